@@ -51,8 +51,10 @@
 
 #include "base/osaf_time.h"
 #include <stdint.h>
+#include <algorithm>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 /* ========================================================================
  *   DEFINITIONS
@@ -127,6 +129,10 @@ static char *StrDup(const char *s)
 	return c;
 }
 uint32_t const MAX_JOB_SIZE_AT_STANDBY = 200;
+// Jobs executed per call of Fifo::execute, the main loop polls in between
+uint32_t const MAX_JOBS_PER_EXECUTE = 32;
+// Queued attribute updates looked at by one ImmObjUpdate::exec
+uint32_t const MAX_UPDATES_PER_EXECUTE = 256;
 
 //
 Job::~Job()
@@ -205,53 +211,168 @@ ImmObjCreate::~ImmObjCreate()
 	delete [] attrValues_;
 }
 
-//
-AvdJobDequeueResultT ImmObjUpdate::exec(const AVD_CL_CB *cb)
+/**
+ * Replaces attributes of one object in IMM
+ * @param immOiHandle
+ * @param attrs  update jobs of the object, one per attribute
+ * @return SaAisErrorT
+ */
+static SaAisErrorT rt_object_update(SaImmOiHandleT immOiHandle,
+	const std::vector<ImmObjUpdate*>& attrs)
 {
-	SaAisErrorT rc;
-	AvdJobDequeueResultT res;
-	const SaImmOiHandleT immOiHandle = cb->immOiHandle;
-
-	SaImmAttrModificationT_2 attrMod;
-	const SaImmAttrModificationT_2 *attrMods[] = {&attrMod, nullptr};
-	SaImmAttrValueT attrValues[] = {value_};
+	std::vector<SaImmAttrModificationT_2> attrMod(attrs.size());
+	std::vector<const SaImmAttrModificationT_2*> attrMods(attrs.size() + 1, nullptr);
+	std::vector<SaImmAttrValueT> attrValues(attrs.size());
+
+	for (size_t i = 0; i < attrs.size(); i++) {
+		attrValues[i] = attrs[i]->value_;
+		attrMod[i].modType = SA_IMM_ATTR_VALUES_REPLACE;
+		attrMod[i].modAttr.attrName = attrs[i]->attributeName_;
+		attrMod[i].modAttr.attrValuesNumber = 1;
+		attrMod[i].modAttr.attrValueType = attrs[i]->attrValueType_;
+		attrMod[i].modAttr.attrValues = &attrValues[i];
+		attrMods[i] = &attrMod[i];
+	}
 
-	TRACE_ENTER2("Update '%s' %s", dn.c_str(), attributeName_);
+	return saImmOiRtObjectUpdate_o3(immOiHandle, attrs[0]->dn.c_str(), attrMods.data());
+}
 
-	//update latest values.
-	if (immobj_update_required() == false){
-		delete Fifo::dequeue();
-		res = JOB_EXECUTED;
-		goto done;	
+/**
+ * @param rc  result of an update
+ * @return true if the update failed and will not be retried
+ */
+static bool rt_object_update_failed(SaAisErrorT rc)
+{
+	switch (rc) {
+	case SA_AIS_OK:
+	case SA_AIS_ERR_NOT_EXIST:
+	case SA_AIS_ERR_TRY_AGAIN:
+	case SA_AIS_ERR_TIMEOUT:
+	case SA_AIS_ERR_BAD_HANDLE:
+		return false;
+	default:
+		return true;
 	}
-	attrMod.modType = SA_IMM_ATTR_VALUES_REPLACE;
-	attrMod.modAttr.attrName = attributeName_;
-	attrMod.modAttr.attrValuesNumber = 1;
-	attrMod.modAttr.attrValueType = attrValueType_;
-	attrMod.modAttr.attrValues = attrValues;
-
-	rc = saImmOiRtObjectUpdate_o3(immOiHandle, dn.c_str(), attrMods);
+}
 
+/**
+ * Marks the update jobs of one object done unless the update is retried
+ * @param rc  result of the update
+ * @param attrs  update jobs of the object
+ * @param done  jobs to remove from the queue
+ * @param res  set to the result of the execution
+ * @return false if the remaining updates must wait for a retry
+ */
+static bool rt_object_update_result(SaAisErrorT rc,
+	const std::vector<ImmObjUpdate*>& attrs, std::set<Job*> *done,
+	AvdJobDequeueResultT *res)
+{
 	if ((rc == SA_AIS_OK) || (rc == SA_AIS_ERR_NOT_EXIST)) {
-		delete Fifo::dequeue();
-		res = JOB_EXECUTED;
+		done->insert(attrs.begin(), attrs.end());
 	} else if (rc == SA_AIS_ERR_TRY_AGAIN) {
 		TRACE("TRY-AGAIN");
-		res = JOB_ETRYAGAIN;
+		*res = JOB_ETRYAGAIN;
+		return false;
 	} else if (rc == SA_AIS_ERR_TIMEOUT) {
 		TRACE("TIMEOUT");
-		res = JOB_ETRYAGAIN;
+		*res = JOB_ETRYAGAIN;
+		return false;
 	} else if (rc == SA_AIS_ERR_BAD_HANDLE) {
 		TRACE("BADHANDLE");
 		avd_imm_reinit_bg();
-		res = JOB_ETRYAGAIN;
+		*res = JOB_ETRYAGAIN;
+		return false;
 	} else {
-		delete Fifo::dequeue();
-		LOG_ER("%s: update FAILED %u", __FUNCTION__, rc);
-		res = JOB_ERR;
+		done->insert(attrs.begin(), attrs.end());
+		LOG_ER("%s: update of '%s' %s FAILED %u", __FUNCTION__,
+			attrs[0]->dn.c_str(),
+			(attrs.size() == 1) ? attrs[0]->attributeName_ : "", rc);
+		*res = JOB_ERR;
 	}
-done:
-	TRACE_LEAVE();
+	return true;
+}
+
+/**
+ * Executes this update together with the updates queued right after it.
+ * Only the latest value of an attribute is written and each object is
+ * updated with one IMM call. Objects are updated in the order they were
+ * first queued. If IMM rejects the call, the attributes of the object are
+ * updated one by one so that only the rejected ones are dropped.
+ */
+AvdJobDequeueResultT ImmObjUpdate::exec(const AVD_CL_CB *cb)
+{
+	AvdJobDequeueResultT res = JOB_EXECUTED;
+	const SaImmOiHandleT immOiHandle = cb->immOiHandle;
+	std::vector<std::vector<ImmObjUpdate*>> objects;
+	std::unordered_map<std::string, size_t> object_index;
+	std::set<Job*> done;
+	uint32_t count;
+	Job *job;
+
+	TRACE_ENTER2("Update '%s' %s", dn.c_str(), attributeName_);
+
+	for (count = 0; count < MAX_UPDATES_PER_EXECUTE &&
+			(job = Fifo::peek(count)) != nullptr; count++) {
+		ImmObjUpdate *update = dynamic_cast<ImmObjUpdate*>(job);
+		if (update == nullptr)
+			break;
+
+		//update latest values.
+		if (update->immobj_update_required() == false) {
+			done.insert(update);
+			continue;
+		}
+
+		auto it = object_index.find(update->dn);
+		if (it == object_index.end()) {
+			object_index[update->dn] = objects.size();
+			objects.push_back(std::vector<ImmObjUpdate*>(1, update));
+			continue;
+		}
+
+		std::vector<ImmObjUpdate*>& attrs = objects[it->second];
+		auto attr = std::find_if(attrs.begin(), attrs.end(),
+			[update](const ImmObjUpdate *a) {
+				return strcmp(a->attributeName_, update->attributeName_) == 0;
+			});
+		if (attr != attrs.end()) {
+			TRACE("'%s' %s superseded", update->dn.c_str(), update->attributeName_);
+			done.insert(*attr);
+			*attr = update;
+		} else {
+			attrs.push_back(update);
+		}
+	}
+
+	for (const auto& attrs : objects) {
+		SaAisErrorT rc = rt_object_update(immOiHandle, attrs);
+
+		if ((attrs.size() > 1) && rt_object_update_failed(rc)) {
+			// one rejected attribute fails the whole call, write them
+			// one by one so that only the rejected ones are lost
+			TRACE("'%s' update failed %u, updating per attribute",
+				attrs[0]->dn.c_str(), rc);
+			bool retry = false;
+			for (ImmObjUpdate *attr : attrs) {
+				const std::vector<ImmObjUpdate*> one(1, attr);
+				rc = rt_object_update(immOiHandle, one);
+				if (!rt_object_update_result(rc, one, &done, &res)) {
+					retry = true;
+					break;
+				}
+			}
+			if (retry)
+				break;
+			continue;
+		}
+
+		if (!rt_object_update_result(rc, attrs, &done, &res))
+			break;
+	}
+
+	TRACE_LEAVE2("%u updates, %zu objects, %zu done", count, objects.size(), done.size());
+	// this job may be among the deleted ones
+	Fifo::remove(done, count);
 	return res;
 }
 	
@@ -361,10 +482,19 @@ Job* Fifo::peek()
 	return tmp;
 }
 
+//
+Job* Fifo::peek(uint32_t pos)
+{
+	if (pos >= job_.size())
+		return nullptr;
+
+	return job_[pos];
+}
+
 //
 void Fifo::queue(Job* job)
 {
-	job_.push(job);
+	job_.push_back(job);
 }
 
 //
@@ -376,12 +506,26 @@ Job* Fifo::dequeue()
 		tmp = 0;
 	} else {
 		tmp = job_.front();
-		job_.pop();
+		job_.pop_front();
 	}
 	
 	return tmp;
 }
 
+//
+void Fifo::remove(const std::set<Job*>& done, uint32_t count)
+{
+	if (done.empty())
+		return;
+
+	auto end = job_.begin() + std::min<size_t>(count, job_.size());
+	auto kept = std::stable_partition(job_.begin(), end,
+		[&done](Job *job) { return done.count(job) == 0; });
+	for (auto it = kept; it != end; ++it)
+		delete *it;
+	job_.erase(kept, end);
+}
+
 /**
  * @brief   As of now standby AMFD will maintain immjobs for object of few classes.
  *          Flush all the jobs without updating to imm if MAX_JOB_SIZE_AT_STANDBY is 
@@ -416,7 +560,11 @@ AvdJobDequeueResultT Fifo::execute(const AVD_CL_CB *cb)
 
 	TRACE_ENTER();
 
-	ret = ajob->exec(cb);
+	for (uint32_t executed = 0; ajob != nullptr; ajob = peek()) {
+		ret = ajob->exec(cb);
+		if ((ret != JOB_EXECUTED) || (++executed == MAX_JOBS_PER_EXECUTE))
+			break;
+	}
 	
 	TRACE_LEAVE2("%d", ret);
 
@@ -443,7 +591,7 @@ uint32_t Fifo::size()
 }
 
 //
-std::queue<Job*> Fifo::job_;
+std::deque<Job*> Fifo::job_;
 //
 
 extern struct ImmutilWrapperProfile immutilWrapperProfile;
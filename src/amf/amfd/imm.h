@@ -26,7 +26,8 @@
 
 #include "amf/amfd/cb.h"
 #include "osaf/immutil/immutil.h"
-#include <queue>
+#include <deque>
+#include <set>
 #include <string>
 
 typedef void (*AvdImmOiCcbApplyCallbackT) (CcbUtilOperationData_t *opdata);
@@ -139,10 +140,16 @@ class NtfSend : public Job {
 class Fifo {
 public:
         static Job* peek();
+
+        // Job at position pos from the front, nullptr if there is none
+        static Job* peek(uint32_t pos);
     
         static void queue(Job* job);
 
         static Job* dequeue();
+
+        // Removes and deletes the jobs in done among the first count jobs
+        static void remove(const std::set<Job*>& done, uint32_t count);
     
         static AvdJobDequeueResultT execute(const AVD_CL_CB *cb);
 
@@ -150,7 +157,7 @@ public:
     
 	static uint32_t size();
 private:
-        static std::queue<Job*> job_;
+        static std::deque<Job*> job_;
 };
 //
 
@@ -0,0 +1,227 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "amf/amfd/cb.h"
+#include "amf/amfd/imm.h"
+
+extern AVD_CL_CB *avd_cb;
+
+// One saImmOiRtObjectUpdate_o3() call: the object and its attribute values
+struct RtUpdate {
+  std::string dn;
+  std::vector<std::pair<std::string, SaUint32T>> attrs;
+};
+
+static std::vector<RtUpdate> rt_updates;
+static SaAisErrorT rt_update_rc = SA_AIS_OK;
+// Attribute the IMM mock rejects, and every call that contains it
+static const char rejected_attr[] = "saAmfRejected";
+
+SaAisErrorT saImmOiRtObjectUpdate_o3(SaImmOiHandleT immOiHandle,
+                                     SaConstStringT objectName,
+                                     const SaImmAttrModificationT_2 **attrMods) {
+  RtUpdate update;
+  update.dn = objectName;
+  for (; *attrMods != nullptr; attrMods++) {
+    const SaImmAttrValuesT_2& attr = (*attrMods)->modAttr;
+    if (strcmp(attr.attrName, rejected_attr) == 0)
+      return SA_AIS_ERR_INVALID_PARAM;
+    update.attrs.emplace_back(
+        attr.attrName, *static_cast<SaUint32T*>(attr.attrValues[0]));
+  }
+  if (rt_update_rc == SA_AIS_OK)
+    rt_updates.push_back(update);
+  return rt_update_rc;
+}
+
+static void QueueUpdate(const std::string& dn, const std::string& attr,
+                        SaUint32T value) {
+  avd_saImmOiRtObjectUpdate(dn, attr, SA_IMM_ATTR_SAUINT32T, &value);
+}
+
+// A job that counts its executions and completes after a number of tries
+class TestJob : public Job {
+ public:
+  explicit TestJob(int id, int tries = 1) : id_(id), tries_(tries) {}
+  AvdJobDequeueResultT exec(const AVD_CL_CB *cb) {
+    executed_++;
+    if (--tries_ > 0)
+      return JOB_ETRYAGAIN;
+    delete Fifo::dequeue();
+    return JOB_EXECUTED;
+  }
+  ~TestJob() { deleted_++; }
+
+  int id_;
+  int tries_;
+  static int executed_;
+  static int deleted_;
+};
+
+int TestJob::executed_ = 0;
+int TestJob::deleted_ = 0;
+
+// The fixture for testing the IMM job queue
+class JobFifoTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    Fifo::empty();
+    rt_updates.clear();
+    rt_update_rc = SA_AIS_OK;
+    TestJob::executed_ = 0;
+    TestJob::deleted_ = 0;
+    avd_cb->active_services_exist = true;
+    avd_cb->avail_state_avd = SA_AMF_HA_ACTIVE;
+  }
+
+  virtual void TearDown() {
+    Fifo::empty();
+  }
+};
+
+TEST_F(JobFifoTest, PeekAtPosition) {
+  for (int i = 0; i < 3; i++)
+    Fifo::queue(new TestJob(i));
+  EXPECT_EQ(0, static_cast<TestJob*>(Fifo::peek(0))->id_);
+  EXPECT_EQ(2, static_cast<TestJob*>(Fifo::peek(2))->id_);
+  EXPECT_EQ(nullptr, Fifo::peek(3));
+}
+
+TEST_F(JobFifoTest, RemoveKeepsOrderOfOtherJobs) {
+  std::set<Job*> done;
+  for (int i = 0; i < 6; i++) {
+    TestJob *job = new TestJob(i);
+    Fifo::queue(job);
+    if (i % 2 == 0)
+      done.insert(job);
+  }
+
+  // job 4 is beyond the jobs looked at and stays
+  Fifo::remove(done, 4);
+  EXPECT_EQ(2, TestJob::deleted_);
+  ASSERT_EQ(4U, Fifo::size());
+  EXPECT_EQ(1, static_cast<TestJob*>(Fifo::peek(0))->id_);
+  EXPECT_EQ(3, static_cast<TestJob*>(Fifo::peek(1))->id_);
+  EXPECT_EQ(4, static_cast<TestJob*>(Fifo::peek(2))->id_);
+  EXPECT_EQ(5, static_cast<TestJob*>(Fifo::peek(3))->id_);
+}
+
+TEST_F(JobFifoTest, ExecuteRunsSeveralJobs) {
+  for (int i = 0; i < 40; i++)
+    Fifo::queue(new TestJob(i));
+
+  EXPECT_EQ(JOB_EXECUTED, Fifo::execute(avd_cb));
+  EXPECT_GT(TestJob::executed_, 1);
+  EXPECT_EQ(40U, Fifo::size() + TestJob::executed_);
+
+  while (Fifo::execute(avd_cb) == JOB_EXECUTED) {
+  }
+  EXPECT_EQ(0U, Fifo::size());
+  EXPECT_EQ(40, TestJob::executed_);
+}
+
+TEST_F(JobFifoTest, ExecuteStopsAtTryAgain) {
+  Fifo::queue(new TestJob(0));
+  Fifo::queue(new TestJob(1, 2));
+  Fifo::queue(new TestJob(2));
+
+  EXPECT_EQ(JOB_ETRYAGAIN, Fifo::execute(avd_cb));
+  EXPECT_EQ(2, TestJob::executed_);
+  EXPECT_EQ(2U, Fifo::size());
+
+  EXPECT_EQ(JOB_EXECUTED, Fifo::execute(avd_cb));
+  EXPECT_EQ(0U, Fifo::size());
+}
+
+TEST_F(JobFifoTest, UpdatesOfAnObjectAreCoalesced) {
+  const std::string su1{"safSu=SU1,safSg=SG,safApp=App"};
+  const std::string su2{"safSu=SU2,safSg=SG,safApp=App"};
+  QueueUpdate(su1, "saAmfSUOperState", 1);
+  QueueUpdate(su2, "saAmfSUOperState", 2);
+  QueueUpdate(su1, "saAmfSUPresenceState", 3);
+
+  EXPECT_EQ(JOB_EXECUTED, Fifo::execute(avd_cb));
+  EXPECT_EQ(0U, Fifo::size());
+  ASSERT_EQ(2U, rt_updates.size());
+  EXPECT_EQ(su1, rt_updates[0].dn);
+  ASSERT_EQ(2U, rt_updates[0].attrs.size());
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUOperState"}, 1U),
+            rt_updates[0].attrs[0]);
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUPresenceState"}, 3U),
+            rt_updates[0].attrs[1]);
+  EXPECT_EQ(su2, rt_updates[1].dn);
+  ASSERT_EQ(1U, rt_updates[1].attrs.size());
+}
+
+TEST_F(JobFifoTest, LatestValueSupersedesQueuedOne) {
+  const std::string su{"safSu=SU1,safSg=SG,safApp=App"};
+  QueueUpdate(su, "saAmfSUOperState", 1);
+  QueueUpdate(su, "saAmfSUReadinessState", 2);
+  QueueUpdate(su, "saAmfSUOperState", 4);
+
+  EXPECT_EQ(JOB_EXECUTED, Fifo::execute(avd_cb));
+  EXPECT_EQ(0U, Fifo::size());
+  ASSERT_EQ(1U, rt_updates.size());
+  ASSERT_EQ(2U, rt_updates[0].attrs.size());
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUOperState"}, 4U),
+            rt_updates[0].attrs[0]);
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUReadinessState"}, 2U),
+            rt_updates[0].attrs[1]);
+}
+
+TEST_F(JobFifoTest, RejectedUpdateFallsBackToPerAttribute) {
+  const std::string su{"safSu=SU1,safSg=SG,safApp=App"};
+  QueueUpdate(su, "saAmfSUOperState", 1);
+  QueueUpdate(su, rejected_attr, 2);
+  QueueUpdate(su, "saAmfSUPresenceState", 3);
+
+  EXPECT_EQ(JOB_ERR, Fifo::execute(avd_cb));
+  EXPECT_EQ(0U, Fifo::size());
+  // only the rejected attribute is lost
+  ASSERT_EQ(2U, rt_updates.size());
+  ASSERT_EQ(1U, rt_updates[0].attrs.size());
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUOperState"}, 1U),
+            rt_updates[0].attrs[0]);
+  ASSERT_EQ(1U, rt_updates[1].attrs.size());
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUPresenceState"}, 3U),
+            rt_updates[1].attrs[0]);
+}
+
+TEST_F(JobFifoTest, CoalescedUpdatesStayQueuedOnTryAgain) {
+  const std::string su{"safSu=SU1,safSg=SG,safApp=App"};
+  QueueUpdate(su, "saAmfSUOperState", 1);
+  QueueUpdate(su, "saAmfSUOperState", 2);
+  QueueUpdate(su, "saAmfSUPresenceState", 3);
+
+  rt_update_rc = SA_AIS_ERR_TRY_AGAIN;
+  EXPECT_EQ(JOB_ETRYAGAIN, Fifo::execute(avd_cb));
+  // the superseded value is dropped, the rest is retried
+  EXPECT_EQ(2U, Fifo::size());
+
+  rt_update_rc = SA_AIS_OK;
+  EXPECT_EQ(JOB_EXECUTED, Fifo::execute(avd_cb));
+  EXPECT_EQ(0U, Fifo::size());
+  ASSERT_EQ(1U, rt_updates.size());
+  EXPECT_EQ(std::make_pair(std::string{"saAmfSUOperState"}, 2U),
+            rt_updates[0].attrs[0]);
+}
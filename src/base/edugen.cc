@@ -0,0 +1,643 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+// edugen: generates encode/decode functions from the EDU_INST_SET tables of
+// a source file, see base/ncs_edu_gen.h.
+//
+// Usage: edugen <source file> <output base>
+//
+// Writes <output base>.c and <output base>.h. For every table "name" the
+// function name_gen() is generated. Offsets, array sizes and EDPs are read
+// from the table at run time, only the kind of each rule is taken from the
+// source text: builtin fields are encoded/decoded inline, runs of scalar
+// fields with a single reserve/flatten of the buffer, and all other rules
+// (pointers, nested EDPs, tests, versions) are run by ncs_edu_run_rule().
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned kMaxRunSize = 128;  // EDU_GEN_MAX_RUN_SIZE
+
+struct Builtin {
+  unsigned size;      // Encoded size
+  const char* type;   // Type of the field
+  const char* bits;   // ncs_encode_<bits>bit
+};
+
+// Builtin EDPs, including the aliases of base/ncs_edu_pub.h
+const std::map<std::string, Builtin> kBuiltins = {
+  {"ncs_edp_uns8", {1, "uint8_t", "8"}},
+  {"ncs_edp_int8", {1, "int8_t", "8"}},
+  {"ncs_edp_char", {1, "char", "8"}},
+  {"ncs_edp_uns16", {2, "uint16_t", "16"}},
+  {"ncs_edp_int16", {2, "int16_t", "16"}},
+  {"ncs_edp_short", {2, "short", "16"}},
+  {"ncs_edp_uns32", {4, "uint32_t", "32"}},
+  {"ncs_edp_int32", {4, "int32_t", "32"}},
+  {"ncs_edp_float", {4, "int32_t", "32"}},
+  {"ncs_edp_int", {4, "int", "32"}},
+  {"ncs_edp_ncs_bool", {4, "bool", "32"}},
+  {"ncs_edp_uns64", {8, "uint64_t", "64"}},
+  {"ncs_edp_mds_dest", {8, "uint64_t", "64"}},
+  {"ncs_edp_int64", {8, "int64_t", "64"}},
+  {"ncs_edp_double", {8, "int64_t", "64"}},
+};
+
+// How the interpreter reads the length of variable-sized-data, see
+// ncs_edu_get_size_of_var_len_data(). ncs_edp_double is an alias of
+// ncs_edp_int64 and is tested first.
+const std::map<std::string, std::string> kLengthTypes = {
+  {"ncs_edp_uns8", "uint8_t"},
+  {"ncs_edp_int8", "int8_t"},
+  {"ncs_edp_uns16", "uint16_t"},
+  {"ncs_edp_int16", "int16_t"},
+  {"ncs_edp_short", "short"},
+  {"ncs_edp_int", "int"},
+  {"ncs_edp_uns32", "uint32_t"},
+  {"ncs_edp_int32", "int32_t"},
+  {"ncs_edp_float", "int32_t"},
+  {"ncs_edp_double", "double"},
+  {"ncs_edp_int64", "double"},
+  {"ncs_edp_uns64", "uint64_t"},
+  {"ncs_edp_mds_dest", "uint64_t"},
+};
+
+enum class Kind {
+  kInterpret,  // Run by ncs_edu_run_rule()
+  kScalar,
+  kChars,      // char array, encoded as a string
+  kOctets,     // uint8_t/int8_t array
+  kArray,      // Array of 2, 4 or 8 byte integers
+  kVarOctets,  // uint8_t/char variable-sized-data, with its EDU_EXEC_EXT
+  kString,
+  kEnd
+};
+
+enum class Label { kNext, kExit, kJump, kUnknown };
+
+struct Rule {
+  std::string instr;
+  std::string edp;
+  std::string qualifiers;
+  std::string length_edp;
+  std::string label;
+  Kind kind = Kind::kInterpret;
+  bool jump_target = false;
+};
+
+struct Table {
+  std::string name;
+  std::vector<Rule> rules;
+  bool interpret_only = false;  // Linked-list or unparsable table
+  bool can_merge = false;       // Scalar rules may be merged into runs
+};
+
+std::string Trim(const std::string& str) {
+  std::string result;
+  bool space = false;
+  for (char c : str) {
+    if (isspace(static_cast<unsigned char>(c))) {
+      space = !result.empty();
+    } else {
+      if (space) result += ' ';
+      result += c;
+      space = false;
+    }
+  }
+  return result;
+}
+
+// Replaces comments by spaces, keeping string literals and line breaks
+std::string StripComments(const std::string& text) {
+  std::string result = text;
+  size_t i = 0;
+  while (i < result.size()) {
+    char c = result[i];
+    if (c == '"' || c == '\'') {
+      for (++i; i < result.size() && result[i] != c; ++i) {
+        if (result[i] == '\\') ++i;
+      }
+      ++i;
+    } else if (result.compare(i, 2, "/*") == 0) {
+      size_t end = result.find("*/", i + 2);
+      end = (end == std::string::npos) ? result.size() : end + 2;
+      for (; i < end; ++i) {
+        if (result[i] != '\n') result[i] = ' ';
+      }
+    } else if (result.compare(i, 2, "//") == 0) {
+      for (; i < result.size() && result[i] != '\n'; ++i) result[i] = ' ';
+    } else {
+      ++i;
+    }
+  }
+  return result;
+}
+
+bool IsIdentChar(char c) {
+  return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+size_t SkipSpace(const std::string& text, size_t pos) {
+  while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos])))
+    ++pos;
+  return pos;
+}
+
+bool HasQualifier(const Rule& rule, const char* qualifier) {
+  return rule.qualifiers.find(qualifier) != std::string::npos;
+}
+
+Label LabelOf(const std::string& label) {
+  if (label == "0" || label == "EDU_NEXT") return Label::kNext;
+  if (label == "EDU_EXIT") return Label::kExit;
+  if (!label.empty() && label.find_first_not_of("0123456789") ==
+      std::string::npos) return Label::kJump;
+  return Label::kUnknown;
+}
+
+// Splits "{a, b(c, d), e}" at the top level commas
+std::vector<std::string> SplitFields(const std::string& entry) {
+  std::vector<std::string> fields;
+  std::string field;
+  int depth = 0;
+  for (char c : entry) {
+    if (c == '(' || c == '{' || c == '[') ++depth;
+    if (c == ')' || c == '}' || c == ']') --depth;
+    if (c == ',' && depth == 0) {
+      fields.push_back(Trim(field));
+      field.clear();
+    } else {
+      field += c;
+    }
+  }
+  if (!Trim(field).empty()) fields.push_back(Trim(field));
+  return fields;
+}
+
+// Parses the initializer of a table, text[pos] being its opening brace.
+// Returns the position after the closing brace.
+size_t ParseTable(const std::string& text, size_t pos, Table* table) {
+  int depth = 0;
+  size_t entry_start = 0;
+  for (; pos < text.size(); ++pos) {
+    char c = text[pos];
+    if (c == '#') table->interpret_only = true;
+    if (c == '{') {
+      if (++depth == 2) entry_start = pos + 1;
+    } else if (c == '}') {
+      if (depth == 2) {
+        std::vector<std::string> fields =
+            SplitFields(text.substr(entry_start, pos - entry_start));
+        fields.resize(8, "0");
+        Rule rule;
+        rule.instr = fields[0];
+        rule.edp = fields[1];
+        rule.qualifiers = fields[2];
+        rule.length_edp = fields[3];
+        rule.label = fields[4];
+        table->rules.push_back(rule);
+      }
+      if (--depth == 0) return pos + 1;
+    }
+  }
+  table->interpret_only = true;
+  return pos;
+}
+
+std::vector<Table> ParseTables(const std::string& text) {
+  std::vector<Table> tables;
+  const std::string keyword = "EDU_INST_SET";
+  size_t pos = 0;
+  while ((pos = text.find(keyword, pos)) != std::string::npos) {
+    bool whole_word = (pos == 0 || !IsIdentChar(text[pos - 1])) &&
+        !IsIdentChar(text[pos + keyword.size()]);
+    pos += keyword.size();
+    if (!whole_word) continue;
+    size_t p = SkipSpace(text, pos);
+    size_t name_start = p;
+    while (p < text.size() && IsIdentChar(text[p])) ++p;
+    if (p == name_start) continue;
+    std::string name = text.substr(name_start, p - name_start);
+    const char* expected[] = {"[", "]", "=", "{"};
+    bool match = true;
+    for (const char* token : expected) {
+      p = SkipSpace(text, p);
+      if (p >= text.size() || text[p] != *token) {
+        match = false;
+        break;
+      }
+      if (*token != '{') ++p;
+    }
+    if (!match) continue;
+    Table table;
+    table.name = name;
+    pos = ParseTable(text, p, &table);
+    tables.push_back(table);
+  }
+  return tables;
+}
+
+void Classify(Table* table) {
+  std::vector<Rule>& rules = table->rules;
+  if (rules.empty() || rules[0].instr != "EDU_START" ||
+      HasQualifier(rules[0], "EDQ_LNKLIST")) {
+    table->interpret_only = true;
+  }
+  table->can_merge = true;
+  for (const Rule& rule : rules) {
+    if (rule.instr == "EDU_TEST_LL_PTR") table->interpret_only = true;
+    if (rule.instr != "EDU_START" && rule.instr != "EDU_EXEC" &&
+        rule.instr != "EDU_EXEC_EXT" && rule.instr != "EDU_END") {
+      // Tests and versions jump to computed offsets
+      table->can_merge = false;
+    }
+    Label label = LabelOf(rule.label);
+    if (label == Label::kUnknown) {
+      table->can_merge = false;
+    } else if (label == Label::kJump) {
+      size_t target = std::stoul(rule.label);
+      if (target < rules.size()) rules[target].jump_target = true;
+    }
+  }
+  if (table->interpret_only) return;
+
+  for (size_t i = 1; i < rules.size(); ++i) {
+    Rule& rule = rules[i];
+    if (rule.instr == "EDU_END") {
+      rule.kind = Kind::kEnd;
+      continue;
+    }
+    if (rule.instr != "EDU_EXEC") continue;
+
+    // Only known qualifiers, no pointers
+    std::string rest = rule.qualifiers;
+    for (const char* token : {"EDQ_ARRAY", "EDQ_VAR_LEN_DATA", "0", "|", "(",
+                              ")", " "}) {
+      size_t p;
+      while ((p = rest.find(token)) != std::string::npos)
+        rest.erase(p, std::string(token).size());
+    }
+    if (!rest.empty()) continue;
+    bool array = HasQualifier(rule, "EDQ_ARRAY");
+    bool var_len = HasQualifier(rule, "EDQ_VAR_LEN_DATA");
+    auto builtin = kBuiltins.find(rule.edp);
+
+    if (array && var_len) continue;
+    if (var_len) {
+      // The label is the one of the EDU_EXEC_EXT rule
+      if ((rule.edp == "ncs_edp_uns8" || rule.edp == "ncs_edp_char") &&
+          kLengthTypes.count(rule.length_edp) != 0 && i + 1 < rules.size() &&
+          rules[i + 1].instr == "EDU_EXEC_EXT" &&
+          LabelOf(rules[i + 1].label) != Label::kJump &&
+          LabelOf(rules[i + 1].label) != Label::kUnknown) {
+        rule.kind = Kind::kVarOctets;
+      }
+      continue;
+    }
+    Label label = LabelOf(rule.label);
+    if (label != Label::kNext && label != Label::kExit) continue;
+    if (array) {
+      if (rule.edp == "ncs_edp_char") {
+        rule.kind = Kind::kChars;
+      } else if (rule.edp == "ncs_edp_uns8" || rule.edp == "ncs_edp_int8") {
+        rule.kind = Kind::kOctets;
+      } else if (builtin != kBuiltins.end() &&
+                 rule.edp != "ncs_edp_ncs_bool") {
+        rule.kind = Kind::kArray;
+      }
+    } else if (rule.edp == "ncs_edp_string") {
+      rule.kind = Kind::kString;
+    } else if (builtin != kBuiltins.end()) {
+      rule.kind = Kind::kScalar;
+    }
+  }
+}
+
+bool IsGenerated(const Table& table, size_t i) {
+  return i < table.rules.size() && table.rules[i].kind != Kind::kInterpret;
+}
+
+std::string Field(size_t i) {
+  return "m_EDU_GEN_FLD(ptr, prog, " + std::to_string(i) + ")";
+}
+
+class Generator {
+ public:
+  Generator(const Table& table, bool encode) : table_(table),
+      encode_(encode) {}
+  std::string Function();
+
+ private:
+  size_t ScalarRun(size_t i);
+  void EmitRule(size_t i, size_t* next, bool* exit);
+  void EmitFail(const char* error);
+
+  const Table& table_;
+  bool encode_;
+  std::ostringstream body_;
+  bool uses_p8_ = false;
+  bool uses_uba_ = false;
+  bool uses_mem_fail_ = false;
+  bool uses_parse_fail_ = false;
+  unsigned tmp_size_ = 0;
+};
+
+void Generator::EmitFail(const char* error) {
+  body_ << "\t\t\t\tgoto " << error << ";\n";
+  if (std::string(error) == "mem_fail")
+    uses_mem_fail_ = true;
+  else
+    uses_parse_fail_ = true;
+}
+
+// Returns the end of the run of scalar rules starting at rule i
+size_t Generator::ScalarRun(size_t i) {
+  const std::vector<Rule>& rules = table_.rules;
+  unsigned size = kBuiltins.at(rules[i].edp).size;
+  size_t end = i + 1;
+  if (!table_.can_merge || LabelOf(rules[i].label) == Label::kExit)
+    return end;
+  while (end < rules.size() && rules[end].kind == Kind::kScalar &&
+         !rules[end].jump_target &&
+         size + kBuiltins.at(rules[end].edp).size <= kMaxRunSize) {
+    size += kBuiltins.at(rules[end].edp).size;
+    if (LabelOf(rules[end++].label) == Label::kExit) break;
+  }
+  return end;
+}
+
+void Generator::EmitRule(size_t i, size_t* next, bool* exit) {
+  const std::vector<Rule>& rules = table_.rules;
+  const Rule& rule = rules[i];
+  std::string n = std::to_string(i);
+  *next = i + 1;
+  *exit = LabelOf(rule.label) == Label::kExit;
+
+  switch (rule.kind) {
+    case Kind::kScalar: {
+      size_t end = ScalarRun(i);
+      unsigned size = 0;
+      for (size_t j = i; j < end; ++j) size += kBuiltins.at(rules[j].edp).size;
+      std::string s = std::to_string(size);
+      uses_p8_ = uses_uba_ = true;
+      if (encode_) {
+        body_ << "\t\t\tp8 = ncs_enc_reserve_space(uba, " << s << ");\n"
+              << "\t\t\tif (p8 == NULL)\n";
+        EmitFail("mem_fail");
+      } else {
+        if (size > tmp_size_) tmp_size_ = size;
+        body_ << "\t\t\tp8 = ncs_dec_flatten_space(uba, tmp, " << s << ");\n"
+              << "\t\t\tif (p8 == NULL)\n";
+        EmitFail("parse_fail");
+      }
+      for (size_t j = i; j < end; ++j) {
+        const Builtin& b = kBuiltins.at(rules[j].edp);
+        const char* type = (b.size == 1 && std::string(b.type) == "char") ?
+            "uint8_t" : b.type;
+        if (encode_) {
+          body_ << "\t\t\tncs_encode_" << b.bits << "bit(&p8, *(" << type
+                << " *)" << Field(j) << ");\n";
+        } else {
+          body_ << "\t\t\t*(" << type << " *)" << Field(j) << " = (" << type
+                << ")ncs_decode_" << b.bits << "bit(&p8);\n";
+        }
+      }
+      if (encode_) {
+        body_ << "\t\t\tncs_enc_claim_space(uba, " << s << ");\n";
+      } else {
+        body_ << "\t\t\tncs_dec_skip_space(uba, " << s << ");\n";
+      }
+      *next = end;
+      *exit = LabelOf(rules[end - 1].label) == Label::kExit;
+      break;
+    }
+    case Kind::kChars:
+      uses_uba_ = true;
+      if (encode_) {
+        body_ << "\t\t\tif (ncs_edu_gen_enc_chars(uba, (char *)" << Field(i)
+              << ") != NCSCC_RC_SUCCESS)\n";
+        EmitFail("mem_fail");
+      } else {
+        body_ << "\t\t\tif (ncs_edu_gen_dec_chars(uba, (char *)" << Field(i)
+              << ") != NCSCC_RC_SUCCESS)\n";
+        EmitFail("parse_fail");
+      }
+      break;
+    case Kind::kOctets:
+      uses_uba_ = true;
+      body_ << "\t\t\tif (ncs_edu_gen_" << (encode_ ? "enc" : "dec")
+            << "_octets(uba, " << Field(i) << ", prog[" << n
+            << "].fld6) != NCSCC_RC_SUCCESS)\n";
+      EmitFail(encode_ ? "mem_fail" : "parse_fail");
+      break;
+    case Kind::kArray:
+      uses_uba_ = true;
+      body_ << "\t\t\tif (ncs_edu_gen_" << (encode_ ? "enc" : "dec")
+            << "_array(uba, " << Field(i) << ", prog[" << n << "].fld6, "
+            << kBuiltins.at(rule.edp).size << ") != NCSCC_RC_SUCCESS)\n";
+      EmitFail(encode_ ? "mem_fail" : "parse_fail");
+      break;
+    case Kind::kVarOctets: {
+      std::string length = "(uint32_t)*(" + kLengthTypes.at(rule.length_edp) +
+          " *)m_EDU_GEN_LEN_FLD(ptr, prog, " + n + ")";
+      uses_uba_ = true;
+      body_ << "\t\t\t*ptr_data_len = " << length << ";\n";
+      if (encode_) {
+        body_ << "\t\t\tif ((*ptr_data_len != 0) &&\n"
+              << "\t\t\t    (ncs_encode_n_octets_in_uba(uba, *(uint8_t **)"
+              << Field(i) << ", *ptr_data_len) != NCSCC_RC_SUCCESS))\n";
+        EmitFail("mem_fail");
+      } else {
+        body_ << "\t\t\tif (ncs_edu_gen_dec_var_octets(uba, (uint8_t **)"
+              << Field(i) << ", *ptr_data_len, o_err) != NCSCC_RC_SUCCESS)\n"
+              << "\t\t\t\treturn NCSCC_RC_FAILURE;\n";
+      }
+      // Skip the EDU_EXEC_EXT rule, which has the label
+      *next = i + 2;
+      *exit = LabelOf(rules[i + 1].label) == Label::kExit;
+      break;
+    }
+    case Kind::kString:
+      if (encode_) {
+        body_ << "\t\t\tif (ncs_edu_gen_enc_string(edu_hdl, buf_env, *(char **)"
+              << Field(i) << ", ptr_data_len, o_err) != NCSCC_RC_SUCCESS)\n";
+      } else {
+        body_ << "\t\t\tif (ncs_edp_string(edu_hdl, NULL, " << Field(i)
+              << ", ptr_data_len, buf_env, EDP_OP_TYPE_DEC, o_err) != "
+              << "NCSCC_RC_SUCCESS)\n";
+      }
+      body_ << "\t\t\t\treturn NCSCC_RC_FAILURE;\n";
+      break;
+    default:
+      break;
+  }
+  if (encode_) body_ << "\t\t\t*ptr_data_len = 0;\n";
+}
+
+std::string Generator::Function() {
+  const std::vector<Rule>& rules = table_.rules;
+  const char* op = encode_ ? "enc" : "dec";
+
+  for (size_t i = 1; i < rules.size();) {
+    if (!IsGenerated(table_, i)) {
+      ++i;
+      continue;
+    }
+    body_ << "\t\tcase " << i << ":\n";
+    if (rules[i].kind == Kind::kEnd) {
+      body_ << "\t\t\treturn NCSCC_RC_SUCCESS;\n";
+      ++i;
+      continue;
+    }
+    size_t next;
+    bool exit;
+    EmitRule(i, &next, &exit);
+    if (exit || next >= rules.size()) {
+      body_ << "\t\t\treturn NCSCC_RC_SUCCESS;\n";
+    } else if (IsGenerated(table_, next)) {
+      body_ << "\t\t\t/* fall through */\n";
+    } else {
+      body_ << "\t\t\tindx = " << next << ";\n\t\t\tbreak;\n";
+    }
+    i = next;
+  }
+
+  std::ostringstream out;
+  out << "static uint32_t " << table_.name << "_" << op
+      << "(EDU_HDL *edu_hdl, EDU_INST_SET prog[], NCSCONTEXT ptr,\n"
+      << "\t\tuint32_t *ptr_data_len, EDU_BUF_ENV *buf_env, EDU_ERR *o_err, "
+      << "int instr_count)\n{\n";
+  if (uses_uba_) out << "\tNCS_UBAID *uba = buf_env->info.uba;\n";
+  if (uses_p8_) out << "\tuint8_t *p8 = NULL;\n";
+  if (tmp_size_ != 0) out << "\tuint8_t tmp[" << tmp_size_ << "];\n";
+  out << "\tint indx = 1;\n\n"
+      << "\tfor (;;) {\n\t\tswitch (indx) {\n"
+      << body_.str()
+      << "\t\tdefault:\n"
+      << "\t\t\tindx = ncs_edu_run_rule(edu_hdl, prog, indx, ptr, "
+      << "ptr_data_len, buf_env,\n\t\t\t\t\t\tEDP_OP_TYPE_"
+      << (encode_ ? "ENC" : "DEC") << ", o_err, instr_count);\n"
+      << "\t\t\tif (indx == EDU_EXIT)\n\t\t\t\treturn NCSCC_RC_SUCCESS;\n"
+      << "\t\t\tif (indx == EDU_FAIL)\n\t\t\t\treturn NCSCC_RC_FAILURE;\n"
+      << "\t\t\tbreak;\n\t\t}\n\t}\n";
+  if (uses_mem_fail_) {
+    out << "\n mem_fail:\n\t*o_err = EDU_ERR_MEM_FAIL;\n"
+        << "\treturn NCSCC_RC_FAILURE;\n";
+  }
+  if (uses_parse_fail_) {
+    out << "\n parse_fail:\n\t*o_err = EDU_ERR_UBUF_PARSE_FAIL;\n"
+        << "\treturn NCSCC_RC_FAILURE;\n";
+  }
+  out << "}\n\n";
+  return out.str();
+}
+
+const char kSignature[] =
+    "(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, EDU_INST_SET prog[],\n"
+    "\tNCSCONTEXT ptr, uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env,\n"
+    "\tEDP_OP_TYPE optype, EDU_ERR *o_err, int instr_count)";
+
+std::string Wrapper(const Table& table) {
+  std::ostringstream out;
+  out << "uint32_t " << table.name << "_gen" << kSignature << "\n{\n";
+  if (!table.interpret_only) {
+    out << "\tif (ncs_edu_gen_usable(edu_tkn, buf_env, optype, instr_count, "
+        << table.rules.size() << ")) {\n"
+        << "\t\tif (optype == EDP_OP_TYPE_ENC)\n"
+        << "\t\t\treturn " << table.name << "_enc(edu_hdl, prog, ptr, "
+        << "ptr_data_len, buf_env, o_err, instr_count);\n"
+        << "\t\treturn " << table.name << "_dec(edu_hdl, prog, ptr, "
+        << "ptr_data_len, buf_env, o_err, instr_count);\n\t}\n";
+  }
+  out << "\treturn ncs_edu_run_rules(edu_hdl, edu_tkn, prog, ptr, "
+      << "ptr_data_len, buf_env, optype, o_err, instr_count);\n}\n\n";
+  return out.str();
+}
+
+// "x/src/evt/evtd/file" -> "evt/evtd/file"
+std::string SourceRelative(const std::string& path) {
+  size_t pos = path.rfind("src/");
+  return (pos == std::string::npos) ? path : path.substr(pos + 4);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <source file> <output base>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  std::ifstream in(argv[1]);
+  if (!in) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+    return EXIT_FAILURE;
+  }
+  std::stringstream source;
+  source << in.rdbuf();
+  std::vector<Table> tables = ParseTables(StripComments(source.str()));
+
+  std::set<std::string> names;
+  for (Table& table : tables) {
+    if (!names.insert(table.name).second) {
+      fprintf(stderr, "%s: %s: table %s is defined twice\n", argv[0], argv[1],
+              table.name.c_str());
+      return EXIT_FAILURE;
+    }
+    Classify(&table);
+  }
+
+  std::string base = argv[2];
+  std::string header_name = base.substr(base.rfind('/') + 1) + ".h";
+  std::string guard = SourceRelative(base) + "_H_";
+  for (char& c : guard) c = IsIdentChar(c) ? toupper(c) : '_';
+  std::string banner = "/* Generated by edugen from " +
+      SourceRelative(argv[1]) + ", do not edit. */\n\n";
+
+  std::ofstream header(base + ".h");
+  header << banner << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+         << "#include \"base/ncs_edu_gen.h\"\n\n";
+  for (const Table& table : tables)
+    header << "uint32_t " << table.name << "_gen" << kSignature << ";\n\n";
+  header << "#endif  // " << guard << "\n";
+
+  std::ofstream code(base + ".c");
+  code << banner << "#include \"" << header_name << "\"\n\n";
+  for (const Table& table : tables) {
+    if (!table.interpret_only) {
+      code << Generator(table, true).Function()
+           << Generator(table, false).Function();
+    }
+    code << Wrapper(table);
+  }
+
+  header.close();
+  code.close();
+  if (!header || !code) {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], base.c_str());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
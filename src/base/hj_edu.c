@@ -34,10 +34,14 @@
 #include "base/ncssysfpool.h"
 #include "base/ncsencdec_pub.h"
 #include "ncs_edu.h"
+#include "base/ncs_edu_gen.h"
 #include "base/usrbuf.h"
 
  char gl_log_string[GL_LOG_STRING_LEN];
 
+/* Generated EDU functions fall back to the interpreter when false */
+bool gl_edu_gen_enabled = true;
+
 #if(NCS_EDU_VERBOSE_PRINT == 1)
 static uint32_t ncs_edu_ppdb_init(EDU_PPDB * ppdb);
 static void ncs_edu_ppdb_destroy(EDU_PPDB * ppdb);
@@ -599,6 +603,136 @@ uint32_t ncs_edu_run_rules(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	return NCSCC_RC_SUCCESS;
 }
 
+/*****************************************************************************
+
+  PROCEDURE NAME:   ncs_edu_run_rule
+
+  DESCRIPTION:      Runs the rule at index "indx" of an EDP-program during
+                    encode or decode, exactly like one iteration of
+                    ncs_edu_run_rules_for_enc/dec. Used by the functions
+                    generated by edugen for the rules they do not encode or
+                    decode themselves. Linked-lists and selective
+                    encode/decode are not handled here, the generated
+                    functions leave those to ncs_edu_run_rules.
+
+  RETURNS:          int, index of the rule to run next, or
+                    - EDU_EXIT, in case EDP program is executed completely.
+                    - EDU_FAIL, in case failure is encountered.
+
+*****************************************************************************/
+int ncs_edu_run_rule(EDU_HDL *edu_hdl, EDU_INST_SET prog[], int indx,
+		     NCSCONTEXT ptr, uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env,
+		     EDP_OP_TYPE optype, EDU_ERR *o_err, int instr_count)
+{
+	EDU_INST_SET *rule = NULL;
+	EDU_HDL_NODE *lcl_hdl_node = NULL;
+	int rc_lbl = EDU_NEXT;
+
+	if ((indx < 0) || (indx >= instr_count) || (prog[indx].instr == EDU_END))
+		return EDU_EXIT;
+
+	rule = &prog[indx];
+	if ((optype == EDP_OP_TYPE_ENC) && (rule->instr == EDU_EXEC) &&
+	    ((rule->fld2 & EDQ_POINTER) == EDQ_POINTER)) {
+		/* Every pointer is preceded by a count telling whether it
+		   is NULL, except for a non-NULL linked-list, which encodes
+		   its own count. */
+		uint32_t dtype_attrb = 0;
+		uint16_t ptr_cnt = 0;
+		uint8_t *p8 = NULL;
+
+		if ((lcl_hdl_node = (EDU_HDL_NODE *)
+		     ncs_patricia_tree_get(&edu_hdl->tree, (uint8_t *)&rule->fld1)) != NULL) {
+			dtype_attrb = lcl_hdl_node->attrb;
+		} else {
+			NCS_EDU_ADMIN_OP_INFO admin_op;
+
+			memset(&admin_op, '\0', sizeof(admin_op));
+			admin_op.adm_op_type = NCS_EDU_ADMIN_OP_TYPE_GET_ATTRB;
+			admin_op.info.get_attrb.o_attrb = &dtype_attrb;
+			rule->fld1(edu_hdl, NULL, (NCSCONTEXT)&admin_op, NULL, NULL, EDP_OP_TYPE_ADMIN, o_err);
+		}
+
+		if (*(long *)((long)ptr + (long)rule->fld5) != 0)
+			ptr_cnt = 1;
+
+		if ((ptr_cnt == 0) || ((dtype_attrb & EDQ_LNKLIST) != EDQ_LNKLIST)) {
+			if (buf_env->is_ubaid) {
+				p8 = ncs_enc_reserve_space(buf_env->info.uba, 2);
+				if (p8 == NULL) {
+					*o_err = EDU_ERR_MEM_FAIL;
+					return EDU_FAIL;
+				}
+				ncs_enc_claim_space(buf_env->info.uba, 2);
+				ncs_encode_16bit(&p8, ptr_cnt);
+			} else {
+				p8 = buf_env->info.tlv_env.cur_bufp;
+				ncs_encode_tlv_16bit(&p8, ptr_cnt);
+				ncs_edu_skip_space(&buf_env->info.tlv_env, EDU_TLV_HDR_SIZE + 2);
+			}
+		}
+
+		if (ptr_cnt == 0) {
+			if ((rule->nxt_lbl == 0) || (rule->nxt_lbl == EDU_NEXT))
+				return indx + 1;
+			if (rule->nxt_lbl == EDU_EXIT)
+				return EDU_EXIT;
+			return rule->nxt_lbl;
+		}
+	}
+
+	rc_lbl = m_NCS_EDU_EXEC_RULE(edu_hdl, NULL, NULL, rule, ptr, ptr_data_len, buf_env, optype, o_err);
+	if ((rc_lbl == 0) || (rc_lbl == EDU_NEXT)) {
+		if ((rule->instr == EDU_VER_GE) || (rule->instr == EDU_VER_USR))
+			return indx + 1;
+		if ((rule->fld2 & EDQ_VAR_LEN_DATA) == EDQ_VAR_LEN_DATA) {
+			/* To skip the EDU_EXEC_EXT instruction */
+			rule = &prog[++indx];
+		}
+		if ((rule->nxt_lbl == 0) || (rule->nxt_lbl == EDU_NEXT))
+			return indx + 1;
+		if (rule->nxt_lbl == EDU_EXIT)
+			return EDU_EXIT;
+		if (rule->nxt_lbl == EDU_SAME) {
+			/* Invalid label, only tolerated by the decoder. */
+			return (optype == EDP_OP_TYPE_ENC) ? EDU_FAIL : indx + 1;
+		}
+		if (rule->instr == EDU_EXEC)
+			return rule->nxt_lbl;
+		return indx + 1;
+	} else if ((rc_lbl == EDU_EXIT) || (rc_lbl == EDU_FAIL)) {
+		return rc_lbl;
+	} else if (rc_lbl == EDU_SAME) {
+		/* Linked-list looping is left to ncs_edu_run_rules. */
+		if (optype == EDP_OP_TYPE_ENC) {
+			*o_err = EDU_ERR_ILLEGAL_INSTR_GIVEN;
+			return m_LEAP_DBG_SINK(EDU_FAIL);
+		}
+		return EDU_EXIT;
+	}
+
+	if ((rule->instr == EDU_TEST) || (rule->instr == EDU_VER_GE) || (rule->instr == EDU_VER_USR)) {
+		/* rc_lbl is the offset of the rule to jump to. */
+		indx = indx + rc_lbl;
+		if (indx >= instr_count) {
+			m_LEAP_DBG_SINK_VOID;
+			switch (rule->instr) {
+			case EDU_VER_GE:
+				*o_err = EDU_ERR_INV_JUMPTO_OFFSET_PROVIDED_BY_VER_GE;
+				break;
+			case EDU_VER_USR:
+				*o_err = EDU_ERR_INV_JUMPTO_OFFSET_PROVIDED_BY_VER_USR;
+				break;
+			default:
+				*o_err = EDU_ERR_INV_JUMPTO_OFFSET_PROVIDED_BY_TEST_FNC;
+			}
+			return EDU_FAIL;
+		}
+		return indx;
+	}
+	return rc_lbl;
+}
+
 /*****************************************************************************
 
   PROCEDURE NAME:   ncs_edu_exec_rule
@@ -92,6 +92,12 @@ HM_POOL gl_hpool[HM_POOL_CNT] = {
 #define m_HM_DETM_POOL_FRM_HDL(lhdl) \
     ( ((uint32_t)(((HM_HDL*)lhdl)->idx1) < 2) ? NCSHM_POOL_LOCAL : ( (uint32_t)((uint32_t)((uint32_t)(((HM_HDL*)lhdl)->idx1) - 1)>>5) + 1 ) )
 
+/* Does the cell state belong to the busy (created, not destroyed) handle
+   'hdl' of service 'id'? */
+#define m_HM_STATE_MATCH(state, hdl, id) \
+    ( (HM_STATE_SEQ_ID(state) == (hdl)->seq_id) && ((NCS_SERVICE_ID)HM_STATE_SVC_ID(state) == (id)) && \
+      ((state) & HM_STATE_BUSY) )
+
 /* Given the unitID, get the poolID. This mapping has a dependency on
    the values as set in gl_hpool[ ] array. If the array values change, either
    create a new mapping between unitID and poolID, (or) use the function 
@@ -187,6 +193,8 @@ uint32_t ncshm_init(void)
 
 	assert(sizeof(HM_FREE) == sizeof(HM_CELL));	/* must be same size */
 
+	assert(offsetof(HM_FREE, state) == offsetof(HM_CELL, state));	/* and shape */
+
 	assert(sizeof(uint32_t) == sizeof(HM_HDL));	/* must be same size */
 
 	HM_HDL ha = {
@@ -282,9 +290,7 @@ uint32_t ncshm_create_hdl(uint8_t pool, NCS_SERVICE_ID id, NCSCONTEXT save)
 
 		ret = (*(uint32_t *)&free->hdl);
 		cell->data = save;	/* store user stuff and internal state */
-		cell->use_ct = 1;
-		cell->svc_id = id;
-		cell->busy = true;
+		__atomic_store_n(&cell->state, HM_STATE_MAKE(free->hdl.seq_id, id, 1), __ATOMIC_RELEASE);
 	}
 
 	m_NCS_UNLOCK(&gl_hm.lock[pool], NCS_LOCK_WRITE);
@@ -324,9 +330,7 @@ uint32_t ncshm_declare_hdl(uint32_t uhdl, NCS_SERVICE_ID id, NCSCONTEXT save)
 		assert(((void *)free == (void *)cell));	/* checks that add no value   */
 
 		cell->data = save;	/* store user stuff and internal state */
-		cell->use_ct = 1;
-		cell->svc_id = id;
-		cell->busy = true;
+		__atomic_store_n(&cell->state, HM_STATE_MAKE(hdl->seq_id, id, 1), __ATOMIC_RELEASE);
 		ret = NCSCC_RC_SUCCESS;
 	}
 
@@ -342,6 +346,9 @@ uint32_t ncshm_declare_hdl(uint32_t uhdl, NCS_SERVICE_ID id, NCSCONTEXT save)
                      associated data. If some other thread currently is using
                      the data, BLOCK this thread till ref-count == 1
 
+                     Clearing the busy flag stops new take()s; the give()r
+                     that brings the ref-count down to 1 unblocks us.
+
 *****************************************************************************/
 
 NCSCONTEXT ncshm_destroy_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
@@ -350,6 +357,7 @@ NCSCONTEXT ncshm_destroy_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
 	HM_HDL *hdl = (HM_HDL *)&uhdl;
 	NCSCONTEXT data = NULL;
 	uint32_t pool_id = 0;
+	uint32_t state;
 
 	pool_id = m_HM_DETM_POOL_FRM_HDL(&uhdl);
 	if (pool_id >= HM_POOL_CNT)
@@ -358,15 +366,23 @@ NCSCONTEXT ncshm_destroy_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
 	m_NCS_LOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
 
 	if ((cell = hm_find_cell(hdl)) != NULL) {
-		if ((cell->seq_id == hdl->seq_id) && ((NCS_SERVICE_ID)cell->svc_id == id) && (cell->busy == true)) {
-			cell->busy = false;
+		state = __atomic_load_n(&cell->state, __ATOMIC_ACQUIRE);
+		while (m_HM_STATE_MATCH(state, hdl, id)) {
+			if (!__atomic_compare_exchange_n(&cell->state, &state, state & ~HM_STATE_BUSY, false,
+							 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+				continue;	/* a take() or give() got in first */
+
 			data = cell->data;
 
-			if (cell->use_ct > 1) {
+			if (HM_STATE_USE_CT(state) > 1) {
 				hm_block_me(cell, (uint8_t)pool_id);	/* must unlock inside */
 				m_NCS_LOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);	/* must lock again!!! */
+				/* Only the last give() woke us; this pairs with the release
+				   of the earlier give()s so their take()rs are done with the cell */
+				(void)__atomic_load_n(&cell->state, __ATOMIC_ACQUIRE);
 			}
 			hm_free_cell(cell, hdl, true);
+			break;
 		}
 	}
 	m_NCS_UNLOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
@@ -379,34 +395,37 @@ NCSCONTEXT ncshm_destroy_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
    PROCEDURE NAME:   ncshm_take_hdl
 
    DESCRIPTION:      If all validation stuff is in order return the associated
-                     data that this hdl leads to.
+                     data that this hdl leads to. Does not lock; the use count
+                     is bumped only while the cell is still busy with 'hdl'.
 
 *****************************************************************************/
 NCSCONTEXT ncshm_take_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
 {
 	HM_CELL *cell = NULL;
 	HM_HDL *hdl = (HM_HDL *)&uhdl;
-	NCSCONTEXT data = NULL;
 	uint32_t pool_id = 0;
+	uint32_t state;
 
 	pool_id = m_HM_DETM_POOL_FRM_HDL(&uhdl);
 	if (pool_id >= HM_POOL_CNT)
 		return NULL;
 
-	m_NCS_LOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
-
-	if ((cell = hm_find_cell(hdl)) != NULL) {
-		if ((cell->seq_id == hdl->seq_id) && ((NCS_SERVICE_ID)cell->svc_id == id) && (cell->busy == true)) {
-			if (++cell->use_ct == 0) {
-				m_LEAP_DBG_SINK_VOID;	/* Too many takes()s!! */
-			}
+	if ((cell = hm_find_cell(hdl)) == NULL)
+		return NULL;
 
-			data = cell->data;
+	state = __atomic_load_n(&cell->state, __ATOMIC_ACQUIRE);
+	while (m_HM_STATE_MATCH(state, hdl, id)) {
+		if (HM_STATE_USE_CT(state) == HM_STATE_USE_MAX) {
+			m_LEAP_DBG_SINK_VOID;	/* Too many takes()s!! */
+			return NULL;
 		}
+
+		if (__atomic_compare_exchange_n(&cell->state, &state, state + HM_STATE_USE_ONE, true,
+						__ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+			return cell->data;
 	}
 
-	m_NCS_UNLOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
-	return data;
+	return NULL;
 }
 
 /*****************************************************************************
@@ -414,7 +433,8 @@ NCSCONTEXT ncshm_take_hdl(NCS_SERVICE_ID id, uint32_t uhdl)
    PROCEDURE NAME:   ncshm_give_hdl
 
    DESCRIPTION:      Inform Hdl Manager that you are done with associated 
-                     data.
+                     data. Does not lock, unless a destroy()er is waiting for
+                     this give().
 
 *****************************************************************************/
 void ncshm_give_hdl(uint32_t uhdl)
@@ -422,25 +442,29 @@ void ncshm_give_hdl(uint32_t uhdl)
 	HM_CELL *cell = NULL;
 	HM_HDL *hdl = (HM_HDL *)&uhdl;
 	uint32_t pool_id = 0;
+	uint32_t state;
 
 	pool_id = m_HM_DETM_POOL_FRM_HDL(&uhdl);
 	if (pool_id >= HM_POOL_CNT)
 		return;
 
-	m_NCS_LOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
+	if ((cell = hm_find_cell(hdl)) == NULL)
+		return;
 
-	if ((cell = hm_find_cell(hdl)) != NULL) {
-		if (cell->seq_id == hdl->seq_id) {
-			if (--cell->use_ct < 1) {
-				m_LEAP_DBG_SINK_VOID;	/* Client BUG..Too many give()s!! */
-				cell->use_ct++;
-			} else {
-				if ((cell->busy == false) && (cell->use_ct == 1))
-					hm_unblock_him(cell);
-			}
+	state = __atomic_load_n(&cell->state, __ATOMIC_RELAXED);
+	do {
+		if (HM_STATE_SEQ_ID(state) != hdl->seq_id)
+			return;
+
+		if (HM_STATE_USE_CT(state) <= 1) {
+			m_LEAP_DBG_SINK_VOID;	/* Client BUG..Too many give()s!! */
+			return;
 		}
-	}
-	m_NCS_UNLOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
+	} while (!__atomic_compare_exchange_n(&cell->state, &state, state - HM_STATE_USE_ONE, true,
+					      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	if (!(state & HM_STATE_BUSY) && (HM_STATE_USE_CT(state) == 2))
+		hm_unblock_him(cell, (uint8_t)pool_id);
 }
 
 /***************************************************************************
@@ -494,12 +518,14 @@ HM_CELL *hm_find_cell(HM_HDL *hdl)
 	HM_UNIT *unit;
 	HM_CELLS *spot;
 
-	if ((unit = gl_hm.unit[hdl->idx1]) == NULL) {
+	/* take()/give() get here without the pool lock; pair with the
+	   release stores of hm_make_free_cells() and hm_target_cell() */
+	if ((unit = __atomic_load_n(&gl_hm.unit[hdl->idx1], __ATOMIC_ACQUIRE)) == NULL) {
 		m_LEAP_DBG_SINK_VOID;
 		return NULL;
 	}
 
-	if ((spot = unit->cells[hdl->idx2]) == NULL) {
+	if ((spot = __atomic_load_n(&unit->cells[hdl->idx2], __ATOMIC_ACQUIRE)) == NULL) {
 		m_LEAP_DBG_SINK_VOID;
 		return NULL;
 	}
@@ -526,6 +552,9 @@ void hm_free_cell(HM_CELL *cell, HM_HDL *hdl, bool recycle)
 	if (free->hdl.seq_id == 0)
 		free->hdl.seq_id++;	/* seq_id must be non-zero always */
 
+	/* not busy, so stale take()s and give()s leave it alone */
+	__atomic_store_n(&free->state, free->hdl.seq_id, __ATOMIC_RELEASE);
+
 	pmgr = &gl_hm.pool[m_HM_POOL_ID((uint8_t)free->hdl.idx1)];
 	free->next = pmgr->free_pool;
 	pmgr->free_pool = free;
@@ -555,7 +584,7 @@ uint32_t hm_make_free_cells(HM_PMGR *pmgr)
 			return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
 
 		memset(unit, 0, sizeof(HM_UNIT));
-		gl_hm.unit[pmgr->curr] = unit;
+		__atomic_store_n(&gl_hm.unit[pmgr->curr], unit, __ATOMIC_RELEASE);
 	}
 
 	/* another million hdls used up ?? */
@@ -580,7 +609,7 @@ uint32_t hm_make_free_cells(HM_PMGR *pmgr)
 		.idx3 = 0
 	};
 
-	unit->cells[unit->curr++] = cells;	/* update curr++ for next time */
+	__atomic_store_n(&unit->cells[unit->curr++], cells, __ATOMIC_RELEASE);	/* update curr++ for next time */
 
 	for (i = 0; i < HM_CELL_CNT; i++) {	/* carve um up and put in free-po0l */
 		hdl.idx3 = i;
@@ -628,7 +657,7 @@ HM_FREE *hm_target_cell(HM_HDL *hdl)
 		}
 
 		memset(unit, 0, sizeof(HM_UNIT));
-		gl_hm.unit[hdl->idx1] = unit;
+		__atomic_store_n(&gl_hm.unit[hdl->idx1], unit, __ATOMIC_RELEASE);
 	}
 
 	if ((cells = unit->cells[hdl->idx2]) == NULL) {
@@ -643,7 +672,7 @@ HM_FREE *hm_target_cell(HM_HDL *hdl)
 		tmp_hdl.idx2 = hdl->idx2;
 		tmp_hdl.seq_id = 0;
 
-		unit->cells[hdl->idx2] = cells;	/* put it where it goes */
+		__atomic_store_n(&unit->cells[hdl->idx2], cells, __ATOMIC_RELEASE);	/* put it where it goes */
 
 		for (i = 0; i < HM_CELL_CNT; i++) {	/* carve um up and put in free-pool */
 			tmp_hdl.idx3 = i;
@@ -679,29 +708,33 @@ HM_FREE *hm_target_cell(HM_HDL *hdl)
    PROCEDURE NAME:   hm_block_me
 
    DESCRIPTION:      The destroy()er found ref-count > 1; pend this thread.
+                     Called with the pool lock held, which the give()r needs
+                     to find us in the pool's wait list.
 
 *****************************************************************************/
 
 void hm_block_me(HM_CELL *cell, uint8_t pool_id)
 {
 	int rc;
-	sem_t sem;
+	HM_WAIT wait;
 	m_HM_STAT_CRASH(gl_hm.woulda_crashed);
 
-	rc = sem_init(&sem, 0, 0);		/* Create a semaphor to block this thread */
+	rc = sem_init(&wait.sem, 0, 0);	/* Create a semaphor to block this thread */
 	osafassert(rc == 0);
-	cell->data = &sem;
+	wait.cell = cell;
+	wait.next = gl_hm.wait[pool_id];
+	gl_hm.wait[pool_id] = &wait;
 	m_NCS_UNLOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);	/* let others run */
 
 wait_again:						/* stay here till refcount == 1 */
-	if (sem_wait(&sem) == -1) {
+	if (sem_wait(&wait.sem) == -1) {
 		if (errno == EINTR)
 			goto wait_again;
 		else
 			osafassert(0);
 	}
 
-	(void)sem_destroy(&sem);	/* OK, all set, continue on.... */
+	(void)sem_destroy(&wait.sem);	/* OK, all set, continue on.... */
 }
 
 /*****************************************************************************
@@ -713,10 +746,30 @@ wait_again:						/* stay here till refcount == 1 */
 
 *****************************************************************************/
 
-void hm_unblock_him(HM_CELL *cell)
+void hm_unblock_him(HM_CELL *cell, uint8_t pool_id)
 {
-	int rc = sem_post((sem_t*)cell->data);	/* unblock that destroy thread */
-	osafassert(rc == 0);
+	HM_WAIT **wait;
+	HM_WAIT *found = NULL;
+	int rc;
+
+	m_NCS_LOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
+
+	for (wait = &gl_hm.wait[pool_id]; *wait != NULL; wait = &(*wait)->next) {
+		if ((*wait)->cell == cell) {
+			found = *wait;
+			*wait = found->next;	/* splice it out */
+			break;
+		}
+	}
+
+	if (found != NULL) {
+		rc = sem_post(&found->sem);	/* unblock that destroy thread */
+		osafassert(rc == 0);
+	} else {
+		m_LEAP_DBG_SINK_VOID;
+	}
+
+	m_NCS_UNLOCK(&gl_hm.lock[pool_id], NCS_LOCK_WRITE);
 }
 
 /***************************************************************************
@@ -40,6 +40,7 @@
   Encode functions
 
   ncs_enc_init_space.......get NCS_UBAID to start state
+  ncs_enc_init_space_contig get NCS_UBAID to start state in contiguous mode
   ncs_enc_prime_space......get NCS_UBAID to start state w/passed USRBUF
   ncs_enc_reserve_space....reserve 'n' bytes of contiguous space
   ncs_enc_claim_space......claim 'm' of the 'n' bytes reserved (m <= n).
@@ -69,9 +70,14 @@
 #include "base/ncssysf_mem.h"
 #include "base/ncsencdec_pub.h"
 #include "base/ncsusrbuf.h"
+#include "base/usrbuf.h"
 
 #define SIXTYFOUR_BYTES 64
 
+/* Largest segment a contiguous-mode NCS_UBAID doubles up to; larger
+   reservations still get a segment of their own size. */
+#define NCS_UBA_CONTIG_MAX_SEG (1024 * 1024)
+
 /*****************************************************************************
 
                         ! !   W A R N I N G   ! !     
@@ -83,6 +89,7 @@
     That is, it is impossible to reserve more bytes then there are in payload
     area of a single USRDATA, in the NetPlane implementation of USRBUFs.
     .
+    An NCS_UBAID set up by ncs_enc_init_space_contig() has no such limit.
 *****************************************************************************/
 
 /*****************************************************************************
@@ -111,6 +118,7 @@ int32_t ncs_enc_init_space(NCS_UBAID *uba)
 	uba->ub = uba->start;
 	uba->res = 0;
 	uba->ttl = 0;
+	uba->contig = false;
 
 	return NCSCC_RC_SUCCESS;
 }
@@ -147,10 +155,108 @@ int32_t ncs_enc_init_space_pp(NCS_UBAID *uba, uint8_t pool_id, uint8_t priority)
 	uba->ub = uba->start;
 	uba->res = 0;
 	uba->ttl = 0;
+	uba->contig = false;
 
 	return NCSCC_RC_SUCCESS;
 }
 
+/*****************************************************************************
+
+  PROCEDURE NAME:    ncs_enc_init_space_contig
+
+  DESCRIPTION:
+        Same as ncs_enc_init_space_pp, except that the NCS_UBAID is put in
+        contiguous mode: every reservation, of any size, is satisfied from
+        a single payload area, and the USRBUF chain grows by large
+        segments (doubling in size) instead of PAYLOAD_BUF_SIZE ones.
+
+  ARGUMENTS:
+ uba:  NCS_UBAID to be initialized.
+        pool_id:        which USRBUF pool_id should mem come from
+        size:           expected encoded size, 0 if not known
+
+  RETURNS:
+ NCSCC_RC_SUCCESS got space commitment
+        NCSCC_RC_FAILURE space not reserved.
+
+  NOTES:
+        Encoders keep pointers into space reserved earlier (to back-patch
+        counts and lengths), so data is never moved once encoded; a full
+        segment is followed by a new one rather than reallocated.
+
+*****************************************************************************/
+
+int32_t ncs_enc_init_space_contig(NCS_UBAID *uba, uint8_t pool_id, uint32_t size)
+{
+	NCSUB_POOL *pool = m_NCSMMGR_UB_GETPOOL(pool_id);
+
+	if (pool == NULL)
+		return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
+
+	/* Leave room for the headers and trailers the pool owner adds */
+	size += pool->hdr_reserve + pool->trlr_reserve;
+	if ((uba->start = m_MMGR_ALLOC_LARGE_POOLBUFR(pool_id, NCSMEM_HI_PRI, size)) == BNULL)
+		return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
+
+	uba->ub = uba->start;
+	uba->res = 0;
+	uba->ttl = 0;
+	uba->contig = true;
+
+	return NCSCC_RC_SUCCESS;
+}
+
+/*****************************************************************************
+
+  PROCEDURE NAME:    ncs_enc_grow_space
+
+  DESCRIPTION:
+ make sure the last USRBUF of a contiguous-mode NCS_UBAID has room
+        for "size" more octets, linking a new, larger segment if not.
+
+  ARGUMENTS:
+ uba:  NCS_UBAID in contiguous mode.
+        size:           how much space is needed.
+
+  RETURNS:
+ NCSCC_RC_SUCCESS room is available in uba->ub
+        NCSCC_RC_FAILURE out of memory
+
+  NOTES:
+        Mirrors the space check of sysf_reserve_at_end_amap(), which then
+        finds the room without allocating.
+
+*****************************************************************************/
+
+static uint32_t ncs_enc_grow_space(NCS_UBAID *uba, uint32_t size)
+{
+	USRBUF *ub = uba->ub;
+	USRBUF *seg;
+	uint32_t used;
+	uint32_t seg_size;
+
+	while (ub->link != BNULL)
+		ub = ub->link;
+	uba->ub = ub;
+
+	used = ub->pool_ops->trlr_reserve + ub->start + ub->count;
+	if ((ub->payload->RefCnt == 1) && (used <= ub->payload->Size) && (ub->payload->Size - used >= size))
+		return NCSCC_RC_SUCCESS;
+
+	seg_size = ub->payload->Size;
+	if (seg_size < NCS_UBA_CONTIG_MAX_SEG)
+		seg_size *= 2;
+	if (seg_size < size + ub->pool_ops->hdr_reserve + ub->pool_ops->trlr_reserve)
+		seg_size = size + ub->pool_ops->hdr_reserve + ub->pool_ops->trlr_reserve;
+
+	if ((seg = m_MMGR_ALLOC_LARGE_POOLBUFR(ub->pool_ops->pool_id, NCSMEM_HI_PRI, seg_size)) == BNULL)
+		return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
+
+	ub->link = seg;
+	uba->ub = seg;
+	return NCSCC_RC_SUCCESS;
+}
+
 /*****************************************************************************
 
   PROCEDURE NAME:    ncs_enc_prime_space
@@ -174,6 +280,7 @@ void ncs_enc_prime_space(NCS_UBAID *uba, USRBUF *ub)
 	uba->ub = ub;
 	uba->res = 0;
 	uba->ttl = 0;
+	uba->contig = false;
 }
 
 /*****************************************************************************
@@ -221,11 +328,19 @@ void ncs_enc_append_usrbuf(NCS_UBAID *uba, USRBUF *ub)
       only 64 bytes. 'Well behaved' IE encode routines understand this,
       and never try to encode more that 64 bytes anyway.
 
+      In contiguous mode any amount of space can be reserved.
+
 *****************************************************************************/
 
 uint8_t *ncs_enc_reserve_space(NCS_UBAID *uba, int32_t res)
 {
-	if (res > PAYLOAD_BUF_SIZE) {	/* can never reserve > min payload of USRBUF */
+	if (uba->contig) {
+		if ((res < 0) || (ncs_enc_grow_space(uba, (uint32_t)res) != NCSCC_RC_SUCCESS)) {
+			uba->res = 0;
+			uba->bufp = NULL;
+			return NULL;
+		}
+	} else if (res > PAYLOAD_BUF_SIZE) {	/* can never reserve > min payload of USRBUF */
 		res = PAYLOAD_BUF_SIZE;
 	}
 
@@ -299,6 +414,7 @@ void ncs_dec_init_space(NCS_UBAID *uba, USRBUF *ub)
 	uba->ub = ub;
 	uba->res = 0;
 	uba->ttl = 0;
+	uba->contig = false;
 	uba->max = m_MMGR_LINK_DATA_LEN(ub);	/* find max amount of data as of now */
 }
 
@@ -487,6 +603,7 @@ void ncs_reset_uba(NCS_UBAID *uba)
 	uba->res = 0;
 	uba->ttl = 0;
 	uba->max = 0;
+	uba->contig = false;
 }
 
 /***************************************************************\
@@ -718,6 +835,10 @@ uint32_t ncs_encode_n_octets_in_uba(NCS_UBAID *uba, uint8_t *os, unsigned int co
 			return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
 	}
 
+	/* In contiguous mode, the octets go into a single payload area */
+	if (uba->contig && (ncs_enc_grow_space(uba, count) != NCSCC_RC_SUCCESS))
+		return NCSCC_RC_FAILURE;
+
 	for (remaining = count; remaining > 0; remaining -= try_put) {
 		/* The no of bytes to be put in the current payload has
 		   to be the least of
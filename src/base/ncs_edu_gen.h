@@ -0,0 +1,215 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION:
+
+  Support for the EDU functions generated by edugen (src/base/edugen.cc).
+
+  edugen reads the EDU_INST_SET tables of a source file and generates one
+  function per table, named after the table with a "_gen" suffix. The
+  generated function encodes/decodes the builtin fields of the table into
+  a NCS_UBAID without interpreting the rules, and runs the remaining rules
+  through ncs_edu_run_rule(). The wire format is the one of
+  ncs_edu_run_rules(), which is still used for TLV buffers, selective
+  encode/decode and linked-lists.
+
+  An EDP switches to the generated function by replacing
+  m_NCS_EDU_RUN_RULES with m_NCS_EDU_RUN_GEN_RULES.
+..............................................................................
+
+******************************************************************************
+*/
+
+#ifndef BASE_NCS_EDU_GEN_H_
+#define BASE_NCS_EDU_GEN_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include "base/ncs_edu_pub.h"
+#include "base/ncsencdec_pub.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/* Largest number of bytes encoded/decoded in one go by a generated
+   function, for a run of builtin fields */
+#define EDU_GEN_MAX_RUN_SIZE 128
+
+/* Address of the field of rule "indx" */
+#define m_EDU_GEN_FLD(ptr, prog, indx) ((uint8_t *)(ptr) + (prog)[indx].fld5)
+
+/* Address of the length field of variable-sized-data rule "indx" */
+#define m_EDU_GEN_LEN_FLD(ptr, prog, indx) ((uint8_t *)(ptr) + (prog)[indx].fld6)
+
+/* To be invoked in an EDU program instead of m_NCS_EDU_RUN_RULES, when
+   the source file is processed by edugen. */
+#define m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, prog, ptr, ptr_data_len, buf_env, optype, o_err) \
+  prog##_gen(edu_hdl, edu_tkn, prog, ptr, ptr_data_len, buf_env, optype, o_err, \
+             sizeof(prog)/sizeof(EDU_INST_SET))
+
+/* When false, the generated functions run the interpreter instead */
+extern bool gl_edu_gen_enabled;
+
+int ncs_edu_run_rule(EDU_HDL *edu_hdl, EDU_INST_SET prog[], int indx,
+                     NCSCONTEXT ptr, uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env,
+                     EDP_OP_TYPE optype, EDU_ERR *o_err, int instr_count);
+
+/* Whether a generated function, made from a table of "gen_count" rules,
+   may encode/decode, or has to leave it to the interpreter. */
+static inline bool ncs_edu_gen_usable(EDU_TKN *edu_tkn, EDU_BUF_ENV *buf_env,
+                                      EDP_OP_TYPE optype, int instr_count, int gen_count)
+{
+  if (!gl_edu_gen_enabled || !buf_env->is_ubaid || (instr_count != gen_count))
+    return false;
+  if ((optype != EDP_OP_TYPE_ENC) && (optype != EDP_OP_TYPE_DEC))
+    return false;
+  /* Selective encode/decode */
+  if ((edu_tkn != NULL) && (edu_tkn->var_cnt != 0))
+    return false;
+  return true;
+}
+
+static inline uint32_t ncs_edu_gen_enc_octets(NCS_UBAID *uba, const uint8_t *os, uint32_t count)
+{
+  while (count != 0) {
+    uint32_t chunk = (count > PAYLOAD_BUF_SIZE) ? PAYLOAD_BUF_SIZE : count;
+    uint8_t *p8 = ncs_enc_reserve_space(uba, chunk);
+
+    if (p8 == NULL)
+      return NCSCC_RC_FAILURE;
+    memcpy(p8, os, chunk);
+    ncs_enc_claim_space(uba, chunk);
+    os += chunk;
+    count -= chunk;
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+static inline uint32_t ncs_edu_gen_dec_octets(NCS_UBAID *uba, uint8_t *os, uint32_t count)
+{
+  uint8_t *p8;
+
+  if (count == 0)
+    return NCSCC_RC_SUCCESS;
+  p8 = ncs_dec_flatten_space(uba, os, count);
+  if (p8 == NULL)
+    return NCSCC_RC_FAILURE;
+  if (p8 != os)
+    memcpy(os, p8, count);
+  ncs_dec_skip_space(uba, count);
+  return NCSCC_RC_SUCCESS;
+}
+
+/* Array of char, encoded as a string with a 16-bit length */
+static inline uint32_t ncs_edu_gen_enc_chars(NCS_UBAID *uba, const char *str)
+{
+  uint16_t len = strlen(str);
+  uint8_t *p8 = ncs_enc_reserve_space(uba, 2);
+
+  if (p8 == NULL)
+    return NCSCC_RC_FAILURE;
+  ncs_encode_16bit(&p8, len);
+  ncs_enc_claim_space(uba, 2);
+  return ncs_edu_gen_enc_octets(uba, (const uint8_t *)str, len);
+}
+
+static inline uint32_t ncs_edu_gen_dec_chars(NCS_UBAID *uba, char *str)
+{
+  uint16_t len = 0;
+  uint8_t *p8 = ncs_dec_flatten_space(uba, (uint8_t *)&len, 2);
+
+  if (p8 == NULL)
+    return NCSCC_RC_FAILURE;
+  len = ncs_decode_16bit(&p8);
+  ncs_dec_skip_space(uba, 2);
+  return ncs_edu_gen_dec_octets(uba, (uint8_t *)str, len);
+}
+
+/* Array of 2, 4 or 8 byte integers */
+static inline uint32_t ncs_edu_gen_enc_array(NCS_UBAID *uba, const uint8_t *src, uint32_t count, uint32_t size)
+{
+  for (; count != 0; count--, src += size) {
+    uint8_t *p8 = ncs_enc_reserve_space(uba, size);
+
+    if (p8 == NULL)
+      return NCSCC_RC_FAILURE;
+    if (size == 2)
+      ncs_encode_16bit(&p8, *(const uint16_t *)src);
+    else if (size == 4)
+      ncs_encode_32bit(&p8, *(const uint32_t *)src);
+    else
+      ncs_encode_64bit(&p8, *(const uint64_t *)src);
+    ncs_enc_claim_space(uba, size);
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+static inline uint32_t ncs_edu_gen_dec_array(NCS_UBAID *uba, uint8_t *dst, uint32_t count, uint32_t size)
+{
+  for (; count != 0; count--, dst += size) {
+    uint64_t tmp = 0;
+    uint8_t *p8 = ncs_dec_flatten_space(uba, (uint8_t *)&tmp, size);
+
+    if (p8 == NULL)
+      return NCSCC_RC_FAILURE;
+    if (size == 2)
+      *(uint16_t *)dst = ncs_decode_16bit(&p8);
+    else if (size == 4)
+      *(uint32_t *)dst = ncs_decode_32bit(&p8);
+    else
+      *(uint64_t *)dst = ncs_decode_64bit(&p8);
+    ncs_dec_skip_space(uba, size);
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+/* Variable-sized uint8_t/char data, "count" octets */
+static inline uint32_t ncs_edu_gen_dec_var_octets(NCS_UBAID *uba, uint8_t **os, uint32_t count, EDU_ERR *o_err)
+{
+  if (count == 0)
+    return NCSCC_RC_SUCCESS;
+  *os = (uint8_t *)malloc(count);
+  if (*os == NULL) {
+    *o_err = EDU_ERR_MEM_FAIL;
+    return NCSCC_RC_FAILURE;
+  }
+  memset(*os, '\0', count);
+  if (ncs_decode_n_octets_from_uba(uba, *os, count) != NCSCC_RC_SUCCESS) {
+    *o_err = EDU_ERR_MEM_FAIL;
+    return NCSCC_RC_FAILURE;
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+static inline uint32_t ncs_edu_gen_enc_string(EDU_HDL *edu_hdl, EDU_BUF_ENV *buf_env, char *str,
+                                              uint32_t *ptr_data_len, EDU_ERR *o_err)
+{
+  *ptr_data_len = (str != NULL) ? strlen(str) : 0;
+  return ncs_edp_string(edu_hdl, NULL, str, ptr_data_len, buf_env, EDP_OP_TYPE_ENC, o_err);
+}
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // BASE_NCS_EDU_GEN_H_
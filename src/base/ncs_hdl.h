@@ -39,6 +39,7 @@
 #ifndef BASE_NCS_HDL_H_
 #define BASE_NCS_HDL_H_
 
+#include <semaphore.h>
 #include "base/ncs_hdl_pub.h"
 
 /* NCS_LOCK now defined from below include file */
@@ -63,6 +64,10 @@
   - Hdl Mgr will allow any number of take()r threads to have the data at
     the same time. This increments a refcount.
 
+  - take() and give() never lock the handle pool; the refcount is updated
+    atomically. Only create(), declare() and destroy() lock the pool, and
+    a give()r only does so to wake a blocked destroy()er.
+
   - A take()r will fail if the handle referenced has been destroy()ed or is
     in the process of being destroy()ed.
 
@@ -159,28 +164,53 @@ typedef struct hm_hdl {
 
 /***************************************************************************
  * Internal CELL stores private state info and client data mapped to handle
+ *
+ * take() and give() do not lock the pool; they compare-and-swap the 'state'
+ * word, which packs the sequence ID, service ID, busy flag and use count
+ * of the cell (see HM_STATE_ below). 'data' is only read by a take()r that
+ * has bumped the use count of a busy cell, so it is stable until give().
  ***************************************************************************/
 
 typedef struct hm_cell {
   NCSCONTEXT data;        /* This is the stored data thing */
-
-  uint32_t seq_id:4;              /* sequence ID must match for valid key find */
-  uint32_t svc_id:12;     /* Service ID of owning subsystem */
-  uint32_t busy:1;                /* sub-type of datat stored in context */
-  uint32_t use_ct:11;     /* Use Count; Multiple readers, once created */
+  uint32_t state;         /* seq_id, svc_id, busy, use_ct; atomic access */
+  HM_HDL hdl;             /* Not used while the cell is in use */
 
 } HM_CELL;
 
+#define HM_STATE_SEQ_ID(s)  ((s) & 0xf)             /* 4 bits  */
+#define HM_STATE_SVC_ID(s)  (((s) >> 4) & 0xfff)    /* 12 bits */
+#define HM_STATE_BUSY       0x10000                 /* 1 bit   */
+#define HM_STATE_USE_ONE    0x20000
+#define HM_STATE_USE_CT(s)  ((s) >> 17)             /* 15 bits */
+#define HM_STATE_USE_MAX    0x7fff
+
+#define HM_STATE_MAKE(seq, svc, use_ct) \
+  (((seq) & 0xf) | (((svc) & 0xfff) << 4) | HM_STATE_BUSY | \
+   ((uint32_t)(use_ct) << 17))
+
 /***************************************************************************
  * When not a CELL, a CELL is on the free-cell list and looks like this
  ***************************************************************************/
 
 typedef struct hm_free {
   struct hm_free *next;   /* linked list of free/available cells */
+  uint32_t state;         /* seq_id of next use; never busy when free */
   HM_HDL hdl;             /* The place where this memory lives */
 
 } HM_FREE;
 
+/***************************************************************************
+ * A destroy()er waiting for the use count of a cell to drop to one
+ ***************************************************************************/
+
+typedef struct hm_wait {
+  struct hm_wait *next;   /* other destroy()ers blocked in the same pool */
+  HM_CELL *cell;          /* the cell being destroyed */
+  sem_t sem;              /* posted by the last give()r */
+
+} HM_WAIT;
+
 /***************************************************************************
  * CELLs are allocated in hunks
  ***************************************************************************/
@@ -249,6 +279,7 @@ typedef struct hm_core {
   NCS_LOCK lock[HM_POOL_CNT];     /* Lock for each pool */
   HM_UNIT *unit[HM_UNIT_CNT];     /* Name space units */
   HM_PMGR pool[HM_POOL_CNT];      /* pools of name space units */
+  HM_WAIT *wait[HM_POOL_CNT];     /* blocked destroy()ers of each pool */
 
   uint32_t woulda_crashed;        /* # times destroy thread blocked */
 
@@ -304,7 +335,7 @@ uint32_t hm_make_free_cells(HM_PMGR *pmgr);
 
 void hm_block_me(HM_CELL *cell, uint8_t pool_id);
 
-void hm_unblock_him(HM_CELL *cell);
+void hm_unblock_him(HM_CELL *cell, uint8_t pool_id);
 
 /***************************************************************************
 
@@ -655,6 +655,16 @@ uint32_t ncs_os_posix_shm(NCS_OS_POSIX_SHM_REQ_INFO *req);
 uint32_t ncs_sel_obj_create(NCS_SEL_OBJ *o_sel_obj);
 #define     m_NCS_SEL_OBJ_CREATE(o_sel_obj) ncs_sel_obj_create(o_sel_obj)
 
+/****************************************************************************
+   ncs_sel_obj_create_event: As ncs_sel_obj_create(), but the selection-
+                        object is a single non-blocking eventfd. Any number
+                        of indications raised on it are removed by one
+                        non-blocking m_NCS_SEL_OBJ_RMV_IND.
+
+\****************************************************************************/
+uint32_t ncs_sel_obj_create_event(NCS_SEL_OBJ *o_sel_obj);
+#define     m_NCS_SEL_OBJ_CREATE_EVENT(o_sel_obj) ncs_sel_obj_create_event(o_sel_obj)
+
 /****************************************************************************\
 
    ncs_sel_obj_destroy: Destroys a selection-object
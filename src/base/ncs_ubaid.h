@@ -69,6 +69,7 @@ typedef struct ncs_ubaid {
   int32_t res;    /* space reserved          Not Used                      */
   int32_t ttl;    /* total space claimed     total space consumed          */
   int32_t max;    /* max we can encode       max we can decode             */
+  bool contig;    /* contiguous mode         Not used                      */
 } NCS_UBAID;
 
 /*@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
@@ -81,6 +82,7 @@ typedef struct ncs_ubaid {
 
 int32_t ncs_enc_init_space(NCS_UBAID *uba);
 int32_t ncs_enc_init_space_pp(NCS_UBAID *uba, uint8_t pool_id, uint8_t prio);
+int32_t ncs_enc_init_space_contig(NCS_UBAID *uba, uint8_t pool_id, uint32_t size);
 void ncs_enc_prime_space(NCS_UBAID *uba, USRBUF *ub);
 uint8_t *ncs_enc_reserve_space(NCS_UBAID *uba, int32_t res);
 void ncs_enc_claim_space(NCS_UBAID *uba, int32_t used);
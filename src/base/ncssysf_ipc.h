@@ -221,6 +221,13 @@ typedef struct ncs_ipc_msg {
  * NULL if there is no messages in IPC mailbox.
  */
 #define m_NCS_IPC_NON_BLK_RECEIVE(p_mbx, messagebuf)  ncs_ipc_non_blk_recv(p_mbx)
+
+/* Dequeue up to max_msgs messages at once, highest priority first, linked
+   through their "next" pointers. Saves a wakeup and a lock per message
+   when the mailbox has many queued */
+#define m_NCS_IPC_RECEIVE_BATCH(p_mbx, max_msgs)  ncs_ipc_recv_batch(p_mbx, max_msgs)
+
+#define m_NCS_IPC_NON_BLK_RECEIVE_BATCH(p_mbx, max_msgs)  ncs_ipc_non_blk_recv_batch(p_mbx, max_msgs)
 #if 0                           /* The following macro don't seem to be getting used anywhere:PM */
 #define m_NCS_IPC_NON_BLK_SEND(p_mbx, msg, prio)        \
   ncs_ipc_non_blk_send(p_mbx, (NCS_IPC_MSG *)msg, prio)
@@ -368,6 +375,8 @@ uint32_t ncs_ipc_detach(SYSF_MBX *mbx, NCS_IPC_CB cb, void *cb_arg);
 NCS_IPC_MSG *ncs_ipc_recv(SYSF_MBX *mbx);
 uint32_t ncs_ipc_send(SYSF_MBX *mbx, NCS_IPC_MSG *msg, NCS_IPC_PRIORITY prio);
 NCS_IPC_MSG *ncs_ipc_non_blk_recv(SYSF_MBX *mbx);
+NCS_IPC_MSG *ncs_ipc_recv_batch(SYSF_MBX *mbx, uint32_t max_msgs);
+NCS_IPC_MSG *ncs_ipc_non_blk_recv_batch(SYSF_MBX *mbx, uint32_t max_msgs);
 uint32_t ncs_ipc_non_blk_send(SYSF_MBX *mbx, NCS_IPC_MSG *msg, NCS_IPC_PRIORITY prio);
 uint32_t ncs_ipc_config_max_msgs(SYSF_MBX *mbx, NCS_IPC_PRIORITY prio, uint32_t max_limit);
 uint32_t ncs_ipc_config_usr_counters(SYSF_MBX *i_mbx, NCS_IPC_PRIORITY i_prio,
@@ -34,6 +34,7 @@
 #ifndef BASE_NCSSYSF_MEM_H_
 #define BASE_NCSSYSF_MEM_H_
 
+#include <sys/uio.h>
 #include "base/ncs_osprm.h"
 #include "base/ncssysf_lck.h"
 #include "base/ncsencdec_pub.h"
@@ -107,6 +108,12 @@ extern "C" {
  **/
 #define m_MMGR_ALLOC_BUFR(n)  (sysf_alloc_pkt(0,0,n,__LINE__,__FILE__)) /* Alloc short-term buffer */
 
+/** Macro to allocate a USRBUF with a payload area of "n" octets, at least
+ ** PAYLOAD_BUF_SIZE, from pool "i". Used for contiguous encoding of large
+ ** messages.
+ **/
+#define m_MMGR_ALLOC_LARGE_POOLBUFR(i,pr,n) (sysf_alloc_large_pkt(i,pr,n,__LINE__,__FILE__))
+
 /** Macro to free a USRBUF (packet buffer)...
  **/
 #define m_MMGR_FREE_BUFR(ub)  (sysf_free_pkt(ub))       /* Free short-term buffer */
@@ -169,7 +176,7 @@ void sysf_stub_free(void *data, uint8_t pool_id);
  **
  ** This macro must return an unsigned int.
  **/
-#define m_MMGR_TAILROOM(p)    (PAYLOAD_BUF_SIZE - (p)->start - (p)->count)
+#define m_MMGR_TAILROOM(p)    ((p)->payload->Size - (p)->start - (p)->count)
 
 /** Macro to fetch the count of payload data in a given USRBUF (chain)...
  **
@@ -179,6 +186,13 @@ void sysf_stub_free(void *data, uint8_t pool_id);
  **/
 #define m_MMGR_LINK_DATA_LEN(p)  sysf_get_chain_len(p)
 
+/** Macro to describe the first "len" octets of a USRBUF (chain) as an
+ ** array of at most "n" iovecs, for writev()/sendmsg() without copying.
+ **
+ ** This macro returns the number of iovecs used, or -1.
+ **/
+#define m_MMGR_IOVEC(p, len, iov, n)  sysf_usrbuf_iovec(p, len, iov, n)
+
 /** Macro to calculate the cksum of payload data in a given USRBUF (chain)...
  **
  ** "p" is a given USRBUF
@@ -516,6 +530,8 @@ void sysf_free_pkt(USRBUF *pb);
 
 USRBUF *sysf_alloc_pkt(unsigned char pool_id,
   unsigned char priority, int num, unsigned int line, char *file);
+USRBUF *sysf_alloc_large_pkt(unsigned char pool_id,
+  unsigned char priority, unsigned int size, unsigned int line, char *file);
 
 char *sysf_reserve_at_end(USRBUF **ppb, unsigned int size);
 char *sysf_reserve_at_end_amap(USRBUF **ppb, unsigned int *io_size, bool total);
@@ -543,6 +559,7 @@ USRBUF *sysf_copy_to_usrbuf(uint8_t *packet, unsigned int length);
 
 /** Computational routines **/
 uint32_t sysf_get_chain_len(const USRBUF *);
+int sysf_usrbuf_iovec(const USRBUF *ub, unsigned int len, struct iovec *iov, int iovcnt);
 void sysf_calc_usrbuf_cksum_1s_comp(USRBUF *const, unsigned int, uint16_t *const);
 
 void sysf_usrbuf_hexdump(USRBUF *buf, char *fname);
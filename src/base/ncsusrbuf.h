@@ -102,11 +102,15 @@ typedef void *USRDATA_EXTENT;
  * data. It also maintains a ref-count of how many USRBUFs are pointing to
  * it, which assists in the zero-copy paradigm and informs the memory free
  * routine if we really want to give the memory back to the owning pool.
+ *
+ * A large payload, allocated by sysf_alloc_large_pkt(), extends Data beyond
+ * PAYLOAD_BUF_SIZE octets. Size always holds the real size of Data.
  */
 
 typedef struct usrdata {
   USRDATA_EXTENT ue;      /* UserData Extensions                  */
   uint32_t RefCnt;        /* # of USRBUFs pointing to this block. */
+  uint32_t Size;          /* # of octets in the payload area.     */
   char Data[PAYLOAD_BUF_SIZE];    /* payload area ie. The Data  . */
 
 } USRDATA;
@@ -45,6 +45,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <pthread.h>
+#include <sys/eventfd.h>
 
 #include "base/sysf_exc_scr.h"
 #include "base/ncssysf_tsk.h"
@@ -52,6 +53,7 @@
 #include "base/ncssysf_def.h"
 #include "base/osaf_utility.h"
 #include "base/osaf_time.h"
+#include "base/osaf_poll.h"
 #include "base/logtrace.h"
 
 NCS_OS_LOCK gl_ncs_atomic_mtx;
@@ -1053,10 +1055,15 @@ uint32_t ncs_os_process_execute_timed(NCS_OS_PROC_EXECUTE_TIMED_INFO *req)
  *   These primitives make use "fd"s generated by "socket()" invocation as
  *   selection-objects. On LINUX, AF_UNIX sockets shall be used.
  *
+ *   A selection-object made by ncs_sel_obj_create_event() is a single
+ *   eventfd instead, used as both raise_obj and rmv_obj. Raising and
+ *   removing indications then costs no socket buffer handling.
+ *
  * Synopsis:
  *
  *   The following macros comprise the "ncs_sel_obj_*" primitive set
  *      m_NCS_SEL_OBJ_CREATE   =>   ncs_sel_obj_create()
+ *      m_NCS_SEL_OBJ_CREATE_EVENT => ncs_sel_obj_create_event()
  *      m_NCS_SEL_OBJ_DESTROY  =>   ncs_sel_obj_destroy()
  *      m_NCS_SEL_OBJ_IND      =>   ncs_sel_obj_ind()
  *      m_NCS_SEL_OBJ_RMV_IND  =>   ncs_sel_obj_rmv_ind()
@@ -1107,6 +1114,54 @@ uint32_t ncs_sel_obj_create(NCS_SEL_OBJ *o_sel_obj)
 	return NCSCC_RC_SUCCESS;
 }
 
+uint32_t ncs_sel_obj_create_event(NCS_SEL_OBJ *o_sel_obj)
+{
+	int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (fd == -1) {
+		syslog(LOG_ERR, "%s: eventfd failed - %s", __FUNCTION__, strerror(errno));
+		return NCSCC_RC_FAILURE;
+	}
+
+	o_sel_obj->raise_obj = fd;
+	o_sel_obj->rmv_obj = fd;
+
+	return NCSCC_RC_SUCCESS;
+}
+
+/* Removes indications from a selection-object made by
+   ncs_sel_obj_create_event(); see ncs_sel_obj_rmv_ind() */
+static int ncs_sel_obj_rmv_event(NCS_SEL_OBJ *i_ind_obj, bool nonblock, bool one_at_a_time)
+{
+	uint64_t inds;
+
+	for (;;) {
+		if (read(i_ind_obj->rmv_obj, &inds, sizeof(inds)) == sizeof(inds)) {
+			if (one_at_a_time && inds > 1) {
+				/* put the others back */
+				inds--;
+				if (write(i_ind_obj->raise_obj, &inds, sizeof(inds)) != sizeof(inds))
+					syslog(LOG_ERR, "%s: write failed - %s", __FUNCTION__, strerror(errno));
+				return 1;
+			}
+			return (inds > INT_MAX) ? INT_MAX : (int)inds;
+		}
+
+		if (errno == EINTR)
+			continue;
+
+		if (errno != EAGAIN) {
+			syslog(LOG_ERR, "%s: read failed - %s", __FUNCTION__, strerror(errno));
+			return -1;
+		}
+
+		if (nonblock)
+			return 0;
+
+		if (osaf_poll_one_fd(i_ind_obj->rmv_obj, -1) != 1)
+			return -1;
+	}
+}
 
 uint32_t ncs_sel_obj_destroy(NCS_SEL_OBJ *i_ind_obj)
 {
@@ -1125,6 +1180,14 @@ uint32_t ncs_sel_obj_rmv_operation_shut(NCS_SEL_OBJ *i_ind_obj)
 	if (i_ind_obj->rmv_obj == -1)
 		return NCSCC_RC_FAILURE;
 
+	if (i_ind_obj->raise_obj == i_ind_obj->rmv_obj) {
+		/* eventfd; the raise side goes with it */
+		close(i_ind_obj->rmv_obj);
+		i_ind_obj->raise_obj = -1;
+		i_ind_obj->rmv_obj = -1;
+		return NCSCC_RC_SUCCESS;
+	}
+
 	shutdown(i_ind_obj->rmv_obj, SHUT_RDWR);
 	close(i_ind_obj->rmv_obj);
 
@@ -1142,6 +1205,14 @@ uint32_t ncs_sel_obj_raise_operation_shut(NCS_SEL_OBJ *i_ind_obj)
 	if (i_ind_obj->raise_obj == -1)
 		return NCSCC_RC_FAILURE;
 
+	if (i_ind_obj->raise_obj == i_ind_obj->rmv_obj) {
+		/* eventfd; closed with the rmv side, here we only wake pollers */
+		uint64_t ind = 1;
+		if (write(i_ind_obj->raise_obj, &ind, sizeof(ind)) != sizeof(ind))
+			return NCSCC_RC_FAILURE;
+		return NCSCC_RC_SUCCESS;
+	}
+
 	shutdown(i_ind_obj->raise_obj, SHUT_RDWR);
 	close(i_ind_obj->raise_obj);
 
@@ -1162,6 +1233,19 @@ uint32_t ncs_sel_obj_ind(NCS_SEL_OBJ *i_ind_obj)
 		return NCSCC_RC_FAILURE;
 	}
 
+	if (i_ind_obj->raise_obj == i_ind_obj->rmv_obj) {
+		uint64_t ind = 1;
+
+		/* eventfd; only fails if the count would overflow */
+		while ((rc = write(i_ind_obj->raise_obj, &ind, sizeof(ind))) != sizeof(ind)) {
+			if (rc == -1 && errno == EINTR)
+				continue;
+			syslog(LOG_ERR, "%s: write failed - %s", __FUNCTION__, strerror(errno));
+			return NCSCC_RC_FAILURE;
+		}
+		return NCSCC_RC_SUCCESS;
+	}
+
 retry:
 	/* The following call can block, in such a case a failure is returned */
 	if ((rc = write(i_ind_obj->raise_obj, "A", 1)) != 1) {
@@ -1196,6 +1280,8 @@ int ncs_sel_obj_rmv_ind(NCS_SEL_OBJ *i_ind_obj, bool nonblock, bool one_at_a_tim
 		return NCSCC_RC_FAILURE;
 	}
 
+	if (i_ind_obj->raise_obj == i_ind_obj->rmv_obj)
+		return ncs_sel_obj_rmv_event(i_ind_obj, nonblock, one_at_a_time);
 	
 	/* If one_at_a_time == false, remove MAX_INDS_AT_A_TIME in a 
 	 * non-blocking way and count the number of indications 
@@ -34,6 +34,7 @@
   ncs_ipc_detach.....detach from an IPC "mailbox"
   ipc_flush.........internal routine to flush an IPC "mailbox"
   ncs_ipc_recv.......retrieve a message from an IPC "mailbox"
+  ncs_ipc_recv_batch.retrieve a list of messages from an IPC "mailbox"
   ncs_ipc_send.......send a message to an IPC "mailbox"
   ncs_ipc_config_max_msgs.....configure threshold limit of msgs
   ncs_ipc_config_usr_counters....allows a user to supply the address 
@@ -51,9 +52,12 @@
 #include "base/ncssysf_mem.h"
 #include "base/osaf_poll.h"
 
-static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block);
-static uint32_t ipc_enqueue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number);
-static uint32_t ipc_dequeue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number);
+static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block, uint32_t max_msgs);
+static uint32_t ipc_enqueue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number, bool *raise_ind);
+static uint32_t ipc_dequeue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number, uint32_t count);
+static uint32_t ipc_rmv_ind(NCS_IPC *ncs_ipc);
+static void ipc_collect(NCS_IPC_QUEUE *queue);
+static bool ipc_retract(NCS_IPC *ncs_ipc, unsigned int queue_number, NCS_IPC_MSG *msg);
 
 uint32_t ncs_ipc_create(SYSF_MBX *mbx)
 {
@@ -79,7 +83,7 @@ uint32_t ncs_ipc_create(SYSF_MBX *mbx)
 	ncs_ipc->ref_count = 0;
 	ncs_ipc->name = NULL;
 
-	rc = m_NCS_SEL_OBJ_CREATE(&ncs_ipc->sel_obj);
+	rc = m_NCS_SEL_OBJ_CREATE_EVENT(&ncs_ipc->sel_obj);
 	if (NCSCC_RC_SUCCESS == rc) {
 	} else {
 		m_NCS_LOCK_DESTROY(&ncs_ipc->queue_lock);
@@ -110,6 +114,7 @@ static uint32_t ipc_flush(NCS_IPC *ncs_ipc, NCS_IPC_CB remove_from_queue_cb, voi
 	/* walk queues asking if each item should be removed... */
 	for (ind = 0; ind < NCS_IPC_PRIO_LEVELS; ++ind) {
 		cur_queue = &ncs_ipc->queue[ind];
+		ipc_collect(cur_queue);
 
 		msg = cur_queue->head;
 		while (NULL != msg) {
@@ -130,7 +135,7 @@ static uint32_t ipc_flush(NCS_IPC *ncs_ipc, NCS_IPC_CB remove_from_queue_cb, voi
 						cur_queue->tail = p_prev;
 				}
 
-				ipc_dequeue_ind_processing(ncs_ipc, ind);
+				ipc_dequeue_ind_processing(ncs_ipc, ind, 1);
 			}
 			msg = p_next;
 		}
@@ -281,8 +286,9 @@ uint32_t ncs_ipc_detach(SYSF_MBX *mbx, NCS_IPC_CB remove_from_queue_cb, void *cb
 
 	m_NCS_LOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
 
-	/* decrement the reference count. */
-	m_NCS_ATOMIC_DEC(&ncs_ipc->ref_count);
+	/* decrement the reference count. Ordered before the flush collects the
+	   stacks, see ncs_ipc_send() */
+	__atomic_sub_fetch(&ncs_ipc->ref_count, 1, __ATOMIC_SEQ_CST);
 
 	if (NULL == remove_from_queue_cb)
 		rc = NCSCC_RC_SUCCESS;
@@ -297,23 +303,66 @@ uint32_t ncs_ipc_detach(SYSF_MBX *mbx, NCS_IPC_CB remove_from_queue_cb, void *cb
 
 NCS_IPC_MSG *ncs_ipc_recv(SYSF_MBX *mbx)
 {
-	return ncs_ipc_recv_common(mbx, true);
+	return ncs_ipc_recv_common(mbx, true, 1);
 }
 
 NCS_IPC_MSG *ncs_ipc_non_blk_recv(SYSF_MBX *mbx)
 {
-	return ncs_ipc_recv_common(mbx, false);
+	return ncs_ipc_recv_common(mbx, false, 1);
 }
 
-static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block)
+NCS_IPC_MSG *ncs_ipc_recv_batch(SYSF_MBX *mbx, uint32_t max_msgs)
+{
+	return ncs_ipc_recv_common(mbx, true, max_msgs);
+}
+
+NCS_IPC_MSG *ncs_ipc_non_blk_recv_batch(SYSF_MBX *mbx, uint32_t max_msgs)
+{
+	return ncs_ipc_recv_common(mbx, false, max_msgs);
+}
+
+/************************************************************************\
+  ipc_collect : Moves the messages senders have pushed on the stack of a
+                queue to the tail of its list, oldest first. Invoked with
+                the queue_lock held.
+\************************************************************************/
+static void ipc_collect(NCS_IPC_QUEUE *queue)
+{
+	NCS_IPC_MSG *msg, *p_next;
+	NCS_IPC_MSG *list = NULL;
+	NCS_IPC_MSG *tail;
+
+	if ((msg = __atomic_exchange_n(&queue->stack, NULL, __ATOMIC_ACQUIRE)) == NULL)
+		return;
+
+	tail = msg;		/* the newest message */
+	while (msg != NULL) {
+		p_next = msg->next;
+		msg->next = list;
+		list = msg;
+		msg = p_next;
+	}
+
+	if (NULL != queue->tail)
+		queue->tail->next = list;
+	else
+		queue->head = list;
+	queue->tail = tail;
+}
+
+static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block, uint32_t max_msgs)
 {
 	NCS_IPC *ncs_ipc;
+	NCS_IPC_QUEUE *queue;
 	NCS_IPC_MSG *msg;
+	NCS_IPC_MSG *msgs = NULL;
+	NCS_IPC_MSG **p_last = &msgs;
 	unsigned int active_queue;
-	int inds_rmvd;
+	uint32_t count;
+	bool empty;
 	NCS_SEL_OBJ mbx_obj;
 
-	if ((NULL == NCS_INT32_TO_PTR_CAST(mbx)) || (NULL == NCS_INT32_TO_PTR_CAST(*mbx)))
+	if ((NULL == NCS_INT32_TO_PTR_CAST(mbx)) || (NULL == NCS_INT32_TO_PTR_CAST(*mbx)) || (max_msgs == 0))
 		return NULL;
 
 	mbx_obj = m_NCS_IPC_GET_SEL_OBJ(mbx);
@@ -339,67 +388,54 @@ static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block)
 			ncshm_give_hdl((uint32_t)*mbx);
 			return NULL;
 		}
-		msg = NULL;
 
-		if (ncs_ipc->msg_count == 0) {
+		/* get items from head of the (ACTIVE) queues, highest priority first */
+		for (active_queue = 0; (active_queue < NCS_IPC_PRIO_LEVELS) && (max_msgs != 0); active_queue++) {
+			queue = &ncs_ipc->queue[active_queue];
+
+			for (count = 0; count < max_msgs; count++) {
+				if (queue->head == NULL) {
+					ipc_collect(queue);
+					if (queue->head == NULL)
+						break;
+				}
+
+				msg = queue->head;
+				if ((queue->head = msg->next) == NULL)
+					queue->tail = NULL;
+				msg->next = NULL;
+				*p_last = msg;
+				p_last = &msg->next;
+			}
+
+			if (count != 0) {
+				max_msgs -= count;
+				if (ipc_dequeue_ind_processing(ncs_ipc, active_queue, count) != NCSCC_RC_SUCCESS)
+					m_LEAP_DBG_SINK_VOID;
+			}
+		}
+
+		empty = (msgs == NULL && __atomic_load_n(&ncs_ipc->msg_count, __ATOMIC_SEQ_CST) == 0);
+		if (empty) {
 			/* 
 			   We may reach here due to the following reasons.
-			   Blocking case: Between the osaf_poll_one_fd() and m_NCS_LOCK() calls above,
-			   some thread detached from this mail-box, making this mailbox empty.
-			   In such a case by the time we reach here, all indications
-			   must have been removed.
-
-			   Non-blocking case: Between the time that the caller chose to call
-			   m_NCS_IPC_NON_BLK_RECV and the time that m_NCS_LOCK() was called,
-			   some thread detached from this mail-box, making this mailbox empty.
-			   In such a case by the time we reach here, all indications
-			   must have been removed.
+			   A sender raised its indication after we had already
+			   dequeued its message, some thread detached from this
+			   mail-box, making this mailbox empty, or the indication
+			   was raised without a message to wake up the receiver
+			   (as the CLM agent does for a stale handle). Remove the
+			   indication and return NULL, as before.
 			 */
-			inds_rmvd = m_NCS_SEL_OBJ_RMV_IND(&ncs_ipc->sel_obj, true, true);
-			if (inds_rmvd != 0) {
-				/* Should never reach here */
-				m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-				ncshm_give_hdl((uint32_t)*mbx);
-				m_LEAP_DBG_SINK_VOID;
-				return NULL;
-			} else {
-				m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-				ncshm_give_hdl((uint32_t)*mbx);
-				return NULL;
-			}
-		} else {
-			/* queue is non-empty. Retrieve the message */
-			/* get item from head of (ACTIVE) queue... */
-			for (active_queue = 0; active_queue < NCS_IPC_PRIO_LEVELS; active_queue++) {
-				if ((msg = ncs_ipc->queue[active_queue].head) != NULL) {
-
-					if ((ncs_ipc->queue[active_queue].head = msg->next) == NULL)
-						ncs_ipc->queue[active_queue].tail = NULL;
-					msg->next = NULL;
-					/* ncs_ipc->active_queue = active_queue ^ 0x01; */
-
-					if (ipc_dequeue_ind_processing(ncs_ipc, active_queue) != NCSCC_RC_SUCCESS) {
-						m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-						ncshm_give_hdl((uint32_t)*mbx);
-						m_LEAP_DBG_SINK_VOID;
-						return NULL;
-					} else {
-						m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-						ncshm_give_hdl((uint32_t)*mbx);
-						return msg;
-					}
-				}
-			}
-			/* We should never reach here. */
-			assert(0);
-			m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-			ncshm_give_hdl((uint32_t)*mbx);
-			m_LEAP_DBG_SINK_VOID;
-			return NULL;
+			ipc_rmv_ind(ncs_ipc);
 		}
 
 		m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
 		ncshm_give_hdl((uint32_t)*mbx);
+
+		/* A count with no message to be found means a sender is still
+		   pushing it; a blocking receive waits for it then. */
+		if ((msgs != NULL) || empty || (block == false))
+			return msgs;
 	}			/* end of while */
 }
 
@@ -407,77 +443,82 @@ static NCS_IPC_MSG *ncs_ipc_recv_common(SYSF_MBX *mbx, bool block)
 /************************************************************************\
   ipc_enqueue_ind_processing : Processing for NCS_IPC based on selection
                                objects.  This function is invoked, if a
-                               message is removed from SYSF_IPC queue.
+                               message is added to SYSF_IPC queue. Tells
+                               the sender to raise an indication, after
+                               its message is queued, if there were no
+                               messages queued.
 
                                Allowed states of <msg-count, ind-status>
                                combination are:
                                (1)  <zero, no indication>
                                (2)  <non-zero, exactly one ind raised>
+                               and, while senders and receivers race,
+                               (3)  <zero, indication raised>
+                               (4)  <non-zero, ind about to be raised>
 \************************************************************************/
-static uint32_t ipc_enqueue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number)
+static uint32_t ipc_enqueue_ind_processing(NCS_IPC *ncs_ipc, unsigned int queue_number, bool *raise_ind)
 {
-	if ((ncs_ipc->max_no_of_msgs[queue_number] != 0)
-	    && (ncs_ipc->no_of_msgs[queue_number] >= ncs_ipc->max_no_of_msgs[queue_number]))
-		return NCSCC_RC_FAILURE;
+	uint32_t no_of_msgs = __atomic_add_fetch(&ncs_ipc->no_of_msgs[queue_number], 1, __ATOMIC_RELAXED);
 
-	if (ncs_ipc->msg_count == 0) {
-		/* There are no messages queued, we shall raise an indication
-		   on the "sel_obj".  */
-		if (m_NCS_SEL_OBJ_IND(&ncs_ipc->sel_obj) != NCSCC_RC_SUCCESS) {
-			/* We would never reach here! */
-			assert(0);
-			return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
-		}
+	if ((ncs_ipc->max_no_of_msgs[queue_number] != 0) && (no_of_msgs > ncs_ipc->max_no_of_msgs[queue_number])) {
+		__atomic_sub_fetch(&ncs_ipc->no_of_msgs[queue_number], 1, __ATOMIC_RELAXED);
+		return NCSCC_RC_FAILURE;
 	}
-	ncs_ipc->msg_count++;	/* Don't think we need to check for 0xffffffff */
-
-	ncs_ipc->no_of_msgs[queue_number]++;
 
 	if (ncs_ipc->usr_counters[queue_number] != NULL)
-		*(ncs_ipc->usr_counters[queue_number]) = ncs_ipc->no_of_msgs[queue_number];
+		*(ncs_ipc->usr_counters[queue_number]) = no_of_msgs;
+
+	/* Don't think we need to check for 0xffffffff */
+	*raise_ind = (__atomic_fetch_add(&ncs_ipc->msg_count, 1, __ATOMIC_SEQ_CST) == 0);
 
 	return NCSCC_RC_SUCCESS;
 }
 
 /************************************************************************\
   ipc_dequeue_ind_processing : Processing for NCS_IPC based on selection
-                               objects.  This function is invoked, if a
-                               message is removed from SYSF_IPC queue.
-
-                               Allowed states of <msg-count, ind-status>
-                               combination are:
-                               (1)  <zero, no indication>
-                               (2)  <non-zero, exactly one ind raised>
+                               objects.  This function is invoked, if
+                               "count" messages are removed from a
+                               SYSF_IPC queue.
 \************************************************************************/
-static uint32_t ipc_dequeue_ind_processing(NCS_IPC *ncs_ipc, unsigned int active_queue)
+static uint32_t ipc_dequeue_ind_processing(NCS_IPC *ncs_ipc, unsigned int active_queue, uint32_t count)
 {
-	ncs_ipc->no_of_msgs[active_queue]--;
+	uint32_t no_of_msgs = __atomic_sub_fetch(&ncs_ipc->no_of_msgs[active_queue], count, __ATOMIC_RELAXED);
 
 	if (ncs_ipc->usr_counters[active_queue] != NULL)
-		*(ncs_ipc->usr_counters[active_queue]) = ncs_ipc->no_of_msgs[active_queue];
-
-	ncs_ipc->msg_count--;
-
-	if (ncs_ipc->msg_count == 0) {
-		int inds_rmvd = m_NCS_SEL_OBJ_RMV_IND(&ncs_ipc->sel_obj, true, true);
-		if (inds_rmvd <= 0) {
-			if (inds_rmvd != -1) {
-				/* The object has not been destroyed and it has no indication
-				   raised on it inspite of msg_count being non-zero.
-				 */
-				return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
-			}
-			/* The mbox must have been destroyed */
-			return NCSCC_RC_FAILURE;
-		}
+		*(ncs_ipc->usr_counters[active_queue]) = no_of_msgs;
+
+	if (__atomic_sub_fetch(&ncs_ipc->msg_count, count, __ATOMIC_SEQ_CST) == 0)
+		return ipc_rmv_ind(ncs_ipc);
+
+	return NCSCC_RC_SUCCESS;
+}
+
+/************************************************************************\
+  ipc_rmv_ind : Removes the indication(s) raised on an NCS_IPC found with
+                no messages queued. A sender may have counted its message
+                and raised its indication after the count dropped to zero
+                but before the indication was removed; raise it again
+                then.
+\************************************************************************/
+static uint32_t ipc_rmv_ind(NCS_IPC *ncs_ipc)
+{
+	if (m_NCS_SEL_OBJ_RMV_IND(&ncs_ipc->sel_obj, true, false) == -1) {
+		/* The mbox must have been destroyed */
+		return NCSCC_RC_FAILURE;
 	}
+
+	if (__atomic_load_n(&ncs_ipc->msg_count, __ATOMIC_SEQ_CST) != 0)
+		return m_NCS_SEL_OBJ_IND(&ncs_ipc->sel_obj);
+
 	return NCSCC_RC_SUCCESS;
 }
 
 uint32_t ncs_ipc_send(SYSF_MBX *mbx, NCS_IPC_MSG *msg, NCS_IPC_PRIORITY prio)
 {
 	NCS_IPC *ncs_ipc;
+	NCS_IPC_QUEUE *queue;
 	uint32_t queue_number;
+	bool raise_ind;
 
 	if ((NULL == NCS_INT32_TO_PTR_CAST(mbx)) || (NULL == NCS_INT32_TO_PTR_CAST(*mbx)))
 		return NCSCC_RC_FAILURE;
@@ -486,15 +527,12 @@ uint32_t ncs_ipc_send(SYSF_MBX *mbx, NCS_IPC_MSG *msg, NCS_IPC_PRIORITY prio)
 	if (ncs_ipc == NULL)
 		return NCSCC_RC_FAILURE;
 
-	m_NCS_LOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
-
-	if (ncs_ipc->ref_count == 0) {
+	if (__atomic_load_n(&ncs_ipc->ref_count, __ATOMIC_RELAXED) == 0) {
 		/* 
 		 * IPC queue is being released or has no "users" - don't queue
 		 * messages...
 		 */
 		m_LEAP_DBG_SINK_VOID;
-		m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
 		ncshm_give_hdl((uint32_t)*mbx);
 		return NCSCC_RC_FAILURE;
 	}
@@ -504,28 +542,68 @@ uint32_t ncs_ipc_send(SYSF_MBX *mbx, NCS_IPC_MSG *msg, NCS_IPC_PRIORITY prio)
 	 */
 	queue_number = NCS_IPC_PRIO_LEVELS - prio;
 
-	if (ipc_enqueue_ind_processing(ncs_ipc, queue_number) != NCSCC_RC_SUCCESS) {
-		m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
+	if (ipc_enqueue_ind_processing(ncs_ipc, queue_number, &raise_ind) != NCSCC_RC_SUCCESS) {
 		ncshm_give_hdl((uint32_t)*mbx);
 		return NCSCC_RC_FAILURE;
 	}
 
-	if (NULL != ncs_ipc->queue[queue_number].tail)
-		ncs_ipc->queue[queue_number].tail->next = msg;
-	else
-		ncs_ipc->queue[queue_number].head = msg;
-
-	ncs_ipc->queue[queue_number].tail = msg;
-	msg->next = NULL;
-
-	m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
+	/* push on the stack of the queue, no lock needed */
+	queue = &ncs_ipc->queue[queue_number];
+	msg->next = __atomic_load_n(&queue->stack, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&queue->stack, &msg->next, msg, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		;
 
 	/* unblock receiver... */
+	if (raise_ind && (m_NCS_SEL_OBJ_IND(&ncs_ipc->sel_obj) != NCSCC_RC_SUCCESS))
+		m_LEAP_DBG_SINK_VOID;	/* only if the mailbox is going away */
+
+	/* The last user may have detached and flushed the mailbox after the
+	   check above, before the push. Take the message back then, as the
+	   check used to be done under the queue_lock, unless the flush or a
+	   receiver got it. */
+	if ((__atomic_load_n(&ncs_ipc->ref_count, __ATOMIC_SEQ_CST) == 0) &&
+	    ipc_retract(ncs_ipc, queue_number, msg)) {
+		m_LEAP_DBG_SINK_VOID;
+		ncshm_give_hdl((uint32_t)*mbx);
+		return NCSCC_RC_FAILURE;
+	}
+
 	ncshm_give_hdl((uint32_t)*mbx);
 
 	return NCSCC_RC_SUCCESS;
 }
 
+/************************************************************************\
+  ipc_retract : Removes a message sent to a mailbox that has no users
+                left. Returns true if it was still queued.
+\************************************************************************/
+static bool ipc_retract(NCS_IPC *ncs_ipc, unsigned int queue_number, NCS_IPC_MSG *msg)
+{
+	NCS_IPC_QUEUE *queue = &ncs_ipc->queue[queue_number];
+	NCS_IPC_MSG *p_prev = NULL;
+	NCS_IPC_MSG *p_cur;
+
+	m_NCS_LOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
+
+	ipc_collect(queue);
+	for (p_cur = queue->head; (p_cur != NULL) && (p_cur != msg); p_cur = p_cur->next)
+		p_prev = p_cur;
+
+	if (p_cur != NULL) {
+		if (p_prev == NULL)
+			queue->head = msg->next;
+		else
+			p_prev->next = msg->next;
+		if (queue->tail == msg)
+			queue->tail = p_prev;
+		msg->next = NULL;
+		ipc_dequeue_ind_processing(ncs_ipc, queue_number, 1);
+	}
+
+	m_NCS_UNLOCK(&ncs_ipc->queue_lock, NCS_LOCK_WRITE);
+	return p_cur != NULL;
+}
+
 uint32_t ncs_ipc_config_max_msgs(SYSF_MBX *mbx, NCS_IPC_PRIORITY prio, uint32_t max_msgs)
 {
 	NCS_IPC *ncs_ipc;
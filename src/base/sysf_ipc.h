@@ -45,20 +45,24 @@
 
   @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@*/
 
+/* Senders push on "stack" without locking, newest message first. Receivers
+   (holding queue_lock) move the whole stack, reversed, to the head/tail
+   list when that runs empty, and dequeue from "head" */
 typedef struct ncs_ipc_queue {
   NCS_IPC_MSG *head;
   NCS_IPC_MSG *tail;
+  NCS_IPC_MSG *stack;
 } NCS_IPC_QUEUE;
 
 typedef struct tag_ncs_ipc {
-  NCS_LOCK queue_lock;    /* to protect access to queue */
+  NCS_LOCK queue_lock;    /* to protect the receive side of queues */
 
   NCS_IPC_QUEUE queue[NCS_IPC_PRIO_LEVELS];       /* element 0 for queueing HIGH priority IPC messages */
   /* element 1 for queueing NORMAL priority IPC messages */
   /* element 2 for queueing LOW priority IPC messages */
 
   uint32_t no_of_msgs[NCS_IPC_PRIO_LEVELS];       /* (priority level message count, used to compare
-                                                     with the corresponding threshold value) */
+                                                     with the corresponding threshold value); atomic */
 
   uint32_t max_no_of_msgs[NCS_IPC_PRIO_LEVELS];   /* (threshold value configured through
                                                      m_NCS_IPC_CONFIG_MAX_MSGS otherwise initialized to zero) */
@@ -67,7 +71,7 @@ typedef struct tag_ncs_ipc {
   unsigned int active_queue;      /* the next queue to check for an IPC message */
 
   /* Changes to migrate to SAF model:PM:7/Jan/03. */
-  NCS_SEL_OBJ sel_obj;
+  NCS_SEL_OBJ sel_obj;    /* an eventfd, see m_NCS_SEL_OBJ_CREATE_EVENT */
   /* msg_count: Keeps a count of messages queued. When this count is
      non-zero, "sel_obj" will have an "indication" raised against
      it. The "indication" on "sel_obj" will be removed when
@@ -76,6 +80,9 @@ typedef struct tag_ncs_ipc {
      This way there need not be an indication raised for every
      message. An indication is raised only per "burst of
      messages"
+
+     Updated atomically by senders; an indication may briefly be
+     raised with a zero count, which a receiver just removes.
   */
   uint32_t msg_count;
 
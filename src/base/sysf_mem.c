@@ -30,9 +30,11 @@
   FUNCTIONS INCLUDED in this module:
 
   sysf_alloc_pkt....................Allocate a packet buffer
+  sysf_alloc_large_pkt..............Allocate a packet buffer with a large payload area
   sysf_free_pkt.....................Free a packet buffer
   sysf_ditto_pkt....................Duplicate a USRBUF chain
   sysf_get_chain_len................Calculate the data length of a bufr-chain
+  sysf_usrbuf_iovec.................Describe a bufr-chain as an iovec array
   sysf_reserve_at_end...............Append data space to a bufr-chain.
   sysf_remove_from_end..............Remove bytes (freeing buffers if nec.) from end of bufr-chain
   sysf_reserve_at_start.............Prepend data space to a bufr-chain.
@@ -410,10 +412,46 @@ NCSUB_POOL *ncsmmgr_ub_getpool(uint8_t pool_id)
 
 /***********************************************************************/
 
+/***************************************************************************
+ *  sysf_alloc_usrdata
+ *
+ * Allocate a payload area of "size" octets (never less than PAYLOAD_BUF_SIZE)
+ * from the given pool. The caller holds the pool manager lock if needed.
+ ****************************************************************************/
+static USRDATA *sysf_alloc_usrdata(NCSUB_POOL *pool, unsigned int size, unsigned char priority)
+{
+	USRDATA *ud;
+	uint32_t alloc_size = sizeof(USRDATA);
+
+	if (size > PAYLOAD_BUF_SIZE)
+		alloc_size = offsetof(USRDATA, Data) + size;
+	else
+		size = PAYLOAD_BUF_SIZE;
+
+	ud = (USRDATA *)pool->mem_alloc(alloc_size, pool->pool_id, priority);
+	if (ud != (USRDATA *)NULL) {
+		ud->RefCnt = 1;
+		ud->Size = size;
+	}
+	return ud;
+}
+
 /***************************************************************************
  *  sysf_alloc_pkt  
  ****************************************************************************/
 USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num, unsigned int line, char *file)
+{
+	return sysf_alloc_large_pkt(pool_id, priority, PAYLOAD_BUF_SIZE, line, file);
+}
+
+/***************************************************************************
+ *  sysf_alloc_large_pkt
+ *
+ * Allocate a packet buffer whose payload area holds "size" octets. Sizes
+ * below PAYLOAD_BUF_SIZE give an ordinary USRBUF.
+ ****************************************************************************/
+USRBUF *sysf_alloc_large_pkt(unsigned char pool_id, unsigned char priority, unsigned int size, unsigned int line,
+			     char *file)
 {
 
 	USRBUF *ub;
@@ -427,19 +465,17 @@ USRBUF *sysf_alloc_pkt(unsigned char pool_id, unsigned char priority, int num, u
 
 		if (pool_id >= UB_MAX_POOLS) {
 			m_PMGR_UNLK(&gl_ub_pool_mgr.lock);
+			m_NCS_MEM_FREE(ub, NCS_MEM_REGION_IO_DATA_HDR, NCS_SERVICE_ID_OS_SVCS, 2);
 			m_LEAP_DBG_SINK_VOID;
 			return NULL;
 		}
-		ud = (USRDATA *)gl_ub_pool_mgr.pools[pool_id].mem_alloc(sizeof(USRDATA), pool_id, priority);
+		ud = sysf_alloc_usrdata(&gl_ub_pool_mgr.pools[pool_id], size, priority);
 
 		if (ud == (USRDATA *)NULL) {
 			m_NCS_MEM_FREE(ub, NCS_MEM_REGION_IO_DATA_HDR, NCS_SERVICE_ID_OS_SVCS, 2);
 			ub = (USRBUF *)0;
 			m_PMGR_UNLK(&gl_ub_pool_mgr.lock);
 		} else {
-			/* Set up data fields... */
-			ud->RefCnt = 1;
-
 			/* Set up USRBUF fields... */
 			ub->payload = ud;
 			ub->pool_ops = &gl_ub_pool_mgr.pools[pool_id];
@@ -553,7 +589,8 @@ USRBUF *sysf_copy_pkt(USRBUF *dup_me)
 		 * system policies.
 		 */
 
-		*ubp = (ub = (USRBUF *)m_MMGR_ALLOC_POOLBUFR(dup_me->pool_ops->pool_id, NCSMEM_HI_PRI));
+		*ubp = (ub = (USRBUF *)m_MMGR_ALLOC_LARGE_POOLBUFR(dup_me->pool_ops->pool_id, NCSMEM_HI_PRI,
+								    dup_me->payload->Size));
 
 		if (ub == BNULL) {
 			m_MMGR_FREE_BUFR_LIST(ub_head);
@@ -567,7 +604,7 @@ USRBUF *sysf_copy_pkt(USRBUF *dup_me)
 		/* restore preserved payload ptr. and copy data into it */
 		ub->payload = payload;
 
-		memcpy(ub->payload->Data, dup_me->payload->Data, PAYLOAD_BUF_SIZE);
+		memcpy(ub->payload->Data, dup_me->payload->Data, dup_me->payload->Size);
 
 		/* setup link pointers */
 		ubp = &ub->link;
@@ -592,6 +629,37 @@ uint32_t sysf_get_chain_len(const USRBUF *my_len)
 	return len;
 }
 
+/***************************************************************************
+ *  sysf_usrbuf_iovec
+ *
+ * Describe the first "len" octets of a USRBUF chain in "iov", one entry per
+ * non-empty USRBUF, so that the chain can be written with writev()/sendmsg()
+ * without copying. Returns the number of entries used, or -1 if the chain
+ * holds less than "len" octets or needs more than "iovcnt" entries.
+ ****************************************************************************/
+
+int sysf_usrbuf_iovec(const USRBUF *ub, unsigned int len, struct iovec *iov, int iovcnt)
+{
+	int cnt = 0;
+
+	for (; (ub != BNULL) && (len > 0); ub = ub->link) {
+		unsigned int seg = ub->count;
+
+		if (seg == 0)
+			continue;
+		if (cnt == iovcnt)
+			return -1;
+		if (seg > len)
+			seg = len;
+		iov[cnt].iov_base = ub->payload->Data + ub->start;
+		iov[cnt].iov_len = seg;
+		cnt++;
+		len -= seg;
+	}
+
+	return (len == 0) ? cnt : -1;
+}
+
 /***************************************************************************
  * Procedure: sysf_calc_usrbuf_cksum_1s_comp()
  *
@@ -815,7 +883,7 @@ char *sysf_reserve_at_end_amap(USRBUF **ppb, unsigned int *io_size,
 
 	/* Determine the minimum bytes that need to be reserved in the least */
 	min_rsrv = (int32_t)(total ? *io_size : 1);
-	space_left = sizeof(ub->payload->Data) - (ub_trlr_rsrv + ub->start + ub->count);
+	space_left = ub->payload->Size - (ub_trlr_rsrv + ub->start + ub->count);
 
 	/* Partial reservation is ok */
 	if ((ub->payload->RefCnt > 1) || (space_left < min_rsrv)) {
@@ -826,7 +894,7 @@ char *sysf_reserve_at_end_amap(USRBUF **ppb, unsigned int *io_size,
 		if (ub == (USRBUF *)0) {
 			return NULL;
 		}
-		space_left = sizeof(ub->payload->Data) - (ub_trlr_rsrv + ub->start + ub->count);
+		space_left = ub->payload->Size - (ub_trlr_rsrv + ub->start + ub->count);
 	}
 
 	if (space_left < (int32_t)*io_size) {
@@ -1178,23 +1246,22 @@ static char *sysf_reserve_in_mid(USRBUF *pb, unsigned int offset, unsigned int s
 	}
 
 	/* Code currently does not support spanning USRBUFs */
-	if (size > PAYLOAD_BUF_SIZE)
+	if (size > pb->payload->Size)
 		return (char *)0;
 
 	/* If payload has other users, need to allocate own copy */
 	if (pb->payload->RefCnt > 1) {
-		ud = (USRDATA *)pb->pool_ops->mem_alloc(sizeof(USRDATA), pb->pool_ops->pool_id, NCSMEM_HI_PRI);
+		ud = sysf_alloc_usrdata(pb->pool_ops, pb->payload->Size, NCSMEM_HI_PRI);
 
 		if (ud == (USRDATA *)NULL)
 			return (char *)0;
 
-		ud->RefCnt = 1;
-		memcpy(ud->Data, pb->payload->Data, sizeof(pb->payload->Data));
+		memcpy(ud->Data, pb->payload->Data, pb->payload->Size);
 		pb->payload->RefCnt--;
 		pb->payload = ud;
 	}
 
-	pload_size = sizeof(pb->payload->Data);
+	pload_size = pb->payload->Size;
 	post_data_len = pb->count - offset;
 
 	/* 
@@ -1319,13 +1386,12 @@ char *sysf_write_in_mid(USRBUF *pb, unsigned int offset, unsigned int size, char
 
 	/* If payload has other users, need to allocate own copy */
 	if (pb->payload->RefCnt > 1) {
-		ud = (USRDATA *)pb->pool_ops->mem_alloc(sizeof(USRDATA), pb->pool_ops->pool_id, NCSMEM_HI_PRI);
+		ud = sysf_alloc_usrdata(pb->pool_ops, pb->payload->Size, NCSMEM_HI_PRI);
 
 		if (ud == (USRDATA *)NULL)
 			return (char *)0;
 
-		ud->RefCnt = 1;
-		memcpy(ud->Data, pb->payload->Data, sizeof(pb->payload->Data));
+		memcpy(ud->Data, pb->payload->Data, pb->payload->Size);
 		pb->payload->RefCnt--;
 		pb->payload = ud;
 	}
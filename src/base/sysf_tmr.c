@@ -35,10 +35,10 @@
 #include "base/ncssysf_def.h"
 #include "base/ncssysf_tmr.h"
 #include "base/ncssysf_tsk.h"
-#include "base/ncspatricia.h"
 #include "base/ncssysf_mem.h"
 #include "base/osaf_time.h"
 #include "base/osaf_poll.h"
+#include "base/osaf_timerfd.h"
 
 #include <stdlib.h>
 #include <sched.h>
@@ -55,15 +55,23 @@
 #define m_SYSF_TMR_LOG_INFO(str,num)
 #endif
 
-#define TIMESPEC_DIFF_IN_NS(later, before)  \
-                  (((later).tv_sec - (before).tv_sec)*1000000000LL + \
-                  (((later).tv_nsec - (before).tv_nsec)))
 #ifndef ENABLE_SYSLOG_TMR_STATS
 #define ENABLE_SYSLOG_TMR_STATS 0
 #endif
 
-/* This is the period of the timer tick we request from the OS. */
-#define NCS_MILLISECONDS_PER_TICK    100
+/* This is the resolution of the timing wheel. The API still takes its delays
+ * in 10ms units, the finer wheel tick only removes the rounding error that a
+ * coarse tick adds to every expiry. */
+#define NCS_MILLISECONDS_PER_TICK    1
+
+/* Timing wheel geometry: SYSF_TMR_WHEEL_LEVELS levels of SYSF_TMR_WHEEL_SIZE
+ * slots each. Level n holds the timers expiring within 2^(8*(n+1)) ticks, the
+ * last level also holds everything beyond that and re-files it on cascade. */
+#define SYSF_TMR_WHEEL_BITS          8
+#define SYSF_TMR_WHEEL_SIZE          (1 << SYSF_TMR_WHEEL_BITS)
+#define SYSF_TMR_WHEEL_MASK          (SYSF_TMR_WHEEL_SIZE - 1)
+#define SYSF_TMR_WHEEL_LEVELS        4
+#define SYSF_TMR_WHEEL_SPAN(l)       (1ULL << (SYSF_TMR_WHEEL_BITS * (l)))
 
 /* SYSF_TMR  state of a timer during its lifetime */
 #define  TMR_STATE_CREATE          0x01
@@ -79,7 +87,7 @@
  *              +------------+
  *              |            |
  *              v   +---->expired(dormant)----+
- *  create--->start-+                         +-->destroy 
+ *  create--->start-+                         +-->destroy
  *              ^   +----> stop(dormant)  ----+
  *              |            |
  *              +------------+
@@ -132,24 +140,30 @@ typedef struct sysf_tmr {
 	struct sysf_tmr *keep;	/* just to know where you are !! */
 
 	uint8_t state;
-	uint64_t key;
+	uint64_t key;		/* expiry, in ticks since ts_start */
 	TMR_CALLBACK tmrCB;
 	NCSCONTEXT tmrUarg;
 	TMR_DBG_LEAK dbg;
 
 } SYSF_TMR;
 
-/* SYSF_TMR_PAT_NODE holds timer list info available in a pat node */
-typedef struct sysf_tmr_pat_node {
-	NCS_PATRICIA_NODE pat_node;
-	uint64_t key;
-	SYSF_TMR *tmr_list_start;
-	SYSF_TMR *tmr_list_end;
-} SYSF_TMR_PAT_NODE;
+/* SYSF_TMR_SLOT is a FIFO list of timers, linked through 'next' */
+typedef struct sysf_tmr_slot {
+	SYSF_TMR *start;
+	SYSF_TMR *end;
+} SYSF_TMR_SLOT;
+
+/* SYSF_TMR_WHEEL the hierarchical timing wheel, owned by the timer thread */
+typedef struct sysf_tmr_wheel {
+	uint64_t tick;		/* tick the wheel has been advanced to */
+	uint32_t count[SYSF_TMR_WHEEL_LEVELS];	/* timers filed per level */
+	SYSF_TMR_SLOT slot[SYSF_TMR_WHEEL_LEVELS][SYSF_TMR_WHEEL_SIZE];
+	SYSF_TMR_SLOT due;	/* timers whose expiry has already passed */
+} SYSF_TMR_WHEEL;
 
 /* TMR_SAFE the part of the timer svc within the critical region        */
 typedef struct tmr_safe {
-	NCS_LOCK enter_lock;	/* protect list of new timers */
+	NCS_LOCK enter_lock;	/* protect the timing wheel */
 	NCS_LOCK free_lock;	/* protect list of free pool timers */
 	SYSF_TMR dmy_free;
 	SYSF_TMR dmy_keep;
@@ -162,11 +176,12 @@ typedef struct sysf_tmr_cb {
 
 	NCSLPG_OBJ persist;	/* guard against fleeting destruction */
 	TMR_SAFE safe;		/* critical region stuff              */
-	NCS_PATRICIA_TREE tmr_pat_tree;
+	SYSF_TMR_WHEEL wheel;
+	SYSF_TMR *incoming;	/* lock-free stack of started timers  */
 	TMR_STATS stats;
 	void *p_tsk_hdl;	/* expiry task handle storage         */
 	NCS_SEL_OBJ sel_obj;
-	uint32_t msg_count;
+	int tmr_fd;		/* wakes the expiry task              */
 
 } SYSF_TMR_CB;
 
@@ -177,30 +192,140 @@ static bool tmr_destroying = false;
 static NCS_SEL_OBJ tmr_destroy_syn_obj;
 static struct timespec ts_start;
 
-static uint32_t ncs_tmr_add_pat_node(SYSF_TMR *tmr)
+static void ncs_tmr_slot_append(SYSF_TMR_SLOT *slot, SYSF_TMR *tmr)
 {
-	SYSF_TMR_PAT_NODE *temp_tmr_pat_node = NULL;
+	tmr->next = NULL;
+	if (slot->start == NULL) {
+		slot->end = slot->start = tmr;
+	} else {
+		slot->end->next = tmr;
+		slot->end = tmr;
+	}
+}
 
-	temp_tmr_pat_node = (SYSF_TMR_PAT_NODE *)ncs_patricia_tree_get(&gl_tcb.tmr_pat_tree, (uint8_t *)&tmr->key);
+/* Detach the whole list of a slot, optionally keeping the level count right */
+static SYSF_TMR *ncs_tmr_slot_take(SYSF_TMR_SLOT *slot, uint32_t *count)
+{
+	SYSF_TMR *list = slot->start;
+	SYSF_TMR *tmr;
 
-	if (temp_tmr_pat_node == (SYSF_TMR_PAT_NODE *)NULL) {
-		temp_tmr_pat_node = (SYSF_TMR_PAT_NODE *)m_NCS_MEM_ALLOC(sizeof(SYSF_TMR_PAT_NODE),
-									 NCS_MEM_REGION_PERSISTENT,
-									 NCS_SERVICE_ID_LEAP_TMR, 0);
-		memset(temp_tmr_pat_node, '\0', sizeof(SYSF_TMR_PAT_NODE));
-		temp_tmr_pat_node->key = tmr->key;
-		temp_tmr_pat_node->pat_node.key_info = (uint8_t *)&temp_tmr_pat_node->key;
-		ncs_patricia_tree_add(&gl_tcb.tmr_pat_tree, (NCS_PATRICIA_NODE *)&temp_tmr_pat_node->pat_node);
+	slot->start = slot->end = NULL;
+	if (count != NULL) {
+		for (tmr = list; tmr != NULL; tmr = tmr->next)
+			(*count)--;
 	}
+	return list;
+}
 
-	if (temp_tmr_pat_node->tmr_list_start == NULL) {
-		temp_tmr_pat_node->tmr_list_end = temp_tmr_pat_node->tmr_list_start = tmr;
-	} else {
-		temp_tmr_pat_node->tmr_list_end->next = tmr;
-		temp_tmr_pat_node->tmr_list_end = tmr;
+/****************************************************************************
+ * Function Name: ncs_tmr_wheel_add
+ *
+ * Purpose: File a started timer in the wheel. The level is chosen from the
+ *          distance to the expiry and the slot from the expiry itself, so a
+ *          slot is always reached before its timers are due.
+ *
+ ****************************************************************************/
+static void ncs_tmr_wheel_add(SYSF_TMR *tmr)
+{
+	SYSF_TMR_WHEEL *wheel = &gl_tcb.wheel;
+	uint64_t expiry = tmr->key;
+	uint64_t delta;
+	unsigned level;
+
+	if (expiry <= wheel->tick) {
+		ncs_tmr_slot_append(&wheel->due, tmr);
+		return;
 	}
 
-	return NCSCC_RC_SUCCESS;
+	delta = expiry - wheel->tick;
+	for (level = 0; level < SYSF_TMR_WHEEL_LEVELS - 1; level++) {
+		if (delta < SYSF_TMR_WHEEL_SPAN(level + 1))
+			break;
+	}
+
+	/* Beyond the reach of the wheel; park it in the furthest slot and let
+	   the cascade file it again with its real key */
+	if (delta >= SYSF_TMR_WHEEL_SPAN(SYSF_TMR_WHEEL_LEVELS))
+		expiry = wheel->tick + SYSF_TMR_WHEEL_SPAN(SYSF_TMR_WHEEL_LEVELS) - 1;
+
+	ncs_tmr_slot_append(&wheel->slot[level][(expiry >> (SYSF_TMR_WHEEL_BITS * level)) & SYSF_TMR_WHEEL_MASK],
+			    tmr);
+	wheel->count[level]++;
+}
+
+/* Give stopped and freed timers back to the free pool */
+static void ncs_tmr_recycle(SYSF_TMR_SLOT *dead)
+{
+	if (dead->start == NULL)
+		return;
+
+	m_NCS_LOCK(&gl_tcb.safe.free_lock, NCS_LOCK_WRITE);	/* critical region START */
+	dead->end->next = gl_tcb.safe.dmy_free.next;	/* append old free list to end of that  */
+	gl_tcb.safe.dmy_free.next = dead->start;	/* put start of collected dead in front */
+	m_NCS_UNLOCK(&gl_tcb.safe.free_lock, NCS_LOCK_WRITE);	/* critical region END */
+
+	dead->start = dead->end = NULL;
+}
+
+/****************************************************************************
+ * Function Name: ncs_tmr_wheel_cascade
+ *
+ * Purpose: Re-file the timers of the current slot of a higher level into the
+ *          levels below it. Cancelled timers are dropped on the way.
+ *
+ ****************************************************************************/
+static void ncs_tmr_wheel_cascade(unsigned level, SYSF_TMR_SLOT *dead)
+{
+	SYSF_TMR_WHEEL *wheel = &gl_tcb.wheel;
+	SYSF_TMR_SLOT *slot = &wheel->slot[level][(wheel->tick >> (SYSF_TMR_WHEEL_BITS * level)) & SYSF_TMR_WHEEL_MASK];
+	SYSF_TMR *tmr = ncs_tmr_slot_take(slot, &wheel->count[level]);
+	SYSF_TMR *next;
+
+	while (tmr != NULL) {
+		next = tmr->next;
+		if ((TMR_TEST_STATE(tmr, TMR_STATE_DORMANT)) || (TMR_TEST_STATE(tmr, TMR_STATE_DESTROY))) {
+			TMR_STAT_CANCELLED(gl_tcb.stats);
+			ncs_tmr_slot_append(dead, tmr);
+		} else {
+			ncs_tmr_wheel_add(tmr);
+		}
+		tmr = next;
+	}
+}
+
+/****************************************************************************
+ * Function Name: ncs_tmr_take_incoming
+ *
+ * Purpose: Move the timers started since the last pass from the lock-free
+ *          incoming stack into the wheel, in the order they were started.
+ *
+ ****************************************************************************/
+static void ncs_tmr_take_incoming(void)
+{
+	SYSF_TMR *tmr = __atomic_exchange_n(&gl_tcb.incoming, NULL, __ATOMIC_ACQUIRE);
+	SYSF_TMR *fifo = NULL;
+	SYSF_TMR *next;
+	SYSF_TMR_SLOT dead = { NULL, NULL };
+
+	while (tmr != NULL) {
+		next = tmr->next;
+		tmr->next = fifo;
+		fifo = tmr;
+		tmr = next;
+	}
+
+	while (fifo != NULL) {
+		next = fifo->next;
+		if ((TMR_TEST_STATE(fifo, TMR_STATE_DORMANT)) || (TMR_TEST_STATE(fifo, TMR_STATE_DESTROY))) {
+			TMR_STAT_CANCELLED(gl_tcb.stats);
+			ncs_tmr_slot_append(&dead, fifo);
+		} else {
+			ncs_tmr_wheel_add(fifo);
+		}
+		fifo = next;
+	}
+
+	ncs_tmr_recycle(&dead);
 }
 
 /* This routine returns the time elapsed in units of NCS_MILLISECONDS_PER_TICK */
@@ -224,7 +349,7 @@ static uint64_t get_time_elapsed_in_ticks(struct timespec *temp_ts_start)
  * Purpose: Service all timers that live in this expiry bucket
  *
  ****************************************************************************/
-static bool sysfTmrExpiry(SYSF_TMR_PAT_NODE *tmp)
+static bool sysfTmrExpiry(SYSF_TMR *list)
 {
 	SYSF_TMR *now_tmr;
 	SYSF_TMR dead_inst;
@@ -251,7 +376,7 @@ static bool sysfTmrExpiry(SYSF_TMR_PAT_NODE *tmp)
 
 	TMR_DBG_TICK(gl_tcb);
 
-	dead_tmr->next = tmp->tmr_list_start;
+	dead_tmr->next = list;
 
 	TMR_SET_CNT(gl_tcb.stats);
 
@@ -300,160 +425,188 @@ static bool sysfTmrExpiry(SYSF_TMR_PAT_NODE *tmp)
 		m_NCS_UNLOCK(&gl_tcb.safe.free_lock, NCS_LOCK_WRITE);	/* critical region END */
 	}
 
-	ncs_patricia_tree_del(&gl_tcb.tmr_pat_tree, (NCS_PATRICIA_NODE *)tmp);
-	m_NCS_MEM_FREE(tmp, NCS_MEM_REGION_PERSISTENT, NCS_SERVICE_ID_LEAP_TMR, 0);
-
 	ncslpg_give(&gl_tcb.persist, 0);
 	return false;
 }
 
-static uint32_t ncs_tmr_engine(struct timeval *tv, uint64_t *next_delay)
+/****************************************************************************
+ * Function Name: ncs_tmr_engine
+ *
+ * Purpose: Advance the wheel up to the current time, cascading the higher
+ *          levels at their boundaries and expiring every level 0 slot passed.
+ *          Stretches where the lower levels are empty are skipped in one go.
+ *
+ ****************************************************************************/
+static uint32_t ncs_tmr_engine(void)
 {
-	uint64_t next_expiry = 0;
-	uint64_t ticks_elapsed = 0;
-	SYSF_TMR_PAT_NODE *tmp = NULL;
-
-#if ENABLE_SYSLOG_TMR_STATS
-	/* To measure avg. timer expiry gap */
-	struct timespec tmr_exp_prev_finish = { 0, 0 };
-	struct timespec tmr_exp_curr_start = { 0, 0 };
-	uint32_t tot_tmr_exp = 0;
-	uint64_t sum_of_tmr_exp_gaps = 0;	/* Avg = sum_of_tmr_exp_gaps/tot_tmr_exp */
-#endif
+	SYSF_TMR_WHEEL *wheel = &gl_tcb.wheel;
+	uint64_t now = get_time_elapsed_in_ticks(&ts_start);
+	uint64_t next;
+	SYSF_TMR *list;
+	SYSF_TMR_SLOT dead = { NULL, NULL };
+	unsigned level;
+	int i;
 
 	while (true) {
-		tmp = (SYSF_TMR_PAT_NODE *)ncs_patricia_tree_getnext(&gl_tcb.tmr_pat_tree, (uint8_t *)NULL);
-		ticks_elapsed = get_time_elapsed_in_ticks(&ts_start);
-		if (tmp != NULL) {
-			next_expiry = m_NCS_OS_NTOHLL_P(&tmp->key);
-		} else {
-			tv->tv_sec = 0xffffff;
-			tv->tv_usec = 0;
-			*next_delay = 0;
-			return NCSCC_RC_SUCCESS;
+		list = ncs_tmr_slot_take(&wheel->due, NULL);
+		if (list != NULL) {
+			if (true == sysfTmrExpiry(list))	/* call expiry routine          */
+				return NCSCC_RC_FAILURE;
+			continue;
 		}
 
-		if (ticks_elapsed >= next_expiry) {
-#if ENABLE_SYSLOG_TMR_STATS
-			if (tot_tmr_exp != 0) {
-				tmr_exp_curr_start.tv_sec = tmr_exp_curr_start.tv_nsec = 0;
-				if (clock_gettime(CLOCK_MONOTONIC, &tmr_exp_curr_start)) {
-					perror("clock_gettime with MONOTONIC Failed \n");
-				}
-				sum_of_tmr_exp_gaps += TIMESPEC_DIFF_IN_NS(tmr_exp_curr_start, tmr_exp_prev_finish);
-				if (tot_tmr_exp >= 100) {
-					printf("\nTotal active timers: %d\n", gl_tcb.stats.cnt);
-					printf("Average timer-expiry gap (last %d expiries) = %lld\n",
-					       tot_tmr_exp, sum_of_tmr_exp_gaps / tot_tmr_exp);
-					tot_tmr_exp = 0;
-					sum_of_tmr_exp_gaps = 0;
-				}
-			}
-#endif
+		if (wheel->tick >= now)
+			break;
 
-			if (true == sysfTmrExpiry(tmp)) {	/* call expiry routine          */
-				return NCSCC_RC_FAILURE;
-			}
-#if ENABLE_SYSLOG_TMR_STATS
-			tot_tmr_exp++;
-			tmr_exp_prev_finish.tv_sec = tmr_exp_prev_finish.tv_nsec = 0;
-			if (clock_gettime(CLOCK_MONOTONIC, &tmr_exp_prev_finish)) {
-				perror("clock_gettime with MONOTONIC Failed \n");
-				return NCSCC_RC_FAILURE;
-			}
-#endif
-		} else {
+		for (level = 0; level < SYSF_TMR_WHEEL_LEVELS - 1; level++) {
+			if (wheel->count[level] != 0)
+				break;
+		}
+		if (level == 0)
+			next = wheel->tick + 1;
+		else
+			next = (wheel->tick | (SYSF_TMR_WHEEL_SPAN(level) - 1)) + 1;
+
+		if (next > now) {
+			/* No boundary of a populated level before now */
+			wheel->tick = now;
 			break;
 		}
-	}			/* while loop end */
+		wheel->tick = next;
 
-	(*next_delay) = next_expiry - ticks_elapsed;
+		for (i = SYSF_TMR_WHEEL_LEVELS - 1; i > 0; i--) {
+			if ((next & (SYSF_TMR_WHEEL_SPAN(i) - 1)) == 0)
+				ncs_tmr_wheel_cascade(i, &dead);
+		}
+		ncs_tmr_recycle(&dead);
 
-	/* Convert the next_dealy intto the below structure */
-	tv->tv_sec = ((*next_delay) * NCS_MILLISECONDS_PER_TICK) / 1000;
-	tv->tv_usec = (((*next_delay) % (1000 / NCS_MILLISECONDS_PER_TICK)) * (1000 * NCS_MILLISECONDS_PER_TICK));
+		list = ncs_tmr_slot_take(&wheel->slot[0][next & SYSF_TMR_WHEEL_MASK], &wheel->count[0]);
+		if (list != NULL) {
+			if (true == sysfTmrExpiry(list))	/* call expiry routine          */
+				return NCSCC_RC_FAILURE;
+		}
+	}
 
 	return NCSCC_RC_SUCCESS;
 }
 
 /****************************************************************************
- * Function Name: ncs_tmr_wait
+ * Function Name: ncs_tmr_next_wakeup
  *
- * Purpose: Goto counting semephore and block until tmr_pulse is felt. This
- *          means the actual expiry task no longer services the sysfTmrExpiry
- *          function any more. This should eliminate timer drift.
+ * Purpose: Find the tick the expiry task must wake up at next; the first
+ *          populated level 0 slot or the next cascade of a populated level,
+ *          whichever comes first. Returns false when the wheel is empty.
  *
  ****************************************************************************/
-static uint32_t ncs_tmr_wait(void)
+static bool ncs_tmr_next_wakeup(uint64_t *o_tick)
 {
-	int inds_rmvd;
+	SYSF_TMR_WHEEL *wheel = &gl_tcb.wheel;
+	uint64_t wakeup = UINT64_MAX;
+	unsigned level;
+	uint64_t i;
 
-	uint64_t next_delay = 0;
+	if (wheel->due.start != NULL) {
+		*o_tick = wheel->tick;
+		return true;
+	}
 
-	struct timeval tv = { 0xffffff, 0 };
-	struct timespec ts_current = { 0, 0 };
-	struct timespec ts;
-	struct pollfd set;
+	if (wheel->count[0] != 0) {
+		for (i = 1; i <= SYSF_TMR_WHEEL_SIZE; i++) {
+			if (wheel->slot[0][(wheel->tick + i) & SYSF_TMR_WHEEL_MASK].start != NULL) {
+				wakeup = wheel->tick + i;
+				break;
+			}
+		}
+	}
 
-	if (clock_gettime(CLOCK_MONOTONIC, &ts_start)) {
-		perror("clock_gettime with MONOTONIC Failed \n");
-		return NCSCC_RC_FAILURE;
+	for (level = 1; level < SYSF_TMR_WHEEL_LEVELS; level++) {
+		if (wheel->count[level] != 0) {
+			uint64_t cascade = (wheel->tick | (SYSF_TMR_WHEEL_SPAN(level) - 1)) + 1;
+			if (cascade < wakeup)
+				wakeup = cascade;
+			break;
+		}
 	}
 
-	ts_current = ts_start;
+	*o_tick = wakeup;
+	return wakeup != UINT64_MAX;
+}
 
-	while (true) {
-		set.fd = m_GET_FD_FROM_SEL_OBJ(gl_tcb.sel_obj);
-		set.events = POLLIN;
-		osaf_timeval_to_timespec(&tv, &ts);
-		unsigned rc = osaf_ppoll(&set, 1, next_delay != 0 ? &ts : NULL, NULL);
-		m_NCS_LOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
+/* Arm the timerfd at an absolute tick, or disarm it */
+static void ncs_tmr_arm(bool armed, uint64_t tick)
+{
+	struct itimerspec its = { {0, 0}, {0, 0} };
+	struct timespec offset;
 
-		if (rc == 1) {
-			if (set.revents != POLLIN) osaf_abort(set.revents);
+	if (armed) {
+		osaf_millis_to_timespec(tick * NCS_MILLISECONDS_PER_TICK, &offset);
+		osaf_timespec_add(&ts_start, &offset, &its.it_value);
+	}
+	osaf_timerfd_settime(gl_tcb.tmr_fd, OSAF_TFD_TIMER_ABSTIME, &its, NULL);
+}
 
-			/* if select returned because of indication on sel_obj from sysfTmrDestroy */
-			if (tmr_destroying == true) {
-				/* Raise An indication */
-				m_NCS_SEL_OBJ_IND(&tmr_destroy_syn_obj);
-				m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-				return NCSCC_RC_SUCCESS;
-			}
+/****************************************************************************
+ * Function Name: ncs_tmr_wait
+ *
+ * Purpose: Block on the selection object and the timerfd. The selection
+ *          object is raised when timers are queued on the incoming stack,
+ *          the timerfd is armed at the next tick that has work in the wheel.
+ *
+ ****************************************************************************/
+static uint32_t ncs_tmr_wait(void)
+{
+	struct pollfd set[2];
+	uint64_t next_tick = 0;
+	uint64_t armed_tick = 0;
+	bool armed = false;
+	bool pending;
+	bool fired;
 
-			gl_tcb.msg_count--;
+	while (true) {
+		set[0].fd = m_GET_FD_FROM_SEL_OBJ(gl_tcb.sel_obj);
+		set[0].events = POLLIN;
+		set[1].fd = gl_tcb.tmr_fd;
+		set[1].events = POLLIN;
+		osaf_poll(set, 2, -1);
+		m_NCS_LOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
 
-			if (gl_tcb.msg_count == 0) {
-				inds_rmvd = m_NCS_SEL_OBJ_RMV_IND(&gl_tcb.sel_obj, true, true);
-				if (inds_rmvd <= 0) {
-					if (inds_rmvd != -1) {
-						/* The object has not been destroyed and it has no indication
-						   raised on it inspite of msg_count being non-zero.
-						 */
-						m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-						return m_LEAP_DBG_SINK(NCSCC_RC_FAILURE);
-					}
+		/* if poll returned because of indication on sel_obj from sysfTmrDestroy */
+		if (tmr_destroying == true) {
+			/* Raise An indication */
+			m_NCS_SEL_OBJ_IND(&tmr_destroy_syn_obj);
+			m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
+			return NCSCC_RC_SUCCESS;
+		}
 
-					m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
+		if (set[0].revents != 0) {
+			if (set[0].revents != POLLIN) osaf_abort(set[0].revents);
 
-					/* The mbox must have been destroyed */
-					return NCSCC_RC_FAILURE;
-				}
+			/* Starters only raise an indication when they find the incoming
+			   stack empty, so everything queued so far is picked up below */
+			if (m_NCS_SEL_OBJ_RMV_IND(&gl_tcb.sel_obj, true, false) == -1) {
+				/* The mbox must have been destroyed */
+				m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
+				return NCSCC_RC_FAILURE;
 			}
 		}
+		fired = (set[1].revents & POLLIN) != 0;
+
+		ncs_tmr_take_incoming();
 
-		rc = ncs_tmr_engine(&tv, &next_delay);
-		if (rc == NCSCC_RC_FAILURE) {
+		if (ncs_tmr_engine() == NCSCC_RC_FAILURE) {
 			m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
 			return NCSCC_RC_FAILURE;
 		}
 
-		m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-		ts_current.tv_sec = ts_current.tv_nsec = 0;
-
-		if (clock_gettime(CLOCK_MONOTONIC, &ts_current)) {
-			perror("clock_gettime with MONOTONIC Failed \n");
-			return NCSCC_RC_FAILURE;
+		/* Re-arming also consumes a pending expiration of the timerfd */
+		pending = ncs_tmr_next_wakeup(&next_tick);
+		if (fired || pending != armed || (pending && next_tick != armed_tick)) {
+			ncs_tmr_arm(pending, next_tick);
+			armed = pending;
+			armed_tick = next_tick;
 		}
+
+		m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
 	}
 
 	return NCSCC_RC_SUCCESS;
@@ -470,7 +623,6 @@ static bool ncs_tmr_create_done = false;
 
 bool sysfTmrCreate(void)
 {
-	NCS_PATRICIA_PARAMS pat_param;
 	uint32_t rc = NCSCC_RC_SUCCESS;
 
 	if (ncs_tmr_create_done == false)
@@ -488,20 +640,17 @@ bool sysfTmrCreate(void)
 	m_NCS_LOCK_INIT(&gl_tcb.safe.enter_lock);
 	m_NCS_LOCK_INIT(&gl_tcb.safe.free_lock);
 
-	memset((void *)&pat_param, 0, sizeof(NCS_PATRICIA_PARAMS));
-
-	pat_param.key_size = sizeof(uint64_t);
-
-	rc = ncs_patricia_tree_init(&gl_tcb.tmr_pat_tree, &pat_param);
-	if (rc != NCSCC_RC_SUCCESS) {
+	/* Tick 0 of the wheel; set before any timer can be started */
+	if (clock_gettime(CLOCK_MONOTONIC, &ts_start)) {
+		perror("clock_gettime with MONOTONIC Failed \n");
 		return NCSCC_RC_FAILURE;
 	}
 
 	rc = m_NCS_SEL_OBJ_CREATE(&gl_tcb.sel_obj);
 	if (rc != NCSCC_RC_SUCCESS) {
-		ncs_patricia_tree_destroy(&gl_tcb.tmr_pat_tree);
 		return NCSCC_RC_FAILURE;
 	}
+	gl_tcb.tmr_fd = osaf_timerfd_create(CLOCK_MONOTONIC, 0);
 	tmr_destroying = false;
 
 	/* create expiry thread */
@@ -515,14 +664,14 @@ bool sysfTmrCreate(void)
 			      0,
 			      (char *)"OSAF_TMR",
 			      prio_val, policy, NCS_TMR_STACKSIZE, &gl_tcb.p_tsk_hdl) != NCSCC_RC_SUCCESS) {
-		ncs_patricia_tree_destroy(&gl_tcb.tmr_pat_tree);
+		osaf_timerfd_close(gl_tcb.tmr_fd);
 		m_NCS_SEL_OBJ_DESTROY(&gl_tcb.sel_obj);
 		return false;
 	}
 
 	if (m_NCS_TASK_START(gl_tcb.p_tsk_hdl) != NCSCC_RC_SUCCESS) {
 		m_NCS_TASK_RELEASE(gl_tcb.p_tsk_hdl);
-		ncs_patricia_tree_destroy(&gl_tcb.tmr_pat_tree);
+		osaf_timerfd_close(gl_tcb.tmr_fd);
 		m_NCS_SEL_OBJ_DESTROY(&gl_tcb.sel_obj);
 		return false;
 	}
@@ -540,7 +689,6 @@ bool sysfTmrCreate(void)
 bool sysfTmrDestroy(void)
 {
 	SYSF_TMR *tmr;
-	SYSF_TMR_PAT_NODE *tmp = NULL;
 
 	/* There is only ever one timer per instance */
 
@@ -572,12 +720,11 @@ bool sysfTmrDestroy(void)
 		tmr->keep = tmr->keep->keep;
 		m_NCS_MEM_FREE(free_tmr, NCS_MEM_REGION_PERSISTENT, NCS_SERVICE_ID_LEAP_TMR, 0);
 	}
-	while ((tmp = (SYSF_TMR_PAT_NODE *)ncs_patricia_tree_getnext(&gl_tcb.tmr_pat_tree, (uint8_t *)0)) != NULL) {
-		ncs_patricia_tree_del(&gl_tcb.tmr_pat_tree, (NCS_PATRICIA_NODE *)tmp);
-		m_NCS_MEM_FREE(tmp, NCS_MEM_REGION_PERSISTENT, NCS_SERVICE_ID_LEAP_TMR, 0);
-	}
+	/* The timers on the wheel were on the keep list as well */
+	memset(&gl_tcb.wheel, '\0', sizeof(SYSF_TMR_WHEEL));
+	gl_tcb.incoming = NULL;
 
-	ncs_patricia_tree_destroy(&gl_tcb.tmr_pat_tree);
+	osaf_timerfd_close(gl_tcb.tmr_fd);
 	m_NCS_SEL_OBJ_DESTROY(&gl_tcb.sel_obj);
 
 	/* Stop the dedicated thread that runs out of ncs_tmr_wait() */
@@ -678,9 +825,8 @@ tmr_t ncs_tmr_start(tmr_t tid, int64_t tmrDelay,	/* timer period in number of 10
 {
 	SYSF_TMR *tmr;
 	SYSF_TMR *new_tmr;
+	SYSF_TMR *head;
 	uint64_t scaled;
-	uint64_t temp_key_value;
-	uint32_t rc = NCSCC_RC_SUCCESS;
 
 	if (((tmr = (SYSF_TMR *)tid) == NULL) || (tmr_destroying == true))	/* NULL tmrs are no good! */
 		return NULL;
@@ -704,64 +850,42 @@ tmr_t ncs_tmr_start(tmr_t tid, int64_t tmrDelay,	/* timer period in number of 10
 	}
 	scaled = (tmrDelay * 10 / NCS_MILLISECONDS_PER_TICK) + 1 + (get_time_elapsed_in_ticks(&ts_start));
 
-	/* Lock the enter wheel in the safe area */
-	m_NCS_LOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-
 	/* Do some up front initialization as if all will go well */
 	tmr->tmrCB = tmrCB;
 	tmr->tmrUarg = tmrUarg;
 	TMR_SET_STATE(tmr, TMR_STATE_START);
+	tmr->key = scaled;
+	TMR_DBG_SET(tmr->dbg, file, line);
 
-	tmr->next = NULL;
-	m_NCS_OS_HTONLL_P(&temp_key_value, scaled);
-	tmr->key = temp_key_value;
-
-	rc = ncs_tmr_add_pat_node(tmr);
-	if (rc == NCSCC_RC_FAILURE) {
-		/* Free the timer created */
-		m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-		return NULL;
-	}
 #if ENABLE_SYSLOG_TMR_STATS
 	gl_tcb.stats.cnt++;
 	if (gl_tcb.stats.cnt == 1) {
 		syslog(LOG_INFO, "At least one timer started\n");
 	}
 #endif
-	if (gl_tcb.msg_count == 0) {
-		/* There are no messages queued, we shall raise an indication
-		   on the "sel_obj".  */
+
+	/*
+	   Push the timer on the incoming stack without taking the enter lock;
+	   the expiry task files it in the wheel. Only the starter that finds
+	   the stack empty raises an indication on the "sel_obj", the expiry
+	   task drains the whole stack each time it wakes up.
+	 */
+	head = __atomic_load_n(&gl_tcb.incoming, __ATOMIC_RELAXED);
+	do {
+		tmr->next = head;
+	} while (!__atomic_compare_exchange_n(&gl_tcb.incoming, &head, tmr, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	if (head == NULL) {
 		if (m_NCS_SEL_OBJ_IND(&gl_tcb.sel_obj) != NCSCC_RC_SUCCESS) {
 			/* We would never reach here! */
-			m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
 			m_LEAP_DBG_SINK_VOID;
+			ncslpg_give(&gl_tcb.persist, 0);
 			return NULL;
 		}
 	}
-	gl_tcb.msg_count++;
-
-	/*
-	   1)Take Lock
-	   2)Caliculate the key value based on (A+1)+T
-	   T is Timer ticks elapsed  and A is ticks 
-	   ncs_tmr_add_pat_node(root_node,tmr,(A+1)+T,)
-	   3)See whether patricia Node is already present in patricia Tree with the 
-	   caliculated Key 
-	   If not present 
-	   Create patricia Node and add it the patricia tree 
-	   If present
-	   Add the tmr data structure to the double linked list as FIFO.
-	   i.e adds at the last of the double linked list.
-	   4) Raise an indication on the selection object.
-	   if (write(i_ind_obj.raise_obj, "A", 1) != 1)
-	   return NCSCC_RC_FAILURE;
-	 */
 
 	TMR_STAT_STARTS(gl_tcb.stats);
 
-	m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);
-	TMR_DBG_SET(tmr->dbg, file, line);
-
 	ncslpg_give(&gl_tcb.persist, 0);
 
 	return tmr;
@@ -908,7 +1032,7 @@ int64_t ncs_tmr_remaining(tmr_t tmrID, int64_t *p_tleft)
 	}
 	m_NCS_UNLOCK(&gl_tcb.safe.enter_lock, NCS_LOCK_WRITE);	/* critical region START */
 	ticks_elapsed = get_time_elapsed_in_ticks(&ts_start);
-	ticks_to_expiry = m_NCS_OS_NTOHLL_P(&tmr->key);
+	ticks_to_expiry = tmr->key;
 	total_ticks_left = (ticks_to_expiry - ticks_elapsed);
 
 	*p_tleft = total_ticks_left * NCS_MILLISECONDS_PER_TICK;
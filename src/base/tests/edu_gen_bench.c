@@ -0,0 +1,140 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION: Measures the encode and decode time of records through the
+               EDU interpreter and through the functions generated by
+               edugen.
+
+  Usage: edugenbench [records]
+
+  A checkpoint-like record of builtin fields and a record with nested,
+  pointer and variable-sized fields are each encoded and decoded "records"
+  times, one after the other in the same buffer, as in a cold sync.
+
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "base/ncs_edu_gen.h"
+#include "base/ncs_ubaid.h"
+#include "base/ncssysf_mem.h"
+#include "base/tests/edu_gen_test_edp.h"
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Returns the encode and decode times of "count" records */
+static int bench_run(EDU_HDL *edu_hdl, EDU_PROG_HANDLER edp, void *rec, void *dec_rec, uint32_t count,
+		     double *enc_time, double *dec_time)
+{
+	NCS_UBAID uba;
+	EDU_ERR err;
+	double start;
+	uint32_t i;
+
+	memset(&uba, 0, sizeof(uba));
+	if (ncs_enc_init_space(&uba) != NCSCC_RC_SUCCESS)
+		return 1;
+
+	start = bench_now();
+	for (i = 0; i < count; i++) {
+		if (m_NCS_EDU_EXEC(edu_hdl, edp, &uba, EDP_OP_TYPE_ENC, rec, &err) != NCSCC_RC_SUCCESS) {
+			fprintf(stderr, "encode failed: %d\n", err);
+			return 1;
+		}
+	}
+	*enc_time = bench_now() - start;
+
+	ncs_dec_init_space(&uba, uba.start);
+	start = bench_now();
+	for (i = 0; i < count; i++) {
+		if (m_NCS_EDU_EXEC(edu_hdl, edp, &uba, EDP_OP_TYPE_DEC, &dec_rec, &err) != NCSCC_RC_SUCCESS) {
+			fprintf(stderr, "decode failed: %d\n", err);
+			return 1;
+		}
+		if (edp == edu_gen_test_edp_rec)
+			edu_gen_test_rec_free(dec_rec);
+	}
+	*dec_time = bench_now() - start;
+	m_MMGR_FREE_BUFR_LIST(uba.ub);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static uint8_t data[64];
+	EDU_HDL edu_hdl;
+	EDU_GEN_TEST_CKPT ckpt, dec_ckpt;
+	EDU_GEN_TEST_REC rec, dec_rec;
+	EDU_GEN_TEST_INNER opt;
+	uint32_t count = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100000;
+	struct {
+		const char *name;
+		EDU_PROG_HANDLER edp;
+		void *rec;
+		void *dec_rec;
+	} records[] = {
+		{"ckpt", edu_gen_test_edp_ckpt, &ckpt, &dec_ckpt},
+		{"rec", edu_gen_test_edp_rec, &rec, &dec_rec},
+	};
+	double enc_time[2], dec_time[2];
+	uint32_t i;
+	int gen;
+
+	memset(&ckpt, 0, sizeof(ckpt));
+	ckpt.id = 1;
+	ckpt.dest = 0x2010f00000001ULL;
+	ckpt.name_len = strlen("safChnl=bench");
+	memcpy(ckpt.name, "safChnl=bench", ckpt.name_len);
+	ckpt.time = 1234567890;
+
+	memset(&rec, 0, sizeof(rec));
+	memset(&opt, 0, sizeof(opt));
+	rec.u64 = 0x0123456789abcdefULL;
+	strcpy(rec.text, "safEvtChannel");
+	rec.data_len = sizeof(data);
+	rec.data = data;
+	rec.str = "bench";
+	rec.opt = &opt;
+
+	m_NCS_EDU_HDL_INIT(&edu_hdl);
+	printf("%u records\n", count);
+	for (i = 0; i < sizeof(records) / sizeof(records[0]); i++) {
+		for (gen = 0; gen < 2; gen++) {
+			gl_edu_gen_enabled = gen;
+			if (bench_run(&edu_hdl, records[i].edp, records[i].rec, records[i].dec_rec, count,
+				      &enc_time[gen], &dec_time[gen]) != 0)
+				return EXIT_FAILURE;
+		}
+		printf("%-5s interpreter: encode %8.1f ns, decode %8.1f ns\n", records[i].name,
+		       enc_time[0] * 1e9 / count, dec_time[0] * 1e9 / count);
+		printf("%-5s generated:   encode %8.1f ns, decode %8.1f ns (%.1fx, %.1fx)\n", records[i].name,
+		       enc_time[1] * 1e9 / count, dec_time[1] * 1e9 / count,
+		       enc_time[0] / enc_time[1], dec_time[0] / dec_time[1]);
+	}
+	m_NCS_EDU_HDL_FLUSH(&edu_hdl);
+	return EXIT_SUCCESS;
+}
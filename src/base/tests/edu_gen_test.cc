@@ -0,0 +1,206 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "gtest/gtest.h"
+#include "base/ncs_edu_gen.h"
+#include "base/ncs_ubaid.h"
+#include "base/ncssysf_mem.h"
+#include "base/tests/edu_gen_test_edp.h"
+
+// The fixture for comparing the functions generated by edugen with the
+// EDU interpreter
+class EduGenTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    m_NCS_EDU_HDL_INIT(&edu_hdl_);
+    gl_edu_gen_enabled = true;
+  }
+
+  virtual void TearDown() {
+    m_NCS_EDU_HDL_FLUSH(&edu_hdl_);
+    gl_edu_gen_enabled = true;
+  }
+
+  // Encodes "data", returns the encoded octets
+  std::string Encode(EDU_PROG_HANDLER edp, void *data, bool generated) {
+    NCS_UBAID uba;
+    EDU_ERR err = EDU_NORMAL;
+
+    gl_edu_gen_enabled = generated;
+    memset(&uba, 0, sizeof(uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS,
+              m_NCS_EDU_EXEC(&edu_hdl_, edp, &uba, EDP_OP_TYPE_ENC, data,
+                             &err));
+    USRBUF *ub = uba.start;
+    uint32_t len = m_MMGR_LINK_DATA_LEN(ub);
+    std::string octets(len, '\0');
+    ncs_dec_init_space(&uba, ub);
+    EXPECT_EQ(NCSCC_RC_SUCCESS,
+              ncs_decode_n_octets_from_uba(
+                  &uba, reinterpret_cast<uint8_t *>(&octets[0]), len));
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    return octets;
+  }
+
+  // Decodes "octets" into "data"
+  uint32_t Decode(EDU_PROG_HANDLER edp, const std::string &octets, void *data,
+                  bool generated) {
+    NCS_UBAID uba;
+    EDU_ERR err = EDU_NORMAL;
+
+    gl_edu_gen_enabled = generated;
+    memset(&uba, 0, sizeof(uba));
+    ncs_enc_init_space(&uba);
+    ncs_encode_n_octets_in_uba(
+        &uba,
+        reinterpret_cast<uint8_t *>(const_cast<char *>(octets.data())),
+        octets.size());
+    ncs_dec_init_space(&uba, uba.start);
+    uint32_t rc = m_NCS_EDU_EXEC(&edu_hdl_, edp, &uba, EDP_OP_TYPE_DEC, &data,
+                                 &err);
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    return rc;
+  }
+
+  void FillRec(EDU_GEN_TEST_REC *rec, uint32_t type) {
+    memset(rec, 0, sizeof(*rec));
+    rec->u8 = 0xf1;
+    rec->i8 = -2;
+    rec->c = 'x';
+    rec->u16 = 0xbeef;
+    rec->i16 = -1234;
+    rec->s = 4321;
+    rec->u32 = 0xdeadbeef;
+    rec->i32 = -77777;
+    rec->i = 123456;
+    rec->b = true;
+    rec->u64 = 0x0123456789abcdefULL;
+    rec->i64 = -5;
+    rec->dest = 0x2010f00000001ULL;
+    strcpy(rec->text, "safEvtChannel");
+    for (int i = 0; i < EDU_GEN_TEST_NAME_LEN; i++)
+      rec->name[i] = i;
+    for (int i = 0; i < 4; i++)
+      rec->words[i] = 0x01020304 * (i + 1);
+    rec->data_len = sizeof(data_);
+    rec->data = data_;
+    rec->str = str_;
+    rec->inner.id = 7;
+    strcpy(rec->inner.label, "inner");
+    rec->opt = &opt_;
+    opt_.id = 8;
+    strcpy(opt_.label, "opt");
+    rec->type = type;
+    rec->u = 11;
+    rec->v = 12;
+    rec->trailer = 0xfeedface;
+  }
+
+  EDU_HDL edu_hdl_;
+  uint8_t data_[300] = {1, 2, 3, 4, 5, 6};
+  char str_[8] = "string";
+  EDU_GEN_TEST_INNER opt_;
+};
+
+TEST_F(EduGenTest, EncodesLikeInterpreter) {
+  EDU_GEN_TEST_REC rec;
+
+  for (uint32_t type = 0; type < 2; type++) {
+    FillRec(&rec, type);
+    std::string expected = Encode(edu_gen_test_edp_rec, &rec, false);
+    EXPECT_EQ(expected, Encode(edu_gen_test_edp_rec, &rec, true));
+  }
+
+  // Null pointer, empty variable-sized data and string
+  FillRec(&rec, 0);
+  rec.opt = nullptr;
+  rec.data_len = 0;
+  rec.data = nullptr;
+  rec.str = nullptr;
+  rec.text[0] = '\0';
+  std::string expected = Encode(edu_gen_test_edp_rec, &rec, false);
+  EXPECT_EQ(expected, Encode(edu_gen_test_edp_rec, &rec, true));
+}
+
+TEST_F(EduGenTest, DecodesLikeInterpreter) {
+  EDU_GEN_TEST_REC rec;
+  EDU_GEN_TEST_REC decoded;
+
+  for (uint32_t type = 0; type < 2; type++) {
+    FillRec(&rec, type);
+    std::string octets = Encode(edu_gen_test_edp_rec, &rec, false);
+    ASSERT_EQ(NCSCC_RC_SUCCESS,
+              Decode(edu_gen_test_edp_rec, octets, &decoded, true));
+    EXPECT_EQ(rec.u8, decoded.u8);
+    EXPECT_EQ(rec.i16, decoded.i16);
+    EXPECT_EQ(rec.b, decoded.b);
+    EXPECT_EQ(rec.i64, decoded.i64);
+    EXPECT_STREQ(rec.text, decoded.text);
+    EXPECT_EQ(0, memcmp(rec.name, decoded.name, sizeof(rec.name)));
+    EXPECT_EQ(rec.words[3], decoded.words[3]);
+    ASSERT_EQ(rec.data_len, decoded.data_len);
+    EXPECT_EQ(0, memcmp(rec.data, decoded.data, rec.data_len));
+    EXPECT_STREQ(rec.str, decoded.str);
+    EXPECT_STREQ(rec.inner.label, decoded.inner.label);
+    ASSERT_NE(nullptr, decoded.opt);
+    EXPECT_EQ(rec.opt->id, decoded.opt->id);
+    EXPECT_EQ(type == 0 ? rec.u : 0, decoded.u);
+    EXPECT_EQ(type == 0 ? 0 : rec.v, decoded.v);
+    EXPECT_EQ(rec.trailer, decoded.trailer);
+    // Re-encoded from the decoded record
+    EXPECT_EQ(octets, Encode(edu_gen_test_edp_rec, &decoded, true));
+    edu_gen_test_rec_free(&decoded);
+  }
+}
+
+TEST_F(EduGenTest, MergedFieldsAndJumps) {
+  EDU_GEN_TEST_CKPT ckpt;
+  EDU_GEN_TEST_CKPT decoded;
+
+  memset(&ckpt, 0, sizeof(ckpt));
+  ckpt.id = 1;
+  ckpt.dest = 0x2020f00000002ULL;
+  ckpt.skipped = 3;
+  ckpt.flags = 4;
+  ckpt.name_len = 5;
+  memcpy(ckpt.name, "safSu", 5);
+  ckpt.time = 6;
+  ckpt.count = 7;
+  std::string octets = Encode(edu_gen_test_edp_ckpt, &ckpt, false);
+  EXPECT_EQ(octets, Encode(edu_gen_test_edp_ckpt, &ckpt, true));
+
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            Decode(edu_gen_test_edp_ckpt, octets, &decoded, true));
+  EXPECT_EQ(0U, decoded.skipped);
+  ckpt.skipped = 0;
+  EXPECT_EQ(0, memcmp(&ckpt, &decoded, sizeof(ckpt)));
+}
+
+TEST_F(EduGenTest, DecodeOfTruncatedDataFails) {
+  EDU_GEN_TEST_CKPT ckpt;
+  EDU_GEN_TEST_CKPT decoded;
+
+  memset(&ckpt, 0, sizeof(ckpt));
+  std::string octets = Encode(edu_gen_test_edp_ckpt, &ckpt, false);
+  octets.resize(octets.size() - 1);
+  EXPECT_NE(NCSCC_RC_SUCCESS,
+            Decode(edu_gen_test_edp_ckpt, octets, &decoded, true));
+}
@@ -0,0 +1,170 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+  DESCRIPTION:
+
+  EDU programs for the tests of the functions generated by edugen. This
+  file is processed by edugen into edu_gen_test_edp_edu_gen.{c,h}.
+******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "base/ncs_edu_gen.h"
+#include "base/tests/edu_gen_test_edp.h"
+#include "base/tests/edu_gen_test_edp_edu_gen.h"
+
+static uint32_t edu_gen_test_edp_inner(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr, uint32_t *ptr_data_len,
+				       EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err)
+{
+	EDU_GEN_TEST_INNER *inner = NULL, **inner_dec_ptr;
+
+	EDU_INST_SET edu_gen_test_inner_rules[] = {
+		{EDU_START, edu_gen_test_edp_inner, 0, 0, 0, sizeof(EDU_GEN_TEST_INNER), 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_INNER *)0)->id, 0, NULL},
+		{EDU_EXEC, ncs_edp_char, EDQ_ARRAY, 0, 0, (long)&((EDU_GEN_TEST_INNER *)0)->label, 16, NULL},
+		{EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+	};
+
+	if (op == EDP_OP_TYPE_DEC) {
+		inner_dec_ptr = (EDU_GEN_TEST_INNER **)ptr;
+		if (*inner_dec_ptr == NULL) {
+			/* Pointer field */
+			*inner_dec_ptr = malloc(sizeof(EDU_GEN_TEST_INNER));
+			if (*inner_dec_ptr == NULL) {
+				*o_err = EDU_ERR_MEM_FAIL;
+				return NCSCC_RC_FAILURE;
+			}
+		}
+		memset(*inner_dec_ptr, '\0', sizeof(EDU_GEN_TEST_INNER));
+		inner = *inner_dec_ptr;
+	} else {
+		inner = ptr;
+	}
+
+	return m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, edu_gen_test_inner_rules, inner, ptr_data_len,
+				       buf_env, op, o_err);
+}
+
+/* Jump offset from the "type" rule */
+static int32_t edu_gen_test_type(NCSCONTEXT arg)
+{
+	if (arg == NULL)
+		return EDU_FAIL;
+	return (*(uint32_t *)arg == 0) ? 1 : 2;
+}
+
+uint32_t edu_gen_test_edp_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr, uint32_t *ptr_data_len,
+			      EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err)
+{
+	EDU_GEN_TEST_REC *rec = NULL, **rec_dec_ptr;
+
+	EDU_INST_SET edu_gen_test_rec_rules[] = {
+		{EDU_START, edu_gen_test_edp_rec, 0, 0, 0, sizeof(EDU_GEN_TEST_REC), 0, NULL},
+		{EDU_EXEC, ncs_edp_uns8, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->u8, 0, NULL},
+		{EDU_EXEC, ncs_edp_int8, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->i8, 0, NULL},
+		{EDU_EXEC, ncs_edp_char, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->c, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns16, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->u16, 0, NULL},
+		{EDU_EXEC, ncs_edp_int16, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->i16, 0, NULL},
+		{EDU_EXEC, ncs_edp_short, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->s, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->u32, 0, NULL},
+		{EDU_EXEC, ncs_edp_int32, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->i32, 0, NULL},
+		{EDU_EXEC, ncs_edp_int, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->i, 0, NULL},
+		{EDU_EXEC, ncs_edp_ncs_bool, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->b, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns64, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->u64, 0, NULL},
+		{EDU_EXEC, ncs_edp_int64, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->i64, 0, NULL},
+		{EDU_EXEC, ncs_edp_mds_dest, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->dest, 0, NULL},
+		{EDU_EXEC, ncs_edp_char, EDQ_ARRAY, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->text, 32, NULL},
+		{EDU_EXEC, ncs_edp_uns8, EDQ_ARRAY, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->name,
+		 EDU_GEN_TEST_NAME_LEN, NULL},
+		{EDU_EXEC, ncs_edp_uns32, EDQ_ARRAY, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->words, 4, NULL},
+		{EDU_EXEC, ncs_edp_uns16, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->data_len, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns8, EDQ_VAR_LEN_DATA, ncs_edp_uns16, 0,
+		 (long)&((EDU_GEN_TEST_REC *)0)->data, (long)&((EDU_GEN_TEST_REC *)0)->data_len, NULL},
+		{EDU_EXEC_EXT, NULL, NCS_SERVICE_ID_COMMON /* Svc-ID */ , NULL, 0, 0 /* Sub-ID */ , 0, NULL},
+		{EDU_EXEC, ncs_edp_string, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->str, 0, NULL},
+		{EDU_EXEC, edu_gen_test_edp_inner, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->inner, 0, NULL},
+		{EDU_EXEC, edu_gen_test_edp_inner, EDQ_POINTER, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->opt, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->type, 0, NULL},
+		{EDU_TEST, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->type, 0,
+		 (EDU_EXEC_RTINE)edu_gen_test_type},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 27, (long)&((EDU_GEN_TEST_REC *)0)->u, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns64, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->v, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_REC *)0)->trailer, 0, NULL},
+		{EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+	};
+
+	if (op == EDP_OP_TYPE_DEC) {
+		rec_dec_ptr = (EDU_GEN_TEST_REC **)ptr;
+		if (*rec_dec_ptr == NULL) {
+			*o_err = EDU_ERR_MEM_FAIL;
+			return NCSCC_RC_FAILURE;
+		}
+		memset(*rec_dec_ptr, '\0', sizeof(EDU_GEN_TEST_REC));
+		rec = *rec_dec_ptr;
+	} else {
+		rec = ptr;
+	}
+
+	return m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, edu_gen_test_rec_rules, rec, ptr_data_len,
+				       buf_env, op, o_err);
+}
+
+uint32_t edu_gen_test_edp_ckpt(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr, uint32_t *ptr_data_len,
+			       EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err)
+{
+	EDU_GEN_TEST_CKPT *ckpt = NULL, **ckpt_dec_ptr;
+
+	EDU_INST_SET edu_gen_test_ckpt_rules[] = {
+		{EDU_START, edu_gen_test_edp_ckpt, 0, 0, 0, sizeof(EDU_GEN_TEST_CKPT), 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->id, 0, NULL},
+		{EDU_EXEC, ncs_edp_mds_dest, 0, 0, 4, (long)&((EDU_GEN_TEST_CKPT *)0)->dest, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->skipped, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->flags, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns16, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->name_len, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns8, EDQ_ARRAY, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->name,
+		 EDU_GEN_TEST_NAME_LEN, NULL},
+		{EDU_EXEC, ncs_edp_uns64, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->time, 0, NULL},
+		{EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((EDU_GEN_TEST_CKPT *)0)->count, 0, NULL},
+		{EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+	};
+
+	if (op == EDP_OP_TYPE_DEC) {
+		ckpt_dec_ptr = (EDU_GEN_TEST_CKPT **)ptr;
+		if (*ckpt_dec_ptr == NULL) {
+			*o_err = EDU_ERR_MEM_FAIL;
+			return NCSCC_RC_FAILURE;
+		}
+		memset(*ckpt_dec_ptr, '\0', sizeof(EDU_GEN_TEST_CKPT));
+		ckpt = *ckpt_dec_ptr;
+	} else {
+		ckpt = ptr;
+	}
+
+	return m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, edu_gen_test_ckpt_rules, ckpt, ptr_data_len,
+				       buf_env, op, o_err);
+}
+
+void edu_gen_test_rec_free(EDU_GEN_TEST_REC *rec)
+{
+	free(rec->data);
+	free(rec->str);
+	free(rec->opt);
+	rec->data = NULL;
+	rec->str = NULL;
+	rec->opt = NULL;
+}
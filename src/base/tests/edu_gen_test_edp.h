@@ -0,0 +1,86 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#ifndef BASE_TESTS_EDU_GEN_TEST_EDP_H_
+#define BASE_TESTS_EDU_GEN_TEST_EDP_H_
+
+#include <stdint.h>
+#include "base/ncs_edu_pub.h"
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+#define EDU_GEN_TEST_NAME_LEN 256
+
+typedef struct edu_gen_test_inner {
+  uint32_t id;
+  char label[16];
+} EDU_GEN_TEST_INNER;
+
+/* A record with a field of each kind handled by edugen */
+typedef struct edu_gen_test_rec {
+  uint8_t u8;
+  int8_t i8;
+  char c;
+  uint16_t u16;
+  int16_t i16;
+  short s;
+  uint32_t u32;
+  int32_t i32;
+  int i;
+  bool b;
+  uint64_t u64;
+  int64_t i64;
+  uint64_t dest;
+  char text[32];
+  uint8_t name[EDU_GEN_TEST_NAME_LEN];
+  uint32_t words[4];
+  uint16_t data_len;
+  uint8_t *data;
+  char *str;
+  EDU_GEN_TEST_INNER inner;
+  EDU_GEN_TEST_INNER *opt;
+  uint32_t type;  /* 0: "u" follows, else "v" follows */
+  uint32_t u;
+  uint64_t v;
+  uint32_t trailer;
+} EDU_GEN_TEST_REC;
+
+/* A checkpoint-like record of builtin fields only, with a jump */
+typedef struct edu_gen_test_ckpt {
+  uint32_t id;
+  uint64_t dest;
+  uint32_t skipped;  /* Jumped over, neither encoded nor decoded */
+  uint32_t flags;
+  uint16_t name_len;
+  uint8_t name[EDU_GEN_TEST_NAME_LEN];
+  uint64_t time;
+  uint32_t count;
+} EDU_GEN_TEST_CKPT;
+
+uint32_t edu_gen_test_edp_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr, uint32_t *ptr_data_len,
+                              EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err);
+uint32_t edu_gen_test_edp_ckpt(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn, NCSCONTEXT ptr, uint32_t *ptr_data_len,
+                               EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err);
+void edu_gen_test_rec_free(EDU_GEN_TEST_REC *rec);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // BASE_TESTS_EDU_GEN_TEST_EDP_H_
@@ -0,0 +1,137 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION: Measures the throughput of ncshm_take_hdl()/ncshm_give_hdl()
+               pairs from concurrent threads.
+
+  Usage: hdlbench [pairs per thread] [max threads]
+
+  Each run is done with 1, 2, 4 ... "max threads" threads, once with all
+  threads using the same handle (as many threads using one agent handle)
+  and once with a handle per thread. For comparison, the same is also done
+  with every pair serialized by a mutex, as take() and give() did with the
+  handle pool lock.
+
+******************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "base/ncs_hdl_pub.h"
+
+#define BENCH_MAX_THREADS 64
+
+static uint32_t bench_pairs;
+static uint32_t bench_hdls[BENCH_MAX_THREADS];
+static int bench_shared;
+static int bench_locked;
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t bench_barrier;
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *bench_thread(void *arg)
+{
+	uint32_t hdl = bench_hdls[bench_shared ? 0 : (uintptr_t)arg];
+	uint32_t i;
+
+	pthread_barrier_wait(&bench_barrier);
+	for (i = 0; i < bench_pairs; i++) {
+		if (bench_locked)
+			pthread_mutex_lock(&bench_lock);
+		if (ncshm_take_hdl(NCS_SERVICE_ID_LGA, hdl) == NULL)
+			abort();
+		if (bench_locked) {
+			pthread_mutex_unlock(&bench_lock);
+			pthread_mutex_lock(&bench_lock);
+		}
+		ncshm_give_hdl(hdl);
+		if (bench_locked)
+			pthread_mutex_unlock(&bench_lock);
+	}
+	return NULL;
+}
+
+/* Returns the take()/give() pairs per second of "threads" threads */
+static double bench_run(uint32_t threads)
+{
+	pthread_t tid[BENCH_MAX_THREADS];
+	double start;
+	uint32_t i;
+
+	pthread_barrier_init(&bench_barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++) {
+		if (pthread_create(&tid[i], NULL, bench_thread, (void *)(uintptr_t)i) != 0)
+			return 0;
+	}
+	start = bench_now();
+	pthread_barrier_wait(&bench_barrier);
+	for (i = 0; i < threads; i++)
+		pthread_join(tid[i], NULL);
+	start = bench_now() - start;
+	pthread_barrier_destroy(&bench_barrier);
+
+	return (double)bench_pairs * threads / start;
+}
+
+int main(int argc, char *argv[])
+{
+	static uint32_t objects[BENCH_MAX_THREADS];
+	uint32_t max_threads = (argc > 2) ? strtoul(argv[2], NULL, 0) : 8;
+	uint32_t threads;
+	uint32_t i;
+
+	bench_pairs = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+	if (max_threads < 1 || max_threads > BENCH_MAX_THREADS) {
+		fprintf(stderr, "max threads must be 1..%d\n", BENCH_MAX_THREADS);
+		return EXIT_FAILURE;
+	}
+
+	if (ncshm_init() != NCSCC_RC_SUCCESS)
+		return EXIT_FAILURE;
+	for (i = 0; i < max_threads; i++) {
+		bench_hdls[i] = ncshm_create_hdl(NCS_HM_POOL_ID_COMMON, NCS_SERVICE_ID_LGA, &objects[i]);
+		if (bench_hdls[i] == 0)
+			return EXIT_FAILURE;
+	}
+
+	printf("%u take()/give() pairs per thread, Mpairs/s\n", bench_pairs);
+	printf("%8s %12s %12s %12s %12s\n", "threads", "shared", "per-thread", "shared+lock", "per-thr+lock");
+	for (threads = 1; threads <= max_threads; threads *= 2) {
+		printf("%8u", threads);
+		for (bench_locked = 0; bench_locked < 2; bench_locked++) {
+			for (bench_shared = 1; bench_shared >= 0; bench_shared--)
+				printf(" %12.2f", bench_run(threads) / 1e6);
+		}
+		printf("\n");
+	}
+
+	for (i = 0; i < max_threads; i++)
+		ncshm_destroy_hdl(NCS_SERVICE_ID_LGA, bench_hdls[i]);
+	ncshm_delete();
+	return EXIT_SUCCESS;
+}
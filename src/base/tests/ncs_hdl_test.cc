@@ -0,0 +1,178 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "base/ncs_hdl_pub.h"
+
+namespace {
+
+const NCS_SERVICE_ID kSvcId = NCS_SERVICE_ID_LGA;
+
+// An object guarded by a handle; "alive" is cleared once the handle has
+// been destroyed, which must not happen while a take()r holds the object.
+// "creating" is set while Create() has not yet stored the new handle.
+struct Object {
+  std::atomic<uint32_t> hdl;
+  std::atomic<bool> alive;
+  std::atomic<bool> creating;
+  std::atomic<uint32_t> users;
+};
+
+}  // namespace
+
+class NcsHdlTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { ASSERT_EQ(NCSCC_RC_SUCCESS, ncshm_init()); }
+
+  virtual void TearDown() { ncshm_delete(); }
+
+  static uint32_t Create(Object *obj) {
+    obj->alive = true;
+    obj->users = 0;
+    obj->creating = true;
+    obj->hdl = ncshm_create_hdl(NCS_HM_POOL_ID_COMMON, kSvcId, obj);
+    obj->creating = false;
+    return obj->hdl;
+  }
+
+  static void Destroy(Object *obj) {
+    EXPECT_EQ(obj, ncshm_destroy_hdl(kSvcId, obj->hdl));
+    EXPECT_EQ(0U, obj->users.load());
+    obj->alive = false;
+  }
+};
+
+TEST_F(NcsHdlTest, TakeGiveAndDestroy) {
+  Object obj;
+  ASSERT_NE(0U, Create(&obj));
+
+  EXPECT_EQ(&obj, ncshm_take_hdl(kSvcId, obj.hdl));
+  EXPECT_EQ(&obj, ncshm_take_hdl(kSvcId, obj.hdl));
+  EXPECT_EQ(nullptr, ncshm_take_hdl(NCS_SERVICE_ID_CLMA, obj.hdl));
+  ncshm_give_hdl(obj.hdl);
+  ncshm_give_hdl(obj.hdl);
+  // One give() too many is ignored
+  ncshm_give_hdl(obj.hdl);
+
+  EXPECT_EQ(nullptr, ncshm_destroy_hdl(NCS_SERVICE_ID_CLMA, obj.hdl));
+  EXPECT_EQ(&obj, ncshm_destroy_hdl(kSvcId, obj.hdl));
+  EXPECT_EQ(nullptr, ncshm_take_hdl(kSvcId, obj.hdl));
+  EXPECT_EQ(nullptr, ncshm_destroy_hdl(kSvcId, obj.hdl));
+}
+
+TEST_F(NcsHdlTest, StaleHandleOfReusedCellIsRejected) {
+  Object obj;
+  Object other;
+  ASSERT_NE(0U, Create(&obj));
+  uint32_t stale = obj.hdl.load();
+  Destroy(&obj);
+
+  // Free cells are reused last in, first out
+  ASSERT_NE(0U, Create(&other));
+  EXPECT_NE(stale, other.hdl.load());
+  EXPECT_EQ(stale & ~0xfU, other.hdl & ~0xfU);
+  EXPECT_EQ(nullptr, ncshm_take_hdl(kSvcId, stale));
+  ncshm_give_hdl(stale);
+  EXPECT_EQ(&other, ncshm_take_hdl(kSvcId, other.hdl));
+  ncshm_give_hdl(other.hdl);
+  Destroy(&other);
+}
+
+TEST_F(NcsHdlTest, DestroyBlocksUntilLastGive) {
+  Object obj;
+  std::atomic<bool> destroyed(false);
+  ASSERT_NE(0U, Create(&obj));
+  ASSERT_EQ(&obj, ncshm_take_hdl(kSvcId, obj.hdl));
+  ASSERT_EQ(&obj, ncshm_take_hdl(kSvcId, obj.hdl));
+
+  std::thread destroyer([&] {
+    EXPECT_EQ(&obj, ncshm_destroy_hdl(kSvcId, obj.hdl));
+    destroyed = true;
+  });
+  usleep(20000);
+  EXPECT_FALSE(destroyed);
+  // No new take()s once the destroy() has started
+  EXPECT_EQ(nullptr, ncshm_take_hdl(kSvcId, obj.hdl));
+  ncshm_give_hdl(obj.hdl);
+  usleep(20000);
+  EXPECT_FALSE(destroyed);
+  ncshm_give_hdl(obj.hdl);
+  destroyer.join();
+  EXPECT_TRUE(destroyed);
+}
+
+// take() and give() from many threads while other threads destroy and
+// re-create the handles being taken
+TEST_F(NcsHdlTest, StressTakeGiveWithDestroy) {
+  const int kObjects = 64;
+  const int kTakers = 8;
+  const int kDestroyers = 2;
+  const int kRounds = 2000;
+  std::vector<Object> objects(kObjects);
+  std::vector<std::atomic<uint32_t>> hdls(kObjects);
+  std::atomic<bool> done(false);
+  std::atomic<uint64_t> taken(0);
+
+  for (int i = 0; i < kObjects; i++) {
+    ASSERT_NE(0U, Create(&objects[i]));
+    hdls[i] = objects[i].hdl.load();
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kTakers; t++) {
+    threads.emplace_back([&, t] {
+      uint64_t n = 0;
+      for (uint32_t i = t; !done; i++) {
+        uint32_t hdl = hdls[i % kObjects];
+        Object *obj = static_cast<Object *>(ncshm_take_hdl(kSvcId, hdl));
+        if (obj == nullptr) continue;
+        ++obj->users;
+        // The 4 bit sequence number of a handle wraps, so a stale "hdl" can
+        // take an object that Create() has just given that same handle but
+        // not yet stored it in
+        while (obj->creating) std::this_thread::yield();
+        EXPECT_EQ(hdl, obj->hdl.load());
+        EXPECT_TRUE(obj->alive);
+        --obj->users;
+        ncshm_give_hdl(hdl);
+        n++;
+      }
+      taken += n;
+    });
+  }
+  for (int t = 0; t < kDestroyers; t++) {
+    threads.emplace_back([&, t] {
+      for (int r = 0; r < kRounds; r++) {
+        // Each destroyer owns every other object
+        int i = (r * kDestroyers + t) % kObjects;
+        Destroy(&objects[i]);
+        ASSERT_NE(0U, Create(&objects[i]));
+        hdls[i] = objects[i].hdl.load();
+      }
+    });
+  }
+  for (int t = kTakers; t < kTakers + kDestroyers; t++) threads[t].join();
+  done = true;
+  for (int t = 0; t < kTakers; t++) threads[t].join();
+
+  EXPECT_LT(0U, taken.load());
+  for (int i = 0; i < kObjects; i++) Destroy(&objects[i]);
+}
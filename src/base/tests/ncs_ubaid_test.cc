@@ -0,0 +1,164 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <sys/uio.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "base/ncs_ubaid.h"
+#include "base/ncsencdec_pub.h"
+#include "base/ncssysf_mem.h"
+#include "base/usrbuf.h"
+
+// The fixture for testing the contiguous mode of NCS_UBAID
+class NcsUbaidTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    memset(&uba_, 0, sizeof(uba_));
+    for (size_t i = 0; i < sizeof(data_); i++)
+      data_[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  virtual void TearDown() {
+    if (uba_.start != nullptr)
+      m_MMGR_FREE_BUFR_LIST(uba_.start);
+  }
+
+  // Returns the number of USRBUFs holding data in "ub"
+  static int Segments(USRBUF *ub) {
+    struct iovec iov[64];
+    return m_MMGR_IOVEC(ub, m_MMGR_LINK_DATA_LEN(ub), iov, 64);
+  }
+
+  // Returns the data of "ub" as a string, read through an iovec array
+  static std::string Gather(USRBUF *ub) {
+    struct iovec iov[64];
+    std::string octets;
+    int cnt = m_MMGR_IOVEC(ub, m_MMGR_LINK_DATA_LEN(ub), iov, 64);
+
+    EXPECT_LT(0, cnt);
+    for (int i = 0; i < cnt; i++)
+      octets.append(static_cast<char *>(iov[i].iov_base), iov[i].iov_len);
+    return octets;
+  }
+
+  NCS_UBAID uba_;
+  uint8_t data_[3 * PAYLOAD_BUF_SIZE];
+};
+
+TEST_F(NcsUbaidTest, ReservesMoreThanPayloadBufSize) {
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_enc_init_space_contig(&uba_, NCSUB_MDS_POOL, 0));
+  uint8_t *p = ncs_enc_reserve_space(&uba_, sizeof(data_));
+  ASSERT_NE(nullptr, p);
+  memcpy(p, data_, sizeof(data_));
+  ncs_enc_claim_space(&uba_, sizeof(data_));
+
+  EXPECT_EQ(sizeof(data_), m_MMGR_LINK_DATA_LEN(uba_.start));
+  EXPECT_EQ(static_cast<int32_t>(sizeof(data_)), uba_.ttl);
+  EXPECT_EQ(1, Segments(uba_.start));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data_), sizeof(data_)),
+            Gather(uba_.start));
+}
+
+TEST_F(NcsUbaidTest, GrowsByDoublingSegments) {
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_enc_init_space_contig(&uba_, NCSUB_MDS_POOL, 0));
+  std::string expected;
+  for (int i = 0; i < 10000; i++) {
+    uint8_t *p = ncs_enc_reserve_space(&uba_, 4);
+    ASSERT_NE(nullptr, p);
+    ncs_encode_32bit(&p, i);
+    ncs_enc_claim_space(&uba_, 4);
+    expected.append(reinterpret_cast<char *>(p) - 4, 4);
+  }
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_encode_n_octets_in_uba(&uba_, data_, sizeof(data_)));
+  expected.append(reinterpret_cast<char *>(data_), sizeof(data_));
+
+  // 64000 octets fit in 8000 + 16000 + 32000 + 64000 octet segments
+  EXPECT_EQ(4, Segments(uba_.start));
+  EXPECT_EQ(expected, Gather(uba_.start));
+  for (USRBUF *ub = uba_.start; ub != nullptr; ub = ub->link)
+    EXPECT_LE(ub->start + ub->count, ub->payload->Size);
+
+  ncs_dec_init_space(&uba_, uba_.start);
+  uba_.start = nullptr;
+  for (uint32_t i = 0; i < 10000; i++) {
+    uint8_t space[4];
+    uint8_t *p = ncs_dec_flatten_space(&uba_, space, 4);
+    ASSERT_EQ(i, ncs_decode_32bit(&p));
+    ncs_dec_skip_space(&uba_, 4);
+  }
+  std::vector<uint8_t> decoded(sizeof(data_));
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_decode_n_octets_from_uba(&uba_, decoded.data(),
+                                         decoded.size()));
+  EXPECT_EQ(0, memcmp(data_, decoded.data(), sizeof(data_)));
+  // Decoding frees the consumed USRBUFs
+  EXPECT_EQ(nullptr, uba_.ub);
+}
+
+TEST_F(NcsUbaidTest, ChainModeIsUnchanged) {
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_enc_init_space_pp(&uba_, NCSUB_MDS_POOL, 0));
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_encode_n_octets_in_uba(&uba_, data_, sizeof(data_)));
+  EXPECT_LT(3, Segments(uba_.start));
+  EXPECT_EQ(std::string(reinterpret_cast<char *>(data_), sizeof(data_)),
+            Gather(uba_.start));
+}
+
+TEST_F(NcsUbaidTest, CopiesAndWritesLargePayloads) {
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_enc_init_space_contig(&uba_, NCSUB_MDS_POOL, sizeof(data_)));
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_encode_n_octets_in_uba(&uba_, data_, sizeof(data_)));
+  // The size hint is honoured by the first USRBUF
+  ASSERT_EQ(nullptr, uba_.start->link);
+
+  USRBUF *copy = m_MMGR_COPY_BUFR(uba_.start);
+  ASSERT_NE(nullptr, copy);
+  EXPECT_EQ(Gather(uba_.start), Gather(copy));
+  m_MMGR_FREE_BUFR_LIST(copy);
+
+  // Writing into shared data makes a private copy of the whole payload
+  USRBUF *ditto = m_MMGR_DITTO_BUFR(uba_.start);
+  ASSERT_NE(nullptr, ditto);
+  char marker[4] = {'o', 's', 'a', 'f'};
+  ASSERT_NE(nullptr, sysf_write_in_mid(ditto, sizeof(data_) - 4, 4, marker));
+  EXPECT_NE(uba_.start->payload, ditto->payload);
+  std::string octets = Gather(ditto);
+  EXPECT_EQ(std::string(marker, 4), octets.substr(sizeof(data_) - 4));
+  EXPECT_EQ(0, memcmp(data_, octets.data(), sizeof(data_) - 4));
+  m_MMGR_FREE_BUFR_LIST(ditto);
+}
+
+TEST_F(NcsUbaidTest, IovecCoversRequestedLength) {
+  ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba_));
+  ASSERT_EQ(NCSCC_RC_SUCCESS,
+            ncs_encode_n_octets_in_uba(&uba_, data_, sizeof(data_)));
+  uint32_t len = m_MMGR_LINK_DATA_LEN(uba_.start);
+  struct iovec iov[8];
+
+  EXPECT_EQ(3, m_MMGR_IOVEC(uba_.start, len, iov, 8));
+  EXPECT_EQ(2, m_MMGR_IOVEC(uba_.start, PAYLOAD_BUF_SIZE + 1, iov, 8));
+  EXPECT_EQ(1U, iov[1].iov_len);
+  EXPECT_EQ(-1, m_MMGR_IOVEC(uba_.start, len, iov, 2));
+  EXPECT_EQ(-1, m_MMGR_IOVEC(uba_.start, len + 1, iov, 8));
+}
@@ -239,3 +239,187 @@ TEST_F(SysfIpcTest, TestThreadsSendReceiveMessage) {
 
   msg_receiver.join();
 }
+
+// Tests receiving a batch of messages
+TEST_F(SysfIpcTest, TestBatchReceiveMessage) {
+  Message *msg;
+
+  send_msg(NCS_IPC_PRIORITY_LOW, 1);
+  send_msg(NCS_IPC_PRIORITY_NORMAL, 1);
+  send_msg(NCS_IPC_PRIORITY_NORMAL, 2);
+  send_msg(NCS_IPC_PRIORITY_VERY_HIGH, 1);
+  send_msg(NCS_IPC_PRIORITY_LOW, 2);
+
+  // highest priority first, in sending order within a priority
+  msg = reinterpret_cast<Message*>(ncs_ipc_non_blk_recv_batch(&mbox, 3));
+  ASSERT_TRUE(msg != NULL);
+  EXPECT_EQ(msg->prio, NCS_IPC_PRIORITY_VERY_HIGH);
+  ASSERT_TRUE(msg->next != NULL);
+  EXPECT_EQ(msg->next->prio, NCS_IPC_PRIORITY_NORMAL);
+  EXPECT_EQ(msg->next->seq_no, 1);
+  ASSERT_TRUE(msg->next->next != NULL);
+  EXPECT_EQ(msg->next->next->seq_no, 2);
+  EXPECT_TRUE(msg->next->next->next == NULL);
+  mbox_clean(NULL, msg);
+
+  msg = reinterpret_cast<Message*>(ncs_ipc_non_blk_recv_batch(&mbox, 10));
+  ASSERT_TRUE(msg != NULL);
+  EXPECT_EQ(msg->seq_no, 1);
+  ASSERT_TRUE(msg->next != NULL);
+  EXPECT_EQ(msg->next->seq_no, 2);
+  EXPECT_TRUE(msg->next->next == NULL);
+  mbox_clean(NULL, msg);
+
+  // The selection object is no longer raised
+  pollfd fds;
+  fds.fd = ncs_ipc_get_sel_obj(&mbox).rmv_obj;
+  fds.events = POLLIN;
+  EXPECT_EQ(poll(&fds, 1, 0), 0);
+  EXPECT_TRUE(ncs_ipc_non_blk_recv_batch(&mbox, 10) == NULL);
+}
+
+// Measures messages per second from concurrent senders to one receiver,
+// receiving one message or a batch of messages per call
+TEST_F(SysfIpcTest, BenchmarkSendReceive) {
+  const int kSenders = 4;
+  const int kMessages = 50000;
+
+  for (uint32_t batch : {1, 64}) {
+    std::thread sndr_thread[kSenders];
+    struct timespec start, end;
+    int received = 0;
+    pollfd fds;
+
+    fds.fd = ncs_ipc_get_sel_obj(&mbox).rmv_obj;
+    fds.events = POLLIN;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < kSenders; ++i) {
+      sndr_thread[i] = std::thread {[] {
+        for (int j = 0; j < kMessages; ++j) {
+          Message* msg = new Message;
+          msg->prio = NCS_IPC_PRIORITY_NORMAL;
+          msg->seq_no = j;
+          EXPECT_EQ(m_NCS_IPC_SEND(&mbox, msg, msg->prio), NCSCC_RC_SUCCESS);
+        }
+      }};
+    }
+
+    while (received < kSenders * kMessages) {
+      ASSERT_EQ(poll(&fds, 1, 10000), 1);
+      Message *msg = reinterpret_cast<Message*>(
+          ncs_ipc_non_blk_recv_batch(&mbox, batch));
+      while (msg != NULL) {
+        Message *next = msg->next;
+        delete msg;
+        msg = next;
+        received++;
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (int i = 0; i < kSenders; ++i) {
+      sndr_thread[i].join();
+    }
+
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    std::cout << kSenders << " senders, batch " << batch << ": "
+              << received / secs << " msgs/s" << std::endl;
+    EXPECT_TRUE(ncs_ipc_non_blk_recv(&mbox) == NULL);
+  }
+}
+
+// Measures a send and receive on an empty mailbox, which raises and
+// removes an indication on the selection object each time
+TEST_F(SysfIpcTest, BenchmarkSendReceiveEmptyMailbox) {
+  const int kMessages = 100000;
+  Message msg;
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < kMessages; ++i) {
+    ASSERT_EQ(m_NCS_IPC_SEND(&mbox, &msg, NCS_IPC_PRIORITY_NORMAL),
+              NCSCC_RC_SUCCESS);
+    ASSERT_EQ(reinterpret_cast<Message*>(ncs_ipc_non_blk_recv(&mbox)), &msg);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double nsecs = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+  std::cout << "send and receive: " << nsecs / kMessages << " ns" << std::endl;
+}
+
+// Tests that a bare indication on the selection object, as raised by the CLM
+// agent on the mailbox of a stale handle, makes a blocking receive return
+// NULL instead of waiting for a message
+TEST_F(SysfIpcTest, TestBareIndicationWakesBlockingReceive) {
+  std::atomic<bool> returned {false};
+  Message *msg = reinterpret_cast<Message*>(1);
+
+  std::thread receiver {[&] {
+    msg = reinterpret_cast<Message*>(ncs_ipc_recv(&mbox));
+    returned = true;
+  }};
+
+  usleep(20000);
+  EXPECT_FALSE(returned);
+  NCS_SEL_OBJ sel_obj = m_NCS_IPC_GET_SEL_OBJ(&mbox);
+  ASSERT_EQ(m_NCS_SEL_OBJ_IND(&sel_obj), NCSCC_RC_SUCCESS);
+  receiver.join();
+  EXPECT_TRUE(msg == NULL);
+
+  // The mailbox still works after the wakeup
+  send_msg(NCS_IPC_PRIORITY_NORMAL, 1);
+  recv_msg(NCS_IPC_PRIORITY_NORMAL, 1);
+}
+
+static std::atomic<int> no_of_msgs_flushed {0};
+
+static bool mbox_count_clean(NCSCONTEXT arg, NCSCONTEXT msg) {
+  for (Message *curr = reinterpret_cast<Message*>(msg); curr;) {
+    Message* temp = curr;
+    curr = curr->next;
+    no_of_msgs_flushed++;
+    delete temp;
+  }
+  return true;
+}
+
+// Tests that every message accepted by a send racing with the last detach
+// is flushed by the detach, and every other message is returned to the sender
+TEST_F(SysfIpcTest, TestSendRacingWithLastDetach) {
+  const int kSenders = 2;
+
+  for (int round = 0; round < 200; ++round) {
+    SYSF_MBX race_mbox {0};
+    std::atomic<int> accepted {0};
+    std::thread sndr_thread[kSenders];
+
+    ASSERT_EQ(m_NCS_IPC_CREATE(&race_mbox), NCSCC_RC_SUCCESS);
+    ASSERT_EQ(m_NCS_IPC_ATTACH(&race_mbox), NCSCC_RC_SUCCESS);
+    no_of_msgs_flushed = 0;
+
+    for (int i = 0; i < kSenders; ++i) {
+      sndr_thread[i] = std::thread {[&] {
+        for (;;) {
+          Message* msg = new Message;
+          msg->prio = NCS_IPC_PRIORITY_NORMAL;
+          msg->seq_no = 0;
+          if (m_NCS_IPC_SEND(&race_mbox, msg, msg->prio) != NCSCC_RC_SUCCESS) {
+            delete msg;
+            break;
+          }
+          accepted++;
+        }
+      }};
+    }
+
+    sched_yield();
+    ASSERT_EQ(m_NCS_IPC_DETACH(&race_mbox, mbox_count_clean, 0),
+              NCSCC_RC_SUCCESS);
+    for (int i = 0; i < kSenders; ++i) {
+      sndr_thread[i].join();
+    }
+
+    EXPECT_EQ(accepted, no_of_msgs_flushed);
+    ASSERT_EQ(m_NCS_IPC_RELEASE(&race_mbox, 0), NCSCC_RC_SUCCESS);
+  }
+}
@@ -18,6 +18,7 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <cstdint>
 #include <random>
 
 #include "base/ncssysf_tmr.h"
@@ -147,3 +148,77 @@ TEST_F(SysfTmrTest, CreateOneMillionTimers) {
   EXPECT_EQ(expired_, false);
 }
 
+// Start 100k concurrent timers from several threads, measure the start
+// rate and check that no timer expires before its timeout or much later
+// than it
+TEST_F(SysfTmrTest, StartAndExpireHundredThousandTimers) {
+  static const int kThreads = 4;
+  static const int kTimersPerThread = 25000;
+  static const int kTimers = kThreads * kTimersPerThread;
+  // The deadline is taken before ncs_tmr_start() rounds the current time
+  // down to a whole 1 ms wheel tick, so a timer may fire up to 1 ms before
+  // it. The upper bound leaves room for the starting threads and the 100k
+  // callbacks competing for the CPU on a loaded host.
+  static const int64_t kMinLatenessUs = -1000;
+  static const int64_t kMaxLatenessUs = 100000;
+  static std::atomic<int> expired {0};
+  static std::atomic<int64_t> min_lateness_us {0};
+  static std::atomic<int64_t> max_lateness_us {0};
+  struct Expiry {
+    steady_clock::time_point deadline;
+    tmr_t tmr;
+  };
+  static Expiry expiries[kTimers];
+  expired = 0;
+  min_lateness_us = INT64_MAX;
+  max_lateness_us = INT64_MIN;
+
+  auto callback = [](void* arg) {
+    Expiry* e = static_cast<Expiry*>(arg);
+    int64_t late =
+        duration_cast<microseconds>(steady_clock::now() - e->deadline).count();
+    int64_t prev = max_lateness_us;
+    while (late > prev && !max_lateness_us.compare_exchange_weak(prev, late)) {
+    }
+    prev = min_lateness_us;
+    while (late < prev && !min_lateness_us.compare_exchange_weak(prev, late)) {
+    }
+    ncs_tmr_free(e->tmr);
+    ++expired;
+  };
+
+  auto start_time = steady_clock::now();
+  std::thread threads[kThreads];
+  for (int t = 0; t < kThreads; ++t) {
+    threads[t] = std::thread([t, callback]() {
+      std::mt19937 generator(t);
+      std::uniform_int_distribution<int64_t> delay(1, 100);
+      for (int i = 0; i < kTimersPerThread; ++i) {
+        Expiry* e = &expiries[t * kTimersPerThread + i];
+        int64_t timeout = delay(generator);
+        e->deadline = steady_clock::now() + milliseconds(timeout * 10);
+        e->tmr = ncs_tmr_alloc(const_cast<char*>(__FILE__), __LINE__);
+        ASSERT_NE(e->tmr, TMR_T_NULL);
+        ASSERT_NE(ncs_tmr_start(e->tmr, timeout, callback, e,
+                                const_cast<char*>(__FILE__), __LINE__),
+                  TMR_T_NULL);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  auto start_duration = steady_clock::now() - start_time;
+
+  while (expired != kTimers) {
+    ASSERT_LT(steady_clock::now() - start_time, seconds(30));
+    std::this_thread::sleep_for(milliseconds(10));
+  }
+
+  std::cout << "Started " << kTimers << " timers in "
+            << duration_cast<microseconds>(start_duration).count() << " us, "
+            << "lateness " << min_lateness_us << " .. " << max_lateness_us
+            << " us\n";
+  EXPECT_EQ(expired, kTimers);
+  EXPECT_GE(min_lateness_us, kMinLatenessUs);
+  EXPECT_LE(max_lateness_us, kMaxLatenessUs);
+}
+
@@ -1068,7 +1068,6 @@ SaAisErrorT saCkptCheckpointOpen(SaCkptHandleT ckptHandle, const SaNameT *checkp
 
                if ( add_flag == false)
                {
-                       gc_node->open.info.open.o_addr=out_evt->info.cpa.info.openRsp.addr;
                        gc_node->ckpt_creat_attri = out_evt->info.cpa.info.openRsp.creation_attr;
 
                        /*To store the active MDS_DEST info of checkpoint */
@@ -3927,6 +3926,21 @@ SaAisErrorT saCkptCheckpointRead(SaCkptCheckpointHandleT checkpointHandle,
 		goto done;
 	}
 
+	/* Read the local replica from shared memory, without a round trip to
+	   CPND, when it can be mapped */
+	if ((is_local_read == true) && (gc_node->is_shm_open_failed == false)) {
+		if ((gc_node->open.info.open.o_addr != NULL) ||
+		    (cpa_proc_shm_open(cb, gc_node, lc_node->ckpt_name) == NCSCC_RC_SUCCESS)) {
+			proc_rc = cpa_proc_replica_read(gc_node, numberOfElements, ioVector,
+							erroneousVectorIndex, &cl_node->version, &rc);
+			if (proc_rc == NCSCC_RC_SUCCESS) {
+				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+				goto fail1;
+			}
+			rc = SA_AIS_OK;
+		}
+	}
+
 	/* Populate the event & send it to CPND */
 	evt.type = CPSV_EVT_TYPE_CPND;
 	evt.info.cpnd.type = CPND_EVT_A2ND_CKPT_READ;
@@ -50,7 +50,10 @@ typedef struct cpa_glbl_ckpt_node {
 	NCS_PATRICIA_NODE patnode;
 	SaCkptCheckpointHandleT gbl_ckpt_hdl;	/* globally aware handle */
 	/*SaCkptCheckpointHandleT    lcl_ckpt_hdl; */
-	NCS_OS_POSIX_SHM_REQ_INFO open;
+	NCS_OS_POSIX_SHM_REQ_INFO open;	/* Local replica, mapped read only */
+	bool is_shm_open_failed;	/* Local replica can not be mapped, read through CPND */
+	uint32_t *sec_slots;	/* Replica slot + 1 of a section, by hash of its id */
+	uint32_t n_sec_slots;
 	SaCkptCheckpointCreationAttributesT ckpt_creat_attri;
 	uint32_t ref_cnt;		/* Client count */
 	MDS_DEST active_mds_dest;
@@ -119,7 +122,7 @@ typedef struct cpa_cb {
 
 } CPA_CB;
 
-uint32_t gl_cpa_hdl;
+extern uint32_t gl_cpa_hdl;
 
 typedef struct cpa_prcess_evt_sync {
 	NCS_QELEM qelem;
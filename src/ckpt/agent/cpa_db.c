@@ -449,8 +449,8 @@ uint32_t cpa_gbl_ckpt_node_delete(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node)
 		rc = NCSCC_RC_FAILURE;
 	}
 
-	if (gc_node)
-		m_MMGR_FREE_CPA_GLOBAL_CKPT_NODE(gc_node);
+	cpa_proc_shm_close(gc_node);
+	m_MMGR_FREE_CPA_GLOBAL_CKPT_NODE(gc_node);
 
 	return rc;
 
@@ -28,6 +28,7 @@
 ******************************************************************************
 */
 
+#include <sys/stat.h>
 #include "ckpt/agent/cpa.h"
 #include "base/osaf_poll.h"
 
@@ -1233,71 +1234,355 @@ void cpa_proc_free_read_data(CPSV_ND2A_DATA_ACCESS_RSP *rmt_read_rsp)
 	}
 }
 
+/* Number of times a section is looked up again when CPND keeps updating
+   it. The lookups are done with cb_lock held, so the count is kept low and
+   a section that stays busy is read through CPND instead. */
+#define CPA_REPLICA_READ_MAX_RETRIES 16
+
+/* Most entries of the section slot index of a mapped replica */
+#define CPA_REPLICA_MAX_SEC_SLOTS 4096
+
 /****************************************************************************
-  Name          : cpa_proc_replica_read
-  Description   : reads replica from (shared memory )
-  Arguments     :  cb         ---   Control block of CPA
-                   ioVector   ---   ioVector of Data
-                   read_map   ---   read_map information received from ND
-                   erroneousVectorIndex ---   Vector Index
-                   gbl_ckpt_hdl  ----  Global Checkpoint Hdl
-                   numbeofOfElements --- Number of Elements
+  Name          : cpa_proc_shm_open
+  Description   : Maps the local replica of a checkpoint read only, so that
+                  it can be read without a round trip to CPND. The name of the
+                  shared memory object is built as in cpnd_ckpt_replica_create.
+  Arguments     : cb         ---   Control block of CPA
+                  gc_node    ---   Global checkpoint node
+                  ckpt_name  ---   Checkpoint name
   Return Values : NCSCC_RC_FAILURE/NCSCC_RC_SUCCESS
   Notes         : None
 ******************************************************************************/
-uint32_t cpa_proc_replica_read(CPA_CB *cb, SaUint32T numberOfElements,
-			    SaCkptCheckpointHandleT gbl_ckpt_hdl,
-			    SaCkptIOVectorElementT **ioVector, CPSV_ND2A_READ_MAP *read_map,
-			    SaUint32T **erroneousVectorIndex)
+uint32_t cpa_proc_shm_open(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node, SaConstStringT ckpt_name)
 {
-	uint32_t iter = 0, rc = NCSCC_RC_SUCCESS;
-	NCS_OS_POSIX_SHM_REQ_INFO shm_info;
-	CPA_GLOBAL_CKPT_NODE *gc_node;
-	bool add_flag = false;
+	NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open = &gc_node->open.info.open;
+	char rep_name[CPSV_REPLICA_NAME_MAX_LENGTH];
+	char shm_name[CPSV_REPLICA_NAME_MAX_LENGTH + 16];
+	struct stat shm_stat;
+	void *addr;
+	int fd;
 
 	TRACE_ENTER();
-	memset(&shm_info, '\0', sizeof(NCS_OS_POSIX_SHM_REQ_INFO));
+	memset(rep_name, '\0', sizeof(rep_name));
+	strncpy(rep_name, ckpt_name, CPSV_REPLICA_NAME_MAX_CKPT_NAME_LENGTH);
+	sprintf(rep_name + strlen(rep_name) - 1, "_%u_%llu",
+		(uint32_t)m_NCS_NODE_ID_FROM_MDS_DEST(cb->cpnd_mds_dest), gc_node->gbl_ckpt_hdl);
+	snprintf(shm_name, sizeof(shm_name), "/opensaf_%s", rep_name);
+
+	open->i_size = sizeof(CPSV_CKPT_HDR) + gc_node->ckpt_creat_attri.maxSections *
+	    (sizeof(CPSV_SECT_HDR) + gc_node->ckpt_creat_attri.maxSectionSize);
+
+	fd = shm_open(shm_name, O_RDONLY, 0);
+	if (fd < 0) {
+		TRACE_4("cpa shm_open of %s failed: %s", shm_name, strerror(errno));
+		goto fail;
+	}
 
-	cpa_gbl_ckpt_node_find_add(&cb->gbl_ckpt_tree, &gbl_ckpt_hdl, &gc_node, &add_flag);
+	/* A replica smaller than expected would fault on access */
+	if (fstat(fd, &shm_stat) < 0 || (uint64_t)shm_stat.st_size < open->i_size) {
+		TRACE_4("cpa replica %s has unexpected size", shm_name);
+		close(fd);
+		goto fail;
+	}
 
-	for (; iter < numberOfElements; iter++) {
-		if (read_map[iter].offset_index == -1) {
-			if (*erroneousVectorIndex != NULL) 
-				(*erroneousVectorIndex)[0] = iter;
-			TRACE_LEAVE();
-			return NCSCC_RC_FAILURE;
-		}
+	addr = mmap(NULL, open->i_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		TRACE_4("cpa mmap of %s failed: %s", shm_name, strerror(errno));
+		close(fd);
+		goto fail;
+	}
 
-		(*ioVector)[iter].readSize = read_map[iter].read_size;
+	/* Index of the slots sections were last found in, so that a section
+	   read again is not searched for among all slots */
+	gc_node->n_sec_slots = gc_node->ckpt_creat_attri.maxSections;
+	if (gc_node->n_sec_slots > CPA_REPLICA_MAX_SEC_SLOTS)
+		gc_node->n_sec_slots = CPA_REPLICA_MAX_SEC_SLOTS;
+	gc_node->sec_slots = m_MMGR_ALLOC_CPA_DEFAULT(gc_node->n_sec_slots * sizeof(uint32_t));
+	if (gc_node->sec_slots == NULL) {
+		TRACE_4("cpa section slot index allocation failed");
+		munmap(addr, open->i_size);
+		close(fd);
+		goto fail;
+	}
+	memset(gc_node->sec_slots, 0, gc_node->n_sec_slots * sizeof(uint32_t));
 
-		if (read_map[iter].read_size == 0) {
-			continue;
+	open->o_addr = addr;
+	open->o_fd = fd;
+	TRACE_LEAVE();
+	return NCSCC_RC_SUCCESS;
+
+ fail:
+	gc_node->is_shm_open_failed = true;
+	TRACE_LEAVE();
+	return NCSCC_RC_FAILURE;
+}
+
+/****************************************************************************
+  Name          : cpa_proc_shm_close
+  Description   : Unmaps the local replica of a checkpoint
+  Arguments     : gc_node    ---   Global checkpoint node
+  Return Values : None
+  Notes         : None
+******************************************************************************/
+void cpa_proc_shm_close(CPA_GLOBAL_CKPT_NODE *gc_node)
+{
+	NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open = &gc_node->open.info.open;
+
+	if (open->o_addr == NULL)
+		return;
+
+	munmap(open->o_addr, open->i_size);
+	close(open->o_fd);
+	open->o_addr = NULL;
+	open->o_fd = -1;
+	m_MMGR_FREE_CPA_DEFAULT(gc_node->sec_slots);
+	gc_node->sec_slots = NULL;
+	gc_node->n_sec_slots = 0;
+}
+
+/* Index entry of a section id in the section slot index, FNV-1a */
+static uint32_t cpa_proc_sec_slot_hash(CPA_GLOBAL_CKPT_NODE *gc_node, const SaCkptSectionIdT *id)
+{
+	uint32_t hash = 2166136261u;
+	uint16_t i;
+
+	for (i = 0; i < id->idLen; i++)
+		hash = (hash ^ id->id[i]) * 16777619u;
+	return hash % gc_node->n_sec_slots;
+}
+
+/* Returns the even generation of the section header if it holds the section */
+static bool cpa_proc_sec_hdr_match(CPSV_SECT_HDR *hdr, const SaCkptSectionIdT *id, uint32_t *generation,
+				   bool *busy)
+{
+	uint32_t gen = __atomic_load_n(&hdr->generation, __ATOMIC_ACQUIRE);
+
+	if (gen & 1) {
+		*busy = true;
+		return false;
+	}
+	if (hdr->in_use && hdr->idLen == id->idLen &&
+	    (id->idLen == 0 || memcmp(hdr->id, id->id, id->idLen) == 0)) {
+		*generation = gen;
+		return true;
+	}
+	return false;
+}
+
+/****************************************************************************
+  Name          : cpa_proc_replica_sec_read
+  Description   : Reads one IO vector element from the mapped replica. The
+                  section is looked up by id in the slot it was last found
+                  in, else among all section headers, and read between two
+                  loads of its generation, which CPND keeps odd while it
+                  updates the section.
+  Arguments     : gc_node    ---   Global checkpoint node
+                  iov        ---   IO vector element
+                  version    ---   Client version, selects the allocator
+                  allocated  ---   Set if the data buffer was allocated here
+  Return Values : SA_AIS_OK, SA_AIS_ERR_NOT_EXIST, SA_AIS_ERR_INVALID_PARAM,
+                  SA_AIS_ERR_NO_MEMORY or SA_AIS_ERR_TRY_AGAIN
+  Notes         : None
+******************************************************************************/
+static SaAisErrorT cpa_proc_replica_sec_read(CPA_GLOBAL_CKPT_NODE *gc_node, SaCkptIOVectorElementT *iov,
+					     SaVersionT *version, bool *allocated)
+{
+	char *base = (char *)gc_node->open.info.open.o_addr + sizeof(CPSV_CKPT_HDR);
+	SaSizeT max_sec_size = gc_node->ckpt_creat_attri.maxSectionSize;
+	SaSizeT slot_size = sizeof(CPSV_SECT_HDR) + max_sec_size;
+	uint32_t retries = 0;
+
+	*allocated = false;
+
+	while (retries++ < CPA_REPLICA_READ_MAX_RETRIES) {
+		CPSV_SECT_HDR *sec_hdr = NULL;
+		uint32_t generation = 0;
+		bool busy = false;
+		SaSizeT sec_size, read_size;
+		uint32_t hash = cpa_proc_sec_slot_hash(gc_node, &iov->sectionId);
+		uint32_t slot = gc_node->sec_slots[hash];
+
+		/* A slot from the index is checked like any other, the section
+		   may have been deleted or created again elsewhere */
+		if (slot != 0 && slot <= gc_node->ckpt_creat_attri.maxSections &&
+		    cpa_proc_sec_hdr_match((CPSV_SECT_HDR *)(base + (slot - 1) * slot_size), &iov->sectionId,
+					   &generation, &busy)) {
+			sec_hdr = (CPSV_SECT_HDR *)(base + (slot - 1) * slot_size);
 		} else {
-			if ((*ioVector)[iter].dataBuffer == NULL) {
-				(*ioVector)[iter].dataBuffer = m_MMGR_ALLOC_CPA_DEFAULT(read_map[iter].read_size);
-				if ((*ioVector)[iter].dataBuffer == NULL) {
-					TRACE_4("cpa data buff alloc failed in proc replica read");
-					TRACE_LEAVE();
-					return NCSCC_RC_FAILURE;
+			for (slot = 0; slot < gc_node->ckpt_creat_attri.maxSections; slot++) {
+				CPSV_SECT_HDR *hdr = (CPSV_SECT_HDR *)(base + slot * slot_size);
+
+				if (cpa_proc_sec_hdr_match(hdr, &iov->sectionId, &generation, &busy)) {
+					sec_hdr = hdr;
+					gc_node->sec_slots[hash] = slot + 1;
+					break;
 				}
-				memset((*ioVector)[iter].dataBuffer, '\0', read_map[iter].read_size);
 			}
-			shm_info.type = NCS_OS_POSIX_SHM_REQ_READ;
-			shm_info.info.read.i_addr =
-			    (void *)((char *)gc_node->open.info.open.o_addr + sizeof(CPSV_CKPT_HDR) +
-				     ((read_map[iter].offset_index + 1) * sizeof(CPSV_SECT_HDR)) +
-				     (read_map[iter].offset_index * gc_node->ckpt_creat_attri.maxSectionSize));
-			shm_info.info.read.i_to_buff = (*ioVector)[iter].dataBuffer;
-			shm_info.info.read.i_read_size = read_map[iter].read_size;
-			shm_info.info.read.i_offset = (*ioVector)[iter].dataOffset;
-
-			ncs_os_posix_shm(&shm_info);
 		}
 
+		if (sec_hdr == NULL) {
+			/* The section may be the one CPND is updating */
+			if (busy)
+				continue;
+			return SA_AIS_ERR_NOT_EXIST;
+		}
+
+		sec_size = sec_hdr->sec_size;
+		if (sec_size > max_sec_size)
+			sec_size = max_sec_size;
+
+		if (iov->dataOffset > sec_size) {
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&sec_hdr->generation, __ATOMIC_RELAXED) != generation)
+				continue;
+			return SA_AIS_ERR_INVALID_PARAM;
+		}
+
+		/* Same read size as cpnd_ckpt_read_replica, a NULL buffer reads
+		   the rest of the section */
+		if (iov->dataBuffer == NULL || iov->dataSize == 0 ||
+		    (iov->dataOffset + iov->dataSize) >= sec_size)
+			read_size = sec_size - iov->dataOffset;
+		else
+			read_size = iov->dataSize;
+
+		if (read_size != 0 && iov->dataBuffer == NULL) {
+			if (m_CPA_VER_IS_ABOVE_B_1_1(version))
+				iov->dataBuffer = m_MMGR_ALLOC_CPA_DEFAULT(read_size);
+			else
+				iov->dataBuffer = malloc(read_size);
+			if (iov->dataBuffer == NULL) {
+				TRACE_4("cpa data buff allocation failed");
+				return SA_AIS_ERR_NO_MEMORY;
+			}
+			*allocated = true;
+		}
+
+		memcpy(iov->dataBuffer, (char *)sec_hdr + sizeof(CPSV_SECT_HDR) + iov->dataOffset, read_size);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&sec_hdr->generation, __ATOMIC_RELAXED) == generation) {
+			iov->readSize = read_size;
+			return SA_AIS_OK;
+		}
+
+		/* CPND changed the section while it was read, start over */
+		if (*allocated) {
+			if (m_CPA_VER_IS_ABOVE_B_1_1(version))
+				m_MMGR_FREE_CPA_DEFAULT(iov->dataBuffer);
+			else
+				free(iov->dataBuffer);
+			iov->dataBuffer = NULL;
+			*allocated = false;
+		}
 	}
-	TRACE_LEAVE();
-	return rc;
 
+	return SA_AIS_ERR_TRY_AGAIN;
+}
+
+/****************************************************************************
+  Name          : cpa_proc_replica_read
+  Description   : reads the local replica directly from shared memory
+  Arguments     : gc_node    ---   Global checkpoint node, replica mapped
+                  numberOfElements --- Number of Elements
+                  ioVector   ---   ioVector of Data
+                  erroneousVectorIndex ---   Vector Index
+                  version    ---   Client version
+                  error      ---   Result of the read
+  Return Values : NCSCC_RC_SUCCESS if the read was done, with its result in
+                  error. NCSCC_RC_FAILURE if the mapped replica is no longer
+                  the replica of this checkpoint, or a section stayed busy
+                  while CPND updated it, read through CPND instead.
+  Notes         : Errors are reported as cpnd_ckpt_read_replica does: an
+                  offset outside a section is reported at once, a missing
+                  section after all elements have been read.
+******************************************************************************/
+uint32_t cpa_proc_replica_read(CPA_GLOBAL_CKPT_NODE *gc_node, SaUint32T numberOfElements,
+			       SaCkptIOVectorElementT *ioVector, SaUint32T *erroneousVectorIndex,
+			       SaVersionT *version, SaAisErrorT *error)
+{
+	CPSV_CKPT_HDR *ckpt_hdr = gc_node->open.info.open.o_addr;
+	bool *allocated;
+	uint32_t iter, not_exist_index = 0;
+	bool not_exist = false;
+
+	TRACE_ENTER();
+	*error = SA_AIS_OK;
+
+	/* Section headers only keep MAX_SIZE bytes of the section id */
+	for (iter = 0; iter < numberOfElements; iter++) {
+		if (ioVector[iter].sectionId.idLen > MAX_SIZE) {
+			TRACE_LEAVE();
+			return NCSCC_RC_FAILURE;
+		}
+	}
+
+	allocated = m_MMGR_ALLOC_CPA_DEFAULT(sizeof(bool) * numberOfElements);
+	if (allocated == NULL) {
+		TRACE_LEAVE();
+		return NCSCC_RC_FAILURE;
+	}
+	memset(allocated, 0, sizeof(bool) * numberOfElements);
+
+	for (iter = 0; iter < numberOfElements; iter++) {
+		SaAisErrorT rc = cpa_proc_replica_sec_read(gc_node, &ioVector[iter], version, &allocated[iter]);
+
+		if (rc == SA_AIS_ERR_NOT_EXIST) {
+			if (!not_exist)
+				not_exist_index = iter;
+			not_exist = true;
+		} else if (rc == SA_AIS_ERR_TRY_AGAIN) {
+			/* Not an error of the read, CPND serializes it with the update */
+			*error = rc;
+			break;
+		} else if (rc != SA_AIS_OK) {
+			*error = rc;
+			if (erroneousVectorIndex != NULL)
+				*erroneousVectorIndex = iter;
+			break;
+		}
+	}
+
+	if (*error == SA_AIS_OK && not_exist) {
+		*error = SA_AIS_ERR_NOT_EXIST;
+		if (erroneousVectorIndex != NULL)
+			*erroneousVectorIndex = not_exist_index;
+	}
+
+	/* CPND clears the checkpoint id before it removes the replica */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&ckpt_hdr->ckpt_id, __ATOMIC_RELAXED) != gc_node->gbl_ckpt_hdl)
+		*error = SA_AIS_ERR_LIBRARY;
+
+	if (*error != SA_AIS_OK) {
+		for (iter = 0; iter < numberOfElements; iter++) {
+			if (!allocated[iter])
+				continue;
+			if (m_CPA_VER_IS_ABOVE_B_1_1(version))
+				m_MMGR_FREE_CPA_DEFAULT(ioVector[iter].dataBuffer);
+			else
+				free(ioVector[iter].dataBuffer);
+			ioVector[iter].dataBuffer = NULL;
+		}
+	}
+	m_MMGR_FREE_CPA_DEFAULT(allocated);
+
+	if (*error == SA_AIS_ERR_LIBRARY) {
+		TRACE_4("cpa local replica of ckpt_id:%llx is gone", gc_node->gbl_ckpt_hdl);
+		cpa_proc_shm_close(gc_node);
+		TRACE_LEAVE();
+		return NCSCC_RC_FAILURE;
+	}
+
+	if (*error == SA_AIS_ERR_TRY_AGAIN) {
+		TRACE_4("cpa local replica of ckpt_id:%llx is busy", gc_node->gbl_ckpt_hdl);
+		*error = SA_AIS_OK;
+		TRACE_LEAVE();
+		return NCSCC_RC_FAILURE;
+	}
+
+	TRACE_LEAVE2("rc:%u", *error);
+	return NCSCC_RC_SUCCESS;
 }
 
 /****************************************************************************
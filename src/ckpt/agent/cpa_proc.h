@@ -47,9 +47,8 @@ uint32_t cpa_open_attr_validate(const SaCkptCheckpointCreationAttributesT
 uint32_t cpa_callback_ipc_init(CPA_CLIENT_NODE *client_info);
 void cpa_callback_ipc_destroy(CPA_CLIENT_NODE *client_info);
 uint32_t cpa_ckpt_finalize_proc(CPA_CB *cb, CPA_CLIENT_NODE *cl_node);
-uint32_t cpa_proc_shm_open(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node,
-				 const SaNameT *ckpt_name, SaSizeT ckpt_size);
-uint32_t cpa_proc_shm_close(CPA_GLOBAL_CKPT_NODE *gc_node);
+uint32_t cpa_proc_shm_open(CPA_CB *cb, CPA_GLOBAL_CKPT_NODE *gc_node, SaConstStringT ckpt_name);
+void cpa_proc_shm_close(CPA_GLOBAL_CKPT_NODE *gc_node);
 
 uint32_t cpa_proc_build_data_access_evt(const SaCkptIOVectorElementT *ioVector,
 					      uint32_t numberOfElements, uint32_t data_access_type,
@@ -62,10 +61,9 @@ void cpa_proc_free_arrival_ntfy_cpsv_ckpt_data(CPSV_CKPT_DATA *ckpt_data);
 uint32_t cpa_proc_check_iovector(CPA_CB *cb, CPA_LOCAL_CKPT_NODE *lc_node,
 				       const SaCkptIOVectorElementT *iovector, uint32_t num_of_elmts, uint32_t *errflag);
 
-uint32_t cpa_proc_replica_read(CPA_CB *cb, SaUint32T numberOfElements,
-				     SaCkptCheckpointHandleT gbl_ckpt_hdl,
-				     SaCkptIOVectorElementT **ioVector, CPSV_ND2A_READ_MAP *read_map,
-				     SaUint32T **erroneousVectorIndex);
+uint32_t cpa_proc_replica_read(CPA_GLOBAL_CKPT_NODE *gc_node, SaUint32T numberOfElements,
+			       SaCkptIOVectorElementT *ioVector, SaUint32T *erroneousVectorIndex,
+			       SaVersionT *version, SaAisErrorT *error);
 
 uint32_t cpa_proc_rmt_replica_read(SaUint32T numberOfElements,
 					 SaCkptIOVectorElementT *ioVector, CPSV_ND2A_READ_DATA *read_data,
@@ -0,0 +1,214 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include "gtest/gtest.h"
+extern "C" {
+#include "ckpt/agent/cpa.h"
+}
+
+namespace {
+
+const SaCkptCheckpointHandleT kCkptId = 0x1234;
+const SaUint32T kMaxSections = 4;
+const SaSizeT kMaxSectionSize = 64;
+const SaUint32T kNoIndex = 0xffffffff;
+
+SaCkptSectionIdT SectionId(const char *id) {
+  SaCkptSectionIdT section_id;
+  section_id.idLen = strlen(id);
+  section_id.id = reinterpret_cast<SaUint8T *>(const_cast<char *>(id));
+  return section_id;
+}
+
+SaCkptIOVectorElementT Element(const char *id, void *buffer, SaSizeT size,
+                               SaOffsetT offset) {
+  SaCkptIOVectorElementT element;
+  memset(&element, 0, sizeof(element));
+  element.sectionId = SectionId(id);
+  element.dataBuffer = buffer;
+  element.dataSize = size;
+  element.dataOffset = offset;
+  return element;
+}
+
+}  // namespace
+
+// The fixture for reading a replica laid out the way CPND writes it,
+// mapped as cpa_proc_shm_open() maps it
+class CpaProcReplicaReadTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    memset(&gc_node_, 0, sizeof(gc_node_));
+    gc_node_.gbl_ckpt_hdl = kCkptId;
+    gc_node_.ckpt_creat_attri.maxSections = kMaxSections;
+    gc_node_.ckpt_creat_attri.maxSectionSize = kMaxSectionSize;
+
+    NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open = &gc_node_.open.info.open;
+    open->i_size = sizeof(CPSV_CKPT_HDR) +
+                   kMaxSections * (sizeof(CPSV_SECT_HDR) + kMaxSectionSize);
+    open->o_fd = memfd_create("cpa_proc_test", 0);
+    ASSERT_LE(0, open->o_fd);
+    ASSERT_EQ(0, ftruncate(open->o_fd, open->i_size));
+    replica_ = static_cast<char *>(mmap(nullptr, open->i_size,
+                                        PROT_READ | PROT_WRITE, MAP_SHARED,
+                                        open->o_fd, 0));
+    ASSERT_NE(MAP_FAILED, replica_);
+    open->o_addr = replica_;
+    Header()->ckpt_id = kCkptId;
+
+    gc_node_.n_sec_slots = kMaxSections;
+    gc_node_.sec_slots = static_cast<uint32_t *>(
+        m_MMGR_ALLOC_CPA_DEFAULT(kMaxSections * sizeof(uint32_t)));
+    memset(gc_node_.sec_slots, 0, kMaxSections * sizeof(uint32_t));
+
+    version_.releaseCode = 'B';
+    version_.majorVersion = 2;
+    version_.minorVersion = 3;
+  }
+
+  virtual void TearDown() { cpa_proc_shm_close(&gc_node_); }
+
+  CPSV_CKPT_HDR *Header() {
+    return reinterpret_cast<CPSV_CKPT_HDR *>(replica_);
+  }
+
+  CPSV_SECT_HDR *Slot(uint32_t slot) {
+    return reinterpret_cast<CPSV_SECT_HDR *>(
+        replica_ + sizeof(CPSV_CKPT_HDR) +
+        slot * (sizeof(CPSV_SECT_HDR) + kMaxSectionSize));
+  }
+
+  // Writes a section in "slot" as CPND does, with an even generation
+  void WriteSection(uint32_t slot, const char *id, const std::string &data) {
+    CPSV_SECT_HDR *hdr = Slot(slot);
+    hdr->idLen = strlen(id);
+    memcpy(hdr->id, id, hdr->idLen);
+    hdr->sec_size = data.size();
+    hdr->generation += 2;
+    hdr->in_use = true;
+    memcpy(reinterpret_cast<char *>(hdr) + sizeof(CPSV_SECT_HDR), data.data(),
+           data.size());
+  }
+
+  uint32_t Read(SaCkptIOVectorElementT *elements, SaUint32T n) {
+    return cpa_proc_replica_read(&gc_node_, n, elements, &error_index_,
+                                 &version_, &error_);
+  }
+
+  CPA_GLOBAL_CKPT_NODE gc_node_;
+  char *replica_ = nullptr;
+  SaVersionT version_;
+  SaAisErrorT error_ = SA_AIS_ERR_BAD_OPERATION;
+  SaUint32T error_index_ = kNoIndex;
+};
+
+TEST_F(CpaProcReplicaReadTest, ReadsSectionsFromReplica) {
+  WriteSection(2, "first", "hello world");
+  WriteSection(0, "second", "0123456789");
+
+  char buffer[8];
+  SaCkptIOVectorElementT elements[] = {
+      Element("first", buffer, sizeof(buffer), 6),
+      Element("second", nullptr, 0, 4)};
+  ASSERT_EQ(NCSCC_RC_SUCCESS, Read(elements, 2));
+  EXPECT_EQ(SA_AIS_OK, error_);
+  EXPECT_EQ(kNoIndex, error_index_);
+  EXPECT_EQ(5U, elements[0].readSize);
+  EXPECT_EQ("world", std::string(buffer, elements[0].readSize));
+  // A NULL buffer is allocated and holds the rest of the section
+  ASSERT_NE(nullptr, elements[1].dataBuffer);
+  EXPECT_EQ(6U, elements[1].readSize);
+  EXPECT_EQ("456789",
+            std::string(static_cast<char *>(elements[1].dataBuffer), 6));
+  m_MMGR_FREE_CPA_DEFAULT(elements[1].dataBuffer);
+
+  // Sections are found again through the slot index
+  WriteSection(2, "first", "HELLO WORLD");
+  ASSERT_EQ(NCSCC_RC_SUCCESS, Read(elements, 1));
+  EXPECT_EQ("WORLD", std::string(buffer, elements[0].readSize));
+  EXPECT_NE(nullptr, gc_node_.open.info.open.o_addr);
+}
+
+TEST_F(CpaProcReplicaReadTest, ReportsErrorsAsCpnd) {
+  WriteSection(1, "first", "abc");
+
+  // A missing section is reported after all elements have been read
+  char buffer[4];
+  SaCkptIOVectorElementT elements[] = {Element("missing", buffer, 4, 0),
+                                       Element("first", nullptr, 0, 0)};
+  ASSERT_EQ(NCSCC_RC_SUCCESS, Read(elements, 2));
+  EXPECT_EQ(SA_AIS_ERR_NOT_EXIST, error_);
+  EXPECT_EQ(0U, error_index_);
+  EXPECT_EQ(nullptr, elements[1].dataBuffer);
+
+  // An offset outside the section
+  elements[0] = Element("first", buffer, 4, 4);
+  ASSERT_EQ(NCSCC_RC_SUCCESS, Read(elements, 1));
+  EXPECT_EQ(SA_AIS_ERR_INVALID_PARAM, error_);
+  EXPECT_EQ(0U, error_index_);
+}
+
+TEST_F(CpaProcReplicaReadTest, BusySectionFallsBackToCpnd) {
+  WriteSection(0, "first", "abc");
+  WriteSection(1, "second", "def");
+  // CPND is updating the second section
+  Slot(1)->generation++;
+
+  SaCkptIOVectorElementT elements[] = {Element("first", nullptr, 0, 0),
+                                       Element("second", nullptr, 0, 0)};
+  EXPECT_EQ(NCSCC_RC_FAILURE, Read(elements, 2));
+  // Nothing is reported or left allocated, the read is done again by CPND
+  EXPECT_EQ(SA_AIS_OK, error_);
+  EXPECT_EQ(kNoIndex, error_index_);
+  EXPECT_EQ(nullptr, elements[0].dataBuffer);
+  EXPECT_EQ(nullptr, elements[1].dataBuffer);
+  // The replica stays mapped for the next read
+  EXPECT_NE(nullptr, gc_node_.open.info.open.o_addr);
+
+  Slot(1)->generation++;
+  ASSERT_EQ(NCSCC_RC_SUCCESS, Read(elements, 2));
+  EXPECT_EQ(SA_AIS_OK, error_);
+  EXPECT_EQ("def", std::string(static_cast<char *>(elements[1].dataBuffer),
+                               elements[1].readSize));
+  m_MMGR_FREE_CPA_DEFAULT(elements[0].dataBuffer);
+  m_MMGR_FREE_CPA_DEFAULT(elements[1].dataBuffer);
+}
+
+TEST_F(CpaProcReplicaReadTest, RemovedReplicaFallsBackToCpnd) {
+  WriteSection(0, "first", "abc");
+  // CPND clears the checkpoint id before it removes the replica
+  Header()->ckpt_id = 0;
+
+  SaCkptIOVectorElementT element = Element("first", nullptr, 0, 0);
+  EXPECT_EQ(NCSCC_RC_FAILURE, Read(&element, 1));
+  EXPECT_EQ(nullptr, element.dataBuffer);
+  // The replica is unmapped
+  EXPECT_EQ(nullptr, gc_node_.open.info.open.o_addr);
+  EXPECT_EQ(nullptr, gc_node_.sec_slots);
+}
+
+TEST_F(CpaProcReplicaReadTest, LongSectionIdFallsBackToCpnd) {
+  std::string id(MAX_SIZE + 1, 'x');
+  SaCkptIOVectorElementT element = Element(id.c_str(), nullptr, 0, 0);
+  EXPECT_EQ(NCSCC_RC_FAILURE, Read(&element, 1));
+  EXPECT_EQ(nullptr, element.dataBuffer);
+  EXPECT_NE(nullptr, gc_node_.open.info.open.o_addr);
+}
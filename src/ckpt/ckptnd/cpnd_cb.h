@@ -34,8 +34,8 @@ extern uint32_t gl_cpnd_cb_hdl;
 #define m_CPND_GIVEUP_CPND_CB    ncshm_give_hdl(gl_cpnd_cb_hdl)
 
 #define CPND_MAX_REPLICAS 1000
-#define CPND_MAX_REPLICA_NAME_LENGTH 255
-#define CPND_REP_NAME_MAX_CKPT_NAME_LENGTH (CPND_MAX_REPLICA_NAME_LENGTH - 32)
+#define CPND_MAX_REPLICA_NAME_LENGTH CPSV_REPLICA_NAME_MAX_LENGTH
+#define CPND_REP_NAME_MAX_CKPT_NAME_LENGTH CPSV_REPLICA_NAME_MAX_CKPT_NAME_LENGTH
 
 #define CPSV_GEN_SECTION_ID_SIZE 4
 #define CPSV_WAIT_TIME  1000
@@ -342,7 +342,8 @@ uint32_t cpnd_amf_deregister(CPND_CB *cpnd_cb);
 uint32_t cpnd_client_extract_bits(uint32_t bitmap_value, uint32_t *bit_position);
 uint32_t cpnd_res_ckpt_sec_del(CPND_CKPT_NODE *cp_node);
 uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char *buf, CPND_CKPT_NODE **cp_node,
-					    uint32_t ref_cnt, CKPT_INFO *cp_info, bool shm_alloc_guaranteed);
+					    uint32_t ref_cnt, CKPT_INFO *cp_info, bool shm_alloc_guaranteed,
+					    uint16_t shm_version);
 int32_t cpnd_find_free_loc(CPND_CB *cb, CPND_TYPE_INFO type);
 uint32_t cpnd_ckpt_write_header(CPND_CB *cb, uint32_t nckpts);
 uint32_t cpnd_cli_info_write_header(CPND_CB *cb, int32_t n_clients);
@@ -4005,6 +4005,7 @@ static uint32_t cpnd_evt_proc_ckpt_destroy(CPND_CB *cb, CPND_EVT *evt, CPSV_SEND
 	if (cp_node->cpnd_rep_create) {
 		/* Free back pointers from client list and ckpt_list */
 		cpnd_ckpt_delete_all_sect(cp_node);
+		cpnd_ckpt_hdr_invalidate(cp_node);
 
 		/* need to destroy only the shm info,no need to send to director */
 		{
@@ -56,6 +56,10 @@ static void cpnd_dump_ckpt_attri(CPND_CKPT_NODE *cp_node);
 static void cpnd_ckpt_sc_cpnd_mdest_del(CPND_CB *cb);
 static void cpnd_headless_ckpt_node_del(CPND_CB *cb);
 static SaUint32T cpnd_get_imm_attr(char **attribute_names);
+static CPSV_SECT_HDR *cpnd_sec_hdr_addr(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+static void cpnd_sec_update_begin(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+static void cpnd_sec_update_end(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id);
+static uint32_t cpnd_sec_hdr_write(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *cp_node, bool in_use);
 
 /****************************************************************************
  * Name          : cpnd_ckpt_client_add
@@ -346,6 +350,7 @@ uint32_t cpnd_ckpt_replica_destroy(CPND_CB *cb, CPND_CKPT_NODE *cp_node, SaAisEr
 
 		/* First delete all sections in the heckpoint about to be deleted */
 		cpnd_ckpt_delete_all_sect(cp_node);
+		cpnd_ckpt_hdr_invalidate(cp_node);
 
 		memset(&shm_info, '\0', sizeof(shm_info));
 
@@ -675,6 +680,9 @@ uint32_t cpnd_ckpt_sec_write(CPND_CKPT_NODE *cp_node, CPND_CKPT_SECTION_INFO
 
 	write_req.info.write.i_write_size = size;
 
+	/* Data and header are updated under one generation change */
+	cpnd_sec_update_begin(cp_node, sec_info->lcl_sec_id);
+
 	ncs_os_posix_shm(&write_req);
 
 	m_GET_TIME_STAMP(sec_info->lastUpdate);
@@ -687,14 +695,16 @@ uint32_t cpnd_ckpt_sec_write(CPND_CKPT_NODE *cp_node, CPND_CKPT_SECTION_INFO
 		}
 
 		/* SECTION HEADER UPDATE */
-		cpnd_sec_hdr_update(sec_info, cp_node);
+		cpnd_sec_hdr_write(sec_info, cp_node, true);
 
 	} else if ((type == 1) || (type == 3)) {
 		cp_node->replica_info.mem_used -= sec_info->sec_size;
 		sec_info->sec_size = size;
 		cp_node->replica_info.mem_used += size;
-		cpnd_sec_hdr_update(sec_info, cp_node);
+		cpnd_sec_hdr_write(sec_info, cp_node, true);
 	}
+
+	cpnd_sec_update_end(cp_node, sec_info->lcl_sec_id);
 	TRACE_LEAVE();
 	return rc;
 
@@ -1836,17 +1846,83 @@ uint32_t cpnd_ckpt_hdr_update(CPND_CKPT_NODE *cp_node)
 
 }
 
+/***************************************************************************
+ * Name          : cpnd_ckpt_hdr_invalidate
+ *
+ * Description   : To mark the replica as no longer in use, before it is
+ *                 unmapped and unlinked. Agents that have the replica mapped
+ *                 check the checkpoint id before trusting what they read.
+ *
+ * Arguments     : CPND_CKPT_NODE - ckpt node
+ *
+ * Return Values : None
+****************************************************************************/
+
+void cpnd_ckpt_hdr_invalidate(CPND_CKPT_NODE *cp_node)
+{
+	CPSV_CKPT_HDR *ckpt_hdr = cp_node->replica_info.open.info.open.o_addr;
+
+	if (ckpt_hdr != NULL)
+		__atomic_store_n(&ckpt_hdr->ckpt_id, 0, __ATOMIC_RELEASE);
+}
+
 /**********************************************************************************
- * Name          :  cpnd_sec_hdr_update
- 
- * Description   : To update the section header information
-  
- * Arguments    : CPND_CKPT_SECTION_INFO - section info , CPND_CKPT_NODE - ckpt node
- 
+ * Name          : cpnd_sec_hdr_addr
+
+ * Description   : Address of a section header in the replica
+
+ * Arguments     : CPND_CKPT_NODE - ckpt node, lcl_sec_id - local section id
+
+ * Return Values : Pointer to the section header
+***********************************************************************************/
+
+static CPSV_SECT_HDR *cpnd_sec_hdr_addr(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	return (CPSV_SECT_HDR *)((char *)cp_node->replica_info.open.info.open.o_addr + sizeof(CPSV_CKPT_HDR) +
+				 lcl_sec_id * (sizeof(CPSV_SECT_HDR) + cp_node->create_attrib.maxSectionSize));
+}
+
+/**********************************************************************************
+ * Name          : cpnd_sec_update_begin / cpnd_sec_update_end
+
+ * Description   : Make the section generation odd while the section header or
+                   data is modified, and even again when done. Agents reading
+                   the replica directly retry if the generation is odd or has
+                   changed during their read.
+
+ * Arguments     : CPND_CKPT_NODE - ckpt node, lcl_sec_id - local section id
+
+ * Return Values : None
+***********************************************************************************/
+
+static void cpnd_sec_update_begin(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	CPSV_SECT_HDR *sec_hdr = cpnd_sec_hdr_addr(cp_node, lcl_sec_id);
+
+	__atomic_store_n(&sec_hdr->generation, sec_hdr->generation + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void cpnd_sec_update_end(CPND_CKPT_NODE *cp_node, uint32_t lcl_sec_id)
+{
+	CPSV_SECT_HDR *sec_hdr = cpnd_sec_hdr_addr(cp_node, lcl_sec_id);
+
+	__atomic_store_n(&sec_hdr->generation, sec_hdr->generation + 1, __ATOMIC_RELEASE);
+}
+
+/**********************************************************************************
+ * Name          : cpnd_sec_hdr_write
+
+ * Description   : Write the section header, keeping its generation. Callers
+                   hold the section between cpnd_sec_update_begin/end.
+
+ * Arguments     : CPND_CKPT_SECTION_INFO - section info , CPND_CKPT_NODE - ckpt node
+                   in_use - false when the section has been deleted
+
  * Return Values : Success / Error
 ***********************************************************************************/
 
-uint32_t cpnd_sec_hdr_update(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *cp_node)
+static uint32_t cpnd_sec_hdr_write(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *cp_node, bool in_use)
 {
 	CPSV_SECT_HDR sec_hdr;
 	uint32_t rc = NCSCC_RC_SUCCESS;
@@ -1860,11 +1936,14 @@ uint32_t cpnd_sec_hdr_update(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *c
 	sec_hdr.sec_size = sec_info->sec_size;
 	sec_hdr.exp_tmr = sec_info->exp_tmr;
 	sec_hdr.lastUpdate = sec_info->lastUpdate;
+	sec_hdr.in_use = in_use;
 
 	if ((sec_info->lcl_sec_id * (sizeof(CPSV_SECT_HDR) + cp_node->create_attrib.maxSectionSize)) > UINTMAX_MAX) {
 		LOG_ER("cpnd Section hdr update failed exceeded the update limits(UINT64_MAX)");
 		return NCSCC_RC_FAILURE;
 	}
+	sec_hdr.generation = cpnd_sec_hdr_addr(cp_node, sec_info->lcl_sec_id)->generation;
+
 	write_req.type = NCS_OS_POSIX_SHM_REQ_WRITE;
 	write_req.info.write.i_addr =
 	    (void *)((char *)cp_node->replica_info.open.info.open.o_addr + sizeof(CPSV_CKPT_HDR));
@@ -1877,6 +1956,48 @@ uint32_t cpnd_sec_hdr_update(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *c
 	return rc;
 }
 
+/**********************************************************************************
+ * Name          :  cpnd_sec_hdr_update
+ 
+ * Description   : To update the section header information
+  
+ * Arguments    : CPND_CKPT_SECTION_INFO - section info , CPND_CKPT_NODE - ckpt node
+ 
+ * Return Values : Success / Error
+***********************************************************************************/
+
+uint32_t cpnd_sec_hdr_update(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *cp_node)
+{
+	uint32_t rc;
+
+	cpnd_sec_update_begin(cp_node, sec_info->lcl_sec_id);
+	rc = cpnd_sec_hdr_write(sec_info, cp_node, true);
+	cpnd_sec_update_end(cp_node, sec_info->lcl_sec_id);
+
+	return rc;
+}
+
+/**********************************************************************************
+ * Name          :  cpnd_sec_hdr_release
+ 
+ * Description   : To update the section header of a deleted section
+  
+ * Arguments    : CPND_CKPT_SECTION_INFO - section info , CPND_CKPT_NODE - ckpt node
+ 
+ * Return Values : Success / Error
+***********************************************************************************/
+
+uint32_t cpnd_sec_hdr_release(CPND_CKPT_SECTION_INFO *sec_info, CPND_CKPT_NODE *cp_node)
+{
+	uint32_t rc;
+
+	cpnd_sec_update_begin(cp_node, sec_info->lcl_sec_id);
+	rc = cpnd_sec_hdr_write(sec_info, cp_node, false);
+	cpnd_sec_update_end(cp_node, sec_info->lcl_sec_id);
+
+	return rc;
+}
+
 /****************************************************************************
  * Name          : cpnd_cb_dump
  *
@@ -2622,6 +2743,7 @@ void cpnd_ckpt_replica_delete(CPND_CB *cb, CPND_CKPT_NODE *ckpt_node)
 
 		/* First delete all sections in the heckpoint about to be deleted */
 		cpnd_ckpt_delete_all_sect(ckpt_node);
+		cpnd_ckpt_hdr_invalidate(ckpt_node);
 
 		memset(&shm_info, '\0', sizeof(shm_info));
 
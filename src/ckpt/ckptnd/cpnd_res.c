@@ -22,6 +22,8 @@
 
 ******************************************************************************/
 
+#include <limits.h>
+#include <sys/stat.h>
 #include "ckpt/ckptnd/cpnd.h"
 
 #define m_CPND_CKPT_HDR_UPDATE(ckpt_hdr,addr,offset)  memcpy(&ckpt_hdr,addr+offset,sizeof(CPSV_CKPT_HDR))
@@ -50,6 +52,8 @@ static bool cpnd_find_exact_ckptinfo(CPND_CB *cb, CKPT_INFO *ckpt_info, uint32_t
 static void cpnd_clear_ckpt_info(CPND_CB *cb, CPND_CKPT_NODE *cp_node, uint32_t curr_offset, uint32_t prev_offset);
 static void cpnd_destroy_shm(NCS_OS_POSIX_SHM_REQ_OPEN_INFO *open_req);
 static uint32_t cpnd_shm_extended_open(CPND_CB *cb, uint32_t flag);
+static bool cpnd_replica_is_v1_layout(const char *buf, CKPT_INFO *cp_info);
+static void cpnd_replica_sect_hdr_migrate(void *addr, CKPT_INFO *cp_info, SaUint32T n_secs);
 static uint32_t cpnd_extended_name_lend(SaConstStringT value, SaNameT* name);
 static SaConstStringT cpnd_extended_name_borrow(const SaNameT* name);
 static void cpnd_extended_name_free(const SaNameT* name);
@@ -137,6 +141,9 @@ uint32_t cpnd_res_ckpt_sec_del(CPND_CKPT_NODE *cp_node)
  *                  uint8_t* buf  - Name of the shared memory
  *                  CPND_CKPT_NODE *cp_node - CPND_CKPT_NODE pointer
  *                  ref_cnt
+ *                  shm_version - version of the CPND shared memory found at restart,
+ *                                replicas of a version before CPSV_CPND_SHM_VERSION_SECT_GEN
+ *                                get the larger section headers
  *
  * Return Values  :
  * Notes          : None
@@ -150,7 +157,8 @@ uint32_t cpnd_res_ckpt_sec_del(CPND_CKPT_NODE *cp_node)
 */
 
 uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char *buf, CPND_CKPT_NODE **cp_node,
-				   uint32_t ref_cnt, CKPT_INFO *cp_info, bool shm_alloc_guaranteed)
+				   uint32_t ref_cnt, CKPT_INFO *cp_info, bool shm_alloc_guaranteed,
+				   uint16_t shm_version)
 {
 /*   NCS_OS_POSIX_SHM_REQ_INFO read_req,shm_read; */
 	CPSV_CKPT_HDR ckpt_hdr;
@@ -158,9 +166,16 @@ uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char
 	uint32_t counter = 0, sec_cnt = 0, rc = NCSCC_RC_SUCCESS;
 	CPND_CKPT_SECTION_INFO *pSecPtr = NULL;
 	NCS_OS_POSIX_SHM_REQ_INFO read_req;
+	bool migrate = false;
 
 	TRACE_ENTER();
 
+	/* The replica still has the section headers of the previous version if
+	   it has the size of that layout, opening it below grows it */
+	if ((shm_version == CPSV_CPND_SHM_VERSION || shm_version == CPSV_CPND_SHM_VERSION_EXTENDED) &&
+	    cp_info->maxSections != 0)
+		migrate = cpnd_replica_is_v1_layout(buf, cp_info);
+
 	memset(&ckpt_hdr, '\0', sizeof(CPSV_CKPT_HDR));
 	open_req->type = NCS_OS_POSIX_SHM_REQ_OPEN;
 	open_req->info.open.i_size =
@@ -182,6 +197,8 @@ uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char
 	}
 
 	m_CPND_CKPT_HDR_UPDATE(ckpt_hdr, (char *)open_req->info.open.o_addr, 0);
+	if (migrate)
+		cpnd_replica_sect_hdr_migrate(open_req->info.open.o_addr, cp_info, ckpt_hdr.n_secs);
 	(*cp_node)->create_attrib = ckpt_hdr.create_attrib;
 	(*cp_node)->open_flags = ckpt_hdr.open_flags;
 	(*cp_node)->is_active_exist = ckpt_hdr.is_active_exist;
@@ -194,6 +211,17 @@ uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char
 	if ((*cp_node)->create_attrib.maxSections == 0)
 		return rc;
 
+	/* Close any section update left open by a CPND that went down in the
+	   middle of it, agents reading the replica directly would otherwise
+	   wait for it */
+	for (; sec_cnt < (*cp_node)->create_attrib.maxSections; sec_cnt++) {
+		CPSV_SECT_HDR *sec_hdr = (CPSV_SECT_HDR *)((char *)open_req->info.open.o_addr + sizeof(CPSV_CKPT_HDR) +
+			sec_cnt * (sizeof(CPSV_SECT_HDR) + (*cp_node)->create_attrib.maxSectionSize));
+		if (sec_hdr->generation & 1)
+			__atomic_store_n(&sec_hdr->generation, sec_hdr->generation + 1, __ATOMIC_RELEASE);
+	}
+	sec_cnt = 0;
+
 	(*cp_node)->replica_info.shm_sec_mapping =
 	    (uint32_t *)m_MMGR_ALLOC_CPND_DEFAULT(sizeof(uint32_t) * ((*cp_node)->create_attrib.maxSections));
 
@@ -287,6 +315,71 @@ uint32_t cpnd_ckpt_replica_create_res(NCS_OS_POSIX_SHM_REQ_INFO *open_req, char
 	return rc;
 }
 
+/*********************************************************************************************
+ * Name           :  cpnd_replica_is_v1_layout
+ *
+ * Description    : To check if a replica still has the size it had with the section
+ *                  headers before CPSV_CPND_SHM_VERSION_SECT_GEN
+ *
+ * Arguments      : buf - Name of the replica shared memory, cp_info - ckpt info
+ *
+ * Return Values  : true if the replica has to be migrated
+ *
+ **********************************************************************************************/
+static bool cpnd_replica_is_v1_layout(const char *buf, CKPT_INFO *cp_info)
+{
+	char shm_name[PATH_MAX];
+	struct stat st;
+	int fd;
+	bool v1 = false;
+
+	snprintf(shm_name, sizeof(shm_name), "/opensaf_%s", buf);
+	fd = shm_open(shm_name, O_RDONLY, 0);
+	if (fd < 0)
+		return false;
+	if (fstat(fd, &st) == 0)
+		v1 = ((uint64_t)st.st_size ==
+		      sizeof(CPSV_CKPT_HDR) + cp_info->maxSections * (CPSV_SECT_HDR_V1_SIZE + cp_info->maxSecSize));
+	close(fd);
+	return v1;
+}
+
+/*********************************************************************************************
+ * Name           :  cpnd_replica_sect_hdr_migrate
+ *
+ * Description    : To move the sections of a replica apart for the larger section headers
+ *                  of CPSV_CPND_SHM_VERSION_SECT_GEN. The replica is already mapped with
+ *                  its new size.
+ *
+ * Arguments      : addr - Replica address, cp_info - ckpt info,
+ *                  n_secs - Number of sections, kept in the first slots
+ *
+ * Return Values  : -
+ *
+ **********************************************************************************************/
+static void cpnd_replica_sect_hdr_migrate(void *addr, CKPT_INFO *cp_info, SaUint32T n_secs)
+{
+	char *base = (char *)addr + sizeof(CPSV_CKPT_HDR);
+	SaSizeT old_slot = CPSV_SECT_HDR_V1_SIZE + cp_info->maxSecSize;
+	SaSizeT new_slot = sizeof(CPSV_SECT_HDR) + cp_info->maxSecSize;
+	uint32_t i;
+
+	TRACE_ENTER2("maxSections %u", cp_info->maxSections);
+
+	/* From the last slot, a slot only moves over slots already moved */
+	for (i = cp_info->maxSections; i-- > 0;) {
+		char *from = base + i * old_slot;
+		CPSV_SECT_HDR *sec_hdr = (CPSV_SECT_HDR *)(base + i * new_slot);
+
+		memmove((char *)sec_hdr + sizeof(CPSV_SECT_HDR), from + CPSV_SECT_HDR_V1_SIZE, cp_info->maxSecSize);
+		memmove(sec_hdr, from, CPSV_SECT_HDR_V1_SIZE);
+		memset((char *)sec_hdr + CPSV_SECT_HDR_V1_SIZE, 0, sizeof(CPSV_SECT_HDR) - CPSV_SECT_HDR_V1_SIZE);
+		sec_hdr->in_use = (i < n_secs);
+	}
+
+	TRACE_LEAVE();
+}
+
 void cpnd_restart_update_timer(CPND_CB *cb, CPND_CKPT_NODE *cp_node, SaTimeT closetime)
 {
 	CKPT_INFO ckpt_info;
@@ -343,7 +436,7 @@ void *cpnd_restart_shm_create(NCS_OS_POSIX_SHM_REQ_INFO *cpnd_open_req, CPND_CB
 	TRACE_ENTER();
 	/* Initializing shared memory version */
 	memset(&cpnd_shm_version, '\0', sizeof(cpnd_shm_version));
-	cpnd_shm_version.shm_version = CPSV_CPND_SHM_VERSION;
+	cpnd_shm_version.shm_version = CPSV_CPND_SHM_VERSION_SECT_GEN;
 
 	size = strlen("CPND_CHECKPOINT_INFO");
 	total_length = size + sizeof(nodeid) + 5;
@@ -415,9 +508,12 @@ void *cpnd_restart_shm_create(NCS_OS_POSIX_SHM_REQ_INFO *cpnd_open_req, CPND_CB
 
 		switch (cpnd_shm_version.shm_version) {
 			case CPSV_CPND_SHM_VERSION:
-				/* Do nothing, continue with next step */
+			case CPSV_CPND_SHM_VERSION_SECT_GEN:
+				/* Do nothing, continue with next step. Replicas of
+				   CPSV_CPND_SHM_VERSION are migrated when read */
 				break;
 			case CPSV_CPND_SHM_VERSION_EXTENDED:
+			case CPSV_CPND_SHM_VERSION_EXTENDED_SECT_GEN:
 				/* Update extended address */
 				rc = cpnd_shm_extended_open(cb, O_RDWR);
 				break;
@@ -529,7 +625,8 @@ void *cpnd_restart_shm_create(NCS_OS_POSIX_SHM_REQ_INFO *cpnd_open_req, CPND_CB
 					memset(buf, '\0', CPND_MAX_REPLICA_NAME_LENGTH);
 					strncpy(buf, cp_node->ckpt_name, CPND_REP_NAME_MAX_CKPT_NAME_LENGTH);
 					sprintf(buf + strlen(buf) - 1, "_%u_%llu", (uint32_t)nodeid, cp_node->ckpt_id);
-					rc = cpnd_ckpt_replica_create_res(&ckpt_rep_open, buf, &cp_node, 0, &cp_info, cb->shm_alloc_guaranteed);
+					rc = cpnd_ckpt_replica_create_res(&ckpt_rep_open, buf, &cp_node, 0, &cp_info,
+									  cb->shm_alloc_guaranteed, cpnd_shm_version.shm_version);
 					if (rc != NCSCC_RC_SUCCESS) {
 						/*   assert(0); */
 						TRACE_4("cpnd ckpt replica create failed with return value %d",rc);
@@ -619,6 +716,14 @@ void *cpnd_restart_shm_create(NCS_OS_POSIX_SHM_REQ_INFO *cpnd_open_req, CPND_CB
 			}	/* End of one cp_node processing */
 			counter++;
 		}		/* End of while  after processing all 2000 ckpt structs */
+
+		/* All replicas have the section headers of this version now */
+		if (cpnd_shm_version.shm_version == CPSV_CPND_SHM_VERSION)
+			((CPND_SHM_VERSION *)cpnd_open_req->info.open.o_addr)->shm_version =
+			    CPSV_CPND_SHM_VERSION_SECT_GEN;
+		else if (cpnd_shm_version.shm_version == CPSV_CPND_SHM_VERSION_EXTENDED)
+			((CPND_SHM_VERSION *)cpnd_open_req->info.open.o_addr)->shm_version =
+			    CPSV_CPND_SHM_VERSION_EXTENDED_SECT_GEN;
 	}			/* End of else  CPND after restart */
 	TRACE_LEAVE();
 	return cpnd_open_req->info.open.o_addr;
@@ -1511,7 +1616,7 @@ uint32_t cpnd_restart_shm_ckpt_update(CPND_CB *cb, CPND_CKPT_NODE *cp_node, SaCk
 			return rc;
 		}
 		/* Update shared memory version */
-		((CPND_SHM_VERSION*)cb->shm_addr.base_addr)->shm_version = CPSV_CPND_SHM_VERSION_EXTENDED;
+		((CPND_SHM_VERSION*)cb->shm_addr.base_addr)->shm_version = CPSV_CPND_SHM_VERSION_EXTENDED_SECT_GEN;
 	}
 
 	/* check if the ckpt already exists */
@@ -211,7 +211,7 @@ cpnd_ckpt_sec_del(CPND_CKPT_NODE *cp_node, SaCkptSectionIdT *id)
     cp_node->replica_info.mem_used = cp_node->replica_info.mem_used - (sectionInfo->sec_size);
 
     // UPDATE THE SECTION HEADER
-    uint32_t rc(cpnd_sec_hdr_update(sectionInfo, cp_node));
+    uint32_t rc(cpnd_sec_hdr_release(sectionInfo, cp_node));
     if (rc == NCSCC_RC_FAILURE) {
       TRACE_4("cpnd sect hdr update failed");
     }
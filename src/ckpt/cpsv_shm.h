@@ -18,6 +18,7 @@
 #ifndef CKPT_CPSV_SHM_H_
 #define CKPT_CPSV_SHM_H_
 
+#include <stddef.h>
 #include "base/osaf_extended_name.h"
 
 #define MAX_CLIENTS 1000
@@ -30,6 +31,14 @@
 #define CPSV_CPND_SHM_VERSION			1
 #define CPSV_CPND_SHM_VERSION_DEPRECATE	2
 #define CPSV_CPND_SHM_VERSION_EXTENDED	3
+/* Replica section headers with generation and in_use, without and with
+   the extended shared memory */
+#define CPSV_CPND_SHM_VERSION_SECT_GEN	4
+#define CPSV_CPND_SHM_VERSION_EXTENDED_SECT_GEN	5
+
+/* Replica shared memory object name, "<ckpt name>_<node id>_<ckpt id>" */
+#define CPSV_REPLICA_NAME_MAX_LENGTH 255
+#define CPSV_REPLICA_NAME_MAX_CKPT_NAME_LENGTH (CPSV_REPLICA_NAME_MAX_LENGTH - 32)
 
 typedef struct cpsv_ckpt_hdr {
 	SaCkptCheckpointHandleT ckpt_id;	/* Index for identifying the checkpoint */
@@ -56,8 +65,15 @@ typedef struct cpsv_sect_hdr {
 	SaSizeT sec_size;
 	SaTimeT exp_tmr;
 	SaTimeT lastUpdate;
+	/* Odd while CPND updates the section header or data. Agents reading
+	   the replica directly retry when it is odd or has changed. */
+	uint32_t generation;
+	bool in_use;
 } CPSV_SECT_HDR;
 
+/* Size of a section header before CPSV_CPND_SHM_VERSION_SECT_GEN */
+#define CPSV_SECT_HDR_V1_SIZE offsetof(CPSV_SECT_HDR, generation)
+
 typedef struct ckpt_info {
 	SaNameT ckpt_name;
 	SaCkptCheckpointHandleT ckpt_id;
@@ -38,9 +38,10 @@
 #include "amf/saf/saAmf.h"
 
 #include "base/ncssysf_tmr.h"
+#include "evt/evtd/eds_filter_index.h"
 
 /* global variables */
-uint32_t gl_eds_hdl;
+extern uint32_t gl_eds_hdl;
 
 struct eda_reg_list_tag;
 
@@ -139,6 +140,7 @@ typedef struct subsc_rec_tag {
 	SaEvtEventFilterArrayT *filters;
 	struct eda_reg_list_tag *reg_list;
 	struct chan_open_rec_tag *par_chan_open_inst;	/* Backpointer to the channel open instance */
+	EDS_FIDX_SUB *fidx;	/* Filters in the channel's filter index */
 	struct subsc_rec_tag *prev;
 	struct subsc_rec_tag *next;
 } SUBSC_REC;
@@ -201,6 +203,7 @@ typedef struct eds_worklist_tag {
 
 	NCS_PATRICIA_TREE chan_open_rec;	/* Channel Open record - mix of all opens *
 						 * on this channel for all reg_ids        */
+	EDS_FILTER_INDEX filter_index;	/* Filters of all subscriptions on this channel */
 	EDS_RETAINED_EVT_REC *ret_evt_list_head[SA_EVT_LOWEST_PRIORITY + 1];	/* priority queues head */
 	EDS_RETAINED_EVT_REC *ret_evt_list_tail[SA_EVT_LOWEST_PRIORITY + 1];	/* priority queues tail */
 	struct eds_worklist_tag *prev;
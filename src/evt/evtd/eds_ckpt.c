@@ -30,6 +30,7 @@ MBCSv.
 
 #include "eds.h"
 #include "base/logtrace.h"
+#include "evt/evtd/eds_ckpt_edu_gen.h"
 
 /*
 EDS_CKPT_DATA_HEADER
@@ -2307,8 +2308,8 @@ uint32_t eds_edp_ed_reg_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 		ckpt_reg_msg_ptr = ptr;
 	}
 
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_reg_rec_ed_rules, ckpt_reg_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_reg_rec_ed_rules, ckpt_reg_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/* End eds_edp_ed_reg_rec */
@@ -2365,8 +2366,8 @@ uint32_t eds_edp_ed_chan_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_chan_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_chan_rec_ed_rules, ckpt_chan_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_chan_rec_ed_rules, ckpt_chan_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/*End eds_edp_ed_chan_rec */
@@ -2423,8 +2424,8 @@ uint32_t eds_edp_ed_chan_open_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_copen_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_copen_rec_ed_rules, ckpt_copen_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_copen_rec_ed_rules, ckpt_copen_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/* End eds_edp_ed_chan_open_rec() */
@@ -2476,8 +2477,8 @@ uint32_t eds_edp_ed_chan_close_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_cclose_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_cclose_rec_ed_rules, ckpt_cclose_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_cclose_rec_ed_rules, ckpt_cclose_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/*End eds_edp_ed_chan_close_rec */
@@ -2528,8 +2529,8 @@ uint32_t eds_edp_ed_chan_ulink_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_culink_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_culink_rec_ed_rules, ckpt_culink_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_culink_rec_ed_rules, ckpt_culink_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/*End eds_edp_ed_chan_ulink_rec */
@@ -2583,8 +2584,8 @@ uint32_t eds_edp_ed_ret_clr_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_ret_clr_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_ret_clr_rec_ed_rules, ckpt_ret_clr_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_ret_clr_rec_ed_rules, ckpt_ret_clr_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/*End eds_edp_ed_ret_clr_rec */
@@ -2635,8 +2636,8 @@ uint32_t eds_edp_ed_csum_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_csum_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_csum_rec_ed_rules, ckpt_csum_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_csum_rec_ed_rules, ckpt_csum_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 
 	return rc;
 }	/*End eds_edp_ed_csum_rec */
@@ -2687,8 +2688,8 @@ uint32_t eds_edp_ed_usubsc_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_usubsc_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_usubsc_rec_ed_rules, ckpt_usubsc_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_usubsc_rec_ed_rules, ckpt_usubsc_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 
 	return rc;
 
@@ -2738,8 +2739,8 @@ uint32_t eds_edp_ed_finalize_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_final_msg_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_final_rec_ed_rules, ckpt_final_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_final_rec_ed_rules, ckpt_final_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/* End eds_edp_ed_finalize_rec() */
@@ -2790,8 +2791,8 @@ uint32_t eds_edp_ed_header_rec(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 	} else {
 		ckpt_header_ptr = ptr;
 	}
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_header_rec_ed_rules, ckpt_header_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_header_rec_ed_rules, ckpt_header_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/* End eds_edp_ed_header_rec() */
@@ -2961,8 +2962,8 @@ uint32_t eds_edp_ed_ckpt_msg(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
 		ckpt_msg_ptr = ptr;
 	}
 
-	rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, eds_ckpt_msg_ed_rules, ckpt_msg_ptr, ptr_data_len,
-				 buf_env, op, o_err);
+	rc = m_NCS_EDU_RUN_GEN_RULES(edu_hdl, edu_tkn, eds_ckpt_msg_ed_rules, ckpt_msg_ptr, ptr_data_len,
+				     buf_env, op, o_err);
 	return rc;
 
 }	/* End eds_edu_enc_dec_ckpt_msg() */
@@ -489,6 +489,8 @@ static uint32_t eds_proc_publish_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
 	EDS_WORKLIST *wp;
 	CHAN_OPEN_REC *co;
 	SUBSC_REC *subrec;
+	SUBSC_REC **found;
+	uint32_t num_found, i;
 	EDSV_MSG msg;
 	time_t time_of_day;
 	EDSV_EDA_PUBLISH_PARAM *publish_param;
@@ -538,45 +540,43 @@ static uint32_t eds_proc_publish_msg(EDS_CB *cb, EDSV_EDS_EVT *evt)
     ** this event now
     **/
 
-	/* Go through all chan_open_rec's under this channel */
-	co = (CHAN_OPEN_REC *)ncs_patricia_tree_getnext(&wp->chan_open_rec, (uint8_t *)0);
-	while (co) {
-		subrec = co->subsc_rec_head;
-		while (subrec) {	/* while subscriptions... */
-			/* Does the patterns/filters match? */
-			if (eds_pattern_match(publish_param->pattern_array, subrec->filters)) {
-
-				/* Fill in the event record to send */
-				m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(msg,
-								     co->reg_id,
-								     subrec->subscript_id,
-								     subrec->chan_id,
-								     subrec->chan_open_id,
-								     publish_param->pattern_array,
-								     publish_param->priority,
-								     publish_param->publisher_name,
-								     publish_time,
-								     publish_param->retention_time,
-								     publish_param->event_id,
-								     retd_evt_chan_open_id,
-								     publish_param->data_len, publish_param->data)
-
-				    /* Determine evt to MDS priority mapping */
-				    prio = edsv_map_ais_prio_to_mds_snd_prio(publish_param->priority);
-
-				/* Send the event. Only once per match/per open_id */
-				if (NCSCC_RC_SUCCESS != (rc = eds_mds_msg_send(cb, &msg, &co->chan_opener_dest,
-									       NULL, prio))) {
-					LOG_ER("Event Publish(MDS send) failed. From publisher dest: %" PRIx64
-						", To subscriber dest: %" PRIx64 ",on Node_id: %u", evt->fr_dest,
-					co->chan_opener_dest,  m_NCS_NODE_ID_FROM_MDS_DEST(co->chan_opener_dest)); 
-				}
+	/* Look up the subscriptions whose patterns/filters match. They come
+	 * in chan_open_rec order, each chan_open_rec's in subscription order.
+	 */
+	num_found = eds_filter_index_match(&wp->filter_index, publish_param->pattern_array, &found);
+	for (i = 0; i < num_found; i++) {
+		subrec = found[i];
+		co = subrec->par_chan_open_inst;
 
-				break;
-			}
-			subrec = subrec->next;
+		/* Send the event only once per match/per open_id */
+		if (i > 0 && found[i - 1]->par_chan_open_inst == co)
+			continue;
+
+		/* Fill in the event record to send */
+		m_EDS_EDSV_DELIVER_EVENT_CB_MSG_FILL(msg,
+						     co->reg_id,
+						     subrec->subscript_id,
+						     subrec->chan_id,
+						     subrec->chan_open_id,
+						     publish_param->pattern_array,
+						     publish_param->priority,
+						     publish_param->publisher_name,
+						     publish_time,
+						     publish_param->retention_time,
+						     publish_param->event_id,
+						     retd_evt_chan_open_id,
+						     publish_param->data_len, publish_param->data)
+
+		    /* Determine evt to MDS priority mapping */
+		    prio = edsv_map_ais_prio_to_mds_snd_prio(publish_param->priority);
+
+		/* Send the event */
+		if (NCSCC_RC_SUCCESS != (rc = eds_mds_msg_send(cb, &msg, &co->chan_opener_dest,
+							       NULL, prio))) {
+			LOG_ER("Event Publish(MDS send) failed. From publisher dest: %" PRIx64
+				", To subscriber dest: %" PRIx64 ",on Node_id: %u", evt->fr_dest,
+			co->chan_opener_dest,  m_NCS_NODE_ID_FROM_MDS_DEST(co->chan_opener_dest)); 
 		}
-		co = (CHAN_OPEN_REC *)ncs_patricia_tree_getnext(&wp->chan_open_rec, (uint8_t *)&co->copen_id_Net);
 	}
 
   /** If this event has been retained, send an async update &
@@ -0,0 +1,622 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+*                                                                            *
+*  MODULE NAME:  eds_filter_index.c                                          *
+*                                                                            *
+*                                                                            *
+*  DESCRIPTION:                                                              *
+*  This module contains the subscription filter index of an event channel.  *
+*  A subscription is found by a publish when each of its filters is hit by  *
+*  the pattern at the same position, which gives the same result as         *
+*  eds_pattern_match() for every subscription of the channel:               *
+*                                                                            *
+*  - A prefix or suffix filter is hit by the trie nodes along the pattern,  *
+*    an exact filter by the hash entry of the pattern.                      *
+*  - Pass all filters and empty prefix/suffix filters match any pattern and *
+*    are not indexed.                                                       *
+*  - Positions after the last pattern are looked up with the empty pattern. *
+*  - A subscription with an unknown filter type never matches.              *
+*                                                                            *
+*****************************************************************************/
+#include "eds.h"
+
+#define EDS_FIDX_MIN_BUCKETS 64
+
+/* Trie node, the path from the root spells the filter */
+typedef struct eds_fidx_node_tag {
+	struct eds_fidx_node_tag *parent;
+	struct eds_fidx_node_tag **children;	/* Sorted on byte */
+	uint16_t num_children;
+	uint16_t max_children;
+	uint8_t byte;
+	EDS_FIDX_ENTRY *entries;
+} EDS_FIDX_NODE;
+
+/* Exact filter */
+typedef struct eds_fidx_key_tag {
+	struct eds_fidx_key_tag *next;
+	uint32_t hash;
+	uint32_t position;
+	SaSizeT size;
+	EDS_FIDX_ENTRY *entries;
+	uint8_t bytes[];
+} EDS_FIDX_KEY;
+
+static uint32_t fidx_hash(uint32_t position, const uint8_t *bytes, SaSizeT size)
+{
+	uint32_t hash = 2166136261u ^ position;
+	SaSizeT i;
+
+	for (i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void fidx_link(EDS_FIDX_ENTRY **head, EDS_FIDX_ENTRY *entry)
+{
+	entry->head = head;
+	entry->prev = NULL;
+	entry->next = *head;
+	if (*head != NULL)
+		(*head)->prev = entry;
+	*head = entry;
+}
+
+static void fidx_unlink(EDS_FIDX_ENTRY *entry)
+{
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
+	else
+		*entry->head = entry->next;
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+}
+
+/****************************************************************************
+ * Trie of the prefix or reversed suffix filters of one position
+ ****************************************************************************/
+static EDS_FIDX_NODE *fidx_node_alloc(EDS_FIDX_NODE *parent, uint8_t byte)
+{
+	EDS_FIDX_NODE *node = m_MMGR_ALLOC_EDS_FILTER_INDEX(sizeof(EDS_FIDX_NODE));
+
+	if (node == NULL)
+		return NULL;
+	memset(node, 0, sizeof(EDS_FIDX_NODE));
+	node->parent = parent;
+	node->byte = byte;
+	return node;
+}
+
+/* Index of the child with byte, or where it is to be inserted */
+static uint32_t fidx_child_pos(EDS_FIDX_NODE *node, uint8_t byte)
+{
+	uint32_t low = 0;
+	uint32_t high = node->num_children;
+
+	while (low < high) {
+		uint32_t mid = (low + high) / 2;
+		if (node->children[mid]->byte < byte)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+static EDS_FIDX_NODE *fidx_child(EDS_FIDX_NODE *node, uint8_t byte)
+{
+	uint32_t pos = fidx_child_pos(node, byte);
+
+	if (pos < node->num_children && node->children[pos]->byte == byte)
+		return node->children[pos];
+	return NULL;
+}
+
+static EDS_FIDX_NODE *fidx_child_add(EDS_FIDX_NODE *node, uint8_t byte)
+{
+	uint32_t pos = fidx_child_pos(node, byte);
+	EDS_FIDX_NODE *child;
+
+	if (pos < node->num_children && node->children[pos]->byte == byte)
+		return node->children[pos];
+
+	if (node->num_children == node->max_children) {
+		uint16_t max = node->max_children ? 2 * node->max_children : 2;
+		EDS_FIDX_NODE **children = m_MMGR_ALLOC_EDS_FILTER_INDEX(max * sizeof(EDS_FIDX_NODE *));
+
+		if (children == NULL)
+			return NULL;
+		if (node->num_children > 0)
+			memcpy(children, node->children, node->num_children * sizeof(EDS_FIDX_NODE *));
+		if (node->children != NULL)
+			m_MMGR_FREE_EDS_FILTER_INDEX(node->children);
+		node->children = children;
+		node->max_children = max;
+	}
+
+	child = fidx_node_alloc(node, byte);
+	if (child == NULL)
+		return NULL;
+	memmove(&node->children[pos + 1], &node->children[pos],
+		(node->num_children - pos) * sizeof(EDS_FIDX_NODE *));
+	node->children[pos] = child;
+	node->num_children++;
+	return child;
+}
+
+/* Frees the nodes left without filters, up to the root */
+static void fidx_node_prune(EDS_FIDX_NODE *node)
+{
+	while (node->parent != NULL && node->entries == NULL && node->num_children == 0) {
+		EDS_FIDX_NODE *parent = node->parent;
+		uint32_t pos = fidx_child_pos(parent, node->byte);
+
+		memmove(&parent->children[pos], &parent->children[pos + 1],
+			(parent->num_children - pos - 1) * sizeof(EDS_FIDX_NODE *));
+		parent->num_children--;
+		if (node->children != NULL)
+			m_MMGR_FREE_EDS_FILTER_INDEX(node->children);
+		m_MMGR_FREE_EDS_FILTER_INDEX(node);
+		node = parent;
+	}
+}
+
+static void fidx_node_destroy(EDS_FIDX_NODE *node)
+{
+	uint32_t i;
+
+	if (node == NULL)
+		return;
+	for (i = 0; i < node->num_children; i++)
+		fidx_node_destroy(node->children[i]);
+	if (node->children != NULL)
+		m_MMGR_FREE_EDS_FILTER_INDEX(node->children);
+	m_MMGR_FREE_EDS_FILTER_INDEX(node);
+}
+
+/* Adds the entry at the node spelling the filter, reversed for a suffix */
+static uint32_t fidx_trie_add(EDS_FIDX_NODE **root, SaEvtEventPatternT *filter, bool reversed,
+			      EDS_FIDX_ENTRY *entry)
+{
+	EDS_FIDX_NODE *node;
+	SaSizeT i;
+
+	if (*root == NULL && (*root = fidx_node_alloc(NULL, 0)) == NULL)
+		return NCSCC_RC_OUT_OF_MEM;
+
+	node = *root;
+	for (i = 0; i < filter->patternSize; i++) {
+		uint8_t byte = reversed ? filter->pattern[filter->patternSize - 1 - i] : filter->pattern[i];
+		EDS_FIDX_NODE *child = fidx_child_add(node, byte);
+
+		if (child == NULL) {
+			fidx_node_prune(node);
+			return NCSCC_RC_OUT_OF_MEM;
+		}
+		node = child;
+	}
+
+	entry->node = node;
+	fidx_link(&node->entries, entry);
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Hash table of the exact filters
+ ****************************************************************************/
+static EDS_FIDX_KEY *fidx_key_get(EDS_FILTER_INDEX *index, uint32_t position, const uint8_t *bytes,
+				  SaSizeT size, uint32_t hash)
+{
+	EDS_FIDX_KEY *key;
+
+	if (index->num_buckets == 0)
+		return NULL;
+	for (key = index->buckets[hash % index->num_buckets]; key != NULL; key = key->next) {
+		if (key->hash == hash && key->position == position && key->size == size &&
+		    (size == 0 || memcmp(key->bytes, bytes, (size_t)size) == 0))
+			return key;
+	}
+	return NULL;
+}
+
+static uint32_t fidx_buckets_grow(EDS_FILTER_INDEX *index)
+{
+	uint32_t num_buckets = index->num_buckets ? 2 * index->num_buckets : EDS_FIDX_MIN_BUCKETS;
+	EDS_FIDX_KEY **buckets = m_MMGR_ALLOC_EDS_FILTER_INDEX(num_buckets * sizeof(EDS_FIDX_KEY *));
+	uint32_t i;
+
+	if (buckets == NULL)
+		return NCSCC_RC_OUT_OF_MEM;
+	memset(buckets, 0, num_buckets * sizeof(EDS_FIDX_KEY *));
+
+	for (i = 0; i < index->num_buckets; i++) {
+		EDS_FIDX_KEY *key = index->buckets[i];
+
+		while (key != NULL) {
+			EDS_FIDX_KEY *next = key->next;
+			key->next = buckets[key->hash % num_buckets];
+			buckets[key->hash % num_buckets] = key;
+			key = next;
+		}
+	}
+	if (index->buckets != NULL)
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->buckets);
+	index->buckets = buckets;
+	index->num_buckets = num_buckets;
+	return NCSCC_RC_SUCCESS;
+}
+
+static uint32_t fidx_exact_add(EDS_FILTER_INDEX *index, uint32_t position, SaEvtEventPatternT *filter,
+			       EDS_FIDX_ENTRY *entry)
+{
+	uint32_t hash = fidx_hash(position, filter->pattern, filter->patternSize);
+	EDS_FIDX_KEY *key = fidx_key_get(index, position, filter->pattern, filter->patternSize, hash);
+
+	if (key == NULL) {
+		if (index->num_keys >= index->num_buckets && fidx_buckets_grow(index) != NCSCC_RC_SUCCESS)
+			return NCSCC_RC_OUT_OF_MEM;
+
+		key = m_MMGR_ALLOC_EDS_FILTER_INDEX(sizeof(EDS_FIDX_KEY) + filter->patternSize);
+		if (key == NULL)
+			return NCSCC_RC_OUT_OF_MEM;
+		key->hash = hash;
+		key->position = position;
+		key->size = filter->patternSize;
+		key->entries = NULL;
+		if (filter->patternSize > 0)
+			memcpy(key->bytes, filter->pattern, (size_t)filter->patternSize);
+		key->next = index->buckets[hash % index->num_buckets];
+		index->buckets[hash % index->num_buckets] = key;
+		index->num_keys++;
+	}
+
+	entry->key = key;
+	fidx_link(&key->entries, entry);
+	return NCSCC_RC_SUCCESS;
+}
+
+static void fidx_key_remove(EDS_FILTER_INDEX *index, EDS_FIDX_KEY *key)
+{
+	EDS_FIDX_KEY **pp = &index->buckets[key->hash % index->num_buckets];
+
+	while (*pp != key)
+		pp = &(*pp)->next;
+	*pp = key->next;
+	index->num_keys--;
+	m_MMGR_FREE_EDS_FILTER_INDEX(key);
+}
+
+/****************************************************************************
+ * Subscriptions
+ ****************************************************************************/
+static uint32_t fidx_positions_grow(EDS_FILTER_INDEX *index, uint32_t num_positions)
+{
+	EDS_FIDX_NODE **prefix, **suffix;
+	size_t size = num_positions * sizeof(EDS_FIDX_NODE *);
+	size_t old_size = index->num_positions * sizeof(EDS_FIDX_NODE *);
+
+	prefix = m_MMGR_ALLOC_EDS_FILTER_INDEX(size);
+	suffix = m_MMGR_ALLOC_EDS_FILTER_INDEX(size);
+	if (prefix == NULL || suffix == NULL) {
+		if (prefix != NULL)
+			m_MMGR_FREE_EDS_FILTER_INDEX(prefix);
+		if (suffix != NULL)
+			m_MMGR_FREE_EDS_FILTER_INDEX(suffix);
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	memset(prefix, 0, size);
+	memset(suffix, 0, size);
+	if (index->num_positions > 0) {
+		memcpy(prefix, index->prefix, old_size);
+		memcpy(suffix, index->suffix, old_size);
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->prefix);
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->suffix);
+	}
+	index->prefix = prefix;
+	index->suffix = suffix;
+	index->num_positions = num_positions;
+	return NCSCC_RC_SUCCESS;
+}
+
+/* Removes the filters of a subscription and frees its index data */
+static void fidx_sub_free(EDS_FIDX_SUB *sub)
+{
+	EDS_FILTER_INDEX *index = sub->index;
+	uint32_t i;
+
+	for (i = 0; i < sub->num_entries; i++) {
+		EDS_FIDX_ENTRY *entry = &sub->entries[i];
+
+		fidx_unlink(entry);
+		if (entry->node != NULL)
+			fidx_node_prune(entry->node);
+		else if (entry->key != NULL && entry->key->entries == NULL)
+			fidx_key_remove(index, entry->key);
+	}
+
+	if (sub->prev != NULL)
+		sub->prev->next = sub->next;
+	else
+		index->subs = sub->next;
+	if (sub->next != NULL)
+		sub->next->prev = sub->prev;
+
+	m_MMGR_FREE_EDS_FILTER_INDEX(sub);
+}
+
+/****************************************************************************
+ * Name          : eds_filter_index_add
+ *
+ * Description   : Indexes the filters of a new subscription on the channel.
+ *                 Subscriptions are added in the order of their channel
+ *                 open's subscription list.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_OUT_OF_MEM
+ *****************************************************************************/
+uint32_t eds_filter_index_add(EDS_FILTER_INDEX *index, SUBSC_REC *subrec)
+{
+	SaEvtEventFilterArrayT *filterArray = subrec->filters;
+	uint32_t num_filters = filterArray ? (uint32_t)filterArray->filtersNumber : 0;
+	bool never = (filterArray == NULL);
+	EDS_FIDX_SUB *sub;
+	uint32_t x;
+
+	for (x = 0; x < num_filters; x++) {
+		if (filterArray->filters[x].filterType < SA_EVT_PREFIX_FILTER ||
+		    filterArray->filters[x].filterType > SA_EVT_PASS_ALL_FILTER)
+			never = true;
+	}
+	if (never)
+		num_filters = 0;
+
+	if (num_filters > index->num_positions && fidx_positions_grow(index, num_filters) != NCSCC_RC_SUCCESS)
+		return NCSCC_RC_OUT_OF_MEM;
+
+	sub = m_MMGR_ALLOC_EDS_FILTER_INDEX(sizeof(EDS_FIDX_SUB) + (num_filters + 1) * sizeof(EDS_FIDX_ENTRY));
+	if (sub == NULL)
+		return NCSCC_RC_OUT_OF_MEM;
+	memset(sub, 0, sizeof(EDS_FIDX_SUB));
+	sub->index = index;
+	sub->subrec = subrec;
+	sub->seq = ++index->next_seq;
+	sub->next = index->subs;
+	if (index->subs != NULL)
+		index->subs->prev = sub;
+	index->subs = sub;
+	subrec->fidx = sub;
+
+	for (x = 0; x < num_filters; x++) {
+		SaEvtEventFilterT *filter = &filterArray->filters[x];
+		EDS_FIDX_ENTRY *entry = &sub->entries[sub->num_entries];
+		uint32_t rc;
+
+		memset(entry, 0, sizeof(EDS_FIDX_ENTRY));
+		entry->sub = sub;
+
+		switch (filter->filterType) {
+		case SA_EVT_PREFIX_FILTER:
+			if (filter->filter.patternSize == 0)
+				continue;
+			rc = fidx_trie_add(&index->prefix[x], &filter->filter, false, entry);
+			break;
+		case SA_EVT_SUFFIX_FILTER:
+			if (filter->filter.patternSize == 0)
+				continue;
+			rc = fidx_trie_add(&index->suffix[x], &filter->filter, true, entry);
+			break;
+		case SA_EVT_EXACT_FILTER:
+			rc = fidx_exact_add(index, x, &filter->filter, entry);
+			break;
+		default:
+			continue;
+		}
+
+		if (rc != NCSCC_RC_SUCCESS) {
+			subrec->fidx = NULL;
+			fidx_sub_free(sub);
+			return rc;
+		}
+		sub->num_entries++;
+	}
+
+	sub->needed = sub->num_entries;
+	if (!never && sub->num_entries == 0) {
+		/* No filter was indexed, the subscription matches every event */
+		memset(&sub->entries[0], 0, sizeof(EDS_FIDX_ENTRY));
+		sub->entries[0].sub = sub;
+		fidx_link(&index->pass_all, &sub->entries[0]);
+		sub->num_entries = 1;
+		sub->needed = 1;
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : eds_filter_index_remove
+ *
+ * Description   : Removes a subscription from the index of its channel.
+ *****************************************************************************/
+void eds_filter_index_remove(SUBSC_REC *subrec)
+{
+	if (subrec->fidx == NULL)
+		return;
+	fidx_sub_free(subrec->fidx);
+	subrec->fidx = NULL;
+}
+
+/****************************************************************************
+ * Name          : eds_filter_index_destroy
+ *
+ * Description   : Frees the index of a channel. Subscriptions still on the
+ *                 channel are left unindexed.
+ *****************************************************************************/
+void eds_filter_index_destroy(EDS_FILTER_INDEX *index)
+{
+	uint32_t i;
+
+	while (index->subs != NULL) {
+		EDS_FIDX_SUB *sub = index->subs;
+
+		index->subs = sub->next;
+		sub->subrec->fidx = NULL;
+		m_MMGR_FREE_EDS_FILTER_INDEX(sub);
+	}
+
+	for (i = 0; i < index->num_positions; i++) {
+		fidx_node_destroy(index->prefix[i]);
+		fidx_node_destroy(index->suffix[i]);
+	}
+	if (index->num_positions > 0) {
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->prefix);
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->suffix);
+	}
+
+	for (i = 0; i < index->num_buckets; i++) {
+		while (index->buckets[i] != NULL) {
+			EDS_FIDX_KEY *key = index->buckets[i];
+			index->buckets[i] = key->next;
+			m_MMGR_FREE_EDS_FILTER_INDEX(key);
+		}
+	}
+	if (index->buckets != NULL)
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->buckets);
+	if (index->found != NULL)
+		m_MMGR_FREE_EDS_FILTER_INDEX(index->found);
+
+	memset(index, 0, sizeof(EDS_FILTER_INDEX));
+}
+
+/****************************************************************************
+ * Lookup
+ ****************************************************************************/
+static void fidx_found(EDS_FILTER_INDEX *index, SUBSC_REC *subrec)
+{
+	if (index->num_found == index->max_found) {
+		uint32_t max = index->max_found ? 2 * index->max_found : 16;
+		SUBSC_REC **found = m_MMGR_ALLOC_EDS_FILTER_INDEX(max * sizeof(SUBSC_REC *));
+
+		if (found == NULL) {
+			LOG_CR("malloc failed for filter index lookup, event not delivered to all subscribers");
+			return;
+		}
+		if (index->num_found > 0)
+			memcpy(found, index->found, index->num_found * sizeof(SUBSC_REC *));
+		if (index->found != NULL)
+			m_MMGR_FREE_EDS_FILTER_INDEX(index->found);
+		index->found = found;
+		index->max_found = max;
+	}
+	index->found[index->num_found++] = subrec;
+}
+
+static void fidx_hit(EDS_FILTER_INDEX *index, EDS_FIDX_ENTRY *entry)
+{
+	for (; entry != NULL; entry = entry->next) {
+		EDS_FIDX_SUB *sub = entry->sub;
+
+		if (sub->gen != index->gen) {
+			sub->gen = index->gen;
+			sub->hits = 0;
+		}
+		if (++sub->hits == sub->needed)
+			fidx_found(index, sub->subrec);
+	}
+}
+
+static void fidx_trie_hit(EDS_FILTER_INDEX *index, EDS_FIDX_NODE *node, SaEvtEventPatternT *pattern,
+			  bool reversed)
+{
+	SaSizeT i;
+
+	for (i = 0; node != NULL && i < pattern->patternSize; i++) {
+		uint8_t byte = reversed ? pattern->pattern[pattern->patternSize - 1 - i] : pattern->pattern[i];
+
+		node = fidx_child(node, byte);
+		if (node != NULL)
+			fidx_hit(index, node->entries);
+	}
+}
+
+/* Channel open order, then subscription order within a channel open */
+static int fidx_found_cmp(const void *a, const void *b)
+{
+	const SUBSC_REC *sa = *(SUBSC_REC *const *)a;
+	const SUBSC_REC *sb = *(SUBSC_REC *const *)b;
+
+	if (sa->chan_open_id != sb->chan_open_id)
+		return sa->chan_open_id < sb->chan_open_id ? -1 : 1;
+	if (sa->fidx->seq != sb->fidx->seq)
+		return sa->fidx->seq < sb->fidx->seq ? -1 : 1;
+	return 0;
+}
+
+/****************************************************************************
+ * Name          : eds_filter_index_match
+ *
+ * Description   : Finds the subscriptions of the channel whose filters match
+ *                 a pattern array. The cost depends on the pattern sizes and
+ *                 the number of filters hit, not on the number of
+ *                 subscriptions.
+ *
+ * Arguments     : found - Set to the matching subscriptions, ordered by
+ *                         channel open id and then as in the channel open's
+ *                         subscription list. Valid until the next call.
+ *
+ * Return Values : Number of matching subscriptions.
+ *****************************************************************************/
+uint32_t eds_filter_index_match(EDS_FILTER_INDEX *index, SaEvtEventPatternArrayT *patternArray,
+				SUBSC_REC ***found)
+{
+	SaEvtEventPatternT emptyPattern = { 0, 0, NULL };
+	uint32_t x;
+
+	index->num_found = 0;
+	*found = index->found;
+	if (patternArray == NULL)
+		return 0;
+
+	if (++index->gen == 0)
+		index->gen = 1;
+
+	fidx_hit(index, index->pass_all);
+
+	for (x = 0; x < index->num_positions; x++) {
+		SaEvtEventPatternT *pattern = &emptyPattern;
+		uint32_t hash;
+		EDS_FIDX_KEY *key;
+
+		if (x < patternArray->patternsNumber && patternArray->patterns != NULL)
+			pattern = &patternArray->patterns[x];
+
+		fidx_trie_hit(index, index->prefix[x], pattern, false);
+		fidx_trie_hit(index, index->suffix[x], pattern, true);
+
+		hash = fidx_hash(x, pattern->pattern, pattern->patternSize);
+		key = fidx_key_get(index, x, pattern->pattern, pattern->patternSize, hash);
+		if (key != NULL)
+			fidx_hit(index, key->entries);
+	}
+
+	if (index->num_found > 1)
+		qsort(index->found, index->num_found, sizeof(SUBSC_REC *), fidx_found_cmp);
+	*found = index->found;
+	return index->num_found;
+}
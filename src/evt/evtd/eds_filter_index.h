@@ -0,0 +1,92 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION:
+
+  This file contains the subscription filter index of an event channel.
+
+  The filters of the subscriptions on a channel are indexed by their
+  position in the filter array. Prefix filters are kept in a trie, suffix
+  filters in a trie of the reversed filters and exact filters in a hash
+  table. A published pattern array is looked up once per position and a
+  subscription matches when all of its filters were hit.
+..............................................................................
+
+*******************************************************************************/
+#ifndef EVT_EVTD_EDS_FILTER_INDEX_H_
+#define EVT_EVTD_EDS_FILTER_INDEX_H_
+
+#include "base/ncsgl_defs.h"
+#include "evt/saf/saEvt.h"
+
+struct subsc_rec_tag;
+struct eds_fidx_node_tag;
+struct eds_fidx_key_tag;
+struct eds_fidx_sub_tag;
+
+/* One indexed filter of a subscription */
+typedef struct eds_fidx_entry_tag {
+	struct eds_fidx_entry_tag *prev;
+	struct eds_fidx_entry_tag *next;
+	struct eds_fidx_entry_tag **head;	/* List holding the entry */
+	struct eds_fidx_node_tag *node;	/* Trie node of a prefix/suffix filter */
+	struct eds_fidx_key_tag *key;	/* Hash entry of an exact filter */
+	struct eds_fidx_sub_tag *sub;
+} EDS_FIDX_ENTRY;
+
+/* Index data of a subscription, SUBSC_REC.fidx */
+typedef struct eds_fidx_sub_tag {
+	struct eds_filter_index_tag *index;
+	struct subsc_rec_tag *subrec;
+	struct eds_fidx_sub_tag *prev;
+	struct eds_fidx_sub_tag *next;
+	uint32_t seq;		/* Order of the subscriptions of a channel open */
+	uint32_t needed;	/* Filters to hit for a match */
+	uint32_t gen;		/* Lookup that last hit a filter */
+	uint32_t hits;
+	uint32_t num_entries;
+	EDS_FIDX_ENTRY entries[];
+} EDS_FIDX_SUB;
+
+typedef struct eds_filter_index_tag {
+	uint32_t num_positions;
+	struct eds_fidx_node_tag **prefix;	/* Trie per filter position */
+	struct eds_fidx_node_tag **suffix;	/* Trie of reversed filters per position */
+	struct eds_fidx_key_tag **buckets;	/* Exact filters of all positions */
+	uint32_t num_buckets;
+	uint32_t num_keys;
+	EDS_FIDX_ENTRY *pass_all;	/* Subscriptions matching every event */
+	EDS_FIDX_SUB *subs;
+	uint32_t next_seq;
+	uint32_t gen;
+	struct subsc_rec_tag **found;	/* Result of the last lookup */
+	uint32_t num_found;
+	uint32_t max_found;
+} EDS_FILTER_INDEX;
+
+uint32_t eds_filter_index_add(EDS_FILTER_INDEX *index, struct subsc_rec_tag *subrec);
+void eds_filter_index_remove(struct subsc_rec_tag *subrec);
+void eds_filter_index_destroy(EDS_FILTER_INDEX *index);
+uint32_t eds_filter_index_match(EDS_FILTER_INDEX *index, SaEvtEventPatternArrayT *patternArray,
+				 struct subsc_rec_tag ***found);
+
+#endif  // EVT_EVTD_EDS_FILTER_INDEX_H_
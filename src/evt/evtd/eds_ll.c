@@ -226,6 +226,8 @@ static void eds_remove_subrec_entry(EDS_CB *cb, SUBSC_REC **subrec)
 	TRACE("chan_id: %u, chan_open_id: %u, subscription id: %u", p->chan_id,
 								 p->chan_open_id, p->subscript_id);
 
+	eds_filter_index_remove(p);
+
 	if (p->prev == NULL) {	/* Top entry */
 		if (p->next != NULL) {	/* It's not the only element */
 			p->next->prev = NULL;	/* Clear prev pointer */
@@ -304,6 +306,13 @@ static uint32_t eds_add_subscription_to_worklist(EDS_CB *cb, SUBSC_REC *subrec)
 			/* Set parent chan_open_rec pointer so we can remove root entry later */
 			subrec->par_chan_open_inst = co;
 
+			/* Index the filters for publish */
+			if (eds_filter_index_add(&wp->filter_index, subrec) != NCSCC_RC_SUCCESS) {
+				LOG_CR("malloc failed for subscription filter index");
+				TRACE_LEAVE();
+				return (NCSCC_RC_OUT_OF_MEM);
+			}
+
 			/* Add it! */
 			rs = eds_add_subrec_entry(co, subrec);
 			TRACE_LEAVE();
@@ -445,6 +454,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				eds_remove_retained_events(wp->ret_evt_list_head, wp->ret_evt_list_tail);
 				/* Destroy the patricia tree for channel open recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_filter_index_destroy(&wp->filter_index);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(wp->cname);	/* free channelName */
 				m_MMGR_FREE_EDS_WORKLIST(cb->eds_work_list);	/* free 1st cell */
@@ -458,6 +468,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				eds_remove_retained_events(wp->ret_evt_list_head, wp->ret_evt_list_tail);
 				/* Destroy the patricia tree for channel open recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_filter_index_destroy(&wp->filter_index);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(wp->cname);
 				m_MMGR_FREE_EDS_WORKLIST(wp);	/* free Last cell */
@@ -472,6 +483,7 @@ uint32_t eds_remove_worklist_entry(EDS_CB *cb, uint32_t chan_id)
 				eds_remove_retained_events(wp->ret_evt_list_head, wp->ret_evt_list_tail);
 				/* Destroy the patricia tree for channel open recs */
 				ncs_patricia_tree_destroy(&wp->chan_open_rec);
+				eds_filter_index_destroy(&wp->filter_index);
 				m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
 				m_MMGR_FREE_EDS_CHAN_NAME(wp->cname);
 				m_MMGR_FREE_EDS_WORKLIST(wp);	/* free the cell */
@@ -861,6 +873,7 @@ static void eds_del_work_list(EDS_CB *cb, EDS_WORKLIST **p_work_list)
 	** erased
 	**/
 		ncs_patricia_tree_destroy(&work_list->chan_open_rec);
+		eds_filter_index_destroy(&work_list->filter_index);
 
 		/* free channelName */
 		m_MMGR_FREE_EDS_CHAN_NAME(work_list->cname);
@@ -48,6 +48,7 @@ typedef enum {
 	NCS_SERVICE_EDS_CNAME_REC,
 	NCS_SERVICE_EDA_DOWN_LIST,
 	NCS_SERVICE_EDS_CLUSTER_NODE_LIST,
+	NCS_SERVICE_EDS_FILTER_INDEX,
 } NCS_SERVICE_EDS_SUBID;
 
 /****************************************
@@ -186,4 +187,14 @@ typedef enum {
                                             NCS_SERVICE_ID_EDS, \
                                             NCS_SERVICE_EDS_CLUSTER_NODE_LIST)
 
+#define m_MMGR_ALLOC_EDS_FILTER_INDEX(size) m_NCS_MEM_ALLOC(size, \
+                                            NCS_MEM_REGION_PERSISTENT, \
+                                            NCS_SERVICE_ID_EDS, \
+                                            NCS_SERVICE_EDS_FILTER_INDEX)
+
+#define m_MMGR_FREE_EDS_FILTER_INDEX(p)     m_NCS_MEM_FREE(p, \
+                                            NCS_MEM_REGION_PERSISTENT, \
+                                            NCS_SERVICE_ID_EDS, \
+                                            NCS_SERVICE_EDS_FILTER_INDEX)
+
 #endif  // EVT_EVTD_EDS_MEM_H_
@@ -0,0 +1,231 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstring>
+#include <string>
+#include "gtest/gtest.h"
+#include "base/ncs_edu_gen.h"
+#include "base/ncs_ubaid.h"
+#include "base/ncssysf_mem.h"
+extern "C" {
+#include "evt/evtd/eds.h"
+}
+
+// The fixture for comparing the EDU functions generated from the evtd
+// checkpoint rules with the EDU interpreter
+class EdsCkptTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    m_NCS_EDU_HDL_INIT(&edu_hdl_);
+    gl_edu_gen_enabled = true;
+  }
+
+  virtual void TearDown() {
+    m_NCS_EDU_HDL_FLUSH(&edu_hdl_);
+    gl_edu_gen_enabled = true;
+  }
+
+  // Encodes "data", returns the encoded octets
+  std::string Encode(EDS_CKPT_DATA *data, bool generated) {
+    NCS_UBAID uba;
+    EDU_ERR err = EDU_NORMAL;
+
+    gl_edu_gen_enabled = generated;
+    memset(&uba, 0, sizeof(uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS,
+              m_NCS_EDU_EXEC(&edu_hdl_, eds_edp_ed_ckpt_msg, &uba,
+                             EDP_OP_TYPE_ENC, data, &err));
+    USRBUF *ub = uba.start;
+    uint32_t len = m_MMGR_LINK_DATA_LEN(ub);
+    std::string octets(len, '\0');
+    ncs_dec_init_space(&uba, ub);
+    EXPECT_EQ(NCSCC_RC_SUCCESS,
+              ncs_decode_n_octets_from_uba(
+                  &uba, reinterpret_cast<uint8_t *>(&octets[0]), len));
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    return octets;
+  }
+
+  // Decodes "octets" into "data"
+  uint32_t Decode(const std::string &octets, EDS_CKPT_DATA *data,
+                  bool generated) {
+    NCS_UBAID uba;
+    EDU_ERR err = EDU_NORMAL;
+
+    gl_edu_gen_enabled = generated;
+    memset(&uba, 0, sizeof(uba));
+    ncs_enc_init_space(&uba);
+    ncs_encode_n_octets_in_uba(
+        &uba,
+        reinterpret_cast<uint8_t *>(const_cast<char *>(octets.data())),
+        octets.size());
+    ncs_dec_init_space(&uba, uba.start);
+    uint32_t rc = m_NCS_EDU_EXEC(&edu_hdl_, eds_edp_ed_ckpt_msg, &uba,
+                                 EDP_OP_TYPE_DEC, &data, &err);
+    m_MMGR_FREE_BUFR_LIST(uba.ub);
+    return rc;
+  }
+
+  // Encodes "data" with both, checks that the octets are the same and that
+  // both decode them into "data" again
+  void RoundTrip(EDS_CKPT_DATA *data) {
+    EDS_CKPT_DATA generated;
+    EDS_CKPT_DATA interpreted;
+
+    std::string octets = Encode(data, false);
+    EXPECT_EQ(octets, Encode(data, true));
+
+    ASSERT_EQ(NCSCC_RC_SUCCESS, Decode(octets, &generated, true));
+    ASSERT_EQ(NCSCC_RC_SUCCESS, Decode(octets, &interpreted, false));
+    EXPECT_EQ(0, memcmp(&generated, &interpreted, sizeof(generated)));
+    EXPECT_EQ(0, memcmp(data, &generated, sizeof(generated)));
+  }
+
+  void FillHeader(EDS_CKPT_DATA *data, EDS_CKPT_DATA_TYPE type) {
+    memset(data, 0, sizeof(*data));
+    data->header.ckpt_rec_type = type;
+    data->header.num_ckpt_records = 1;
+    data->header.data_len = 0x1234;
+  }
+
+  EDU_HDL edu_hdl_;
+};
+
+TEST_F(EdsCkptTest, RegRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_INITIALIZE_REC);
+  data.ckpt_rec.reg_rec.reg_id = 0x01020304;
+  data.ckpt_rec.reg_rec.eda_client_dest = 0x2010f00000123ULL;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, FinalizeRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_FINALIZE_REC);
+  data.ckpt_rec.finalize_rec.reg_id = 42;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, ChanRec) {
+  EDS_CKPT_DATA data;
+
+  for (EDS_CKPT_DATA_TYPE type :
+       {EDS_CKPT_CHAN_REC, EDS_CKPT_ASYNC_CHAN_OPEN_REC}) {
+    FillHeader(&data, type);
+    EDS_CKPT_CHAN_MSG *rec = &data.ckpt_rec.chan_rec;
+    rec->reg_id = 1;
+    rec->chan_id = 2;
+    rec->last_copen_id = 3;
+    rec->chan_attrib = SA_EVT_CHANNEL_CREATE | SA_EVT_CHANNEL_PUBLISHER;
+    rec->cname_len = strlen("safChnl=evtChannel");
+    memcpy(rec->cname, "safChnl=evtChannel", rec->cname_len);
+    rec->chan_opener_dest = 0x2020f00000456ULL;
+    rec->chan_create_time = 1476700000000000000LL;
+    RoundTrip(&data);
+  }
+}
+
+TEST_F(EdsCkptTest, ChanOpenRec) {
+  EDS_CKPT_DATA data;
+
+  // The creation time is not part of the channel open record
+  FillHeader(&data, EDS_CKPT_CHAN_OPEN_REC);
+  EDS_CKPT_CHAN_OPEN_MSG *rec = &data.ckpt_rec.chan_open_rec;
+  rec->reg_id = 1;
+  rec->chan_id = 2;
+  rec->chan_open_id = 3;
+  rec->chan_attrib = SA_EVT_CHANNEL_SUBSCRIBER;
+  rec->chan_opener_dest = 0x2020f00000456ULL;
+  rec->cname_len = strlen("safChnl=evtChannel");
+  memcpy(rec->cname, "safChnl=evtChannel", rec->cname_len);
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, ChanCloseRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_CHAN_CLOSE_REC);
+  data.ckpt_rec.chan_close_rec.reg_id = 5;
+  data.ckpt_rec.chan_close_rec.chan_id = 6;
+  data.ckpt_rec.chan_close_rec.chan_open_id = 7;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, ChanUnlinkRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_CHAN_UNLINK_REC);
+  data.ckpt_rec.chan_unlink_rec.reg_id = 8;
+  data.ckpt_rec.chan_unlink_rec.chan_name.length =
+      strlen("safChnl=evtChannel");
+  memcpy(data.ckpt_rec.chan_unlink_rec.chan_name.value, "safChnl=evtChannel",
+         data.ckpt_rec.chan_unlink_rec.chan_name.length);
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, RetentionTimeClearRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_RETENTION_TIME_CLR_REC);
+  data.ckpt_rec.reten_time_clr_rec.data.chan_id = 9;
+  data.ckpt_rec.reten_time_clr_rec.data.chan_open_id = 10;
+  data.ckpt_rec.reten_time_clr_rec.data.event_id = 11;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, UnsubscribeRec) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_UNSUBSCRIBE_REC);
+  data.ckpt_rec.unsubscribe_rec.data.reg_id = 12;
+  data.ckpt_rec.unsubscribe_rec.data.chan_id = 13;
+  data.ckpt_rec.unsubscribe_rec.data.chan_open_id = 14;
+  data.ckpt_rec.unsubscribe_rec.data.sub_id = 15;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, WarmSyncChecksum) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_WARM_SYNC_CSUM);
+  data.ckpt_rec.warm_sync_csum.reg_csum = 0xa1a2;
+  data.ckpt_rec.warm_sync_csum.copen_csum = 0xb1b2;
+  data.ckpt_rec.warm_sync_csum.subsc_csum = 0xc1c2;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, AgentDown) {
+  EDS_CKPT_DATA data;
+
+  FillHeader(&data, EDS_CKPT_AGENT_DOWN);
+  data.ckpt_rec.agent_dest = 0x2030f00000789ULL;
+  RoundTrip(&data);
+}
+
+TEST_F(EdsCkptTest, DecodeOfTruncatedDataFails) {
+  EDS_CKPT_DATA data;
+  EDS_CKPT_DATA decoded;
+
+  FillHeader(&data, EDS_CKPT_CHAN_OPEN_REC);
+  data.ckpt_rec.chan_open_rec.cname_len = 4;
+  std::string octets = Encode(&data, false);
+  octets.resize(octets.size() - 1);
+  EXPECT_NE(NCSCC_RC_SUCCESS, Decode(octets, &decoded, true));
+}
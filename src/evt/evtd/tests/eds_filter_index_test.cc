@@ -0,0 +1,248 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "evt/evtd/eds.h"
+}
+
+namespace {
+
+// Bytes following every pattern. eds_pattern_match() compares a prefix
+// filter with the pattern without checking the pattern size, so these
+// bytes, which are in no filter, make a too long prefix filter miss.
+const uint8_t kGuard = 0xff;
+const size_t kGuardSize = 8;
+
+struct Subscription {
+  SUBSC_REC rec;
+  SaEvtEventFilterArrayT array;
+  std::vector<SaEvtEventFilterT> filters;
+  uint32_t order;
+};
+
+}  // namespace
+
+// The fixture for comparing the subscriptions found by the filter index
+// with the ones that eds_pattern_match() accepts
+class EdsFilterIndexTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    memset(&index_, 0, sizeof(index_));
+    next_order_ = 0;
+  }
+
+  virtual void TearDown() {
+    eds_filter_index_destroy(&index_);
+    for (auto &sub : subs_) EXPECT_EQ(nullptr, sub->rec.fidx);
+  }
+
+  // Returns a copy of "str" that lives as long as the test
+  uint8_t *Store(const std::string &str) {
+    bytes_.emplace_back(str.begin(), str.end());
+    bytes_.back().insert(bytes_.back().end(), kGuardSize, kGuard);
+    return bytes_.back().data();
+  }
+
+  SaEvtEventPatternT Pattern(const std::string &str) {
+    SaEvtEventPatternT pattern;
+    pattern.allocatedSize = str.size();
+    pattern.patternSize = str.size();
+    pattern.pattern = Store(str);
+    return pattern;
+  }
+
+  SaEvtEventFilterT Filter(int type, const std::string &str) {
+    SaEvtEventFilterT filter;
+    filter.filterType = static_cast<SaEvtEventFilterTypeT>(type);
+    filter.filter = Pattern(str);
+    return filter;
+  }
+
+  // Adds a subscription with "filters" to the index, or one without a
+  // filter array if "filters" is null
+  Subscription *Add(uint32_t chan_open_id,
+                    const std::vector<SaEvtEventFilterT> *filters) {
+    subs_.emplace_back(new Subscription());
+    Subscription *sub = subs_.back().get();
+    memset(&sub->rec, 0, sizeof(sub->rec));
+    sub->rec.chan_open_id = chan_open_id;
+    sub->order = next_order_++;
+    if (filters != nullptr) {
+      sub->filters = *filters;
+      sub->array.filtersNumber = sub->filters.size();
+      sub->array.filters = sub->filters.empty() ? nullptr : &sub->filters[0];
+      sub->rec.filters = &sub->array;
+    }
+    EXPECT_EQ(NCSCC_RC_SUCCESS, eds_filter_index_add(&index_, &sub->rec));
+    return sub;
+  }
+
+  void Remove(Subscription *sub) {
+    eds_filter_index_remove(&sub->rec);
+    EXPECT_EQ(nullptr, sub->rec.fidx);
+    subs_.remove_if([sub](const std::unique_ptr<Subscription> &s) {
+      return s.get() == sub;
+    });
+  }
+
+  // The subscriptions that eds_pattern_match() accepts, in channel open
+  // order and then in the order they were added
+  std::vector<SUBSC_REC *> Expected(SaEvtEventPatternArrayT *patterns) {
+    std::vector<Subscription *> sorted;
+    for (auto &sub : subs_) sorted.push_back(sub.get());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Subscription *a, const Subscription *b) {
+                if (a->rec.chan_open_id != b->rec.chan_open_id)
+                  return a->rec.chan_open_id < b->rec.chan_open_id;
+                return a->order < b->order;
+              });
+
+    std::vector<SUBSC_REC *> expected;
+    for (Subscription *sub : sorted) {
+      if (eds_pattern_match(patterns, sub->rec.filters))
+        expected.push_back(&sub->rec);
+    }
+    return expected;
+  }
+
+  std::vector<SUBSC_REC *> Found(SaEvtEventPatternArrayT *patterns) {
+    SUBSC_REC **found = nullptr;
+    uint32_t num_found = eds_filter_index_match(&index_, patterns, &found);
+    return std::vector<SUBSC_REC *>(found, found + num_found);
+  }
+
+  EDS_FILTER_INDEX index_;
+  std::list<std::unique_ptr<Subscription>> subs_;
+  std::list<std::vector<uint8_t>> bytes_;
+  uint32_t next_order_;
+};
+
+TEST_F(EdsFilterIndexTest, FilterTypes) {
+  std::vector<SaEvtEventFilterT> prefix{Filter(SA_EVT_PREFIX_FILTER, "ab")};
+  std::vector<SaEvtEventFilterT> suffix{
+      Filter(SA_EVT_PASS_ALL_FILTER, ""), Filter(SA_EVT_SUFFIX_FILTER, "yz")};
+  std::vector<SaEvtEventFilterT> exact{Filter(SA_EVT_EXACT_FILTER, "abc")};
+  std::vector<SaEvtEventFilterT> empty{Filter(SA_EVT_PREFIX_FILTER, ""),
+                                       Filter(SA_EVT_EXACT_FILTER, "")};
+  std::vector<SaEvtEventFilterT> unknown{Filter(0, "ab")};
+  std::vector<SaEvtEventFilterT> none;
+
+  Subscription *sub_prefix = Add(1, &prefix);
+  Subscription *sub_suffix = Add(1, &suffix);
+  Subscription *sub_exact = Add(1, &exact);
+  Subscription *sub_empty = Add(2, &empty);
+  Add(2, &unknown);
+  Subscription *sub_none = Add(2, &none);
+  Add(3, nullptr);
+
+  std::vector<SaEvtEventPatternT> patterns{Pattern("abc"), Pattern("xyz")};
+  SaEvtEventPatternArrayT array = {2, 2, &patterns[0]};
+  EXPECT_EQ((std::vector<SUBSC_REC *>{&sub_prefix->rec, &sub_suffix->rec,
+                                      &sub_exact->rec, &sub_none->rec}),
+            Found(&array));
+  EXPECT_EQ(Expected(&array), Found(&array));
+
+  // The second filter of "empty" only matches the empty pattern
+  array.patternsNumber = 1;
+  EXPECT_EQ((std::vector<SUBSC_REC *>{&sub_prefix->rec, &sub_exact->rec,
+                                      &sub_empty->rec, &sub_none->rec}),
+            Found(&array));
+  EXPECT_EQ(Expected(&array), Found(&array));
+
+  EXPECT_TRUE(Found(nullptr).empty());
+}
+
+TEST_F(EdsFilterIndexTest, RemovedSubscriptionIsNotFound) {
+  std::vector<SaEvtEventFilterT> prefix{Filter(SA_EVT_PREFIX_FILTER, "ab")};
+  std::vector<SaEvtEventFilterT> exact{Filter(SA_EVT_EXACT_FILTER, "ab")};
+
+  Subscription *first = Add(1, &prefix);
+  Subscription *second = Add(1, &prefix);
+  Subscription *third = Add(1, &exact);
+
+  std::vector<SaEvtEventPatternT> patterns{Pattern("ab")};
+  SaEvtEventPatternArrayT array = {1, 1, &patterns[0]};
+  EXPECT_EQ(3U, Found(&array).size());
+
+  Remove(second);
+  EXPECT_EQ((std::vector<SUBSC_REC *>{&first->rec, &third->rec}),
+            Found(&array));
+  Remove(third);
+  EXPECT_EQ(std::vector<SUBSC_REC *>{&first->rec}, Found(&array));
+  Remove(first);
+  EXPECT_TRUE(Found(&array).empty());
+  // The index is empty again and can be reused
+  EXPECT_EQ(0U, index_.num_keys);
+  Add(1, &exact);
+  EXPECT_EQ(1U, Found(&array).size());
+}
+
+TEST_F(EdsFilterIndexTest, MatchesPatternMatchOnRandomFilters) {
+  for (uint32_t seed = 1; seed <= 20; seed++) {
+    std::mt19937 rng(seed);
+    auto random = [&rng](uint32_t n) {
+      return std::uniform_int_distribution<uint32_t>(0, n - 1)(rng);
+    };
+    // Short strings of few letters, so that filters often hit
+    auto random_string = [&random]() {
+      std::string str(random(4), 'a');
+      for (char &c : str) c = "ab"[random(2)];
+      return str;
+    };
+
+    for (uint32_t step = 0; step < 500; step++) {
+      SCOPED_TRACE("seed " + std::to_string(seed) + " step " +
+                   std::to_string(step));
+      uint32_t op = random(100);
+
+      if (op < 35 && subs_.size() < 64) {
+        std::vector<SaEvtEventFilterT> filters(random(5));
+        for (auto &filter : filters) {
+          // Mostly known filter types, sometimes an unknown one
+          int type = (random(40) == 0) ? 5 : SA_EVT_PREFIX_FILTER + random(4);
+          filter = Filter(type, random_string());
+        }
+        Add(1 + random(4), (random(30) == 0) ? nullptr : &filters);
+      } else if (op < 50 && !subs_.empty()) {
+        auto it = subs_.begin();
+        std::advance(it, random(subs_.size()));
+        Remove(it->get());
+      } else {
+        std::vector<SaEvtEventPatternT> patterns(random(6));
+        for (auto &pattern : patterns) pattern = Pattern(random_string());
+        SaEvtEventPatternArrayT array;
+        array.allocatedNumber = patterns.size();
+        array.patternsNumber = patterns.size();
+        array.patterns = patterns.empty() ? nullptr : &patterns[0];
+        ASSERT_EQ(Expected(&array), Found(&array));
+      }
+    }
+
+    eds_filter_index_destroy(&index_);
+    for (auto &sub : subs_) ASSERT_EQ(nullptr, sub->rec.fidx);
+    subs_.clear();
+    bytes_.clear();
+  }
+}
@@ -1587,6 +1587,118 @@ SaAisErrorT saImmOmCcbObjectCreate_o3(SaImmCcbHandleT ccbHandle,
 	return ccb_object_create_common(ccbHandle, className, NULL, objectName, attrValues);
 }
 
+/****************************************************************************
+  Name          :  imma_objCreate_attrValues
+
+  Description   :  Converts the initial attribute values of an object create
+                   to the list sent to the IMMND, checking them on the way.
+                   Used by ccb_object_create_common and immsv_load.
+
+  Arguments     :  attrList - The list, converted attributes are pushed on
+                              its front. Left for the caller to free also
+                              when an error is returned.
+                   attrValues - Initial values for some attributes.
+
+  Return Values :  SA_AIS_OK or SA_AIS_ERR_INVALID_PARAM.
+******************************************************************************/
+static SaAisErrorT imma_objCreate_attrValues(IMMSV_ATTR_VALUES_LIST **attrList,
+				     const SaImmAttrValuesT_2 **attrValues)
+{
+	const SaImmAttrValuesT_2 *attr;
+	int i;
+
+	for (i = 0; attrValues[i]; ++i) {
+		attr = attrValues[i];
+		TRACE("attr:%s \n", attr->attrName);
+
+		/* Prevent duplicate attribute assignments */
+		IMMSV_ATTR_VALUES_LIST *p = *attrList;
+		while(p!= NULL) {
+			if(strcmp(attr->attrName, p->n.attrName.buf) == 0) {
+				TRACE_2("ERR_INVALID_PARAM: Attribute %s occurs multiple times "
+					"in attrValues parameter", attr->attrName);
+				return SA_AIS_ERR_INVALID_PARAM;
+			}
+			p = p->next;
+		}
+
+		/*Check that the user does not set value for System attributes. */
+
+		if (strcmp(attr->attrName, sysaClName) == 0) {
+			if (immOmIsLoader) {
+				/*I am loader => will allow the classname attribute to be defaulted */
+				continue;
+			}
+			/*Non loaders are not allowed to explicitly assign className attribute */
+			TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s ", sysaClName);
+			return SA_AIS_ERR_INVALID_PARAM;
+		} else if (strcmp(attr->attrName, sysaAdmName) == 0) {
+			if (immOmIsLoader) {
+				/*Loader => clear admName attribute, not others */
+				/*This is controversial! The standard is not explicit on this. */
+				/* Removing curent admin owner name allows the imm to set IMMLOADER */
+				continue;
+			}
+			TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s", sysaAdmName);
+			return SA_AIS_ERR_INVALID_PARAM;
+		} else if ((strcmp(attr->attrName, sysaImplName) == 0) && (!immOmIsLoader)) {
+			/*Loader allowed to explicitly assign implName attribute, not others
+			   The only point of allowing this is that a class/object implementer
+			   set with identical implementer name may be faster after cluster
+			   restart because ImmAttrValue::setValueC_st checks for equality
+			   before overwrite.
+			 */
+
+			TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s", sysaImplName);
+			return SA_AIS_ERR_INVALID_PARAM;
+		} else if (attr->attrValuesNumber == 0) {
+			TRACE("CcbObjectCreate ignoring attribute %s with no values", attr->attrName);
+			continue;
+		}
+
+		if (strlen(attr->attrName) + 1 >= IMMSV_MAX_ATTR_NAME_LENGTH) {
+			TRACE_2("ERR_INVALID_PARAM: Attribute name too long");
+			return SA_AIS_ERR_INVALID_PARAM;
+		}
+
+		/*alloc-3 */
+		p = calloc(1, sizeof(IMMSV_ATTR_VALUES_LIST));
+
+		p->n.attrName.size = strlen(attr->attrName) + 1;
+
+		/*alloc-4 */
+		p->n.attrName.buf = malloc(p->n.attrName.size);
+
+		strncpy(p->n.attrName.buf, attr->attrName, p->n.attrName.size);
+
+		p->n.attrValuesNumber = attr->attrValuesNumber;
+		p->n.attrValueType = attr->attrValueType;
+
+		const SaImmAttrValueT *avarr = attr->attrValues;
+		/*alloc-5 */
+		imma_copyAttrValue(&(p->n.attrValue), attr->attrValueType, avarr[0]);
+
+		if (attr->attrValuesNumber > 1) {
+			unsigned int numAdded = attr->attrValuesNumber - 1;
+			unsigned int j;
+			for (j = 1; j <= numAdded; ++j) {
+				/*alloc-6 */
+				IMMSV_EDU_ATTR_VAL_LIST *al = calloc(1, sizeof(IMMSV_EDU_ATTR_VAL_LIST));
+
+				/*alloc-7 */
+				imma_copyAttrValue(&(al->n), attr->attrValueType, avarr[j]);
+				al->next = p->n.attrMoreValues;
+				p->n.attrMoreValues = al;
+			}
+		}
+
+		p->next = *attrList;	/*NULL initially. */
+		*attrList = p;
+	}
+
+	return SA_AIS_OK;
+}
+
 static SaAisErrorT ccb_object_create_common(SaImmCcbHandleT ccbHandle,
 				     const SaImmClassNameT className,
 				     const SaNameT *parentName,
@@ -1876,101 +1988,9 @@ static SaAisErrorT ccb_object_create_common(SaImmCcbHandleT ccbHandle,
 
 	osafassert(evt.info.immnd.info.objCreate.attrValues == NULL);
 	if(attrValues) {
-		const SaImmAttrValuesT_2 *attr;
-		int i;
-		for (i = 0; attrValues[i]; ++i) {
-			attr = attrValues[i];
-			TRACE("attr:%s \n", attr->attrName);
-
-			/* Prevent duplicate attribute assignments */
-			IMMSV_ATTR_VALUES_LIST *p = evt.info.immnd.info.objCreate.attrValues;
-			while(p!= NULL) {
-				if(strcmp(attr->attrName, p->n.attrName.buf) == 0) {
-					rc = SA_AIS_ERR_INVALID_PARAM;
-					TRACE_2("ERR_INVALID_PARAM: Attribute %s occurs multiple times "
-						"in attrValues parameter", attr->attrName);
-					goto mds_send_fail;
-				}
-				p = p->next;
-			}
-
-			/*Check that the user does not set value for System attributes. */
-
-			if (strcmp(attr->attrName, sysaClName) == 0) {
-				if (immOmIsLoader) {
-					/*I am loader => will allow the classname attribute to be defaulted */
-					continue;
-				}
-				/*Non loaders are not allowed to explicitly assign className attribute */
-				rc = SA_AIS_ERR_INVALID_PARAM;
-				TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s ", sysaClName);
-				goto mds_send_fail;
-			} else if (strcmp(attr->attrName, sysaAdmName) == 0) {
-				if (immOmIsLoader) {
-					/*Loader => clear admName attribute, not others */
-					/*This is controversial! The standard is not explicit on this. */
-					/* Removing curent admin owner name allows the imm to set IMMLOADER */
-					continue;
-				}
-				rc = SA_AIS_ERR_INVALID_PARAM;
-				TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s", sysaAdmName);
-				goto mds_send_fail;
-			} else if ((strcmp(attr->attrName, sysaImplName) == 0) && (!immOmIsLoader)) {
-				/*Loader allowed to explicitly assign implName attribute, not others
-				   The only point of allowing this is that a class/object implementer
-				   set with identical implementer name may be faster after cluster
-				   restart because ImmAttrValue::setValueC_st checks for equality
-				   before overwrite.
-				 */
-
-				rc = SA_AIS_ERR_INVALID_PARAM;
-				TRACE_2("ERR_INVALID_PARAM: Not allowed to set attribute %s", sysaImplName);
-				goto mds_send_fail;
-			} else if (attr->attrValuesNumber == 0) {
-				TRACE("CcbObjectCreate ignoring attribute %s with no values", attr->attrName);
-				continue;
-			}
-
-			/*alloc-3 */
-			p = calloc(1, sizeof(IMMSV_ATTR_VALUES_LIST));
-
-			p->n.attrName.size = strlen(attr->attrName) + 1;
-			if (p->n.attrName.size >= IMMSV_MAX_ATTR_NAME_LENGTH) {
-				TRACE_2("ERR_INVALID_PARAM: Attribute name too long");
-				rc = SA_AIS_ERR_INVALID_PARAM;
-				free(p);
-				p=NULL;
-				goto mds_send_fail;
-			}
-
-			/*alloc-4 */
-			p->n.attrName.buf = malloc(p->n.attrName.size);
-
-			strncpy(p->n.attrName.buf, attr->attrName, p->n.attrName.size);
-
-			p->n.attrValuesNumber = attr->attrValuesNumber;
-			p->n.attrValueType = attr->attrValueType;
-
-			const SaImmAttrValueT *avarr = attr->attrValues;
-			/*alloc-5 */
-			imma_copyAttrValue(&(p->n.attrValue), attr->attrValueType, avarr[0]);
-
-			if (attr->attrValuesNumber > 1) {
-				unsigned int numAdded = attr->attrValuesNumber - 1;
-				unsigned int i;
-				for (i = 1; i <= numAdded; ++i) {
-					/*alloc-6 */
-					IMMSV_EDU_ATTR_VAL_LIST *al = calloc(1, sizeof(IMMSV_EDU_ATTR_VAL_LIST));
-
-					/*alloc-7 */
-					imma_copyAttrValue(&(al->n), attr->attrValueType, avarr[i]);
-					al->next = p->n.attrMoreValues;
-					p->n.attrMoreValues = al;
-				}
-			}
-
-			p->next = evt.info.immnd.info.objCreate.attrValues;	/*NULL initially. */
-			evt.info.immnd.info.objCreate.attrValues = p;
+		rc = imma_objCreate_attrValues(&evt.info.immnd.info.objCreate.attrValues, attrValues);
+		if (rc != SA_AIS_OK) {
+			goto mds_send_fail;
 		}
 	}
 
@@ -6833,6 +6853,299 @@ SaAisErrorT immsv_sync(SaImmHandleT immHandle, const SaImmClassNameT className,
 	return rc;
 }
 
+/* Frees a batch of objects built by immsv_load. */
+static void imma_free_load_batch(IMMSV_OM_OBJECT_SYNC *batch)
+{
+	while (batch) {
+		IMMSV_OM_OBJECT_SYNC *obj = batch;
+		batch = obj->next;
+		free(obj->className.buf);
+		free(obj->objectName.buf);
+		immsv_free_attrvalues_list(obj->attrValues);
+		free(obj);
+	}
+}
+
+static IMMSV_OM_OBJECT_SYNC *imma_reverse_load_batch(IMMSV_OM_OBJECT_SYNC *batch)
+{
+	IMMSV_OM_OBJECT_SYNC *reversed = NULL;
+	while (batch) {
+		IMMSV_OM_OBJECT_SYNC *obj = batch;
+		batch = obj->next;
+		obj->next = reversed;
+		reversed = obj;
+	}
+	return reversed;
+}
+
+/* Converts one object for immsv_load, with the checks of
+   ccb_object_create_common. */
+static SaAisErrorT imma_load_obj_fill(IMMSV_OM_OBJECT_SYNC *obj,
+	const SaImmClassNameT className, const SaNameT *parentName,
+	const SaImmAttrValuesT_2 **attrValues)
+{
+	size_t parentNameLength = 0;
+
+	if (parentName) {
+		if (!osaf_is_extended_name_valid(parentName)) {
+			TRACE_2("ERR_INVALID_PARAM: Parent name invalid");
+			return SA_AIS_ERR_INVALID_PARAM;
+		}
+		parentNameLength = osaf_extended_name_length(parentName);
+	}
+
+	obj->className.size = strlen(className) + 1;
+	obj->className.buf = malloc(obj->className.size);
+	memcpy(obj->className.buf, className, obj->className.size);
+
+	if (parentNameLength > 0) {
+		obj->objectName.size = parentNameLength + 1;
+		obj->objectName.buf = malloc(obj->objectName.size);
+		memcpy(obj->objectName.buf, osaf_extended_name_borrow(parentName), parentNameLength);
+		obj->objectName.buf[parentNameLength] = '\0';
+	}
+
+	return imma_objCreate_attrValues(&obj->attrValues, attrValues);
+}
+
+/* Set when the IMMND rejects IMMND_EVT_A2ND_OBJ_LOAD because not all IMMNDs
+   are known to support it. The loader then falls back to regular object
+   creates for the rest of the loading. */
+static bool imma_load_per_object = false;
+
+/* Sends the objects of a batch to the IMMND. The whole batch is sent in one
+   IMMND_EVT_A2ND_OBJ_LOAD, or only the first object is sent as a regular
+   object create when imma_load_per_object is set. The objects sent are
+   removed from *batchp. */
+static SaAisErrorT imma_load_send(IMMA_CB *cb, SaImmCcbHandleT ccbHandle,
+	IMMSV_OM_OBJECT_SYNC **batchp)
+{
+	SaAisErrorT rc = SA_AIS_OK;
+	IMMSV_EVT evt;
+	IMMSV_EVT *out_evt = NULL;
+	IMMA_CLIENT_NODE *cl_node = NULL;
+	IMMA_CCB_NODE *ccb_node = NULL;
+	IMMA_ADMIN_OWNER_NODE *ao_node = NULL;
+	IMMSV_OM_OBJECT_SYNC *batch = *batchp;
+	SaImmHandleT immHandle = 0LL;
+	bool locked = false;
+
+	if (m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+		rc = SA_AIS_ERR_LIBRARY;
+		TRACE_4("ERR_LIBRARY: Lock failed");
+		goto done;
+	}
+	locked = true;
+
+	imma_ccb_node_get(&cb->ccb_tree, &ccbHandle, &ccb_node);
+	if (!ccb_node) {
+		rc = SA_AIS_ERR_BAD_HANDLE;
+		TRACE_2("ERR_BAD_HANDLE: Ccb handle not valid");
+		goto done;
+	}
+
+	if (ccb_node->mExclusive) {
+		rc = SA_AIS_ERR_TRY_AGAIN;
+		TRACE_3("ERR_TRY_AGAIN: Ccb-id %u being created or in critical phase, in another thread",
+			ccb_node->mCcbId);
+		goto done;
+	}
+
+	if (ccb_node->mAborted || ccb_node->mApplied) {
+		/* Loading is done in one ccb, never continued with a new ccb-id. */
+		rc = SA_AIS_ERR_FAILED_OPERATION;
+		TRACE_2("ERR_FAILED_OPERATION: CCB %u is aborted or applied", ccb_node->mCcbId);
+		goto done;
+	}
+
+	immHandle = ccb_node->mImmHandle;
+	imma_client_node_get(&cb->client_tree, &immHandle, &cl_node);
+	if (!(cl_node && cl_node->isOm)) {
+		rc = SA_AIS_ERR_LIBRARY;
+		TRACE_4("ERR_LIBRARY: SaImmHandleT associated with Ccb is not valid");
+		goto done;
+	}
+
+	if (cl_node->stale) {
+		/* Dont bother resurrecting, the loading ccb is lost anyway. */
+		TRACE_3("ERR_BAD_HANDLE: IMM Handle %llx is stale", immHandle);
+		rc = SA_AIS_ERR_BAD_HANDLE;
+		goto done;
+	}
+
+	imma_admin_owner_node_get(&cb->admin_owner_tree, &(ccb_node->mAdminOwnerHdl), &ao_node);
+	if (!ao_node) {
+		rc = SA_AIS_ERR_LIBRARY;
+		TRACE_4("ERR_LIBRARY: No Amin-Owner associated with Ccb");
+		goto done;
+	}
+
+	/* Borrows the objects, they are freed by the caller. */
+	memset(&evt, 0, sizeof(IMMSV_EVT));
+	evt.type = IMMSV_EVT_TYPE_IMMND;
+	if (imma_load_per_object) {
+		evt.info.immnd.type = IMMND_EVT_A2ND_OBJ_CREATE;
+		evt.info.immnd.info.objCreate.ccbId = ccb_node->mCcbId;
+		evt.info.immnd.info.objCreate.adminOwnerId = ao_node->mAdminOwnerId;
+		evt.info.immnd.info.objCreate.className = batch->className;
+		evt.info.immnd.info.objCreate.parentOrObjectDn = batch->objectName;
+		evt.info.immnd.info.objCreate.attrValues = batch->attrValues;
+	} else {
+		evt.info.immnd.type = IMMND_EVT_A2ND_OBJ_LOAD;
+		evt.info.immnd.info.objLoad.ccbId = ccb_node->mCcbId;
+		evt.info.immnd.info.objLoad.adminOwnerId = ao_node->mAdminOwnerId;
+		evt.info.immnd.info.objLoad.objects = *batch;
+	}
+	ccb_node = NULL;
+	ao_node = NULL;
+
+	if((rc = imma_proc_increment_pending_reply(cl_node, true)) != SA_AIS_OK) {
+		TRACE_4("ERR_LIBRARY: Overlapping use of IMM handle by multiple threads");
+		goto done;
+	}
+
+	rc = imma_evt_fake_evs(cb, &evt, &out_evt, cl_node->syncr_timeout, cl_node->handle, &locked, false);
+	cl_node = NULL;
+
+	if (out_evt) {
+		osafassert(out_evt->type == IMMSV_EVT_TYPE_IMMA);
+		osafassert((out_evt->info.imma.type == IMMA_EVT_ND2A_IMM_ERROR) ||
+			(out_evt->info.imma.type == IMMA_EVT_ND2A_IMM_ERROR_2));
+		if (rc == SA_AIS_OK) {
+			rc = out_evt->info.imma.info.errRsp.error;
+		}
+		if (out_evt->info.imma.type == IMMA_EVT_ND2A_IMM_ERROR_2) {
+			immsv_evt_free_attrNames(out_evt->info.imma.info.errRsp.errStrings);
+		}
+		free(out_evt);
+		out_evt = NULL;
+	}
+
+	if (!locked && m_NCS_LOCK(&cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS) {
+		TRACE_4("ERR_LIBRARY: Lock failed");
+		rc = SA_AIS_ERR_LIBRARY;
+		goto done;
+	}
+	locked = true;
+
+	imma_client_node_get(&cb->client_tree, &immHandle, &cl_node);
+	if (cl_node && cl_node->isOm) {
+		imma_proc_decrement_pending_reply(cl_node, true);
+	} else if (rc == SA_AIS_OK) {
+		TRACE_3("ERR_BAD_HANDLE: client_node gone on return from down-call");
+		rc = SA_AIS_ERR_BAD_HANDLE;
+	}
+
+ done:
+	if (locked) {
+		m_NCS_UNLOCK(&cb->cb_lock, NCS_LOCK_WRITE);
+	}
+
+	if (rc == SA_AIS_OK) {
+		if (imma_load_per_object) {
+			(*batchp) = batch->next;
+			batch->next = NULL;
+		} else {
+			(*batchp) = NULL;
+		}
+		imma_free_load_batch(batch);
+	}
+
+	return rc;
+}
+
+SaAisErrorT immsv_load(SaImmCcbHandleT ccbHandle, const SaImmClassNameT className,
+	const SaNameT *parentName, const SaImmAttrValuesT_2 **attrValues, void** batchp,
+	int* remainingSpacep, int objsInBatch)
+{
+	SaAisErrorT rc = SA_AIS_OK;
+	IMMA_CB *cb = &imma_cb;
+	IMMSV_OM_OBJECT_SYNC *batch = NULL;
+	TRACE_ENTER2("remainingSpace %d objsInBatch:%u", *remainingSpacep, objsInBatch);
+
+	if (cb->sv_id == 0) {
+		TRACE_2("ERR_BAD_HANDLE: No initialized handle exists!");
+		return SA_AIS_ERR_BAD_HANDLE;
+	}
+
+	if (!immOmIsLoader) {
+		TRACE_2("ERR_BAD_OPERATION: immsv_load is only allowed for the loader");
+		return SA_AIS_ERR_BAD_OPERATION;
+	}
+
+	osafassert(batchp && remainingSpacep);
+	batch = (*(IMMSV_OM_OBJECT_SYNC **)batchp);
+
+	if (attrValues) {
+		IMMSV_OM_OBJECT_SYNC *obj = NULL;
+
+		if (className == NULL) {
+			TRACE_2("ERR_INVALID_PARAM: classname is NULL");
+			TRACE_LEAVE();
+			return SA_AIS_ERR_INVALID_PARAM;
+		}
+
+		obj = calloc(1, sizeof(IMMSV_OM_OBJECT_SYNC));
+		rc = imma_load_obj_fill(obj, className, parentName, attrValues);
+		if (rc != SA_AIS_OK) {
+			/* The batch is left as it was. */
+			imma_free_load_batch(obj);
+			TRACE_LEAVE();
+			return rc;
+		}
+
+		obj->next = batch;
+		batch = obj;
+		(*batchp) = batch;
+
+		if (objsInBatch >= (IMMSV_MAX_OBJS_IN_SYNCBATCH - 1)) {
+			TRACE("Limit for # of objects in batch reached: %d", objsInBatch);
+			(*remainingSpacep) = 0;
+		} else {
+			(*remainingSpacep) -= get_obj_size(obj);
+		}
+
+		if ((*remainingSpacep) > 0) {
+			TRACE_LEAVE();
+			return SA_AIS_ERR_NOT_READY; /* Not an error, flags object was buffered */
+		}
+	}
+
+	if (batch == NULL) {
+		TRACE_LEAVE();
+		return SA_AIS_OK;
+	}
+
+	/* Objects are pushed on the front of the batch, send them in the
+	   order they were added. */
+	batch = imma_reverse_load_batch(batch);
+
+	while (batch) {
+		rc = imma_load_send(cb, ccbHandle, &batch);
+		if ((rc == SA_AIS_ERR_VERSION) && !imma_load_per_object) {
+			LOG_NO("Bulk loading of objects not allowed by IMMND, "
+				"loading one object at a time");
+			imma_load_per_object = true;
+			continue;
+		}
+		if (rc != SA_AIS_OK) {
+			break;
+		}
+	}
+
+	if (rc == SA_AIS_ERR_TRY_AGAIN) {
+		/* Keep the objects not sent yet for a re-send. */
+		(*batchp) = imma_reverse_load_batch(batch);
+	} else {
+		imma_free_load_batch(batch);
+		(*batchp) = NULL;
+		(*remainingSpacep) = 0;
+	}
+
+	TRACE_LEAVE();
+	return rc;
+}
+
 SaAisErrorT immsv_finalize_sync(SaImmHandleT immHandle)
 {
 	SaAisErrorT rc = SA_AIS_OK;
@@ -0,0 +1,282 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "imm/agent/imma.h"
+#include "imm/immsv_api.h"
+#include "base/osaf_extended_name.h"
+}
+
+namespace {
+
+// What the fake IMMND below has received and how it answers
+struct FakeImmnd {
+  // Answer IMMND_EVT_A2ND_OBJ_LOAD with SA_AIS_ERR_VERSION, as an IMMND
+  // does when the IMMD has not allowed bulk loading
+  bool reject_obj_load = false;
+  // The parent name of every object received, in the order received
+  std::vector<std::string> objects;
+  // The number of IMMND_EVT_A2ND_OBJ_LOAD and IMMND_EVT_A2ND_OBJ_CREATE
+  // received, rejected ones included
+  int obj_loads = 0;
+  int obj_creates = 0;
+};
+
+FakeImmnd immnd;
+
+std::string ParentName(const IMMSV_OM_OBJECT_SYNC &obj) {
+  return (obj.objectName.buf != nullptr) ? obj.objectName.buf : "";
+}
+
+void FreeObject(IMMSV_OM_OBJECT_SYNC *obj) {
+  free(obj->className.buf);
+  free(obj->objectName.buf);
+  immsv_free_attrvalues_list(obj->attrValues);
+}
+
+// Handles an event sent over fevs and returns the error to reply with
+SaAisErrorT FakeFevs(const IMMSV_FEVS &fevs) {
+  NCS_UBAID uba;
+  IMMSV_EVT evt;
+  SaAisErrorT error = SA_AIS_OK;
+
+  EXPECT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space_pp(&uba, 0, 0));
+  EXPECT_EQ(NCSCC_RC_SUCCESS,
+            ncs_encode_n_octets_in_uba(&uba,
+                                       reinterpret_cast<uint8_t *>(fevs.msg.buf),
+                                       fevs.msg.size));
+  ncs_dec_init_space(&uba, uba.start);
+  uba.bufp = nullptr;
+  memset(&evt, 0, sizeof(evt));
+  EXPECT_EQ(NCSCC_RC_SUCCESS, immsv_evt_dec(&uba, &evt));
+  if (uba.start) m_MMGR_FREE_BUFR_LIST(uba.start);
+
+  if (evt.info.immnd.type == IMMND_EVT_A2ND_OBJ_CREATE) {
+    IMMSV_OM_CCB_OBJECT_CREATE *req = &evt.info.immnd.info.objCreate;
+    immnd.obj_creates++;
+    immnd.objects.push_back(
+        (req->parentOrObjectDn.buf != nullptr) ? req->parentOrObjectDn.buf
+                                               : "");
+    free(req->className.buf);
+    free(req->parentOrObjectDn.buf);
+    immsv_free_attrvalues_list(req->attrValues);
+  } else if (evt.info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD) {
+    IMMSV_OM_OBJECT_SYNC *obj = &evt.info.immnd.info.objLoad.objects;
+    IMMSV_OM_OBJECT_SYNC *next = obj->next;
+    immnd.obj_loads++;
+    if (immnd.reject_obj_load) {
+      error = SA_AIS_ERR_VERSION;
+    } else {
+      immnd.objects.push_back(ParentName(*obj));
+    }
+    FreeObject(obj);
+    while (next != nullptr) {
+      obj = next;
+      next = obj->next;
+      if (!immnd.reject_obj_load) immnd.objects.push_back(ParentName(*obj));
+      FreeObject(obj);
+      free(obj);
+    }
+  } else {
+    ADD_FAILURE() << "Unexpected fevs event " << evt.info.immnd.type;
+  }
+
+  return error;
+}
+
+}  // namespace
+
+// The MDS interface of the agent, replaced by a local IMMND that answers
+// what the loader sends
+extern "C" {
+
+const char *imma_sockname = "/nonexistent/immnd.sock";
+
+unsigned int ncs_agents_startup(void) { return NCSCC_RC_SUCCESS; }
+
+unsigned int ncs_agents_shutdown(void) { return NCSCC_RC_SUCCESS; }
+
+uint32_t imma_mds_register(IMMA_CB *cb) {
+  cb->immnd_mds_dest = 1;
+  cb->is_immnd_up = true;
+  return NCSCC_RC_SUCCESS;
+}
+
+void imma_mds_unregister(IMMA_CB *cb) { cb->is_immnd_up = false; }
+
+uint32_t imma_mds_callback(struct ncsmds_callback_info *info) {
+  return NCSCC_RC_SUCCESS;
+}
+
+uint32_t imma_mds_msg_send(uint32_t imma_mds_hdl, MDS_DEST *destination,
+                           IMMSV_EVT *i_evt, uint32_t to_svc) {
+  return NCSCC_RC_SUCCESS;
+}
+
+uint32_t imma_mds_msg_sync_send(uint32_t imma_mds_hdl, MDS_DEST *destination,
+                                IMMSV_EVT *i_evt, IMMSV_EVT **o_evt,
+                                SaTimeT timeout) {
+  IMMSV_EVT *rsp = static_cast<IMMSV_EVT *>(calloc(1, sizeof(IMMSV_EVT)));
+  rsp->type = IMMSV_EVT_TYPE_IMMA;
+
+  switch (i_evt->info.immnd.type) {
+    case IMMND_EVT_A2ND_IMM_INIT:
+      rsp->info.imma.type = IMMA_EVT_ND2A_IMM_INIT_RSP;
+      rsp->info.imma.info.initRsp.error = SA_AIS_OK;
+      rsp->info.imma.info.initRsp.immHandle = 0x100000001ULL;
+      break;
+    case IMMND_EVT_A2ND_IMM_ADMINIT:
+      rsp->info.imma.type = IMMA_EVT_ND2A_IMM_ADMINIT_RSP;
+      rsp->info.imma.info.admInitRsp.error = SA_AIS_OK;
+      rsp->info.imma.info.admInitRsp.ownerId = 1;
+      break;
+    case IMMND_EVT_A2ND_CCBINIT:
+      rsp->info.imma.type = IMMA_EVT_ND2A_CCBINIT_RSP;
+      rsp->info.imma.info.ccbInitRsp.error = SA_AIS_OK;
+      rsp->info.imma.info.ccbInitRsp.ccbId = 1;
+      break;
+    case IMMND_EVT_A2ND_IMM_FEVS:
+      rsp->info.imma.type = IMMA_EVT_ND2A_IMM_ERROR;
+      rsp->info.imma.info.errRsp.error =
+          FakeFevs(i_evt->info.immnd.info.fevsReq);
+      break;
+    default:
+      rsp->info.imma.type = IMMA_EVT_ND2A_IMM_ERROR;
+      rsp->info.imma.info.errRsp.error = SA_AIS_OK;
+      break;
+  }
+
+  *o_evt = rsp;
+  return NCSCC_RC_SUCCESS;
+}
+
+}  // extern "C"
+
+// The fixture for loading objects as the loader does, with a loading ccb
+// started by a regular object create
+class ImmaLoadTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    SaVersionT version = {'A', 2, 11};
+    immnd = FakeImmnd();
+    ASSERT_EQ(SA_AIS_OK, saImmOmInitialize(&imm_handle_, nullptr, &version));
+    ASSERT_EQ(SA_AIS_OK,
+              saImmOmAdminOwnerInitialize(
+                  imm_handle_, const_cast<char *>(IMMSV_LOADERNAME), SA_TRUE,
+                  &owner_handle_));
+    ASSERT_EQ(SA_AIS_OK, saImmOmCcbInitialize(owner_handle_, 0, &ccb_handle_));
+    ASSERT_EQ(SA_AIS_OK, Create("first"));
+    ASSERT_EQ(1, immnd.obj_creates);
+    immnd = FakeImmnd();
+  }
+
+  virtual void TearDown() {
+    EXPECT_EQ(nullptr, batch_);
+    EXPECT_EQ(SA_AIS_OK, saImmOmFinalize(imm_handle_));
+  }
+
+  const SaImmAttrValuesT_2 **AttrValues(const char *rdn) {
+    rdn_ = const_cast<char *>(rdn);
+    rdn_value_ = &rdn_;
+    attr_.attrName = const_cast<char *>("rdn");
+    attr_.attrValueType = SA_IMM_ATTR_SASTRINGT;
+    attr_.attrValuesNumber = 1;
+    attr_.attrValues = reinterpret_cast<SaImmAttrValueT *>(&rdn_value_);
+    attr_values_[0] = &attr_;
+    attr_values_[1] = nullptr;
+    return attr_values_;
+  }
+
+  SaAisErrorT Create(const char *parent) {
+    SaNameT parent_name;
+    osaf_extended_name_lend(parent, &parent_name);
+    return saImmOmCcbObjectCreate_2(ccb_handle_, const_cast<char *>("Class"),
+                                    &parent_name, AttrValues("rdn=1"));
+  }
+
+  // Adds an object to the batch as the loader does
+  SaAisErrorT Load(const char *parent) {
+    SaNameT parent_name;
+    osaf_extended_name_lend(parent, &parent_name);
+    SaAisErrorT rc = immsv_load(ccb_handle_, const_cast<char *>("Class"),
+                                &parent_name, AttrValues("rdn=1"), &batch_,
+                                &remaining_space_, objs_in_batch_ + 1);
+    if (rc == SA_AIS_ERR_NOT_READY) objs_in_batch_++;
+    return rc;
+  }
+
+  // Sends the objects in the batch
+  SaAisErrorT Flush() {
+    SaAisErrorT rc = immsv_load(ccb_handle_, nullptr, nullptr, nullptr,
+                                &batch_, &remaining_space_, objs_in_batch_);
+    remaining_space_ = IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE;
+    objs_in_batch_ = 0;
+    return rc;
+  }
+
+  SaImmHandleT imm_handle_ = 0;
+  SaImmAdminOwnerHandleT owner_handle_ = 0;
+  SaImmCcbHandleT ccb_handle_ = 0;
+  void *batch_ = nullptr;
+  int remaining_space_ = IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE;
+  int objs_in_batch_ = 0;
+  char *rdn_ = nullptr;
+  char **rdn_value_ = nullptr;
+  SaImmAttrValuesT_2 attr_;
+  const SaImmAttrValuesT_2 *attr_values_[2];
+};
+
+// The fallback to object creates lasts for the rest of the process, as it
+// does for the loader, so both cases are in one test
+TEST_F(ImmaLoadTest, FallsBackToObjectCreateWhenObjLoadIsRejected) {
+  // Allowed by the IMMD, the batch is sent in one IMMND_EVT_A2ND_OBJ_LOAD
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("a"));
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("b"));
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("c"));
+  EXPECT_EQ(0, immnd.obj_loads);
+  ASSERT_EQ(SA_AIS_OK, Flush());
+  EXPECT_EQ(1, immnd.obj_loads);
+  EXPECT_EQ(0, immnd.obj_creates);
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "c"}), immnd.objects);
+
+  // Not allowed by the IMMD, a down-level IMMND takes part in the loading.
+  // Every object of the rejected batch is sent once, in order, as a
+  // regular object create.
+  immnd = FakeImmnd();
+  immnd.reject_obj_load = true;
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("d"));
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("e"));
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("f"));
+  ASSERT_EQ(SA_AIS_OK, Flush());
+  EXPECT_EQ(1, immnd.obj_loads);
+  EXPECT_EQ(3, immnd.obj_creates);
+  EXPECT_EQ((std::vector<std::string>{"d", "e", "f"}), immnd.objects);
+
+  // Later batches go straight to object creates
+  immnd = FakeImmnd();
+  immnd.reject_obj_load = true;
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("g"));
+  EXPECT_EQ(SA_AIS_ERR_NOT_READY, Load("h"));
+  ASSERT_EQ(SA_AIS_OK, Flush());
+  EXPECT_EQ(0, immnd.obj_loads);
+  EXPECT_EQ(2, immnd.obj_creates);
+  EXPECT_EQ((std::vector<std::string>{"g", "h"}), immnd.objects);
+}
@@ -60,6 +60,7 @@ typedef struct immd_immnd_info_node {
 	bool isCoord;
 	bool syncStarted;
 	bool pbeConfigured; /* Pbe-file-name configured. Pbe may still be disabled. */
+	MDS_SVC_PVT_SUB_PART_VER mdsVersion; /* Of the IMMND, 0 until its MDS up event */
 } IMMD_IMMND_INFO_NODE;
 
 typedef struct immd_immnd_detached_node { /* IMMD SBY tracking of departed payload */
@@ -180,5 +181,6 @@ uint32_t immd_mds_change_role(IMMD_CB *cb);
 void immd_proc_immd_reset(IMMD_CB *cb, bool active);
 
 uint32_t immd_immnd_info_node_cardinality(NCS_PATRICIA_TREE *immnd_tree);
+bool immd_immnd_info_obj_load_allowed(NCS_PATRICIA_TREE *immnd_tree);
 
 #endif  // IMM_IMMD_IMMD_CB_H_
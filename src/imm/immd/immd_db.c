@@ -411,3 +411,37 @@ uint32_t immd_immnd_info_node_cardinality(NCS_PATRICIA_TREE *immnd_tree)
 {
 	return 	ncs_patricia_tree_size(immnd_tree);
 }
+
+/****************************************************************************
+  Name          : immd_immnd_info_obj_load_allowed
+  Description   : Checks if the loader may send objects in bulk
+                  (IMMND_EVT_A2ND_OBJ_LOAD), which requires that every known
+                  IMMND handles the message. An IMMND whose MDS version is
+                  not known yet counts as one that does not.
+  Arguments     : immnd_tree - IMMND Tree.
+  Return Values : true/false
+*****************************************************************************/
+bool immd_immnd_info_obj_load_allowed(NCS_PATRICIA_TREE *immnd_tree)
+{
+	IMMD_IMMND_INFO_NODE *immnd_info_node;
+	NODE_ID key;
+	bool allowed = false;
+
+	memset(&key, 0, sizeof(NODE_ID));
+
+	immnd_info_node = (IMMD_IMMND_INFO_NODE *)
+	    ncs_patricia_tree_getnext(immnd_tree, (uint8_t *)&key);
+	while (immnd_info_node) {
+		if (immnd_info_node->mdsVersion < IMMSV_IMMND_MDS_VER_OBJ_LOAD) {
+			LOG_NO("IMMND at node %x does not handle bulk loading of objects (MDS version %u)",
+			       immnd_info_node->immnd_key, immnd_info_node->mdsVersion);
+			return false;
+		}
+		allowed = true;
+		key = immnd_info_node->immnd_key;
+		immnd_info_node = (IMMD_IMMND_INFO_NODE *)
+		    ncs_patricia_tree_getnext(immnd_tree, (uint8_t *)&key);
+	}
+
+	return allowed;
+}
@@ -542,6 +542,10 @@ static void immd_announce_load_ok(IMMD_CB *cb, SaUint32T rulingEpoch)
 	load_evt.info.immnd.type = IMMND_EVT_D2ND_LOADING_OK;
 	load_evt.info.immnd.info.ctrl.rulingEpoch = cb->mRulingEpoch;
 	load_evt.info.immnd.info.ctrl.fevsMsgStart = cb->fevsSendCount;
+	/* Earlier IMMDs leave this 0, which IMMNDs take as bulk load not
+	   allowed. Earlier IMMNDs ignore it. */
+	load_evt.info.immnd.info.ctrl.canBeCoord =
+		immd_immnd_info_obj_load_allowed(&cb->immnd_tree) ? 1 : 0;
 
 	/*Use fevs instead !! */
 	proc_rc = immd_mds_bcast_send(cb, &load_evt, NCSMDS_SVC_ID_IMMND);
@@ -2739,7 +2743,10 @@ static uint32_t immd_evt_proc_mds_evt(IMMD_CB *cb, IMMD_EVT *evt)
 				TRACE_5("NCSMDS_UP and this IMMD is STANDBY");
 			}
 
-			immd_add_immnd_node(cb, mds_info->dest);
+			node_info = immd_add_immnd_node(cb, mds_info->dest);
+			if (node_info) {
+				node_info->mdsVersion = mds_info->svc_pvt_ver;
+			}
 		}
 
 		break;
@@ -559,6 +559,7 @@ static uint32_t immd_mds_svc_evt(IMMD_CB *cb, MDS_CALLBACK_SVC_EVENT_INFO *svc_e
 	evt->info.immd.info.mds_info.dest = svc_evt->i_dest;
 	evt->info.immd.info.mds_info.svc_id = svc_evt->i_svc_id;
 	evt->info.immd.info.mds_info.node_id = svc_evt->i_node_id;
+	evt->info.immd.info.mds_info.svc_pvt_ver = svc_evt->i_rem_svc_pvt_ver;
 
 	/* Put it in IMMD's Event Queue */
 	rc = m_NCS_IPC_SEND(&cb->mbx, (NCSCONTEXT)evt, NCS_IPC_PRIORITY_VERY_HIGH);
@@ -0,0 +1,72 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstring>
+#include "gtest/gtest.h"
+extern "C" {
+#include "imm/immd/immd.h"
+}
+
+// The fixture for the IMMNDs known by the IMMD
+class ImmdImmndInfoTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    memset(&cb_, 0, sizeof(cb_));
+    ASSERT_EQ(NCSCC_RC_SUCCESS, immd_immnd_info_tree_init(&cb_));
+  }
+
+  virtual void TearDown() { immd_immnd_info_tree_destroy(&cb_); }
+
+  // Adds the IMMND at "node_id" as immd_evt.c does when it comes up, with
+  // the MDS version of the IMMND
+  void Add(NODE_ID node_id, MDS_SVC_PVT_SUB_PART_VER mds_version) {
+    MDS_DEST dest = (static_cast<MDS_DEST>(node_id) << 32) | 0x1234;
+    IMMD_IMMND_INFO_NODE *node = nullptr;
+    bool add_flag = true;
+    ASSERT_EQ(NCSCC_RC_SUCCESS, immd_immnd_info_node_find_add(
+                                    &cb_.immnd_tree, &dest, &node, &add_flag));
+    ASSERT_NE(nullptr, node);
+    node->mdsVersion = mds_version;
+  }
+
+  IMMD_CB cb_;
+};
+
+TEST_F(ImmdImmndInfoTest, ObjLoadAllowedWhenAllImmndsHandleIt) {
+  Add(0x2010f, IMMSV_IMMND_MDS_VER_OBJ_LOAD);
+  Add(0x2020f, IMMSV_IMMND_MDS_VER_OBJ_LOAD);
+  Add(0x2030f, IMMSV_IMMND_MDS_VER_OBJ_LOAD + 1);
+  EXPECT_TRUE(immd_immnd_info_obj_load_allowed(&cb_.immnd_tree));
+}
+
+TEST_F(ImmdImmndInfoTest, ObjLoadNotAllowedWithDownLevelImmnd) {
+  Add(0x2010f, IMMSV_IMMND_MDS_VER_OBJ_LOAD);
+  // An IMMND of an earlier release, last in the tree
+  Add(0x2040f, IMMSV_IMMND_MDS_VER_OBJ_LOAD - 1);
+  Add(0x2020f, IMMSV_IMMND_MDS_VER_OBJ_LOAD);
+  EXPECT_FALSE(immd_immnd_info_obj_load_allowed(&cb_.immnd_tree));
+}
+
+TEST_F(ImmdImmndInfoTest, ObjLoadNotAllowedWithUnknownVersion) {
+  Add(0x2010f, 0);
+  Add(0x2020f, IMMSV_IMMND_MDS_VER_OBJ_LOAD);
+  EXPECT_FALSE(immd_immnd_info_obj_load_allowed(&cb_.immnd_tree));
+}
+
+TEST_F(ImmdImmndInfoTest, ObjLoadNotAllowedWithoutImmnds) {
+  EXPECT_FALSE(immd_immnd_info_obj_load_allowed(&cb_.immnd_tree));
+}
@@ -38,6 +38,7 @@
 
 #include "osaf/saf/saAis.h"
 #include "base/osaf_extended_name.h"
+#include "base/osaf_time.h"
 
 // Default value of accessControlMode attribute in the OpensafImm class
 // Can be changed at build time using configure
@@ -52,6 +53,12 @@ static bool opensafClassCreated=false;
 static bool opensafObjectCreated=false;
 static bool opensafPbeRtClassCreated=false;
 
+/* Batch of object creates in the loading ccb, see immsv_load. Loading
+   is done in one ccb from one thread. */
+static void* loadBatch=NULL;
+static int loadRemainingSpace=IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE;
+static int loadObjsInBatch=0;
+
 static char base64_dec_table[] = {
 		62,																										/* + 			*/
 		(char)-1, (char)-1, (char)-1,																								/* 0x2c-0x2e 	*/
@@ -507,6 +514,87 @@ static void opensafObjectCreate(SaImmCcbHandleT ccbHandle)
 }
 
 
+/**
+ * Bulk loading of objects (immsv_load) is used unless IMMSV_BULK_LOAD=0.
+ * When the IMMD does not allow the bulk load message, because an IMMND of
+ * an earlier release takes part in the loading, immsv_load itself falls
+ * back to one object create at a time. The per object
+ * saImmOmCcbObjectCreate_2 can also be forced with IMMSV_BULK_LOAD=0.
+ */
+static bool bulkLoadEnabled()
+{
+    static int enabled = -1;
+    if(enabled < 0) {
+        const char* env = getenv("IMMSV_BULK_LOAD");
+        enabled = (env && strcmp(env, "0") == 0) ? 0 : 1;
+        if(!enabled) {
+            LOG_NO("Bulk loading of objects disabled by IMMSV_BULK_LOAD");
+        }
+    }
+    return enabled;
+}
+
+/**
+ * Adds an object to the load batch, or sends the batch when it is full.
+ * With attrValues NULL the batch is sent as it is.
+ * The local IMMND answers TRY_AGAIN when too many fevs messages are
+ * pending, the batch is then kept and re-sent after a back off.
+ */
+static SaAisErrorT loadObjectBulk(SaImmCcbHandleT ccbHandle,
+    SaImmClassNameT className, const SaNameT* parentName,
+    const SaImmAttrValuesT_2** attrValues)
+{
+    SaAisErrorT err;
+    int retries = 0;
+    useconds_t usec = 10000;
+
+    err = immsv_load(ccbHandle, className, parentName, attrValues,
+        &loadBatch, &loadRemainingSpace,
+        loadObjsInBatch + (attrValues ? 1 : 0));
+
+    while(err == SA_AIS_ERR_TRY_AGAIN && ++retries < 320) {
+        TRACE_8("Got TRY_AGAIN (retries:%u) on bulk load", retries);
+        usleep(usec);
+        if(usec < 500000) { usec = usec*2; }
+        err = immsv_load(ccbHandle, NULL, NULL, NULL,
+            &loadBatch, &loadRemainingSpace, loadObjsInBatch + 1);
+    }
+
+    if(err == SA_AIS_ERR_NOT_READY) {
+        ++loadObjsInBatch;
+        return SA_AIS_OK;
+    }
+
+    if(loadBatch == NULL) {
+        loadRemainingSpace = IMMSV_DEFAULT_MAX_SYNC_BATCH_SIZE;
+        loadObjsInBatch = 0;
+    }
+
+    return err;
+}
+
+/**
+ * Sends any buffered object creates. Must be done before the ccb is
+ * applied or a non bulk create depends on the buffered objects.
+ */
+bool flushImmObjects(SaImmCcbHandleT ccbHandle, bool* pbeCorrupted)
+{
+    SaAisErrorT err;
+
+    if(loadBatch == NULL) {
+        return true;
+    }
+
+    err = loadObjectBulk(ccbHandle, NULL, NULL, NULL);
+    if(err != SA_AIS_OK) {
+        if(pbeCorrupted) *pbeCorrupted = false;
+        LOG_ER("Failed to send batch of objects err: %u", err);
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * Creates an Imm Object through the ImmOm interface
  * Note: classRDNMap is NULL when loading from PBE.
@@ -603,23 +691,29 @@ bool createImmObject(SaImmClassNameT className,
     }
 
     
-    int retries=0;
-    do {/* Do the object creation */
-        
-        if(errorCode == SA_AIS_ERR_TRY_AGAIN) {
-            TRACE_8("Got TRY_AGAIN (retries:%u) on object create",
-                retries);
-            usleep(200000);
-            errorCode = SA_AIS_OK;
-        }
+    if(bulkLoadEnabled()) {
+        /* Errors in creating the object are reported by the ccb apply. */
+        errorCode = loadObjectBulk(ccbHandle, className, &parentName,
+                                   (const SaImmAttrValuesT_2**) attrValues);
+    } else {
+        int retries=0;
+        do {/* Do the object creation */
+
+            if(errorCode == SA_AIS_ERR_TRY_AGAIN) {
+                TRACE_8("Got TRY_AGAIN (retries:%u) on object create",
+                    retries);
+                usleep(200000);
+                errorCode = SA_AIS_OK;
+            }
 
-        errorCode = saImmOmCcbObjectCreate_2(ccbHandle,
-                                         className,
-                                         &parentName,
-                                         (const SaImmAttrValuesT_2**)
-                                         attrValues);
+            errorCode = saImmOmCcbObjectCreate_2(ccbHandle,
+                                             className,
+                                             &parentName,
+                                             (const SaImmAttrValuesT_2**)
+                                             attrValues);
 
-    } while(errorCode == SA_AIS_ERR_TRY_AGAIN && ++retries < 32);
+        } while(errorCode == SA_AIS_ERR_TRY_AGAIN && ++retries < 32);
+    }
 
 
     if (SA_AIS_OK != errorCode)
@@ -1329,6 +1423,10 @@ static void endElementHandler(void* userData,
 
 	if(state->preloadEpochPtr) {goto done;}
 
+        if(state->ccbInit && !flushImmObjects(state->ccbHandle)) {
+            exit(1);
+        }
+
         if(!opensafObjectCreated) {
             opensafObjectCreate(state->ccbHandle);
             LOG_NO("The %s object of class %s has been created since it was missing "
@@ -2587,7 +2685,7 @@ int syncObjectsOfClass(std::string className, SaImmHandleT& immHandle, int maxBa
         do
         {
             if(retries) {
-		    /* TRY_AGAIN while sync is in progress means *this* IMMND most likely has reached IMMSV_DEFAULT_FEVS_MAX_PENDING.
+		    /* TRY_AGAIN while sync is in progress means *this* IMMND most likely has reached its max pending FEVS messages.
 		       This means that *this* IMMND has sent its quota of fevs messages to IMMD without having received them back via
 		       broadcast from IMMD. 
 
@@ -2734,6 +2832,8 @@ int immsync(int maxBatchSize)
 
     it = classNamesList.begin();
 
+    struct timespec start, end, elapsed;
+    osaf_clock_gettime(CLOCK_MONOTONIC, &start);
     int nrofObjects = 0;
     while (it != classNamesList.end())
     {
@@ -2742,7 +2842,13 @@ int immsync(int maxBatchSize)
         nrofObjects += objects;
         ++it;
     }
-    LOG_IN("Synced %u objects in total", nrofObjects);
+    osaf_clock_gettime(CLOCK_MONOTONIC, &end);
+    osaf_timespec_subtract(&end, &start, &elapsed);
+    uint64_t millis = osaf_timespec_to_millis(&elapsed);
+    LOG_IN("Synced %u objects in total in %llu ms (%llu objects/sec)",
+           nrofObjects, (unsigned long long) millis,
+           (unsigned long long) (millis ? (nrofObjects * 1000ULL) / millis :
+                                 nrofObjects));
 
     retries = 0;
     do
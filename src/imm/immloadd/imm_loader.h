@@ -72,6 +72,7 @@ bool createImmObject(SaImmClassNameT className,
 	std::map<std::string, SaImmAttrValuesT_2> *classRDNMap,
 	bool* pbeCorrupted = NULL);
 
+bool flushImmObjects(SaImmCcbHandleT ccbHandle, bool* pbeCorrupted = NULL);
 
 void escalatePbe(std::string dir, std::string file);
 
@@ -984,6 +984,11 @@ int loadImmFromPbe(void* pbeHandle, bool preload, bool* pbeCorrupted)
 		goto bailout;
 	}
 
+	if(!flushImmObjects(ccbHandle, pbeCorrupted))
+	{
+		goto bailout;
+	}
+
 	rc = sqlite3_exec(dbHandle, commitT, NULL, NULL, &execErr);
 	if (rc != SQLITE_OK) {
 		LOG_ER("SQL statement ('%s') failed because:\n %s", 
@@ -28,21 +28,50 @@ ImmAttrValue::ImmAttrValue() :
 
 ImmAttrValue::ImmAttrValue(const ImmAttrValue& b) :
     mValue(NULL), 
-    mValueSize(b.mValueSize) 
+    mValueSize(0) 
 {
-    if(mValueSize) {
-        mValue = new char[b.mValueSize];
-        (void)::memcpy(mValue, b.mValue, b.mValueSize);
+    if(b.mValueSize) {
+        (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(), b.mValueSize);
     }
 }
 
 ImmAttrValue::~ImmAttrValue() 
 {
-    delete [] mValue;
+    freeValue();
+}
+
+char*
+ImmAttrValue::allocValue(unsigned int size)
+{
+    freeValue();
+    mValueSize = size;
+    if(mValueSize > sizeof(mInline)) {
+        mValue = new char[mValueSize];
+    }
+    return valueBuf();
+}
+
+void
+ImmAttrValue::freeValue()
+{
+    if(mValueSize > sizeof(mInline)) {
+        delete [] mValue;
+    }
     mValue=0;
     mValueSize=0;
 }
 
+void
+ImmAttrValue::moveValue(ImmAttrValue& from)
+{
+    /* Takes over the value of 'from' without copying a heap buffer. */
+    freeValue();
+    mValue = from.mValue;  /* Copies an inline value as well. */
+    mValueSize = from.mValueSize;
+    from.mValue=0;
+    from.mValueSize=0;
+}
+
 void
 ImmAttrValue::printSimpleValue() const
 {
@@ -60,12 +89,10 @@ ImmAttrValue::operator= (const ImmAttrValue& b)
 {
     if (this != &b)
     {
-        delete [] mValue;
-
-        mValueSize = b.mValueSize;
-        if(mValueSize) {
-            mValue = new char[b.mValueSize];
-            (void)::memcpy(mValue, b.mValue, b.mValueSize);
+        freeValue();
+        if(b.mValueSize) {
+            (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(),
+                b.mValueSize);
         }
     }
 
@@ -75,45 +102,31 @@ ImmAttrValue::operator= (const ImmAttrValue& b)
 void
 ImmAttrValue::setValue(const IMMSV_OCTET_STRING& in) 
 {
-    if(mValue) {
+    if(mValueSize) {
         if((in.size == mValueSize) && 
-            (memcmp(mValue, in.buf, mValueSize) == 0)) {return;} //Already equal
-        delete [] mValue;
-        mValue=0;
+            (memcmp(valueBuf(), in.buf, mValueSize) == 0)) {return;} //Already equal
+        freeValue();
     }
 
-    mValueSize = (size_t)in.size;
-    if(mValueSize) {
-        mValue = new char[mValueSize];
-        (void)::memcpy(mValue, in.buf, mValueSize);
+    if(in.size) {
+        (void)::memcpy(allocValue(in.size), in.buf, in.size);
     }
 }
 
 void
 ImmAttrValue::discardValues() 
 {
-    if(mValue) {
-        delete [] mValue;
-        mValue=0;
-        mValueSize=0;
-    }
+    freeValue();
 }
 
 void
 ImmAttrValue::setValue_int(int i)
 {
-    if(mValue && mValueSize != sizeof(int)) {
-        delete [] mValue;
-        mValue=0;
-        mValueSize=0;
-    }
-
-    if(!mValue) {
-        mValueSize = sizeof(int);
-        mValue = new char[mValueSize];
+    if(mValueSize != sizeof(int)) {
+        allocValue(sizeof(int));
     }
 
-    *((int *) mValue) = i;
+    memcpy(valueBuf(), &i, sizeof(int));
 }
 
 int
@@ -121,32 +134,31 @@ ImmAttrValue::getValue_int() const
 {
     if(mValueSize != sizeof(int)) {return 0;}
     
-    return *((int *) mValue);
+    int i;
+    memcpy(&i, valueBuf(), sizeof(int));
+    return i;
 }
 
 void
 ImmAttrValue::setValueC_str(const char* str)
 {
-    if(mValue) {
+    if(mValueSize) {
         if(str) {
-            if(strncmp(mValue, str, mValueSize) == 0) {return;} //Already equal
+            if(strncmp(valueBuf(), str, mValueSize) == 0) {return;} //Already equal
         }
-        delete [] mValue;
-        mValue=0;
-        mValueSize=0;
+        freeValue();
     }
     
     if(str) {
-        mValueSize=  (unsigned int) strlen(str) + 1;
-        mValue = new char[mValueSize];
-        strncpy(mValue, str, mValueSize);
+        unsigned int size = (unsigned int) strlen(str) + 1;
+        memcpy(allocValue(size), str, size);
     }
 }
 
 const char* 
 ImmAttrValue::getValueC_str() const
 {
-    return mValue;
+    return mValueSize ? valueBuf() : NULL;
 }
 
 void
@@ -157,30 +169,31 @@ ImmAttrValue::copyValueToEdu(IMMSV_EDU_ATTR_VAL* out, SaImmValueTypeT t) const
         return;
     }
     
-    osafassert(mValue);
+    const char* value = valueBuf();
+    osafassert(value);
     
     switch(t)
     {
         case SA_IMM_ATTR_SAINT32T: 
-            out->val.saint32 = *((SaInt32T *) mValue);
+            out->val.saint32 = *((const SaInt32T *) value);
             return;
         case SA_IMM_ATTR_SAUINT32T: 
-            out->val.sauint32 = *((SaUint32T *) mValue);
+            out->val.sauint32 = *((const SaUint32T *) value);
             return;
         case SA_IMM_ATTR_SAINT64T: 
-            out->val.saint64 = *((SaInt64T *) mValue);
+            out->val.saint64 = *((const SaInt64T *) value);
             return;
         case SA_IMM_ATTR_SAUINT64T: 
-            out->val.sauint64 = *((SaUint64T *) mValue);
+            out->val.sauint64 = *((const SaUint64T *) value);
             return;
         case SA_IMM_ATTR_SATIMET:
-            out->val.satime = *((SaTimeT *) mValue);
+            out->val.satime = *((const SaTimeT *) value);
             return;
         case SA_IMM_ATTR_SAFLOATT:
-            out->val.safloat = *((SaFloatT *) mValue);
+            out->val.safloat = *((const SaFloatT *) value);
             return;
         case SA_IMM_ATTR_SADOUBLET:
-            out->val.sadouble = *((SaDoubleT *) mValue);
+            out->val.sadouble = *((const SaDoubleT *) value);
             return;
             
         case SA_IMM_ATTR_SASTRINGT:
@@ -188,7 +201,7 @@ ImmAttrValue::copyValueToEdu(IMMSV_EDU_ATTR_VAL* out, SaImmValueTypeT t) const
         case SA_IMM_ATTR_SANAMET:
             out->val.x.size = mValueSize;
             out->val.x.buf = (char *) malloc(mValueSize);
-            memcpy(out->val.x.buf, mValue, mValueSize);
+            memcpy(out->val.x.buf, value, mValueSize);
             
             break;
             
@@ -214,7 +227,7 @@ void
 ImmAttrValue::removeValue(const IMMSV_OCTET_STRING& match) //virtual
 {
     if((mValueSize ==  match.size) &&
-        (bcmp((const void *) mValue, (const void *) match.buf, 
+        (bcmp((const void *) valueBuf(), (const void *) match.buf, 
             mValueSize) == 0)) {
         this->discardValues();
     }
@@ -225,7 +238,7 @@ ImmAttrValue::hasMatchingValue(const IMMSV_OCTET_STRING& match) const //virtual
 {
     if(mValueSize != match.size) return false;
     
-    return bcmp((const void *) mValue, (const void *) match.buf, 
+    return bcmp((const void *) valueBuf(), (const void *) match.buf, 
         mValueSize) == 0 ;
 }
 
@@ -259,11 +272,7 @@ ImmAttrMultiValue::ImmAttrMultiValue(const ImmAttrValue& b) :
 
 ImmAttrMultiValue::~ImmAttrMultiValue() 
 {
-    if(mValue) {
-        delete [] mValue;
-        mValue=0;
-        mValueSize=0;
-    }
+    freeValue();
     if(mNext) {
         delete mNext;
         mNext=0;
@@ -275,12 +284,10 @@ ImmAttrMultiValue::operator= (const ImmAttrMultiValue& b)
 {
     if (this != &b)
     {
-        delete [] mValue;
-        mValue=0;
-        mValueSize = b.mValueSize;
-        if(mValueSize) {
-            mValue = new char[b.mValueSize];
-            (void)::memcpy(mValue, b.mValue, b.mValueSize);
+        freeValue();
+        if(b.mValueSize) {
+            (void)::memcpy(allocValue(b.mValueSize), b.valueBuf(),
+                b.mValueSize);
         }
     }
     
@@ -298,11 +305,7 @@ ImmAttrMultiValue::operator= (const ImmAttrMultiValue& b)
 void
 ImmAttrMultiValue::discardValues() //virtual
 {
-    if(mValue) {
-        delete [] mValue;
-        mValue=0;
-        mValueSize=0;
-    }
+    freeValue();
     
     if(mNext) {
         delete mNext;
@@ -319,11 +322,7 @@ ImmAttrMultiValue::removeValue(const IMMSV_OCTET_STRING& match) //virtual
         while(!mValueSize && mNext) { //Empty head => shift up an extra.
             ImmAttrMultiValue* tmp = mNext;
             
-            mValue = tmp->mValue;
-            tmp->mValue=NULL;
-            
-            mValueSize = tmp->mValueSize;
-            tmp->mValueSize=0;
+            moveValue(*tmp);
             
             mNext=tmp->mNext;
             tmp->mNext = NULL;
@@ -331,12 +330,10 @@ ImmAttrMultiValue::removeValue(const IMMSV_OCTET_STRING& match) //virtual
         }
         
         if(mValueSize && (mValueSize ==  match.size) &&
-            (bcmp((const void *) mValue, (const void *) match.buf, 
+            (bcmp((const void *) valueBuf(), (const void *) match.buf, 
                 mValueSize) == 0)) {
             //match!
-            delete [] mValue;
-            mValue=0;
-            mValueSize=0;
+            freeValue();
             //Head is now empty because it matched.
         } else {
             tryRemoveHead = false;
@@ -364,7 +361,7 @@ bool
 ImmAttrMultiValue::hasMatchingValue(const IMMSV_OCTET_STRING& match) const//virtual
 {
     if((mValueSize == match.size) &&
-        bcmp((const void *) mValue, (const void *) match.buf, mValueSize) == 0) {
+        bcmp((const void *) valueBuf(), (const void *) match.buf, mValueSize) == 0) {
         return true;
     }
     
@@ -375,7 +372,7 @@ ImmAttrMultiValue::hasMatchingValue(const IMMSV_OCTET_STRING& match) const//virt
 bool
 ImmAttrMultiValue::hasDuplicates() const//virtual
 {
-    IMMSV_OCTET_STRING match = {mValueSize, mValue};
+    IMMSV_OCTET_STRING match = {mValueSize, (char *) valueBuf()};
     
     return mNext ? (mNext->hasMatchingValue(match) || mNext->hasDuplicates()):false;
 }
@@ -410,7 +407,7 @@ ImmAttrMultiValue::hasExtraValueC_str(const char* str) const
 {
     const ImmAttrMultiValue* mval = this;
     while(mval) {
-        if(strncmp(str, mval->mValue, mval->mValueSize)==0) {
+        if(strncmp(str, mval->valueBuf(), mval->mValueSize)==0) {
             return true;
         }
         mval=mval->mNext;
@@ -423,7 +420,7 @@ ImmAttrMultiValue::removeExtraValueC_str(const char* str)
 {
     ImmAttrMultiValue* mval = this;
     while(mval->mNext) {
-        if(strncmp(str, mval->mNext->mValue, mval->mNext->mValueSize)==0) {
+        if(strncmp(str, mval->mNext->valueBuf(), mval->mNext->mValueSize)==0) {
             ImmAttrMultiValue* tmp = mval->mNext;
             mval->mNext=mval->mNext->mNext;
             tmp->mNext=NULL;
@@ -57,7 +57,21 @@ public:
     bool            empty() const {return !mValueSize;}
     
 protected:
-    char*           mValue;
+    char*           valueBuf()
+        {return (mValueSize > sizeof(mInline)) ? mValue : mInline;}
+    const char*     valueBuf() const
+        {return (mValueSize > sizeof(mInline)) ? mValue : mInline;}
+    char*           allocValue(unsigned int size);
+    void            freeValue();
+    void            moveValue(ImmAttrValue& from);
+
+    /* Values that fit in a pointer (all numeric types and short strings)
+       are stored inline instead of in a separate heap buffer. mValue is
+       only valid when mValueSize > sizeof(mInline). */
+    union {
+        char*       mValue;
+        char        mInline[sizeof(char*)];
+    };
     unsigned int    mValueSize;
     
 };
@@ -0,0 +1,263 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#ifndef IMM_IMMND_IMMINDEXEDMAP_H_
+#define IMM_IMMND_IMMINDEXEDMAP_H_ 1
+
+#include <stdint.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <utility>
+
+/*
+  ImmIndexedMap is a drop in replacement for std::map<std::string, T> as
+  used by the IMM model for the object map and the class map.
+
+  The ordered std::map is kept as the primary store. It owns the one and
+  only copy of each key (the DN is interned in the map node) and it provides
+  the ordered iteration that search, sync and the PBE dump rely on.
+
+  Next to it sits an open addressing hash index (linear probing) that maps
+  the hash of a key to the iterator of the node in the ordered map. A find()
+  is then one hash computation and normally a single string compare, instead
+  of log2(N) string compares of long DNs in the red-black tree.
+
+  Iterators are plain std::map iterators and stay valid under insert and
+  erase exactly as for std::map. Erase leaves a tombstone in the hash index
+  so that no other slot is moved. The index is rebuilt when live entries
+  plus tombstones exceed the load limit.
+*/
+template <typename T>
+class ImmIndexedMap
+{
+public:
+    typedef std::map<std::string, T> OrderedMap;
+    typedef typename OrderedMap::iterator iterator;
+    typedef typename OrderedMap::const_iterator const_iterator;
+    typedef typename OrderedMap::value_type value_type;
+    typedef typename OrderedMap::size_type size_type;
+
+    ImmIndexedMap() : mUsed(0), mTombs(0) { }
+
+    iterator        begin() { return mOrdered.begin(); }
+    iterator        end() { return mOrdered.end(); }
+    const_iterator  begin() const { return mOrdered.begin(); }
+    const_iterator  end() const { return mOrdered.end(); }
+    size_type       size() const { return mOrdered.size(); }
+    bool            empty() const { return mOrdered.empty(); }
+
+    iterator find(const std::string& key)
+    {
+        size_t slot = lookup(key, hashOf(key));
+        return (slot == kNoSlot) ? mOrdered.end() : mSlots[slot].mIter;
+    }
+
+    const_iterator find(const std::string& key) const
+    {
+        size_t slot = lookup(key, hashOf(key));
+        return (slot == kNoSlot) ? mOrdered.end() :
+            const_iterator(mSlots[slot].mIter);
+    }
+
+    size_type count(const std::string& key) const
+    {
+        return (lookup(key, hashOf(key)) == kNoSlot) ? 0 : 1;
+    }
+
+    T& operator[](const std::string& key)
+    {
+        uint32_t hash = hashOf(key);
+        size_t slot = lookup(key, hash);
+        if(slot != kNoSlot) {
+            return mSlots[slot].mIter->second;
+        }
+        iterator it = mOrdered.insert(value_type(key, T())).first;
+        addToIndex(hash, it);
+        return it->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& val)
+    {
+        uint32_t hash = hashOf(val.first);
+        size_t slot = lookup(val.first, hash);
+        if(slot != kNoSlot) {
+            return std::make_pair(mSlots[slot].mIter, false);
+        }
+        iterator it = mOrdered.insert(val).first;
+        addToIndex(hash, it);
+        return std::make_pair(it, true);
+    }
+
+    void erase(iterator pos)
+    {
+        size_t slot = slotOf(pos);
+        if(slot != kNoSlot) {
+            mSlots[slot].mState = kTomb;
+            --mUsed;
+            ++mTombs;
+        }
+        mOrdered.erase(pos);
+    }
+
+    size_type erase(const std::string& key)
+    {
+        iterator it = find(key);
+        if(it == mOrdered.end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    void clear()
+    {
+        mOrdered.clear();
+        mSlots.clear();
+        mUsed = 0;
+        mTombs = 0;
+    }
+
+    /* Pre-size the hash index, e.g. before loading or sync. */
+    void reserve(size_type n)
+    {
+        size_t cap = kMinCapacity;
+        while(cap * kMaxLoadNum < n * kMaxLoadDen) {
+            cap <<= 1;
+        }
+        if(cap > mSlots.size()) {
+            rebuild(cap);
+        }
+    }
+
+    size_type bucket_count() const { return mSlots.size(); }
+
+    /* FNV-1a. DNs in a model tend to share long suffixes (the parent DN)
+       so every byte of the key is used. */
+    static uint32_t hashOf(const std::string& key)
+    {
+        uint32_t h = 2166136261U;
+        const unsigned char* p = (const unsigned char*) key.data();
+        const unsigned char* e = p + key.size();
+        while(p != e) {
+            h ^= *p++;
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+private:
+    enum SlotState { kEmpty = 0, kUsed = 1, kTomb = 2 };
+
+    struct Slot
+    {
+        Slot() : mHash(0), mState(kEmpty) { }
+        uint32_t  mHash;
+        uint32_t  mState;
+        iterator  mIter;
+    };
+
+    static const size_t kNoSlot = (size_t) -1;
+    static const size_t kMinCapacity = 64;
+    /* Max load factor (live entries + tombstones) is 7/10. */
+    static const size_t kMaxLoadNum = 7;
+    static const size_t kMaxLoadDen = 10;
+
+    size_t lookup(const std::string& key, uint32_t hash) const
+    {
+        if(mSlots.empty()) {
+            return kNoSlot;
+        }
+        size_t mask = mSlots.size() - 1;
+        for(size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const Slot& s = mSlots[i];
+            if(s.mState == kEmpty) {
+                return kNoSlot;
+            }
+            if(s.mState == kUsed && s.mHash == hash && s.mIter->first == key) {
+                return i;
+            }
+        }
+    }
+
+    size_t slotOf(iterator pos) const
+    {
+        if(mSlots.empty()) {
+            return kNoSlot;
+        }
+        uint32_t hash = hashOf(pos->first);
+        size_t mask = mSlots.size() - 1;
+        for(size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const Slot& s = mSlots[i];
+            if(s.mState == kEmpty) {
+                return kNoSlot;
+            }
+            if(s.mState == kUsed && s.mIter == pos) {
+                return i;
+            }
+        }
+    }
+
+    void addToIndex(uint32_t hash, iterator it)
+    {
+        if((mUsed + mTombs + 1) * kMaxLoadDen > mSlots.size() * kMaxLoadNum) {
+            size_t cap = mSlots.empty() ? kMinCapacity : mSlots.size();
+            /* Grow only when live entries need it, else just purge tombs. */
+            while((mUsed + 1) * kMaxLoadDen * 2 > cap * kMaxLoadNum) {
+                cap <<= 1;
+            }
+            rebuild(cap);
+        }
+        place(hash, it);
+        ++mUsed;
+    }
+
+    void place(uint32_t hash, iterator it)
+    {
+        size_t mask = mSlots.size() - 1;
+        size_t i = hash & mask;
+        while(mSlots[i].mState == kUsed) {
+            i = (i + 1) & mask;
+        }
+        if(mSlots[i].mState == kTomb) {
+            --mTombs;
+        }
+        mSlots[i].mHash = hash;
+        mSlots[i].mState = kUsed;
+        mSlots[i].mIter = it;
+    }
+
+    void rebuild(size_t cap)
+    {
+        std::vector<Slot> old;
+        old.swap(mSlots);
+        mSlots.resize(cap);
+        mTombs = 0;
+        for(size_t i = 0; i < old.size(); ++i) {
+            if(old[i].mState == kUsed) {
+                place(old[i].mHash, old[i].mIter);
+            }
+        }
+    }
+
+    OrderedMap        mOrdered;
+    std::vector<Slot> mSlots;
+    size_t            mUsed;
+    size_t            mTombs;
+};
+
+#endif  // IMM_IMMND_IMMINDEXEDMAP_H_
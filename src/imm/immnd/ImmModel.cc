@@ -127,7 +127,7 @@ struct ClassInfo
     ObjectSet        mExtent;
     ImplementerSet   mAppliers; //OIs did classImplementerSet on this class
 };
-typedef std::map<std::string, ClassInfo*> ClassMap;
+typedef ImmIndexedMap<ClassInfo*> ClassMap;
 
 typedef std::map<std::string, ImmAttrValue*> ImmAttrValueMap;
 
@@ -497,12 +497,28 @@ typedef enum {
 //of the missing parent. 
 typedef std::map<std::string, ObjectSet> MissingParentsMap; 
 
+//Parent/child index. Maps a parent object to the object-map entries of its
+//direct children, ordered by DN. Only objects present in sObjectMap and
+//with mParent set are indexed. The comparator dereferences the iterators,
+//so an object must be removed from the index (removeChildLinks) before its
+//sObjectMap entry is erased. Removing a parent drops its children from the
+//index and clears their mParent.
+struct ObjectDnLess
+{
+    bool operator()(const ObjectMap::iterator& a,
+                    const ObjectMap::iterator& b) const
+    {return a->first < b->first;}
+};
+typedef std::set<ObjectMap::iterator, ObjectDnLess> ChildSet;
+typedef std::map<ObjectInfo*, ChildSet> ChildIndexMap;
+
 // Local variables
 
 static ClassMap          sClassMap;
 static AdminOwnerVector  sOwnerVector;
 static CcbVector         sCcbVector;
 static ObjectMap         sObjectMap;
+static ChildIndexMap     sChildIndex;
 static ObjectMMap        sReverseRefsNoDanglingMMap;
 /* Maps an object pointer, to the set of pointers to *other* objects
    (not including self and not including children AS CHILDREN)
@@ -837,6 +853,71 @@ immModel_ccbObjectCreate(IMMND_CB *cb,
     return err;
 }
 
+SaAisErrorT
+immModel_ccbObjectLoad(IMMND_CB *cb,
+    struct ImmsvOmObjectLoad* req)
+{
+    SaAisErrorT err = SA_AIS_OK;
+    struct ImmsvOmObjectSync* obj = &(req->objects);
+    std::string objectName;
+    TRACE_ENTER2("Load batch for ccb %u", req->ccbId);
+
+    if(sImmNodeState != IMM_NODE_LOADING) {
+        LOG_ER("Bulk load of objects received when not loading");
+        err = SA_AIS_ERR_BAD_OPERATION;
+        obj = NULL;
+    }
+
+    for(; obj && (err == SA_AIS_OK); obj = obj->next) {
+        struct ImmsvOmCcbObjectCreate create;
+        SaUint32T implConn = 0;
+        unsigned int implNodeId = 0;
+        SaUint32T continuationId = 0;
+        SaUint32T pbeConn = 0;
+        bool dnOrRdnIsLong = false;
+
+        memset(&create, 0, sizeof(create));
+        create.ccbId = req->ccbId;
+        create.adminOwnerId = req->adminOwnerId;
+        create.className = obj->className;
+        create.parentOrObjectDn = obj->objectName;
+        create.attrValues = obj->attrValues;
+
+        /* No pbe and no implementers exist during loading. */
+        err = ImmModel::instance(&cb->immModel)->
+            ccbObjectCreate(&create, &implConn, &implNodeId, &continuationId,
+                &pbeConn, NULL, objectName, &dnOrRdnIsLong, false);
+        obj->attrValues = create.attrValues;
+
+        if((err == SA_AIS_OK) && implNodeId) {
+            LOG_ER("Implementer for object loaded in bulk, class:%s",
+                obj->className.buf);
+            err = SA_AIS_ERR_BAD_OPERATION;
+        }
+
+        if(err != SA_AIS_OK) {
+            LOG_ER("Failed to load object err:%u class:%s parent:'%s'",
+                err, obj->className.buf,
+                obj->objectName.buf ? obj->objectName.buf : "");
+        }
+    }
+
+    if(err != SA_AIS_OK) {
+        /* There is no reply per batch, veto the ccb so that the error is
+           returned by the apply of the loading ccb. */
+        CcbVector::iterator cvi = std::find_if(sCcbVector.begin(),
+            sCcbVector.end(), CcbIdIs(req->ccbId));
+        if(cvi != sCcbVector.end()) {
+            (*cvi)->mVeto = SA_AIS_ERR_FAILED_OPERATION;
+            ImmModel::instance(&cb->immModel)->setCcbErrorString(*cvi,
+                IMM_VALIDATION_ABORT "Bulk load of object failed (%u)", err);
+        }
+    }
+
+    TRACE_LEAVE();
+    return err;
+}
+
 struct immsv_attr_values_list * 
 immModel_specialApplierTrimCreate(IMMND_CB *cb, SaUint32T clientId, 
    struct ImmsvOmCcbObjectCreate *req)
@@ -1654,6 +1735,13 @@ immModel_testTopResult(void* searchOp, SaUint32T* implNodeId, SaBoolT* bRtAttrsT
     ImplementerInfo *implInfo = NULL;
     ImmSearchOp* op = (ImmSearchOp *) searchOp;
 
+    if(op->isSync()) {
+        /* Sync never fetches pure runtime attributes from an OI. */
+        *bRtAttrsToFetch = SA_FALSE;
+        *implNodeId = 0;
+        return (op->syncOsi) ? SA_AIS_OK : SA_AIS_ERR_NOT_EXIST;
+    }
+
     err = op->testTopResult((void **)&implInfo, bRtAttrsToFetch);
     *implNodeId = (implInfo) ? implInfo->mNodeId : 0;
 
@@ -1682,7 +1770,7 @@ immModel_nextResult(IMMND_CB *cb, void* searchOp,
         if(retardSync) {
             TRACE_2("ERR_TRY_AGAIN: Too many pending incoming fevs "
                 "messages (> %u) rejecting sync iteration next request",
-                IMMSV_DEFAULT_FEVS_MAX_PENDING);
+                cb->mFevsMaxPending);
             return SA_AIS_ERR_TRY_AGAIN;
         }
         err = ImmModel::instance(&cb->immModel)->nextSyncResult(rsp, *op);
@@ -1793,6 +1881,13 @@ immModel_isSearchOpAccessor(void* searchOp)
     return op->isAccessor() ? SA_TRUE : SA_FALSE;
 }
 
+SaBoolT
+immModel_isSearchOpSync(void* searchOp)
+{
+    ImmSearchOp* op = (ImmSearchOp *) searchOp;
+    return op->isSync() ? SA_TRUE : SA_FALSE;
+}
+
 SaBoolT
 immModel_isSearchOpNonExtendedNameSet(void* searchOp)
 {
@@ -6114,6 +6209,7 @@ ImmModel::commitDelete(const std::string& dn)
         //Here we are erasing based on value, not iterator position. 
     }
     
+    removeChildLinks(oi);
     delete oi->second;
     sObjectMap.erase(oi);
 
@@ -6494,6 +6590,7 @@ ImmModel::ccbTerminate(SaUint32T ccbId)
                     if(oi->second->mObjFlags & IMM_NO_DANGLING_FLAG) {
                         removeNoDanglingRefs(oi->second, oi->second, true);
                     }
+                    removeChildLinks(oi);
                     sObjectMap.erase(oi);
                     osafassert(afim);
                     SaUint32T adminOwnerId = (omut->mAugmentAdmo)? omut->mAugmentAdmo : ccb->mAdminOwnerId;
@@ -6526,6 +6623,23 @@ ImmModel::ccbTerminate(SaUint32T ccbId)
                     /*Aborting a ccb-create also means we need to decrement mChildcount
                       for all parents of the object being reverted. */
                     ObjectInfo* grandParent = afim->mParent;
+                    if(!grandParent) {
+                        /* The create of the parent was aborted before this
+                           one and removeChildLinks cleared the link. Continue
+                           from the closest ancestor still in the model. */
+                        std::string ancestorDn;
+                        getParentDn(ancestorDn, dn);
+                        while(!ancestorDn.empty()) {
+                            ObjectMap::iterator ai = sObjectMap.find(ancestorDn);
+                            if(ai != sObjectMap.end()) {
+                                grandParent = ai->second;
+                                break;
+                            }
+                            std::string nextDn;
+                            getParentDn(nextDn, ancestorDn);
+                            ancestorDn.swap(nextDn);
+                        }
+                    }
                     while(grandParent) {
                         std::string gpDn;
                         getObjectName(grandParent, gpDn);
@@ -6539,7 +6653,8 @@ ImmModel::ccbTerminate(SaUint32T ccbId)
 
                     /* Dont delete afim yet. Needed if aborting create of a subTREE! 
                        That is, this afim may have children (creates) that are yet
-                       to be aborted. Afim needed as parent link in decrementing childCount.
+                       to be aborted. Those find their surviving ancestors by DN,
+                       since removeChildLinks cleared their parent link.
                        Attributes of the afim also accessed in log info print of childcount.
                        Deleted instead at #### below.
                     */
@@ -8673,6 +8788,7 @@ SaAisErrorT ImmModel::ccbObjectCreate(ImmsvOmCcbObjectCreate* req,
             if(parent) {
                 osafassert(mpm == sMissingParents.end());
                 object->mParent = parent;
+                addChildLink(sObjectMap.find(objectName));
 
                 ObjectInfo* grandParent = parent;
                 do {
@@ -8733,6 +8849,7 @@ SaAisErrorT ImmModel::ccbObjectCreate(ImmsvOmCcbObjectCreate* req,
                     while(oi != mpm->second.end()) {
                         /* Correct the pointer from child to parent */
                         (*oi)->mParent = object;
+                        addChildLink(*oi, objectName);
                         ObjectInfo* grandParent = object;
                         do {
                             grandParent->mChildCount += ((*oi)->mChildCount + 1);
@@ -10098,8 +10215,6 @@ ImmModel::ccbObjectDelete(const ImmsvOmCcbObjectDelete* req,
     }
     
     for(int doIt=0; (doIt < 2) && (err == SA_AIS_OK); ++doIt) {
-        SaUint32T childCount = oi->second->mChildCount;
-        
         err = deleteObject(oi, reqConn, adminOwner, ccb, doIt, objNameVector,
             connVector, continuations, pbeConnPtr?(*pbeConnPtr):0, &readLockedObject);
 
@@ -10113,24 +10228,15 @@ ImmModel::ccbObjectDelete(const ImmsvOmCcbObjectDelete* req,
         }
 
         // Find all sub objects to the deleted object and delete them
-        for (oi2 = sObjectMap.begin(); 
-             oi2 != sObjectMap.end() && err == SA_AIS_OK && childCount; ++oi2) {
-            std::string subObjName = oi2->first;
-            if (subObjName.length() > objectName.length()) {
-                size_t pos = subObjName.length() - objectName.length();
-                if ((subObjName.rfind(objectName, pos) == pos) &&
-                    (subObjName[pos-1] == ',')){
-                    --childCount;
-                    err = deleteObject(oi2, reqConn, adminOwner, ccb, doIt, 
-                        objNameVector, connVector, continuations, 
-                        pbeConnPtr?(*pbeConnPtr):0, &readLockedObject);
-                    if(err == SA_AIS_OK && readLockedObject != NULL) {
-                        safeReadObjSet.insert(readLockedObject);
-                    }
-                    if(!childCount) {
-                        TRACE("Cutoff in ccb-obj-delete-loop by childCount");
-                    }
-                }
+        ObjectIterVector subtree;
+        collectSubtree(oi, SA_IMM_SUBTREE, subtree);
+        for(size_t ix = 1; ix < subtree.size() && err == SA_AIS_OK; ++ix) {
+            oi2 = subtree[ix];
+            err = deleteObject(oi2, reqConn, adminOwner, ccb, doIt, 
+                objNameVector, connVector, continuations, 
+                pbeConnPtr?(*pbeConnPtr):0, &readLockedObject);
+            if(err == SA_AIS_OK && readLockedObject != NULL) {
+                safeReadObjSet.insert(readLockedObject);
             }
         }
     }
@@ -11998,6 +12104,8 @@ ImmModel::searchInitialize(ImmsvOmSearchInit* req, ImmSearchOp& op)
     ObjectMMap::iterator ommi = sReverseRefsNoDanglingMMap.end();
     std::string refObjectName;
     SaUint32T childCount=0;
+    ObjectIterVector subtree;
+    size_t subtreeIx=0;
     
     if(nonExtendedNameCheck) {
         op.setNonExtendedName();
@@ -12198,9 +12306,13 @@ ImmModel::searchInitialize(ImmsvOmSearchInit* req, ImmSearchOp& op)
             goto searchInitializeExit;
         }
     } else {
-        if(childCount > 1) {
-            /* A root was provided and it has children => Initialize */
-            /* iteration for regular object-map as source */
+        if(rootlen > 0 && childCount > 1) {
+            /* A root was provided and it has children => Iterate over the
+               root and its subtree (or sublevel) from the child index. */
+            collectSubtree(omi, scope, subtree);
+            osafassert(subtree[0] == omi);
+        } else if(childCount > 1) {
+            /* No root => Initialize iteration for regular object-map as source */
             omi = sObjectMap.begin();
             osafassert(omi != sObjectMap.end()); /* sObjectMap can never be empty! */
         } else {
@@ -12216,8 +12328,8 @@ ImmModel::searchInitialize(ImmsvOmSearchInit* req, ImmSearchOp& op)
     }
     
     // Find root object and all sub objects to the root object.
-    // Source set is either (a) entire object-map or (b) class extent set
-    // or (c) set of no-dangling dependents on refObj
+    // Source set is either (a) entire object-map or subtree of the root
+    // or (b) class extent set or (c) set of no-dangling dependents on refObj
     while(err==SA_AIS_OK && (omi != sObjectMap.end() || 
             (classInfo && osi != classInfo->mExtent.end()) ||
             (ommi != sReverseRefsNoDanglingMMap.end() && ommi->first == refObj))) {
@@ -12462,7 +12574,11 @@ ImmModel::searchInitialize(ImmsvOmSearchInit* req, ImmSearchOp& op)
                 ++ommi;
             }
         } else {
-            ++omi;
+            if(subtree.empty()) {
+                ++omi;
+            } else {
+                omi = (++subtreeIx < subtree.size()) ? subtree[subtreeIx] : sObjectMap.end();
+            }
             if(omi!= sObjectMap.end()) {
                 obj = omi->second;
                 objectName = omi->first;
@@ -12532,8 +12648,8 @@ SaAisErrorT ImmModel::nextSyncResult(ImmsvOmRspSearchNext** rsp, ImmSearchOp& op
 
         while(list) {
             size_t sz = strnlen((char *) list->name.buf, (size_t) list->name.size);
-            std::string attName((const char *) list->name.buf, sz);
-            if(j->first == attName) {
+            if((j->first.length() == sz) &&
+               (memcmp(j->first.data(), list->name.buf, sz) == 0)) {
                 break;
             }
             list = list->next;
@@ -16366,6 +16482,9 @@ ImmModel::rtObjectCreate(struct ImmsvOmCcbObjectCreate* req,
 
         sObjectMap[objectName] = object;
         classInfo->mExtent.insert(object);
+        if(parent) {
+            addChildLink(sObjectMap.find(objectName));
+        }
         
         if(className == immClassName) {
             updateImmObject(immClassName);
@@ -18025,6 +18144,7 @@ ImmModel::deleteRtObject(ObjectMap::iterator& oi, bool doIt,
             //Here we are erasing based on value, not iterator position. 
         }
         
+        removeChildLinks(oi);
         delete object;
         sObjectMap.erase(oi);
     }
@@ -18326,6 +18446,9 @@ ImmModel::objectSync(const ImmsvOmObjectSync* req)
         if(err == SA_AIS_OK) {
             sObjectMap[objectName] = object; 
             classInfo->mExtent.insert(object);
+            if(object->mParent) {
+                addChildLink(sObjectMap.find(objectName));
+            }
             mpm = sMissingParents.find(objectName);
 
             TRACE_7("Object '%s' was synced ", objectName.c_str());
@@ -18336,6 +18459,7 @@ ImmModel::objectSync(const ImmsvOmObjectSync* req)
                 while(oi != mpm->second.end()) {
                     /* Correct the pointer from child to parent */
                     (*oi)->mParent = object;
+                    addChildLink(*oi, objectName);
                     ObjectInfo* grandParent = object;
                         do {
                             grandParent->mChildCount += ((*oi)->mChildCount + 1);
@@ -18409,6 +18533,85 @@ ImmModel::getObjectName(ObjectInfo* info, std::string& objName)
     }
 }
 
+void
+ImmModel::addChildLink(ObjectMap::iterator oi)
+{
+    osafassert(oi != sObjectMap.end());
+    osafassert(oi->second->mParent);
+    sChildIndex[oi->second->mParent].insert(oi);
+}
+
+void
+ImmModel::addChildLink(ObjectInfo* child, const std::string& parentName)
+{
+    /* Used when a missing parent shows up during loading or sync. The child
+       is already in sObjectMap, but the ancestors of the parent may still be
+       missing, so the DN of the child is built from its RDN and parentName.
+    */
+    AttrMap::iterator i4 = std::find_if(child->mClassInfo->mAttrMap.begin(),
+        child->mClassInfo->mAttrMap.end(), AttrFlagIncludes(SA_IMM_ATTR_RDN));
+    osafassert(i4 != child->mClassInfo->mAttrMap.end());
+    ImmAttrValueMap::iterator oavi = child->mAttrValueMap.find(i4->first);
+    osafassert(oavi != child->mAttrValueMap.end());
+
+    std::string childName(oavi->second->getValueC_str());
+    if(child->mObjFlags & IMM_DN_INTERNAL_REP) {
+        (void) nameToInternal(childName);
+    }
+    childName.append(",");
+    childName.append(parentName);
+    addChildLink(sObjectMap.find(childName));
+}
+
+void
+ImmModel::removeChildLinks(ObjectMap::iterator oi)
+{
+    ObjectInfo* obj = oi->second;
+    if(obj->mParent) {
+        ChildIndexMap::iterator ci = sChildIndex.find(obj->mParent);
+        if(ci != sChildIndex.end()) {
+            ci->second.erase(oi);
+            if(ci->second.empty()) {
+                sChildIndex.erase(ci);
+            }
+        }
+    }
+    /* Children still in sObjectMap (cascading delete or abort of a created
+       subtree in progress) are removed from the index with their parent.
+       Their parent link would dangle once obj is deleted, so clear it. */
+    ChildIndexMap::iterator own = sChildIndex.find(obj);
+    if(own != sChildIndex.end()) {
+        ChildSet::iterator ch;
+        for(ch = own->second.begin(); ch != own->second.end(); ++ch) {
+            (*ch)->second->mParent = NULL;
+        }
+        sChildIndex.erase(own);
+    }
+}
+
+void
+ImmModel::collectSubtree(ObjectMap::iterator root, SaImmScopeT scope,
+    ObjectIterVector& result)
+{
+    /* Breadth first, root first. The result vector is also the queue, so
+       the objects come level by level and the siblings of each parent in DN
+       order. This is not the sObjectMap (DN string) order that the old scan
+       of the whole map produced; callers must not depend on a parent being
+       adjacent to its children.
+    */
+    result.push_back(root);
+    for(size_t ix = 0; ix < result.size(); ++ix) {
+        ChildIndexMap::iterator ci = sChildIndex.find(result[ix]->second);
+        if(ci == sChildIndex.end()) {
+            continue;
+        }
+        result.insert(result.end(), ci->second.begin(), ci->second.end());
+        if(scope == SA_IMM_SUBLEVEL) {
+            break;
+        }
+    }
+}
+
 void
 ImmModel::getParentDn(std::string& parentName, const std::string& objectName)
 {
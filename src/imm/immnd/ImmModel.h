@@ -25,6 +25,7 @@
 #include <vector>
 #include <map>
 #include "imm/immsv_api.h"
+#include "imm/immnd/ImmIndexedMap.h"
 
 struct ClassInfo;
 struct CcbInfo;
@@ -73,7 +74,8 @@ typedef std::vector<SaUint32T> ConnVector;
 typedef std::vector<unsigned int> NodeIdVector;
 typedef std::vector<std::string> ObjectNameVector;
 typedef std::vector<SaUint32T> IdVector;
-typedef std::map<std::string, ObjectInfo*> ObjectMap;
+typedef ImmIndexedMap<ObjectInfo*> ObjectMap;
+typedef std::vector<ObjectMap::iterator> ObjectIterVector;
 typedef std::vector<SaInvocationT> InvocVector;
 
 /* Maps an object pointer, to a set of object pointers.*/
@@ -696,6 +698,16 @@ private:
                                                     ObjectInfo *obj,
                                                     ObjectNameSet &dnSet);
 
+    void               addChildLink(ObjectMap::iterator oi);
+    void               addChildLink(
+                                    ObjectInfo* child,
+                                    const std::string& parentName);
+    void               removeChildLinks(ObjectMap::iterator oi);
+    void               collectSubtree(
+                                      ObjectMap::iterator root,
+                                      SaImmScopeT scope,
+                                      ObjectIterVector& result);
+
     void               commitCreate(ObjectInfo* afim);
     bool               commitModify(const std::string& dn, ObjectInfo* afim);
     void               commitDelete(const std::string& dn);
@@ -41,6 +41,18 @@ ImmSearchOp::~ImmSearchOp()
     classInfo = NULL;
 }
 
+static IMMSV_ATTR_VALUES_LIST*
+newAttrValues(const SearchAttribute& attr)
+{
+    IMMSV_ATTR_VALUES_LIST* attrl = (IMMSV_ATTR_VALUES_LIST *)
+        calloc(1, sizeof(IMMSV_ATTR_VALUES_LIST));
+    osafassert(attrl);
+    attrl->n.attrName.size = (int)attr.name.length()+1;
+    attrl->n.attrName.buf = strdup(attr.name.c_str());
+    attrl->n.attrValueType = attr.valueType;
+    return attrl;
+}
+
 void
 ImmSearchOp::addObject(
                        const std::string& objectName)
@@ -61,6 +73,8 @@ ImmSearchOp::addAttribute(const std::string& attributeName,
     SearchAttribute& attr = obj.attributeList.back();  
     attr.valueType = (SaImmValueTypeT) valueType;
     attr.flags = flags;
+
+    attr.attrl = newAttrValues(attr);
 }
 
 void
@@ -68,10 +82,17 @@ ImmSearchOp::addAttrValue(const ImmAttrValue& value)
 {
     SearchObject& obj = mResultList.back();
     SearchAttribute& attr = obj.attributeList.back();
-    if(value.isMultiValued() && value.extraValues()) {
-        attr.valuep = new ImmAttrMultiValue(*((ImmAttrMultiValue  *) &value));
-    } else {
-        attr.valuep = new ImmAttrValue(value);
+    IMMSV_ATTR_VALUES* av = &(attr.attrl->n);
+    osafassert(av->attrValuesNumber == 0);
+    if(value.empty()) {
+        return;
+    }
+    av->attrValuesNumber = value.extraValues() + 1;
+    value.copyValueToEdu(&(av->attrValue), attr.valueType);
+    if(av->attrValuesNumber > 1) {
+        osafassert(value.isMultiValued());
+        ((const ImmAttrMultiValue *) &value)->
+            copyExtraValuesToEdu(&(av->attrMoreValues), attr.valueType);
     }
 }
 
@@ -132,54 +153,41 @@ ImmSearchOp::nextResult(IMMSV_OM_RSP_SEARCH_NEXT** rsp, void** implInfo,
         p->objectName.buf = strdup(obj.name.c_str());
         p->attrValuesList = NULL;
         
-        // Get attribute values
+        // Hand over the attribute values prepared at search initialize
         AttributeList::iterator i;
         for (i = obj.attributeList.begin(); i != obj.attributeList.end(); ++i) {
-            IMMSV_ATTR_VALUES_LIST* attrl = (IMMSV_ATTR_VALUES_LIST *)
-                calloc(1, sizeof(IMMSV_ATTR_VALUES_LIST));
-            IMMSV_ATTR_VALUES* attr = &(attrl->n);
-            attr->attrName.size = (int)(*i).name.length()+1;
-            attr->attrName.buf = strdup((*i).name.c_str());
-            attr->attrValueType = (*i).valueType;
+            IMMSV_ATTR_VALUES_LIST* attrl = (*i).attrl;
+            if(attrl) {
+                (*i).attrl = NULL;
+            } else {
+                //Values already handed over, the object is re-fetched
+                //after a failed fetch of runtime attributes.
+                attrl = newAttrValues(*i);
+            }
             
             if(rtsToFetch && ((*i).flags & SA_IMM_ATTR_RUNTIME) &&
                 ! ((*i).flags & SA_IMM_ATTR_CACHED)) {
                 //The non-cached rt-attr must in general be fetched
                 mRtsToFetch.push_back(*i);
-                mRtsToFetch.back().valuep=NULL;/*Unused & crashes destructor.*/
                 *rtsToFetch = &mRtsToFetch;
                 *implInfo = obj.implInfo;
-            }
-            
-            if((*i).valuep) {
-                //There is possibly a value for the attribute in the OI
-                if(rtsToFetch && ((*i).flags & SA_IMM_ATTR_RUNTIME) &&
-                    ! ((*i).flags & SA_IMM_ATTR_CACHED) &&
-                    ! ((*i).flags & SA_IMM_ATTR_PERSISTENT)) {
+                
+                if(! ((*i).flags & SA_IMM_ATTR_PERSISTENT) &&
+                    attrl->n.attrValuesNumber) {
                     //Dont set any value for non-cached and non-persistent
                     //runtime attributes, unless this is the local fetch
                     //of just those runtime attributes
-                    attr->attrValuesNumber=0;
-                } else if((*i).valuep->empty()) {
-                    //Value fetched from the OI for the attribute is empty.
-                    attr->attrValuesNumber=0;
-                } else {
-                    attr->attrValuesNumber = (*i).valuep->extraValues() + 1;
-                    (*i).valuep->copyValueToEdu(&(attr->attrValue),
-                        (SaImmValueTypeT) attr->attrValueType);
-                    if(attr->attrValuesNumber > 1) {
-                        osafassert((*i).valuep->isMultiValued());
-                        ((ImmAttrMultiValue *)(*i).valuep)->
-                            copyExtraValuesToEdu(&(attr->attrMoreValues),
-                                (SaImmValueTypeT) attr->attrValueType);
+                    immsv_evt_free_att_val(&(attrl->n.attrValue),
+                        (SaImmValueTypeT) attrl->n.attrValueType);
+                    if(attrl->n.attrValuesNumber > 1) {
+                        immsv_free_attr_list_raw(attrl->n.attrMoreValues,
+                            attrl->n.attrValueType);
+                        attrl->n.attrMoreValues = NULL;
                     }
+                    attrl->n.attrValuesNumber=0;
                 }
-                delete (*i).valuep;
-                (*i).valuep=NULL;
-            } else {
-                //There is no current value for the attribute
-                attr->attrValuesNumber=0;
             }
+            
             attrl->next = p->attrValuesList;
             p->attrValuesList = attrl;
         }
@@ -204,6 +212,9 @@ SearchObject::~SearchObject()
 
 SearchAttribute::~SearchAttribute()
 {
-    delete valuep;
-    valuep = NULL;
+    if(attrl) {
+        osafassert(attrl->next == NULL);
+        immsv_free_attrvalues_list(attrl);
+        attrl = NULL;
+    }
 }
@@ -26,13 +26,20 @@
 #include "immnd.h"
 
 
+/*
+  The values of a search result are snapshot at search initialize directly
+  into the EDU form (attrl) that is sent to the agent. nextResult() then
+  hands the prepared node over to the reply instead of copying the values
+  a second time. Whoever copies a SearchAttribute must clear attrl in the
+  copy, the node is owned by one SearchAttribute only.
+*/
 struct SearchAttribute
 {
     SearchAttribute(const std::string& attributeName) : name(attributeName),
-                                                        valuep(NULL), flags(0)
+                                                        attrl(NULL), flags(0)
     { valueType = (SaImmValueTypeT) 0;}
     std::string name;
-    ImmAttrValue*     valuep;
+    IMMSV_ATTR_VALUES_LIST* attrl;
     SaImmValueTypeT  valueType;
     SaImmAttrFlagsT flags;
 
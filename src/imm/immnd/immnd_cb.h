@@ -40,6 +40,8 @@ typedef enum immnd_server_state {
 typedef struct immnd_om_search_node {
 	SaUint32T searchId;
 	void *searchOp;
+	SaUint32T bundleSize;	/* Max results in next search bundle, grows
+				   while the client keeps iterating. */
 	struct immnd_om_search_node *next;
 } IMMND_OM_SEARCH_NODE;
 
@@ -98,6 +100,8 @@ typedef struct immnd_cb_tag {
 
 	/*Nr of FEVS messages sent, but not received back at origin.*/
 	uint8_t fevs_replies_pending; 
+	/*Max nr of FEVS messages in flight, IMMSV_FEVS_MAX_PENDING.*/
+	uint8_t mFevsMaxPending;
 
 	SaUint32T cli_id_gen;	/* for generating client_id */
 
@@ -134,6 +138,8 @@ typedef struct immnd_cb_tag {
 	bool mForceClean; //true => Force cleanTheHouse to run once *now*.
 	SaUint32T mScAbsenceAllowed; /* Non zero if SC absence is allowed (loss of both IMMDs/SCs).
 				       Value is number of seconds of SC absence tolerated. */
+	bool mObjLoadAllowed; /* IMMD found that all IMMNDs handle IMMND_EVT_A2ND_OBJ_LOAD
+				 when loading started. */
 
 	/* Information about the IMMD */
 	MDS_DEST immd_mdest_id;
@@ -204,7 +210,8 @@ void immnd_client_node_tree_destroy(IMMND_CB *cb);
 */
 
 /*30B Versioning Changes */
-#define IMMND_MDS_PVT_SUBPART_VERSION 1
+/* 2: handles IMMND_EVT_A2ND_OBJ_LOAD, see IMMSV_IMMND_MDS_VER_OBJ_LOAD */
+#define IMMND_MDS_PVT_SUBPART_VERSION 2
 
 /*IMMND - IMMA communication */
 #define IMMND_WRT_IMMA_SUBPART_VER_MIN 1
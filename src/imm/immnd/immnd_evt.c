@@ -36,12 +36,17 @@
 /* Adjust to 90% of MDS_DIRECT_BUF_MAXSIZE  */
 #define IMMND_SEARCH_BUNDLE_SIZE ((MDS_DIRECT_BUF_MAXSIZE / 100) * 90)   
 #define IMMND_MAX_SEARCH_RESULT (IMMND_SEARCH_BUNDLE_SIZE / 300)  
+/* First bundle of an iteration. Doubled for each following searchNext up to
+   IMMND_MAX_SEARCH_RESULT, so that short lived iterators (read one object
+   then finalize) do not pay for building a full bundle. */
+#define IMMND_MIN_SEARCH_RESULT 8
 
 // Same strings exists in ImmModel.cc
 #define IMM_VALIDATION_ABORT	"IMM: Validation abort: "
 #define IMM_RESOURCE_ABORT		"IMM: Resource abort: "
 
-static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq, const IMMSV_SEND_INFO *sinfo);
+static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq, const IMMSV_SEND_INFO *sinfo,
+	bool *ackOnForward);
 static uint32_t immnd_evt_proc_cb_dump(IMMND_CB *cb);
 static uint32_t immnd_evt_proc_imm_init(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SEND_INFO *sinfo, SaBoolT isOm);
 static uint32_t immnd_evt_proc_imm_finalize(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SEND_INFO *sinfo, SaBoolT isOm);
@@ -174,6 +179,8 @@ static void immnd_evt_pbe_admop_rsp(IMMND_CB *cb,
 static void immnd_evt_proc_object_sync(IMMND_CB *cb,
 	IMMND_EVT *evt, SaBoolT originatedAtThisNd, SaImmHandleT clnt_hdl, MDS_DEST reply_dest, SaUint64T msgNo);
 
+static void immnd_evt_proc_object_load(IMMND_CB *cb, IMMND_EVT *evt);
+
 static void immnd_evt_proc_ccb_apply(IMMND_CB *cb, IMMND_EVT *evt, SaBoolT originatedAtThisNd,
 	                             SaImmHandleT clnt_hdl, MDS_DEST reply_dest, SaBoolT validateOnly);
 
@@ -446,6 +453,24 @@ uint32_t immnd_evt_destroy(IMMSV_EVT *evt, SaBoolT onheap, uint32_t line)
 			}
 		}
 
+	} else if (evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD) {
+		IMMSV_OM_OBJECT_SYNC* obj = &(evt->info.immnd.info.objLoad.objects);
+		IMMSV_OM_OBJECT_SYNC* next = obj->next;
+
+		/* Top object resides in evt. */
+		free(obj->className.buf);
+		free(obj->objectName.buf);
+		immsv_free_attrvalues_list(obj->attrValues);
+		memset(obj, '\0', sizeof(IMMSV_OM_OBJECT_SYNC));
+
+		while(next) {
+			obj = next;
+			next = obj->next;
+			free(obj->className.buf);
+			free(obj->objectName.buf);
+			immsv_free_attrvalues_list(obj->attrValues);
+			free(obj);
+		}
 	} else if ((evt->info.immnd.type == IMMND_EVT_A2ND_CLASS_CREATE) ||
 		   (evt->info.immnd.type == IMMND_EVT_A2ND_CLASS_DESCR_GET) ||
 		   (evt->info.immnd.type == IMMND_EVT_A2ND_CLASS_DELETE)) {
@@ -1486,11 +1511,11 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 	IMMSV_OM_RSP_SEARCH_NEXT **rspList = NULL;
 	MDS_DEST implDest = 0LL;
 	SaBoolT retardSync = 
-		((cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) && 
+		((cb->fevs_replies_pending >= cb->mFevsMaxPending) && 
 			cb->mIsCoord && (cb->syncPid > 0));
 	SaUint32T resultSize = 0;
 	IMMSV_OM_RSP_SEARCH_BUNDLE_NEXT bundleSearch = {0, NULL};
-	int ix;
+	SaUint32T ix;
 	SaBoolT isAccessor = SA_FALSE;
 	SaUint32T oiTimeout = 0;
 
@@ -1638,13 +1663,25 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 		SaAisErrorT err;
 		SaBoolT bRtAttrs;
 		uint32_t size = search_result_size(rsp);
+		SaUint32T maxResults;
 		resultSize = 1;
 		isAccessor = immModel_isSearchOpAccessor(sn->searchOp);
 
-		/* Repeat to the maximum search result,
+		if (sn->bundleSize < IMMND_MIN_SEARCH_RESULT) {
+			sn->bundleSize = IMMND_MIN_SEARCH_RESULT;
+		}
+		maxResults = sn->bundleSize;
+		if (sn->bundleSize < IMMND_MAX_SEARCH_RESULT) {
+			sn->bundleSize *= 2;
+			if (sn->bundleSize > IMMND_MAX_SEARCH_RESULT) {
+				sn->bundleSize = IMMND_MAX_SEARCH_RESULT;
+			}
+		}
+
+		/* Repeat to the maximum search result for this bundle,
 		 * or the size os search results becomes bigger then IMMND_SEARCH_BUNDLE_SIZE,
 		 * or till the object with at least one pure runtime attribute */
-		while(resultSize < IMMND_MAX_SEARCH_RESULT && size < IMMND_SEARCH_BUNDLE_SIZE) {
+		while(resultSize < maxResults && size < IMMND_SEARCH_BUNDLE_SIZE) {
 			err = immModel_testTopResult(sn->searchOp, &implNodeId, &bRtAttrs);
 			if ((err != SA_AIS_OK) || (bRtAttrs == SA_TRUE))
 				break;
@@ -1652,13 +1689,19 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 			err = immModel_nextResult(cb, sn->searchOp, &rsp1, &implConn, &implNodeId, &rtAttrs,
 					&implDest, retardSync, NULL);
 			if(err != SA_AIS_OK) {
-				osafassert(err == SA_AIS_ERR_NOT_EXIST);
+				/* A sync iterator does not advance on an error. Throttling
+				   (retardSync, ERR_TRY_AGAIN) is only checked before the first
+				   result of a searchNext, so here the error is ERR_NO_RESOURCES
+				   (sync aborted by a blocked PRTA update). The client gets the
+				   bundle collected so far and the error on the next searchNext. */
+				osafassert(err == SA_AIS_ERR_NOT_EXIST ||
+					immModel_isSearchOpSync(sn->searchOp));
 				break;
 			}
 
 			if(resultSize == 1) {
 				rspList = (IMMSV_OM_RSP_SEARCH_NEXT **)
-					calloc(IMMND_MAX_SEARCH_RESULT, sizeof(IMMSV_OM_RSP_SEARCH_NEXT *));
+					calloc(maxResults, sizeof(IMMSV_OM_RSP_SEARCH_NEXT *));
 				rspList[0] = rsp;
 				rsp = NULL;
 			}
@@ -1683,10 +1726,7 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 		} else {
 			osafassert(rspList);
 			bundleSearch.resultSize = resultSize;
-			bundleSearch.searchResult = (IMMSV_OM_RSP_SEARCH_NEXT **)
-				malloc(sizeof(IMMSV_OM_RSP_SEARCH_NEXT *) * resultSize);
-			for(ix=0; ix<resultSize; ix++)
-				bundleSearch.searchResult[ix] = rspList[ix];
+			bundleSearch.searchResult = rspList;	/* borrowed */
 
 			send_evt.info.imma.type = IMMA_EVT_ND2A_SEARCHBUNDLENEXT_RSP;
 			send_evt.info.imma.info.searchBundleNextRsp = &bundleSearch;
@@ -1704,7 +1744,7 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 	}
 
 	if(rspList) {
-		for(ix=0; ix<IMMND_MAX_SEARCH_RESULT; ix++) {
+		for(ix=0; ix<resultSize; ix++) {
 			if(rspList[ix]) {
 				freeSearchNext(rspList[ix], true);
 			}
@@ -1714,10 +1754,6 @@ static uint32_t immnd_evt_proc_search_next(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_S
 		immModel_clearLastResult(sn->searchOp);
 	}
 
-	if(bundleSearch.searchResult) {
-		free(bundleSearch.searchResult);
-	}
-
 	if (rtAttrsToFetch) {
 		immsv_evt_free_attrNames(rtAttrsToFetch);
 	}
@@ -2396,9 +2432,9 @@ static uint32_t immnd_evt_proc_admowner_init(IMMND_CB *cb, IMMND_EVT *evt, IMMSV
 		goto agent_rsp;
 	}
 
-	if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+	if (cb->fevs_replies_pending >= cb->mFevsMaxPending) {
 		TRACE_2("ERR_TRY_AGAIN: Too many pending incoming fevs messages (> %u) rejecting admo_init request", 
-			IMMSV_DEFAULT_FEVS_MAX_PENDING);
+			cb->mFevsMaxPending);
 		send_evt.info.imma.info.admInitRsp.error = SA_AIS_ERR_TRY_AGAIN;
 		goto agent_rsp;
 	}
@@ -2511,9 +2547,9 @@ static uint32_t immnd_evt_proc_impl_set(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SEND
 		goto agent_rsp;
 	}
 
-	if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+	if (cb->fevs_replies_pending >= cb->mFevsMaxPending) {
 		TRACE_2("ERR_TRY_AGAIN: Too many pending incoming fevs messages (> %u) rejecting impl_set request",
-			IMMSV_DEFAULT_FEVS_MAX_PENDING);
+			cb->mFevsMaxPending);
 		send_evt.info.imma.info.implSetRsp.error = SA_AIS_ERR_TRY_AGAIN;
 		goto agent_rsp;
 	}
@@ -2662,9 +2698,9 @@ static uint32_t immnd_evt_proc_ccb_init(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SEND
 		goto agent_rsp;
 	}
 
-	if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+	if (cb->fevs_replies_pending >= cb->mFevsMaxPending) {
 		TRACE_2("ERR_TRY_AGAIN: Too many pending incoming fevs messages (> %u) rejecting ccb_init request",
-			IMMSV_DEFAULT_FEVS_MAX_PENDING);
+			cb->mFevsMaxPending);
 		send_evt.info.imma.info.ccbInitRsp.error = SA_AIS_ERR_TRY_AGAIN;
 		goto agent_rsp;
 	}
@@ -2808,9 +2844,9 @@ static uint32_t immnd_evt_proc_rt_update(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SEN
 		   code branch if imm is not writbale.
 		 */	
 
-		if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+		if (cb->fevs_replies_pending >= cb->mFevsMaxPending) {
 			TRACE_2("ERR_TRY_AGAIN: Too many pending incoming fevs messages (> %u) rejecting rt_update request",
-				IMMSV_DEFAULT_FEVS_MAX_PENDING);
+				cb->mFevsMaxPending);
 			err = SA_AIS_ERR_TRY_AGAIN;
 			goto agent_rsp;
 		}
@@ -2927,6 +2963,7 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 	IMMND_IMM_CLIENT_NODE *cl_node = NULL;
 	SaImmHandleT client_hdl;
         SaBoolT asyncReq = (!sinfo || sinfo->stype != MDS_SENDTYPE_SNDRSP);
+	bool ackOnForward = false;
 
 	TRACE_2("sender_count: %llu size: %u ", evt->info.fevsReq.sender_count, evt->info.fevsReq.msg.size);
 
@@ -2981,7 +3018,7 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 	}
 
 	if(newMsg) {
-		error = immnd_fevs_local_checks(cb, &(evt->info.fevsReq), sinfo);
+		error = immnd_fevs_local_checks(cb, &(evt->info.fevsReq), sinfo, &ackOnForward);
 		if(error != SA_AIS_OK) {
 			/*Fevs request will NOT be forwarded to IMMD.
 			  Return directly with error or OK for idempotent requests.
@@ -3055,7 +3092,7 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 
 	/* If overflow .....OR IMMD is down.....OR sync is on-going AND out-queue is not empty => 
 	   go via out-queue. The sync should be throttled by immnd_evt_proc_search_next. */
-	if ((cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) || !immnd_is_immd_up(cb) ||
+	if ((cb->fevs_replies_pending >= cb->mFevsMaxPending) || !immnd_is_immd_up(cb) ||
 		((cb->mState == IMM_SERVER_SYNC_SERVER) && cb->fevs_out_count && asyncReq && newMsg)) {
 		if(asyncReq) {
 
@@ -3072,11 +3109,11 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 			if(backlog%50) {
 				TRACE_2("Too many pending incoming FEVS messages (> %u) "
 					"enqueueing async message. Backlog:%u",
-					IMMSV_DEFAULT_FEVS_MAX_PENDING, backlog);
+					cb->mFevsMaxPending, backlog);
 			} else {
 				LOG_IN("Too many pending incoming FEVS messages (> %u) "
 					"enqueueing async message. Backlog:%u",
-					IMMSV_DEFAULT_FEVS_MAX_PENDING, backlog);
+					cb->mFevsMaxPending, backlog);
 			}
 
 			return NCSCC_RC_SUCCESS;
@@ -3084,7 +3121,7 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 			/* Syncronous message, never goes to out-queue, instead push back to user.
 			   Should only be for the overflow case. */
 			TRACE_2("ERR_TRY_AGAIN: Too many pending FEVS message replies (> %u) rejecting request",
-				IMMSV_DEFAULT_FEVS_MAX_PENDING);
+				cb->mFevsMaxPending);
 			error = SA_AIS_ERR_TRY_AGAIN;
 			goto agent_rsp;
 		}
@@ -3126,6 +3163,15 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 		}
 	}
 
+	if(ackOnForward) {
+		/* Bulk load batch. The loader gets its reply as soon as the
+		   message is on its way to IMMD. The sender is still throttled
+		   by fevs_replies_pending above and any failure is reported by
+		   the apply of the loading ccb. */
+		error = SA_AIS_OK;
+		goto agent_rsp;
+	}
+
 	/*Save sinfo in continuation. 
 	   Note should set up a wait time for the continuation roughly in line
 	   with IMMSV_WAIT_TIME. */
@@ -3196,7 +3242,7 @@ static uint32_t immnd_evt_proc_fevs_forward(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_
 
 */
 static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq,
-		const IMMSV_SEND_INFO *sinfo)
+		const IMMSV_SEND_INFO *sinfo, bool *ackOnForward)
 {
 	SaAisErrorT error = SA_AIS_OK;
 	osafassert(fevsReq);
@@ -3326,7 +3372,7 @@ static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq,
 		}
 		/* intentional fallthrough. */
 	case IMMND_EVT_A2ND_CCB_APPLY:
-		if(immModel_pbeNotWritable(cb) || (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) 
+		if(immModel_pbeNotWritable(cb) || (cb->fevs_replies_pending >= cb->mFevsMaxPending) 
 			|| !immnd_is_immd_up(cb)) {
 			/* NO_RESOURCES is here imm internal proxy for TRY_AGAIN.
 			   The library code for saImmOmCcbApply will translate NO_RESOURCES
@@ -3336,9 +3382,9 @@ static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq,
 			   towards that particular library code. 
 			 */
 			error = SA_AIS_ERR_NO_RESOURCES;
-			if (cb->fevs_replies_pending >= IMMSV_DEFAULT_FEVS_MAX_PENDING) {
+			if (cb->fevs_replies_pending >= cb->mFevsMaxPending) {
 				TRACE_2("ERR_TRY_AGAIN: Too many pending FEVS message replies (> %u) rejecting request" 
-					"for CcbApply", IMMSV_DEFAULT_FEVS_MAX_PENDING);
+					"for CcbApply", cb->mFevsMaxPending);
                        }
 		}
 		break;
@@ -3356,6 +3402,25 @@ static SaAisErrorT immnd_fevs_local_checks(IMMND_CB *cb, IMMSV_FEVS *fevsReq,
 		}
 		break;
 
+	case IMMND_EVT_A2ND_OBJ_LOAD:
+		if(fevsReq->sender_count != 0x0) {
+			LOG_WA("ERR_LIBRARY: IMMND_EVT_A2ND_OBJ_LOAD fevsReq->sender_count != 0x0");
+			error = SA_AIS_ERR_LIBRARY;
+		} else if(!isLoading || !sinfo || (sinfo->pid != cb->loaderPid)) {
+			LOG_WA("ERR_LIBRARY: IMMND_EVT_A2ND_OBJ_LOAD can only arrive from loader during loading");
+			error = SA_AIS_ERR_LIBRARY;
+		} else if(!cb->mObjLoadAllowed) {
+			/* Not all IMMNDs handle the message, see immd_announce_load_ok.
+			   The loader falls back to regular object creates. */
+			LOG_NO("Bulk load of objects rejected, not allowed by IMMD");
+			error = SA_AIS_ERR_VERSION;
+		} else {
+			/* The loader is throttled by fevs_replies_pending only, the
+			   outcome comes with the apply of the loading ccb. */
+			*ackOnForward = true;
+		}
+		break;
+
 	case IMMND_EVT_A2ND_IMM_ADMOP:
 	case IMMND_EVT_A2ND_IMM_ADMOP_ASYNC:
 		/* No restrictions at cluster level. */
@@ -5766,6 +5831,31 @@ static uint32_t immnd_evt_proc_sync_finalize(IMMND_CB *cb, IMMND_EVT *evt, IMMSV
 	return proc_rc;
 }
 
+/****************************************************************************
+ * Name          : immnd_evt_proc_object_load
+ *
+ * Description   : Function to process a batch of object creates in the
+ *                 loading ccb, sent by the loader (immsv_load).
+ *                 The loader has already got its reply when the batch was
+ *                 forwarded, so no reply is sent here. A failure vetoes
+ *                 the loading ccb and is reported by the ccb apply.
+ *
+ * Arguments     : IMMND_CB *cb - IMMND CB pointer
+ *                 IMMND_EVT *evt - Received Event structure
+ *
+ * Return Values : None
+ *
+ *****************************************************************************/
+static void immnd_evt_proc_object_load(IMMND_CB *cb, IMMND_EVT *evt)
+{
+	SaAisErrorT err;
+	TRACE_ENTER();
+
+	err = immModel_ccbObjectLoad(cb, &(evt->info.objLoad));
+
+	TRACE_LEAVE2("Batch for ccb %u: %u", evt->info.objLoad.ccbId, err);
+}
+
 /****************************************************************************
  * Name          : immnd_evt_proc_object_sync
  *
@@ -8270,6 +8360,10 @@ immnd_evt_proc_fevs_dispatch(IMMND_CB *cb, IMMSV_OCTET_STRING *msg,
 		immnd_evt_proc_object_sync(cb, &frwrd_evt.info.immnd, originatedAtThisNd, clnt_hdl, reply_dest, msgNo);
 		break;
 
+	case IMMND_EVT_A2ND_OBJ_LOAD:
+		immnd_evt_proc_object_load(cb, &frwrd_evt.info.immnd);
+		break;
+
 	case IMMND_EVT_A2ND_IMM_ADMOP:
 	case IMMND_EVT_A2ND_IMM_ADMOP_ASYNC:
 		immnd_evt_proc_admop(cb, &frwrd_evt.info.immnd, originatedAtThisNd, clnt_hdl, reply_dest);
@@ -8786,7 +8880,9 @@ static uint32_t immnd_evt_proc_loading_ok(IMMND_CB *cb, IMMND_EVT *evt, IMMSV_SE
 {
 	TRACE_ENTER();
 	cb->mRulingEpoch = evt->info.ctrl.rulingEpoch;
-	TRACE_2("Loading can start, ruling epoch:%u", cb->mRulingEpoch);
+	cb->mObjLoadAllowed = (evt->info.ctrl.canBeCoord == 1);
+	TRACE_2("Loading can start, ruling epoch:%u bulk load:%u", cb->mRulingEpoch,
+		cb->mObjLoadAllowed);
 
 	if ((cb->mState == IMM_SERVER_LOADING_PENDING) || (cb->mState == IMM_SERVER_LOADING_CLIENT)) {
 		osafassert(((cb->mMyEpoch + 1) == cb->mRulingEpoch));
@@ -9033,12 +9129,12 @@ void dequeue_outgoing(IMMND_CB *cb)
 	TRACE_ENTER();
 	IMMND_EVT dummy_evt;
 	
-	unsigned int space = (cb->fevs_replies_pending < IMMSV_DEFAULT_FEVS_MAX_PENDING)?
-		(IMMSV_DEFAULT_FEVS_MAX_PENDING - cb->fevs_replies_pending):0;
+	unsigned int space = (cb->fevs_replies_pending < cb->mFevsMaxPending)?
+		(cb->mFevsMaxPending - cb->fevs_replies_pending):0;
 
 	TRACE("Pending replies:%u space:%u out list?:%p", cb->fevs_replies_pending, space, cb->fevs_out_list);
 
-	while(cb->fevs_out_list && space && (cb->fevs_replies_pending < IMMSV_DEFAULT_FEVS_MAX_PENDING) && immnd_is_immd_up(cb)){
+	while(cb->fevs_out_list && space && (cb->fevs_replies_pending < cb->mFevsMaxPending) && immnd_is_immd_up(cb)){
 		memset(&dummy_evt, '\0', sizeof(IMMND_EVT));
 		unsigned int backlog = 
 			immnd_dequeue_outgoing_fevs_msg(cb, &dummy_evt.info.fevsReq.msg, &dummy_evt.info.fevsReq.client_hdl);
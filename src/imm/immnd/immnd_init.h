@@ -173,6 +173,8 @@ extern "C" {
 		    SaUint32T *continuationId, SaUint32T *pbeConn, SaClmNodeIdT *pbeNodeId, 
 		    SaNameT* objName, bool* dnOrRdnIsLong, bool isObjectDnUsed);
 
+	SaAisErrorT immModel_ccbObjectLoad(IMMND_CB *cb, struct ImmsvOmObjectLoad *req);
+
 	SaUint32T immModel_getLocalAppliersForObj(IMMND_CB *cb, const SaNameT* objName, SaUint32T ccbId,
                 SaUint32T **aplConnArr, SaBoolT externalRep);
 	SaUint32T immModel_getLocalAppliersForCcb(IMMND_CB *cb, SaUint32T ccbId, SaUint32T **aplConnArr,
@@ -226,6 +228,8 @@ extern "C" {
 
 	SaBoolT immModel_isSearchOpAccessor(void* searchOp);
 
+	SaBoolT immModel_isSearchOpSync(void* searchOp);
+
 	SaBoolT immModel_isSearchOpNonExtendedNameSet(void* searchOp);
 
 	void immModel_setAdmReqContinuation(IMMND_CB *cb, SaInvocationT invoc, SaUint32T reqCon);
@@ -163,6 +163,24 @@ static uint32_t immnd_initialize(char *progname)
 		immnd_cb->mWaitSecs = waitSecs;
 	}
 
+	immnd_cb->mFevsMaxPending = IMMSV_DEFAULT_FEVS_MAX_PENDING;
+	if ((envVar = getenv("IMMSV_FEVS_MAX_PENDING"))) {
+		int maxPending = atoi(envVar);
+		if(maxPending > 255) {
+			LOG_WA("IMMSV_FEVS_MAX_PENDING set to %u, must be "
+				"less than 256. Setting to 255", maxPending);
+			maxPending = 255;
+		} else if(maxPending < 1) {
+			LOG_WA("IMMSV_FEVS_MAX_PENDING set to %d, must be "
+				"at least 1. Setting to %u", maxPending,
+				IMMSV_DEFAULT_FEVS_MAX_PENDING);
+			maxPending = IMMSV_DEFAULT_FEVS_MAX_PENDING;
+		}
+		immnd_cb->mFevsMaxPending = (uint8_t) maxPending;
+		LOG_NO("Max number of pending FEVS messages set to %u",
+			immnd_cb->mFevsMaxPending);
+	}
+
 	if ((immnd_cb->mPbeFile = getenv("IMMSV_PBE_FILE")) != NULL) {
 		LOG_NO("Persistent Back-End capability configured, Pbe file:%s (suffix may get added)",
 			immnd_cb->mPbeFile);
@@ -0,0 +1,133 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION: Measures the heap and RSS used by the attribute values of a
+               model, and the time to create, copy and delete them.
+
+  Usage: immattrvaluebench [objects]
+
+  Each object gets the attribute mix of a typical AMF/SMF object: six
+  numeric values, two short strings and two DNs. Creating the values is
+  what loading does, copying them is what a CCB modify does when it
+  creates the after image and applies it.
+
+******************************************************************************/
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "imm/immnd/ImmAttrValue.h"
+
+namespace {
+
+const unsigned int kAttrsPerObject = 10;
+
+double Now() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the resident set size in KiB
+long RssKb() {
+  long pages = 0;
+  long rss = 0;
+  FILE* f = fopen("/proc/self/statm", "r");
+
+  if (f == nullptr) return 0;
+  if (fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+  fclose(f);
+  return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+size_t HeapBytes() { return mallinfo2().uordblks; }
+
+void SetValues(ImmAttrValue* values, unsigned int obj) {
+  char dn[128];
+  char str[8];
+  SaUint32T u32 = obj;
+  SaUint64T u64 = obj * 1000ULL;
+  IMMSV_OCTET_STRING os;
+
+  for (unsigned int i = 0; i < 4; i++) {
+    os.size = sizeof(u32);
+    os.buf = reinterpret_cast<char*>(&u32);
+    values[i].setValue(os);
+  }
+  for (unsigned int i = 4; i < 6; i++) {
+    os.size = sizeof(u64);
+    os.buf = reinterpret_cast<char*>(&u64);
+    values[i].setValue(os);
+  }
+  snprintf(str, sizeof(str), "s%u", obj % 100000);
+  values[6].setValueC_str(str);
+  values[7].setValueC_str("OK");
+  snprintf(dn, sizeof(dn), "safComp=Comp%u,safSu=Su%u,safSg=SgApp,safApp=App1",
+           obj, obj / 4);
+  values[8].setValueC_str(dn);
+  values[9].setValueC_str("safVersion=4.0.0,safSgType=SgTypeApp");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  unsigned int objects = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 200000;
+  unsigned int n = objects * kAttrsPerObject;
+
+  // The value objects themselves are allocated up front so that the
+  // figures below only show the memory owned by the values
+  std::vector<ImmAttrValue> values(n);
+  std::vector<ImmAttrValue> copies(n);
+  long rss = RssKb();
+  size_t heap = HeapBytes();
+
+  double start = Now();
+  for (unsigned int obj = 0; obj < objects; obj++) {
+    SetValues(&values[obj * kAttrsPerObject], obj);
+  }
+  double create = Now() - start;
+
+  printf("%u objects, %u values, sizeof(ImmAttrValue) %zu\n", objects, n,
+         sizeof(ImmAttrValue));
+  printf("value heap:   %10.1f MiB (%.1f bytes per value)\n",
+         (HeapBytes() - heap) / 1048576.0,
+         static_cast<double>(HeapBytes() - heap) / n);
+  printf("value RSS:    %10.1f MiB\n", (RssKb() - rss) / 1024.0);
+
+  start = Now();
+  for (unsigned int i = 0; i < n; i++) copies[i] = values[i];
+  double copy = Now() - start;
+
+  start = Now();
+  for (unsigned int i = 0; i < n; i++) {
+    values[i].discardValues();
+    copies[i].discardValues();
+  }
+  double discard = Now() - start;
+
+  printf("create:       %10.1f ns per value\n", create * 1e9 / n);
+  printf("copy:         %10.1f ns per value\n", copy * 1e9 / n);
+  printf("discard (x2): %10.1f ns per value\n", discard * 1e9 / n);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <cstring>
+#include <string>
+#include "imm/immnd/ImmAttrValue.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+IMMSV_OCTET_STRING Octets(const char* str) {
+  IMMSV_OCTET_STRING os;
+  os.size = strlen(str) + 1;
+  os.buf = const_cast<char*>(str);
+  return os;
+}
+
+const char kLong[] = "safComp=Comp1,safSu=Su1,safSg=SgApp,safApp=App1";
+
+}  // namespace
+
+TEST(ImmAttrValue, IsEmptyInitially) {
+  ImmAttrValue value;
+  EXPECT_TRUE(value.empty());
+  EXPECT_EQ(value.getValueC_str(), nullptr);
+  EXPECT_EQ(value.getValue_int(), 0);
+}
+
+TEST(ImmAttrValue, IntValue) {
+  ImmAttrValue value;
+  value.setValue_int(-42);
+  EXPECT_FALSE(value.empty());
+  EXPECT_EQ(value.getValue_int(), -42);
+  value.setValue_int(7);
+  EXPECT_EQ(value.getValue_int(), 7);
+
+  IMMSV_EDU_ATTR_VAL edu;
+  value.copyValueToEdu(&edu, SA_IMM_ATTR_SAINT32T);
+  EXPECT_EQ(edu.val.saint32, 7);
+}
+
+TEST(ImmAttrValue, ShortAndLongStrings) {
+  ImmAttrValue value;
+  value.setValueC_str("abc");
+  EXPECT_STREQ(value.getValueC_str(), "abc");
+  value.setValueC_str(kLong);
+  EXPECT_STREQ(value.getValueC_str(), kLong);
+  value.setValueC_str("xy");
+  EXPECT_STREQ(value.getValueC_str(), "xy");
+  value.setValueC_str(nullptr);
+  EXPECT_TRUE(value.empty());
+}
+
+TEST(ImmAttrValue, CopyAndAssign) {
+  ImmAttrValue shortValue;
+  ImmAttrValue longValue;
+  shortValue.setValueC_str("abc");
+  longValue.setValueC_str(kLong);
+
+  ImmAttrValue copy(longValue);
+  EXPECT_STREQ(copy.getValueC_str(), kLong);
+  EXPECT_NE(copy.getValueC_str(), longValue.getValueC_str());
+  copy = shortValue;
+  EXPECT_STREQ(copy.getValueC_str(), "abc");
+  copy = longValue;
+  EXPECT_STREQ(copy.getValueC_str(), kLong);
+
+  IMMSV_EDU_ATTR_VAL edu;
+  copy.copyValueToEdu(&edu, SA_IMM_ATTR_SASTRINGT);
+  EXPECT_EQ(edu.val.x.size, sizeof(kLong));
+  EXPECT_STREQ(edu.val.x.buf, kLong);
+  free(edu.val.x.buf);
+}
+
+TEST(ImmAttrMultiValue, RemoveShiftsMixedValues) {
+  ImmAttrMultiValue value;
+  value.setValue(Octets("a"));
+  value.setExtraValue(Octets(kLong));
+  value.setExtraValue(Octets("a"));
+  value.setExtraValueC_str("b");
+  EXPECT_EQ(value.extraValues(), 3U);
+  EXPECT_TRUE(value.hasDuplicates());
+
+  value.removeValue(Octets("a"));
+  EXPECT_EQ(value.extraValues(), 1U);
+  EXPECT_FALSE(value.hasDuplicates());
+  EXPECT_TRUE(value.hasMatchingValue(Octets(kLong)));
+  EXPECT_TRUE(value.hasExtraValueC_str("b"));
+
+  ImmAttrMultiValue copy(value);
+  EXPECT_TRUE(copy.hasMatchingValue(Octets(kLong)));
+  EXPECT_STREQ(copy.getValueC_str(), "b");
+  EXPECT_TRUE(copy.removeExtraValueC_str(kLong));
+  EXPECT_EQ(copy.extraValues(), 0U);
+
+  value.discardValues();
+  EXPECT_TRUE(value.empty());
+  EXPECT_EQ(value.extraValues(), 0U);
+}
@@ -0,0 +1,164 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <time.h>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "imm/immnd/ImmIndexedMap.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string MakeDn(unsigned i) {
+  char buf[128];
+  snprintf(buf, sizeof(buf),
+           "safComp=Comp%u,safSu=Su%u,safSg=SgApp,safApp=App%u", i, i / 10,
+           i / 1000);
+  return std::string(buf);
+}
+
+double ElapsedNs(const timespec& start, const timespec& end) {
+  return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+}  // namespace
+
+TEST(ImmIndexedMap, IsEmptyInitially) {
+  ImmIndexedMap<int*> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find("a=1"), map.end());
+}
+
+TEST(ImmIndexedMap, InsertAndFind) {
+  ImmIndexedMap<int> map;
+  for (unsigned i = 0; i < 1000; ++i) map[MakeDn(i)] = i;
+  EXPECT_EQ(map.size(), 1000U);
+  for (unsigned i = 0; i < 1000; ++i) {
+    ImmIndexedMap<int>::iterator it = map.find(MakeDn(i));
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->first, MakeDn(i));
+    EXPECT_EQ(it->second, static_cast<int>(i));
+  }
+  EXPECT_EQ(map.find(MakeDn(1000)), map.end());
+}
+
+TEST(ImmIndexedMap, InsertDoesNotOverwrite) {
+  ImmIndexedMap<int> map;
+  EXPECT_TRUE(map.insert(std::make_pair(std::string("a=1"), 1)).second);
+  EXPECT_FALSE(map.insert(std::make_pair(std::string("a=1"), 2)).second);
+  EXPECT_EQ(map.find("a=1")->second, 1);
+  EXPECT_EQ(map.size(), 1U);
+}
+
+TEST(ImmIndexedMap, IterationIsOrdered) {
+  ImmIndexedMap<int> map;
+  std::map<std::string, int> reference;
+  for (unsigned i = 0; i < 500; ++i) {
+    unsigned k = (i * 7919) % 500;
+    map[MakeDn(k)] = k;
+    reference[MakeDn(k)] = k;
+  }
+  std::map<std::string, int>::iterator ri = reference.begin();
+  for (ImmIndexedMap<int>::iterator it = map.begin(); it != map.end();
+       ++it, ++ri) {
+    ASSERT_NE(ri, reference.end());
+    EXPECT_EQ(it->first, ri->first);
+  }
+  EXPECT_EQ(ri, reference.end());
+}
+
+TEST(ImmIndexedMap, EraseKeepsOtherIteratorsAndLookups) {
+  ImmIndexedMap<int> map;
+  for (unsigned i = 0; i < 2000; ++i) map[MakeDn(i)] = i;
+  ImmIndexedMap<int>::iterator keep = map.find(MakeDn(1999));
+  for (unsigned i = 0; i < 2000; i += 2) map.erase(map.find(MakeDn(i)));
+  EXPECT_EQ(map.size(), 1000U);
+  EXPECT_EQ(keep->second, 1999);
+  for (unsigned i = 0; i < 2000; ++i) {
+    if (i % 2) {
+      EXPECT_NE(map.find(MakeDn(i)), map.end());
+    } else {
+      EXPECT_EQ(map.find(MakeDn(i)), map.end());
+    }
+  }
+  EXPECT_EQ(map.erase(MakeDn(1)), 1U);
+  EXPECT_EQ(map.erase(MakeDn(1)), 0U);
+}
+
+TEST(ImmIndexedMap, ChurnReusesTombstones) {
+  ImmIndexedMap<int> map;
+  for (unsigned i = 0; i < 100; ++i) map[MakeDn(i)] = i;
+  size_t buckets = map.bucket_count();
+  for (unsigned round = 0; round < 100; ++round) {
+    for (unsigned i = 0; i < 100; ++i) map.erase(MakeDn(i));
+    EXPECT_TRUE(map.empty());
+    for (unsigned i = 0; i < 100; ++i) map[MakeDn(i)] = i;
+  }
+  EXPECT_EQ(map.size(), 100U);
+  EXPECT_EQ(map.bucket_count(), buckets);
+  for (unsigned i = 0; i < 100; ++i) EXPECT_NE(map.find(MakeDn(i)), map.end());
+}
+
+TEST(ImmIndexedMap, ClearAndReserve) {
+  ImmIndexedMap<int> map;
+  map.reserve(10000);
+  EXPECT_GE(map.bucket_count() * 7, 10000U * 10);
+  for (unsigned i = 0; i < 10; ++i) map[MakeDn(i)] = i;
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(MakeDn(1)), map.end());
+  map[MakeDn(1)] = 1;
+  EXPECT_EQ(map.find(MakeDn(1))->second, 1);
+}
+
+// Micro benchmark comparing the indexed map with the plain std::map
+// previously used for the IMM object map. Run with:
+//   bin/testimmnd --gtest_also_run_disabled_tests --gtest_filter='*Benchmark'
+TEST(ImmIndexedMap, DISABLED_Benchmark) {
+  const unsigned sizes[] = {100000, 250000, 500000, 1000000};
+  for (unsigned n : sizes) {
+    std::vector<std::string> dns;
+    dns.reserve(n);
+    for (unsigned i = 0; i < n; ++i) dns.push_back(MakeDn((i * 2654435761U) % n));
+
+    timespec t0, t1, t2, t3, t4;
+    std::map<std::string, void*> tree;
+    ImmIndexedMap<void*> indexed;
+    size_t hits = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (unsigned i = 0; i < n; ++i) tree[dns[i]] = nullptr;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (unsigned i = 0; i < n; ++i) hits += tree.find(dns[n - 1 - i]) != tree.end();
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    for (unsigned i = 0; i < n; ++i) indexed[dns[i]] = nullptr;
+    clock_gettime(CLOCK_MONOTONIC, &t3);
+    for (unsigned i = 0; i < n; ++i) {
+      hits += indexed.find(dns[n - 1 - i]) != indexed.end();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t4);
+
+    EXPECT_EQ(hits, 2 * static_cast<size_t>(tree.size()));
+    printf("%8u objects: std::map insert %6.0f ns find %6.0f ns | "
+           "ImmIndexedMap insert %6.0f ns find %6.0f ns\n", n,
+           ElapsedNs(t0, t1) / n, ElapsedNs(t1, t2) / n,
+           ElapsedNs(t2, t3) / n, ElapsedNs(t3, t4) / n);
+  }
+}
@@ -155,6 +155,77 @@ static const char *preparedSql[] = {
 
 static sqlite3_stmt *preparedStmt[SQL_STMT_SIZE] = { NULL };
 
+/* Statements updating a single valued attribute depend on the class and
+   attribute names. They are prepared on first use and then reused for all
+   CCB and PRTA updates, keyed on the SQL text. Statements of a class are
+   finalized when the class is deleted. */
+typedef std::map<std::string, sqlite3_stmt*> AttrStmtMap;
+static AttrStmtMap sAttrUpdateStmts;
+
+/* Kinds of single valued attribute update statements */
+typedef enum {
+	ATTR_UPD_SET = 0,		/* set to ?1 where obj_id = ?2 */
+	ATTR_UPD_SET_NULL = 1,		/* set to NULL where obj_id = ?1 */
+	ATTR_UPD_SET_NULL_IF_EQ = 2	/* set to NULL where obj_id = ?1 and value = ?2 */
+} AttrUpdateKind;
+
+static sqlite3_stmt* getAttrUpdateStmt(sqlite3 *dbHandle, const std::string& className,
+	const char* attrName, AttrUpdateKind kind)
+{
+	std::string sql("update \"");
+	sql.append(className);
+	sql.append("\" set \"");
+	sql.append(attrName);
+	switch(kind) {
+	case ATTR_UPD_SET:
+		sql.append("\" = ? where obj_id = ?");
+		break;
+	case ATTR_UPD_SET_NULL:
+		sql.append("\" = NULL where obj_id = ?");
+		break;
+	case ATTR_UPD_SET_NULL_IF_EQ:
+		sql.append("\" = NULL where obj_id = ? and \"");
+		sql.append(attrName);
+		sql.append("\" = ?");
+		break;
+	}
+
+	AttrStmtMap::iterator it = sAttrUpdateStmts.find(sql);
+	if(it != sAttrUpdateStmts.end()) {
+		return it->second;
+	}
+
+	sqlite3_stmt *stmt = NULL;
+	int rc = sqlite3_prepare_v2(dbHandle, sql.c_str(), -1, &stmt, NULL);
+	if(rc != SQLITE_OK) {
+		LOG_ER("Failed to prepare SQL statement '%s' with error code: %d", sql.c_str(), rc);
+		return NULL;
+	}
+	TRACE("Prepared %s", sql.c_str());
+	sAttrUpdateStmts[sql] = stmt;
+	return stmt;
+}
+
+static void finalizeAttrUpdateStmts(const std::string* className)
+{
+	std::string prefix;
+	if(className) {
+		prefix.append("update \"");
+		prefix.append(*className);
+		prefix.append("\" ");
+	}
+
+	AttrStmtMap::iterator it = sAttrUpdateStmts.begin();
+	while(it != sAttrUpdateStmts.end()) {
+		if(it->first.compare(0, prefix.size(), prefix) == 0) {
+			finalizeSqlStatement(it->second);
+			sAttrUpdateStmts.erase(it++);
+		} else {
+			++it;
+		}
+	}
+}
+
 
 static int prepareSqlStatements(sqlite3 *dbHandle) {
 	int i;
@@ -824,6 +895,7 @@ void* pbeRepositoryInit(const char* filePath, bool create, std::string& localTmp
 
 void pbeRepositoryClose(void* dbHandle)
 {
+	finalizeAttrUpdateStmts(NULL);
 	finalizeSqlStatements();
 	sqlite3_close((sqlite3 *) dbHandle);
 }
@@ -1163,6 +1235,7 @@ void deleteClassToPBE(std::string classNameString, void* db_handle,
 	sqlite3_reset(stmt);
 
 	/* 5. Drop 'classname' base relation. */
+	finalizeAttrUpdateStmts(&classNameString);
 	sqlB.append(classNameString);
 	sqlB.append("\"");
 	TRACE("GENERATED B:%s", sqlB.c_str());
@@ -1331,7 +1404,6 @@ void objectModifyDiscardAllValuesOfAttrToPBE(void* db_handle, std::string objNam
 	sqlite3* dbHandle = (sqlite3 *) db_handle;
 
 	int rc=0;
-	char *zErr=NULL;
 	int object_id;
 	std::string object_id_str;
 	int class_id;
@@ -1477,8 +1549,7 @@ void objectModifyDiscardAllValuesOfAttrToPBE(void* db_handle, std::string objNam
 		TRACE("Deleted %u values", rowsModified);
 	} else {
 		/* Assign the null value to the single valued attribute. */
-		std::string sql22("update \"");
-		const char *class_name;
+		std::string class_name;
 
 		/* Get the class-name for the object */
 		stmt = preparedStmt[SQL_SEL_CLASSES_ID];
@@ -1497,10 +1568,7 @@ void objectModifyDiscardAllValuesOfAttrToPBE(void* db_handle, std::string objNam
 			goto bailout;
 		}
 
-		class_name = (char *)sqlite3_column_text(stmt, 0);
-
-		/* Update the relevant attribute in the class_name table */
-		sql22.append(class_name);
+		class_name.append((char *)sqlite3_column_text(stmt, 0));
 
 		rc = sqlite3_step(stmt);
 		if(rc == SQLITE_ROW) {
@@ -1510,18 +1578,22 @@ void objectModifyDiscardAllValuesOfAttrToPBE(void* db_handle, std::string objNam
 		}
 		sqlite3_reset(stmt);
 
-		sql22.append("\" set \"");
-		sql22.append(attrValue->attrName);
-		sql22.append("\" = NULL where obj_id =");
-		sql22.append(object_id_str);
-
-		TRACE("GENERATED 22:%s", sql22.c_str());
-		rc = sqlite3_exec(dbHandle, sql22.c_str(), NULL, NULL, &zErr);
-		if(rc) {
-			LOG_ER("SQL statement ('%s') failed because:\n %s", sql22.c_str(), zErr);
-			sqlite3_free(zErr);
+		/* Update the relevant attribute in the class_name table */
+		stmt = getAttrUpdateStmt(dbHandle, class_name, attrValue->attrName, ATTR_UPD_SET_NULL);
+		if(!stmt) {
+			goto bailout;
+		}
+		if((rc = sqlite3_bind_int(stmt, 1, object_id)) != SQLITE_OK) {
+			LOG_ER("Failed to bind obj_id with error code: %d", rc);
+			goto bailout;
+		}
+		rc = sqlite3_step(stmt);
+		if(rc != SQLITE_DONE) {
+			LOG_ER("SQL statement ('%s') failed because:\n %s",
+				sqlite3_sql(stmt), sqlite3_errmsg(dbHandle));
 			goto bailout;
 		}
+		sqlite3_reset(stmt);
 		rowsModified = sqlite3_changes(dbHandle);
 		TRACE("Update %u values", rowsModified);
 	}
@@ -1704,7 +1776,7 @@ void objectModifyDiscardMatchingValuesOfAttrToPBE(void* db_handle, std::string o
 		   current value matches.
 		 */
 		unsigned int ix;
-		std::string sql23("update \"");
+		std::string class_name;
 
 		/* Get the class-name for the object */
 		stmt = preparedStmt[SQL_SEL_CLASSES_ID];
@@ -1724,7 +1796,7 @@ void objectModifyDiscardMatchingValuesOfAttrToPBE(void* db_handle, std::string o
 			goto bailout;
 		}
 
-		sql23.append((char *)sqlite3_column_text(stmt, 0));
+		class_name.append((char *)sqlite3_column_text(stmt, 0));
 
 		if(sqlite3_step(stmt) == SQLITE_ROW) {
 			LOG_ER("Expected 1 row got more then 1 row (line: %u)", __LINE__);
@@ -1735,22 +1807,18 @@ void objectModifyDiscardMatchingValuesOfAttrToPBE(void* db_handle, std::string o
 
 		TRACE_2("Successfully accessed classes class_id:%d.", class_id);
 
-		sql23.append("\" set \"");
-		sql23.append(attrValue->attrName);
-		sql23.append("\" = NULL where obj_id = ");
-		sql23.append(object_id_str.c_str());
-		sql23.append(" and \"");
-		sql23.append(attrValue->attrName);
-		sql23.append("\" = ?");
-
-		rc = sqlite3_prepare_v2(dbHandle, sql23.c_str(), -1, &stmt, NULL);
-		if(rc != SQLITE_OK) {
-			LOG_ER("Failed to prepare SQL statement '%s' with erroc code: %d", sql23.c_str(), rc);
+		stmt = getAttrUpdateStmt(dbHandle, class_name, attrValue->attrName, ATTR_UPD_SET_NULL_IF_EQ);
+		if(!stmt) {
 			goto bailout;
 		}
 
 		for(ix=0; ix < attrValue->attrValuesNumber; ++ix) {
-			rc = bindValue(stmt, 1, attrValue->attrValues[ix], attr_type);
+			if((rc = sqlite3_bind_int(stmt, 1, object_id)) != SQLITE_OK) {
+				LOG_ER("Failed to bind obj_id with error code: %d", rc);
+				goto bailout;
+			}
+
+			rc = bindValue(stmt, 2, attrValue->attrValues[ix], attr_type);
 			if(rc != SQLITE_OK) {
 				LOG_ER("Failed to bind '%s' parameter with error code: %d", attrValue->attrName, rc);
 				goto bailout;
@@ -1758,7 +1826,8 @@ void objectModifyDiscardMatchingValuesOfAttrToPBE(void* db_handle, std::string o
 
 			rc = sqlite3_step(stmt);
 			if(rc != SQLITE_DONE) {
-				LOG_ER("SQL statement ('%s') failed because:\n %s", sql23.c_str(), sqlite3_errmsg(dbHandle));
+				LOG_ER("SQL statement ('%s') failed because:\n %s",
+					sqlite3_sql(stmt), sqlite3_errmsg(dbHandle));
 				goto bailout;
 			}
 
@@ -1767,10 +1836,6 @@ void objectModifyDiscardMatchingValuesOfAttrToPBE(void* db_handle, std::string o
 
 			sqlite3_reset(stmt);
 		}
-
-		rc = sqlite3_finalize(stmt);
-		if(rc != SQLITE_OK)
-			LOG_NO("Failed to delete prepared SQL statement '%s' with error code: %d", sql23.c_str(), rc);
 	}
  done:
 	if(rowsModified) {
@@ -1895,7 +1960,6 @@ void objectModifyAddValuesOfAttrToPBE(void* db_handle, std::string objName,
 	} else {
 		/* Add value to single valued */
 		std::string class_name;
-		std::string sql22("update \"");
 
 		assert(attrValue->attrValuesNumber == 1);
 		/* Get the class-name for the object */
@@ -1931,36 +1995,31 @@ void objectModifyAddValuesOfAttrToPBE(void* db_handle, std::string objName,
 		/* Update the relevant attribute in the class_name table */
 		/* We should check that the current value is NULL, but we assume instead
 		   that the ImmModel has done this check. */
-		sql22.append(class_name);
-		sql22.append("\" set \"");
-		sql22.append(attrValue->attrName);
-		sql22.append("\" = ? where obj_id = ");
-		sql22.append(object_id_str);
-
-		rc = sqlite3_prepare_v2(dbHandle, sql22.c_str(), -1, &stmt, NULL);
-		if(rc != SQLITE_OK) {
-			LOG_ER("Failed to prepare SQL statement '%s' with error code: %d", sql22.c_str(), rc);
+		stmt = getAttrUpdateStmt(dbHandle, class_name, attrValue->attrName, ATTR_UPD_SET);
+		if(!stmt) {
 			goto bailout;
 		}
 
 		rc = bindValue(stmt, 1, attrValue->attrValues[0], attrValue->attrValueType);
 		if(rc != SQLITE_OK) {
 			LOG_ER("Failed to bind attr_name parameter with error code: %d", rc);
-			sqlite3_finalize(stmt);
+			goto bailout;
+		}
+		if((rc = sqlite3_bind_int(stmt, 2, object_id)) != SQLITE_OK) {
+			LOG_ER("Failed to bind obj_id with error code: %d", rc);
 			goto bailout;
 		}
 
 		rc = sqlite3_step(stmt);
 		if(rc != SQLITE_DONE) {
-			LOG_ER("SQL statement ('%s') failed because:\n %s", sql22.c_str(), sqlite3_errmsg(dbHandle));
-			sqlite3_finalize(stmt);
+			LOG_ER("SQL statement ('%s') failed because:\n %s",
+				sqlite3_sql(stmt), sqlite3_errmsg(dbHandle));
 			goto bailout;
 		}
+		sqlite3_reset(stmt);
 
 		rowsModified = sqlite3_changes(dbHandle);
 		TRACE("Updated %u values", rowsModified);
-
-		sqlite3_finalize(stmt);
 	}
  done:
 	if(rowsModified) {
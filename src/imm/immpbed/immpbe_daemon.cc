@@ -1365,6 +1365,11 @@ static SaAisErrorT saImmOiCcbCompletedCallback(SaImmOiHandleT immOiHandle, SaImm
 	   that it is not re-used later to see an alternative history.
 	   If the first solution fails then this solution will be used as fallback.
 	   getCcbOutcomeFromPbe will then return BAD_OPERATION i.e. presumed abort.
+
+	   Since returning from this upcall is the ack of the ccb, each ccb is committed
+	   in a sqlite transaction of its own. Coalescing several ccbs into one
+	   transaction (group commit) would require the reply to be sent asynchronously
+	   after the shared commit, which the OI completed callback does not allow.
 	 */
 
 	SaAisErrorT rc = SA_AIS_OK;
@@ -47,6 +47,11 @@
 
 #define m_IMMSV_CONVERT_SATIME_TEN_MILLI_SEC(t)      (t)/(10000000)	/* 10^7 */
 
+/* MDS subpart version of the first IMMND handling IMMND_EVT_A2ND_OBJ_LOAD.
+   The IMMD only allows the loader to send objects in bulk when all IMMNDs
+   have at least this version. */
+#define IMMSV_IMMND_MDS_VER_OBJ_LOAD 2
+
 static inline int osaf_timer_is_expired_sec(const struct timespec* end, const struct timespec* start,
                                              uint32_t timeout) {
     struct timespec expiry = *start;
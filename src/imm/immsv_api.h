@@ -73,7 +73,8 @@ typedef enum {
 	ACCESS_CONTROL_ENFORCING = 2
 } OsafImmAccessControlModeT;
 
-/*Max # of outstanding fevs messages towards director.*/
+/*Default max # of outstanding fevs messages towards director, the
+  IMMND uses IMMSV_FEVS_MAX_PENDING if set.*/
 /*Note max-max is 255. cb->fevs_replies_pending is an uint8_t*/
 #define IMMSV_DEFAULT_FEVS_MAX_PENDING 16
 
@@ -205,6 +206,26 @@ typedef enum {
 	SaAisErrorT
 	 immsv_finalize_sync(SaImmHandleT immHandle);
 
+/* Private and nonstandard bulk variant of saImmOmCcbObjectCreate_2, only
+   usable by the loader during loading. Objects are buffered in *batch
+   (SA_AIS_ERR_NOT_READY) until the batch is full or attrValues is NULL,
+   then the batch is sent. The local IMMND acknowledges the batch as soon
+   as it has been forwarded over fevs, without waiting for the objects to
+   be created. A batch rejected with SA_AIS_ERR_TRY_AGAIN is kept in *batch
+   and is re-sent by calling again with attrValues == NULL. Errors in
+   creating the objects veto the ccb and are reported by saImmOmCcbApply.
+   When the IMMND rejects the bulk message with SA_AIS_ERR_VERSION, because
+   the IMMD found an IMMND of an earlier release when loading started, the
+   objects are sent as regular object creates, one at a time, and errors in
+   creating them are returned directly.
+   Like immsv_sync, this function must be used by only one thread.
+*/
+	SaAisErrorT
+	 immsv_load(SaImmCcbHandleT ccbHandle,
+		    const SaImmClassNameT className, const SaNameT *parentName,
+		    const SaImmAttrValuesT_2 **attrValues, void** batch,
+		    int* remainingSpace, int objsInBatch);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -176,6 +176,7 @@ static const char *immnd_evt_names[] = {
 	"IMMND_EVT_A2ND_OBJ_CREATE_2",  /* saImmOmCcbObjectCreate_o3 */
 	"IMMND_EVT_A2ND_OI_OBJ_CREATE_2",       /* saImmOiRtObjectCreate_o3 */
 	"IMMND_EVT_A2ND_OBJ_SAFE_READ",       /* saImmOmCcbObjectRead */
+	"IMMND_EVT_A2ND_OBJ_LOAD",	/* immsv_load */
 	"undefined (high)"
 };
 
@@ -1682,9 +1683,13 @@ static uint32_t immsv_evt_enc_sublevels(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 			}
 
 		} else if ((i_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC) ||
-			(i_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC_2)) {
+			(i_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC_2) ||
+			(i_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD)) {
 			int syncDepth = 0;
-			IMMSV_OM_OBJECT_SYNC* obj_sync = &(i_evt->info.immnd.info.obj_sync);
+			IMMSV_OM_OBJECT_SYNC* obj_sync =
+				(i_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD) ?
+				&(i_evt->info.immnd.info.objLoad.objects) :
+				&(i_evt->info.immnd.info.obj_sync);
 			while(obj_sync) {
 				uint8_t *p8;
 				int attrDepth = 0;
@@ -2234,11 +2239,15 @@ static uint32_t immsv_evt_dec_sublevels(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 			IMMSV_OCTET_STRING *os = &(o_evt->info.immnd.info.objDelete.objectName);
 			immsv_evt_dec_inline_string(i_ub, os);
 		} else if ((o_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC)||
-			(o_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC_2)) {
+			(o_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_SYNC_2) ||
+			(o_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD)) {
 			uint8_t *p8;
 			uint8_t local_data[8];
 			int syncDepth = 0;
-			IMMSV_OM_OBJECT_SYNC* obj_sync = &(o_evt->info.immnd.info.obj_sync);
+			IMMSV_OM_OBJECT_SYNC* obj_sync =
+				(o_evt->info.immnd.type == IMMND_EVT_A2ND_OBJ_LOAD) ?
+				&(o_evt->info.immnd.info.objLoad.objects) :
+				&(o_evt->info.immnd.info.obj_sync);
 			while(obj_sync) {
 				++syncDepth;
 				if (syncDepth >= IMMSV_MAX_OBJS_IN_SYNCBATCH) {
@@ -2271,7 +2280,7 @@ static uint32_t immsv_evt_dec_sublevels(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 					break;
 				}
 
-				/* IMMND_EVT_A2ND_OBJ_SYNC_2 => possible batch. */
+				/* IMMND_EVT_A2ND_OBJ_SYNC_2/OBJ_LOAD => possible batch. */
 
 				IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 1);
 				if (ncs_decode_8bit(&p8)) {
@@ -3490,6 +3499,30 @@ static uint32_t immsv_evt_enc_toplevel(IMMSV_EVT *i_evt, NCS_UBAID *o_ub)
 			ncs_enc_claim_space(o_ub, 1);
 			break;
 
+		case IMMND_EVT_A2ND_OBJ_LOAD:	/* immsv_load */
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(&p8, immndevt->info.objLoad.ccbId);
+			ncs_enc_claim_space(o_ub, 4);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(&p8, immndevt->info.objLoad.adminOwnerId);
+			ncs_enc_claim_space(o_ub, 4);
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(&p8, immndevt->info.objLoad.objects.className.size);
+			ncs_enc_claim_space(o_ub, 4);
+			/* immndevt->info.objLoad.objects.className.buf encoded by sublevel */
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 4);
+			ncs_encode_32bit(&p8, immndevt->info.objLoad.objects.objectName.size);
+			ncs_enc_claim_space(o_ub, 4);
+			/* immndevt->info.objLoad.objects.objectName.buf encoded by sublevel */
+
+			IMMSV_RSRV_SPACE_ASSERT(p8, o_ub, 1);
+			ncs_encode_8bit(&p8, (immndevt->info.objLoad.objects.attrValues) ? 1 : 0);
+			ncs_enc_claim_space(o_ub, 1);
+			break;
+
 		case IMMND_EVT_A2ND_ADMO_SET:	/* AdminOwnerSet */
 		case IMMND_EVT_A2ND_ADMO_RELEASE:	/* AdminOwnerRelease */
 		case IMMND_EVT_A2ND_ADMO_CLEAR:	/* AdminOwnerClear */
@@ -4923,6 +4956,34 @@ static uint32_t immsv_evt_dec_toplevel(NCS_UBAID *i_ub, IMMSV_EVT *o_evt)
 			ncs_dec_skip_space(i_ub, 1);
 			break;
 
+		case IMMND_EVT_A2ND_OBJ_LOAD:	/* immsv_load */
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.objLoad.ccbId = ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.objLoad.adminOwnerId = ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.objLoad.objects.className.size = ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+			/* immndevt->info.objLoad.objects.className.buf decoded by sublevel */
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 4);
+			immndevt->info.objLoad.objects.objectName.size = ncs_decode_32bit(&p8);
+			ncs_dec_skip_space(i_ub, 4);
+			/* immndevt->info.objLoad.objects.objectName.buf decoded by sublevel */
+
+			IMMSV_FLTN_SPACE_ASSERT(p8, local_data, i_ub, 1);
+			if (ncs_decode_8bit(&p8)) {
+				/*Bogus pointer-val forces decode_sublevel to 
+				   decode attrValues. */
+				immndevt->info.objLoad.objects.attrValues = (void *)0x1;
+			}
+			ncs_dec_skip_space(i_ub, 1);
+			break;
+
 		case IMMND_EVT_A2ND_ADMO_SET:	/* AdminOwnerSet */
 		case IMMND_EVT_A2ND_ADMO_RELEASE:	/* AdminOwnerRelease */
 		case IMMND_EVT_A2ND_ADMO_CLEAR:	/* AdminOwnerClear */
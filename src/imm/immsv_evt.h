@@ -216,6 +216,8 @@ typedef enum immnd_evt_type {
 
 	IMMND_EVT_A2ND_OBJ_SAFE_READ = 100,     /* saImmOmCcbObjectRead */
 
+	IMMND_EVT_A2ND_OBJ_LOAD = 101,	/* immsv_load */
+
 	IMMND_EVT_MAX
 } IMMND_EVT_TYPE;
 /* Make sure the string array in immsv_evt.c matches the IMMND_EVT_TYPE enum. */
@@ -284,6 +286,7 @@ typedef struct immsv_mds_info {
 	MDS_SVC_ID svc_id;
 	NODE_ID node_id;
 	V_DEST_RL role;
+	MDS_SVC_PVT_SUB_PART_VER svc_pvt_ver;	/* Of the service that came up */
 } IMMSV_MDS_INFO;
 
 typedef struct immsv_send_info {
@@ -406,6 +409,7 @@ typedef struct immsv_d2nd_control {
 	SaUint64T fevsMsgStart;
 	SaUint32T ndExecPid;
 	uint8_t canBeCoord; /* 0=>payload; 1=>SC; 2=>2PBE_preload; 3=>2PBE_sync*/
+			    /* IMMND_EVT_D2ND_LOADING_OK: 1=>IMMND_EVT_A2ND_OBJ_LOAD allowed */
 	uint8_t isCoord;
 	uint8_t syncStarted;
 	SaUint32T nodeEpoch;
@@ -540,6 +544,7 @@ typedef struct immnd_evt {
 		IMMSV_OM_CCB_OBJECT_MODIFY objModify;
 		IMMSV_OM_CCB_OBJECT_DELETE objDelete;
 		IMMSV_OM_OBJECT_SYNC obj_sync;
+		IMMSV_OM_OBJECT_LOAD objLoad;
 		IMMSV_OM_FINALIZE_SYNC finSync;
 
 		SaUint32T ccbId;	//CcbApply, CcbFinalize, CCbAbort
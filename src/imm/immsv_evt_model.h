@@ -227,6 +227,15 @@ extern "C" {
 		struct ImmsvOmObjectSync *next;
 	} IMMSV_OM_OBJECT_SYNC;
 
+	/* Batch of object creates in the loading ccb (immsv_load).
+	   Re-uses the object sync list, with objectName holding the
+	   parent DN as for IMMND_EVT_A2ND_OBJ_CREATE. */
+	typedef struct ImmsvOmObjectLoad {
+		SaUint32T ccbId;
+		SaUint32T adminOwnerId;
+		IMMSV_OM_OBJECT_SYNC objects;
+	} IMMSV_OM_OBJECT_LOAD;
+
 	typedef struct ImmsvObjNameList {
 		IMMSV_OCTET_STRING name;
 		struct ImmsvObjNameList *next;
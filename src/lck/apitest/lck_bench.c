@@ -0,0 +1,191 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION: Measures the round-trip latency of saLckResourceLock() and
+               saLckResourceUnlock() on a running LCK service.
+
+  Usage: lckbench [lock/unlock pairs per thread] [max threads] [resources]
+
+  Each run is done with 1, 2, 4 ... "max threads" threads. Every thread has
+  its own lock service handle and locks the resources "safLock=lckbench_<n>"
+  in turn, so that all threads contend for the same "resources" resources.
+  Runs are done with exclusive and with shared locks; the latency of the
+  exclusive locks includes the time spent waiting in the queue of the lock
+  master.
+
+******************************************************************************/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lck/saf/saLck.h"
+
+#define BENCH_MAX_THREADS 64
+#define BENCH_MAX_RESOURCES 10000
+#define BENCH_TIMEOUT 10000000000LL
+
+static SaVersionT bench_version = {'B', 1, 1};
+static uint32_t bench_pairs;
+static uint32_t bench_resources;
+static SaLckLockModeT bench_mode;
+static pthread_barrier_t bench_barrier;
+
+typedef struct bench_thread_info {
+	pthread_t tid;
+	double *samples;	/* lock + unlock round trip, seconds */
+	SaAisErrorT rc;
+} BENCH_THREAD_INFO;
+
+static BENCH_THREAD_INFO bench_threads[BENCH_MAX_THREADS];
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void *bench_thread(void *arg)
+{
+	BENCH_THREAD_INFO *info = arg;
+	SaLckResourceHandleT *res_hdls;
+	SaLckHandleT lck_hdl = 0;
+	SaVersionT version = bench_version;
+	SaLckLockStatusT status;
+	SaLckLockIdT lock_id;
+	SaNameT name;
+	double start;
+	uint32_t i;
+
+	res_hdls = calloc(bench_resources, sizeof(SaLckResourceHandleT));
+	if (res_hdls == NULL) {
+		info->rc = SA_AIS_ERR_NO_MEMORY;
+		goto barrier;
+	}
+	info->rc = saLckInitialize(&lck_hdl, NULL, &version);
+	if (info->rc != SA_AIS_OK)
+		lck_hdl = 0;
+	for (i = 0; i < bench_resources && info->rc == SA_AIS_OK; i++) {
+		memset(&name, 0, sizeof(name));
+		name.length = snprintf((char *)name.value, sizeof(name.value), "safLock=lckbench_%u", i);
+		info->rc = saLckResourceOpen(lck_hdl, &name, SA_LCK_RESOURCE_CREATE, BENCH_TIMEOUT, &res_hdls[i]);
+	}
+
+ barrier:
+	pthread_barrier_wait(&bench_barrier);
+	for (i = 0; i < bench_pairs && info->rc == SA_AIS_OK; i++) {
+		start = bench_now();
+		info->rc = saLckResourceLock(res_hdls[i % bench_resources], &lock_id, bench_mode, 0, 0,
+					     BENCH_TIMEOUT, &status);
+		if (info->rc == SA_AIS_OK && status != SA_LCK_LOCK_GRANTED)
+			info->rc = SA_AIS_ERR_FAILED_OPERATION;
+		if (info->rc == SA_AIS_OK)
+			info->rc = saLckResourceUnlock(lock_id, BENCH_TIMEOUT);
+		info->samples[i] = bench_now() - start;
+	}
+
+	/* only finalize a handle that saLckInitialize() returned */
+	if (lck_hdl != 0)
+		saLckFinalize(lck_hdl);
+	free(res_hdls);
+	return NULL;
+}
+
+/* Runs "threads" contending threads and prints the latency percentiles */
+static int bench_run(uint32_t threads)
+{
+	double *samples;
+	double start, total = 0;
+	uint32_t count = bench_pairs * threads;
+	uint32_t i;
+
+	samples = calloc(count, sizeof(double));
+	if (samples == NULL)
+		return 1;
+
+	pthread_barrier_init(&bench_barrier, NULL, threads + 1);
+	for (i = 0; i < threads; i++) {
+		bench_threads[i].samples = &samples[i * bench_pairs];
+		bench_threads[i].rc = SA_AIS_OK;
+		if (pthread_create(&bench_threads[i].tid, NULL, bench_thread, &bench_threads[i]) != 0)
+			return 1;
+	}
+	pthread_barrier_wait(&bench_barrier);
+	start = bench_now();
+	for (i = 0; i < threads; i++)
+		pthread_join(bench_threads[i].tid, NULL);
+	start = bench_now() - start;
+	pthread_barrier_destroy(&bench_barrier);
+
+	for (i = 0; i < threads; i++) {
+		if (bench_threads[i].rc != SA_AIS_OK) {
+			fprintf(stderr, "thread %u failed: %d\n", i, bench_threads[i].rc);
+			free(samples);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		total += samples[i];
+	qsort(samples, count, sizeof(double), bench_compare);
+	printf("%4s %8u %10.1f %10.1f %10.1f %10.1f %12.0f\n", bench_mode == SA_LCK_EX_LOCK_MODE ? "EX" : "PR",
+	       threads, total * 1e6 / count, samples[count / 2] * 1e6, samples[count * 99 / 100] * 1e6,
+	       samples[count - 1] * 1e6, count / start);
+	free(samples);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static const SaLckLockModeT modes[] = {SA_LCK_EX_LOCK_MODE, SA_LCK_PR_LOCK_MODE};
+	uint32_t max_threads = (argc > 2) ? strtoul(argv[2], NULL, 0) : 8;
+	uint32_t threads;
+	uint32_t i;
+
+	bench_pairs = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10000;
+	bench_resources = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1;
+	if (bench_pairs < 1 || max_threads < 1 || max_threads > BENCH_MAX_THREADS ||
+	    bench_resources < 1 || bench_resources > BENCH_MAX_RESOURCES) {
+		fprintf(stderr, "Usage: %s [pairs per thread] [max threads 1..%d] [resources 1..%d]\n", argv[0],
+			BENCH_MAX_THREADS, BENCH_MAX_RESOURCES);
+		return EXIT_FAILURE;
+	}
+
+	printf("%u lock/unlock pairs per thread on %u resources, latency in us\n", bench_pairs, bench_resources);
+	printf("%4s %8s %10s %10s %10s %10s %12s\n", "mode", "threads", "mean", "p50", "p99", "max", "pairs/s");
+	for (i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+		bench_mode = modes[i];
+		for (threads = 1; threads <= max_threads; threads *= 2) {
+			if (bench_run(threads) != 0)
+				return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -46,6 +46,14 @@ typedef enum {
 	GLND_LOCK_NON_MASTER_NODE = 2
 } GLND_NODE_TYPE;
 
+/* the lock master queue a lock request is on */
+typedef enum {
+	GLND_LOCK_QUEUE_NONE = 0,
+	GLND_LOCK_QUEUE_GRANT,
+	GLND_LOCK_QUEUE_WAIT_EX,
+	GLND_LOCK_QUEUE_WAIT_PR
+} GLND_LOCK_QUEUE;
+
 typedef struct glnd_res_lock_list_info_tag {
 	uint32_t lck_info_hdl_id;	/* maintained for the validity */
 	GLSV_LOCK_REQ_INFO lock_info;
@@ -59,6 +67,7 @@ typedef struct glnd_res_lock_list_info_tag {
 	GLSV_CALL_TYPE unlock_call_type;
 	uint32_t non_master_status;
 	uint32_t shm_index;
+	GLND_LOCK_QUEUE queue;	/* master queue, GLND_LOCK_QUEUE_NONE if local */
 	struct glnd_resource_info_tag *res_info;	/* back pointer */
 	struct glnd_res_lock_list_info_tag *prev, *next;
 } GLND_RES_LOCK_LIST_INFO;
@@ -67,6 +76,11 @@ typedef struct glnd_lock_master_info_tag {
 	GLND_RES_LOCK_LIST_INFO *grant_list;
 	GLND_RES_LOCK_LIST_INFO *wait_exclusive_list;
 	GLND_RES_LOCK_LIST_INFO *wait_read_list;
+	/* the wait lists are FIFO, requests are added at the tail */
+	GLND_RES_LOCK_LIST_INFO *wait_exclusive_tail;
+	GLND_RES_LOCK_LIST_INFO *wait_read_tail;
+	uint32_t pr_grant_count;	/* PR locks in the grant list */
+	uint32_t ex_grant_count;	/* EX locks in the grant list */
 	uint32_t pr_orphan_req_count;	/* local lock ref count */
 	uint32_t ex_orphan_req_count;	/* local lock ref count */
 	bool pr_orphaned;
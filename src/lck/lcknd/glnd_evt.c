@@ -890,6 +890,9 @@ static uint32_t glnd_process_check_master_and_non_master_status(GLND_CB *glnd_cb
 	    || res_info->master_status != GLND_OPERATIONAL_STATE)
 		return SA_AIS_ERR_TRY_AGAIN;
 
+	if (res_info->lck_master_info.ex_grant_count == 0)
+		return SA_AIS_OK;
+
 	for (lock_list_info = res_info->lck_master_info.grant_list; lock_list_info != NULL;
 	     lock_list_info = lock_list_info->next) {
 		if (lock_list_info->lock_info.lock_type == SA_LCK_EX_LOCK_MODE
@@ -511,33 +511,133 @@ void glnd_resource_lock_req_delete(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_L
 }
 
 /*****************************************************************************
-  PROCEDURE NAME : glnd_resource_lock_req_destroy
+  PROCEDURE NAME : glnd_resource_master_queue_add
 
-  DESCRIPTION    : Deletes the lock request 
+  DESCRIPTION    : Adds the lock request to one of the lock master queues
 
   ARGUMENTS      :res_info      - ptr to the Resource Node.
-                  lock_info     - pointer to the lock info
+                  lck_list_info - pointer to the lock info
+                  queue         - the queue to add it to
 
-  RETURNS        : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+  RETURNS        : None
+
+  NOTES         : Granted locks are added at the head of the grant list and
+                  counted per mode, so that the grant decisions need not walk
+                  the list. Waiting locks are added at the tail of their wait
+                  list, so the head is the oldest request.
+*****************************************************************************/
+void glnd_resource_master_queue_add(GLND_RESOURCE_INFO *res_info,
+				    GLND_RES_LOCK_LIST_INFO *lck_list_info, GLND_LOCK_QUEUE queue)
+{
+	GLND_LOCK_MASTER_INFO *master = &res_info->lck_master_info;
+	GLND_RES_LOCK_LIST_INFO **head, **tail;
+
+	lck_list_info->queue = queue;
+	if (queue == GLND_LOCK_QUEUE_GRANT) {
+		if (lck_list_info->lock_info.lock_type == SA_LCK_EX_LOCK_MODE)
+			master->ex_grant_count++;
+		else
+			master->pr_grant_count++;
+
+		lck_list_info->prev = NULL;
+		lck_list_info->next = master->grant_list;
+		if (master->grant_list)
+			master->grant_list->prev = lck_list_info;
+		master->grant_list = lck_list_info;
+		return;
+	}
+
+	if (queue == GLND_LOCK_QUEUE_WAIT_EX) {
+		head = &master->wait_exclusive_list;
+		tail = &master->wait_exclusive_tail;
+	} else {
+		head = &master->wait_read_list;
+		tail = &master->wait_read_tail;
+	}
+	lck_list_info->next = NULL;
+	lck_list_info->prev = *tail;
+	if (*tail)
+		(*tail)->next = lck_list_info;
+	else
+		*head = lck_list_info;
+	*tail = lck_list_info;
+}
+
+/*****************************************************************************
+  PROCEDURE NAME : glnd_resource_master_queue_del
+
+  DESCRIPTION    : Removes the lock request from the lock master queue it is on
+
+  ARGUMENTS      :res_info      - ptr to the Resource Node.
+                  lck_list_info - pointer to the lock info
+
+  RETURNS        : None
 
   NOTES         : None
 *****************************************************************************/
-void glnd_resource_lock_req_destroy(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_LIST_INFO *lck_list_info)
+static void glnd_resource_master_queue_del(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_LIST_INFO *lck_list_info)
 {
-	if (res_info->lcl_lck_req_info == lck_list_info) {
-		res_info->lcl_lck_req_info = lck_list_info->next;
-	} else if (res_info->lck_master_info.grant_list == lck_list_info) {
-		res_info->lck_master_info.grant_list = lck_list_info->next;
-	} else if (res_info->lck_master_info.wait_read_list == lck_list_info) {
-		res_info->lck_master_info.wait_read_list = lck_list_info->next;
-	} else if (res_info->lck_master_info.wait_exclusive_list == lck_list_info) {
-		res_info->lck_master_info.wait_exclusive_list = lck_list_info->next;
+	GLND_LOCK_MASTER_INFO *master = &res_info->lck_master_info;
+	GLND_RES_LOCK_LIST_INFO **head, **tail = NULL;
+
+	switch (lck_list_info->queue) {
+	case GLND_LOCK_QUEUE_GRANT:
+		head = &master->grant_list;
+		if (lck_list_info->lock_info.lock_type == SA_LCK_EX_LOCK_MODE) {
+			if (master->ex_grant_count != 0)
+				master->ex_grant_count--;
+		} else if (master->pr_grant_count != 0) {
+			master->pr_grant_count--;
+		}
+		break;
+	case GLND_LOCK_QUEUE_WAIT_EX:
+		head = &master->wait_exclusive_list;
+		tail = &master->wait_exclusive_tail;
+		break;
+	case GLND_LOCK_QUEUE_WAIT_PR:
+		head = &master->wait_read_list;
+		tail = &master->wait_read_tail;
+		break;
+	default:
+		return;
 	}
 
+	if (*head == lck_list_info)
+		*head = lck_list_info->next;
+	if (tail && *tail == lck_list_info)
+		*tail = lck_list_info->prev;
 	if (lck_list_info->next)
 		lck_list_info->next->prev = lck_list_info->prev;
 	if (lck_list_info->prev)
 		lck_list_info->prev->next = lck_list_info->next;
+	lck_list_info->prev = lck_list_info->next = NULL;
+	lck_list_info->queue = GLND_LOCK_QUEUE_NONE;
+}
+
+/*****************************************************************************
+  PROCEDURE NAME : glnd_resource_lock_req_destroy
+
+  DESCRIPTION    : Deletes the lock request 
+
+  ARGUMENTS      :res_info      - ptr to the Resource Node.
+                  lock_info     - pointer to the lock info
+
+  RETURNS        : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+
+  NOTES         : None
+*****************************************************************************/
+void glnd_resource_lock_req_destroy(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_LIST_INFO *lck_list_info)
+{
+	if (lck_list_info->queue != GLND_LOCK_QUEUE_NONE) {
+		glnd_resource_master_queue_del(res_info, lck_list_info);
+	} else {
+		if (res_info->lcl_lck_req_info == lck_list_info)
+			res_info->lcl_lck_req_info = lck_list_info->next;
+		if (lck_list_info->next)
+			lck_list_info->next->prev = lck_list_info->prev;
+		if (lck_list_info->prev)
+			lck_list_info->prev->next = lck_list_info->next;
+	}
 	/* stop the timer if started */
 	if (lck_list_info->timeout_tmr.tmr_id != TMR_T_NULL)
 		glnd_stop_tmr(&lck_list_info->timeout_tmr);
@@ -682,7 +782,7 @@ GLND_RES_LOCK_LIST_INFO *glnd_resource_master_process_lock_req(GLND_CB *cb,
 					(uint32_t)lck_list_info->lock_info.lockid);
 
 			lck_list_info->lock_info.lockStatus = SA_LCK_LOCK_GRANTED;
-			res_info->lck_master_info.grant_list = lck_list_info;
+			glnd_resource_master_queue_add(res_info, lck_list_info, GLND_LOCK_QUEUE_GRANT);
 		} else if ((lock_info.lockFlags & SA_LCK_LOCK_NO_QUEUE) == SA_LCK_LOCK_NO_QUEUE) {
 			/* send back the request as it can't be queued */
 			lck_list_info->lock_info.lockStatus = SA_LCK_LOCK_NOT_QUEUED;
@@ -701,10 +801,7 @@ GLND_RES_LOCK_LIST_INFO *glnd_resource_master_process_lock_req(GLND_CB *cb,
 					(uint32_t)lock_info.handleId, (uint32_t)res_info->resource_id, 
 					(uint32_t)lck_list_info->lock_info.lockid);
 
-			lck_list_info->next = res_info->lck_master_info.wait_exclusive_list;
-			if (res_info->lck_master_info.wait_exclusive_list)
-				res_info->lck_master_info.wait_exclusive_list->prev = lck_list_info;
-			res_info->lck_master_info.wait_exclusive_list = lck_list_info;
+			glnd_resource_master_queue_add(res_info, lck_list_info, GLND_LOCK_QUEUE_WAIT_EX);
 			if (m_GLND_IS_LOCAL_NODE(&req_node_mds_dest, &cb->glnd_mdest_id) == 0) {
 
 				glnd_start_tmr(cb, &lck_list_info->timeout_tmr,
@@ -780,10 +877,7 @@ GLND_RES_LOCK_LIST_INFO *glnd_resource_master_process_lock_req(GLND_CB *cb,
 		    res_info->lck_master_info.ex_orphaned != true) {
 			/* add it in the grant list */
 			lck_list_info->lock_info.lockStatus = SA_LCK_LOCK_GRANTED;
-			lck_list_info->next = res_info->lck_master_info.grant_list;
-			if (res_info->lck_master_info.grant_list)
-				res_info->lck_master_info.grant_list->prev = lck_list_info;
-			res_info->lck_master_info.grant_list = lck_list_info;
+			glnd_resource_master_queue_add(res_info, lck_list_info, GLND_LOCK_QUEUE_GRANT);
 
 			TRACE("LOCK_GRANTED handle - %d res - %d lockid- %d",
 			      (uint32_t)lock_info.handleId, (uint32_t)res_info->resource_id,
@@ -811,10 +905,7 @@ GLND_RES_LOCK_LIST_INFO *glnd_resource_master_process_lock_req(GLND_CB *cb,
 					(uint32_t)lck_list_info->lock_info.lockid);
 
 			/* add it to the read wait list */
-			lck_list_info->next = res_info->lck_master_info.wait_read_list;
-			if (res_info->lck_master_info.wait_read_list)
-				res_info->lck_master_info.wait_read_list->prev = lck_list_info;
-			res_info->lck_master_info.wait_read_list = lck_list_info;
+			glnd_resource_master_queue_add(res_info, lck_list_info, GLND_LOCK_QUEUE_WAIT_PR);
 			/* send back waitercallback requests to the lock holders in grant list */
 			glnd_master_process_lock_initiate_waitercallbk(cb, res_info, lock_info, lcl_lock_id);
 
@@ -1137,14 +1228,7 @@ bool glnd_resource_grant_list_orphan_locks(GLND_RESOURCE_INFO *res_info, SaLckLo
 *****************************************************************************/
 static bool glnd_resource_grant_list_exclusive_locks(GLND_RESOURCE_INFO *res_info)
 {
-	GLND_RES_LOCK_LIST_INFO *lock_list_info;
-
-	for (lock_list_info = res_info->lck_master_info.grant_list; lock_list_info != NULL;
-	     lock_list_info = lock_list_info->next) {
-		if (lock_list_info->lock_info.lock_type == SA_LCK_EX_LOCK_MODE)
-			return true;
-	}
-	return false;
+	return res_info->lck_master_info.ex_grant_count != 0;
 }
 
 /*****************************************************************************
@@ -1348,21 +1432,17 @@ static void glnd_resource_master_grant_lock_send_notification(GLND_CB *glnd_cb,
 *****************************************************************************/
 static void glnd_resource_master_move_pr_locks_to_grant_list(GLND_CB *glnd_cb, GLND_RESOURCE_INFO *res_info)
 {
-	GLND_RES_LOCK_LIST_INFO *m_node, *pr_node;
+	GLND_RES_LOCK_LIST_INFO *m_node;
 
-	for (pr_node = res_info->lck_master_info.wait_read_list; pr_node != NULL;) {
-		m_node = pr_node;
-		pr_node = pr_node->next;
+	/* grant them in the order they were requested */
+	while ((m_node = res_info->lck_master_info.wait_read_list) != NULL) {
+		glnd_resource_master_queue_del(res_info, m_node);
 
 		/* change the status */
 		m_node->lock_info.lockStatus = SA_LCK_LOCK_GRANTED;
 
 		/* add it to the grant list */
-		m_node->prev = NULL;
-		m_node->next = res_info->lck_master_info.grant_list;
-		if (res_info->lck_master_info.grant_list)
-			res_info->lck_master_info.grant_list->prev = m_node;
-		res_info->lck_master_info.grant_list = m_node;
+		glnd_resource_master_queue_add(res_info, m_node, GLND_LOCK_QUEUE_GRANT);
 
 		/* stop the local lock timer */
 		glnd_stop_tmr(&m_node->timeout_tmr);
@@ -1370,12 +1450,6 @@ static void glnd_resource_master_move_pr_locks_to_grant_list(GLND_CB *glnd_cb, G
 		/* send notification to the lock requesters */
 		glnd_resource_master_grant_lock_send_notification(glnd_cb, res_info, m_node);
 	}
-
-	/* 
-	   if ( res_info->lck_master_info.wait_exclusive_list )
-	   m_MMGR_FREE_GLND_RES_LOCK_LIST_INFO(res_info->lck_master_info.wait_read_list);
-	 */
-	res_info->lck_master_info.wait_read_list = NULL;
 }
 
 /*****************************************************************************
@@ -1392,30 +1466,19 @@ static void glnd_resource_master_move_pr_locks_to_grant_list(GLND_CB *glnd_cb, G
 *****************************************************************************/
 static void glnd_resource_master_move_ex_locks_to_grant_list(GLND_CB *glnd_cb, GLND_RESOURCE_INFO *res_info)
 {
-	GLND_RES_LOCK_LIST_INFO *ex_node;
-	for (ex_node = res_info->lck_master_info.wait_exclusive_list;
-	     ex_node != NULL && ex_node->next != NULL; ex_node = ex_node->next) ;
+	/* the oldest request is at the head of the list */
+	GLND_RES_LOCK_LIST_INFO *ex_node = res_info->lck_master_info.wait_exclusive_list;
 
 	if (ex_node) {
 		/* remove it from the list */
-		if (res_info->lck_master_info.wait_exclusive_list == ex_node)
-			res_info->lck_master_info.wait_exclusive_list = ex_node->next;
-		if (ex_node->next)
-			ex_node->next->prev = ex_node->prev;
-		if (ex_node->prev)
-			ex_node->prev->next = ex_node->next;
+		glnd_resource_master_queue_del(res_info, ex_node);
+
 		/* stop the local lock timer */
 		glnd_stop_tmr(&ex_node->timeout_tmr);
 
-		/* add it to the grant list */
-		ex_node->prev = NULL;
-		ex_node->next = res_info->lck_master_info.grant_list;
-		if (res_info->lck_master_info.grant_list)
-			res_info->lck_master_info.grant_list->prev = ex_node;
-		res_info->lck_master_info.grant_list = ex_node;
-
-		/* change the status and send notification to the lock requester */
+		/* change the status and add it to the grant list */
 		ex_node->lock_info.lockStatus = SA_LCK_LOCK_GRANTED;
+		glnd_resource_master_queue_add(res_info, ex_node, GLND_LOCK_QUEUE_GRANT);
 
 		/* send the notification */
 		glnd_resource_master_grant_lock_send_notification(glnd_cb, res_info, ex_node);
@@ -1513,10 +1576,7 @@ void glnd_resource_convert_nonmaster_to_master(GLND_CB *glnd_cb, GLND_RESOURCE_I
 		/* check to see the status of the lock */
 		if (lck_list_m_info->lock_info.lockStatus == SA_LCK_LOCK_GRANTED) {
 			/* move it to the grant queue */
-			lck_list_m_info->next = res_node->lck_master_info.grant_list;
-			if (res_node->lck_master_info.grant_list)
-				res_node->lck_master_info.grant_list->prev = lck_list_m_info;
-			res_node->lck_master_info.grant_list = lck_list_m_info;
+			glnd_resource_master_queue_add(res_node, lck_list_m_info, GLND_LOCK_QUEUE_GRANT);
 
 			/* take care of the orphan locks */
 			if ((lck_list_m_info->lock_info.lockFlags & SA_LCK_LOCK_ORPHAN) == SA_LCK_LOCK_ORPHAN) {
@@ -1525,16 +1585,10 @@ void glnd_resource_convert_nonmaster_to_master(GLND_CB *glnd_cb, GLND_RESOURCE_I
 			}
 		} else if (lck_list_m_info->lock_info.lock_type == SA_LCK_EX_LOCK_MODE) {
 			/* move it to the exclusive wait list */
-			lck_list_m_info->next = res_node->lck_master_info.wait_exclusive_list;
-			if (res_node->lck_master_info.wait_exclusive_list)
-				res_node->lck_master_info.wait_exclusive_list->prev = lck_list_m_info;
-			res_node->lck_master_info.wait_exclusive_list = lck_list_m_info;
+			glnd_resource_master_queue_add(res_node, lck_list_m_info, GLND_LOCK_QUEUE_WAIT_EX);
 		} else {
 			/* move it to the read wait list */
-			lck_list_m_info->next = res_node->lck_master_info.wait_read_list;
-			if (res_node->lck_master_info.wait_read_list)
-				res_node->lck_master_info.wait_read_list->prev = lck_list_m_info;
-			res_node->lck_master_info.wait_read_list = lck_list_m_info;
+			glnd_resource_master_queue_add(res_node, lck_list_m_info, GLND_LOCK_QUEUE_WAIT_PR);
 		}
 
 	}
@@ -1662,23 +1716,13 @@ void glnd_resource_master_process_resend_lock_req(GLND_CB *glnd_cb,
 	/* check to see the status of the lock */
 	if (lock_info.lockStatus == SA_LCK_LOCK_GRANTED) {
 		/* move it to the grant queue */
-		lck_list_info->next = res_node->lck_master_info.grant_list;
-		if (res_node->lck_master_info.grant_list)
-			res_node->lck_master_info.grant_list->prev = lck_list_info;
-		res_node->lck_master_info.grant_list = lck_list_info;
-
+		glnd_resource_master_queue_add(res_node, lck_list_info, GLND_LOCK_QUEUE_GRANT);
 	} else if (lock_info.lock_type == SA_LCK_EX_LOCK_MODE) {
 		/* move it to the exclusive wait list */
-		lck_list_info->next = res_node->lck_master_info.wait_exclusive_list;
-		if (res_node->lck_master_info.wait_exclusive_list)
-			res_node->lck_master_info.wait_exclusive_list->prev = lck_list_info;
-		res_node->lck_master_info.wait_exclusive_list = lck_list_info;
+		glnd_resource_master_queue_add(res_node, lck_list_info, GLND_LOCK_QUEUE_WAIT_EX);
 	} else {
 		/* move it to the read wait list */
-		lck_list_info->next = res_node->lck_master_info.wait_read_list;
-		if (res_node->lck_master_info.wait_read_list)
-			res_node->lck_master_info.wait_read_list->prev = lck_list_info;
-		res_node->lck_master_info.wait_read_list = lck_list_info;
+		glnd_resource_master_queue_add(res_node, lck_list_info, GLND_LOCK_QUEUE_WAIT_PR);
 	}
 	TRACE_LEAVE();
 	return;
@@ -74,6 +74,9 @@ void glnd_resource_lock_req_delete(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_L
 
 void glnd_resource_lock_req_destroy(GLND_RESOURCE_INFO *res_info, GLND_RES_LOCK_LIST_INFO *lck_list_info);
 
+void glnd_resource_master_queue_add(GLND_RESOURCE_INFO *res_info,
+				    GLND_RES_LOCK_LIST_INFO *lck_list_info, GLND_LOCK_QUEUE queue);
+
 GLND_RES_LOCK_LIST_INFO *glnd_resource_master_process_lock_req(GLND_CB *cb,
 									GLND_RESOURCE_INFO *res_info,
 									GLSV_LOCK_REQ_INFO lock_info,
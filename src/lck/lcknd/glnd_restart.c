@@ -241,14 +241,13 @@ static uint32_t glnd_restart_add_res_lock_to_resource_tree(GLND_CB *glnd_cb,
 				if (lck_list_info->lock_info.lockStatus == SA_LCK_LOCK_GRANTED) {
 					if (res_info->lck_master_info.grant_list == NULL) {
 						/* add it to the grant list */
-						res_info->lck_master_info.grant_list = lck_list_info;
+						glnd_resource_master_queue_add(res_info, lck_list_info,
+									       GLND_LOCK_QUEUE_GRANT);
 					}
 				} else {
 					/*Add to the wait_list */
-					lck_list_info->next = res_info->lck_master_info.wait_exclusive_list;
-					if (res_info->lck_master_info.wait_exclusive_list)
-						res_info->lck_master_info.wait_exclusive_list->prev = lck_list_info;
-					res_info->lck_master_info.wait_exclusive_list = lck_list_info;
+					glnd_resource_master_queue_add(res_info, lck_list_info,
+								       GLND_LOCK_QUEUE_WAIT_EX);
 
 					if (lck_list_info->req_mdest_id == glnd_cb->glnd_mdest_id) {
 						glnd_start_tmr(glnd_cb, &lck_list_info->timeout_tmr,
@@ -261,17 +260,13 @@ static uint32_t glnd_restart_add_res_lock_to_resource_tree(GLND_CB *glnd_cb,
 			}
 			if (lck_list_info->lock_info.lock_type == SA_LCK_PR_LOCK_MODE) {
 				if (lck_list_info->lock_info.lockStatus == SA_LCK_LOCK_GRANTED) {
-					lck_list_info->next = res_info->lck_master_info.grant_list;
-					if (res_info->lck_master_info.grant_list)
-						res_info->lck_master_info.grant_list->prev = lck_list_info;
-					res_info->lck_master_info.grant_list = lck_list_info;
+					glnd_resource_master_queue_add(res_info, lck_list_info,
+								       GLND_LOCK_QUEUE_GRANT);
 				} else {
 					/*Add to the wait_list */
 					/* add it to the read wait list */
-					lck_list_info->next = res_info->lck_master_info.wait_read_list;
-					if (res_info->lck_master_info.wait_read_list)
-						res_info->lck_master_info.wait_read_list->prev = lck_list_info;
-					res_info->lck_master_info.wait_read_list = lck_list_info;
+					glnd_resource_master_queue_add(res_info, lck_list_info,
+								       GLND_LOCK_QUEUE_WAIT_PR);
 
 					if (lck_list_info->req_mdest_id == glnd_cb->glnd_mdest_id) {
 						glnd_start_tmr(glnd_cb, &lck_list_info->timeout_tmr,
@@ -348,6 +348,9 @@ static void amf_comp_terminate_callback(SaInvocationT invocation, const SaNameT
 
   /* Disconnect from MDS */
   lgs_mds_finalize(lgs_cb);
+
+  /* Write log records still queued for the file thread */
+  (void) log_file_flush();
   sleep(1);
   LOG_NO("Received AMF component terminate callback, exiting");
   exit(0);
@@ -21,6 +21,7 @@
 
 #include "lgs_mbcsv_v1.h"
 #include "lgs_mbcsv_v2.h"
+#include "lgs_mbcsv_v6.h"
 #include "lgs_recov.h"
 #include "lgs_imm_gcfg.h"
 #include "base/osaf_extended_name.h"
@@ -1232,6 +1233,7 @@ static uint32_t proc_write_log_async_msg(lgs_cb_t *cb, lgsv_lgs_evt_t *evt) {
   lgsv_ckpt_msg_v2_t ckpt_v2;
   void *ckpt_ptr;
   uint32_t max_logrecsize = 0;
+  uint32_t prev_file_size;
   char node_name[_POSIX_HOST_NAME_MAX];
 
   memset(node_name, 0, _POSIX_HOST_NAME_MAX);
@@ -1272,12 +1274,13 @@ static uint32_t proc_write_log_async_msg(lgs_cb_t *cb, lgsv_lgs_evt_t *evt) {
     goto done;
   }
 
-  if ((n = lgs_format_log_record(param->logRecord, stream->logFileFormat, stream->maxLogFileSize,
+  if ((n = lgs_format_log_record_compiled(param->logRecord, stream->logFileFormatCompiled, stream->maxLogFileSize,
                                  stream->fixedLogRecordSize, buf_size, logOutputString, ++stream->logRecordId, node_name)) == 0) {
     error = SA_AIS_ERR_INVALID_PARAM;
     goto done;
   }
 
+  prev_file_size = stream->curFileSize;
   rc = log_stream_write_h(stream, logOutputString, n);
 
   /* '\0' terminate log record string before check pointing.
@@ -1294,7 +1297,13 @@ static uint32_t proc_write_log_async_msg(lgs_cb_t *cb, lgsv_lgs_evt_t *evt) {
 
   /* TODO: send fail back if ack is wanted, Fix counter for application stream!! */
   if (cb->ha_state == SA_AMF_HA_ACTIVE) {
-    if (lgs_is_peer_v2()) {
+    if (lgs_ckpt_write_hwm_enabled()) {
+      /* Check-pointed in batches. The file size is reset when a new log
+       * file is created
+       */
+      lgs_ckpt_write_hwm_mark(cb, stream, stream->curFileSize < prev_file_size);
+      ckpt_ptr = NULL;
+    } else if (lgs_is_peer_v2()) {
       memset(&ckpt_v2, 0, sizeof(ckpt_v2));
       ckpt_v2.header.ckpt_rec_type = LGS_CKPT_LOG_WRITE;
       ckpt_v2.header.num_ckpt_records = 1;
@@ -1320,7 +1329,8 @@ static uint32_t proc_write_log_async_msg(lgs_cb_t *cb, lgsv_lgs_evt_t *evt) {
       ckpt_ptr = &ckpt_v1;
     }
 
-    (void)lgs_ckpt_send_async(cb, ckpt_ptr, NCS_MBCSV_ACT_ADD);
+    if (ckpt_ptr != NULL)
+      (void)lgs_ckpt_send_async(cb, ckpt_ptr, NCS_MBCSV_ACT_ADD);
   }
 
   /* Save stb_recordId. Used by standby if configured for split file system.
@@ -1330,20 +1340,8 @@ static uint32_t proc_write_log_async_msg(lgs_cb_t *cb, lgsv_lgs_evt_t *evt) {
   stream->stb_logRecordId = stream->logRecordId;
 
 done:
-  /*
-    Since the logOutputString is referred by the log handler thread, in timeout case,
-    the log API thread might be still using the log record memory.
-
-    To make sure there is no corruption of memory usage in case of time-out (rc = -2),
-    We leave the log record memory freed to the log handler thread..
-
-    It is never a good idea to allocate and free memory in different places.
-    But consider it as a trade-off to have a better performance of LOGsv
-    as time-out occurs very rarely.
-
-    Other cases, the allocator frees it.
-  */
-  if ((rc != -2) && (logOutputString != NULL)) {
+  /* The log record is copied when queued for writing */
+  if (logOutputString != NULL) {
     free(logOutputString);
     logOutputString = NULL;
   }
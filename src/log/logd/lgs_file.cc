@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <unistd.h>
+#include <sys/uio.h>
 
 #include "base/logtrace.h"
 #include <errno.h>
@@ -70,6 +71,34 @@ static struct file_communicate lgs_com_data;
 
 static pthread_t file_thread_id;
 
+/* Default size of the write ring of a stream, changed with the environment
+ * variable LOGSV_WRITE_QUEUE_SIZE. A record that does not fit is rejected
+ * with LGSF_BUSY and the client gets SA_AIS_ERR_TRY_AGAIN. A ring always
+ * holds a log record of the maximum size.
+ */
+#define LGSF_WRING_SIZE (1024 * 1024)
+#define LGSF_WRING_MIN_SIZE (64 * 1024)
+
+static size_t wring_size = LGSF_WRING_SIZE;
+
+/* Log records of a stream queued for the file thread.
+ * The main thread appends at the tail, the file thread writes from the head.
+ * All fields are protected by lgs_ftcom_mutex. The bytes between head and
+ * head + used are owned by the file thread while it is writing them.
+ */
+struct lgsf_wring {
+  struct lgsf_wring *next;
+  char *buf;       /* wring_size bytes */
+  size_t head;     /* Offset of the first byte not yet written */
+  size_t used;     /* Number of bytes queued */
+  int fd;          /* File descriptor of the stream when appended, -1 while
+                    * the records wait for the stream file to be reopened */
+  int write_errno; /* Error of a failed write, reported on next append */
+  bool freed_f;    /* Stream is gone. Unlinked and freed by the file thread */
+};
+
+static lgsf_wring_t *wring_first_p = NULL;
+
 /*****************************************************************************
  * Utility functions
  *****************************************************************************/
@@ -94,6 +123,110 @@ static void get_timeout_time(struct timespec *timeout_time, uint32_t timeout_ms)
  * Thread handling
  *****************************************************************************/
 
+/**
+ * Write one batch of queued log records with a single writev(). A batch is
+ * everything queued in a ring, at most two iovecs if the data wraps.
+ * Called with lgs_ftcom_mutex locked. The mutex is unlocked during the write.
+ *
+ * If the write fails only the unwritten part of the batch is lost. Records
+ * queued during the write are kept for the file the stream reopens when the
+ * error is reported.
+ *
+ * @param wring[in]
+ */
+static void wring_write(lgsf_wring_t *wring) {
+  struct iovec iov[2];
+  int iovcnt = 1;
+  size_t count = wring->used;
+  size_t written = 0;
+  ssize_t rc;
+  int fd = wring->fd;
+  int write_errno = 0;
+
+  iov[0].iov_base = &wring->buf[wring->head];
+  if (wring->head + count > wring_size) {
+    iov[0].iov_len = wring_size - wring->head;
+    iov[1].iov_base = wring->buf;
+    iov[1].iov_len = count - iov[0].iov_len;
+    iovcnt = 2;
+  } else {
+    iov[0].iov_len = count;
+  }
+
+  osaf_mutex_unlock_ordie(&lgs_ftcom_mutex); /* UNLOCK  Critical section */
+
+  while (written < count) {
+    rc = writev(fd, iov, iovcnt);
+    if (rc == -1) {
+      if (errno == EINTR) continue;
+
+      write_errno = errno;
+      LOG_ER("%s - write FAILED: %s",__FUNCTION__, strerror(errno));
+      break;
+    }
+
+    /* Handle partial writes */
+    written += rc;
+    while ((iovcnt > 0) && (static_cast<size_t>(rc) >= iov[0].iov_len)) {
+      rc -= iov[0].iov_len;
+      iov[0] = iov[1];
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov[0].iov_base = static_cast<char *>(iov[0].iov_base) + rc;
+      iov[0].iov_len -= rc;
+    }
+  }
+
+  osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK after critical section */
+
+  if (write_errno != 0) {
+    /* Let the next append report the error so that the stream file is
+     * reopened. Nothing is written until then.
+     */
+    LOG_ER("%s - %zu bytes of log records lost", __FUNCTION__,
+           count - written);
+    wring->write_errno = write_errno;
+  }
+  wring->head = (wring->head + count) % wring_size;
+  wring->used -= count;
+}
+
+/**
+ * Write queued log records once and free the rings of deleted streams.
+ * Called with lgs_ftcom_mutex locked. Rings are only unlinked here so the
+ * list can be walked while the mutex is unlocked during a write.
+ *
+ * @param fd[in] Only write the records for this file, -1 for all files
+ * @return true if anything was written
+ */
+static bool wring_drain(int fd) {
+  lgsf_wring_t **wring_pp = &wring_first_p;
+  lgsf_wring_t *wring;
+  bool written_f = false;
+
+  while ((wring = *wring_pp) != NULL) {
+    if (wring->freed_f == true) {
+      *wring_pp = wring->next;
+      free(wring->buf);
+      free(wring);
+      continue;
+    }
+
+    if ((wring->used != 0) && (wring->fd != -1) &&
+        (wring->write_errno == 0) && ((fd == -1) || (wring->fd == fd))) {
+      wring_write(wring);
+      written_f = true;
+
+      /* Do not keep a request waiting for the other streams */
+      if ((fd == -1) && (lgs_com_data.request_f == true)) break;
+    }
+    wring_pp = &wring->next;
+  }
+
+  return written_f;
+}
+
 /**
  * Thread:
  * Handle functions using file I/O
@@ -116,8 +249,9 @@ static void *file_hndl_thread(void *noparam) {
 
   osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK */
   while(1) {
-    /* Wait for request */
+    /* Wait for request, writing queued log records meanwhile */
     if (lgs_com_data.request_f == false) {
+      if (wring_drain(-1) == true) continue;
       rc = pthread_cond_wait(&request_cv, &lgs_ftcom_mutex); /* -> UNLOCK -> LOCK */
       if (rc != 0) osaf_abort(rc);
     } else {
@@ -133,6 +267,18 @@ static void *file_hndl_thread(void *noparam) {
        * file I/O functions. Mutex is locked when _hdl function returns.
        */
 
+      /* Only the log records a request depends on are written before it,
+       * so that it is not delayed by the queues of other streams. A file
+       * is closed after the writes to it, the file parameters are read
+       * after all writes.
+       */
+      if (lgs_com_data.request_code == LGSF_FILECLOSE) {
+        while (wring_drain(*static_cast<int *>(lgs_com_data.indata_ptr)) == true) {}
+      } else if ((lgs_com_data.request_code == LGSF_GET_FILE_PAR) ||
+                 (lgs_com_data.request_code == LGSF_FLUSH)) {
+        while (wring_drain(-1) == true) {}
+      }
+
       /* Invoke requested handler function */
       switch (lgs_com_data.request_code)      {
         case LGSF_FILEOPEN:
@@ -156,10 +302,9 @@ static void *file_hndl_thread(void *noparam) {
           hndl_rc = make_log_dir_hdl(lgs_com_data.indata_ptr,
                                      lgs_com_data.outdata_ptr, lgs_com_data.outdata_size);
           break;
-        case LGSF_WRITELOGREC:
-          hndl_rc = write_log_record_hdl(lgs_com_data.indata_ptr,
-                                         lgs_com_data.outdata_ptr, lgs_com_data.outdata_size,
-                                         &lgs_com_data.timeout_f);
+        case LGSF_FLUSH:
+          /* Queued records are already written */
+          hndl_rc = 0;
           break;
         case LGSF_CREATECFGFILE:
           hndl_rc = create_config_file_hdl(lgs_com_data.indata_ptr,
@@ -258,6 +403,21 @@ uint32_t lgs_file_init() {
 
   TRACE_ENTER();
 
+  const char *val_str = getenv("LOGSV_WRITE_QUEUE_SIZE");
+  if (val_str != NULL) {
+    char *endptr;
+    errno = 0;
+    unsigned long val = strtoul(val_str, &endptr, 0);
+    if ((errno != 0) || (endptr == val_str) || (*endptr != '\0') ||
+        (val < LGSF_WRING_MIN_SIZE)) {
+      LOG_WA("Invalid value LOGSV_WRITE_QUEUE_SIZE=\"%s\" is ignored, "
+             "minimum %d", val_str, LGSF_WRING_MIN_SIZE);
+    } else {
+      wring_size = val;
+    }
+  }
+  TRACE("Write queue size %zu bytes", wring_size);
+
   if (start_file_thread() != 0) {
     rc = NCSCC_RC_FAILURE;
   }
@@ -461,6 +621,123 @@ api_exit:
   return api_rc;
 }
 
+/**
+ * Queue a log record to be written to the stream file by the file thread.
+ * The record is copied, the caller keeps ownership of buf.
+ *
+ * @param wring_p[in/out] Write ring of the stream, created on first use
+ * @param fd[in] Current file descriptor of the stream
+ * @param buf[in] Log record
+ * @param count[in] Size of log record
+ * @param errno_out[out] errno of a failed earlier write if LGSF_FAIL
+ * @return LGSF_SUCESS if queued
+ *         LGSF_BUSY if the ring is full
+ *         LGSF_FAIL if an earlier write to the stream file has failed. The
+ *                   record is not queued.
+ */
+lgsf_retcode_t log_file_write_async(lgsf_wring_t **wring_p, int fd,
+                                    const char *buf, size_t count,
+                                    int *errno_out) {
+  lgsf_retcode_t api_rc = LGSF_SUCESS;
+  lgsf_wring_t *wring;
+  size_t tail;
+  size_t part;
+  bool held_f;
+  int rc = 0;
+
+  *errno_out = 0;
+
+  if (*wring_p == NULL) {
+    wring = static_cast<lgsf_wring_t *>(calloc(1, sizeof(lgsf_wring_t)));
+    if (wring != NULL) wring->buf = static_cast<char *>(malloc(wring_size));
+    if ((wring == NULL) || (wring->buf == NULL)) {
+      LOG_ER("%s Could not allocate memory for write ring", __FUNCTION__);
+      free(wring);
+      *errno_out = ENOMEM;
+      return LGSF_FAIL;
+    }
+    wring->fd = -1;
+
+    osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK */
+    wring->next = wring_first_p;
+    wring_first_p = wring;
+    osaf_mutex_unlock_ordie(&lgs_ftcom_mutex); /* UNLOCK */
+    *wring_p = wring;
+  }
+  wring = *wring_p;
+
+  osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK */
+
+  if (wring->write_errno != 0) {
+    /* The stream file is closed and reopened by the caller. Records still
+     * queued are kept for the new file.
+     */
+    *errno_out = wring->write_errno;
+    wring->write_errno = 0;
+    wring->fd = -1;
+    api_rc = LGSF_FAIL;
+    goto done;
+  }
+
+  if (wring->used + count > wring_size) {
+    TRACE("%s - LGSF_BUSY, %zu bytes queued", __FUNCTION__, wring->used);
+    api_rc = LGSF_BUSY;
+    goto done;
+  }
+
+  /* A file is only closed by the file thread, after the records queued for
+   * it have been written, so everything queued is for the same file.
+   */
+  held_f = (wring->fd == -1);
+  wring->fd = fd;
+  tail = (wring->head + wring->used) % wring_size;
+  part = count;
+  if (tail + count > wring_size) part = wring_size - tail;
+  memcpy(&wring->buf[tail], buf, part);
+  memcpy(wring->buf, buf + part, count - part);
+  wring->used += count;
+
+  /* Wake up the thread if this is the first record it can write */
+  if ((wring->used == count) || (held_f == true)) {
+    rc = pthread_cond_signal(&request_cv);
+    if (rc != 0) osaf_abort(rc);
+  }
+
+done:
+  osaf_mutex_unlock_ordie(&lgs_ftcom_mutex); /* UNLOCK */
+  return api_rc;
+}
+
+/**
+ * Free the write ring of a deleted stream. Records still queued are dropped.
+ *
+ * @param wring[in]
+ */
+void log_file_wring_free(lgsf_wring_t *wring) {
+  if (wring == NULL) return;
+
+  osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK */
+  wring->freed_f = true;
+  osaf_mutex_unlock_ordie(&lgs_ftcom_mutex); /* UNLOCK */
+}
+
+/**
+ * Wait until the file thread has written all queued log records
+ *
+ * @return A lgsf return code
+ */
+lgsf_retcode_t log_file_flush() {
+  lgsf_apipar_t apipar;
+
+  apipar.req_code_in = LGSF_FLUSH;
+  apipar.data_in_size = 0;
+  apipar.data_in = NULL;
+  apipar.data_out_size = 0;
+  apipar.data_out = NULL;
+
+  return log_file_api(&apipar);
+}
+
 /**
  * Return lgsf return code as a string
  * @param rc
@@ -37,13 +37,13 @@ typedef enum {
   LGSF_DELETE_FILE,
   LGSF_GET_NUM_LOGFILES,
   LGSF_MAKELOGDIR,
-  LGSF_WRITELOGREC,
   LGSF_CREATECFGFILE,
   LGSF_RENAME_FILE,
   LGSF_CHECKPATH,
   LGSF_CHECKDIR,
   LGSF_OWN_LOGFILES,
   LGSF_GET_FILE_PAR,
+  LGSF_FLUSH,
   LGSF_NOREQ
 }lgsf_treq_t;
 
@@ -57,9 +57,17 @@ typedef struct {
   void *data_out; /* Buffer containing out data from the handler */
 }lgsf_apipar_t;
 
+/* Log records of a stream queued for the file thread */
+typedef struct lgsf_wring lgsf_wring_t;
+
 char *lgsf_retcode_str(lgsf_retcode_t rc);
 uint32_t lgs_file_init();
 lgsf_retcode_t log_file_api(lgsf_apipar_t *param_in);
+lgsf_retcode_t log_file_write_async(lgsf_wring_t **wring_p, int fd,
+                                    const char *buf, size_t count,
+                                    int *errno_out);
+void log_file_wring_free(lgsf_wring_t *wring);
+lgsf_retcode_t log_file_flush();
 void lgs_fd_list_add(int32_t fd);
 int32_t lgs_fd_list_get();
 
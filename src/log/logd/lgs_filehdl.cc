@@ -219,98 +219,6 @@ done:
   return rc;
 }
 
-/**
- * Write a log record to file
- * The file must be opened for append
- *
- * @param indata[in] Type wlrh_t
- * @param outdata[out], int errno, 0 if no error
- * @param max_outsize[in], always sizeof(int)
- * @return (-1) on error or number of written bytes
- */
-int write_log_record_hdl(void *indata, void *outdata, size_t max_outsize, bool *timeout_f) {
-  int rc = 0;
-  uint32_t bytes_written = 0;
-  off_t file_length = 0;
-  wlrh_t *params_in = static_cast<wlrh_t *>(indata);
-  /* Get log record pointed by lgs_rec pointer */
-  char *logrecord = const_cast<char *>(static_cast<const char*>(params_in->lgs_rec));
-  int *errno_out_p = static_cast<int *>(outdata);
-  *errno_out_p = 0;
-
-  TRACE_ENTER();
-
-  osaf_mutex_unlock_ordie(&lgs_ftcom_mutex); /* UNLOCK  Critical section */
-
-retry:
-  rc = write(params_in->fd, &logrecord[bytes_written],
-             params_in->record_size - bytes_written);
-  if (rc == -1) {
-    if (errno == EINTR)
-      goto retry;
-
-    LOG_ER("%s - write FAILED: %s",__FUNCTION__, strerror(errno));
-    *errno_out_p = errno;
-    goto done;
-  } else {
-    /* Handle partial writes */
-    bytes_written += rc;
-    if (bytes_written < params_in->record_size)
-      goto retry;
-  }
-  osaf_mutex_lock_ordie(&lgs_ftcom_mutex); /* LOCK after critical section */
-
-  /* If the thread was hanging and has timed out and the log record was
-   * written it is invalid and shall be removed from file (log service has
-   * returned SA_AIS_TRY_AGAIN).
-   */
-  if (*timeout_f == true) {
-    LOG_NO("Timeout, removing last log record");
-    file_length = lseek(params_in->fd, -((off_t)bytes_written), SEEK_END);
-    if (file_length != -1) {
-      do {
-        rc = ftruncate(params_in->fd, file_length);
-      } while ((rc == -1) && (errno == EINTR));
-    }
-
-    if (file_length == -1) {
-      LOG_WA("%s - lseek error, Could not remove redundant log record, %s",
-             __FUNCTION__,strerror(errno));
-    } else if (rc == -1) {
-      LOG_WA("%s - ftruncate error, Could not remove redundant log record, %s",
-             __FUNCTION__,strerror(errno));
-    }
-  }
-
-done:
-  /*
-    Log record memory is allocated by the caller and this memory is
-    used or referred by main thread as well as log handler thread.
-
-    In most cases, the caller thread is blocked until the log handler thread
-    finishs the request (e.g: finish writing log record to file).
-    Therefore, once the caller thread is unblocked, it is safe to free
-    the log record memory as the log handler thread no longer uses it.
-
-    But in time-out case, it is unsure when the log handler thread
-    use the log record memory.
-
-    To make sure there is no corruption of memory usage in case of time-out,
-    We leave the log record memory freed at the end of this function.
-
-    It is never a good idea to allocate and free memory in different places.
-    But consider it as a trade-off to have a better performance of LOGsv
-    as time-out occurs very rarely.
-  */
-  if ((*timeout_f == true) && (logrecord != NULL)) {
-    free(logrecord);
-    logrecord = NULL;
-  }
-
-  TRACE_LEAVE2("rc = %d",rc);
-  return rc;
-}
-
 /**
  * Make directory. Handles creation of directory path.
  * Creates the relative directory in the directory given by the root path.
@@ -84,17 +84,6 @@ typedef struct {
   char *pathName;
 } gnolfh_in_t;
 
-/*
- * write_log_record_hdl(..)
- * Outpar int errno_save
- */
-typedef struct {
-  int fd; /* File descriptor for current log file */
-  size_t record_size; /* Size of logrecord including '\0' */
-  SaUint32T fixedLogRecordSize;
-  const void *lgs_rec;  /* Pointer to allocated log record */
-}wlrh_t;
-
 /*
  * create_config_file_hdl(..)
  * No out parameters
@@ -179,7 +168,6 @@ int path_is_writeable_dir_hdl(void *indata, void *outdata, size_t max_outsize);
 int check_path_exists_hdl(void *indata, void *outdata, size_t max_outsize);
 int rename_file_hdl(void *indata, void *outdata, size_t max_outsize);
 int create_config_file_hdl(void *indata, void *outdata, size_t max_outsize);
-int write_log_record_hdl(void *indata, void *outdata, size_t max_outsize, bool *timeout_f);
 int make_log_dir_hdl(void *indata, void *outdata, size_t max_outsize);
 int fileopen_hdl(void *indata, void *outdata, size_t max_outsize, bool *timeout_f);
 int fileclose_hdl(void *indata, void *outdata, size_t max_outsize);
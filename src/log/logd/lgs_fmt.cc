@@ -20,6 +20,8 @@
 #include <string.h>
 #include <ctype.h>
 #include <time.h>
+#include <string>
+#include <vector>
 #include "base/logtrace.h"
 
 #include "lgs_fmt.h"
@@ -1247,6 +1249,61 @@ SaBoolT lgs_is_valid_format_expression(const SaStringT formatExpression,
   return formatExpressionOk;
 }
 
+/**
+ * Pad or terminate a formatted log record and insert the truncation info
+ * letter if the format expression has one
+ *
+ * @param dest formatted log record
+ * @param dest_size size of dest
+ * @param i number of bytes formatted into dest
+ * @param logFileSize
+ * @param fixedLogRecordSize if 0 do not pad
+ * @param truncationLetterPos position of the truncation letter or -1
+ * @param truncationCharacter
+ *
+ * @return size_t length of the log record
+ */
+static size_t terminateLogRecord(char *dest, size_t dest_size, size_t i,
+                                 SaUint64T logFileSize,
+                                 SaUint16T fixedLogRecordSize,
+                                 SaInt32T truncationLetterPos,
+                                 SaInt8T truncationCharacter) {
+  /* Pad log record to fixed log record fieldSize */
+  if ((fixedLogRecordSize > 0) && (i < fixedLogRecordSize)) {
+    memset(&dest[i], ' ', fixedLogRecordSize - i);
+    dest[fixedLogRecordSize - 1] = '\n';
+    i = fixedLogRecordSize;
+  } else if ((fixedLogRecordSize > 0) && (i >= fixedLogRecordSize)) {
+    dest[fixedLogRecordSize - 2] = (SaInt8T)'\"';
+    dest[fixedLogRecordSize - 1] = '\n';
+    i = fixedLogRecordSize;
+  }
+
+  if ((fixedLogRecordSize == 0) && (i < dest_size)) {
+    dest[i] = '\n';
+    ++i;
+  } else if ((fixedLogRecordSize == 0) && (i >= dest_size)) { /* dest size = record size +1 */
+    if (i >= logFileSize) {
+      /* There can be situations when the filesize is as small as the maxrecsize.
+       * For eg:- By default for the application streams max file size is 1024
+       */
+      dest[logFileSize - 2] = (SaInt8T)'\"';
+      dest[logFileSize - 1] = '\n';
+      i = logFileSize;
+    } else {
+      dest[dest_size - 2] = (SaInt8T)'\"';
+      dest[dest_size - 1] = '\n';
+      i = dest_size;
+    }
+  }
+
+  if (truncationLetterPos != -1) {        /* Insert truncation info letter */
+    dest[truncationLetterPos] = truncationCharacter;
+  }
+
+  return i;
+}
+
 /**
  * Format a log record
  *
@@ -1357,39 +1414,713 @@ int lgs_format_log_record(SaLogRecordT *logRecord,
     fmtExpPtrSnabel = (fmtExpPtr + 1);
   }                       /* for ( ; ; ) */
 
-  /* Pad log record to fixed log record fieldSize */
-  if ((fixedLogRecordSize > 0) && (i < fixedLogRecordSize)) {
-    memset(&dest[i], ' ', fixedLogRecordSize - i);
-    dest[fixedLogRecordSize - 1] = '\n';
-    i = fixedLogRecordSize;
-  } else if ((fixedLogRecordSize > 0) && (i >= fixedLogRecordSize)) {
-    dest[fixedLogRecordSize - 2] = (SaInt8T)'\"';
-    dest[fixedLogRecordSize - 1] = '\n';
-    i = fixedLogRecordSize;
+  i = terminateLogRecord(dest, dest_size, i, logFileSize, fixedLogRecordSize,
+                         truncationLetterPos, truncationCharacter);
+
+error_exit:
+  return i;
+}
+
+/*
+ * Compiled format expressions
+ *
+ * The format expression of a stream is parsed once into a sequence of
+ * elements: runs of literal characters, fields, and time blocks. A time
+ * block is a run of fields with one second resolution (e.g. @Ch:@Cn:@Cs
+ * @Cm/@Cd/@CY) and the literals between them. Its output is cached and only
+ * rendered again when the second of the time stamp changes, which saves the
+ * localtime_r() and snprintf() calls for most log records.
+ *
+ * The output is identical to the output of lgs_format_log_record(),
+ * including truncation. A time block that does not fit in the remaining
+ * space is therefore emitted field by field.
+ *
+ * The time block caches are not protected and a compiled format expression
+ * must only be used from one thread.
+ */
+
+typedef enum {
+  FMT_ELEM_LITERAL,
+  FMT_ELEM_FIELD,
+  FMT_ELEM_TIME_BLOCK
+} lgs_fmt_elem_kind_t;
+
+struct lgs_fmt_elem {
+  lgs_fmt_elem_kind_t kind;
+  char fieldType;               /* COMMON, NOTIFICATION or SYSTEM */
+  char letter;                  /* Token letter */
+  SaInt32T fieldSize;           /* 0 if no field size is given */
+  bool lastInExpression;        /* Literal run that ends the expression */
+  std::string text;             /* Literal run or cached time block output */
+  std::vector<lgs_fmt_elem> block;  /* Elements of a time block */
+  SaTimeT cachedSecond;
+  bool cacheValid;
+};
+
+struct lgs_compiled_fmt {
+  std::string formatExpression;
+  bool compiled;                /* false, use lgs_format_log_record() */
+  std::vector<lgs_fmt_elem> elems;
+};
+
+/* Data for formatting one log record */
+typedef struct {
+  const SaLogRecordT *logRecord;
+  SaUint32T logRecordIdCounter;
+  const char *node_name;
+  SaUint16T rec_size;
+  SaInt32T truncationLetterPos;
+  struct tm timeStampData;
+  bool timeStampDataValid;
+  struct tm eventTimeData;
+  bool eventTimeDataValid;
+} lgs_fmt_ctx_t;
+
+static bool fieldHasFieldSize(char fieldType, char letter) {
+  switch (fieldType) {
+    case COMMON_LOG_RECORD_FIELD_TYPE:
+      return letter == C_LR_STRING_BODY_LETTER ||
+          letter == C_LR_HEX_CHAR_BODY_LETTER;
+    case NOTIFICATION_LOG_RECORD_FIELD_TYPE:
+      return letter == N_EVENT_TYPE_LETTER ||
+          letter == N_NOTIFICATION_OBJECT_LETTER ||
+          letter == N_NOTIFYING_OBJECT_LETTER;
+    default:
+      return letter == S_LOGGER_NAME_LETTER;
   }
+}
 
-  if ((fixedLogRecordSize == 0) && (i < dest_size)) {
-    dest[i] = '\n';
-    ++i;
-  } else if ((fixedLogRecordSize == 0) && (i >= dest_size)) { /* dest size = record size +1 */
-    if (i >= logFileSize) {
-      /* There can be situations when the filesize is as small as the maxrecsize.
-       * For eg:- By default for the application streams max file size is 1024
-       */
-      dest[logFileSize - 2] = (SaInt8T)'\"';
-      dest[logFileSize - 1] = '\n';
-      i = logFileSize;
+/* Fields that only change when the second of the time changes */
+static bool isSecondTimeField(const lgs_fmt_elem &elem) {
+  if (elem.kind != FMT_ELEM_FIELD ||
+      elem.fieldType == SYSTEM_LOG_RECORD_FIELD_TYPE)
+    return false;
+
+  switch (elem.letter) {
+    case C_TIME_STAMP_HOUR_LETTER:
+    case C_TIME_STAMP_MINUTE_LETTER:
+    case C_TIME_STAMP_SECOND_LETTER:
+    case C_TIME_STAMP_12_24_MODE_LETTER:
+    case C_TIME_STAMP_MONTH_LETTER:
+    case C_TIME_STAMP_MON_LETTER:
+    case C_TIME_STAMP_DAY_LETTER:
+    case C_TIME_STAMP_DAYN_LETTER:
+    case C_TIME_STAMP_YEAR_LETTER:
+    case C_TIME_STAMP_FULL_YEAR_LETTER:
+    case C_TIME_TIMEZONE_LETTER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static SaTimeT fieldTime(const lgs_fmt_ctx_t *ctx, char fieldType) {
+  if (fieldType == NOTIFICATION_LOG_RECORD_FIELD_TYPE)
+    return ctx->logRecord->logHeader.ntfHdr.eventTime;
+  return ctx->logRecord->logTimeStamp;
+}
+
+static const struct tm *fieldTimeData(lgs_fmt_ctx_t *ctx, char fieldType) {
+  bool *valid = &ctx->timeStampDataValid;
+  struct tm *data = &ctx->timeStampData;
+
+  if (fieldType == NOTIFICATION_LOG_RECORD_FIELD_TYPE) {
+    valid = &ctx->eventTimeDataValid;
+    data = &ctx->eventTimeData;
+  }
+
+  if (*valid == false) {
+    SaTimeT totalTime = fieldTime(ctx, fieldType) / (SaTimeT)SA_TIME_ONE_SECOND;
+    osafassert(localtime_r((const time_t *)&totalTime, data));
+    *valid = true;
+  }
+
+  return data;
+}
+
+/**
+ * Copy a string to dest with the same result as snprintf(dest, dest_size,
+ * "%s", src) in the extract functions
+ *
+ * @return int number of characters, at most dest_size
+ */
+static int putString(char *dest, size_t dest_size, const char *src, size_t len) {
+  size_t n = len < dest_size ? len : dest_size - 1;
+
+  memcpy(dest, src, n);
+  dest[n] = '\0';
+  return len < dest_size ? len : dest_size;
+}
+
+/**
+ * Copy at most width characters of a string to dest and pad it with blanks
+ * up to width. Same result as snprintf(dest, dest_size, "%*.*s", -width,
+ * width, src) or, if rightJustify, "%*.*s" with width.
+ *
+ * @return int number of characters, at most dest_size
+ */
+static int putPaddedString(char *dest, size_t dest_size, const char *src,
+                           size_t len, size_t width, bool rightJustify) {
+  size_t pad, n, room = dest_size - 1;
+
+  if (len > width)
+    len = width;
+  pad = width - len;
+
+  if (rightJustify) {
+    n = pad < room ? pad : room;
+    memset(dest, ' ', n);
+    dest += n;
+    room -= n;
+    n = len < room ? len : room;
+    memcpy(dest, src, n);
+    dest += n;
+  } else {
+    n = len < room ? len : room;
+    memcpy(dest, src, n);
+    dest += n;
+    room -= n;
+    n = pad < room ? pad : room;
+    memset(dest, ' ', n);
+    dest += n;
+  }
+  *dest = '\0';
+
+  return width < dest_size ? width : dest_size;
+}
+
+/* Same as snprintf(dest, dest_size, "%#016llx", value) */
+static int putHex64(char *dest, size_t dest_size, unsigned long long value) {
+  static const char hex[] = "0123456789abcdef";
+  char digits[16];
+  char buf[20];
+  int ndigits = 0, len = 0;
+
+  do {
+    digits[ndigits++] = hex[value & 0xf];
+    value >>= 4;
+  } while (value != 0);
+
+  if (ndigits == 1 && digits[0] == '0') {
+    /* The # flag does not add 0x to zero */
+    memset(buf, '0', 16);
+    len = 16;
+  } else {
+    buf[len++] = '0';
+    buf[len++] = 'x';
+    while (len + ndigits < 16) buf[len++] = '0';
+    while (ndigits > 0) buf[len++] = digits[--ndigits];
+  }
+
+  return putString(dest, dest_size, buf, len);
+}
+
+/* Same as snprintf(dest, dest_size, "% 10d", value) */
+static int putRecordId(char *dest, size_t dest_size, int value) {
+  char buf[16];
+  char *p = &buf[sizeof(buf)];
+  unsigned int u = value < 0 ? 0U - (unsigned int)value : (unsigned int)value;
+
+  do {
+    *--p = '0' + u % 10;
+    u /= 10;
+  } while (u != 0);
+  *--p = value < 0 ? '-' : ' ';
+  while (&buf[sizeof(buf)] - p < 10) *--p = ' ';
+
+  return putString(dest, dest_size, p, &buf[sizeof(buf)] - p);
+}
+
+/**
+ * Format a field with one second resolution. Same output as the
+ * corresponding case in extractCommonField() or extractNotificationField().
+ */
+static int formatTimeField(char *dest, size_t dest_size, char fieldType,
+                           char letter, const struct tm *timeData) {
+  static const char *const months[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+  };
+  static const char *const days[] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+  };
+  int characters = 0;
+  long gmtOffset, uGmtOffset;
+
+  switch (letter) {
+    case C_TIME_STAMP_HOUR_LETTER:
+      /* Twelve hour mode is never used when formatting */
+      characters = snprintf(dest, dest_size, "%02d", timeData->tm_hour);
+      break;
+
+    case C_TIME_STAMP_MINUTE_LETTER:
+      characters = snprintf(dest, dest_size, "%02d", timeData->tm_min);
+      break;
+
+    case C_TIME_STAMP_SECOND_LETTER:
+      characters = snprintf(dest, dest_size, "%02d", timeData->tm_sec);
+      break;
+
+    case C_TIME_STAMP_12_24_MODE_LETTER:
+      characters = putString(dest, dest_size,
+                             (timeData->tm_hour >= 0 && timeData->tm_hour < 12) ? "am" : "pm", 2);
+      break;
+
+    case C_TIME_STAMP_MONTH_LETTER:
+      characters = snprintf(dest, dest_size, "%02d", (timeData->tm_mon + 1));
+      break;
+
+    case C_TIME_STAMP_MON_LETTER:
+      if (timeData->tm_mon >= MONTH_JANUARY && timeData->tm_mon <= MONTH_DECEMBER)
+        characters = putString(dest, dest_size, months[timeData->tm_mon], 3);
+      break;
+
+    case C_TIME_STAMP_DAY_LETTER:
+      characters = snprintf(dest, dest_size, "%02d", timeData->tm_mday);
+      break;
+
+    case C_TIME_STAMP_DAYN_LETTER:
+      if (timeData->tm_wday >= DAY_SUNDAY && timeData->tm_wday <= DAY_SATURDAY)
+        characters = putString(dest, dest_size, days[timeData->tm_wday], 3);
+      break;
+
+    case C_TIME_STAMP_YEAR_LETTER:
+      if (fieldType == COMMON_LOG_RECORD_FIELD_TYPE)
+        characters = strftime(dest, dest_size, "%y", timeData);
+      else
+        characters = snprintf(dest, dest_size, "%02d",
+                              timeData->tm_year - (YEAR_2000 - START_YEAR));
+      break;
+
+    case C_TIME_STAMP_FULL_YEAR_LETTER:
+      if (fieldType == COMMON_LOG_RECORD_FIELD_TYPE)
+        characters = strftime(dest, dest_size, "%Y", timeData);
+      else
+        characters = snprintf(dest, dest_size, "%d", (timeData->tm_year + START_YEAR));
+      break;
+
+    case C_TIME_TIMEZONE_LETTER:
+      gmtOffset = (timeData->tm_gmtoff / SECOND_PER_HOUR) * 100 +
+          (timeData->tm_gmtoff % SECOND_PER_HOUR) / SECOND_PER_MINUTE;
+      uGmtOffset = (gmtOffset >= 0) ? (gmtOffset) : (gmtOffset * -1);
+      characters = snprintf(dest, dest_size, "%c%04ld", gmtOffset >= 0 ? '+' : '-', uGmtOffset);
+      break;
+
+    default:
+      break;
+  }
+
+  if (characters < 0)
+    characters = 0;
+
+  if (characters > static_cast<int>(dest_size))
+    characters = dest_size;
+
+  return characters;
+}
+
+/* Same as snprintf(dest, dest_size, "%03lld", ms) */
+static int putMillisecond(char *dest, size_t dest_size, SaTimeT time) {
+  SaTimeT ms = (time / SA_TIME_ONE_MILLISECOND) % SA_TIME_OFFSET;
+  char buf[3];
+
+  if (ms < 0) {
+    int characters = snprintf(dest, dest_size, "%03lld", ms);
+    return characters > static_cast<int>(dest_size) ? dest_size : characters;
+  }
+
+  buf[0] = '0' + ms / 100;
+  buf[1] = '0' + (ms / 10) % 10;
+  buf[2] = '0' + ms % 10;
+  return putString(dest, dest_size, buf, 3);
+}
+
+/* Same as "%x" of each byte in the body, see extractCommonField() */
+static void hexBody(const SaLogBufferT *logBuffer, std::string *hex_string) {
+  static const char hex[] = "0123456789abcdef";
+
+  hex_string->clear();
+  hex_string->reserve(2 * logBuffer->logBufSize);
+  for (size_t i = 0; i < logBuffer->logBufSize; i++) {
+    SaUint8T c = logBuffer->logBuf[i];
+    if (c >= 0x10)
+      hex_string->push_back(hex[c >> 4]);
+    hex_string->push_back(hex[c & 0xf]);
+  }
+}
+
+static int putName(char *dest, size_t dest_size, SaConstStringT name,
+                   SaInt32T fieldSize) {
+  size_t len = strlen(name);
+
+  if (fieldSize == 0)
+    return putString(dest, dest_size, name, len);
+  return putPaddedString(dest, dest_size, name, len, fieldSize, false);
+}
+
+/**
+ * Format one field. Same output as extractCommonField(),
+ * extractNotificationField() and extractSystemField().
+ *
+ * @return int number of characters, at most dest_size
+ */
+static int formatField(char *dest, size_t dest_size, const lgs_fmt_elem &elem,
+                       size_t inputPos, lgs_fmt_ctx_t *ctx) {
+  const SaLogRecordT *logRecord = ctx->logRecord;
+  int characters = 0;
+
+  if (isSecondTimeField(elem))
+    return formatTimeField(dest, dest_size, elem.fieldType, elem.letter,
+                           fieldTimeData(ctx, elem.fieldType));
+
+  if (elem.fieldType == COMMON_LOG_RECORD_FIELD_TYPE) {
+    const SaLogBufferT *logBuffer = logRecord->logBuffer;
+
+    switch (elem.letter) {
+      case C_LR_ID_LETTER:
+        return putRecordId(dest, dest_size, (int)ctx->logRecordIdCounter);
+
+      case C_LR_TIME_STAMP_LETTER:
+        return putHex64(dest, dest_size, logRecord->logTimeStamp);
+
+      case C_TIME_MILLISECOND_LETTER:
+        return putMillisecond(dest, dest_size, logRecord->logTimeStamp);
+
+      case C_NOTIFICATION_CLASS_ID_LETTER:
+        if (logRecord->logHdrType == SA_LOG_GENERIC_HEADER) {
+          characters = snprintf(dest, dest_size,
+                                "NCI[0x%#08x,0x%#04x,0x%#04x]",
+                                (unsigned int)logRecord->logHeader.genericHdr.notificationClassId->
+                                vendorId, logRecord->logHeader.genericHdr.notificationClassId->majorId,
+                                logRecord->logHeader.genericHdr.notificationClassId->minorId);
+        } else {
+          characters = snprintf(dest, dest_size,
+                                "NCI[0x%08x,0x%04x,0x%04x]",
+                                (unsigned int)logRecord->logHeader.ntfHdr.notificationClassId->vendorId,
+                                logRecord->logHeader.ntfHdr.notificationClassId->majorId,
+                                logRecord->logHeader.ntfHdr.notificationClassId->minorId);
+        }
+        break;
+
+      case C_LR_TRUNCATION_INFO_LETTER:
+        /* A space inserted at the truncationCharacter:s position */
+        if ((inputPos + 1) == ctx->rec_size)
+          ctx->truncationLetterPos = inputPos - 1;
+        else
+          ctx->truncationLetterPos = inputPos;
+        return putString(dest, dest_size, " ", 1);
+
+      case C_LR_STRING_BODY_LETTER: {
+        const char *body = reinterpret_cast<const char *>(logBuffer->logBuf);
+        if (elem.fieldSize == 0)
+          return putString(dest, dest_size, body, strnlen(body, logBuffer->logBufSize));
+        return putPaddedString(dest, dest_size, body,
+                               strnlen(body, elem.fieldSize), elem.fieldSize, false);
+      }
+
+      case C_LR_HEX_CHAR_BODY_LETTER: {
+        std::string hex_string;
+        hexBody(logBuffer, &hex_string);
+        if (elem.fieldSize == 0)
+          return putString(dest, dest_size, hex_string.c_str(), hex_string.size());
+        return putPaddedString(dest, dest_size, hex_string.c_str(),
+                               hex_string.size(), elem.fieldSize, true);
+      }
+
+      case C_NETWORK_NAME_LETTER: {
+        std::string networkname = lgs_get_networkname();
+        return putString(dest, dest_size, networkname.c_str(), networkname.size());
+      }
+
+      case C_NODE_NAME_LETTER:
+        return putString(dest, dest_size, ctx->node_name, strlen(ctx->node_name));
+
+      default:
+        break;
+    }
+  } else if (elem.fieldType == NOTIFICATION_LOG_RECORD_FIELD_TYPE) {
+    const SaLogNtfLogHeaderT *ntfHdr = &logRecord->logHeader.ntfHdr;
+    SaInt32T fieldSize;
+
+    switch (elem.letter) {
+      case N_NOTIFICATION_ID_LETTER:
+        if (dest_size <= 2)
+          return putString(dest, dest_size, "0x", 2);
+        memcpy(dest, "0x", 2);
+        return 2 + putHex64(dest + 2, dest_size - 2, ntfHdr->notificationId);
+
+      case N_EVENT_TIME_LETTER:
+        return putHex64(dest, dest_size, ntfHdr->eventTime);
+
+      case N_EVENT_TIME_MILLISECOND_LETTER:
+        return putMillisecond(dest, dest_size, ntfHdr->eventTime);
+
+      case N_EVENT_TYPE_LETTER:
+        if (elem.fieldSize == 0) {
+          characters = snprintf(dest, dest_size, "%#x", ntfHdr->eventType);
+        } else {
+          /* 0x included in total field size */
+          fieldSize = (elem.fieldSize > 2) ? (elem.fieldSize - 2) : 2;
+          characters = snprintf(dest, dest_size, "%#.*x", fieldSize, ntfHdr->eventType);
+        }
+        break;
+
+      case N_NOTIFICATION_OBJECT_LETTER:
+        return putName(dest, dest_size,
+                       osaf_extended_name_borrow(ntfHdr->notificationObject), elem.fieldSize);
+
+      case N_NOTIFYING_OBJECT_LETTER:
+        return putName(dest, dest_size,
+                       osaf_extended_name_borrow(ntfHdr->notifyingObject), elem.fieldSize);
+
+      default:
+        break;
+    }
+  } else {
+    static const char *const severities[] = {
+      "EM", "AL", "CR", "ER", "WA", "NO", "IN"
+    };
+    SaLogSeverityT severity;
+
+    switch (elem.letter) {
+      case S_LOGGER_NAME_LETTER:
+        return putName(dest, dest_size,
+                       osaf_extended_name_borrow(logRecord->logHeader.genericHdr.logSvcUsrName),
+                       elem.fieldSize);
+
+      case S_SEVERITY_ID_LETTER:
+        severity = logRecord->logHeader.genericHdr.logSeverity;
+        if (severity <= SA_LOG_SEV_INFO)
+          return putString(dest, dest_size, severities[severity], 2);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if (characters < 0)
+    characters = 0;
+
+  if (characters > static_cast<int>(dest_size))
+    characters = dest_size;
+
+  return characters;
+}
+
+/**
+ * Render the output of a time block into its cache if the second has changed
+ */
+static void renderTimeBlock(lgs_fmt_elem *block, lgs_fmt_ctx_t *ctx) {
+  char fieldType = block->block.front().fieldType;
+  SaTimeT second = fieldTime(ctx, fieldType) / (SaTimeT)SA_TIME_ONE_SECOND;
+  const struct tm *timeData;
+  char buf[32];
+
+  if (block->cacheValid && block->cachedSecond == second)
+    return;
+
+  timeData = fieldTimeData(ctx, fieldType);
+  block->text.clear();
+  for (const auto &elem : block->block) {
+    if (elem.kind == FMT_ELEM_LITERAL) {
+      block->text += elem.text;
     } else {
-      dest[dest_size - 2] = (SaInt8T)'\"';
-      dest[dest_size - 1] = '\n';
-      i = dest_size;
+      int n = formatTimeField(buf, sizeof(buf), elem.fieldType, elem.letter, timeData);
+      block->text.append(buf, n);
     }
   }
+  block->cachedSecond = second;
+  block->cacheValid = true;
+}
 
-  if (truncationLetterPos != -1) {        /* Insert truncation info letter */
-    dest[truncationLetterPos] = truncationCharacter;
+/**
+ * Emit elements to dest starting at position *i
+ *
+ * @return bool true if the log record is truncated
+ */
+static bool emitElements(std::vector<lgs_fmt_elem> *elems, lgs_fmt_ctx_t *ctx,
+                         char *dest, size_t dest_size, size_t *i) {
+  for (auto &elem : *elems) {
+    size_t room = dest_size - *i;
+
+    switch (elem.kind) {
+      case FMT_ELEM_LITERAL:
+        if (elem.text.size() < room) {
+          memcpy(&dest[*i], elem.text.data(), elem.text.size());
+          *i += elem.text.size();
+          break;
+        }
+        memcpy(&dest[*i], elem.text.data(), room);
+        *i = dest_size;
+        /* No truncation if the last character of the expression fits */
+        return !(elem.lastInExpression && elem.text.size() == room);
+
+      case FMT_ELEM_TIME_BLOCK:
+        renderTimeBlock(&elem, ctx);
+        if (elem.text.size() < room) {
+          memcpy(&dest[*i], elem.text.data(), elem.text.size());
+          *i += elem.text.size();
+        } else if (emitElements(&elem.block, ctx, dest, dest_size, i)) {
+          return true;
+        }
+        break;
+
+      case FMT_ELEM_FIELD:
+        *i += formatField(&dest[*i], room, elem, *i, ctx);
+        if (*i >= dest_size)
+          return true;
+        break;
+    }
   }
 
-error_exit:
-  return i;
+  return false;
+}
+
+/**
+ * Compile a format expression. Each stream has its format expression compiled
+ * when the stream is opened and when the format expression is changed.
+ *
+ * @param formatExpression
+ *
+ * @return lgs_compiled_fmt_t* to be freed with lgs_free_compiled_format()
+ */
+lgs_compiled_fmt_t *lgs_compile_format_expression(const char *formatExpression) {
+  lgs_compiled_fmt_t *compiled = new lgs_compiled_fmt_t();
+  std::vector<lgs_fmt_elem> flat;
+  const char *p = formatExpression;
+  size_t k;
+
+  osafassert(formatExpression != NULL);
+  compiled->formatExpression = formatExpression;
+  compiled->compiled = false;
+
+  if (*p == STRING_END_CHARACTER)
+    return compiled;
+
+  /* Split the expression in the same way as lgs_format_log_record() */
+  for (;;) {
+    SaUint16T offset = LITTERAL_CHAR_OFFSET;
+
+    if ((p[0] == TOKEN_START_SYMBOL) && (p[1] != STRING_END_CHARACTER)) {
+      lgs_fmt_elem elem = lgs_fmt_elem();
+      SaUint16T fieldSizeOffset = 0;
+
+      if (p[1] != COMMON_LOG_RECORD_FIELD_TYPE &&
+          p[1] != NOTIFICATION_LOG_RECORD_FIELD_TYPE &&
+          p[1] != SYSTEM_LOG_RECORD_FIELD_TYPE) {
+        TRACE("Invalid token %u", p[1]);
+        return compiled;
+      }
+      if (p[2] == STRING_END_CHARACTER)
+        return compiled;
+
+      elem.kind = FMT_ELEM_FIELD;
+      elem.fieldType = p[1];
+      elem.letter = p[2];
+      offset = DEFAULT_FMT_EXP_PTR_OFFSET;
+      if (fieldHasFieldSize(elem.fieldType, elem.letter)) {
+        elem.fieldSize = checkFieldSize(const_cast<SaStringT>(&p[3]), &fieldSizeOffset);
+        offset += fieldSizeOffset;
+      }
+      flat.push_back(elem);
+    } else {
+      if (flat.empty() || flat.back().kind != FMT_ELEM_LITERAL) {
+        flat.push_back(lgs_fmt_elem());
+        flat.back().kind = FMT_ELEM_LITERAL;
+      }
+      flat.back().text += p[0];
+      if (p[1] == STRING_END_CHARACTER) {
+        flat.back().lastInExpression = true;
+        break;
+      }
+    }
+
+    p += offset;
+    if (*p == STRING_END_CHARACTER)
+      break;
+  }
+
+  /* Group time fields with the same time source into time blocks */
+  for (k = 0; k < flat.size(); k++) {
+    size_t last = k;
+
+    if (!isSecondTimeField(flat[k])) {
+      compiled->elems.push_back(flat[k]);
+      continue;
+    }
+
+    for (size_t j = k + 1; j < flat.size(); j++) {
+      if (isSecondTimeField(flat[j]) && flat[j].fieldType == flat[k].fieldType)
+        last = j;
+      else if (flat[j].kind != FMT_ELEM_LITERAL || flat[j].lastInExpression)
+        break;
+    }
+
+    lgs_fmt_elem block = lgs_fmt_elem();
+    block.kind = FMT_ELEM_TIME_BLOCK;
+    block.block.assign(flat.begin() + k, flat.begin() + last + 1);
+    compiled->elems.push_back(block);
+    k = last;
+  }
+
+  compiled->compiled = true;
+  return compiled;
+}
+
+void lgs_free_compiled_format(lgs_compiled_fmt_t *compiled) {
+  delete compiled;
+}
+
+/**
+ * Format a log record using a compiled format expression. Same output as
+ * lgs_format_log_record() with the format expression.
+ *
+ * @param logRecord
+ * @param compiled compiled format expression
+ * @param fixedLogRecordSize if 0 do not pad
+ * @param dest_size size of dest
+ * @param dest write at most dest_size bytes to dest
+ * @param logRecordIdCounter
+ *
+ * @return int number of bytes written to dest
+ */
+int lgs_format_log_record_compiled(SaLogRecordT *logRecord,
+                                   lgs_compiled_fmt_t *compiled,
+                                   SaUint64T logFileSize,
+                                   SaUint16T fixedLogRecordSize,
+                                   size_t dest_size,
+                                   char *dest,
+                                   SaUint32T logRecordIdCounter,
+                                   char *node_name) {
+  lgs_fmt_ctx_t ctx;
+  SaInt8T truncationCharacter = (SaInt8T)COMPLETED_LOG_RECORD;
+  size_t i = 0;
+
+  if (compiled == NULL)
+    return 0;
+
+  if (compiled->compiled == false) {
+    return lgs_format_log_record(logRecord,
+                                 const_cast<SaStringT>(compiled->formatExpression.c_str()),
+                                 logFileSize, fixedLogRecordSize, dest_size, dest,
+                                 logRecordIdCounter, node_name);
+  }
+
+  ctx.logRecord = logRecord;
+  ctx.logRecordIdCounter = logRecordIdCounter;
+  ctx.node_name = node_name;
+  ctx.rec_size = dest_size;
+  ctx.truncationLetterPos = -1;
+  ctx.timeStampDataValid = false;
+  ctx.eventTimeDataValid = false;
+
+  /* Init output vector with a '\0' */
+  dest[0] = '\0';
+
+  if (emitElements(&compiled->elems, &ctx, dest, dest_size, &i))
+    truncationCharacter = (SaInt8T)TRUNCATED_LOG_RECORD;
+
+  return terminateLogRecord(dest, dest_size, i, logFileSize, fixedLogRecordSize,
+                            ctx.truncationLetterPos, truncationCharacter);
 }
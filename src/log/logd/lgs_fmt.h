@@ -187,4 +187,20 @@ extern int lgs_format_log_record(
     char *node_name
                                  );
 
+/* A format expression compiled for formatting many log records */
+typedef struct lgs_compiled_fmt lgs_compiled_fmt_t;
+
+extern lgs_compiled_fmt_t *lgs_compile_format_expression(const char *);
+extern void lgs_free_compiled_format(lgs_compiled_fmt_t *);
+extern int lgs_format_log_record_compiled(
+    SaLogRecordT *,
+    lgs_compiled_fmt_t *,
+    SaUint64T logFileSize,
+    SaUint16T fixedLogRecordSize,
+    size_t dest_size,
+    char *dest,
+    SaUint32T,
+    char *node_name
+                                          );
+
 #endif  // LOG_LOGD_LGS_FMT_H_
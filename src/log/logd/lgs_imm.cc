@@ -2217,6 +2217,7 @@ static SaAisErrorT stream_create_and_configure1(
     const char* logFileFormat = static_cast<const char *>(lgs_cfg_get(LGS_IMM_LOG_STREAM_FILE_FORMAT));
     (*stream)->logFileFormat = strdup(logFileFormat);
   }
+  log_stream_compile_format(*stream);
 
   /* Update creation timestamp */
   rc = immutil_update_one_rattr(lgs_cb->immOiHandle, objectName.c_str(),
@@ -2303,6 +2304,7 @@ static void stream_ccb_apply_modify(const CcbUtilOperationData_t *opdata) {
       if (stream->logFileFormat != NULL)
         free(stream->logFileFormat);
       stream->logFileFormat = strdup(logFileFormat);
+      log_stream_compile_format(stream);
       new_cfg_file_needed = true;
     } else if (!strcmp(attribute->attrName, "saLogStreamSeverityFilter")) {
       SaUint32T severityFilter = *((SaUint32T *)value);
@@ -2670,6 +2672,7 @@ static SaAisErrorT stream_create_and_configure(const std::string &dn,
       stream->logFileFormat = strdup(log_file_format[stream->streamType]);
     }
   }
+  log_stream_compile_format(stream);
 
 done:
   TRACE_LEAVE2("rc: %s", saf_error(rc));
@@ -39,6 +39,7 @@
 #include "lgs_recov.h"
 #include "osaf/immutil/immutil.h"
 #include "lgs_clm.h"
+#include "lgs_mbcsv_v6.h"
 
 /* ========================================================================
  *   DEFINITIONS
@@ -50,6 +51,7 @@ enum {
   FD_MBCSV,
   FD_MBX,
   FD_CLTIMER,
+  FD_CKPTTIMER,
   FD_CLM,
   FD_IMM,         /* Must be the last in the fds array */
   FD_NUM
@@ -503,6 +505,8 @@ int main(int argc, char *argv[]) {
   fds[FD_AMF].events = POLLIN;
   fds[FD_MBX].fd = mbx_fd.rmv_obj;
   fds[FD_MBX].events = POLLIN;
+  fds[FD_CKPTTIMER].fd = lgs_ckpt_write_hwm_timer_fd();
+  fds[FD_CKPTTIMER].events = POLLIN;
   fds[FD_IMM].fd = lgs_cb->immSelectionObject;
   fds[FD_IMM].events = POLLIN;
 
@@ -547,6 +551,9 @@ int main(int argc, char *argv[]) {
     }
 
     if (fds[FD_TERM].revents & POLLIN) {
+      /* Write log records still queued for the file thread */
+      (void) log_file_flush();
+      lgs_ckpt_write_hwm_flush(lgs_cb);
       daemon_exit();
     }
 
@@ -611,6 +618,11 @@ int main(int argc, char *argv[]) {
       log_rtobj_list_free();
     }
 
+    if (fds[FD_CKPTTIMER].revents & POLLIN) {
+      /* Check-point log writes not yet check-pointed */
+      lgs_ckpt_write_hwm_flush(lgs_cb);
+    }
+
     if (fds[FD_MBX].revents & POLLIN)
       lgs_process_mbx(&lgs_mbx);
 
@@ -20,6 +20,7 @@
 #include "base/ncssysf_mem.h"
 #include "base/osaf_time.h"
 
+#include "lgs_mbcsv_v6.h"
 #include "lgs_mbcsv_v5.h"
 #include "lgs_mbcsv_v3.h"
 #include "lgs_mbcsv_v2.h"
@@ -97,7 +98,8 @@ static LGS_CKPT_HDLR ckpt_data_handler[] = {
   ckpt_proc_cfg_stream,
   ckpt_proc_lgs_cfg_v2,
   ckpt_proc_lgs_cfg_v3,
-  ckpt_proc_lgs_cfg_v5
+  ckpt_proc_lgs_cfg_v5,
+  ckpt_proc_write_hwm_v6
 };
 
 /****************************************************************************
@@ -239,6 +241,8 @@ uint32_t lgs_mbcsv_init(lgs_cb_t *cb, SaAmfHAStateT ha_state) {
     goto done;
   }
 
+  lgs_ckpt_write_hwm_init();
+
   rc = lgs_mbcsv_change_HA_state(cb, ha_state);
 
 done:
@@ -265,6 +269,11 @@ uint32_t lgs_mbcsv_change_HA_state(lgs_cb_t *cb, SaAmfHAStateT ha_state) {
   TRACE_ENTER();
   NCS_MBCSV_ARG mbcsv_arg;
 
+  /* Send high-water marks not yet check-pointed while still active */
+  if (ha_state != SA_AMF_HA_ACTIVE) {
+    lgs_ckpt_write_hwm_flush(cb);
+  }
+
   memset(&mbcsv_arg, '\0', sizeof(NCS_MBCSV_ARG));
 
   /* Set the mbcsv args */
@@ -301,6 +310,11 @@ uint32_t lgs_mbcsv_change_HA_state(lgs_cb_t *cb, SaAmfHAStateT ha_state) {
         *stream->p_fd = -1; /* Reopen files */
       }
     }
+  } else if (ha_state == SA_AMF_HA_ACTIVE) {
+    /* Log writes may have been check-pointed as high-water marks. The
+     * previous active may have written more records than check-pointed.
+     */
+    lgs_ckpt_write_hwm_resync();
   }
 
   TRACE_LEAVE();
@@ -359,6 +373,18 @@ bool lgs_is_peer_v5() {
   }
 }
 
+/**
+ * Check if peer is version 6 (or later)
+ * @return bool
+ */
+bool lgs_is_peer_v6() {
+  if (lgs_cb->mbcsv_peer_version >= LGS_MBCSV_VERSION_6) {
+    return true;
+  } else {
+    return false;
+  }
+}
+
 /**
  * Check if configured for split file system.
  * If other node is version 1 split file system mode is not applicable.
@@ -750,6 +776,7 @@ static uint32_t edu_enc_reg_list(lgs_cb_t *cb, NCS_UBAID *uba) {
  ****************************************************************************/
 
 static uint32_t ckpt_encode_async_update(lgs_cb_t *lgs_cb, EDU_HDL edu_hdl, NCS_MBCSV_CB_ARG *cbk_arg) {
+  lgsv_ckpt_msg_v6_t *data_v6 = NULL;
   lgsv_ckpt_msg_v5_t *data_v5 = NULL;
   lgsv_ckpt_msg_v3_t *data_v3 = NULL;
   lgsv_ckpt_msg_v2_t *data_v2 = NULL;
@@ -761,7 +788,12 @@ static uint32_t ckpt_encode_async_update(lgs_cb_t *lgs_cb, EDU_HDL edu_hdl, NCS_
 
   TRACE_ENTER();
   /* Set reo_hdl from callback arg to ckpt_rec */
-  if (lgs_is_peer_v5()) {
+  if (lgs_is_peer_v6()) {
+    data_v6 = reinterpret_cast<lgsv_ckpt_msg_v6_t *>(
+        static_cast<long>(cbk_arg->info.encode.io_reo_hdl));
+    vdata = data_v6;
+    edp_function = edp_ed_ckpt_msg_v6;
+  } else if (lgs_is_peer_v5()) {
     data_v5 = reinterpret_cast<lgsv_ckpt_msg_v5_t *>(
         static_cast<long>(cbk_arg->info.encode.io_reo_hdl));
     vdata = data_v5;
@@ -1111,6 +1143,8 @@ static uint32_t ckpt_decode_async_update(lgs_cb_t *cb, NCS_MBCSV_CB_ARG *cbk_arg
   lgsv_ckpt_msg_v3_t *ckpt_msg_v3 = &msg_v3;
   lgsv_ckpt_msg_v5_t msg_v5;
   lgsv_ckpt_msg_v5_t *ckpt_msg_v5 = &msg_v5;
+  lgsv_ckpt_msg_v6_t msg_v6;
+  lgsv_ckpt_msg_v6_t *ckpt_msg_v6 = &msg_v6;
   void *ckpt_msg;
   lgsv_ckpt_header_t hdr, *hdr_ptr = &hdr;
 
@@ -1130,7 +1164,10 @@ static uint32_t ckpt_decode_async_update(lgs_cb_t *cb, NCS_MBCSV_CB_ARG *cbk_arg
 
   TRACE_2("\tckpt_rec_type: %d ", (int)hdr_ptr->ckpt_rec_type);
 
-  if (lgs_is_peer_v5()) {
+  if (lgs_is_peer_v6()) {
+    ckpt_msg_v6->header = hdr;
+    ckpt_msg = ckpt_msg_v6;
+  } else if (lgs_is_peer_v5()) {
     ckpt_msg_v5->header = hdr;
     ckpt_msg = ckpt_msg_v5;
   } else if (lgs_is_peer_v4()) {
@@ -1148,7 +1185,9 @@ static uint32_t ckpt_decode_async_update(lgs_cb_t *cb, NCS_MBCSV_CB_ARG *cbk_arg
   switch (hdr_ptr->ckpt_rec_type) {
     case LGS_CKPT_CLIENT_INITIALIZE:
       TRACE_2("\tINITIALIZE REC: UPDATE");
-      if (lgs_is_peer_v5()) {
+      if (lgs_is_peer_v6()) {
+        reg_rec = &ckpt_msg_v6->ckpt_rec.initialize_client;
+      } else if (lgs_is_peer_v5()) {
         reg_rec = &ckpt_msg_v5->ckpt_rec.initialize_client;
       } else if (lgs_is_peer_v4()) {
         reg_rec = &ckpt_msg_v3->ckpt_rec.initialize_client;
@@ -1173,7 +1212,9 @@ static uint32_t ckpt_decode_async_update(lgs_cb_t *cb, NCS_MBCSV_CB_ARG *cbk_arg
 
     case LGS_CKPT_OPEN_STREAM: /* 4 */
       TRACE_2("\tSTREAM OPEN: UPDATE");
-      if (lgs_is_peer_v5()) {
+      if (lgs_is_peer_v6()) {
+        stream_open = &ckpt_msg_v6->ckpt_rec.stream_open;
+      } else if (lgs_is_peer_v5()) {
         stream_open = &ckpt_msg_v5->ckpt_rec.stream_open;
       } else if (lgs_is_peer_v4()) {
         stream_open = &ckpt_msg_v3->ckpt_rec.stream_open;
@@ -1228,6 +1269,15 @@ static uint32_t ckpt_decode_async_update(lgs_cb_t *cb, NCS_MBCSV_CB_ARG *cbk_arg
         goto done;
       }
       break;
+    case LGS_CKPT_LOG_WRITE_HWM:
+      TRACE_2("\tWRITE HWM REC: UPDATE");
+      rc = ckpt_decode_log_struct(cb, cbk_arg, ckpt_msg,
+                                  &ckpt_msg_v6->ckpt_rec.write_hwm,
+                                  edp_ed_write_hwm_v6);
+      if (rc != NCSCC_RC_SUCCESS) {
+        goto done;
+      }
+      break;
     default:
       rc = NCSCC_RC_FAILURE;
       TRACE("\tFAILED Unknown ckpt record type");
@@ -1417,13 +1467,17 @@ static uint32_t process_ckpt_data(lgs_cb_t *cb, void *data) {
   lgsv_ckpt_msg_v2_t *data_v2;
   lgsv_ckpt_msg_v3_t *data_v3;
   lgsv_ckpt_msg_v5_t *data_v5;
+  lgsv_ckpt_msg_v6_t *data_v6;
 
   if ((!cb) || (data == NULL)) {
     TRACE("%s - FAILED: (!cb) || (data == NULL)", __FUNCTION__);
     return (rc = NCSCC_RC_FAILURE);
   }
 
-  if (lgs_is_peer_v5()) {
+  if (lgs_is_peer_v6()) {
+    data_v6 = static_cast<lgsv_ckpt_msg_v6_t *>(data);
+    lgsv_ckpt_msg_type = data_v6->header.ckpt_rec_type;
+  } else if (lgs_is_peer_v5()) {
     data_v5 = static_cast<lgsv_ckpt_msg_v5_t *>(data);
     lgsv_ckpt_msg_type = data_v5->header.ckpt_rec_type;
   } else if (lgs_is_peer_v4()) {
@@ -1588,7 +1642,7 @@ static void insert_localmsg_in_stream(log_stream_t *stream, char *message) {
   }
 
   /* Format the log record */
-  if ((n = lgs_format_log_record(&log_record, stream->logFileFormat, stream->maxLogFileSize,
+  if ((n = lgs_format_log_record_compiled(&log_record, stream->logFileFormatCompiled, stream->maxLogFileSize,
                                  stream->fixedLogRecordSize, buf_size, logOutputString,
                                  LOG_REC_ID, host_name)) == 0) {
     LOG_ER("%s - Could not format internal log record",__FUNCTION__);
@@ -1600,50 +1654,14 @@ static void insert_localmsg_in_stream(log_stream_t *stream, char *message) {
   while ((rc == -2) && (msecs_waited < max_waiting_time_ms)) {
     usleep(sleep_delay_ms * 1000);
     msecs_waited += sleep_delay_ms;
-
-    /*
-      In time-out case, file handler thread frees the log record memory.
-      Therefore, need to re-allocate memory & retry writing log.
-    */
-    if (logOutputString == NULL) {
-      logOutputString = static_cast<char *>(calloc(1, buf_size + 1)); /* Make room for a '\0' termination */
-      if (logOutputString == NULL) {
-        LOG_ER("%s - Could not allocate %d bytes",__FUNCTION__, stream->fixedLogRecordSize + 1);
-      }
-
-      /* Format the log record */
-      if ((n = lgs_format_log_record(
-              &log_record,
-              stream->logFileFormat,
-              stream->maxLogFileSize,
-              stream->fixedLogRecordSize,
-              buf_size,
-              logOutputString,
-              LOG_REC_ID, host_name)) == 0) {
-        LOG_ER("%s - Could not format internal log record", __FUNCTION__);
-      }
-    }
-
     rc = log_stream_write_h(stream, logOutputString, n);
   }
   if (rc != 0) {
     TRACE("Error %d when writing log record",rc);
   }
-  /*
-    Since the logOutputString is referred by the log handler thread, in timeout case,
-    the log API thread might be still using the log record memory.
-
-    To make sure there is no corruption of memory usage in case of time-out (rc = -2),
-    We leave the log record memory freed to the log handler thread..
-
-    It is never a good idea to allocate and free memory in different places.
-    But consider it as a trade-off to have a better performance of LOGsv
-    as time-out occurs very rarely.
 
-    Other cases, the allocator frees it.
-  */
 done:
-  if ((rc != -2) && (logOutputString != NULL)) {
+  if (logOutputString != NULL) {
     free(logOutputString);
     logOutputString = NULL;
   }
@@ -1730,20 +1748,7 @@ static uint32_t ckpt_proc_log_write(lgs_cb_t *cb, void *data) {
   } /* END lgs_is_split_file_system */
 
 done:
-  /*
-    Since the logRecord is referred by the log handler thread, in time-out case,
-    the log API thread might be still using the log record memory.
-
-    To make sure there is no corruption of memory usage in case of time-out (rc = -2),
-    We leave the log record memory freed to the log handler thread..
-
-    It is never a good idea to allocate and free memory in different places.
-    But consider it as a trade-off to have a better performance of LOGsv
-    as time-out occurs very rarely.
-
-    Other cases, the allocator frees it.
-  */
-  if ((rc != -2) && (logRecord != NULL)) {
+  if (logRecord != NULL) {
     lgs_free_edu_mem(logRecord);
     logRecord = NULL;
   }
@@ -2117,6 +2122,7 @@ static uint32_t ckpt_proc_cfg_stream(lgs_cb_t *cb, void *data) {
   }
 
   strcpy(stream->logFileFormat, logFileFormat);
+  log_stream_compile_format(stream);
   stream->severityFilter = severityFilter;
   stream->logFileCurrent = logFileCurrent;
 
@@ -2176,7 +2182,10 @@ uint32_t lgs_ckpt_send_async(lgs_cb_t *cb, void *ckpt_rec, uint32_t action) {
   NCS_MBCSV_ARG mbcsv_arg;
   lgsv_ckpt_msg_type_t ckpt_rec_type;
 
-  if (lgs_is_peer_v5()) {
+  if (lgs_is_peer_v6()) {
+    lgsv_ckpt_msg_v6_t *ckpt_rec_v6 = static_cast<lgsv_ckpt_msg_v6_t *>(ckpt_rec);
+    ckpt_rec_type = ckpt_rec_v6->header.ckpt_rec_type;
+  } else if (lgs_is_peer_v5()) {
     lgsv_ckpt_msg_v5_t *ckpt_rec_v5 = static_cast<lgsv_ckpt_msg_v5_t *>(ckpt_rec);
     ckpt_rec_type = ckpt_rec_v5->header.ckpt_rec_type;
   } else if (lgs_is_peer_v4()) {
@@ -2190,6 +2199,13 @@ uint32_t lgs_ckpt_send_async(lgs_cb_t *cb, void *ckpt_rec, uint32_t action) {
     ckpt_rec_type = ckpt_rec_v1->header.ckpt_rec_type;
   }
 
+  /* Log writes not yet check-pointed must reach the standby before any
+   * other check-point, e.g. before the stream is closed
+   */
+  if (ckpt_rec_type != LGS_CKPT_LOG_WRITE_HWM) {
+    lgs_ckpt_write_hwm_flush(cb);
+  }
+
   /* Fill mbcsv specific data */
   memset(&mbcsv_arg, '\0', sizeof(NCS_MBCSV_ARG));
   mbcsv_arg.i_op = NCS_MBCSV_OP_SEND_CKPT;
@@ -2465,7 +2481,8 @@ int32_t ckpt_msg_test_type(NCSCONTEXT arg) {
     LCL_TEST_JUMP_OFFSET_LGS_CKPT_CLOSE_STREAM,
     LCL_TEST_JUMP_OFFSET_LGS_CKPT_AGENT_DOWN,
     LCL_TEST_JUMP_OFFSET_LGS_CKPT_CFG_STREAM,
-    LCL_TEST_JUMP_OFFSET_LGS_CKPT_LGS_CFG
+    LCL_TEST_JUMP_OFFSET_LGS_CKPT_LGS_CFG,
+    LCL_TEST_JUMP_OFFSET_LGS_CKPT_WRITE_HWM
   };
   lgsv_ckpt_msg_type_t ckpt_rec_type;
 
@@ -2492,6 +2509,8 @@ int32_t ckpt_msg_test_type(NCSCONTEXT arg) {
     case LGS_CKPT_LGS_CFG_V3:
     case LGS_CKPT_LGS_CFG_V5:
       return LCL_TEST_JUMP_OFFSET_LGS_CKPT_LGS_CFG;
+    case LGS_CKPT_LOG_WRITE_HWM:
+      return LCL_TEST_JUMP_OFFSET_LGS_CKPT_WRITE_HWM;
     default:
       return EDU_EXIT;
       break;
@@ -33,14 +33,19 @@
  *            supported on both nodes. For the moment check-pointing is not
  *            changed from version 2. Instead the configuration object is always
  *            read when changing from standby to active.
+ * Version 6: Log writes can be check-pointed as per stream high-water marks
+ *            (last record id, file size and current file) sent in batches
+ *            instead of one check-point per log record. Only used if not
+ *            configured for split file system.
  */
 #define LGS_MBCSV_VERSION_1 1
 #define LGS_MBCSV_VERSION_2 2
 #define LGS_MBCSV_VERSION_4 4
 #define LGS_MBCSV_VERSION_5 5
+#define LGS_MBCSV_VERSION_6 6
 
 /* Current version */
-#define LGS_MBCSV_VERSION 5
+#define LGS_MBCSV_VERSION 6
 #define LGS_MBCSV_VERSION_MIN 1
 
 /* Checkpoint message types(Used as 'reotype' w.r.t mbcsv)  */
@@ -61,6 +66,7 @@ typedef enum {
   LGS_CKPT_LGS_CFG = 7,
   LGS_CKPT_LGS_CFG_V3 = 8,
   LGS_CKPT_LGS_CFG_V5 = 9,
+  LGS_CKPT_LOG_WRITE_HWM = 10,
   LGS_CKPT_MSG_MAX
 } lgsv_ckpt_msg_type_t;
 
@@ -106,6 +112,7 @@ bool lgs_is_peer_v2();
 bool lgs_is_peer_v3();
 bool lgs_is_peer_v4();
 bool lgs_is_peer_v5();
+bool lgs_is_peer_v6();
 bool lgs_is_split_file_system();
 uint32_t lgs_mbcsv_dispatch(NCS_MBCSV_HDL mbcsv_hdl);
 void lgs_free_edu_mem(char *ptr);
@@ -0,0 +1,500 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ * File:   lgs_mbcsv_v6.c
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*
+ * V6 applies to coalesced check-pointing of log writes. Instead of one
+ * check-point per written log record the active sends the write high-water
+ * mark (last record id, file size and current file) of each stream written
+ * since the previous check-point. A check-point is sent when
+ * LOGSV_CKPT_WRITE_BATCH records have been written or when
+ * LOGSV_CKPT_WRITE_INTERVAL milliseconds have passed since the first
+ * record not yet check-pointed, whichever comes first.
+ *
+ * Coalescing is only done if the peer is version 6 and the log files are on
+ * a shared file system. With a split file system the standby writes the log
+ * records itself and every record must be check-pointed.
+ */
+
+#include "lgs_mbcsv_v6.h"
+
+#include <stdlib.h>
+#include <vector>
+#include "base/osaf_timerfd.h"
+#include "lgs_recov.h"
+
+/* Default interval in ms if LOGSV_CKPT_WRITE_INTERVAL is not set */
+static const uint32_t kHwmDefaultIntervalMs = 100;
+
+/* Number of written records that triggers a check-point. Values <= 1 means
+ * that coalescing is disabled and every record is check-pointed.
+ */
+static uint32_t hwm_batch = 1;
+static uint32_t hwm_interval_ms = kHwmDefaultIntervalMs;
+
+/* Ids of streams written since the previous check-point */
+static std::vector<uint32_t> hwm_pending;
+static uint32_t hwm_records = 0;
+
+static int hwm_timer_fd = -1;
+static bool hwm_timer_armed = false;
+
+/**
+ * Read a positive number from an environment variable
+ *
+ * @param name[in]   Name of the environment variable
+ * @param value[out] Not changed if the variable is not set or not valid
+ */
+static void hwm_getenv(const char *name, uint32_t *value) {
+  const char *val_str = getenv(name);
+  char *endptr;
+
+  if (val_str == NULL)
+    return;
+
+  errno = 0;
+  unsigned long val = strtoul(val_str, &endptr, 0);
+  if ((errno != 0) || (endptr == val_str) || (*endptr != '\0') ||
+      (val > UINT32_MAX)) {
+    LOG_WA("Invalid value %s=\"%s\" is ignored", name, val_str);
+    return;
+  }
+
+  *value = static_cast<uint32_t>(val);
+}
+
+static void hwm_timer_set(uint32_t timeout_ms) {
+  struct itimerspec timeout;
+
+  timeout.it_interval.tv_sec = 0;
+  timeout.it_interval.tv_nsec = 0;
+  timeout.it_value.tv_sec = timeout_ms / 1000;
+  timeout.it_value.tv_nsec = (timeout_ms % 1000) * 1000000;
+
+  osaf_timerfd_settime(hwm_timer_fd, 0, &timeout, NULL);
+  hwm_timer_armed = (timeout_ms != 0);
+}
+
+/**
+ * Read the coalescing configuration and create the check-point timer.
+ * Must be called once before any of the other lgs_ckpt_write_hwm_ functions
+ */
+void lgs_ckpt_write_hwm_init() {
+  TRACE_ENTER();
+
+  hwm_getenv("LOGSV_CKPT_WRITE_BATCH", &hwm_batch);
+  hwm_getenv("LOGSV_CKPT_WRITE_INTERVAL", &hwm_interval_ms);
+  if (hwm_interval_ms == 0)
+    hwm_interval_ms = kHwmDefaultIntervalMs;
+
+  hwm_timer_fd = osaf_timerfd_create(CLOCK_MONOTONIC, 0);
+
+  if (hwm_batch > 1) {
+    LOG_NO("Log write check-points coalesced: batch = %u, interval = %u ms",
+           hwm_batch, hwm_interval_ms);
+    hwm_pending.reserve(64);
+  }
+
+  TRACE_LEAVE();
+}
+
+/**
+ * @return The check-point timer file descriptor to poll for expiry
+ */
+int lgs_ckpt_write_hwm_timer_fd() {
+  return hwm_timer_fd;
+}
+
+/**
+ * Check if log writes shall be check-pointed as high-water marks
+ * @return bool
+ */
+bool lgs_ckpt_write_hwm_enabled() {
+  return (hwm_batch > 1) && lgs_is_peer_v6() &&
+      (lgs_is_split_file_system() == false);
+}
+
+/**
+ * Register that a log record has been written to a stream. The stream high-
+ * water mark is check-pointed when the batch is full, when the check-point
+ * timer expires or before any other check-point is sent.
+ *
+ * @param cb[in]
+ * @param stream[in]   The stream written to
+ * @param new_file[in] A new current log file was created when writing
+ */
+void lgs_ckpt_write_hwm_mark(lgs_cb_t *cb, log_stream_t *stream,
+                             bool new_file) {
+  if (stream->ckpt_hwm_pending == false) {
+    stream->ckpt_hwm_pending = true;
+    hwm_pending.push_back(stream->streamId);
+  }
+
+  /* The standby must know the name of the current log file */
+  if ((new_file == true) || (++hwm_records >= hwm_batch)) {
+    lgs_ckpt_write_hwm_flush(cb);
+    return;
+  }
+
+  if (hwm_timer_armed == false)
+    hwm_timer_set(hwm_interval_ms);
+}
+
+/**
+ * Check-point the high-water marks of all streams written since the previous
+ * check-point. Does nothing if there is nothing to check-point.
+ *
+ * @param cb[in]
+ */
+void lgs_ckpt_write_hwm_flush(lgs_cb_t *cb) {
+  std::vector<lgs_ckpt_write_hwm_rec_v6_t> recs;
+  lgsv_ckpt_msg_v6_t ckpt_v6;
+  log_stream_t *stream;
+
+  if (hwm_timer_armed == true)
+    hwm_timer_set(0);
+
+  if (hwm_pending.empty())
+    return;
+
+  TRACE_ENTER2("%zu streams, %u records", hwm_pending.size(), hwm_records);
+
+  recs.reserve(hwm_pending.size());
+  for (uint32_t streamId : hwm_pending) {
+    /* The stream may have been closed after it was written to */
+    stream = log_stream_get_by_id(streamId);
+    if ((stream == NULL) || (stream->ckpt_hwm_pending == false))
+      continue;
+
+    stream->ckpt_hwm_pending = false;
+
+    lgs_ckpt_write_hwm_rec_v6_t rec;
+    rec.streamId = stream->streamId;
+    rec.recordId = stream->logRecordId;
+    rec.curFileSize = stream->curFileSize;
+    rec.logFileCurrent = const_cast<char *>(stream->logFileCurrent.c_str());
+    rec.c_file_close_time_stamp = stream->act_last_close_timestamp;
+    recs.push_back(rec);
+  }
+  hwm_pending.clear();
+  hwm_records = 0;
+
+  /* If the peer has left or changed version it will be cold synced */
+  if (recs.empty() || (lgs_is_peer_v6() == false)) {
+    TRACE_LEAVE();
+    return;
+  }
+
+  memset(&ckpt_v6, 0, sizeof(ckpt_v6));
+  ckpt_v6.header.ckpt_rec_type = LGS_CKPT_LOG_WRITE_HWM;
+  ckpt_v6.header.num_ckpt_records = 1;
+  ckpt_v6.header.data_len = 1;
+  ckpt_v6.ckpt_rec.write_hwm.num_streams = recs.size();
+  ckpt_v6.ckpt_rec.write_hwm.streams = recs.data();
+
+  (void) lgs_ckpt_send_async(cb, &ckpt_v6, NCS_MBCSV_ACT_ADD);
+
+  TRACE_LEAVE();
+}
+
+/**
+ * Called when becoming active. The check-pointed high-water marks may be
+ * behind what the previous active wrote before it went down. Get current
+ * file, file size and last record id from the log files for every stream
+ * that has been updated by a high-water mark check-point.
+ */
+void lgs_ckpt_write_hwm_resync() {
+  log_stream_t *stream;
+  SaBoolT endloop = SA_FALSE, jstart = SA_TRUE;
+
+  TRACE_ENTER();
+
+  while ((stream = iterate_all_streams(endloop, jstart)) && !endloop) {
+    jstart = SA_FALSE;
+    if (stream->ckpt_hwm_pending == false)
+      continue;
+
+    stream->ckpt_hwm_pending = false;
+    if (log_stream_file_params_sync(stream) == -1) {
+      LOG_NO("Could not get file parameters for stream %s",
+             stream->name.c_str());
+    }
+  }
+
+  TRACE_LEAVE();
+}
+
+/****************************************************************************
+ * Name          : ckpt_proc_write_hwm_v6
+ *
+ * Description   : This function updates the write high-water marks of
+ *                 streams on standby node
+ *
+ * Arguments     : cb - pointer to LGS  ControlBlock.
+ *                 data - pointer to  LGS_CHECKPOINT_DATA.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : The stream is marked so that its file parameters are read
+ *                 from the log file if this node becomes active.
+ *
+ ****************************************************************************/
+
+uint32_t ckpt_proc_write_hwm_v6(lgs_cb_t *cb, void *data) {
+  log_stream_t *stream;
+
+  TRACE_ENTER();
+
+  if (!lgs_is_peer_v6()) {
+    /* Should never enter here */
+    LOG_ER("%s: Called when peer is not version 6. "
+           "We should never enter here",__FUNCTION__);
+    osafassert(0);
+  }
+
+  lgsv_ckpt_msg_v6_t *data_v6 = static_cast<lgsv_ckpt_msg_v6_t *>(data);
+  lgs_ckpt_write_hwm_v6_t *param = &data_v6->ckpt_rec.write_hwm;
+
+  for (uint32_t i = 0; i < param->num_streams; i++) {
+    lgs_ckpt_write_hwm_rec_v6_t *rec = &param->streams[i];
+
+    stream = log_stream_get_by_id(rec->streamId);
+    if (stream == NULL) {
+      TRACE("Could not lookup stream: %u", rec->streamId);
+    } else {
+      stream->logRecordId = rec->recordId;
+      stream->curFileSize = rec->curFileSize;
+      stream->logFileCurrent = rec->logFileCurrent;
+      stream->act_last_close_timestamp = rec->c_file_close_time_stamp;
+      stream->ckpt_hwm_pending = true;
+    }
+
+    lgs_free_edu_mem(rec->logFileCurrent);
+  }
+
+  /* Allocated by the EDU decoder */
+  free(param->streams);
+
+  TRACE_LEAVE();
+  return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : edp_ed_write_hwm_rec_v6
+ *
+ * Description   : This function is an EDU program for encoding/decoding
+ *                 the write high-water mark of one stream.
+ *
+ * Arguments     : EDU_HDL - pointer to edu handle,
+ *                 EDU_TKN - internal edu token to help encode/decode,
+ *                 POINTER to the structure to encode/decode from/to,
+ *                 data length specifying number of structures,
+ *                 EDU_BUF_ENV - pointer to buffer for encoding/decoding.
+ *                 op - operation type being encode/decode.
+ *                 EDU_ERR - out param to indicate errors in processing.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : None.
+ *****************************************************************************/
+
+uint32_t edp_ed_write_hwm_rec_v6(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
+                                 NCSCONTEXT ptr, uint32_t *ptr_data_len,
+                                 EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err) {
+  uint32_t rc = NCSCC_RC_SUCCESS;
+  lgs_ckpt_write_hwm_rec_v6_t *ckpt_hwm_rec_ptr = NULL, **ckpt_hwm_rec_dec_ptr;
+
+  EDU_INST_SET ckpt_hwm_rec_ed_rules[] = {
+    {EDU_START, edp_ed_write_hwm_rec_v6, 0, 0, 0, sizeof(lgs_ckpt_write_hwm_rec_v6_t), 0, NULL},
+    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((lgs_ckpt_write_hwm_rec_v6_t *)0)->streamId, 0, NULL},
+    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((lgs_ckpt_write_hwm_rec_v6_t *)0)->recordId, 0, NULL},
+    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((lgs_ckpt_write_hwm_rec_v6_t *)0)->curFileSize, 0, NULL},
+    {EDU_EXEC, ncs_edp_string, 0, 0, 0, (long)&((lgs_ckpt_write_hwm_rec_v6_t *)0)->logFileCurrent, 0, NULL},
+    {EDU_EXEC, ncs_edp_uns64, 0, 0, 0,
+     (long)&((lgs_ckpt_write_hwm_rec_v6_t *)0)->c_file_close_time_stamp, 0, NULL},
+    {EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+  };
+
+  if (op == EDP_OP_TYPE_ENC) {
+    ckpt_hwm_rec_ptr = static_cast<lgs_ckpt_write_hwm_rec_v6_t *>(ptr);
+  } else if (op == EDP_OP_TYPE_DEC) {
+    ckpt_hwm_rec_dec_ptr = static_cast<lgs_ckpt_write_hwm_rec_v6_t **>(ptr);
+    if (*ckpt_hwm_rec_dec_ptr == NULL) {
+      *o_err = EDU_ERR_MEM_FAIL;
+      return NCSCC_RC_FAILURE;
+    }
+    memset(*ckpt_hwm_rec_dec_ptr, '\0', sizeof(lgs_ckpt_write_hwm_rec_v6_t));
+    ckpt_hwm_rec_ptr = *ckpt_hwm_rec_dec_ptr;
+  } else {
+    ckpt_hwm_rec_ptr = static_cast<lgs_ckpt_write_hwm_rec_v6_t *>(ptr);
+  }
+
+  rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, ckpt_hwm_rec_ed_rules, ckpt_hwm_rec_ptr,
+                           ptr_data_len, buf_env, op, o_err);
+  return rc;
+}
+
+/****************************************************************************
+ * Name          : edp_ed_write_hwm_v6
+ *
+ * Description   : This function is an EDU program for encoding/decoding
+ *                 lgsv checkpoint write high-water marks. The high-water
+ *                 marks are a variable length array of per stream records.
+ *
+ * Arguments     : EDU_HDL - pointer to edu handle,
+ *                 EDU_TKN - internal edu token to help encode/decode,
+ *                 POINTER to the structure to encode/decode from/to,
+ *                 data length specifying number of structures,
+ *                 EDU_BUF_ENV - pointer to buffer for encoding/decoding.
+ *                 op - operation type being encode/decode.
+ *                 EDU_ERR - out param to indicate errors in processing.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : None.
+ *****************************************************************************/
+
+uint32_t edp_ed_write_hwm_v6(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
+                             NCSCONTEXT ptr, uint32_t *ptr_data_len,
+                             EDU_BUF_ENV *buf_env, EDP_OP_TYPE op, EDU_ERR *o_err) {
+  uint32_t rc = NCSCC_RC_SUCCESS;
+  lgs_ckpt_write_hwm_v6_t *ckpt_hwm_msg_ptr = NULL, **ckpt_hwm_msg_dec_ptr;
+
+  EDU_INST_SET ckpt_hwm_ed_rules[] = {
+    {EDU_START, edp_ed_write_hwm_v6, 0, 0, 0, sizeof(lgs_ckpt_write_hwm_v6_t), 0, NULL},
+    {EDU_EXEC, ncs_edp_uns32, 0, 0, 0, (long)&((lgs_ckpt_write_hwm_v6_t *)0)->num_streams, 0, NULL},
+    {EDU_EXEC, edp_ed_write_hwm_rec_v6, EDQ_VAR_LEN_DATA, ncs_edp_uns32, 0,
+     (long)&((lgs_ckpt_write_hwm_v6_t *)0)->streams,
+     (long)&((lgs_ckpt_write_hwm_v6_t *)0)->num_streams, NULL},
+    {EDU_EXEC_EXT, NULL, NCS_SERVICE_ID_LGS /* Svc-ID */ , NULL, 0, 0 /* Sub-ID */ , 0, NULL},
+    {EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+  };
+
+  if (op == EDP_OP_TYPE_ENC) {
+    ckpt_hwm_msg_ptr = static_cast<lgs_ckpt_write_hwm_v6_t *>(ptr);
+  } else if (op == EDP_OP_TYPE_DEC) {
+    ckpt_hwm_msg_dec_ptr = static_cast<lgs_ckpt_write_hwm_v6_t **>(ptr);
+    if (*ckpt_hwm_msg_dec_ptr == NULL) {
+      *o_err = EDU_ERR_MEM_FAIL;
+      return NCSCC_RC_FAILURE;
+    }
+    memset(*ckpt_hwm_msg_dec_ptr, '\0', sizeof(lgs_ckpt_write_hwm_v6_t));
+    ckpt_hwm_msg_ptr = *ckpt_hwm_msg_dec_ptr;
+  } else {
+    ckpt_hwm_msg_ptr = static_cast<lgs_ckpt_write_hwm_v6_t *>(ptr);
+  }
+
+  rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, ckpt_hwm_ed_rules, ckpt_hwm_msg_ptr,
+                           ptr_data_len, buf_env, op, o_err);
+  return rc;
+}
+
+/****************************************************************************
+ * Name          : edp_ed_ckpt_msg_v6
+ *
+ * Description   : This function is an EDU program for encoding/decoding
+ *                 lgsv checkpoint messages. This program runs the
+ *                 edp_ed_hdr_rec program first to decide the
+ *                 checkpoint message type based on which it will call the
+ *                 appropriate EDU programs for the different checkpoint
+ *                 messages.
+ *
+ * Arguments     : EDU_HDL - pointer to edu handle,
+ *                 EDU_TKN - internal edu token to help encode/decode,
+ *                 POINTER to the structure to encode/decode from/to,
+ *                 data length specifying number of structures,
+ *                 EDU_BUF_ENV - pointer to buffer for encoding/decoding.
+ *                 op - operation type being encode/decode.
+ *                 EDU_ERR - out param to indicate errors in processing.
+ *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ *
+ * Notes         : None.
+ *****************************************************************************/
+
+uint32_t edp_ed_ckpt_msg_v6(EDU_HDL *edu_hdl, EDU_TKN *edu_tkn,
+                            NCSCONTEXT ptr, uint32_t *ptr_data_len, EDU_BUF_ENV *buf_env,
+                            EDP_OP_TYPE op, EDU_ERR *o_err) {
+  uint32_t rc = NCSCC_RC_SUCCESS;
+  lgsv_ckpt_msg_v6_t *ckpt_msg_ptr = NULL, **ckpt_msg_dec_ptr;
+
+  EDU_INST_SET ckpt_msg_ed_rules[] = {
+    {EDU_START, edp_ed_ckpt_msg_v6, 0, 0, 0, sizeof(lgsv_ckpt_msg_v6_t), 0, NULL},
+    {EDU_EXEC, edp_ed_header_rec, 0, 0, 0, (long)&((lgsv_ckpt_msg_v6_t *)0)->header, 0, NULL},
+
+    {EDU_TEST, ncs_edp_uns32, 0, 0, 0, (long)&((lgsv_ckpt_msg_v6_t *)0)->header, 0,
+     (EDU_EXEC_RTINE)ckpt_msg_test_type},
+
+    /* Reg Record */
+    {EDU_EXEC, edp_ed_reg_rec, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.initialize_client, 0, NULL},
+
+    /* Finalize record */
+    {EDU_EXEC, edp_ed_finalize_rec_v2, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.finalize_client, 0, NULL},
+
+    /* write log Record */
+    {EDU_EXEC, edp_ed_write_rec_v2, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.write_log, 0, NULL},
+
+    /* Open stream */
+    {EDU_EXEC, edp_ed_open_stream_rec, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.stream_open, 0, NULL},
+
+    /* Close stream */
+    {EDU_EXEC, edp_ed_close_stream_rec_v2, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.stream_close, 0, NULL},
+
+    /* Agent dest */
+    {EDU_EXEC, edp_ed_agent_down_rec_v2, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.stream_cfg, 0, NULL},
+
+    /* Cfg stream */
+    {EDU_EXEC, edp_ed_cfg_stream_rec_v2, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.stream_cfg, 0, NULL},
+
+    /* Lgs cfg */
+    {EDU_EXEC, edp_ed_lgs_cfg_rec_v5, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.lgs_cfg, 0, NULL},
+
+    /* Write high-water marks */
+    {EDU_EXEC, edp_ed_write_hwm_v6, 0, 0, static_cast<int>(EDU_EXIT),
+     (long)&((lgsv_ckpt_msg_v6_t *)0)->ckpt_rec.write_hwm, 0, NULL},
+
+    {EDU_END, 0, 0, 0, 0, 0, 0, NULL},
+  };
+
+  if (op == EDP_OP_TYPE_ENC) {
+    ckpt_msg_ptr = static_cast<lgsv_ckpt_msg_v6_t *>(ptr);
+  } else if (op == EDP_OP_TYPE_DEC) {
+    ckpt_msg_dec_ptr = static_cast<lgsv_ckpt_msg_v6_t **>(ptr);
+    if (*ckpt_msg_dec_ptr == NULL) {
+      *o_err = EDU_ERR_MEM_FAIL;
+      return NCSCC_RC_FAILURE;
+    }
+    memset(*ckpt_msg_dec_ptr, '\0', sizeof(lgsv_ckpt_msg_v6_t));
+    ckpt_msg_ptr = *ckpt_msg_dec_ptr;
+  } else {
+    ckpt_msg_ptr = static_cast<lgsv_ckpt_msg_v6_t *>(ptr);
+  }
+
+  rc = m_NCS_EDU_RUN_RULES(edu_hdl, edu_tkn, ckpt_msg_ed_rules,
+                           ckpt_msg_ptr, ptr_data_len, buf_env, op, o_err);
+
+  return rc;
+
+}       /* End edu_enc_dec_ckpt_msg() */
@@ -761,6 +761,65 @@ done:
   return rc_out;
 }
 
+/**
+ * Update the stream with current log file, file size and log record Id
+ * found in the log files. Used when the check-pointed values may be behind
+ * what was actually written, e.g. after a fail-over when log writes were
+ * check-pointed as high-water marks.
+ * The values are only updated if the log file contains a later record than
+ * the stream.
+ *
+ * @param stream[in/out]
+ * Will/May modify the following stream parameters:
+ *   logFileCurrent
+ *   curFileSize
+ *   logRecordId
+ *
+ * @return -1 on error
+ */
+int log_stream_file_params_sync(log_stream_t *stream) {
+  int rc_out = 0;
+  gfp_in_t par_in;
+  gfp_out_t par_out;
+  std::string pathName;
+
+  TRACE_ENTER2("stream %s", stream->name.c_str());
+
+  pathName = static_cast<const char *>(lgs_cfg_get(LGS_IMM_LOG_ROOT_DIRECTORY));
+  pathName = pathName + "/" + stream->pathName;
+
+  par_in.file_name = const_cast<char *>(stream->fileName.c_str());
+  par_in.file_path = const_cast<char *>(pathName.c_str());
+
+  // Initialize the output
+  par_out.curFileSize = 0;
+  par_out.logRecordId = 0;
+  par_out.curFileName = NULL;
+
+  if (lgs_get_file_params_h(&par_in, &par_out) == -1) {
+    TRACE("%s: lgs_get_file_params_h Fail", __FUNCTION__);
+    rc_out = -1;
+    goto done;
+  }
+
+  if ((par_out.curFileName != NULL) &&
+      (par_out.logRecordId > stream->logRecordId)) {
+    stream->logFileCurrent = par_out.curFileName;
+    stream->curFileSize = par_out.curFileSize;
+    stream->logRecordId = par_out.logRecordId;
+  }
+
+  TRACE("Out: curFileSize = %u, logRecordId = %u, logFileCurrent = %s",
+        stream->curFileSize, stream->logRecordId, stream->logFileCurrent.c_str());
+
+done:
+  // This memory is allocated in lgs_get_file_params_hdl()
+  if (par_out.curFileName != NULL)
+    free(par_out.curFileName);
+
+  TRACE_LEAVE2("rc_out = %d", rc_out);
+  return rc_out;
+}
 
 /**
  *
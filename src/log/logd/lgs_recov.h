@@ -33,6 +33,7 @@ int lgs_restore_one_app_stream(
     log_stream_t **o_stream
                                );
 int log_stream_open_file_restore(log_stream_t *log_stream);
+int log_stream_file_params_sync(log_stream_t *stream);
 int log_close_rtstream_files(const std::string &stream_name);
 
 #endif  // LOG_LOGD_LGS_RECOV_H_
@@ -389,6 +389,9 @@ void log_free_stream_resources(log_stream_t *stream) {
   if (stream->logFileFormat != NULL)
     free(stream->logFileFormat);
 
+  lgs_free_compiled_format(stream->logFileFormatCompiled);
+  log_file_wring_free(stream->wring);
+
   delete stream;
   stream = NULL;
 }
@@ -429,6 +432,9 @@ void log_stream_delete(log_stream_t **s) {
   if (stream->logFileFormat != NULL)
     free(stream->logFileFormat);
 
+  lgs_free_compiled_format(stream->logFileFormatCompiled);
+  log_file_wring_free(stream->wring);
+
   delete stream;
   *s = NULL;
   TRACE_LEAVE();
@@ -484,6 +490,8 @@ int lgs_populate_log_stream(
   if (o_stream->logFileFormat == NULL) {
     LOG_WA("Failed to allocate memory for logFileFormat");
     rc = -1;
+  } else {
+    log_stream_compile_format(o_stream);
   }
 
   return rc;
@@ -713,6 +721,20 @@ int log_file_open(
   return fd;
 }
 
+/**
+ * Compile the log file format of the stream. Must be done every time the
+ * logFileFormat of the stream is changed.
+ *
+ * @param stream
+ */
+void log_stream_compile_format(log_stream_t *stream) {
+  lgs_free_compiled_format(stream->logFileFormatCompiled);
+  stream->logFileFormatCompiled = NULL;
+
+  if (stream->logFileFormat != NULL)
+    stream->logFileFormatCompiled = lgs_compile_format_expression(stream->logFileFormat);
+}
+
 /**
  * If the stream is new (number of openers are 0) the stream files are created.
  * This includes:
@@ -1121,9 +1143,14 @@ done:
 }
 
 /**
- * log_stream_write will write a number of bytes to the associated file. If
- * the file size gets too big, the file is closed, renamed and a new file is
- * opened. If there are too many files, the oldest file will be deleted.
+ * log_stream_write will queue a number of bytes to be written to the
+ * associated file by the file thread. The record is copied and the caller
+ * keeps ownership of buf. If the file size gets too big, the file is closed,
+ * renamed and a new file is opened. If there are too many files, the oldest
+ * file will be deleted.
+ *
+ * A failed write is detected by the file thread and reported when the next
+ * record is queued to the stream.
  *
  * @param stream
  * @param buf
@@ -1131,14 +1158,12 @@ done:
  *
  * @return int 0 No error
  *            -1 on error
- *            -2 Write failed because of write timeout or EWOULDBLOCK/EAGAIN
+ *            -2 Write failed because the write queue of the stream is full
+ *               or EWOULDBLOCK/EAGAIN
  */
 int log_stream_write_h(log_stream_t *stream, const char *buf, size_t count) {
   int rc = 0;
   int errno_ret;
-  lgsf_apipar_t apipar;
-  wlrh_t params_in;
-  size_t params_in_size;
   lgsf_retcode_t api_rc;
   int write_errno=0;
 
@@ -1169,52 +1194,26 @@ int log_stream_write_h(log_stream_t *stream, const char *buf, size_t count) {
 
   TRACE("%s - *stream->p_fd = %d",__FUNCTION__,*stream->p_fd);
 
-  /* Get size of write log record header */
-  params_in_size = sizeof(wlrh_t);
-
-  params_in.fd = *stream->p_fd;
-  params_in.fixedLogRecordSize = stream->fixedLogRecordSize;
-  params_in.record_size = count;
-
-  /*
-    Not necessary to allocated memory for log record here.
-    Instead, point to log buffer allocated by the caller.
-
-    By this way, LOGsv will be improved performance as
-    it did not copy a large data (max could be 32 Kb) using memcpy.
-  */
-  params_in.lgs_rec = buf;
-
-  /* Fill in API structure */
-  apipar.req_code_in = LGSF_WRITELOGREC;
-  apipar.data_in_size = params_in_size;
-  apipar.data_in = &params_in;
-  apipar.data_out_size = sizeof(int);
-  apipar.data_out = &write_errno;
-
-  api_rc = log_file_api(&apipar);
-  if (api_rc == LGSF_TIMEOUT) {
+  api_rc = log_file_write_async(&stream->wring, *stream->p_fd, buf, count,
+                                &write_errno);
+  if (api_rc == LGSF_BUSY) {
+    /* Earlier records are still being written. Let the client try again */
     TRACE("%s - API error %s",__FUNCTION__,lgsf_retcode_str(api_rc));
     rc = -2;
+    goto done;
   } else if (api_rc != LGSF_SUCESS) {
     TRACE("%s - API error %s",__FUNCTION__,lgsf_retcode_str(api_rc));
     rc = -1;
-  } else {
-    rc = apipar.hdl_ret_code_out;
   }
 
   /* End write the log record */
 
-  if ((rc == -1) || (rc == -2)) {
+  if (rc == -1) {
     /* If writing failed always invalidate the stream file descriptor.
      */
     /* Careful with log level here to avoid syslog flooding */
-    if (rc == -2) {
-      LOG_IN("write '%s' failed \"Timeout\"", stream->logFileCurrent.c_str());
-    } else {
-      LOG_IN("write '%s' failed \"%s\"", stream->logFileCurrent.c_str(),
-             strerror(write_errno));
-    }
+    LOG_IN("write '%s' failed \"%s\"", stream->logFileCurrent.c_str(),
+           strerror(write_errno));
 
     if (*stream->p_fd != -1) {
       /* Close the file and invalidate the stream fd */
@@ -24,6 +24,7 @@
 #include <limits.h>
 
 #include "lgs_fmt.h"
+#include "lgs_file.h"
 #include "base/osaf_extended_name.h"
 
 #define LGS_LOG_FILE_EXT ".log"
@@ -56,9 +57,16 @@ typedef struct log_stream {
   int32_t fd_shared;      /* Checkpointed stream file descriptor for shared fs */
   int32_t fd_local;       /* Local stream file descriptor for split fs */
   int32_t *p_fd;      /* Points to shared or local fd depending on fs config */
+  lgsf_wring_t *wring;    /* Log records queued for the file thread */
+  lgs_compiled_fmt_t *logFileFormatCompiled; /* Compiled logFileFormat */
   std::string logFileCurrent;     /* Current file name */
   uint32_t curFileSize;   /* Bytes written to current log file */
   uint32_t logRecordId;   /* log record indentifier increased for each record */
+  /* Active: written to since the last write high-water mark check-point.
+   * Standby: updated by a high-water mark, to be synced with the log file
+   * when becoming active.
+   */
+  bool ckpt_hwm_pending;
   SaBoolT twelveHourModeFlag; /* Not used. Can be removed? */
   logStreamTypeT streamType;
   /**
@@ -106,6 +114,7 @@ extern int lgs_populate_log_stream(
 extern SaAisErrorT lgs_create_rt_appstream(log_stream_t *const rt);
 extern log_stream_t *log_stream_new(const std::string &name, int stream_id);
 
+extern void log_stream_compile_format(log_stream_t *stream);
 extern void log_stream_open_fileinit(log_stream_t *stream);
 extern void log_initiate_stream_files(log_stream_t *stream);
 
@@ -0,0 +1,203 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "base/osaf_extended_name.h"
+#include "log/logd/lgs_fmt.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+// The network name is otherwise read from the IMM configuration
+std::string lgs_get_networkname() {
+  return "testnet";
+}
+
+// The fixture for testing the compiled format expressions against
+// lgs_format_log_record()
+class LgsFmtTest : public ::testing::Test {
+ protected:
+  LgsFmtTest() :
+      class_id_{SA_NTF_VENDOR_ID_SAF, 1, 2},
+      body_("Hello world \xc3\xa5 with a body of some length"),
+      buffer_{body_.size(), reinterpret_cast<SaUint8T*>(&body_[0])} {
+  }
+
+  virtual void SetUp() {
+    osaf_extended_name_lend("safApp=LgsFmtTest", &user_name_);
+    osaf_extended_name_lend("safSu=SU1,safSg=SG1,safApp=App1", &ntf_object_);
+    osaf_extended_name_lend("safComp=Comp1,safSu=SU1", &ntf_notifier_);
+
+    memset(&app_record_, 0, sizeof(app_record_));
+    app_record_.logTimeStamp = 1476612345678901234LL;
+    app_record_.logHdrType = SA_LOG_GENERIC_HEADER;
+    app_record_.logHeader.genericHdr.notificationClassId = &class_id_;
+    app_record_.logHeader.genericHdr.logSvcUsrName = &user_name_;
+    app_record_.logHeader.genericHdr.logSeverity = SA_LOG_SEV_WARNING;
+    app_record_.logBuffer = &buffer_;
+
+    memset(&ntf_record_, 0, sizeof(ntf_record_));
+    ntf_record_.logTimeStamp = 1476612345678901234LL;
+    ntf_record_.logHdrType = SA_LOG_NTF_HEADER;
+    ntf_record_.logHeader.ntfHdr.notificationId = 4711;
+    ntf_record_.logHeader.ntfHdr.eventType = SA_NTF_ALARM_PROCESSING;
+    ntf_record_.logHeader.ntfHdr.notificationObject = &ntf_object_;
+    ntf_record_.logHeader.ntfHdr.notifyingObject = &ntf_notifier_;
+    ntf_record_.logHeader.ntfHdr.notificationClassId = &class_id_;
+    ntf_record_.logHeader.ntfHdr.eventTime = 1476612340123456789LL;
+    ntf_record_.logBuffer = &buffer_;
+  }
+
+  // Format a record with both formatters and expect identical results
+  void ExpectSameOutput(SaLogRecordT *record, const char *format,
+                        SaUint16T fixed_size, size_t dest_size) {
+    std::vector<char> expected(dest_size + 1, '\0');
+    std::vector<char> actual(dest_size + 1, '\0');
+    lgs_compiled_fmt_t *compiled = lgs_compile_format_expression(format);
+
+    int n1 = lgs_format_log_record(record, const_cast<SaStringT>(format),
+                                   1024, fixed_size, dest_size,
+                                   expected.data(), 42, node_name_);
+    int n2 = lgs_format_log_record_compiled(record, compiled, 1024, fixed_size,
+                                            dest_size, actual.data(), 42,
+                                            node_name_);
+    ASSERT_EQ(n1, n2) << format << " size " << dest_size;
+    EXPECT_EQ(std::string(expected.data(), n1), std::string(actual.data(), n2))
+        << format << " size " << dest_size;
+    lgs_free_compiled_format(compiled);
+  }
+
+  // Format records with one formatter and return the number of records/sec
+  double RecordsPerSecond(SaLogRecordT *record, const char *format,
+                          bool use_compiled) {
+    static const int kRecords = 200000;
+    char dest[1024];
+    lgs_compiled_fmt_t *compiled = lgs_compile_format_expression(format);
+    SaTimeT time_stamp = record->logTimeStamp;
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < kRecords; ++i) {
+      // A new second every 1000 records
+      record->logTimeStamp = time_stamp + i * SA_TIME_ONE_MILLISECOND;
+      if (use_compiled) {
+        lgs_format_log_record_compiled(record, compiled, 1024 * 1024, 0,
+                                       sizeof(dest), dest, i, node_name_);
+      } else {
+        lgs_format_log_record(record, const_cast<SaStringT>(format),
+                              1024 * 1024, 0, sizeof(dest), dest, i,
+                              node_name_);
+      }
+    }
+    duration<double> elapsed = steady_clock::now() - start;
+
+    record->logTimeStamp = time_stamp;
+    lgs_free_compiled_format(compiled);
+    return kRecords / elapsed.count();
+  }
+
+  void Benchmark(const char *name, SaLogRecordT *record, const char *format) {
+    double interpreted = RecordsPerSecond(record, format, false);
+    double compiled = RecordsPerSecond(record, format, true);
+    std::cout << name << ": interpreted " << static_cast<uint64_t>(interpreted)
+              << " records/s, compiled " << static_cast<uint64_t>(compiled)
+              << " records/s\n";
+  }
+
+  SaNtfClassIdT class_id_;
+  SaNameT user_name_;
+  SaNameT ntf_object_;
+  SaNameT ntf_notifier_;
+  std::string body_;
+  SaLogBufferT buffer_;
+  SaLogRecordT app_record_;
+  SaLogRecordT ntf_record_;
+  char node_name_[8] = "SC-1";
+};
+
+static const char *const app_formats[] = {
+  DEFAULT_APP_SYS_FORMAT_EXP,
+  "@Cr @Ct @Ch:@Cn:@Cs.@Ck @Cm/@Cd/@CY @Sv @Sl \"@Cb\"",
+  "@Ca @CM @CD @Cy @Cz @Cc @Cp @Cq @Sl10 @Cb8 @Ci @Ci6 @Cx",
+  "<@Cr> @Cs@Cs @Cb30 @Sl30 end",
+  "@Cx@Cb",
+  "@Cb@Cx",
+};
+
+static const char *const ntf_formats[] = {
+  DEFAULT_ALM_NOT_FORMAT_EXP,
+  "@Cr @Ni @Nt @Nh:@Nn:@Ns.@Nk @Nm/@Nd/@NY @Ny @Na @NM @ND @Nz \"@Cb\"",
+  "@Ch:@Cn:@Cs @Nh:@Nn:@Ns @Ne @Ne2 @Ne10 @No @Ng @Cc @Cx",
+};
+
+TEST_F(LgsFmtTest, CompiledAppFormatsGiveSameOutput) {
+  for (const char *format : app_formats) {
+    for (size_t size = 2; size < 150; ++size) {
+      ExpectSameOutput(&app_record_, format, 0, size);
+    }
+    ExpectSameOutput(&app_record_, format, 150, 150);
+    ExpectSameOutput(&app_record_, format, 40, 40);
+  }
+}
+
+TEST_F(LgsFmtTest, CompiledNtfFormatsGiveSameOutput) {
+  for (const char *format : ntf_formats) {
+    for (size_t size = 2; size < 250; ++size) {
+      ExpectSameOutput(&ntf_record_, format, 0, size);
+    }
+    ExpectSameOutput(&ntf_record_, format, 250, 250);
+    ExpectSameOutput(&ntf_record_, format, 40, 40);
+  }
+}
+
+TEST_F(LgsFmtTest, CachedTimeFollowsTimeStamp) {
+  lgs_compiled_fmt_t *compiled =
+      lgs_compile_format_expression(DEFAULT_APP_SYS_FORMAT_EXP);
+  char expected[256];
+  char actual[256];
+
+  for (int i = 0; i < 5000; ++i) {
+    app_record_.logTimeStamp += 997 * SA_TIME_ONE_MILLISECOND;
+    int n1 = lgs_format_log_record(
+        &app_record_, const_cast<SaStringT>(DEFAULT_APP_SYS_FORMAT_EXP),
+        1024, 0, sizeof(expected), expected, i, node_name_);
+    int n2 = lgs_format_log_record_compiled(&app_record_, compiled, 1024, 0,
+                                            sizeof(actual), actual, i,
+                                            node_name_);
+    ASSERT_EQ(n1, n2);
+    ASSERT_EQ(std::string(expected, n1), std::string(actual, n2));
+  }
+  lgs_free_compiled_format(compiled);
+}
+
+TEST_F(LgsFmtTest, InvalidFormatIsFormattedAsBefore) {
+  ExpectSameOutput(&app_record_, "@Cr @Xy", 0, 100);
+  ExpectSameOutput(&app_record_, "@Cr @", 0, 100);
+}
+
+// Compare the number of formatted records/sec with lgs_format_log_record()
+TEST_F(LgsFmtTest, Benchmark) {
+  Benchmark("app", &app_record_, DEFAULT_APP_SYS_FORMAT_EXP);
+  ntf_record_.logHeader.ntfHdr.eventType = SA_NTF_ALARM_PROCESSING;
+  Benchmark("alarm", &ntf_record_, DEFAULT_ALM_NOT_FORMAT_EXP);
+  ntf_record_.logHeader.ntfHdr.eventType = SA_NTF_OBJECT_CREATION;
+  Benchmark("notification", &ntf_record_, DEFAULT_ALM_NOT_FORMAT_EXP);
+}
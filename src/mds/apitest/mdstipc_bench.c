@@ -0,0 +1,234 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/* The test framework */
+#include "osaf/apitest/utest.h"
+#include "osaf/apitest/util.h"
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "mds/mds_papi.h"
+#include "base/ncs_mda_papi.h"
+#include "base/ncs_main_papi.h"
+#include "mdstipc.h"
+
+/*
+  Throughput of MDS when several threads send over the same service
+  handle while a receiver thread dispatches the receiving service. This is
+  the pattern of the agent libraries, where all threads of a process share
+  the MDS library mutex. Run with: mdstest 27 1
+*/
+
+#define BENCH_SNDR_SVC_ID 2100
+#define BENCH_RCVR_SVC_ID 2101
+#define BENCH_MAX_THREADS 8
+#define BENCH_MSGS_PER_THREAD 20000
+#define BENCH_MSG_LEN 128
+
+static MDS_HDL bench_pwe_hdl;
+static MDS_DEST bench_rcvr_dest;
+static NCS_SEL_OBJ bench_rcvr_sel_obj;
+static volatile uint32_t bench_received;
+static volatile uint32_t bench_send_failed;
+static volatile uint32_t bench_expected;
+
+static uint32_t bench_svc_callback(NCSMDS_CALLBACK_INFO *info)
+{
+  if (info->i_op == MDS_CALLBACK_DIRECT_RECEIVE) {
+    m_MDS_FREE_DIRECT_BUFF(info->info.direct_receive.i_direct_buff);
+    __sync_fetch_and_add(&bench_received, 1);
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+static uint32_t bench_install(MDS_SVC_ID svc_id, bool q_ownership)
+{
+  NCSMDS_INFO info;
+
+  memset(&info, 0, sizeof(info));
+  info.i_mds_hdl = bench_pwe_hdl;
+  info.i_svc_id = svc_id;
+  info.i_op = MDS_INSTALL;
+  info.info.svc_install.i_mds_svc_pvt_ver = 1;
+  info.info.svc_install.i_svc_cb = bench_svc_callback;
+  info.info.svc_install.i_install_scope = NCSMDS_SCOPE_NONE;
+  info.info.svc_install.i_mds_q_ownership = q_ownership;
+
+  if (ncsmds_api(&info) != NCSCC_RC_SUCCESS)
+    return NCSCC_RC_FAILURE;
+
+  if (svc_id == BENCH_RCVR_SVC_ID) {
+    bench_rcvr_dest = info.info.svc_install.o_dest;
+    bench_rcvr_sel_obj = info.info.svc_install.o_sel_obj;
+  }
+  return NCSCC_RC_SUCCESS;
+}
+
+static void bench_uninstall(MDS_SVC_ID svc_id)
+{
+  NCSMDS_INFO info;
+
+  memset(&info, 0, sizeof(info));
+  info.i_mds_hdl = bench_pwe_hdl;
+  info.i_svc_id = svc_id;
+  info.i_op = MDS_UNINSTALL;
+  ncsmds_api(&info);
+}
+
+static uint32_t bench_subscribe(void)
+{
+  NCSMDS_INFO info;
+  MDS_SVC_ID svc_ids[] = {BENCH_RCVR_SVC_ID};
+
+  memset(&info, 0, sizeof(info));
+  info.i_mds_hdl = bench_pwe_hdl;
+  info.i_svc_id = BENCH_SNDR_SVC_ID;
+  info.i_op = MDS_SUBSCRIBE;
+  info.info.svc_subscribe.i_scope = NCSMDS_SCOPE_NONE;
+  info.info.svc_subscribe.i_num_svcs = 1;
+  info.info.svc_subscribe.i_svc_ids = svc_ids;
+  return ncsmds_api(&info);
+}
+
+static void *bench_sender(void *arg)
+{
+  unsigned int i;
+  char payload[BENCH_MSG_LEN];
+
+  memset(payload, 'x', sizeof(payload));
+  for (i = 0; i < BENCH_MSGS_PER_THREAD; ++i) {
+    NCSMDS_INFO info;
+    MDS_DIRECT_BUFF buff = m_MDS_ALLOC_DIRECT_BUFF(sizeof(payload));
+
+    memcpy(buff, payload, sizeof(payload));
+    memset(&info, 0, sizeof(info));
+    info.i_mds_hdl = bench_pwe_hdl;
+    info.i_svc_id = BENCH_SNDR_SVC_ID;
+    info.i_op = MDS_DIRECT_SEND;
+    info.info.svc_direct_send.i_direct_buff = buff;
+    info.info.svc_direct_send.i_direct_buff_len = sizeof(payload);
+    info.info.svc_direct_send.i_to_svc = BENCH_RCVR_SVC_ID;
+    info.info.svc_direct_send.i_msg_fmt_ver = 1;
+    info.info.svc_direct_send.i_priority = MDS_SEND_PRIORITY_MEDIUM;
+    info.info.svc_direct_send.i_sendtype = MDS_SENDTYPE_SND;
+    info.info.svc_direct_send.info.snd.i_to_dest = bench_rcvr_dest;
+    if (ncsmds_api(&info) != NCSCC_RC_SUCCESS)
+      __sync_fetch_and_add(&bench_send_failed, 1);
+  }
+  return NULL;
+}
+
+static void *bench_receiver(void *arg)
+{
+  struct pollfd fd;
+  int idle = 0;
+
+  fd.fd = m_GET_FD_FROM_SEL_OBJ(bench_rcvr_sel_obj);
+  fd.events = POLLIN;
+
+  /* Stop when all messages have arrived, or after 5 s without traffic */
+  while ((bench_received + bench_send_failed) < bench_expected && idle < 50) {
+    NCSMDS_INFO info;
+
+    if (poll(&fd, 1, 100) <= 0) {
+      ++idle;
+      continue;
+    }
+    idle = 0;
+    memset(&info, 0, sizeof(info));
+    info.i_mds_hdl = bench_pwe_hdl;
+    info.i_svc_id = BENCH_RCVR_SVC_ID;
+    info.i_op = MDS_RETRIEVE;
+    info.info.retrieve_msg.i_dispatchFlags = SA_DISPATCH_ALL;
+    ncsmds_api(&info);
+  }
+  return NULL;
+}
+
+static double bench_elapsed(const struct timespec *start,
+                            const struct timespec *end)
+{
+  return (end->tv_sec - start->tv_sec) +
+         (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+void tet_bench_multi_thread_send(void)
+{
+  int FAIL = 0;
+  unsigned int nthreads;
+
+  if (adest_get_handle() != NCSCC_RC_SUCCESS) {
+    test_validate(1, 0);
+    return;
+  }
+  bench_pwe_hdl = gl_tet_adest.mds_pwe1_hdl;
+
+  if (bench_install(BENCH_RCVR_SVC_ID, true) != NCSCC_RC_SUCCESS ||
+      bench_install(BENCH_SNDR_SVC_ID, false) != NCSCC_RC_SUCCESS ||
+      bench_subscribe() != NCSCC_RC_SUCCESS) {
+    printf("\nFail to set up the benchmark services\n");
+    FAIL = 1;
+    goto done;
+  }
+  /* Let the service up event for the receiver reach the sender */
+  sleep(1);
+
+  for (nthreads = 1; nthreads <= BENCH_MAX_THREADS; nthreads *= 2) {
+    pthread_t senders[BENCH_MAX_THREADS];
+    pthread_t receiver;
+    struct timespec start, end;
+    unsigned int i;
+    double secs;
+
+    bench_received = 0;
+    bench_send_failed = 0;
+    bench_expected = nthreads * BENCH_MSGS_PER_THREAD;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&receiver, NULL, bench_receiver, NULL);
+    for (i = 0; i < nthreads; ++i)
+      pthread_create(&senders[i], NULL, bench_sender, NULL);
+    for (i = 0; i < nthreads; ++i)
+      pthread_join(senders[i], NULL);
+    pthread_join(receiver, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    secs = bench_elapsed(&start, &end);
+    printf("\n%u sender thread(s): %u msgs received in %.3f s, "
+           "%.0f msgs/s, %u send failures\n", nthreads, bench_received,
+           secs, bench_received / secs, bench_send_failed);
+    if (bench_received + bench_send_failed != bench_expected ||
+        bench_send_failed != 0)
+      FAIL = 1;
+  }
+
+done:
+  bench_uninstall(BENCH_SNDR_SVC_ID);
+  bench_uninstall(BENCH_RCVR_SVC_ID);
+  test_validate(FAIL, 0);
+}
+
+__attribute__ ((constructor)) static void mdsTipcBench_constructor(void)
+{
+  test_suite_add(27, "Benchmark test cases");
+  test_case_add(27, tet_bench_multi_thread_send,
+                "Throughput of direct sends from 1, 2, 4 and 8 threads to a service on the same ADEST");
+}
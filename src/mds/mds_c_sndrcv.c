@@ -1175,7 +1175,7 @@ static uint32_t mcm_msg_cpy_send(uint8_t to, MDS_SVC_INFO *svc_cb, SEND_MSG *to_
 				/* svc subpart ver to be filled */
 				cbinfo.info.enc.i_rem_svc_pvt_ver = to_msg->rem_svc_sub_part_ver;
 
-				if (ncs_enc_init_space_pp(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) !=
+				if (ncs_enc_init_space_contig(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) !=
 				    NCSCC_RC_SUCCESS) {
 					m_MDS_LOG_ERR("MDS_SND_RCV: encode full init failed svc_id = %s(%d)\n",
 						      get_svc_names(svc_cb->svc_id), svc_cb->svc_id);
@@ -1380,14 +1380,14 @@ static uint32_t mcm_msg_encode_full_or_flat_and_send(uint8_t to, SEND_MSG *to_ms
 
 	if (to == DESTINATION_OFF_NODE) {
 		msg_send.msg.encoding = MDS_ENC_TYPE_FULL;
-		if (ncs_enc_init_space_pp(&msg_send.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
+		if (ncs_enc_init_space_contig(&msg_send.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
 			m_MDS_LOG_ERR("MDS_SND_RCV: encode full init failed svc_id = %s(%d)\n",
 			 get_svc_names(svc_cb->svc_id), svc_cb->svc_id);
 			return NCSCC_RC_FAILURE;
 		}
 	} else {
 		msg_send.msg.encoding = MDS_ENC_TYPE_FLAT;
-		if (ncs_enc_init_space_pp(&msg_send.msg.data.flat_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
+		if (ncs_enc_init_space_contig(&msg_send.msg.data.flat_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
 			m_MDS_LOG_ERR("MDS_SND_RCV: encode flat init failed svc_id = %s(%d)\n", 
 			get_svc_names(svc_cb->svc_id), svc_cb->svc_id);
 			return NCSCC_RC_FAILURE;
@@ -2039,7 +2039,7 @@ static uint32_t mcm_process_await_active(MDS_SVC_INFO *svc_cb, MDS_SUBSCRIPTION_
 		    ((NCSCC_RC_SUCCESS == (mds_mcm_search_bcast_list(to_msg, BCAST_ENC, to_msg->rem_svc_sub_part_ver,
 								     MDS_SVC_ARCHWORD_TYPE_UNSPECIFIED, &bcast_ptr,
 								     1))))) {
-			if (ncs_enc_init_space_pp(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
+			if (ncs_enc_init_space_contig(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
 				m_MDS_LOG_ERR("MDS_SND_RCV: encode full init failed svc_id = %s(%d)\n", 
 				get_svc_names(svc_cb->svc_id), svc_cb->svc_id);
 				return NCSCC_RC_FAILURE;
@@ -2062,7 +2062,7 @@ static uint32_t mcm_process_await_active(MDS_SVC_INFO *svc_cb, MDS_SUBSCRIPTION_
 			cbinfo.info.enc.i_rem_svc_pvt_ver =
 			    send_hdl->info.active_vdest.active_route_info->last_active_svc_sub_part_ver;
 
-			if (ncs_enc_init_space_pp(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
+			if (ncs_enc_init_space_contig(&req.msg.data.fullenc_uba, NCSUB_MDS_POOL, 0) != NCSCC_RC_SUCCESS) {
 				m_MDS_LOG_ERR("MDS_SND_RCV: Encode init space failed for ub\n");
 				return NCSCC_RC_FAILURE;
 			}
@@ -45,7 +45,11 @@ typedef uint32_t MDS_SYNC_TXN_ID;
  * be locked several times by the same thread.
  *
  * There is only one mutex protecting all data for the entire MDS library, hence
- * it is very important to keep the lock for as short time as possible.
+ * it is very important to keep the lock for as short time as possible. The
+ * receive threads therefore only take it once a complete message or discovery
+ * event has been read from the socket. The send path keeps pointers into the
+ * subscription and destination tables between calls, so the tables can not be
+ * split over several locks or read through snapshots without reworking it.
  */
 extern pthread_mutex_t gl_mds_library_mutex;
 
@@ -1050,7 +1050,7 @@ uint32_t mdtm_process_recv_data(uint8_t *buffer, uint16_t len, uint64_t transpor
 				if (reassem_queue->recv.msg.encoding == MDS_ENC_TYPE_FLAT) {
 					m_MDS_LOG_INFO("MDTM: Reassembling in flat UB\n");
 					NCS_UBAID ub;
-					ncs_enc_init_space_pp(&ub, 0, 0);
+					ncs_enc_init_space_contig(&ub, 0, (len - MDTM_FRAG_HDR_LEN));
 					ncs_encode_n_octets_in_uba(&ub, &buffer[MDTM_FRAG_HDR_LEN],
 								   (len - MDTM_FRAG_HDR_LEN));
 
@@ -1058,7 +1058,7 @@ uint32_t mdtm_process_recv_data(uint8_t *buffer, uint16_t len, uint64_t transpor
 				} else if (reassem_queue->recv.msg.encoding == MDS_ENC_TYPE_FULL) {
 					m_MDS_LOG_INFO("MDTM: Reassembling in FULL UB\n");
 					NCS_UBAID ub;
-					ncs_enc_init_space_pp(&ub, 0, 0);
+					ncs_enc_init_space_contig(&ub, 0, (len - MDTM_FRAG_HDR_LEN));
 					ncs_encode_n_octets_in_uba(&ub, &buffer[MDTM_FRAG_HDR_LEN],
 								   (len - MDTM_FRAG_HDR_LEN));
 
@@ -1174,7 +1174,7 @@ static uint32_t mdtm_fill_data(MDTM_REASSEMBLY_QUEUE *reassem_queue, uint8_t *bu
 
 	case MDS_ENC_TYPE_FLAT:
 		{
-			ncs_enc_init_space_pp(&reassem_queue->recv.msg.data.flat_uba, 0, 0);
+			ncs_enc_init_space_contig(&reassem_queue->recv.msg.data.flat_uba, 0, len);
 			ncs_encode_n_octets_in_uba(&reassem_queue->recv.msg.data.flat_uba, buffer, len);
 			return NCSCC_RC_SUCCESS;
 		}
@@ -1182,7 +1182,7 @@ static uint32_t mdtm_fill_data(MDTM_REASSEMBLY_QUEUE *reassem_queue, uint8_t *bu
 
 	case MDS_ENC_TYPE_FULL:
 		{
-			ncs_enc_init_space_pp(&reassem_queue->recv.msg.data.fullenc_uba, 0, 0);
+			ncs_enc_init_space_contig(&reassem_queue->recv.msg.data.fullenc_uba, 0, len);
 			ncs_encode_n_octets_in_uba(&reassem_queue->recv.msg.data.fullenc_uba, buffer, len);
 			return NCSCC_RC_SUCCESS;
 		}
@@ -71,6 +71,8 @@ static bool mds_use_network_order = false;
 #define NTOHL(x) (mds_use_network_order?ntohl(x):x)
 #define HTONL(x) (mds_use_network_order?htonl(x):x)
 
+#define MDTM_MAX_SEND_IOV 32	/* Header plus USRBUF segments sent with one sendmsg() */
+
 extern bool tipc_mcast_enabled;
 static uint32_t mdtm_tipc_check_for_endianness(void);
 
@@ -105,6 +107,9 @@ uint32_t mds_mdtm_send_tipc(MDTM_SEND_REQ *req);
 /* Tipc actual send, can be made as Macro even*/
 static uint32_t mdtm_sendto(uint8_t *buffer, uint16_t buff_len, struct tipc_portid tipc_id);
 static uint32_t mdtm_mcast_sendto(void *buffer, size_t size, const MDTM_SEND_REQ *req);
+static uint32_t mdtm_sendto_usrbuf(uint8_t *hdr, uint16_t hdr_len, USRBUF *usrbuf, uint16_t len,
+				   struct tipc_portid tipc_id);
+static uint8_t *mdtm_flatten_usrbuf(const uint8_t *hdr, uint16_t hdr_len, USRBUF *usrbuf, uint16_t len);
 
 uint32_t mdtm_frag_and_send(MDTM_SEND_REQ *req, uint32_t seq_num, struct tipc_portid id, int frag_size);
 
@@ -650,14 +655,15 @@ static uint32_t mdtm_process_recv_events(void)
 		pollres = poll(pfd, 3, MDTM_TIPC_POLL_TIMEOUT);
 
 		if (pollres > 0) {	/* Check for EINTR and discard */
+			/* The sockets are only read by this thread, the library
+			   mutex is taken once an event or a message has been received. */
 			memset(&event, 0, sizeof(event));
-			osaf_mutex_lock_ordie(&gl_mds_library_mutex);
 			if (pfd[0].revents == POLLIN) {
 				if (recv(tipc_cb.Dsock, &event, sizeof(event), 0) != sizeof(event)) {
 					m_MDS_LOG_ERR("Unable to capture the recd event .. Continuing  err :%s", strerror(errno));
-					osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
 					continue;
 				} else {
+					osaf_mutex_lock_ordie(&gl_mds_library_mutex);
 					if (NTOHL(event.event) == TIPC_PUBLISHED) {
 
 						m_MDS_LOG_INFO("MDTM: Published: ");
@@ -726,9 +732,9 @@ static uint32_t mdtm_process_recv_events(void)
 						(struct sockaddr *)&client_addr, &alen);
 				if (recd_bytes == 0) {
 					m_MDS_LOG_DBG("MDTM: recd bytes=0 on received on sock, abnormal/unknown/hack  condition. Ignoring");
-					osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
 					continue;
 				}
+				osaf_mutex_lock_ordie(&gl_mds_library_mutex);
 				data = inbuf;
 
 				recd_buf_len = ncs_decode_16bit(&data);
@@ -791,6 +797,7 @@ static uint32_t mdtm_process_recv_events(void)
 					mds_buff_dump(inbuf, recd_bytes, 100);
 				}
 			} else if (pfd[2].revents == POLLIN) {
+				osaf_mutex_lock_ordie(&gl_mds_library_mutex);
 				m_MDS_LOG_INFO("MDTM: Processing Timer mailbox events\n");
 
 				/* Check if destroy-event has been processed */
@@ -804,6 +811,8 @@ static uint32_t mdtm_process_recv_events(void)
 					   pthread-cancel & pthread-join, do not get blocked. */
 					return NCSCC_RC_SUCCESS;	/* Thread quit */
 				}
+			} else {
+				continue;
 			}
 			osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
 		}		/* if pollres */
@@ -2150,29 +2159,21 @@ uint32_t mds_mdtm_send_tipc(MDTM_SEND_REQ *req)
                                               get_svc_names(req->src_svc_id), req->src_svc_id, get_svc_names(req->dest_svc_id), req->dest_svc_id);
 					return mdtm_frag_and_send(req, frag_seq_num, tipc_id, frag_size);
 				} else {
-					uint8_t *p8;
-					uint8_t *body = NULL;
-					body = calloc(1, len + sum_mds_hdr_plus_mdtm_hdr_plus_len);
-
-					p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf, len, (char *)
-									  (body + sum_mds_hdr_plus_mdtm_hdr_plus_len));
+					/* Headers only; the data is sent from the USRBUF chain */
+					uint8_t hdr[sum_mds_hdr_plus_mdtm_hdr_plus_len];
+					uint32_t data_len = len;
 
-					if (p8 != (body + sum_mds_hdr_plus_mdtm_hdr_plus_len))
-						memcpy((body + sum_mds_hdr_plus_mdtm_hdr_plus_len), p8, len);
-
-					if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr(body, req)) {
+					if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr(hdr, req)) {
 						m_MDS_LOG_ERR("MDTM: Unable to add the mds Hdr to the send msg\n");
 						m_MMGR_FREE_BUFR_LIST(usrbuf);
-						free(body);
 						return NCSCC_RC_FAILURE;
 					}
 
 					if (NCSCC_RC_SUCCESS !=
-					    mdtm_add_frag_hdr(body, (len + sum_mds_hdr_plus_mdtm_hdr_plus_len),
+					    mdtm_add_frag_hdr(hdr, (len + sum_mds_hdr_plus_mdtm_hdr_plus_len),
 							      frag_seq_num, 0)) {
 						m_MDS_LOG_ERR("MDTM: Unable to add the frag Hdr to the send msg\n");
 						m_MMGR_FREE_BUFR_LIST(usrbuf);
-						free(body);
 						return NCSCC_RC_FAILURE;
 					}
 
@@ -2183,16 +2184,18 @@ uint32_t mds_mdtm_send_tipc(MDTM_SEND_REQ *req)
 					len += sum_mds_hdr_plus_mdtm_hdr_plus_len;
 					if (((req->snd_type == MDS_SENDTYPE_RBCAST) || (req->snd_type == MDS_SENDTYPE_BCAST)) && 
 							(version > 0) && (tipc_mcast_enabled)) {
+						uint8_t *body;
+
 						m_MDS_LOG_DBG("MDTM: User Sending Multicast Data lenght=%d From svc_id = %s(%d) to svc_id = %s(%d)\n", len,
 								get_svc_names(req->src_svc_id), req->src_svc_id, get_svc_names(req->dest_svc_id), req->dest_svc_id);
 						if ( len > MDS_DIRECT_BUF_MAXSIZE) {
 							m_MMGR_FREE_BUFR_LIST(usrbuf);
-							free(body);
 							LOG_NO("MDTM: Not possible to send size:%d TIPC multicast to svc_id = %s(%d)",
 									len, get_svc_names(req->dest_svc_id), req->dest_svc_id);
 							return NCSCC_RC_FAILURE;
 						}
-						if (NCSCC_RC_SUCCESS != mdtm_mcast_sendto(body, len, req)) {
+						body = mdtm_flatten_usrbuf(hdr, sum_mds_hdr_plus_mdtm_hdr_plus_len, usrbuf, data_len);
+						if ((body == NULL) || (NCSCC_RC_SUCCESS != mdtm_mcast_sendto(body, len, req))) {
 							m_MDS_LOG_ERR("MDTM: Failed to send Multicast message Data lenght=%d " 
 									"From svc_id = %s(%d) to svc_id = %s(%d) err :%s",
 									len, get_svc_names(req->src_svc_id), req->src_svc_id,
@@ -2201,16 +2204,16 @@ uint32_t mds_mdtm_send_tipc(MDTM_SEND_REQ *req)
 							free(body);
 							return NCSCC_RC_FAILURE;
 						}
+						free(body);
 					} else {
-						if (NCSCC_RC_SUCCESS !=	mdtm_sendto(body, len, tipc_id)) {
+						if (NCSCC_RC_SUCCESS != mdtm_sendto_usrbuf(hdr, sum_mds_hdr_plus_mdtm_hdr_plus_len,
+											   usrbuf, data_len, tipc_id)) {
 							m_MDS_LOG_ERR("MDTM: Unable to send the msg thru TIPC\n");
 							m_MMGR_FREE_BUFR_LIST(usrbuf);
-							free(body);
 							return NCSCC_RC_FAILURE;
 						}
 					}
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_SUCCESS;
 				}
 			}
@@ -2306,7 +2309,6 @@ uint32_t mdtm_frag_and_send(MDTM_SEND_REQ *req, uint32_t seq_num,
 	USRBUF *usrbuf;
 	uint32_t len = 0;
 	uint16_t len_buf = 0;
-	uint8_t *p8;
 	uint16_t i = 1;
 	uint16_t frag_val = 0;
 	uint32_t sum_mds_hdr_plus_mdtm_hdr_plus_len;
@@ -2363,54 +2365,38 @@ uint32_t mdtm_frag_and_send(MDTM_SEND_REQ *req, uint32_t seq_num,
 			frag_val = NO_FRAG_BIT | i;
 		}
 		{
-			uint8_t *body = NULL;
-			body = calloc(1, len_buf);
+			/* Headers only; the fragment data is sent from the USRBUF chain */
+			uint8_t hdr[sum_mds_hdr_plus_mdtm_hdr_plus_len];
 			if (i == 1) {
-				p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf,
-								  (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len),
-								  (char *)(body + sum_mds_hdr_plus_mdtm_hdr_plus_len));
-
-				if (p8 != (body + sum_mds_hdr_plus_mdtm_hdr_plus_len))
-					memcpy((body + sum_mds_hdr_plus_mdtm_hdr_plus_len), p8, (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len));
-
-				if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr(body, req)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr(hdr, req)) {
 					m_MDS_LOG_ERR("MDTM: frg MDS hdr addition failed\n");
-					free(body);
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
 					return NCSCC_RC_FAILURE;
 				}
 
-				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr(body, len_buf, seq_num, frag_val)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr(hdr, len_buf, seq_num, frag_val)) {
 					m_MDS_LOG_ERR("MDTM: Frag hdr addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 				m_MDS_LOG_DBG
 				    ("MDTM:Sending message with Service Seqno=%d, Fragment Seqnum=%d, frag_num=%d, TO Dest_Tipc_id=<0x%08x:%u>",
 				     req->svc_seq_num, seq_num, frag_val, id.node, id.ref);
-				mdtm_sendto(body, len_buf, id);
+				mdtm_sendto_usrbuf(hdr, sum_mds_hdr_plus_mdtm_hdr_plus_len, usrbuf,
+						   len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len, id);
 				m_MMGR_REMOVE_FROM_START(&usrbuf, len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len);
-				free(body);
 				len = len - (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len);
 			} else {
-				p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf, len_buf - MDTM_FRAG_HDR_PLUS_LEN_2,
-								  (char *)(body + MDTM_FRAG_HDR_PLUS_LEN_2));
-				if (p8 != (body + MDTM_FRAG_HDR_PLUS_LEN_2))
-					memcpy((body + MDTM_FRAG_HDR_PLUS_LEN_2), p8, len_buf - MDTM_FRAG_HDR_PLUS_LEN_2);
-
-				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr(body, len_buf, seq_num, frag_val)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr(hdr, len_buf, seq_num, frag_val)) {
 					m_MDS_LOG_ERR("MDTM: Frag hde addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 				m_MDS_LOG_DBG
 				    ("MDTM:Sending message with Service Seqno=%d, Fragment Seqnum=%d, frag_num=%d, TO Dest_Tipc_id=<0x%08x:%u>",
 				     req->svc_seq_num, seq_num, frag_val, id.node, id.ref);
-				mdtm_sendto(body, len_buf, id);
+				mdtm_sendto_usrbuf(hdr, MDTM_FRAG_HDR_PLUS_LEN_2, usrbuf, len_buf - MDTM_FRAG_HDR_PLUS_LEN_2, id);
 				m_MMGR_REMOVE_FROM_START(&usrbuf, (len_buf - MDTM_FRAG_HDR_PLUS_LEN_2));
-				free(body);
 				len = len - (len_buf - MDTM_FRAG_HDR_PLUS_LEN_2);
 				if (len == 0)
 					break;
@@ -2508,6 +2494,108 @@ static uint32_t mdtm_sendto(uint8_t *buffer, uint16_t buff_len, struct tipc_port
 	}
 }
 
+/*********************************************************
+
+  Function NAME: mdtm_flatten_usrbuf
+
+  DESCRIPTION: Copies a message header and the first "len"
+               octets of a USRBUF chain into one allocated
+               buffer, to be freed by the caller.
+
+  ARGUMENTS:
+
+  RETURNS:  The buffer, or NULL
+
+*********************************************************/
+
+static uint8_t *mdtm_flatten_usrbuf(const uint8_t *hdr, uint16_t hdr_len, USRBUF *usrbuf, uint16_t len)
+{
+	uint8_t *body = malloc(hdr_len + len);
+
+	if (body == NULL)
+		return NULL;
+
+	memcpy(body, hdr, hdr_len);
+	if ((len != 0) && (m_MMGR_COPY_MID_DATA(usrbuf, 0, len, body + hdr_len) == NULL)) {
+		free(body);
+		return NULL;
+	}
+	return body;
+}
+
+/*********************************************************
+
+  Function NAME: mdtm_sendto_usrbuf
+
+  DESCRIPTION: Sends a message header followed by the first
+               "len" octets of a USRBUF chain with one
+               sendmsg(), gathering the data from the USRBUF
+               payloads. Falls back to flattening the message
+               when a checksum has to be computed over it or
+               the chain has too many segments.
+
+  ARGUMENTS:
+
+  RETURNS:  1 - NCSCC_RC_SUCCESS
+            2 - NCSCC_RC_FAILURE
+
+*********************************************************/
+
+static uint32_t mdtm_sendto_usrbuf(uint8_t *hdr, uint16_t hdr_len, USRBUF *usrbuf, uint16_t len,
+				   struct tipc_portid id)
+{
+	struct sockaddr_tipc server_addr;
+	struct iovec iov[MDTM_MAX_SEND_IOV];
+	struct msghdr msg;
+	ssize_t send_len = 0;
+	int cnt = -1;
+
+#ifdef MDS_CHECKSUM_ENABLE_FLAG
+	if (gl_mds_checksum != 1)
+#endif
+		cnt = m_MMGR_IOVEC(usrbuf, len, &iov[1], MDTM_MAX_SEND_IOV - 1);
+
+	if (cnt < 0) {
+		uint32_t rc;
+		uint8_t *body = mdtm_flatten_usrbuf(hdr, hdr_len, usrbuf, len);
+
+		if (body == NULL) {
+			m_MDS_LOG_ERR("MDTM: Unable to flatten the msg of Len=%d", hdr_len + len);
+			return NCSCC_RC_FAILURE;
+		}
+		rc = mdtm_sendto(body, hdr_len + len, id);
+		free(body);
+		return rc;
+	}
+
+	memset(&server_addr, 0, sizeof(server_addr));
+	server_addr.family = AF_TIPC;
+	server_addr.addrtype = TIPC_ADDR_ID;
+	server_addr.addr.id = id;
+
+	iov[0].iov_base = hdr;
+	iov[0].iov_len = hdr_len;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = cnt + 1;
+
+	m_MDS_LOG_INFO("MDTM: TIPC Sending Len=%d\n", hdr_len + len);
+
+	send_len = sendmsg(tipc_cb.BSRsock, &msg, 0);
+	if (send_len == (hdr_len + len)) {
+		m_MDS_LOG_INFO("MDTM: Successfully sent message");
+		return NCSCC_RC_SUCCESS;
+	} else if (send_len == -1) {
+		m_MDS_LOG_ERR("MDTM: Failed to send message err :%s", strerror(errno));
+		return NCSCC_RC_FAILURE;
+	} else {
+		m_MDS_LOG_ERR("MDTM: Failed to send message send_len :%zd", send_len);
+		return NCSCC_RC_FAILURE;
+	}
+}
+
 /*********************************************************
 
   Function NAME: mdtm_mcast_sendto
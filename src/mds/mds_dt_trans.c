@@ -44,11 +44,14 @@
 
 #define MDTM_MAX_SEND_PKT_SIZE_TCP   (MDS_DIRECT_BUF_MAXSIZE+SUM_MDS_HDR_PLUS_MDTM_HDR_PLUS_LEN_TCP)	/* Includes the 30 header bytes(2+8+20) */
 
+#define MDTM_MAX_SEND_IOV_TCP    32	/* Header plus USRBUF segments sent with one sendmsg() */
+
 uint32_t mdtm_global_frag_num_tcp;
 extern struct pollfd pfd[2];
 extern pid_t mdtm_pid;
 
 static uint32_t mds_mdtm_process_recvdata(uint32_t rcv_bytes, uint8_t *buffer);
+static void mds_mdtm_process_recvdata_locked(uint32_t rcv_bytes, uint8_t *buffer);
 
 /**
  * Function contains the logic to add the message to the queue based on counter
@@ -72,6 +75,59 @@ uint32_t mds_sock_send(uint8_t *tcp_buffer, uint32_t bufflen)
 	return NCSCC_RC_SUCCESS;
 }
 
+/**
+ * Function contains the logic to send a message header followed by the
+ * first "len" octets of a USRBUF chain, gathered by sendmsg() straight from
+ * the USRBUF payloads. A chain of too many segments is flattened instead.
+ *
+ * @param hdr hdr_len usrbuf len
+ *
+ * @return NCSCC_RC_SUCCESS
+ * @return NCSCC_RC_FAILURE
+ *
+ */
+static uint32_t mds_sock_send_usrbuf(uint8_t *hdr, uint32_t hdr_len, USRBUF *usrbuf, uint32_t len)
+{
+	struct iovec iov[MDTM_MAX_SEND_IOV_TCP];
+	struct msghdr msg;
+	ssize_t send_len;
+	int cnt;
+
+	cnt = m_MMGR_IOVEC(usrbuf, len, &iov[1], MDTM_MAX_SEND_IOV_TCP - 1);
+	if (cnt < 0) {
+		uint32_t rc;
+		uint8_t *body = malloc(hdr_len + len);
+
+		if (body == NULL) {
+			LOG_ER("Failed to allocate %u octets for send", hdr_len + len);
+			return NCSCC_RC_FAILURE;
+		}
+		memcpy(body, hdr, hdr_len);
+		if (m_MMGR_COPY_MID_DATA(usrbuf, 0, len, body + hdr_len) == NULL) {
+			free(body);
+			return NCSCC_RC_FAILURE;
+		}
+		rc = mds_sock_send(body, hdr_len + len);
+		free(body);
+		return rc;
+	}
+
+	iov[0].iov_base = hdr;
+	iov[0].iov_len = hdr_len;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = cnt + 1;
+
+	send_len = sendmsg(tcp_cb->DBSRsock, &msg, MSG_NOSIGNAL);
+
+	/* message send failed */
+	if ((send_len == -1) || (send_len != (hdr_len + len))) {
+		LOG_ER("Failed to Send  Message bufflen :%d err :%s", hdr_len + len, strerror(errno));
+		return NCSCC_RC_FAILURE;
+	}
+	return NCSCC_RC_SUCCESS;
+}
+
 /**
  * Function contains the logic to add the header to the sending message
  *
@@ -234,7 +290,6 @@ static uint32_t mdtm_frag_and_send_tcp(MDTM_SEND_REQ *req, uint32_t seq_num, MDS
 	USRBUF *usrbuf;
 	uint32_t len = 0;
 	uint16_t len_buf = 0;
-	uint8_t *p8;
 	uint16_t i = 1;
 	uint16_t frag_val = 0;
 	uint32_t sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp;
@@ -292,74 +347,54 @@ static uint32_t mdtm_frag_and_send_tcp(MDTM_SEND_REQ *req, uint32_t seq_num, MDS
 			frag_val = NO_FRAG_BIT | i;
 		}
 		{
-			uint8_t *body = NULL;
-			body = calloc(1, len_buf);
+			/* Headers only; the fragment data is sent from the USRBUF chain */
+			uint8_t hdr[sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp];
 			if (i == 1) {
-				p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf,
-								  (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp),
-								  (char *)
-								  (body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp));
-
-				if (p8 != (body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp))
-					memcpy((body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp), p8, (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp));
-
-				if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr_tcp(body, req, len_buf)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_mds_hdr_tcp(hdr, req, len_buf)) {
 					m_MDS_LOG_ERR("MDTM: frg MDS hdr addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 
-				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr_tcp((body + 24), len_buf, seq_num, frag_val)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr_tcp((hdr + 24), len_buf, seq_num, frag_val)) {
 					m_MDS_LOG_ERR("MDTM: Frag hdr addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 				m_MDS_LOG_DBG("MDTM: Sending msg with Service Seqno=%d, Fragment Seqnum=%d, frag_num=%d,to Dest_id=<0x%08x:%u>",
 				     req->svc_seq_num, seq_num, frag_val, id.node_id, id.process_id);
 
-				if (NCSCC_RC_SUCCESS != mds_sock_send(body, len_buf)) {
+				if (NCSCC_RC_SUCCESS != mds_sock_send_usrbuf(hdr, sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp, usrbuf,
+									     len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp)) {
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 
 				m_MMGR_REMOVE_FROM_START(&usrbuf, len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp);
-				free(body);
 				len = len - (len_buf - sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp);
 			} else {
-				p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf, len_buf - MDTM_FRAG_HDR_PLUS_LEN_2_TCP,
-								  (char *)(body + MDTM_FRAG_HDR_PLUS_LEN_2_TCP));
-				if (p8 != (body + MDTM_FRAG_HDR_PLUS_LEN_2_TCP))
-					memcpy((body + MDTM_FRAG_HDR_PLUS_LEN_2_TCP), p8,
-					       len_buf - MDTM_FRAG_HDR_PLUS_LEN_2_TCP);
-
-				if (NCSCC_RC_SUCCESS != mdtm_fill_frag_hdr_tcp(body, req, len_buf)) {
+				if (NCSCC_RC_SUCCESS != mdtm_fill_frag_hdr_tcp(hdr, req, len_buf)) {
 					m_MDS_LOG_ERR("MDTM: Frag hdr addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 
-				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr_tcp((body + 24), len_buf, seq_num, frag_val)) {
+				if (NCSCC_RC_SUCCESS != mdtm_add_frag_hdr_tcp((hdr + 24), len_buf, seq_num, frag_val)) {
 					m_MDS_LOG_ERR("MDTM: Frag hde addition failed\n");
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 				m_MDS_LOG_DBG
 				    ("MDTM: Sending message with Service Seqno=%d, Fragment Seqnum=%d, frag_num=%d, TO Dest_id=<0x%08x:%u>",
 				     req->svc_seq_num, seq_num, frag_val, id.node_id, id.process_id);
 
-				if (NCSCC_RC_SUCCESS !=	mds_sock_send(body, len_buf)) {
+				if (NCSCC_RC_SUCCESS != mds_sock_send_usrbuf(hdr, MDTM_FRAG_HDR_PLUS_LEN_2_TCP, usrbuf,
+									     len_buf - MDTM_FRAG_HDR_PLUS_LEN_2_TCP)) {
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_FAILURE;
 				}
 
 				m_MMGR_REMOVE_FROM_START(&usrbuf, (len_buf - MDTM_FRAG_HDR_PLUS_LEN_2_TCP));
-				free(body);
 				len = len - (len_buf - MDTM_FRAG_HDR_PLUS_LEN_2_TCP);
 				if (len == 0)
 					break;
@@ -492,32 +527,23 @@ uint32_t mds_mdtm_send_tcp(MDTM_SEND_REQ *req)
 					return status;
 
 				} else {
-					uint8_t *p8;
-					uint8_t *body = NULL;
-					body = calloc(1, len + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp);
-
-					p8 = (uint8_t *)m_MMGR_DATA_AT_START(usrbuf, len, (char *)
-									  (body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp));
-
-					if (p8 != (body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp))
-						memcpy((body + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp), p8, len);
+					/* Headers only; the data is sent from the USRBUF chain */
+					uint8_t hdr[sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp];
 
 					if (NCSCC_RC_SUCCESS !=
-					    mdtm_add_mds_hdr_tcp(body, req,
+					    mdtm_add_mds_hdr_tcp(hdr, req,
 								 (len + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp))) {
 						m_MDS_LOG_ERR("MDTM: Unable to add the mds Hdr to the send msg\n");
 						m_MMGR_FREE_BUFR_LIST(usrbuf);
-						free(body);
 						return NCSCC_RC_FAILURE;
 					}
 
 					if (NCSCC_RC_SUCCESS !=
-					    mdtm_add_frag_hdr_tcp((body + 24),
+					    mdtm_add_frag_hdr_tcp((hdr + 24),
 								  (len + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp),
 								  frag_seq_num, 0)) {
 						m_MDS_LOG_ERR("MDTM: Unable to add the frag Hdr to the send msg\n");
 						m_MMGR_FREE_BUFR_LIST(usrbuf);
-						free(body);
 						return NCSCC_RC_FAILURE;
 					}
 
@@ -525,14 +551,13 @@ uint32_t mds_mdtm_send_tcp(MDTM_SEND_REQ *req)
 					    ("MDTM: Sending message with Service Seqno=%d, TO Dest_id=<0x%08x:%u> ",
 					     req->svc_seq_num, id.node_id, id.process_id);
 
-					if (NCSCC_RC_SUCCESS != mds_sock_send(body, (len + sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp))) {
+					if (NCSCC_RC_SUCCESS != mds_sock_send_usrbuf(hdr, sum_mds_hdr_plus_mdtm_hdr_plus_len_tcp,
+										     usrbuf, len)) {
 						m_MDS_LOG_ERR("MDTM: Unable to send the msg \n");
 						m_MMGR_FREE_BUFR_LIST(usrbuf);
-						free(body);
 						return NCSCC_RC_FAILURE;
 					}
 					m_MMGR_FREE_BUFR_LIST(usrbuf);
-					free(body);
 					return NCSCC_RC_SUCCESS;
 				}
 			}
@@ -649,7 +674,7 @@ void mdtm_process_poll_recv_data_tcp(void)
 					return;
 				} else if (local_len_buf == recd_bytes) {
 					/* Call the common rcv function */
-					mds_mdtm_process_recvdata(tcp_cb->buff_total_len, tcp_cb->buffer);
+					mds_mdtm_process_recvdata_locked(tcp_cb->buff_total_len, tcp_cb->buffer);
 					tcp_cb->bytes_tb_read = 0;
 					tcp_cb->buff_total_len = 0;
 					tcp_cb->num_by_read_for_len_buff = 0;
@@ -715,7 +740,7 @@ void mdtm_process_poll_recv_data_tcp(void)
 				return;
 			} else if (tcp_cb->buff_total_len == recd_bytes) {
 				/* Call the common rcv function */
-				mds_mdtm_process_recvdata(tcp_cb->buff_total_len, tcp_cb->buffer);
+				mds_mdtm_process_recvdata_locked(tcp_cb->buff_total_len, tcp_cb->buffer);
 				tcp_cb->bytes_tb_read = 0;
 				tcp_cb->buff_total_len = 0;
 				tcp_cb->num_by_read_for_len_buff = 0;
@@ -748,7 +773,7 @@ void mdtm_process_poll_recv_data_tcp(void)
 			return;
 		} else if (tcp_cb->bytes_tb_read == recd_bytes) {
 			/* Call the common rcv function */
-			mds_mdtm_process_recvdata(tcp_cb->buff_total_len, tcp_cb->buffer);
+			mds_mdtm_process_recvdata_locked(tcp_cb->buff_total_len, tcp_cb->buffer);
 			tcp_cb->bytes_tb_read = 0;
 			tcp_cb->buff_total_len = 0;
 			tcp_cb->num_by_read_for_len_buff = 0;
@@ -791,15 +816,16 @@ uint32_t mdtm_process_recv_events_tcp(void)
 		pollres = poll(pfd, 2, MDTM_TCP_POLL_TIMEOUT);
 
 		if (pollres > 0) {	/* Check for EINTR and discard */
-			osaf_mutex_lock_ordie(&gl_mds_library_mutex);
-
-			/* Check for Socket Read operation */
+			/* Check for Socket Read operation. The socket is only read
+			   by this thread, the library mutex is taken when a complete
+			   message has been received. */
 			if (pfd[0].revents & POLLIN) {
 				m_MDS_LOG_INFO("MDTM: Processing pollin events\n");
 				mdtm_process_poll_recv_data_tcp();
 			}
 
 			if (pfd[1].revents & POLLIN) {
+				osaf_mutex_lock_ordie(&gl_mds_library_mutex);
 				m_MDS_LOG_INFO("MDTM: Processing Timer mailbox events\n");
 
 				/* Check if destroy-event has been processed */
@@ -813,12 +839,26 @@ uint32_t mdtm_process_recv_events_tcp(void)
 					   pthread-cancel & pthread-join, do not get blocked. */
 					return NCSCC_RC_SUCCESS;	/* Thread quit */
 				}
+				osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
 			}
-			osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
 		}
 	}
 }
 
+/**
+ * Process a complete message read from the socket, with the MDS library
+ * mutex held.
+ *
+ * @param rcv_bytes, buff_in
+ *
+ */
+static void mds_mdtm_process_recvdata_locked(uint32_t rcv_bytes, uint8_t *buff_in)
+{
+	osaf_mutex_lock_ordie(&gl_mds_library_mutex);
+	mds_mdtm_process_recvdata(rcv_bytes, buff_in);
+	osaf_mutex_unlock_ordie(&gl_mds_library_mutex);
+}
+
 /**
  * Rcv thread processing
  *
@@ -2538,13 +2538,13 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
  again:
 	posix_mq_get_failure = false;
 
-	if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		if (timeout == 0) {
 			TRACE_2("ERR_TIMEOUT: Message get failed "); 
 			rc = SA_AIS_ERR_TIMEOUT;
 			goto done;
 		} else if (timeout == SA_TIME_MAX) {
-			TRACE_4("ERR_RESOURCES: Message get failed due to native msgrcv error"); 
+			TRACE_4("ERR_RESOURCES: Message get failed due to native queue error"); 
 			rc = SA_AIS_ERR_NO_RESOURCES;
 			goto done;
 		} else {
@@ -2576,7 +2576,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 		}
 
 		rc = SA_AIS_ERR_NO_RESOURCES;
-		TRACE_4("ERR_RESOURCES: Message get failed due to native msgrcv erro");
+		TRACE_4("ERR_RESOURCES: Message get failed due to native queue error");
 		goto done;
 	}
 
@@ -2597,7 +2597,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 				mq_req_snd.info.send.i_msg = &mq_msg;
 				mq_req_snd.info.send.i_mtype = 2;
 
-				if (ncs_os_posix_mq(&mq_req_snd) != NCSCC_RC_SUCCESS) {
+				if (m_MQSV_OS_MQ(&mq_req_snd) != NCSCC_RC_SUCCESS) {
 					TRACE_4("ERR_RESOURCES: Unable to put back the genuine message in msgget call");
 					rc = SA_AIS_ERR_NO_RESOURCES;
 					goto done;
@@ -2640,7 +2640,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 			mq_req_snd.info.send.i_msg = &mq_msg;
 			mq_req_snd.info.send.i_mtype = 1;
 
-			if (ncs_os_posix_mq(&mq_req_snd) != NCSCC_RC_SUCCESS) {
+			if (m_MQSV_OS_MQ(&mq_req_snd) != NCSCC_RC_SUCCESS) {
 				TRACE_4("ERR_RESOURCES: Unable to put back the stop Tmr message"
 					" which is meant for a different msgget");
 				rc = SA_AIS_ERR_NO_RESOURCES;
@@ -2734,7 +2734,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 			mq_req.info.send.i_msg = &mq_msg;
 			mq_req.info.send.i_mtype = 2;
 
-			if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+			if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 				TRACE_4("Unable to put back the genuine message in msgget call");
 				/* TBD: Don't know what to do */
 			}
@@ -2848,7 +2848,7 @@ SaAisErrorT mqa_receive_message(SaMsgQueueHandleT queueHandle,
 		mq_req.info.send.i_msg = &mq_msg;
 		mq_req.info.send.i_mtype = 2;
 
-		if (ncs_os_posix_mq(&mq_req) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 			TRACE_4("Unable to put back the genuine message in msgget call");
 			/* TBD: Don't know what to do */
 		}
@@ -3073,7 +3073,7 @@ SaAisErrorT saMsgMessageCancel(SaMsgQueueHandleT queueHandle)
 	/* Send the message from the Queue using the OS call ->ncs_os_mq() */
 
 	for (i = 0; i < cancel_message_count; i++) {
-		if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 			TRACE_2("ERR_TRY_AGAIN: Unable to put the cancel message in the queue");
 			rc = SA_AIS_ERR_TRY_AGAIN;
 		}
@@ -5153,7 +5153,7 @@ static void msgget_timer_expired(void *arg)
 	mq_req.info.send.mqd = (*cancel_req)->queueHandle;
 	mq_req.info.send.i_mtype = 1;
 
-	if ((rc = m_NCS_OS_POSIX_MQ(&mq_req)) != NCSCC_RC_SUCCESS) {
+	if ((rc = m_MQSV_OS_MQ(&mq_req)) != NCSCC_RC_SUCCESS) {
 		TRACE_4("Unable to put the cancel message in the queue");
 	}
 
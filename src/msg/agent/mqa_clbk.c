@@ -1120,7 +1120,7 @@ void mqa_queue_reader(NCSCONTEXT arg)
 	mq_req.info.recv.dataprio = 0;
 
 	while (1) {
-		if ((existing_msg_count == 0) && (m_NCS_OS_POSIX_MQ(&mq_req) == NCSCC_RC_FAILURE))
+		if ((existing_msg_count == 0) && (m_MQSV_OS_MQ(&mq_req) == NCSCC_RC_FAILURE))
 			break;
 
 		if (m_NCS_LOCK(&mqa_cb->cb_lock, NCS_LOCK_WRITE) != NCSCC_RC_SUCCESS)
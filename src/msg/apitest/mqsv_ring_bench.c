@@ -0,0 +1,163 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+
+  DESCRIPTION: Measures the message throughput from one process to another
+               through the MQSv queue rings and through SysV message queues,
+               which the queue rings replaced. No MQSv service is needed.
+
+  Usage: mqsvringbench [messages [message size]]
+
+  The sender cycles through the four SAF priorities. The receiver checks
+  that the messages of each priority arrive in order.
+
+******************************************************************************/
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "base/ncs_osprm.h"
+#include "msg/mqsv_ring.h"
+
+#define BENCH_QUEUE_SIZE (16 * 1024)	/* default msgmnb */
+#define BENCH_PRIORITIES 4
+
+typedef uint32_t (*BENCH_MQ)(NCS_OS_POSIX_MQ_REQ_INFO *req);
+
+static double bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int bench_receive(BENCH_MQ mq, NCS_OS_POSIX_MQD mqd, uint32_t count, uint32_t size)
+{
+	NCS_OS_POSIX_MQ_REQ_INFO req;
+	NCS_OS_MQ_MSG *msg = malloc(sizeof(NCS_OS_MQ_MSG));
+	uint32_t next[BENCH_PRIORITIES] = { 0, 1, 2, 3 };
+	uint32_t i, seq, prio;
+
+	for (i = 0; i < count; i++) {
+		memset(&req, 0, sizeof(req));
+		req.req = NCS_OS_POSIX_MQ_REQ_MSG_RECV;
+		req.info.recv.mqd = mqd;
+		req.info.recv.i_msg = msg;
+		req.info.recv.datalen = size;
+		req.info.recv.i_mtype = -7;
+		if (mq(&req) != NCSCC_RC_SUCCESS) {
+			fprintf(stderr, "receive failed\n");
+			return 1;
+		}
+		memcpy(&seq, msg->data, sizeof(seq));
+		prio = seq % BENCH_PRIORITIES;
+		if (msg->ll_hdr != (NCS_OS_MQ_MSG_LL_HDR)(prio + 3) || seq != next[prio]) {
+			fprintf(stderr, "message %u out of order\n", seq);
+			return 1;
+		}
+		next[prio] += BENCH_PRIORITIES;
+	}
+	free(msg);
+	return 0;
+}
+
+static double bench_run(const char *name, BENCH_MQ mq, uint32_t count, uint32_t size)
+{
+	NCS_OS_POSIX_MQ_REQ_INFO req;
+	NCS_OS_MQ_MSG *msg = calloc(1, sizeof(NCS_OS_MQ_MSG));
+	char qname[64];
+	NCS_OS_POSIX_MQD mqd;
+	double start, elapsed;
+	pid_t pid;
+	int status;
+	uint32_t i;
+
+	snprintf(qname, sizeof(qname), "mqsvringbench_%s", name);
+	memset(&req, 0, sizeof(req));
+	req.req = NCS_OS_POSIX_MQ_REQ_OPEN;
+	req.info.open.qname = qname;
+	req.info.open.node = getpid();
+	req.info.open.iflags = O_CREAT;
+	req.info.open.attr.mq_msgsize = BENCH_QUEUE_SIZE;
+	if (mq(&req) != NCSCC_RC_SUCCESS) {
+		fprintf(stderr, "%s: queue creation failed\n", name);
+		exit(EXIT_FAILURE);
+	}
+	mqd = req.info.open.o_mqd;
+
+	start = bench_now();
+	pid = fork();
+	if (pid == 0)
+		_exit(bench_receive(mq, mqd, count, size));
+
+	for (i = 0; i < count; i++) {
+		memcpy(msg->data, &i, sizeof(i));
+		memset(&req, 0, sizeof(req));
+		req.req = NCS_OS_POSIX_MQ_REQ_MSG_SEND;
+		req.info.send.mqd = mqd;
+		req.info.send.datalen = size;
+		req.info.send.i_msg = msg;
+		req.info.send.i_mtype = i % BENCH_PRIORITIES + 3;
+		if (mq(&req) != NCSCC_RC_SUCCESS) {
+			fprintf(stderr, "%s: send failed\n", name);
+			kill(pid, SIGKILL);
+			break;
+		}
+	}
+	waitpid(pid, &status, 0);
+	elapsed = bench_now() - start;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		fprintf(stderr, "%s: receiver failed\n", name);
+
+	memset(&req, 0, sizeof(req));
+	req.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
+	req.info.close.mqd = mqd;
+	mq(&req);
+	memset(&req, 0, sizeof(req));
+	req.req = NCS_OS_POSIX_MQ_REQ_UNLINK;
+	req.info.unlink.qname = (uint8_t *)qname;
+	req.info.unlink.node = getpid();
+	mq(&req);
+	free(msg);
+
+	printf("%-6s %u messages of %u bytes: %.0f messages/s\n", name, count, size, count / elapsed);
+	return count / elapsed;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t count = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+	uint32_t size = argc > 2 ? strtoul(argv[2], NULL, 0) : 256;
+	double sysv, ring;
+
+	if (size < sizeof(uint32_t) || size > NCS_OS_MQ_MAX_PAYLOAD) {
+		fprintf(stderr, "message size must be %zu to %u bytes\n", sizeof(uint32_t), NCS_OS_MQ_MAX_PAYLOAD);
+		return EXIT_FAILURE;
+	}
+
+	sysv = bench_run("sysv", ncs_os_posix_mq, count, size);
+	ring = bench_run("ring", mqsv_ring_mq, count, size);
+	printf("ring/sysv: %.2f\n", ring / sysv);
+	return EXIT_SUCCESS;
+}
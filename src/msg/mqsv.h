@@ -73,6 +73,7 @@
 
 /* From /leap/os_svcs/leap_basic/inc */
 #include "mqsv_common.h"
+#include "msg/mqsv_ring.h"
 #include "base/ncs_util.h"
 
 #endif  // MSG_MQSV_H_
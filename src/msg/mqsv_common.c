@@ -74,7 +74,7 @@ uint32_t mqsv_listenerq_msg_send(SaMsgQueueHandleT listenerHandle)
 	info.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	info.info.attr.i_mqd = listenerHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS)
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS)
 		return NCSCC_RC_FAILURE;
 
 	actual_qsize = info.info.attr.o_attr.mq_maxmsg;
@@ -88,7 +88,7 @@ uint32_t mqsv_listenerq_msg_send(SaMsgQueueHandleT listenerHandle)
 		/* Increase queue size so that its able to hold 5 such messages */
 		info.info.resize.i_newqsize = actual_qsize + 10000;
 
-		if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS)
+		if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS)
 			return NCSCC_RC_FAILURE;
 	}
 
@@ -102,7 +102,7 @@ uint32_t mqsv_listenerq_msg_send(SaMsgQueueHandleT listenerHandle)
 	info.info.send.i_msg = &mq_msg;
 	info.info.send.i_mtype = 1;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS)
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS)
 		return (NCSCC_RC_FAILURE);
 
 	return NCSCC_RC_SUCCESS;
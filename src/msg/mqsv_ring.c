@@ -0,0 +1,886 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION: This file contains the native message queues of MQSv, kept
+               in shared memory rings instead of SysV message queues.
+
+  The segment of a queue is named after its handle, so any process on the
+  node can map a queue from the handle alone. Each process keeps its own
+  mappings and maps a queue again when it has grown. The access mode of the
+  segments can be narrowed with MQSV_RING_MODE, and the lane sizes in a
+  segment are checked against the mapped bytes before they are used.
+
+  The ring lock is a robust mutex. A message is written before the tail of
+  its lane is moved and read before the head is moved, so a process dying
+  with the lock held leaves every lane consistent except for the message
+  counts, which the next process taking the lock counts again. The rings
+  survive a restart of MQND, which finds them again from the queue handles
+  in its checkpoint.
+
+  This file includes following routines:
+    mqsv_ring_mq
+    mqsv_ring_send
+    mqsv_ring_recover
+
+******************************************************************************/
+
+#include "msg/mqsv_ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "base/logtrace.h"
+
+/* The mapping of a queue in this process */
+typedef struct mqsv_ring_map {
+	struct mqsv_ring_map *next;
+	NCS_OS_POSIX_MQD mqd;
+	MQSV_RING_HDR *hdr;
+	uint64_t map_size;
+	uint32_t users;
+	bool stale;		/* destroyed or grown, unmapped when unused */
+} MQSV_RING_MAP;
+
+/* Each message is a length followed by the data, padded to 8 bytes */
+typedef struct mqsv_ring_rec {
+	uint32_t len;
+	uint32_t reserved;
+} MQSV_RING_REC;
+
+#define MQSV_RING_MAP_BUCKETS 64
+#define m_MQSV_RING_REC_SIZE(len) (sizeof(MQSV_RING_REC) + (((uint64_t)(len) + 7) & ~(uint64_t)7))
+
+static MQSV_RING_MAP *ring_maps[MQSV_RING_MAP_BUCKETS];
+static pthread_mutex_t ring_maps_lock = PTHREAD_MUTEX_INITIALIZER;
+static NCS_OS_POSIX_MQD ring_next_mqd;
+
+static uint32_t ring_destroy(NCS_OS_POSIX_MQD mqd);
+
+static void ring_name(NCS_OS_POSIX_MQD mqd, char *name, size_t size)
+{
+	snprintf(name, size, "/" MQSV_RING_NAME_FMT, mqd);
+}
+
+/* A message takes at most twice the bytes charged for it in a lane, so a
+   lane holds a full queue of any one type */
+static uint64_t ring_lane_size(uint32_t max_bytes)
+{
+	uint64_t size = 2 * (uint64_t)max_bytes;
+	long page = sysconf(_SC_PAGESIZE);
+
+	if (size == 0)
+		size = page;
+	return (size + page - 1) / page * page;
+}
+
+static uint64_t ring_map_size(uint64_t lane_size)
+{
+	return MQSV_RING_DATA_OFFSET + MQSV_RING_NUM_LANES * lane_size;
+}
+
+/* The sizes in a header are only trusted within the mapped bytes */
+static bool ring_valid(const MQSV_RING_HDR *hdr, uint64_t size)
+{
+	if (size < MQSV_RING_DATA_OFFSET || hdr->map_size > size)
+		return false;
+	return hdr->lane_size != 0 && hdr->lane_size % 8 == 0 &&
+	       hdr->lane_size <= (size - MQSV_RING_DATA_OFFSET) / MQSV_RING_NUM_LANES;
+}
+
+static uint8_t *ring_lane_data(MQSV_RING_HDR *hdr, uint32_t lane_no, uint64_t lane_size)
+{
+	return (uint8_t *)hdr + MQSV_RING_DATA_OFFSET + lane_no * lane_size;
+}
+
+static void ring_write(uint8_t *data, uint64_t size, uint64_t offset, const void *from, uint64_t len)
+{
+	uint64_t pos = offset % size;
+	uint64_t first = size - pos;
+
+	if (len <= first) {
+		memcpy(data + pos, from, len);
+	} else {
+		memcpy(data + pos, from, first);
+		memcpy(data, (const uint8_t *)from + first, len - first);
+	}
+}
+
+static void ring_read(const uint8_t *data, uint64_t size, uint64_t offset, void *to, uint64_t len)
+{
+	uint64_t pos = offset % size;
+	uint64_t first = size - pos;
+
+	if (len <= first) {
+		memcpy(to, data + pos, len);
+	} else {
+		memcpy(to, data + pos, first);
+		memcpy((uint8_t *)to + first, data, len - first);
+	}
+}
+
+/****************************************************************************
+ * Function Name: ring_repair
+ * Purpose: Counts the messages again after a process died holding the
+ *          ring lock. Lanes that can not be walked are emptied.
+ * Arguments: size - bytes mapped at hdr
+ ****************************************************************************/
+static void ring_repair(MQSV_RING_HDR *hdr, uint64_t size)
+{
+	uint32_t i;
+
+	if (hdr->resizing || !ring_valid(hdr, size)) {
+		LOG_WA("MQSv queue ring %s, messages discarded",
+		       hdr->resizing ? "resize interrupted" : "lanes outside of the mapping");
+		for (i = 0; i < MQSV_RING_NUM_LANES; i++)
+			hdr->lane[i].head = hdr->lane[i].tail;
+		hdr->resizing = 0;
+	}
+
+	hdr->num_msgs = 0;
+	hdr->num_bytes = 0;
+	for (i = 0; i < MQSV_RING_NUM_LANES; i++) {
+		MQSV_RING_LANE *lane = &hdr->lane[i];
+		uint8_t *data = ring_lane_data(hdr, i, hdr->lane_size);
+		uint64_t pos = lane->head;
+		uint32_t lost = lane->num_msgs;
+
+		lane->num_msgs = 0;
+		lane->num_bytes = 0;
+		if (lane->tail - lane->head > hdr->lane_size) {
+			/* the lane can not be walked, drop what it holds */
+			LOG_WA("MQSv queue ring lane %u oversized, %u messages discarded", i + 1, lost);
+			lane->head = lane->tail;
+			pos = lane->tail;
+		}
+		while (pos < lane->tail) {
+			MQSV_RING_REC rec;
+
+			ring_read(data, hdr->lane_size, pos, &rec, sizeof(rec));
+			if (m_MQSV_RING_REC_SIZE(rec.len) > lane->tail - pos) {
+				LOG_WA("MQSv queue ring lane %u corrupt, %u messages discarded", i + 1,
+				       lost > lane->num_msgs ? lost - lane->num_msgs : 0);
+				lane->head = lane->tail;
+				lane->num_msgs = 0;
+				lane->num_bytes = 0;
+				break;
+			}
+			lane->num_msgs++;
+			lane->num_bytes += m_MQSV_RING_MSG_BYTES(rec.len);
+			pos += m_MQSV_RING_REC_SIZE(rec.len);
+		}
+		hdr->num_msgs += lane->num_msgs;
+		hdr->num_bytes += lane->num_bytes;
+	}
+}
+
+/****************************************************************************
+ * Function Name: ring_get
+ * Purpose: Returns the mapping of a queue in this process, mapping the
+ *          queue if needed. The mapping is released with ring_put.
+ ****************************************************************************/
+static MQSV_RING_MAP *ring_get(NCS_OS_POSIX_MQD mqd)
+{
+	MQSV_RING_MAP **bucket = &ring_maps[mqd % MQSV_RING_MAP_BUCKETS];
+	MQSV_RING_MAP *map;
+	MQSV_RING_HDR *hdr;
+	char name[NAME_MAX];
+	struct stat st;
+	int fd;
+
+	pthread_mutex_lock(&ring_maps_lock);
+	for (map = *bucket; map != NULL; map = map->next) {
+		if (map->mqd == mqd && !map->stale) {
+			map->users++;
+			pthread_mutex_unlock(&ring_maps_lock);
+			return map;
+		}
+	}
+	pthread_mutex_unlock(&ring_maps_lock);
+
+	ring_name(mqd, name, sizeof(name));
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		TRACE_4("shm_open of %s failed: %s", name, strerror(errno));
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size < MQSV_RING_DATA_OFFSET) {
+		close(fd);
+		return NULL;
+	}
+	hdr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (hdr == MAP_FAILED) {
+		TRACE_4("mmap of %s failed: %s", name, strerror(errno));
+		return NULL;
+	}
+	if (hdr->magic != MQSV_RING_MAGIC || hdr->version != MQSV_RING_VERSION) {
+		TRACE_4("%s is not a message queue ring", name);
+		munmap(hdr, st.st_size);
+		return NULL;
+	}
+	if (!ring_valid(hdr, st.st_size)) {
+		LOG_ER("%s has lanes outside of its %llu bytes", name, (unsigned long long)st.st_size);
+		munmap(hdr, st.st_size);
+		return NULL;
+	}
+
+	map = malloc(sizeof(MQSV_RING_MAP));
+	if (map == NULL) {
+		munmap(hdr, st.st_size);
+		return NULL;
+	}
+	map->mqd = mqd;
+	map->hdr = hdr;
+	map->map_size = st.st_size;
+	map->users = 1;
+	map->stale = false;
+
+	pthread_mutex_lock(&ring_maps_lock);
+	map->next = *bucket;
+	*bucket = map;
+	pthread_mutex_unlock(&ring_maps_lock);
+	return map;
+}
+
+static void ring_put(MQSV_RING_MAP *map)
+{
+	MQSV_RING_MAP **pos;
+
+	pthread_mutex_lock(&ring_maps_lock);
+	if (--map->users == 0 && map->stale) {
+		for (pos = &ring_maps[map->mqd % MQSV_RING_MAP_BUCKETS]; *pos != map; pos = &(*pos)->next)
+			;
+		*pos = map->next;
+		munmap(map->hdr, map->map_size);
+		free(map);
+	}
+	pthread_mutex_unlock(&ring_maps_lock);
+}
+
+static void ring_invalidate(MQSV_RING_MAP *map)
+{
+	pthread_mutex_lock(&ring_maps_lock);
+	map->stale = true;
+	pthread_mutex_unlock(&ring_maps_lock);
+}
+
+/****************************************************************************
+ * Function Name: ring_lock
+ * Purpose: Takes the ring lock through a mapping covering the whole queue.
+ *          The mapping is replaced if the queue has grown.
+ * Return Value: 0 with the lock taken, -1 if the queue is gone. *pmap is
+ *               the mapping to release, NULL if there is none.
+ ****************************************************************************/
+static int ring_lock(MQSV_RING_MAP **pmap)
+{
+	MQSV_RING_MAP *map = *pmap;
+	MQSV_RING_MAP *fresh;
+	int rc;
+
+	for (;;) {
+		rc = pthread_mutex_lock(&map->hdr->lock);
+		if (rc == EOWNERDEAD) {
+			ring_repair(map->hdr, map->map_size);
+			pthread_mutex_consistent(&map->hdr->lock);
+		} else if (rc != 0) {
+			LOG_ER("MQSv queue ring lock failed: %s", strerror(rc));
+			return -1;
+		}
+
+		if (map->hdr->destroyed) {
+			pthread_mutex_unlock(&map->hdr->lock);
+			ring_invalidate(map);
+			return -1;
+		}
+		/* the file may be larger after a failed resize */
+		if (map->hdr->map_size <= map->map_size) {
+			if (ring_valid(map->hdr, map->map_size))
+				return 0;
+			LOG_ER("MQSv queue ring %u has lanes outside of its mapping", map->mqd);
+			pthread_mutex_unlock(&map->hdr->lock);
+			return -1;
+		}
+
+		pthread_mutex_unlock(&map->hdr->lock);
+		ring_invalidate(map);
+		fresh = ring_get(map->mqd);
+		ring_put(map);
+		*pmap = map = fresh;
+		if (map == NULL)
+			return -1;
+	}
+}
+
+/* Waits for a message to be sent or received, with the lock taken */
+static int ring_wait(MQSV_RING_MAP **pmap)
+{
+	MQSV_RING_HDR *hdr = (*pmap)->hdr;
+	int rc;
+
+	hdr->num_waiters++;
+	rc = pthread_cond_wait(&hdr->cond, &hdr->lock);
+	if (rc == EOWNERDEAD) {
+		ring_repair(hdr, (*pmap)->map_size);
+		pthread_mutex_consistent(&hdr->lock);
+	}
+	if (hdr->num_waiters > 0)
+		hdr->num_waiters--;
+
+	if (hdr->destroyed || !ring_valid(hdr, (*pmap)->map_size)) {
+		pthread_mutex_unlock(&hdr->lock);
+		return ring_lock(pmap);
+	}
+	return 0;
+}
+
+static void ring_unlock(MQSV_RING_HDR *hdr, bool changed)
+{
+	if (changed && hdr->num_waiters > 0)
+		pthread_cond_broadcast(&hdr->cond);
+	pthread_mutex_unlock(&hdr->lock);
+}
+
+/* The access mode of new rings, MQSV_RING_MODE if set and valid */
+static mode_t ring_mode(void)
+{
+	const char *value = getenv("MQSV_RING_MODE");
+	unsigned long mode;
+	char *end;
+
+	if (value == NULL || value[0] == '\0')
+		return MQSV_RING_PROTECTION_FLAGS;
+	errno = 0;
+	mode = strtoul(value, &end, 8);
+	if (errno != 0 || *end != '\0' || mode > 0777 || (mode & 0600) != 0600) {
+		LOG_WA("MQSv queue ring mode %s invalid, using %o", value, MQSV_RING_PROTECTION_FLAGS);
+		return MQSV_RING_PROTECTION_FLAGS;
+	}
+	return (mode_t)mode;
+}
+
+/* Gives the group of OpenSAF, if there is one, the ring and sets its mode */
+static int ring_set_owner(int fd)
+{
+	const char *group = getenv("OPENSAF_GROUP");
+	struct group *gr;
+
+	if (group != NULL && group[0] != '\0') {
+		gr = getgrnam(group);
+		if (gr == NULL)
+			LOG_WA("MQSv queue ring group %s not found", group);
+		else if (fchown(fd, (uid_t)-1, gr->gr_gid) != 0)
+			return -1;
+	}
+	return fchmod(fd, ring_mode());
+}
+
+/* The handle of a queue is kept in a file named after the queue */
+static uint32_t ring_read_file(const char *filename, NCS_OS_POSIX_MQD *mqd)
+{
+	FILE *file = fopen(filename, "r");
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	if (file == NULL)
+		return NCSCC_RC_FAILURE;
+	if (fscanf(file, "%u", mqd) == 1 && *mqd != 0)
+		rc = NCSCC_RC_SUCCESS;
+	fclose(file);
+	return rc;
+}
+
+/****************************************************************************
+ * Function Name: ring_create
+ * Purpose: Creates the ring of a new queue. A queue created before with
+ *          the same name is destroyed, as a SysV queue with the same key
+ *          was.
+ ****************************************************************************/
+static uint32_t ring_create(const char *filename, uint32_t max_bytes, NCS_OS_POSIX_MQD *o_mqd)
+{
+	pthread_mutexattr_t mattr;
+	pthread_condattr_t cattr;
+	MQSV_RING_HDR *hdr;
+	NCS_OS_POSIX_MQD mqd;
+	uint64_t lane_size = ring_lane_size(max_bytes);
+	uint64_t map_size = ring_map_size(lane_size);
+	char name[NAME_MAX];
+	FILE *file;
+	int fd;
+
+	if (ring_read_file(filename, &mqd) == NCSCC_RC_SUCCESS)
+		ring_destroy(mqd);
+
+	/* Handles are not reused while a ring with the handle exists */
+	for (;;) {
+		pthread_mutex_lock(&ring_maps_lock);
+		if (ring_next_mqd == 0)
+			ring_next_mqd = (NCS_OS_POSIX_MQD)time(NULL) ^ ((NCS_OS_POSIX_MQD)getpid() << 16);
+		mqd = ring_next_mqd++;
+		pthread_mutex_unlock(&ring_maps_lock);
+		if (mqd == 0)
+			continue;
+
+		ring_name(mqd, name, sizeof(name));
+		fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, MQSV_RING_PROTECTION_FLAGS);
+		if (fd >= 0)
+			break;
+		if (errno != EEXIST) {
+			LOG_ER("shm_open of %s failed: %s", name, strerror(errno));
+			return NCSCC_RC_FAILURE;
+		}
+	}
+
+	/* The agents in application processes receive from the queue, so
+	   they need write access. The mode is set again as the umask applies
+	   to shm_open. */
+	if (ring_set_owner(fd) != 0 || ftruncate(fd, map_size) != 0) {
+		LOG_ER("Sizing %s failed: %s", name, strerror(errno));
+		close(fd);
+		shm_unlink(name);
+		return NCSCC_RC_FAILURE;
+	}
+	hdr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (hdr == MAP_FAILED) {
+		LOG_ER("mmap of %s failed: %s", name, strerror(errno));
+		shm_unlink(name);
+		return NCSCC_RC_FAILURE;
+	}
+
+	memset(hdr, 0, sizeof(MQSV_RING_HDR));
+	pthread_mutexattr_init(&mattr);
+	pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&mattr, PTHREAD_MUTEX_ROBUST);
+	pthread_mutex_init(&hdr->lock, &mattr);
+	pthread_mutexattr_destroy(&mattr);
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+	pthread_cond_init(&hdr->cond, &cattr);
+	pthread_condattr_destroy(&cattr);
+	hdr->map_size = map_size;
+	hdr->lane_size = lane_size;
+	hdr->max_bytes = max_bytes;
+	hdr->version = MQSV_RING_VERSION;
+	__atomic_store_n(&hdr->magic, MQSV_RING_MAGIC, __ATOMIC_RELEASE);
+	munmap(hdr, map_size);
+
+	file = fopen(filename, "w");
+	if (file == NULL) {
+		shm_unlink(name);
+		return NCSCC_RC_FAILURE;
+	}
+	fprintf(file, "%u\n", mqd);
+	if (fclose(file) != 0) {
+		shm_unlink(name);
+		return NCSCC_RC_FAILURE;
+	}
+
+	TRACE("Queue ring %s created, %u bytes", name, max_bytes);
+	*o_mqd = mqd;
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Function Name: ring_destroy
+ * Purpose: Removes a queue. Processes blocked on the queue return failure.
+ ****************************************************************************/
+static uint32_t ring_destroy(NCS_OS_POSIX_MQD mqd)
+{
+	MQSV_RING_MAP *map = ring_get(mqd);
+	char name[NAME_MAX];
+
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) != 0) {
+		if (map != NULL)
+			ring_put(map);
+		return NCSCC_RC_FAILURE;
+	}
+
+	map->hdr->destroyed = 1;
+	pthread_cond_broadcast(&map->hdr->cond);
+	pthread_mutex_unlock(&map->hdr->lock);
+	ring_invalidate(map);
+	ring_put(map);
+
+	ring_name(mqd, name, sizeof(name));
+	if (shm_unlink(name) != 0)
+		return NCSCC_RC_FAILURE;
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Function Name: ring_resize
+ * Purpose: Sets the queue size. The lanes are moved apart when the queue
+ *          grows beyond what they hold, the other processes map the queue
+ *          again when they next take the lock.
+ ****************************************************************************/
+static uint32_t ring_resize(NCS_OS_POSIX_MQD mqd, uint32_t max_bytes)
+{
+	MQSV_RING_MAP *map = ring_get(mqd);
+	MQSV_RING_HDR *hdr, *grown;
+	uint64_t old_size, lane_size, map_size;
+	uint8_t *tmp;
+	char name[NAME_MAX];
+	uint32_t rc = NCSCC_RC_FAILURE;
+	int i, fd;
+
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) != 0)
+		goto done;
+	hdr = map->hdr;
+
+	lane_size = ring_lane_size(max_bytes);
+	if (lane_size <= hdr->lane_size) {
+		hdr->max_bytes = max_bytes;
+		ring_unlock(hdr, true);
+		rc = NCSCC_RC_SUCCESS;
+		goto done;
+	}
+
+	old_size = hdr->lane_size;
+	for (i = 0; i < MQSV_RING_NUM_LANES; i++) {
+		if (hdr->lane[i].tail - hdr->lane[i].head > old_size) {
+			LOG_ER("MQSv queue ring %u lane %d corrupt, not resized", mqd, i + 1);
+			ring_unlock(hdr, false);
+			goto done;
+		}
+	}
+	map_size = ring_map_size(lane_size);
+	tmp = malloc(old_size);
+	if (tmp == NULL) {
+		ring_unlock(hdr, false);
+		goto done;
+	}
+
+	ring_name(mqd, name, sizeof(name));
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0 || ftruncate(fd, map_size) != 0) {
+		LOG_ER("Resizing %s failed: %s", name, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		free(tmp);
+		ring_unlock(hdr, false);
+		goto done;
+	}
+	grown = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (grown == MAP_FAILED) {
+		LOG_ER("mmap of %s failed: %s", name, strerror(errno));
+		free(tmp);
+		ring_unlock(hdr, false);
+		goto done;
+	}
+
+	/* Lane i only moves over lanes above it, which are already moved */
+	hdr->resizing = 1;
+	for (i = MQSV_RING_NUM_LANES - 1; i >= 0; i--) {
+		MQSV_RING_LANE *lane = &grown->lane[i];
+		uint64_t used = lane->tail - lane->head;
+
+		ring_read(ring_lane_data(grown, i, old_size), old_size, lane->head, tmp, used);
+		memcpy(ring_lane_data(grown, i, lane_size), tmp, used);
+		lane->head = 0;
+		lane->tail = used;
+	}
+	hdr->lane_size = lane_size;
+	hdr->max_bytes = max_bytes;
+	hdr->map_size = map_size;
+	__atomic_store_n(&hdr->resizing, 0, __ATOMIC_RELEASE);
+	ring_unlock(hdr, true);
+
+	munmap(grown, map_size);
+	free(tmp);
+	TRACE("Queue ring %s resized to %u bytes", name, max_bytes);
+	rc = NCSCC_RC_SUCCESS;
+ done:
+	if (map != NULL)
+		ring_put(map);
+	return rc;
+}
+
+/****************************************************************************
+ * Function Name: mqsv_ring_send
+ * Purpose: Copies a message into the lane of its type.
+ * Arguments: mtype - message type 1 to 6, lower types are received first
+ *            wait - wait for room in the queue
+ * Return Value: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ ****************************************************************************/
+uint32_t mqsv_ring_send(NCS_OS_POSIX_MQD mqd, const void *data, uint32_t len, uint32_t mtype, bool wait)
+{
+	MQSV_RING_MAP *map;
+	MQSV_RING_HDR *hdr;
+	MQSV_RING_LANE *lane;
+	MQSV_RING_REC rec;
+	uint64_t rec_size = m_MQSV_RING_REC_SIZE(len);
+	uint32_t bytes = m_MQSV_RING_MSG_BYTES(len);
+	uint8_t *lane_data;
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	/* A message the receivers can not take would block its lane */
+	if (mtype < 1 || mtype > MQSV_RING_NUM_LANES || len > NCS_OS_MQ_MAX_PAYLOAD)
+		return NCSCC_RC_FAILURE;
+
+	map = ring_get(mqd);
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) != 0)
+		goto done;
+
+	for (;;) {
+		hdr = map->hdr;
+		lane = &hdr->lane[mtype - 1];
+		if (bytes > hdr->max_bytes) {
+			ring_unlock(hdr, false);
+			goto done;
+		}
+		if (hdr->num_bytes + bytes <= hdr->max_bytes &&
+		    lane->tail - lane->head + rec_size <= hdr->lane_size)
+			break;
+		if (!wait) {
+			ring_unlock(hdr, false);
+			goto done;
+		}
+		if (ring_wait(&map) != 0)
+			goto done;
+	}
+
+	lane_data = ring_lane_data(hdr, mtype - 1, hdr->lane_size);
+	rec.len = len;
+	rec.reserved = 0;
+	ring_write(lane_data, hdr->lane_size, lane->tail, &rec, sizeof(rec));
+	ring_write(lane_data, hdr->lane_size, lane->tail + sizeof(rec), data, len);
+	__atomic_store_n(&lane->tail, lane->tail + rec_size, __ATOMIC_RELEASE);
+
+	lane->num_msgs++;
+	lane->num_bytes += bytes;
+	hdr->num_msgs++;
+	hdr->num_bytes += bytes;
+	hdr->stime = time(NULL);
+	ring_unlock(hdr, true);
+	rc = NCSCC_RC_SUCCESS;
+ done:
+	if (map != NULL)
+		ring_put(map);
+	return rc;
+}
+
+/* The lane to receive from, -1 if there is none. A negative type takes the
+   lowest type up to its absolute value, as msgrcv does. */
+static int ring_recv_lane(MQSV_RING_HDR *hdr, int32_t mtype)
+{
+	int last = MQSV_RING_NUM_LANES;
+	int i;
+
+	if (mtype > 0) {
+		if (mtype > MQSV_RING_NUM_LANES || hdr->lane[mtype - 1].num_msgs == 0)
+			return -1;
+		return mtype - 1;
+	}
+	if (mtype < 0 && -mtype < last)
+		last = -mtype;
+	for (i = 0; i < last; i++) {
+		if (hdr->lane[i].num_msgs != 0)
+			return i;
+	}
+	return -1;
+}
+
+/****************************************************************************
+ * Function Name: ring_recv
+ * Purpose: Copies the first message of the lowest type out of the queue.
+ *          A message longer than max_len is left in the queue.
+ ****************************************************************************/
+static uint32_t ring_recv(NCS_OS_POSIX_MQD mqd, NCS_OS_MQ_MSG *msg, uint32_t max_len, int32_t mtype, bool wait)
+{
+	MQSV_RING_MAP *map;
+	MQSV_RING_HDR *hdr;
+	MQSV_RING_LANE *lane;
+	MQSV_RING_REC rec;
+	uint8_t *lane_data;
+	uint32_t rc = NCSCC_RC_FAILURE;
+	int lane_no;
+
+	map = ring_get(mqd);
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) != 0)
+		goto done;
+
+	for (;;) {
+		hdr = map->hdr;
+		lane_no = ring_recv_lane(hdr, mtype);
+		if (lane_no >= 0)
+			break;
+		if (!wait) {
+			ring_unlock(hdr, false);
+			goto done;
+		}
+		if (ring_wait(&map) != 0)
+			goto done;
+	}
+
+	lane = &hdr->lane[lane_no];
+	lane_data = ring_lane_data(hdr, lane_no, hdr->lane_size);
+	ring_read(lane_data, hdr->lane_size, lane->head, &rec, sizeof(rec));
+	if (lane->tail - lane->head > hdr->lane_size ||
+	    m_MQSV_RING_REC_SIZE(rec.len) > lane->tail - lane->head) {
+		LOG_ER("MQSv queue ring %u lane %d corrupt", mqd, lane_no + 1);
+		ring_unlock(hdr, false);
+		goto done;
+	}
+	if (rec.len > max_len || rec.len > NCS_OS_MQ_MAX_PAYLOAD) {
+		ring_unlock(hdr, false);
+		goto done;
+	}
+	ring_read(lane_data, hdr->lane_size, lane->head + sizeof(rec), msg->data, rec.len);
+	msg->ll_hdr = lane_no + 1;
+	__atomic_store_n(&lane->head, lane->head + m_MQSV_RING_REC_SIZE(rec.len), __ATOMIC_RELEASE);
+
+	lane->num_msgs--;
+	lane->num_bytes -= m_MQSV_RING_MSG_BYTES(rec.len);
+	hdr->num_msgs--;
+	hdr->num_bytes -= m_MQSV_RING_MSG_BYTES(rec.len);
+	ring_unlock(hdr, true);
+	rc = NCSCC_RC_SUCCESS;
+ done:
+	if (map != NULL)
+		ring_put(map);
+	return rc;
+}
+
+static uint32_t ring_get_attr(NCS_OS_POSIX_MQD mqd, NCS_OS_POSIX_MQ_ATTR *attr)
+{
+	MQSV_RING_MAP *map = ring_get(mqd);
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) == 0) {
+		attr->mq_curmsgs = map->hdr->num_msgs;
+		attr->mq_msgsize = map->hdr->num_bytes;
+		attr->mq_stime = map->hdr->stime;
+		attr->mq_maxmsg = map->hdr->max_bytes;
+		ring_unlock(map->hdr, false);
+		rc = NCSCC_RC_SUCCESS;
+	}
+	if (map != NULL)
+		ring_put(map);
+	return rc;
+}
+
+/****************************************************************************
+ * Function Name: mqsv_ring_recover
+ * Purpose: Checks that the ring of a queue found in the checkpoint after
+ *          a restart still exists, and repairs it if the previous MQND
+ *          died while changing it.
+ * Return Value: NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE
+ ****************************************************************************/
+uint32_t mqsv_ring_recover(NCS_OS_POSIX_MQD mqd)
+{
+	MQSV_RING_MAP *map = ring_get(mqd);
+	uint32_t rc = NCSCC_RC_FAILURE;
+
+	if (map == NULL)
+		return NCSCC_RC_FAILURE;
+	if (ring_lock(&map) == 0) {
+		TRACE("Queue ring %u has %u messages", mqd, map->hdr->num_msgs);
+		ring_unlock(map->hdr, false);
+		rc = NCSCC_RC_SUCCESS;
+	}
+	if (map != NULL)
+		ring_put(map);
+	return rc;
+}
+
+/***************************************************************************
+ *
+ * uint32_t mqsv_ring_mq(NCS_OS_POSIX_MQ_REQ_INFO *req)
+ *
+ * Description:
+ *   This routine handles the native message queue requests of MQSv, with
+ *   the semantics SysV message queues gave them.
+ *
+ * Call Arguments:
+ *    req ............... ....action request
+ *
+ * Returns:
+ *   Returns NCSCC_RC_SUCCESS if successful, otherwise NCSCC_RC_FAILURE.
+ *
+ ****************************************************************************/
+uint32_t mqsv_ring_mq(NCS_OS_POSIX_MQ_REQ_INFO *req)
+{
+	char filename[264];
+	MQSV_RING_MAP *map;
+
+	switch (req->req) {
+	case NCS_OS_POSIX_MQ_REQ_MSG_SEND:
+	case NCS_OS_POSIX_MQ_REQ_MSG_SEND_ASYNC:
+		return mqsv_ring_send(req->info.send.mqd, req->info.send.i_msg->data,
+				      req->info.send.datalen, req->info.send.i_mtype,
+				      req->req == NCS_OS_POSIX_MQ_REQ_MSG_SEND);
+
+	case NCS_OS_POSIX_MQ_REQ_MSG_RECV:
+	case NCS_OS_POSIX_MQ_REQ_MSG_RECV_ASYNC:
+		return ring_recv(req->info.recv.mqd, req->info.recv.i_msg,
+				 req->info.recv.datalen, req->info.recv.i_mtype,
+				 req->req == NCS_OS_POSIX_MQ_REQ_MSG_RECV);
+
+	case NCS_OS_POSIX_MQ_REQ_GET_ATTR:
+		return ring_get_attr(req->info.attr.i_mqd, &req->info.attr.o_attr);
+
+	case NCS_OS_POSIX_MQ_REQ_OPEN:
+		snprintf(filename, sizeof(filename), "/tmp/%s%d", req->info.open.qname, req->info.open.node);
+		if (req->info.open.iflags & O_CREAT)
+			return ring_create(filename, req->info.open.attr.mq_msgsize, &req->info.open.o_mqd);
+
+		if (ring_read_file(filename, &req->info.open.o_mqd) != NCSCC_RC_SUCCESS)
+			return NCSCC_RC_FAILURE;
+		map = ring_get(req->info.open.o_mqd);
+		if (map == NULL)
+			return NCSCC_RC_FAILURE;
+		ring_put(map);
+		return NCSCC_RC_SUCCESS;
+
+	case NCS_OS_POSIX_MQ_REQ_RESIZE:
+		return ring_resize(req->info.resize.mqd, req->info.resize.i_newqsize);
+
+	case NCS_OS_POSIX_MQ_REQ_CLOSE:
+		return ring_destroy(req->info.close.mqd);
+
+	case NCS_OS_POSIX_MQ_REQ_UNLINK:
+		snprintf(filename, sizeof(filename), "/tmp/%s%d", (char *)req->info.unlink.qname, req->info.unlink.node);
+		if (unlink(filename) != 0)
+			return NCSCC_RC_FAILURE;
+		return NCSCC_RC_SUCCESS;
+
+	default:
+		return NCSCC_RC_FAILURE;
+	}
+}
@@ -0,0 +1,94 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/*****************************************************************************
+..............................................................................
+
+..............................................................................
+
+  DESCRIPTION:
+
+  MQSv native message queues kept in shared memory rings.
+
+  Each queue is a POSIX shared memory segment holding one ring per message
+  type (mtype 1 to 6), shared by MQND and the MQA agents on the node. A
+  message is copied once into the ring by the sender and once out of it by
+  the receiver. Receivers take the lowest message type first, as msgrcv
+  does with a negative type.
+
+******************************************************************************
+*/
+#ifndef MSG_MQSV_RING_H_
+#define MSG_MQSV_RING_H_
+
+#include <pthread.h>
+#include "base/ncs_osprm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MQSV_RING_MAGIC       0x4d515247	/* "MQRG" */
+#define MQSV_RING_VERSION     1
+#define MQSV_RING_NUM_LANES   6	/* message types 1 to 6 */
+#define MQSV_RING_NAME_FMT    "opensaf_mqsv_%u"
+#define MQSV_RING_DATA_OFFSET 512
+/* Senders and receivers both write the ring. The default gives any user the
+   access a SysV queue of mode 0644 gave, MQSV_RING_MODE (octal) overrides it,
+   e.g. 0660 to share the rings with OPENSAF_GROUP only. */
+#define MQSV_RING_PROTECTION_FLAGS 0666
+
+/* Bytes charged to the queue size per message, as for a SysV message */
+#define m_MQSV_RING_MSG_BYTES(len) ((len) + sizeof(NCS_OS_MQ_MSG_LL_HDR))
+
+/* Messages of one type. The offsets are free running, a message is
+   published by moving tail and consumed by moving head. */
+typedef struct mqsv_ring_lane {
+	uint64_t head;
+	uint64_t tail;
+	uint32_t num_msgs;
+	uint32_t num_bytes;
+} MQSV_RING_LANE;
+
+/* Start of the shared memory segment of a queue */
+typedef struct mqsv_ring_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t map_size;	/* grows when the queue is resized */
+	uint64_t lane_size;	/* data bytes of each lane */
+	pthread_mutex_t lock;	/* robust and process shared */
+	pthread_cond_t cond;	/* a message was sent or received */
+	uint32_t num_waiters;
+	uint32_t destroyed;
+	uint32_t resizing;
+	uint32_t max_bytes;	/* queue size, as msg_qbytes */
+	uint32_t num_msgs;
+	uint32_t num_bytes;
+	uint32_t stime;
+	MQSV_RING_LANE lane[MQSV_RING_NUM_LANES];
+} MQSV_RING_HDR;
+
+#define m_MQSV_OS_MQ mqsv_ring_mq
+uint32_t mqsv_ring_mq(NCS_OS_POSIX_MQ_REQ_INFO *req);
+uint32_t mqsv_ring_send(NCS_OS_POSIX_MQD mqd, const void *data, uint32_t len, uint32_t mtype, bool wait);
+uint32_t mqsv_ring_recover(NCS_OS_POSIX_MQD mqd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MSG_MQSV_RING_H_
@@ -1078,7 +1078,7 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 	info.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	info.info.attr.i_mqd = qnode->qinfo.queueHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		err = SA_AIS_ERR_BAD_HANDLE;
 		LOG_ER("Unable to get the queue attributes from the queue");
 		rc = NCSCC_RC_FAILURE;
@@ -1101,7 +1101,7 @@ static uint32_t mqnd_evt_proc_send_msg(MQND_CB *cb, MQSV_DSEND_EVT *evt)
 		info.info.resize.i_newqsize =
 		    actual_qsize + (5 * (snd_msg->message.size + sizeof(MQSV_MESSAGE) + sizeof(NCS_OS_MQ_MSG_LL_HDR)));
 
-		if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 			LOG_ER("Unable to resize the queue to the given size");
 			err = SA_AIS_ERR_NO_RESOURCES;
 			rc = NCSCC_RC_FAILURE;
@@ -69,7 +69,7 @@ uint32_t mqnd_mq_create(MQND_QUEUE_INFO *q_info)
 	info.info.open.attr.mq_msgsize = size + MQSV_MSG_OVERHEAD;
 
 	/* Create a New message queue */
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Creation of New message queue failed", __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
@@ -78,7 +78,7 @@ uint32_t mqnd_mq_create(MQND_QUEUE_INFO *q_info)
 		/* MQSv particia can't handle zero Handle, get the new queue */
 		zero_q = *q_info;
 		zero_q.queueHandle = 0;
-		if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 			LOG_ER("%s:%u: Creation of New message queue failed", __FILE__, __LINE__);
 			rc = NCSCC_RC_FAILURE;
 		}
@@ -111,7 +111,7 @@ uint32_t mqnd_mq_open(MQND_QUEUE_INFO *q_info)
 	info.info.open.iflags = 0;
 
 	/* Create a New message queue */
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Creation of New message queue failed", __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
@@ -139,7 +139,7 @@ uint32_t mqnd_mq_destroy(MQND_QUEUE_INFO *q_info)
 	info.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
 	info.info.close.mqd = q_info->queueHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Closing the existing message queue failed", __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
@@ -151,7 +151,7 @@ uint32_t mqnd_mq_destroy(MQND_QUEUE_INFO *q_info)
 	info.info.unlink.qname = qName;
 	info.info.unlink.node = m_NCS_NODE_ID_FROM_MDS_DEST(q_info->rcvr_mqa);
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Removing the existing message queue failed");
 		return (NCSCC_RC_FAILURE);
 	}
@@ -166,25 +166,14 @@ uint32_t mqnd_mq_destroy(MQND_QUEUE_INFO *q_info)
  ****************************************************************************/
 uint32_t mqnd_mq_msg_send(uint32_t qhdl, MQSV_MESSAGE *mqsv_msg, uint32_t size)
 {
-	NCS_OS_POSIX_MQ_REQ_INFO info;
-	NCS_OS_MQ_MSG mq_msg;
-
-	memset(&mq_msg, 0, sizeof(NCS_OS_MQ_MSG));
-	memcpy(mq_msg.data, mqsv_msg, size);
-
-	memset(&info, 0, sizeof(NCS_OS_POSIX_MQ_REQ_INFO));
-	info.req = NCS_OS_POSIX_MQ_REQ_MSG_SEND_ASYNC;
-	info.info.send.mqd = qhdl;
-	info.info.send.datalen = size;
-	info.info.send.i_msg = &mq_msg;
 	/* Priority 1 will be used for control messages like MQP_EVT_CANCEL_REQ 
 	   Priority 2 will be used for re-sending the messages that failed to deliver
 	   to applications in saMsgMessageGet. 
 	   Priority 3 to 6 will be used for SAF priorities 0 to 3 respectivelyp */
+	uint32_t mtype = mqsv_msg->info.msg.message.priority + 3;
 
-	info.info.send.i_mtype = mqsv_msg->info.msg.message.priority + 3;
-
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	/* The message is copied straight into the queue ring */
+	if (mqsv_ring_send(qhdl, mqsv_msg, size, mtype, false) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Sending the message to message queue failed");
 		return (NCSCC_RC_FAILURE);
 	}
@@ -209,7 +198,7 @@ uint32_t mqnd_mq_empty(SaMsgQueueHandleT handle)
 
 	mq_req.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	mq_req.info.attr.i_mqd = handle;
-	if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Empty the message in message queue failed");
 		return NCSCC_RC_FAILURE;
 	}
@@ -233,7 +222,7 @@ uint32_t mqnd_mq_empty(SaMsgQueueHandleT handle)
 	mq_req.info.recv.i_mtype = -7;
 
 	for (count = 0; count < num_messages; count++)
-		m_NCS_OS_POSIX_MQ(&mq_req);
+		m_MQSV_OS_MQ(&mq_req);
 
 	return NCSCC_RC_SUCCESS;
 }
@@ -268,7 +257,7 @@ uint32_t mqnd_mq_rcv(SaMsgQueueHandleT handle)
 	mq_req.info.recv.i_mtype = -7;	/* Read only the priorities brtween 1 and 6,
 					   with 1 as highest priority */
 
-	if (m_NCS_OS_POSIX_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&mq_req) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Receiving the message from message queue failed");
 		return NCSCC_RC_FAILURE;
 	}
@@ -298,7 +287,7 @@ uint32_t mqnd_listenerq_create(MQND_QUEUE_INFO *q_info)
 	info.info.open.attr.mq_msgsize = MQND_LISTENER_QUEUE_SIZE;
 
 	/* Create a New message queue */
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Creation of message queue failed", __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
@@ -307,7 +296,7 @@ uint32_t mqnd_listenerq_create(MQND_QUEUE_INFO *q_info)
 		/* MQSv particia can't handle zero Handle, get the new queue */
 		zero_q = *q_info;
 		zero_q.listenerHandle = 0;
-		if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+		if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 			LOG_ER("%s:%u: Creation of message queue failed", __FILE__, __LINE__);
 			rc = NCSCC_RC_FAILURE;
 		}
@@ -338,7 +327,7 @@ uint32_t mqnd_listenerq_destroy(MQND_QUEUE_INFO *q_info)
 	info.req = NCS_OS_POSIX_MQ_REQ_CLOSE;
 	info.info.close.mqd = q_info->listenerHandle;
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("%s:%u: Closing the existing message queue failed", __FILE__, __LINE__);
 		return (NCSCC_RC_FAILURE);
 	}
@@ -350,7 +339,7 @@ uint32_t mqnd_listenerq_destroy(MQND_QUEUE_INFO *q_info)
 	info.info.unlink.qname = qName;
 	info.info.unlink.node = m_NCS_NODE_ID_FROM_MDS_DEST(q_info->rcvr_mqa);
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Removing the existing message queue failed");
 		return (NCSCC_RC_FAILURE);
 	}
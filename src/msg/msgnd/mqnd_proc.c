@@ -236,7 +236,7 @@ uint32_t mqnd_evt_proc_mqp_qtransfer(MQND_CB *cb, MQSV_EVT *req)
 	/* Read all the messages from the queue and pack it into buffer */
 	qreq.req = NCS_OS_POSIX_MQ_REQ_GET_ATTR;
 	qreq.info.attr.i_mqd = qhdl;
-	if (m_NCS_OS_POSIX_MQ(&qreq) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&qreq) != NCSCC_RC_SUCCESS) {
 		LOG_ER("ERR_RESOURCES: Unable to get the queue attributes from the queue");
 		err = SA_AIS_ERR_NO_RESOURCES;
 		goto send_rsp;
@@ -628,7 +628,7 @@ uint32_t mqnd_fill_queue_from_transfered_buffer(MQND_CB *cb, MQND_QUEUE_NODE *qn
 	info.info.resize.i_newqsize = transfer_rsp->msg_bytes +
 	    (transfer_rsp->msg_count * (sizeof(MQSV_MESSAGE) + sizeof(NCS_OS_MQ_MSG_LL_HDR)));
 
-	if (m_NCS_OS_POSIX_MQ(&info) != NCSCC_RC_SUCCESS) {
+	if (m_MQSV_OS_MQ(&info) != NCSCC_RC_SUCCESS) {
 		LOG_ER("Unable to resize the queue to the given size");
 		rc = NCSCC_RC_FAILURE;
 		return rc;
@@ -165,6 +165,12 @@ static SaAisErrorT mqnd_build_database_from_shm(MQND_CB *cb)
 			memset(qnode, 0, sizeof(MQND_QUEUE_NODE));
 
 			mqnd_fill_queue_node(&ckpt_queue_info, &(qnode->qinfo));
+			/* The queue rings outlive MQND, repair them if it died changing one */
+			if (mqsv_ring_recover(qnode->qinfo.queueHandle) != NCSCC_RC_SUCCESS)
+				LOG_ER("Message queue %llu not found after restart", qnode->qinfo.queueHandle);
+			if (qnode->qinfo.listenerHandle &&
+			    mqsv_ring_recover(qnode->qinfo.listenerHandle) != NCSCC_RC_SUCCESS)
+				LOG_ER("Listener queue %llu not found after restart", qnode->qinfo.listenerHandle);
 			/* Check for the insertion and add the queue info to the patricia tree */
 			mqnd_restart_queue_node_add(cb, qnode);
 		} else if (shm_base_addr[i].valid)
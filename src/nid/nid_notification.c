@@ -0,0 +1,84 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "base/logtrace.h"
+#include "nid/agent/nid_api.h"
+#include "nid/nid_notification.h"
+
+/****************************************************************************
+ * Name          : nid_parse_notifications                                  *
+ *                                                                          *
+ * Description   : Splits a buffer read from the NID FIFO into its          *
+ *                 "magic:service:status" notifications. The notifications  *
+ *                 are written back to back by nid_notify() and separated   *
+ *                 by a newline when written by the service scripts.        *
+ *                                                                          *
+ * Arguments     : buff - NUL terminated buffer, modified in place.         *
+ *                 cb   - Called with the service and status of each one.   *
+ *                 arg  - Passed to cb.                                     *
+ *                                                                          *
+ * Return Values : Number of notifications parsed.                          *
+ *                                                                          *
+ ***************************************************************************/
+unsigned nid_parse_notifications(char *buff, NID_NOTIFICATION_CB cb, void *arg)
+{
+	char magic_str[15], *p, *serv, *end;
+	size_t magic_len;
+	unsigned count = 0;
+	long stat;
+
+	magic_len = sprintf(magic_str, "%x:", NID_MAGIC);
+
+	p = buff;
+	for (;;) {
+		while (isspace((unsigned char)*p))
+			p++;
+		if (*p == '\0')
+			break;
+
+		if (strncasecmp(p, magic_str, magic_len) != 0) {
+			LOG_ER("Received invalid message: %s", p);
+			break;
+		}
+
+		serv = p + magic_len;
+		if ((p = strchr(serv, ':')) == NULL) {
+			LOG_ER("Failed missing status code");
+			break;
+		}
+		*p++ = '\0';
+
+		/* The status ends at the newline or where the next magic starts */
+		stat = strtol(p, &end, 10);
+		if (end == p) {
+			LOG_ER("Failed missing status code");
+			break;
+		}
+		p = end;
+
+		cb(serv, stat, arg);
+		count++;
+	}
+
+	return count;
+}
@@ -0,0 +1,42 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#ifndef NID_NID_NOTIFICATION_H_
+#define NID_NID_NOTIFICATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Called for every "magic:service:status" notification parsed */
+typedef void (*NID_NOTIFICATION_CB)(const char *service, long status,
+                                    void *arg);
+
+/*
+ * Parses the notifications in the NUL terminated buffer "buff", which is
+ * modified in place. Whitespace around the notifications, such as the newline
+ * "echo" appends in the service scripts, is skipped. Parsing stops at the first
+ * malformed notification. Returns the number of notifications parsed.
+ */
+extern unsigned nid_parse_notifications(char *buff, NID_NOTIFICATION_CB cb,
+                                        void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // NID_NID_NOTIFICATION_H_
@@ -33,12 +33,15 @@
 *                         "N" times).                                   *
 *                       * [OPTIONAL]: Input parameters for application. *
 *                       * [OPTIONAL]: Input parameters for cleanup app. *
+*                       * [OPTIONAL]: Services the application depends  *
+*                         on, the previous entry if not given.          *
 *                                                                       *
-*            Spawns the services in the sequence listed in              *
-*            this file,uses time-out against each service               *
-*            spawned and spawn the next service only once               *
-*            opensafd receives a successful initialization              *
-*            notification from spawned servrice.                        *
+*            Spawns a service once opensafd received a successful       *
+*            initialization notification from all the services it       *
+*            depends on, services which do not depend on each other     *
+*            are started concurrently. Uses time-out against each       *
+*            service spawned. The spawn and ready times of the          *
+*            services are written to the startup timeline.              *
 *                                                                       *
 *            opensafd invokes cleanup followed by recovery              *
 *            if it receives initialize action error from                *
@@ -59,6 +62,7 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "osaf/configmake.h"
 #include "rde/agent/rda_papi.h"
@@ -67,6 +71,7 @@
 #include "base/osaf_time.h"
 
 #include "nodeinit.h"
+#include "nid/nid_notification.h"
 
 #define SETSIG(sa, sig, fun, flags) \
 	do { \
@@ -95,6 +100,10 @@ uint32_t role = 0;
 char rolebuff[20];
 char svc_name[NID_MAXSNAME];
 
+/* Startup timeline, times are relative to boot_time */
+static FILE *timeline;
+static struct timespec boot_time;
+
 static uint32_t spawn_wait(NID_SPAWN_INFO *servicie, char *strbuff);
 int32_t fork_process(NID_SPAWN_INFO *service, char *app, char *args[], char *strbuff);
 static int32_t fork_script(NID_SPAWN_INFO *service, char *app, char *args[], char *strbuff);
@@ -108,6 +117,12 @@ static uint32_t parse_nodeinit_conf(char *strbuf);
 static uint32_t check_process(NID_SPAWN_INFO *service);
 static void cleanup(NID_SPAWN_INFO *service, int reason);
 static uint32_t recovery_action(NID_SPAWN_INFO *, char *, int);
+static uint32_t resolve_deps(NID_SPAWN_INFO *, char *);
+static void timeline_event(NID_SPAWN_INFO *, const char *);
+static uint32_t read_notifications(char *);
+static uint32_t spawn_service(NID_SPAWN_INFO *, char *);
+static uint32_t wait_notifications(const struct timespec *, char *);
+static uint32_t notified_status(NID_SPAWN_INFO *, char *);
 static uint32_t spawn_services(char *);
 static void nid_sleep(uint32_t);
 
@@ -478,7 +493,7 @@ uint32_t get_spawn_info(char *srcstr, NID_SPAWN_INFO *spawninfo, char *sbuf)
 				strcpy(spawninfo->cleanup_parms, " ");
 				spawninfo->clnup_args[1] = NULL;
 				spawninfo->clnup_args[0] = spawninfo->cleanup_file;
-				parse_state = NID_PLATCONF_END;
+				parse_state = NID_PLATCONF_DEPS;
 				continue;
 			} else {
 				if (strlen(q) > NID_MAXPARMS) {
@@ -488,6 +503,23 @@ uint32_t get_spawn_info(char *srcstr, NID_SPAWN_INFO *spawninfo, char *sbuf)
 				}
 				strncpy(spawninfo->cleanup_parms, q, NID_MAXPARMS);
 				collect_param(spawninfo->cleanup_parms, spawninfo->cleanup_file, spawninfo->clnup_args);
+				parse_state = NID_PLATCONF_DEPS;
+				continue;
+			}
+
+		case NID_PLATCONF_DEPS:
+			q = gettoken(&p, ':');
+			if (q == NULL) {
+				spawninfo->depends[0] = '\0';
+				parse_state = NID_PLATCONF_END;
+				continue;
+			} else {
+				if (strlen(q) >= NID_MAX_DEPS_LEN) {
+					sprintf(sbuf, ": Depends field length exceeded max:%d in file"
+						NID_PLAT_CONF, NID_MAX_DEPS_LEN - 1);
+					break;
+				}
+				strcpy(spawninfo->depends, q);
 				parse_state = NID_PLATCONF_END;
 				continue;
 			}
@@ -505,6 +537,66 @@ uint32_t get_spawn_info(char *srcstr, NID_SPAWN_INFO *spawninfo, char *sbuf)
 	return NCSCC_RC_SUCCESS;
 }
 
+/****************************************************************************
+ * Name          : resolve_deps                                             *
+ *                                                                          *
+ * Description   : Looks up the services listed in the depends field of     *
+ *                 "service" among the entries parsed before it. Without a  *
+ *                 depends field the service depends on the previous entry, *
+ *                 which keeps the sequence of the file.                    *
+ *                                                                          *
+ * Arguments     : service - service details, not in spawn_list yet.        *
+ *                 sbuf - Buffer for returning error messages               *
+ *                                                                          *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE                        *
+ *                                                                          *
+ ***************************************************************************/
+uint32_t resolve_deps(NID_SPAWN_INFO *service, char *sbuf)
+{
+	char depends[NID_MAX_DEPS_LEN], *name, *saveptr;
+	NID_SPAWN_INFO *dep;
+
+	TRACE_ENTER();
+
+	service->num_deps = 0;
+
+	if (service->depends[0] == '\0') {
+		if (spawn_list.tail != NULL)
+			service->deps[service->num_deps++] = spawn_list.tail;
+		return NCSCC_RC_SUCCESS;
+	}
+
+	if (strcmp(service->depends, NID_NO_DEPS) == 0)
+		return NCSCC_RC_SUCCESS;
+
+	/* Only earlier entries are looked up, so there are no dependency cycles */
+	strcpy(depends, service->depends);
+	for (name = strtok_r(depends, ",", &saveptr); name != NULL;
+	     name = strtok_r(NULL, ",", &saveptr)) {
+		for (dep = spawn_list.head; dep != NULL; dep = dep->next) {
+			if (strcmp(dep->serv_name, name) == 0)
+				break;
+		}
+
+		if (dep == NULL) {
+			sprintf(sbuf, ": %s depends on %s which is not listed before it",
+				service->serv_name, name);
+			return NCSCC_RC_FAILURE;
+		}
+
+		if (service->num_deps == NID_MAXDEPS) {
+			sprintf(sbuf, ": %s depends on more than %d services", service->serv_name, NID_MAXDEPS);
+			return NCSCC_RC_FAILURE;
+		}
+
+		service->deps[service->num_deps++] = dep;
+	}
+
+	TRACE_LEAVE();
+
+	return NCSCC_RC_SUCCESS;
+}
+
 /****************************************************************************
  * Name          : parse_nodeinit_conf                                       *
  *                                                                          *
@@ -582,6 +674,11 @@ uint32_t parse_nodeinit_conf(char *strbuf)
 			return NCSCC_RC_FAILURE;
 		}
 
+		if (resolve_deps(childinfo, sbuf) != NCSCC_RC_SUCCESS) {
+			sprintf(strbuf, "%s, At: %d\n", sbuf, lineno);
+			return NCSCC_RC_FAILURE;
+		}
+
 		if (strcmp(childinfo->serv_name, info.faild_serv_name) == 0)
 			childinfo->recovery_matrix[NID_RESET].retry_count = info.count;
 
@@ -903,26 +1000,113 @@ void collect_param(char *params, char *s_name, char *args[])
 }
 
 /****************************************************************************
- * Name          : spawn_wait                                               *
+ * Name          : timeline_event                                           *
  *                                                                          *
- * Description   : Spawns given service and waits for given time for        *
- *                 service to respond. Error processing is done based on    *
- *                 services response. Returns a failure if service doesent  *
- *                 respond before timeout.                                  *
+ * Description   : Writes a startup event of a service to the timeline.     *
+ *                                                                          *
+ * Arguments     : service - service the event happened to.                 *
+ *                 event - event name.                                      *
+ *                                                                          *
+ ***************************************************************************/
+void timeline_event(NID_SPAWN_INFO *service, const char *event)
+{
+	struct timespec now, elapsed;
+
+	if (timeline == NULL)
+		return;
+
+	osaf_clock_gettime(CLOCK_MONOTONIC, &now);
+	osaf_timespec_subtract(&now, &boot_time, &elapsed);
+	fprintf(timeline, "%8llu ms %-8s %-15s pid=%d\n",
+		(unsigned long long)osaf_timespec_to_millis(&elapsed), event,
+		service->serv_name, service->pid);
+	fflush(timeline);
+}
+
+/****************************************************************************
+ * Name          : record_notification                                      *
+ *                                                                          *
+ * Description   : Records a notification in the service which sent it.     *
+ *                 Notifications from services not waited for are dropped.  *
+ *                                                                          *
+ * Arguments     : serv - Name of the service.                              *
+ *                 stat - Status code sent by the service.                  *
+ *                 arg  - Unused.                                           *
+ *                                                                          *
+ * Return Values : None.                                                    *
+ *                                                                          *
+ ***************************************************************************/
+static void record_notification(const char *serv, long stat, void *arg)
+{
+	NID_SPAWN_INFO *service;
+
+	for (service = spawn_list.head; service != NULL; service = service->next) {
+		if (strcmp(service->serv_name, serv) == 0)
+			break;
+	}
+
+	if ((service == NULL) || (service->state != NID_SVC_STARTING)) {
+		LOG_WA("Dropped notification from %s, status %ld", serv, stat);
+		return;
+	}
+
+	service->notify_status = stat;
+	service->state = NID_SVC_NOTIFIED;
+	osaf_clock_gettime(CLOCK_MONOTONIC, &service->ready_time);
+}
+
+/****************************************************************************
+ * Name          : read_notifications                                       *
+ *                                                                          *
+ * Description   : Reads the notifications available on the NID FIFO and    *
+ *                 records them in the services which sent them. One read   *
+ *                 may return several "magic:service:status" notifications  *
+ *                 as services started concurrently share the FIFO.         *
+ *                                                                          *
+ * Arguments     : strbuff - Buffer to return error message if any.         *
+ *                                                                          *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE.                       *
+ *                                                                          *
+ ***************************************************************************/
+uint32_t read_notifications(char *strbuff)
+{
+	char buff[PIPE_BUF + 1];
+	ssize_t n;
+
+	TRACE_ENTER();
+
+	while ((n = read(select_fd, buff, sizeof(buff) - 1)) < 0) {
+		if (errno == EINTR)
+			continue;
+		if (errno == EAGAIN)
+			return NCSCC_RC_SUCCESS;
+		sprintf(strbuff, "Failed \nError reading NID FIFO: %d", errno);
+		return NCSCC_RC_FAILURE;
+	}
+
+	buff[n] = '\0';
+	nid_parse_notifications(buff, record_notification, NULL);
+
+	TRACE_LEAVE();
+
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : spawn_service                                            *
+ *                                                                          *
+ * Description   : Spawns given service without waiting for its response,  *
+ *                 the response is expected before service->deadline.       *
  *                                                                          *
  * Arguments     : service - service details for spawning.                  *
  *                 strbuff - Buffer to return error message if any.         *
  *                                                                          *
- * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE/NCSCC_RC_REQ_TIMOUT.   *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE.                       *
  *                                                                          *
  ***************************************************************************/
-uint32_t spawn_wait(NID_SPAWN_INFO *service, char *strbuff)
+uint32_t spawn_service(NID_SPAWN_INFO *service, char *strbuff)
 {
 	int32_t pid = -1, retry = 5;
-	int32_t i = 0, n = 0;
-	NID_FIFO_MSG reqmsg;
-	char *magicno, *serv, *stat, *p;
-	char buff1[100], magic_str[15];
 	FILE *file;
 
 	TRACE_ENTER();
@@ -962,6 +1146,10 @@ uint32_t spawn_wait(NID_SPAWN_INFO *service, char *strbuff)
 			return NCSCC_RC_FAILURE;
 	}
 
+	/* Dispatch what is pending, a notification from a previous instance is dropped */
+	if (read_notifications(strbuff) != NCSCC_RC_SUCCESS)
+		return NCSCC_RC_FAILURE;
+
 	/* Fork based on the application type, executable, script or daemon */
 	while (retry) {
 		pid = (fork_funcs[service->app_type])
@@ -983,82 +1171,112 @@ uint32_t spawn_wait(NID_SPAWN_INFO *service, char *strbuff)
 	}
 
 	service->pid = pid;
+	service->state = NID_SVC_STARTING;
 
-	/* IF Everything is fine till now, wait till service notifies its initializtion status */
 	/* service->time_out is in centi sec */
-	while ((n = osaf_poll_one_fd(select_fd, service->time_out * 10)) <= 0) {
-		if (n == 0) {
-			LOG_ER("Timed-out for response from %s", service->serv_name);
-			return NCSCC_RC_REQ_TIMOUT;
-		}
-		break;
-	}
+	osaf_clock_gettime(CLOCK_MONOTONIC, &service->spawn_time);
+	osaf_millis_to_timespec(service->time_out * 10, &service->deadline);
+	osaf_timespec_add(&service->spawn_time, &service->deadline, &service->deadline);
+	timeline_event(service, "SPAWN");
 
-	/* Read the message from FIFO and fill in structure. */
-	while ((n = read(select_fd, buff1, sizeof(buff1))) <= 0) {
-		if (errno == EINTR) {
-			continue;
-		} else {
-			sprintf(strbuff, "Failed \nError reading NID FIFO: %d", errno);
-			return NCSCC_RC_FAILURE;
-		}
-	}
+	TRACE_LEAVE();
 
-	buff1[n] = '\0';
-	p = buff1;
-	if ((magicno = gettoken(&p, ':')) == NULL) {
-		LOG_ER("Failed missing magicno");
-		return NCSCC_RC_FAILURE;
-	}
-	if ((serv = gettoken(&p, ':')) == NULL) {
-		LOG_ER("Failed missing service name");
-		return NCSCC_RC_FAILURE;
-	}
-	if ((stat = p) == NULL) {
-		LOG_ER("Failed missing status code");
-		return NCSCC_RC_FAILURE;
-	}
+	return NCSCC_RC_SUCCESS;
+}
 
-	sprintf(magic_str, "%x", NID_MAGIC);
-	for (i = 0; magicno[i] != '\0'; i++)
-		magicno[i] = (char)tolower(magicno[i]);
+/****************************************************************************
+ * Name          : wait_notifications                                       *
+ *                                                                          *
+ * Description   : Waits until a notification arrives on the NID FIFO or    *
+ *                 the deadline passes, and records the notifications read. *
+ *                                                                          *
+ * Arguments     : deadline - monotonic time to wait until.                 *
+ *                 strbuff - Buffer to return error message if any.         *
+ *                                                                          *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE/NCSCC_RC_REQ_TIMOUT.   *
+ *                                                                          *
+ ***************************************************************************/
+uint32_t wait_notifications(const struct timespec *deadline, char *strbuff)
+{
+	struct timespec now, left;
 
-	if (strcmp(magic_str, magicno) == 0)
-		reqmsg.nid_magic_no = NID_MAGIC;
-	else
-		reqmsg.nid_magic_no = -1;
+	osaf_clock_gettime(CLOCK_MONOTONIC, &now);
+	if (osaf_timespec_compare(deadline, &now) <= 0)
+		return NCSCC_RC_REQ_TIMOUT;
 
-	if (strcmp(serv, service->serv_name) != 0) {
-		sprintf(strbuff, "Failed \nReceived invalid service name received :"
-			" %s sent service->serv_name : %s", serv, service->serv_name);
-		return NCSCC_RC_FAILURE;
-	} else {
-		strcpy(reqmsg.nid_serv_name, serv);
-	}
+	/* Round up, not to wake up just before the deadline */
+	osaf_timespec_subtract(deadline, &now, &left);
+	if (osaf_poll_one_fd(select_fd, osaf_timespec_to_millis(&left) + 1) == 0)
+		return NCSCC_RC_REQ_TIMOUT;
 
-	reqmsg.nid_stat_code = atoi(stat);
-	if (reqmsg.nid_magic_no != NID_MAGIC) {
-		sprintf(strbuff, "Failed \nReceived invalid message: %x", reqmsg.nid_magic_no);
-		return NCSCC_RC_FAILURE;
-	}
+	return read_notifications(strbuff);
+}
 
-	/* LOOKS LIKE CORRECT RESPONSE LETS PROCESS */
-	if (strcmp(reqmsg.nid_serv_name, service->serv_name) != 0) {
-		sprintf(strbuff, "Failed \nService name  mismatch! Srvc spawned: %s, Srvc code received:%s",
-			service->serv_name, reqmsg.nid_serv_name);
+/****************************************************************************
+ * Name          : notified_status                                          *
+ *                                                                          *
+ * Description   : Processes the notification received from a service,     *
+ *                 the service is ready if it reported success.             *
+ *                                                                          *
+ * Arguments     : service - service in NID_SVC_NOTIFIED state.             *
+ *                 strbuff - Buffer to return error message if any.         *
+ *                                                                          *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE.                       *
+ *                                                                          *
+ ***************************************************************************/
+uint32_t notified_status(NID_SPAWN_INFO *service, char *strbuff)
+{
+	if (service->notify_status > NCSCC_RC_SUCCESS) {
+		sprintf(strbuff, "Failed \n DESC:%s", service->serv_name);
+		timeline_event(service, "FAILED");
 		return NCSCC_RC_FAILURE;
-	} else if (reqmsg.nid_stat_code == NCSCC_RC_SUCCESS) {
-		return NCSCC_RC_SUCCESS;
 	}
 
-	if ((reqmsg.nid_stat_code > NCSCC_RC_SUCCESS)) {
-		sprintf(strbuff, "Failed \n DESC:%s", service->serv_name);
-		return NCSCC_RC_FAILURE;
+	service->state = NID_SVC_READY;
+	timeline_event(service, "READY");
+
+	return NCSCC_RC_SUCCESS;
+}
+
+/****************************************************************************
+ * Name          : spawn_wait                                               *
+ *                                                                          *
+ * Description   : Spawns given service and waits for given time for        *
+ *                 service to respond. Error processing is done based on    *
+ *                 services response. Returns a failure if service doesent  *
+ *                 respond before timeout. Notifications of other services  *
+ *                 read meanwhile are recorded for spawn_services.          *
+ *                                                                          *
+ * Arguments     : service - service details for spawning.                  *
+ *                 strbuff - Buffer to return error message if any.         *
+ *                                                                          *
+ * Return Values : NCSCC_RC_SUCCESS/NCSCC_RC_FAILURE/NCSCC_RC_REQ_TIMOUT.   *
+ *                                                                          *
+ ***************************************************************************/
+uint32_t spawn_wait(NID_SPAWN_INFO *service, char *strbuff)
+{
+	uint32_t rc;
+
+	TRACE_ENTER();
+
+	if ((rc = spawn_service(service, strbuff)) != NCSCC_RC_SUCCESS)
+		return rc;
+
+	/* IF Everything is fine till now, wait till service notifies its initializtion status */
+	while (service->state == NID_SVC_STARTING) {
+		rc = wait_notifications(&service->deadline, strbuff);
+		if (rc == NCSCC_RC_REQ_TIMOUT) {
+			LOG_ER("Timed-out for response from %s", service->serv_name);
+			timeline_event(service, "TIMEOUT");
+			return NCSCC_RC_REQ_TIMOUT;
+		} else if (rc != NCSCC_RC_SUCCESS) {
+			return rc;
+		}
 	}
 
 	TRACE_LEAVE();
 
-	return NCSCC_RC_SUCCESS;
+	return notified_status(service, strbuff);
 }
 
 /****************************************************************************
@@ -1157,9 +1375,13 @@ void cleanup(NID_SPAWN_INFO *service, int reason)
 
 	TRACE_ENTER();
 
-	/* Dont Allow anyone to write to this pipe till we start recovery action */
-	nid_close_ipc();
-	select_fd = -1;
+	/**********************************************************
+	*    Drop the notifications of this instance, the FIFO     *
+	*    stays open for the other services being started.      *
+	*    spawn_service reads what it still wrote before        *
+	*    spawning the next instance.                           *
+	**********************************************************/
+	service->state = NID_SVC_WAITING;
 
 	pid_t w_pid;
 	pid_t pid;
@@ -1273,12 +1495,66 @@ uint32_t recovery_action(NID_SPAWN_INFO *service, char *strbuff, int reason)
 	return NCSCC_RC_FAILURE;
 }
 
+/****************************************************************************
+ * Name          : deps_ready                                               *
+ *                                                                          *
+ * Description   : Checks if all the services "service" depends on are      *
+ *                 initialized.                                             *
+ *                                                                          *
+ * Arguments     : service - service details.                               *
+ *                                                                          *
+ * Return Values : true/false                                               *
+ *                                                                          *
+ ***************************************************************************/
+static bool deps_ready(const NID_SPAWN_INFO *service)
+{
+	uint32_t i;
+
+	for (i = 0; i < service->num_deps; i++) {
+		if (service->deps[i]->state != NID_SVC_READY)
+			return false;
+	}
+
+	return true;
+}
+
+/****************************************************************************
+ * Name          : write_timeline_summary                                   *
+ *                                                                          *
+ * Description   : Writes the spawn and ready time of each service and the  *
+ *                 services it waited for to the startup timeline.          *
+ *                                                                          *
+ ***************************************************************************/
+static void write_timeline_summary(void)
+{
+	NID_SPAWN_INFO *service;
+	struct timespec spawned, ready, took;
+	uint32_t i;
+
+	fprintf(timeline, "\n%-15s %10s %10s %10s  %s\n", "SERVICE", "SPAWN(ms)", "READY(ms)", "TOOK(ms)", "AFTER");
+	for (service = spawn_list.head; service != NULL; service = service->next) {
+		osaf_timespec_subtract(&service->spawn_time, &boot_time, &spawned);
+		osaf_timespec_subtract(&service->ready_time, &boot_time, &ready);
+		osaf_timespec_subtract(&service->ready_time, &service->spawn_time, &took);
+		fprintf(timeline, "%-15s %10llu %10llu %10llu ", service->serv_name,
+			(unsigned long long)osaf_timespec_to_millis(&spawned),
+			(unsigned long long)osaf_timespec_to_millis(&ready),
+			(unsigned long long)osaf_timespec_to_millis(&took));
+		for (i = 0; i < service->num_deps; i++)
+			fprintf(timeline, " %s", service->deps[i]->serv_name);
+		fprintf(timeline, "\n");
+	}
+}
+
 /****************************************************************************
  * Name          : spawn_services                                           *
  *                                                                          *
- * Description   : Takes the global spawn list and calls spawn_wait for     *
- *                 each service in the list, spawn wait retrns only after   *
- *                 the service is spawned successfully.                     *
+ * Description   : Takes the global spawn list and spawns every service     *
+ *                 once the services it depends on are ready, services that *
+ *                 do not depend on each other are started concurrently.    *
+ *                 A service which fails or times out is recovered before   *
+ *                 the next service is spawned. Returns only after all the  *
+ *                 services are spawned successfully.                       *
  *                                                                          *
  * Arguments     : strbuff - Buffer to return error message if any.         *
  *                                                                          *
@@ -1288,13 +1564,15 @@ uint32_t recovery_action(NID_SPAWN_INFO *service, char *strbuff, int reason)
 uint32_t spawn_services(char *strbuf)
 {
 	NID_SPAWN_INFO *service;
-	NID_CHILD_LIST sp_list = spawn_list;
+	struct timespec deadline, took;
 	char sbuff[100];
+	uint32_t remaining = spawn_list.count;
 	uint32_t rc = NCSCC_RC_FAILURE;
+	bool starting;
 
 	TRACE_ENTER();
 
-	if (sp_list.head == NULL) {
+	if (spawn_list.head == NULL) {
 		sprintf(strbuf, "No services to spawn\n");
 		return NCSCC_RC_FAILURE;
 	}
@@ -1307,22 +1585,73 @@ uint32_t spawn_services(char *strbuf)
 	if (nid_open_ipc(&select_fd, strbuf) != NCSCC_RC_SUCCESS)
 		return NCSCC_RC_FAILURE;
 
-	while (sp_list.head != NULL) {
-		service = sp_list.head;
-		rc = spawn_wait(service, sbuff);
+	osaf_clock_gettime(CLOCK_MONOTONIC, &boot_time);
+	if ((timeline = fopen(NID_TIMELINE, "we")) == NULL)
+		LOG_WA("Could not open %s: %s", NID_TIMELINE, strerror(errno));
+
+	while (remaining > 0) {
+		/* Spawn what can be spawned, and find the first deadline */
+		starting = false;
+		for (service = spawn_list.head; service != NULL; service = service->next) {
+			if ((service->state == NID_SVC_WAITING) && deps_ready(service)) {
+				if (spawn_service(service, sbuff) != NCSCC_RC_SUCCESS) {
+					LOG_ER("%s", sbuff);
+					LOG_ER("Going for recovery");
+					if (recovery_action(service, sbuff, NCSCC_RC_FAILURE) != NCSCC_RC_SUCCESS)
+						exit(EXIT_FAILURE);
+					remaining--;
+					continue;
+				}
+			}
+
+			if (service->state != NID_SVC_STARTING)
+				continue;
+
+			if (!starting || (osaf_timespec_compare(&service->deadline, &deadline) < 0))
+				deadline = service->deadline;
+			starting = true;
+		}
 
-		if (rc != NCSCC_RC_SUCCESS) {
+		if (starting && (wait_notifications(&deadline, sbuff) == NCSCC_RC_FAILURE))
 			LOG_ER("%s", sbuff);
-			LOG_ER("Going for recovery");
-			if (recovery_action(service, sbuff, rc) != NCSCC_RC_SUCCESS) {
-				exit(EXIT_FAILURE);
+
+		for (service = spawn_list.head; service != NULL; service = service->next) {
+			sbuff[0] = '\0';
+
+			if (service->state == NID_SVC_NOTIFIED) {
+				rc = notified_status(service, sbuff);
+			} else if ((service->state == NID_SVC_STARTING) && osaf_is_timeout(&service->deadline)) {
+				LOG_ER("Timed-out for response from %s", service->serv_name);
+				timeline_event(service, "TIMEOUT");
+				rc = NCSCC_RC_REQ_TIMOUT;
+			} else {
+				continue;
+			}
+
+			if (rc != NCSCC_RC_SUCCESS) {
+				LOG_ER("%s", sbuff);
+				LOG_ER("Going for recovery");
+				if (recovery_action(service, sbuff, rc) != NCSCC_RC_SUCCESS) {
+					exit(EXIT_FAILURE);
+				}
 			}
+
+			if (strlen(sbuff) > 0)
+				LOG_NO("%s", sbuff);
+
+			remaining--;
 		}
+	}
 
-		if (strlen(sbuff) > 0)
-			LOG_NO("%s", sbuff);
+	osaf_clock_gettime(CLOCK_MONOTONIC, &deadline);
+	osaf_timespec_subtract(&deadline, &boot_time, &took);
+	LOG_NO("Started %u services in %llu ms, see %s", spawn_list.count,
+	       (unsigned long long)osaf_timespec_to_millis(&took), NID_TIMELINE);
 
-		sp_list.head = sp_list.head->next;
+	if (timeline != NULL) {
+		write_timeline_summary();
+		fclose(timeline);
+		timeline = NULL;
 	}
 
 	TRACE_LEAVE();
@@ -30,6 +30,8 @@
 #ifndef NID_NODEINIT_H_
 #define NID_NODEINIT_H_
 
+#include <time.h>
+
 #include "osaf/configmake.h"
 #include "nid/agent/nid_api.h"
 
@@ -47,9 +49,17 @@
 #define NID_MAX_PRIO_LEN             4
 #define NID_MAX_RESP_LEN             1
 #define NID_MAX_REST_LEN             1
+#define NID_MAXDEPS                  16
+#define NID_MAX_DEPS_LEN             (NID_MAXDEPS * (NID_MAX_SVC_NAME_LEN + 1))
 
 #define NID_PLAT_CONF   PKGSYSCONFDIR "/nodeinit.conf"
 
+/* Startup timeline, written while spawning the services */
+#define NID_TIMELINE    PKGLOGDIR "/nid_timeline.log"
+
+/* Depends field value of a service that can start right away */
+#define NID_NO_DEPS     "-"
+
 /*******************************************************************
  *       States Used While Parsing nodeinit.conf                    *
  *******************************************************************/
@@ -64,6 +74,7 @@ typedef enum nid_platconf_pars {
   NID_PLATCONF_RST,
   NID_PLATCONF_SPARM,
   NID_PLATCONF_CLNPARM,
+  NID_PLATCONF_DEPS,
   NID_PLATCONF_END
 } NID_PLATCONF_PARS;
 
@@ -96,6 +107,16 @@ typedef enum nid_recovery_opt {
   NID_MAXREC
 } NID_RECOVERY_OPT;
 
+/******************************************************************
+ *       Startup states of a service                               *
+ ******************************************************************/
+typedef enum nid_svc_state {
+  NID_SVC_WAITING = 0,    /* Waiting for its dependencies */
+  NID_SVC_STARTING,       /* Spawned, no notification yet */
+  NID_SVC_NOTIFIED,       /* Notification received, not handled yet */
+  NID_SVC_READY           /* Initialized successfully */
+} NID_SVC_STATE;
+
 typedef struct nid_spawn_info NID_SPAWN_INFO;
 
 typedef uint32_t (*NID_FUNC) (NID_SPAWN_INFO *, char *);
@@ -124,6 +145,14 @@ struct nid_spawn_info {
   char *serv_args[NID_MAXARGS];   /* pointers to '\0' seperated arguments in s_parameters */
   char cleanup_parms[NID_MAXPARMS];       /* Parameters for cleaning appl */
   char *clnup_args[NID_MAXARGS];  /* pointers to \0 sperated arguments in cleanup_parms */
+  char depends[NID_MAX_DEPS_LEN]; /* ',' separated services to wait for */
+  uint32_t num_deps;
+  struct nid_spawn_info *deps[NID_MAXDEPS];       /* resolved depends */
+  NID_SVC_STATE state;
+  int32_t notify_status;  /* Status code of the notification received */
+  struct timespec spawn_time;     /* Time of the last spawn */
+  struct timespec ready_time;
+  struct timespec deadline;       /* spawn_time + time_out */
   struct nid_spawn_info *next;
 };
 
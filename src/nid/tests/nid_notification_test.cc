@@ -0,0 +1,84 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nid/nid_notification.h"
+
+namespace {
+
+typedef std::vector<std::pair<std::string, long>> Notifications;
+
+void Record(const char* service, long status, void* arg) {
+  static_cast<Notifications*>(arg)->emplace_back(service, status);
+}
+
+unsigned Parse(const std::string& input, Notifications* out) {
+  std::vector<char> buff(input.begin(), input.end());
+  buff.push_back('\0');
+  return nid_parse_notifications(buff.data(), Record, out);
+}
+
+}  // namespace
+
+TEST(NidNotification, BackToBack) {
+  Notifications n;
+  EXPECT_EQ(Parse("aab49daa:RDE:1aab49daa:LOG:1", &n), 2u);
+  ASSERT_EQ(n.size(), 2u);
+  EXPECT_EQ(n[0], std::make_pair(std::string{"RDE"}, 1L));
+  EXPECT_EQ(n[1], std::make_pair(std::string{"LOG"}, 1L));
+}
+
+TEST(NidNotification, NewlineTerminatedRecordsInOneRead) {
+  Notifications n;
+  EXPECT_EQ(Parse("aab49daa:RDE:1\naab49daa:LOG:3\nAAB49DAA:NTF:1\n", &n),
+            3u);
+  ASSERT_EQ(n.size(), 3u);
+  EXPECT_EQ(n[0], std::make_pair(std::string{"RDE"}, 1L));
+  EXPECT_EQ(n[1], std::make_pair(std::string{"LOG"}, 3L));
+  EXPECT_EQ(n[2], std::make_pair(std::string{"NTF"}, 1L));
+}
+
+TEST(NidNotification, MixedSeparators) {
+  Notifications n;
+  EXPECT_EQ(Parse("aab49daa:RDE:1aab49daa:LOG:1\n\naab49daa:FM:1\n", &n), 3u);
+  ASSERT_EQ(n.size(), 3u);
+  EXPECT_EQ(n[2], std::make_pair(std::string{"FM"}, 1L));
+}
+
+TEST(NidNotification, StopsAtInvalidRecord) {
+  Notifications n;
+  EXPECT_EQ(Parse("aab49daa:RDE:1\ngarbage\naab49daa:LOG:1\n", &n), 1u);
+  ASSERT_EQ(n.size(), 1u);
+  EXPECT_EQ(n[0].first, "RDE");
+}
+
+TEST(NidNotification, MissingStatus) {
+  Notifications n;
+  EXPECT_EQ(Parse("aab49daa:RDE:\n", &n), 0u);
+  EXPECT_EQ(Parse("aab49daa:RDE", &n), 0u);
+  EXPECT_TRUE(n.empty());
+}
+
+TEST(NidNotification, Empty) {
+  Notifications n;
+  EXPECT_EQ(Parse("", &n), 0u);
+  EXPECT_EQ(Parse("\n", &n), 0u);
+  EXPECT_TRUE(n.empty());
+}
@@ -206,11 +206,25 @@ void NtfAdmin::processNotification(unsigned int clientId,
   sendNotificationUpdate(clientId, notification->getNotInfo());
 
   ClientMap::iterator pos;
-  for (pos = clientMap.begin(); pos != clientMap.end(); pos++) {
+  pos = clientMap.find(clientId);
+  if (pos != clientMap.end()) {
     NtfClient* client = pos->second;
     client->notificationReceived(clientId, notification, mdsCtxt);
   }
 
+  // send the notification to the clients with matching subscriptions
+  std::vector<NtfSubscriptionIndex::Match> matches;
+  subscriptionIndex.findMatches(notification, matches);
+  for (unsigned int i = 0; i < matches.size(); i++) {
+    pos = clientMap.find(matches[i].clientId);
+    if (pos != clientMap.end()) {
+      NtfClient* client = pos->second;
+      client->notificationMatched(matches[i].subscriptionId, notification);
+    }
+  }
+  // the reader cache may keep the notification long after it was sent
+  notification->releaseEncodedNotification();
+
   /* remove notification if sent to all subscribers and logged */
   if (notification->isSubscriptionListEmpty() &&
       notification->loggedOk()) {
@@ -28,6 +28,7 @@
 #include "ntf/ntfd/NtfClient.h"
 #include "ntf/ntfd/NtfFilter.h"
 #include "ntf/ntfd/NtfSubscription.h"
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
 #include "assert.h"
 #include "ntf/ntfd/NtfLogger.h"
 
@@ -94,6 +95,7 @@ class NtfAdmin{
   void discardedClear(unsigned int clientId, SaNtfSubscriptionIdT subscriptionId);
   static NtfAdmin* theNtfAdmin;
   NtfLogger logger;
+  NtfSubscriptionIndex subscriptionIndex;
 
   void AddMemberNode(NODE_ID node_id);
   NODE_ID* FindMemberNode(NODE_ID node_id);
@@ -55,6 +55,7 @@ NtfClient::~NtfClient() {
   SubscriptionMap::iterator pos;
   for (pos = subscriptionMap.begin(); pos != subscriptionMap.end(); pos++) {
     NtfSubscription* subscription = pos->second;
+    subscription->removeFromIndex(NtfAdmin::theNtfAdmin->subscriptionIndex);
     delete subscription;
   }
   // delete all readers
@@ -114,6 +115,7 @@ void NtfClient::subscriptionAdded(NtfSubscription* subscription,
   {
     // store new subscription in subscriptionMap
     subscriptionMap[subscription->getSubscriptionId()] = subscription;
+    subscription->addToIndex(NtfAdmin::theNtfAdmin->subscriptionIndex);
     TRACE_3("NtfClient::subscriptionAdded subscription %u added,"
             " client %u, subscriptionMap size is %u",
             subscription->getSubscriptionId(),
@@ -128,14 +130,9 @@ void NtfClient::subscriptionAdded(NtfSubscription* subscription,
 }
 
 /**
- * This method is called when the client received a notification.
+ * This method is called when the client sent a notification.
  *
- * If the notification is send from this client, a confirmation
- * for the notification is sent.
- *
- * The client scans through its subscriptions and if it finds a
- * matching one, it stores the id of the matching subscription in
- * the notification object.
+ * A confirmation for the notification is sent.
  *
  * @param clientId Node-wide unique id of the client who sent the notification.
  * @param notification
@@ -162,42 +159,52 @@ void NtfClient::notificationReceived(unsigned int clientId,
     }
   }
 
+  TRACE_LEAVE();
+}
+
+/**
+ * This method is called when a notification matches one of the
+ * subscriptions of the client.
+ *
+ * The id of the matching subscription is stored in the notification
+ * object and, if active, the notification is sent to the client.
+ *
+ * @param subscriptionId
+ *                 Client-wide unique id of the matching subscription.
+ * @param notification
+ *                 Pointer to the notification object.
+ */
+void NtfClient::notificationMatched(SaNtfSubscriptionIdT subscriptionId,
+                                    NtfSmartPtr& notification) {
+  TRACE_ENTER2("%u %u", clientId_, subscriptionId);
   //Send notification to this client if its node is CLM member node.
   if (is_stale_client(clientId_) == true) {
-    TRACE_2("NtfClient::notificationReceived, non clm member client:'%u' cannot"
+    TRACE_2("NtfClient::notificationMatched, non clm member client:'%u' cannot"
             " receive notification %llu", clientId_, notification->getNotificationId());
+    TRACE_LEAVE();
     return;
   }
 
-  // scan through all subscriptions
-  SubscriptionMap::iterator pos;
-
-  for (pos = subscriptionMap.begin(); pos != subscriptionMap.end(); pos++) {
-    NtfSubscription* subscription = pos->second;
-
-    if (subscription->checkSubscription(notification)) {
-      // notification matches the subscription
-      TRACE_2("NtfClient::notificationReceived notification %llu matches"
-              " subscription %d, client %u",
-              notification->getNotificationId(),
-              subscription->getSubscriptionId(),
-              clientId_);
-      // first store subscription data in notifiaction object for
-      //  tracking purposes
-      notification->storeMatchingSubscription(clientId_, subscription->getSubscriptionId());
-      // if active, send out the notification
-      if (activeController()) {
-        subscription->sendNotification(notification, this);
-      }
-    }
-    else
-    {
-      TRACE_2("NtfClient::notificationReceived notification %llu does not"
-              " match subscription %u, client %u",
-              notification->getNotificationId(),
-              subscription->getSubscriptionId(),
-              clientId_);
-    }
+  SubscriptionMap::iterator pos = subscriptionMap.find(subscriptionId);
+  if (pos == subscriptionMap.end()) {
+    LOG_WA("NtfClient::notificationMatched subscription %u not found,"
+           " client %u", subscriptionId, clientId_);
+    TRACE_LEAVE();
+    return;
+  }
+  NtfSubscription* subscription = pos->second;
+
+  TRACE_2("NtfClient::notificationMatched notification %llu matches"
+          " subscription %d, client %u",
+          notification->getNotificationId(),
+          subscription->getSubscriptionId(),
+          clientId_);
+  // first store subscription data in notifiaction object for
+  //  tracking purposes
+  notification->storeMatchingSubscription(clientId_, subscription->getSubscriptionId());
+  // if active, send out the notification
+  if (activeController()) {
+    subscription->sendNotification(notification, this);
   }
   TRACE_LEAVE();
 }
@@ -220,6 +227,7 @@ void NtfClient::subscriptionRemoved(SaNtfSubscriptionIdT subscriptionId,
   if (pos != subscriptionMap.end()) {
     // subscription found
     NtfSubscription* subscription = pos->second;
+    subscription->removeFromIndex(NtfAdmin::theNtfAdmin->subscriptionIndex);
     delete subscription;
     // remove subscription from subscription map
     subscriptionMap.erase(pos);
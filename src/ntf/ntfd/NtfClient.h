@@ -38,6 +38,8 @@ class NtfClient{
   void notificationReceived(unsigned int clientId,
                             NtfSmartPtr& notification,
                             MDS_SYNC_SND_CTXT *mdsCtxt);
+  void notificationMatched(SaNtfSubscriptionIdT subscriptionId,
+                           NtfSmartPtr& notification);
   void confirmNtfSend();
   unsigned int getClientId() const;
   MDS_DEST getMdsDest() const;
@@ -236,6 +236,10 @@ NtfAlarmFilter::~NtfAlarmFilter() {
   free(filter_);
 }
 
+SaNtfNotificationFilterHeaderT *NtfAlarmFilter::filterHeader() {
+  return &filter_->notificationFilterHeader;
+}
+
 bool NtfAlarmFilter::checkTrend(SaNtfAlarmNotificationT *a) {
   TRACE_8("num Trends: %hd", filter_->numTrends);
   if (filter_->numTrends) {
@@ -311,6 +315,10 @@ NtfSecurityAlarmFilter::~NtfSecurityAlarmFilter() {
   free(filter_);
 }
 
+SaNtfNotificationFilterHeaderT *NtfSecurityAlarmFilter::filterHeader() {
+  return &filter_->notificationFilterHeader;
+}
+
 /**
  * checkFilter - check if the notification matches the filter.
  *
@@ -420,6 +428,10 @@ NtfObjectCreateDeleteFilter::~NtfObjectCreateDeleteFilter() {
   free(filter_);
 }
 
+SaNtfNotificationFilterHeaderT *NtfObjectCreateDeleteFilter::filterHeader() {
+  return &filter_->notificationFilterHeader;
+}
+
 /**
  * checkFilter - check if the notification matches the filter.
  *
@@ -451,6 +463,10 @@ NtfStateChangeFilter::~NtfStateChangeFilter() {
   free(filter_);
 }
 
+SaNtfNotificationFilterHeaderT *NtfStateChangeFilter::filterHeader() {
+  return &filter_->notificationFilterHeader;
+}
+
 /**
  * checkFilter - check if the notification matches the filter.
  *
@@ -518,4 +534,8 @@ NtfAttributeChangeFilter::~NtfAttributeChangeFilter() {
   free(filter_);
 }
 
+SaNtfNotificationFilterHeaderT *NtfAttributeChangeFilter::filterHeader() {
+  return &filter_->notificationFilterHeader;
+}
+
 
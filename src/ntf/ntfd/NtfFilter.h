@@ -34,6 +34,7 @@ class NtfFilter
   NtfFilter(SaNtfNotificationTypeT filterType);
   virtual ~NtfFilter();
   virtual bool checkFilter(NtfSmartPtr& notif) = 0;
+  virtual SaNtfNotificationFilterHeaderT *filterHeader() = 0;
   SaNtfNotificationTypeT type();
   bool checkHeader(SaNtfNotificationFilterHeaderT *h, NtfSmartPtr& notif);
   bool checkEventType(SaNtfNotificationFilterHeaderT *fh, const SaNtfNotificationHeaderT *h);
@@ -55,6 +56,7 @@ class NtfAlarmFilter:public NtfFilter
   NtfAlarmFilter(SaNtfAlarmNotificationFilterT *f);
   ~NtfAlarmFilter();
   bool checkFilter(NtfSmartPtr& notif);
+  SaNtfNotificationFilterHeaderT *filterHeader();
   bool checkTrend(SaNtfAlarmNotificationT *a);
   bool checkPerceivedSeverity(SaNtfAlarmNotificationT *a);
   bool checkprobableCause(SaNtfAlarmNotificationT *a);
@@ -69,6 +71,7 @@ class NtfSecurityAlarmFilter: public NtfFilter
   NtfSecurityAlarmFilter(SaNtfSecurityAlarmNotificationFilterT *f);
   ~NtfSecurityAlarmFilter();
   bool checkFilter(NtfSmartPtr& notif);
+  SaNtfNotificationFilterHeaderT *filterHeader();
   bool checkProbableCause(SaNtfSecurityAlarmNotificationT *s);
   bool checkSeverity(SaNtfSecurityAlarmNotificationT *s);
   bool checkSecurityAlarmDetector(SaNtfSecurityAlarmNotificationT *s);
@@ -85,6 +88,7 @@ class NtfObjectCreateDeleteFilter: public NtfFilter
   NtfObjectCreateDeleteFilter(SaNtfObjectCreateDeleteNotificationFilterT *f);
   ~NtfObjectCreateDeleteFilter();
   bool checkFilter(NtfSmartPtr& notif);
+  SaNtfNotificationFilterHeaderT *filterHeader();
 
  private:
   SaNtfObjectCreateDeleteNotificationFilterT *filter_;
@@ -96,6 +100,7 @@ class NtfStateChangeFilter: public NtfFilter
   NtfStateChangeFilter(SaNtfStateChangeNotificationFilterT *f);
   ~NtfStateChangeFilter();
   bool checkFilter(NtfSmartPtr& notif);
+  SaNtfNotificationFilterHeaderT *filterHeader();
   bool checkStateId(SaUint16T ns, SaNtfStateChangeT * sc);
 
  private:
@@ -108,6 +113,7 @@ class NtfAttributeChangeFilter: public NtfFilter
   NtfAttributeChangeFilter(SaNtfAttributeChangeNotificationFilterT *f);
   ~NtfAttributeChangeFilter();
   bool checkFilter(NtfSmartPtr& notif);
+  SaNtfNotificationFilterHeaderT *filterHeader();
 
  private:
   SaNtfAttributeChangeNotificationFilterT *filter_;
@@ -126,7 +126,7 @@ void saLogWriteLogCallback(SaInvocationT invocation,
 
 
 void NtfLogger::log(NtfSmartPtr& notif, bool isLocal) {
-  unsigned int collSize = (unsigned int)coll_.size();
+  unsigned int collSize = cache_.size();
   TRACE_ENTER();
   TRACE_2("notification Id=%llu received in logger with size %d",
           notif->getNotificationId(), collSize);
@@ -140,17 +140,7 @@ void NtfLogger::log(NtfSmartPtr& notif, bool isLocal) {
   if ((notif->sendNotInfo_->notificationType == SA_NTF_TYPE_ALARM) ||
       (notif->sendNotInfo_->notificationType == SA_NTF_TYPE_SECURITY_ALARM)) {
     TRACE_2("template queue handling...");
-    if (coll_.size() < ntfs_cb->cache_size) {
-      TRACE_2("push_back");
-      coll_.push_back(notif);
-    }
-    else
-    {
-      TRACE_2("pop_front");
-      coll_.pop_front();
-      TRACE_2("push_back");
-      coll_.push_back(notif);
-    }
+    cache_.add(notif, ntfs_cb->cache_size, ntfs_cb->cache_bytes);
   }
   TRACE_LEAVE();
 }
@@ -337,6 +327,7 @@ void logEvent () {
 void NtfLogger::printInfo() {
   TRACE("Logger Information:");
   TRACE(" logQueueList size:  %u", (unsigned int)queuedNotificationList.size());
-  TRACE(" reader cache size:  %u", (unsigned int)coll_.size());
+  TRACE(" reader cache size:  %u", cache_.size());
+  TRACE(" reader cache bytes: %llu", (unsigned long long)cache_.bytes());
 }
 
@@ -65,7 +65,7 @@ class NtfLogger
  private:
   SaAisErrorT initLog();
 
-  readerNotificationListT coll_;
+  NtfReaderCache cache_;
   unsigned int readCounter;
   typedef std::list<NtfSmartPtr> QueuedNotificationsList;
   QueuedNotificationsList queuedNotificationList;
@@ -20,6 +20,7 @@
 
 #include "ntf/ntfd/NtfNotification.h"
 #include "base/logtrace.h"
+#include "base/ncssysf_mem.h"
 #include "ntf/ntfsv_enc_dec.h"
 #include "ntf/ntfsv_mem.h"
 
@@ -39,7 +40,8 @@
 NtfNotification::NtfNotification
 (SaNtfIdentifierT notificationId,
  SaNtfNotificationTypeT notificationType,
- ntfsv_send_not_req_t* sendNotInfo):notificationId_(notificationId) {
+ ntfsv_send_not_req_t* sendNotInfo):notificationId_(notificationId),
+                                   encodedNotification_(NULL) {
   logged = false;
   loggFromCallback_ = false;
   TRACE_3("constructor %p, notId: %llu", this, notificationId);
@@ -57,6 +59,8 @@ NtfNotification::~NtfNotification() {
   TRACE_3("Notification %llu with type %x destroyed.\n destructor this = %p",
           notificationId_, notificationType_, this);
   osafassert(sendNotInfo_);
+  if (encodedNotification_ != NULL)
+    m_MMGR_FREE_BUFR_LIST(encodedNotification_);
   ntfsv_dealloc_notification(sendNotInfo_);
   free(sendNotInfo_);
   sendNotInfo_ = NULL;
@@ -273,6 +277,45 @@ ntfsv_send_not_req_t* NtfNotification::getNotInfo() {
   return sendNotInfo_;
 }
 
+/**
+ * This method is called to get the notification encoded for the
+ * notification callback.
+ *
+ * The notification is encoded when it is first sent to a subscriber.
+ * The sends to all subscribers refer to the same encoded buffer.
+ *
+ * @return Encoded notification, NULL if the encoding failed.
+ */
+USRBUF* NtfNotification::getEncodedNotification() {
+  if (encodedNotification_ == NULL) {
+    NCS_UBAID uba;
+    if (ncs_enc_init_space(&uba) != NCSCC_RC_SUCCESS) {
+      LOG_ER("ncs_enc_init_space failed");
+      return NULL;
+    }
+    if (ntfsv_enc_not_msg(&uba, sendNotInfo_) != NCSCC_RC_SUCCESS) {
+      LOG_WA("Notification %llu could not be encoded", notificationId_);
+      m_MMGR_FREE_BUFR_LIST(uba.start);
+      return NULL;
+    }
+    encodedNotification_ = uba.start;
+    TRACE_3("Notification %llu encoded, %d bytes",
+            notificationId_, uba.ttl);
+  }
+  return encodedNotification_;
+}
+
+/**
+ * This method is called to free the encoded notification when it is not
+ * sent to more subscribers for now. It is encoded again if needed.
+ */
+void NtfNotification::releaseEncodedNotification() {
+  if (encodedNotification_ != NULL) {
+    m_MMGR_FREE_BUFR_LIST(encodedNotification_);
+    encodedNotification_ = NULL;
+  }
+}
+
 /**
  * This method is called if a newly started standby asks for
  * synchronization.
@@ -58,6 +58,8 @@ class NtfNotification{
   void removeSubscription(unsigned int clientId,
                           SaNtfSubscriptionIdT subscriptionId);
   ntfsv_send_not_req_t* getNotInfo();
+  USRBUF* getEncodedNotification();
+  void releaseEncodedNotification();
   void syncRequest(NCS_UBAID *uba);
   void resetSubscriptionIdList();
   SaAisErrorT getNextSubscription(UniqueSubscriptionId& subId);
@@ -77,6 +79,7 @@ class NtfNotification{
   typedef std::list<UniqueSubscriptionId> SubscriptionList;
   SubscriptionList subscriptionList;
   SubscriptionList::iterator idListPos;
+  USRBUF *encodedNotification_;
 };
 
 typedef std::tr1::shared_ptr<NtfNotification> NtfSmartPtr;
@@ -48,44 +48,82 @@
 
 
 /**
- *   NtfReader object creates a copy of the current cashed
- *   notifications. The private forward iterator ffIter is set
- *   to first element.
+ *   NtfReader object reads the notifications in the logger's
+ *   cache when the reader is created. The notifications are not
+ *   copied. The reader starts at the oldest notification.
  *   @param ntfLogger
  *   @param readerId
  *
  */
 NtfReader::NtfReader(NtfLogger& ntfLogger, unsigned int readerId):
-    coll_(ntfLogger.coll_),
-    ffIter(coll_.begin()),
+    NtfReader(ntfLogger.cache_, readerId) {
+}
+
+/**
+ *   NtfReader object reading the notifications in a cache.
+ *   @param cache
+ *   @param readerId
+ */
+NtfReader::NtfReader(NtfReaderCache& cache, unsigned int readerId):
+    cache_(cache),
+    viewBegin_(cache_.begin()),
+    viewEnd_(cache_.end()),
+    cursor_(viewBegin_),
+    pastEnd_(false),
+    useFilter_(false),
     readerId_(readerId),
     c_filter_(0),
     firstRead(true) {
   searchCriteria_.eventTime = 0;
   searchCriteria_.notificationId = 0;
   searchCriteria_.searchMode = SA_NTF_SEARCH_NOTIFICATION_ID;
-  TRACE_3("ntfLogger.coll_.size: %u", (unsigned int)ntfLogger.coll_.size());
+  TRACE_3("ntfLogger cache size: %u", cache_.size());
 }
 
 /**
- *   NtfReader object creates a copy of the current cashed
- *   notifications that matches the filter and the search
- *   criteria. The private forward iterator ffIter is set
- *   according to the searchCriteria. This constructor is used
- *   when filter is provided.
+ *   NtfReader object reads the notifications in the logger's
+ *   cache when the reader is created that matches the filter and
+ *   the search criteria. The notifications are not copied. The
+ *   reader is positioned according to the searchCriteria. This
+ *   constructor is used when filter is provided.
  *
  *   @param ntfLogger
  *   @param readerId
  *   @param searchCriteria
  *   @param f_rec - filter record
- *   @param firstRead
  */
 NtfReader::NtfReader(NtfLogger& ntfLogger,
                      unsigned int readerId,
                      SaNtfSearchCriteriaT searchCriteria,
-                     ntfsv_filter_ptrs_t *f_rec):readerId_(readerId),searchCriteria_(searchCriteria),c_filter_(NtfCriteriaFilter::getCriteriaFilter(searchCriteria, this)),firstRead(true)
+                     ntfsv_filter_ptrs_t *f_rec):
+    NtfReader(ntfLogger.cache_, readerId, searchCriteria, f_rec) {
+}
+
+/**
+ *   NtfReader object reading the notifications in a cache that
+ *   match the filter and the search criteria.
+ *
+ *   @param cache
+ *   @param readerId
+ *   @param searchCriteria
+ *   @param f_rec - filter record
+ */
+NtfReader::NtfReader(NtfReaderCache& cache,
+                     unsigned int readerId,
+                     SaNtfSearchCriteriaT searchCriteria,
+                     ntfsv_filter_ptrs_t *f_rec):
+    cache_(cache),
+    viewBegin_(cache_.begin()),
+    viewEnd_(cache_.end()),
+    cursor_(viewBegin_),
+    pastEnd_(false),
+    useFilter_(true),
+    readerId_(readerId),
+    searchCriteria_(searchCriteria),
+    c_filter_(NtfCriteriaFilter::getCriteriaFilter(searchCriteria, this)),
+    firstRead(true)
 {
-  TRACE_3("New NtfReader with filter, ntfLogger.coll_.size: %u", (unsigned int)ntfLogger.coll_.size());
+  TRACE_3("New NtfReader with filter, ntfLogger cache size: %u", cache_.size());
   if (f_rec->alarm_filter) {
     NtfFilter* filter = new NtfAlarmFilter(f_rec->alarm_filter);
     filterMap[filter->type()] = filter;
@@ -94,7 +132,7 @@ NtfReader::NtfReader(NtfLogger& ntfLogger,
     NtfFilter* filter = new NtfSecurityAlarmFilter(f_rec->sec_al_filter);
     filterMap[filter->type()] = filter;
   }
-  filterCacheList(ntfLogger);
+  c_filter_->find();
 }
 
 NtfReader::~NtfReader() {
@@ -109,42 +147,65 @@ NtfReader::~NtfReader() {
 }
 
 /**
- * This method is called to check which notifications that
- * matches the filtering criterias.
+ * This method is called to check if the notification at a
+ * position in the cache is read by this reader.
  *
- * For those notifications that matches the different
- * notification type filter criterias (only alarms and security
- * alarms notification types is possible) a help object derived
- * from NtfCriteriaFilter class will save notifcations in the
- * NtfReader collection that matches the saNtfSearchCriteria
- * that has been set.
+ * Only alarms and security alarms are cached. The notification
+ * must match the notification type filters and the search criteria.
  *
- *   @param ntfLogger
+ *   @param pos - position in the cache
  */
-void NtfReader::filterCacheList(NtfLogger& ntfLogger) {
-  readerNotificationListT::iterator rpos;
-  for (rpos = ntfLogger.coll_.begin(); rpos != ntfLogger.coll_.end(); rpos++) {
-    NtfSmartPtr n (*rpos);
-    bool rv = false;
-    FilterMap::iterator pos = filterMap.find(n->getNotificationType());
-    if (pos != filterMap.end()) {
-      NtfFilter* filter = pos->second;
-      osafassert(filter);
-      rv = filter->checkFilter(n);
-    }
-    if (rv){
-      if (!c_filter_->filter(n))
-        break;
+bool NtfReader::matches(Position pos) {
+  if (!useFilter_)
+    return true;
+  NtfSmartPtr& n = cache_.at(pos);
+  FilterMap::iterator fpos = filterMap.find(n->getNotificationType());
+  if (fpos == filterMap.end())
+    return false;
+  NtfFilter* filter = fpos->second;
+  osafassert(filter);
+  return filter->checkFilter(n) && c_filter_->filter(n);
+}
+
+/**
+ *   @param from - position to start at
+ *   @return position of the first notification read at or after
+ *           from, viewEnd_ if there is none.
+ */
+NtfReader::Position NtfReader::nextMatch(Position from) {
+  Position pos = from > cache_.begin() ? from : cache_.begin();
+  for (; pos < viewEnd_; pos++) {
+    if (matches(pos))
+      return pos;
+  }
+  return viewEnd_;
+}
+
+/**
+ *   @param before - position to start before
+ *   @param pos - outparam, position of the last notification read
+ *          before the position
+ *   @return true if a notification was found
+ */
+bool NtfReader::prevMatch(Position before, Position* pos) {
+  Position first = viewBegin_ > cache_.begin() ? viewBegin_ : cache_.begin();
+  Position p = before < viewEnd_ ? before : viewEnd_;
+  while (p > first) {
+    p--;
+    if (matches(p)) {
+      *pos = p;
+      return true;
     }
   }
-  c_filter_->finalize();
+  return false;
 }
 
 /**
  *   This method returns the notification at the current
- *   position of the iterator ffIter if search direction is
+ *   position of the cursor if search direction is
  *   SA_NTF_SEARCH_YOUNGER. The first search will give the same
- *   result for both search directions.
+ *   result for both search directions. Notifications removed
+ *   from the cache since the reader was created are skipped.
  *
  *   @param searchDirection
  *   @param error - outparam tells if the operation succeded
@@ -157,47 +218,50 @@ NtfReader::next(SaNtfSearchDirectionT direction,
   TRACE_ENTER();
 
   *error = SA_AIS_ERR_NOT_EXIST;
+  Position pos = viewEnd_;
+  bool found;
 
   if (direction == SA_NTF_SEARCH_YOUNGER ||
       searchCriteria_.searchMode == SA_NTF_SEARCH_AT_TIME ||
       searchCriteria_.searchMode == SA_NTF_SEARCH_ONLY_FILTER) {
-    if (ffIter >= coll_.end()) {
-      *error = SA_AIS_ERR_NOT_EXIST;
-      TRACE_LEAVE();
-      NtfSmartPtr notif;
-      firstRead = false;
-      return notif;
-    }
-    NtfSmartPtr notif(*ffIter);
-    ffIter++;
-    *error = SA_AIS_OK;
-    TRACE_LEAVE();
-    firstRead = false;
-    return notif;
+    if (!pastEnd_)
+      pos = nextMatch(cursor_);
+    found = pos < viewEnd_;
   }
   else  // SA_NTF_SEARCH_OLDER
   {
-    readerNotReverseIterT rIter(ffIter);
-    if (firstRead)
-      rIter--;
-    else
-      rIter++;
-
-    if (rIter >= coll_.rend() || rIter < coll_.rbegin()) {
-      *error = SA_AIS_ERR_NOT_EXIST;
-      ffIter = rIter.base();
-      TRACE_LEAVE();
-      NtfSmartPtr notif;
-      firstRead = false;
-      return notif;
+    if (firstRead) {
+      // the notification at the cursor
+      if (!pastEnd_)
+        pos = nextMatch(cursor_);
+      found = pos < viewEnd_;
+      if (!found)
+        pastEnd_ = true;
+    } else if (pastEnd_) {
+      found = prevMatch(viewEnd_, &pos);
+    } else {
+      // the notification before the last one read
+      Position prev;
+      found = prevMatch(cursor_, &prev) && prevMatch(prev, &pos);
     }
-    NtfSmartPtr notif(*rIter);
-    ffIter = rIter.base();
-    *error = SA_AIS_OK;
+    if (!found && !firstRead) {
+      cursor_ = viewBegin_;
+      pastEnd_ = false;
+    }
+  }
+  firstRead = false;
+
+  if (!found) {
     TRACE_LEAVE();
-    firstRead = false;
+    NtfSmartPtr notif;
     return notif;
   }
+  NtfSmartPtr notif(cache_.at(pos));
+  cursor_ = pos + 1;
+  pastEnd_ = false;
+  *error = SA_AIS_OK;
+  TRACE_LEAVE();
+  return notif;
 }
 
 unsigned int NtfReader::getId() {
@@ -208,199 +272,238 @@ unsigned int NtfReader::getId() {
  *   NtfCriteriaFilter is a base class for all searchCriteria
  *   filters. NtfCriteriaFilter and its derived classes are help
  *   classes to the NtfReader class. The derived classes must
- *   implementer the filter() method.
+ *   implement the find() method, which sets the notifications
+ *   read and the start position of the reader.
+ *
+ *   Event times are found by binary search if the cache is time
+ *   ordered, else by scanning the cache.
  *
  *   @param searchCriteria
  *   @param reader
  */
 NtfCriteriaFilter::NtfCriteriaFilter(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):
-    searchCriteria_(searchCriteria), reader_(reader), i_(-1), startIdx_(0) {
+    searchCriteria_(searchCriteria), reader_(reader) {
 }
 
 NtfCriteriaFilter::~NtfCriteriaFilter() {
 }
 
-void NtfCriteriaFilter::add(NtfSmartPtr& n) {
-  reader_->coll_.push_back(n);
-  i_++;
+/**
+ *   Notifications are only read if they match this filter, in
+ *   addition to the notification type filters.
+ */
+bool NtfCriteriaFilter::filter(NtfSmartPtr& n) {
+  return true;
 }
 
-void NtfCriteriaFilter::setIndexCurrent() {
-  if (reader_->coll_.size()) {
-    startIdx_=i_;
-  }
+NtfReaderCache& NtfCriteriaFilter::cache() {
+  return reader_->cache_;
 }
 
-void NtfCriteriaFilter::removeTail() {
-  if (reader_->coll_.size()) {
-    reader_->coll_.erase(reader_->coll_.begin() +  startIdx_ + 1, reader_->coll_.end());
-    i_= startIdx_;
-  };
+NtfCriteriaFilter::Position NtfCriteriaFilter::viewBegin() {
+  return reader_->viewBegin_;
 }
 
-void NtfCriteriaFilter::removeHead() {
-  if (reader_->coll_.size()) {
-    reader_->coll_.erase(reader_->coll_.begin(), reader_->coll_.begin() + startIdx_);
-    i_ -= startIdx_;
-    startIdx_ = 0;
-  }
+NtfCriteriaFilter::Position NtfCriteriaFilter::viewEnd() {
+  return reader_->viewEnd_;
 }
 
-void NtfCriteriaFilter::finalize() {
-  startIdx_=0;
-  convertToIter();
+bool NtfCriteriaFilter::matches(Position pos) {
+  return reader_->matches(pos);
 }
 
-void NtfCriteriaFilter::convertToIter() {
-  reader_->ffIter = reader_->coll_.begin() + startIdx_;
+bool NtfCriteriaFilter::prevMatch(Position before, Position* pos) {
+  return reader_->prevMatch(before, pos);
 }
 
-NtfBeforeAtTime::NtfBeforeAtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader), eTimeFound_(false) {
-  TRACE_3("NtfBeforeAtTime constructor");
+void NtfCriteriaFilter::setView(Position begin, Position end, Position start) {
+  reader_->viewBegin_ = begin;
+  reader_->viewEnd_ = end;
+  reader_->cursor_ = start;
 }
 
-bool NtfBeforeAtTime::filter(NtfSmartPtr& n) {
-  add(n);
-  if (*n->header()->eventTime == searchCriteria_.eventTime) {
-    setIndexCurrent();
-    eTimeFound_ = true;
+bool NtfCriteriaFilter::firstAtOrAfter(Position* pos) {
+  NtfReaderCache& cache = reader_->cache_;
+  Position end = reader_->viewEnd_;
+  Position p;
+  if (cache.timeOrdered()) {
+    p = reader_->nextMatch(cache.lowerBoundTime(reader_->viewBegin_, end,
+                                                searchCriteria_.eventTime));
+  } else {
+    /* The first notification at the time is preferred to an
+     * earlier one after the time */
+    if (firstAt(pos))
+      return true;
+    p = reader_->nextMatch(reader_->viewBegin_);
+    while (p < end && cache.eventTime(p) < searchCriteria_.eventTime)
+      p = reader_->nextMatch(p + 1);
   }
-  return true;
+  *pos = p;
+  return p < end;
 }
 
-void NtfBeforeAtTime::finalize() {
-  TRACE_3("NtfBeforeAtTime finalize");
-  if(eTimeFound_) {
-    removeTail();
+bool NtfCriteriaFilter::firstAt(Position* pos) {
+  NtfReaderCache& cache = reader_->cache_;
+  Position end = reader_->viewEnd_;
+  Position p;
+  if (cache.timeOrdered()) {
+    p = reader_->nextMatch(cache.lowerBoundTime(reader_->viewBegin_, end,
+                                                searchCriteria_.eventTime));
+  } else {
+    p = reader_->nextMatch(reader_->viewBegin_);
+    while (p < end && cache.eventTime(p) != searchCriteria_.eventTime)
+      p = reader_->nextMatch(p + 1);
   }
-  setIndexCurrent();
-  convertToIter();
+  *pos = p;
+  return p < end && cache.eventTime(p) == searchCriteria_.eventTime;
 }
 
-AtTime::AtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
-  TRACE_3("AtTime constructor");
+bool NtfCriteriaFilter::lastAt(Position* pos) {
+  NtfReaderCache& cache = reader_->cache_;
+  if (cache.timeOrdered()) {
+    Position p = cache.upperBoundTime(reader_->viewBegin_, reader_->viewEnd_,
+                                      searchCriteria_.eventTime);
+    return reader_->prevMatch(p, pos) &&
+        cache.eventTime(*pos) == searchCriteria_.eventTime;
+  }
+  Position p = reader_->viewEnd_;
+  while (reader_->prevMatch(p, pos)) {
+    if (cache.eventTime(*pos) == searchCriteria_.eventTime)
+      return true;
+    p = *pos;
+  }
+  return false;
 }
 
-bool AtTime::filter(NtfSmartPtr& n) {
-  if (*n->header()->eventTime == searchCriteria_.eventTime) {
-    add(n);
-  }
-  return true;
+bool NtfCriteriaFilter::last(Position* pos) {
+  return reader_->prevMatch(reader_->viewEnd_, pos);
 }
 
-NtfAtOrAfterTime::NtfAtOrAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader),indexSaved_(false), eTimeFound_(false) {
-  TRACE_3("NtfAtOrAfterTime constructor");
+NtfBeforeAtTime::NtfBeforeAtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
+  TRACE_3("NtfBeforeAtTime constructor");
 }
 
-bool NtfAtOrAfterTime::filter(NtfSmartPtr& n) {
-  add(n);
-  if (*n->header()->eventTime == searchCriteria_.eventTime) {
-    if (!eTimeFound_) {
-      setIndexCurrent();
-      indexSaved_ = true;
-      eTimeFound_ = true;
-    }
-  } else if (!eTimeFound_ && (*n->header()->eventTime > searchCriteria_.eventTime)) {
-    if (!indexSaved_) {
-      setIndexCurrent();
-      indexSaved_ = true;
-    }
+/**
+ *   Read from the last notification at the time, or from the
+ *   last notification if there is none at the time.
+ */
+void NtfBeforeAtTime::find() {
+  TRACE_3("NtfBeforeAtTime find");
+  Position begin = viewBegin();
+  Position end = viewEnd();
+  Position pos;
+  if (lastAt(&pos)) {
+    setView(begin, pos + 1, pos);
+  } else if (last(&pos)) {
+    setView(begin, end, pos);
+  } else {
+    setView(begin, end, end);
   }
-  return true;
 }
 
-void NtfAtOrAfterTime::finalize() {
-  if (indexSaved_) {
-    removeHead();
+AtTime::AtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
+  TRACE_3("AtTime constructor");
+}
+
+/**
+ *   Read the notifications at the time.
+ */
+void AtTime::find() {
+  if (cache().timeOrdered()) {
+    Position begin = cache().lowerBoundTime(viewBegin(), viewEnd(),
+                                            searchCriteria_.eventTime);
+    Position end = cache().upperBoundTime(begin, viewEnd(),
+                                          searchCriteria_.eventTime);
+    setView(begin, end, begin);
   }
-  convertToIter();
 }
 
-NtfBeforeTime::NtfBeforeTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader),indexSaved_(false), eTimeFound_(false) {
-  TRACE_3("NtfBeforeTime constructor");
+bool AtTime::filter(NtfSmartPtr& n) {
+  return *n->header()->eventTime == searchCriteria_.eventTime;
 }
 
-bool NtfBeforeTime::filter(NtfSmartPtr& n) {
-  if (*n->header()->eventTime == searchCriteria_.eventTime) {
-    if (!indexSaved_) {
-      setIndexCurrent();
-      indexSaved_ = true;
-      eTimeFound_     = true;
-    }
-    return false;
-  } else if (!eTimeFound_ && (*n->header()->eventTime > searchCriteria_.eventTime)) {
-    if (!indexSaved_) {
-      setIndexCurrent();
-      indexSaved_ = true;
-    }
-  }
-  add(n);
-  return true;
+NtfAtOrAfterTime::NtfAtOrAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
+  TRACE_3("NtfAtOrAfterTime constructor");
 }
 
-void NtfBeforeTime::finalize() {
-  if (!indexSaved_) {
-    setIndexCurrent();
-  } else {
-    if(eTimeFound_) {
-      removeTail();
-    }
-    setIndexCurrent();
+/**
+ *   Read the notifications from the first one at the time, else
+ *   from the first one after the time, or all notifications if
+ *   there is none.
+ */
+void NtfAtOrAfterTime::find() {
+  Position pos;
+  if (firstAtOrAfter(&pos)) {
+    setView(pos, viewEnd(), pos);
   }
-  convertToIter();
 }
 
-NtfAfterTime::NtfAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader),indexSaved_(false), eTimeFound_(false) {
-  TRACE_3("NtfAfterTime constructor");
+NtfBeforeTime::NtfBeforeTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
+  TRACE_3("NtfBeforeTime constructor");
 }
 
-bool NtfAfterTime::filter(NtfSmartPtr& n) {
-  add(n);
-  if (*n->header()->eventTime == searchCriteria_.eventTime) {
-    if (!eTimeFound_) {
-      indexSaved_ = true;
-      eTimeFound_ = true;
-    }
-    setIndexCurrent();
-  } else if (eTimeFound_ && (*n->header()->eventTime > searchCriteria_.eventTime)) {
-    if (!indexSaved_) {
-      setIndexCurrent();
-      indexSaved_ = true;
-    }
+/**
+ *   Read the notifications before the first one at the time,
+ *   starting from the last of them. Read from the last
+ *   notification if there is none at the time.
+ */
+void NtfBeforeTime::find() {
+  Position begin = viewBegin();
+  Position end = viewEnd();
+  Position pos;
+  Position at;
+  if (firstAt(&at)) {
+    end = at;
+    if (!prevMatch(end, &pos))
+      pos = end;
+  } else if (!last(&pos)) {
+    pos = end;
   }
-  return true;
+  setView(begin, end, pos);
+}
+
+NtfAfterTime::NtfAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
+  TRACE_3("NtfAfterTime constructor");
 }
 
-void NtfAfterTime::finalize() {
-  if (indexSaved_) {
-    startIdx_++;
-    removeHead();
+/**
+ *   Read the notifications after the last one at the time, or
+ *   all notifications if there is none at the time.
+ */
+void NtfAfterTime::find() {
+  Position pos;
+  if (lastAt(&pos)) {
+    setView(pos + 1, viewEnd(), pos + 1);
   }
-  convertToIter();
 }
 
 NtfOnlyFilter::NtfOnlyFilter(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
   TRACE_3("NtfOnlyFilter constructor");
 }
 
-
-bool NtfOnlyFilter::filter(NtfSmartPtr& n) {
-  unsigned int nId =  n->getNotificationId();
-  TRACE_3("nId: %u added to readerList", nId);
-  add(n);
-  return true;
+/**
+ *   Read all notifications.
+ */
+void NtfOnlyFilter::find() {
 }
 
 NtfIdSearch::NtfIdSearch(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader):NtfCriteriaFilter(searchCriteria,reader) {
   TRACE_3("NtfIdSearch constructor");
 }
 
-bool NtfIdSearch::filter(NtfSmartPtr& n) {
-  if (*n->header()->notificationId == searchCriteria_.notificationId) {
-    add(n);
-    return false;
+/**
+ *   Read the notification with the notification id.
+ */
+void NtfIdSearch::find() {
+  Position end = viewEnd();
+  Position pos = cache().findId(viewBegin(), end,
+                                searchCriteria_.notificationId);
+  if (pos < end && matches(pos)) {
+    TRACE_3("nId: %llu found", searchCriteria_.notificationId);
+    setView(pos, pos + 1, pos);
+  } else {
+    setView(end, end, end);
   }
-  return true;
 }
 
 NtfCriteriaFilter* NtfCriteriaFilter::getCriteriaFilter(SaNtfSearchCriteriaT& sc, NtfReader* r) {
@@ -25,6 +25,7 @@
  */
 #include "ntf/ntfd/NtfNotification.h"
 #include "ntf/ntfd/NtfFilter.h"
+#include "ntf/ntfd/NtfReaderCache.h"
 /* ========================================================================
  *   DEFINITIONS
  * ========================================================================
@@ -34,9 +35,6 @@
  *   TYPE DEFINITIONS
  * ========================================================================
  */
-typedef std::deque<NtfSmartPtr> readerNotificationListT;
-typedef std::deque<NtfSmartPtr>::iterator readerNotificationListTIter;
-typedef std::deque<NtfSmartPtr>::reverse_iterator readerNotReverseIterT;
 
 /* ========================================================================
  *   DATA DECLARATIONS
@@ -54,15 +52,32 @@ class NtfReader
             unsigned int readerId,
             SaNtfSearchCriteriaT searchCriteria,
             ntfsv_filter_ptrs_t *f_rec);
+  NtfReader(NtfReaderCache& cache, unsigned int readerId);
+  NtfReader(NtfReaderCache& cache,
+            unsigned int readerId,
+            SaNtfSearchCriteriaT searchCriteria,
+            ntfsv_filter_ptrs_t *f_rec);
   ~NtfReader();
-  void filterCacheList(NtfLogger& ntfLogger);
   NtfSmartPtr next(SaNtfSearchDirectionT direction,
                    SaAisErrorT* error);
   unsigned int getId();
 
  private:
-  readerNotificationListT coll_;
-  readerNotificationListTIter ffIter;
+  typedef NtfReaderCache::Position Position;
+
+  bool matches(Position pos);
+  Position nextMatch(Position from);
+  bool prevMatch(Position before, Position* pos);
+
+  NtfReaderCache& cache_;
+  /* the notifications read are the matching ones in [viewBegin_, viewEnd_) */
+  Position viewBegin_;
+  Position viewEnd_;
+  /* next notification to read in the younger direction */
+  Position cursor_;
+  /* an older read found no notification after the view */
+  bool pastEnd_;
+  bool useFilter_;
   FilterMap filterMap;
   unsigned int readerId_;
   SaNtfSearchCriteriaT searchCriteria_;
@@ -70,39 +85,45 @@ class NtfReader
   bool firstRead;
 };
 
+/* Positions the reader according to the search criteria. */
 class NtfCriteriaFilter
 {
  public:
   NtfCriteriaFilter(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
   virtual ~NtfCriteriaFilter();
   static NtfCriteriaFilter* getCriteriaFilter(SaNtfSearchCriteriaT& sc, NtfReader* r);
-  virtual bool filter(NtfSmartPtr& n)=0;
-  void add(NtfSmartPtr& n);
-  void setIndexCurrent();
-  virtual void finalize();
-  void removeTail();
-  void removeHead();
-  void convertToIter();
+  virtual void find()=0;
+  virtual bool filter(NtfSmartPtr& n);
  protected:
+  typedef NtfReaderCache::Position Position;
+
+  NtfReaderCache& cache();
+  Position viewBegin();
+  Position viewEnd();
+  bool matches(Position pos);
+  bool prevMatch(Position before, Position* pos);
+  void setView(Position begin, Position end, Position start);
+  bool firstAtOrAfter(Position* pos);
+  bool firstAt(Position* pos);
+  bool lastAt(Position* pos);
+  bool last(Position* pos);
+
   SaNtfSearchCriteriaT searchCriteria_;
   NtfReader* reader_;
-  int i_;
-  int startIdx_;
 };
 
 class NtfBeforeAtTime:public NtfCriteriaFilter
 {
  public:
   NtfBeforeAtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
-  void finalize();
-  bool eTimeFound_;
+  void find();
 };
 
 class AtTime:public NtfCriteriaFilter
 {
  public:
   AtTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
+  void find();
   bool filter(NtfSmartPtr& n);
 };
 
@@ -110,48 +131,35 @@ class NtfAtOrAfterTime:public NtfCriteriaFilter
 {
  public:
   NtfAtOrAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
-  void finalize();
- private:
-  bool indexSaved_;
-  bool eTimeFound_;
+  void find();
 };
 
 class NtfBeforeTime:public NtfCriteriaFilter
 {
  public:
   NtfBeforeTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
-  void finalize();
-
- private:
-  bool indexSaved_;
-  bool eTimeFound_;
+  void find();
 };
 
 class NtfAfterTime:public NtfCriteriaFilter
 {
  public:
   NtfAfterTime(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
-  void finalize();
- private:
-  bool indexSaved_;
-  bool eTimeFound_;
+  void find();
 };
 
 class NtfOnlyFilter:public NtfCriteriaFilter
 {
  public:
   NtfOnlyFilter(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
+  void find();
 };
 
 class NtfIdSearch:public NtfCriteriaFilter
 {
  public:
   NtfIdSearch(SaNtfSearchCriteriaT& searchCriteria, NtfReader* reader);
-  bool filter(NtfSmartPtr& n);
+  void find();
 };
 
 #endif  // NTF_NTFD_NTFREADER_H_
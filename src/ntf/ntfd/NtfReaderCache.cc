@@ -0,0 +1,257 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/**
+ *   This object holds the notifications that can be read with the
+ *   reader API.
+ *
+ *   The notifications are kept in the order they were received. The oldest
+ *   notifications are removed when the cache holds more notifications or
+ *   more bytes than configured. Readers refer to the notifications by
+ *   position and do not copy the cache.
+ *
+ *   Event times and notification ids normally increase with the position
+ *   and are then searched by binary search. The number of notifications
+ *   out of order is counted so that a search can fall back to scanning.
+ */
+
+#include "ntf/ntfd/NtfReaderCache.h"
+#include "base/logtrace.h"
+#include "base/osaf_extended_name.h"
+#include "ntf/ntfsv_mem.h"
+
+/**
+ * This is the constructor.
+ */
+NtfReaderCache::NtfReaderCache():firstPos(0), numBytes(0), timeInversions(0),
+                                 idInversions(0) {
+}
+
+/**
+ * This is the destructor.
+ */
+NtfReaderCache::~NtfReaderCache() {
+}
+
+static uint64_t nameSize(const SaNameT *name) {
+  return name != NULL ? osaf_extended_name_length(name) : 0;
+}
+
+/**
+ * This method is called to estimate the memory used by a notification.
+ *
+ * @param notification
+ *               Pointer to the notification object.
+ * @return Number of bytes allocated for the notification.
+ */
+uint64_t NtfReaderCache::notificationSize(NtfSmartPtr& notification) {
+  ntfsv_send_not_req_t *info = notification->getNotInfo();
+  const SaNtfNotificationHeaderT *h = notification->header();
+  uint64_t size = sizeof(NtfNotification) + sizeof(*info) +
+      info->variable_data.size;
+
+  size += h->numCorrelatedNotifications * sizeof(SaNtfIdentifierT) +
+      h->lengthAdditionalText +
+      h->numAdditionalInfo * sizeof(SaNtfAdditionalInfoT) +
+      nameSize(h->notificationObject) + nameSize(h->notifyingObject);
+  if (info->notificationType == SA_NTF_TYPE_ALARM) {
+    const SaNtfAlarmNotificationT *a = &info->notification.alarm;
+    size += a->numSpecificProblems * sizeof(SaNtfSpecificProblemT) +
+        a->numMonitoredAttributes * sizeof(SaNtfAttributeT) +
+        a->numProposedRepairActions * sizeof(SaNtfProposedRepairActionT);
+  }
+  return size;
+}
+
+/**
+ * This method is called to add a notification to the cache.
+ *
+ * The oldest notifications are removed until there is room for the
+ * notification.
+ *
+ * @param notification
+ *               Pointer to the notification object.
+ * @param maxEntries Maximum number of notifications in the cache.
+ * @param maxBytes Maximum number of bytes used by the notifications
+ *                 in the cache, 0 for no limit.
+ */
+void NtfReaderCache::add(NtfSmartPtr& notification, unsigned int maxEntries,
+                         uint64_t maxBytes) {
+  if (maxEntries == 0)
+    return;
+
+  Entry entry;
+  entry.notification = notification;
+  entry.eventTime = *notification->header()->eventTime;
+  entry.notificationId = notification->getNotificationId();
+  entry.size = notificationSize(notification);
+
+  while (!entries.empty() &&
+         (entries.size() >= maxEntries ||
+          (maxBytes != 0 && numBytes + entry.size > maxBytes))) {
+    removeOldest();
+  }
+
+  if (!entries.empty()) {
+    if (entry.eventTime < entries.back().eventTime)
+      timeInversions++;
+    if (entry.notificationId < entries.back().notificationId)
+      idInversions++;
+  }
+  entries.push_back(entry);
+  numBytes += entry.size;
+  TRACE_2("Notification %llu cached, %u notifications, %llu bytes",
+          entry.notificationId, size(), (unsigned long long)numBytes);
+}
+
+void NtfReaderCache::removeOldest() {
+  const Entry& oldest = entries[0];
+  if (entries.size() > 1) {
+    if (entries[1].eventTime < oldest.eventTime)
+      timeInversions--;
+    if (entries[1].notificationId < oldest.notificationId)
+      idInversions--;
+  }
+  numBytes -= oldest.size;
+  entries.pop_front();
+  firstPos++;
+}
+
+/**
+ * @return Position of the oldest notification in the cache.
+ */
+NtfReaderCache::Position NtfReaderCache::begin() const {
+  return firstPos;
+}
+
+/**
+ * @return Position after the youngest notification in the cache.
+ */
+NtfReaderCache::Position NtfReaderCache::end() const {
+  return firstPos + entries.size();
+}
+
+/**
+ * @param pos Position in [begin(), end()).
+ * @return Pointer to the notification object at the position.
+ */
+NtfSmartPtr& NtfReaderCache::at(Position pos) {
+  return entries[pos - firstPos].notification;
+}
+
+/**
+ * @param pos Position in [begin(), end()).
+ * @return Event time of the notification at the position.
+ */
+SaTimeT NtfReaderCache::eventTime(Position pos) const {
+  return entries[pos - firstPos].eventTime;
+}
+
+/**
+ * @return true if no notification has an older event time than the
+ *         notification before it.
+ */
+bool NtfReaderCache::timeOrdered() const {
+  return timeInversions == 0;
+}
+
+/**
+ * This method is called to find the first notification with an event
+ * time at or after a time. The cache must be time ordered.
+ *
+ * @param first,last Positions to search, within [begin(), end()].
+ * @param time Event time to search for.
+ * @return Position of the notification, last if there is none.
+ */
+NtfReaderCache::Position NtfReaderCache::lowerBoundTime(Position first,
+                                                        Position last,
+                                                        SaTimeT time) const {
+  while (first < last) {
+    Position mid = first + (last - first) / 2;
+    if (eventTime(mid) < time)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+  return first;
+}
+
+/**
+ * This method is called to find the first notification with an event
+ * time after a time. The cache must be time ordered.
+ *
+ * @param first,last Positions to search, within [begin(), end()].
+ * @param time Event time to search for.
+ * @return Position of the notification, last if there is none.
+ */
+NtfReaderCache::Position NtfReaderCache::upperBoundTime(Position first,
+                                                        Position last,
+                                                        SaTimeT time) const {
+  while (first < last) {
+    Position mid = first + (last - first) / 2;
+    if (eventTime(mid) <= time)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+  return first;
+}
+
+/**
+ * This method is called to find a notification by notification id.
+ *
+ * @param first,last Positions to search, within [begin(), end()].
+ * @param id Notification id to search for.
+ * @return Position of the notification, last if it is not found.
+ */
+NtfReaderCache::Position NtfReaderCache::findId(Position first,
+                                                Position last,
+                                                SaNtfIdentifierT id) const {
+  if (idInversions != 0) {
+    for (Position pos = first; pos < last; pos++) {
+      if (entries[pos - firstPos].notificationId == id)
+        return pos;
+    }
+    return last;
+  }
+
+  Position end = last;
+  while (first < last) {
+    Position mid = first + (last - first) / 2;
+    if (entries[mid - firstPos].notificationId < id)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+  if (first != end && entries[first - firstPos].notificationId == id)
+    return first;
+  return end;
+}
+
+/**
+ * @return Number of notifications in the cache.
+ */
+unsigned int NtfReaderCache::size() const {
+  return entries.size();
+}
+
+/**
+ * @return Number of bytes used by the notifications in the cache.
+ */
+uint64_t NtfReaderCache::bytes() const {
+  return numBytes;
+}
@@ -0,0 +1,73 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/**
+ *   This object holds the notifications that can be read with the
+ *   reader API, oldest first. It is shared by all readers.
+ */
+
+#ifndef NTF_NTFD_NTFREADERCACHE_H_
+#define NTF_NTFD_NTFREADERCACHE_H_
+
+#include <stdint.h>
+#include <deque>
+#include "ntf/ntfd/NtfNotification.h"
+
+class NtfReaderCache{
+
+ public:
+  /* Position of a notification. Positions are never reused, a position
+   * below begin() refers to a notification removed from the cache.
+   */
+  typedef uint64_t Position;
+
+  NtfReaderCache();
+  virtual ~NtfReaderCache();
+  void add(NtfSmartPtr& notification, unsigned int maxEntries,
+           uint64_t maxBytes);
+  Position begin() const;
+  Position end() const;
+  NtfSmartPtr& at(Position pos);
+  SaTimeT eventTime(Position pos) const;
+  bool timeOrdered() const;
+  Position lowerBoundTime(Position first, Position last, SaTimeT time) const;
+  Position upperBoundTime(Position first, Position last, SaTimeT time) const;
+  Position findId(Position first, Position last, SaNtfIdentifierT id) const;
+  unsigned int size() const;
+  uint64_t bytes() const;
+  static uint64_t notificationSize(NtfSmartPtr& notification);
+
+ private:
+  struct Entry {
+    NtfSmartPtr notification;
+    SaTimeT eventTime;
+    SaNtfIdentifierT notificationId;
+    uint64_t size;
+  };
+  typedef std::deque<Entry> EntryList;
+
+  void removeOldest();
+
+  EntryList entries;
+  Position firstPos;
+  uint64_t numBytes;
+  /* number of notifications older than the notification before them */
+  unsigned int timeInversions;
+  unsigned int idInversions;
+};
+
+#endif  // NTF_NTFD_NTFREADERCACHE_H_
@@ -145,6 +145,31 @@ bool NtfSubscription::checkSubscription(NtfSmartPtr& notification) {
   return(rv);
 }
 
+/**
+ * Add the filters of the subscription to the subscription index.
+ *
+ * @param index The subscription index.
+ */
+void NtfSubscription::addToIndex(NtfSubscriptionIndex& index) {
+  FilterMap::iterator pos;
+  for (pos = filterMap.begin(); pos != filterMap.end(); pos++) {
+    index.filterAdded(s_info_.client_id, subscriptionId_, pos->second);
+  }
+}
+
+/**
+ * Remove the filters of the subscription from the subscription index.
+ * Must be done before the subscription is deleted.
+ *
+ * @param index The subscription index.
+ */
+void NtfSubscription::removeFromIndex(NtfSubscriptionIndex& index) {
+  FilterMap::iterator pos;
+  for (pos = filterMap.begin(); pos != filterMap.end(); pos++) {
+    index.filterRemoved(s_info_.client_id, subscriptionId_, pos->second);
+  }
+}
+
 /**
  * Add a notification Id to the discarded list
  *
@@ -220,7 +245,9 @@ void NtfSubscription::sendNotification(NtfSmartPtr& notification, NtfClient *cli
     // send notification
     TRACE_3("send_notification_lib called, client %u, notification %llu",
             client->getClientId(), notification->getNotificationId());
-    if (send_notification_lib(notification->getNotInfo(), client->getClientId(), client->getMdsDest())
+    if (send_notification_lib(notification->getNotInfo(),
+                              notification->getEncodedNotification(),
+                              client->getClientId(), client->getMdsDest())
         != NCSCC_RC_SUCCESS) {
       // send failed, put notification id in discard list
       discardedAdd(notification->getNotificationId());
@@ -259,7 +286,9 @@ void NtfSubscription::sendNotification(NtfSmartPtr& notification, NtfClient *cli
               (unsigned int)discardedNotificationIdList.size());
 
       // try to send the new notification
-      if (send_notification_lib(notification->getNotInfo(), client->getClientId(), client->getMdsDest())
+      if (send_notification_lib(notification->getNotInfo(),
+                                notification->getEncodedNotification(),
+                                client->getClientId(), client->getMdsDest())
           != NCSCC_RC_SUCCESS) {
         discardedAdd(notification->getNotificationId());
       }
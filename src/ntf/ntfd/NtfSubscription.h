@@ -24,6 +24,7 @@
 
 #include "ntf/ntfd/NtfFilter.h"
 #include "ntf/ntfd/NtfNotification.h"
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
 #include "ntf/saf/saNtf.h"
 
 class NtfClient;
@@ -34,6 +35,8 @@ class NtfSubscription{
   NtfSubscription(ntfsv_subscribe_req_t* s);
   virtual ~NtfSubscription();
   bool checkSubscription(NtfSmartPtr& notification);
+  void addToIndex(NtfSubscriptionIndex& index);
+  void removeFromIndex(NtfSubscriptionIndex& index);
   void confirmNtfSend();
   SaNtfSubscriptionIdT getSubscriptionId() const;
   ntfsv_subscribe_req_t* getSubscriptionInfo();
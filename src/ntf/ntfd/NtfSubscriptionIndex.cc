@@ -0,0 +1,206 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/**
+ *   This object is an inverted index over the filters of all subscriptions.
+ *
+ *   The filters are indexed on notification type and on event type or
+ *   notification class id. Only the filters found through the index are
+ *   checked against a notification, the matching is still done by
+ *   NtfFilter::checkFilter.
+ */
+
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
+#include <algorithm>
+#include "base/logtrace.h"
+
+/**
+ * This is the constructor.
+ */
+NtfSubscriptionIndex::NtfSubscriptionIndex():numFilters(0) {
+}
+
+/**
+ * This is the destructor.
+ *
+ * The filters are owned by the subscriptions and are not deleted.
+ */
+NtfSubscriptionIndex::~NtfSubscriptionIndex() {
+}
+
+uint64_t NtfSubscriptionIndex::classIdKey(const SaNtfClassIdT *classId) {
+  return ((uint64_t)classId->vendorId << 32) |
+      ((uint64_t)classId->majorId << 16) | classId->minorId;
+}
+
+void NtfSubscriptionIndex::addEntry(EntryList& list, const Entry& entry) {
+  // a filter may list the same event type or class id more than once
+  for (EntryList::iterator pos = list.begin(); pos != list.end(); pos++) {
+    if (pos->filter == entry.filter)
+      return;
+  }
+  list.push_back(entry);
+}
+
+void NtfSubscriptionIndex::removeEntry(EntryList& list, const Entry& entry) {
+  for (EntryList::iterator pos = list.begin(); pos != list.end(); pos++) {
+    if (pos->filter == entry.filter) {
+      *pos = list.back();
+      list.pop_back();
+      return;
+    }
+  }
+}
+
+/**
+ * This method is called when a subscription with a filter is added.
+ *
+ * @param clientId Node-wide unique id of the client owning the subscription.
+ * @param subscriptionId Client-wide unique id of the subscription.
+ * @param filter Pointer to the filter object, owned by the subscription.
+ */
+void NtfSubscriptionIndex::filterAdded(unsigned int clientId,
+                                       SaNtfSubscriptionIdT subscriptionId,
+                                       NtfFilter *filter) {
+  SaNtfNotificationFilterHeaderT *fh = filter->filterHeader();
+  TypeIndex& typeIndex = typeIndexMap[filter->type()];
+  Entry entry = {clientId, subscriptionId, filter};
+
+  if (fh->numEventTypes) {
+    for (int i = 0; i < fh->numEventTypes; i++)
+      addEntry(typeIndex.eventTypes[fh->eventTypes[i]], entry);
+  } else if (fh->numNotificationClassIds) {
+    for (int i = 0; i < fh->numNotificationClassIds; i++)
+      addEntry(typeIndex.classIds[classIdKey(&fh->notificationClassIds[i])], entry);
+  } else {
+    typeIndex.anyNotification.push_back(entry);
+  }
+  numFilters++;
+  TRACE_2("Filter type %#x of subscription %u client %u indexed, %u filters",
+          filter->type(), subscriptionId, clientId, numFilters);
+}
+
+/**
+ * This method is called before a subscription with a filter is deleted.
+ *
+ * @param clientId Node-wide unique id of the client owning the subscription.
+ * @param subscriptionId Client-wide unique id of the subscription.
+ * @param filter Pointer to the filter object given to filterAdded.
+ */
+void NtfSubscriptionIndex::filterRemoved(unsigned int clientId,
+                                         SaNtfSubscriptionIdT subscriptionId,
+                                         NtfFilter *filter) {
+  SaNtfNotificationFilterHeaderT *fh = filter->filterHeader();
+  TypeIndexMap::iterator posT = typeIndexMap.find(filter->type());
+  Entry entry = {clientId, subscriptionId, filter};
+
+  if (posT == typeIndexMap.end()) {
+    LOG_WA("NtfSubscriptionIndex::filterRemoved filter type %#x not found",
+           filter->type());
+    return;
+  }
+  TypeIndex& typeIndex = posT->second;
+
+  if (fh->numEventTypes) {
+    for (int i = 0; i < fh->numEventTypes; i++) {
+      std::map<SaNtfEventTypeT, EntryList>::iterator pos =
+          typeIndex.eventTypes.find(fh->eventTypes[i]);
+      if (pos == typeIndex.eventTypes.end())
+        continue;
+      removeEntry(pos->second, entry);
+      if (pos->second.empty())
+        typeIndex.eventTypes.erase(pos);
+    }
+  } else if (fh->numNotificationClassIds) {
+    for (int i = 0; i < fh->numNotificationClassIds; i++) {
+      std::map<uint64_t, EntryList>::iterator pos =
+          typeIndex.classIds.find(classIdKey(&fh->notificationClassIds[i]));
+      if (pos == typeIndex.classIds.end())
+        continue;
+      removeEntry(pos->second, entry);
+      if (pos->second.empty())
+        typeIndex.classIds.erase(pos);
+    }
+  } else {
+    removeEntry(typeIndex.anyNotification, entry);
+  }
+  numFilters--;
+  TRACE_2("Filter type %#x of subscription %u client %u removed, %u filters",
+          filter->type(), subscriptionId, clientId, numFilters);
+}
+
+void NtfSubscriptionIndex::checkEntries(const EntryList& list,
+                                        NtfSmartPtr& notification,
+                                        std::vector<Match>& matches) {
+  for (EntryList::const_iterator pos = list.begin(); pos != list.end(); pos++) {
+    if (pos->filter->checkFilter(notification)) {
+      Match match = {pos->clientId, pos->subscriptionId};
+      matches.push_back(match);
+    }
+  }
+}
+
+static bool matchLess(const NtfSubscriptionIndex::Match& a,
+                      const NtfSubscriptionIndex::Match& b) {
+  if (a.clientId != b.clientId)
+    return a.clientId < b.clientId;
+  return a.subscriptionId < b.subscriptionId;
+}
+
+/**
+ * This method is called to find the subscriptions matching a notification.
+ *
+ * Each filter is stored under one index key only, so a subscription is
+ * found at most once.
+ *
+ * @param notification
+ *               Pointer to the received notification object.
+ * @param matches
+ *               Matching subscriptions, sorted on client id and
+ *               subscription id.
+ */
+void NtfSubscriptionIndex::findMatches(NtfSmartPtr& notification,
+                                       std::vector<Match>& matches) {
+  matches.clear();
+  TypeIndexMap::iterator posT = typeIndexMap.find(notification->getNotificationType());
+  if (posT == typeIndexMap.end())
+    return;
+  TypeIndex& typeIndex = posT->second;
+  const SaNtfNotificationHeaderT *h = notification->header();
+
+  std::map<SaNtfEventTypeT, EntryList>::iterator posE =
+      typeIndex.eventTypes.find(*h->eventType);
+  if (posE != typeIndex.eventTypes.end())
+    checkEntries(posE->second, notification, matches);
+
+  std::map<uint64_t, EntryList>::iterator posC =
+      typeIndex.classIds.find(classIdKey(h->notificationClassId));
+  if (posC != typeIndex.classIds.end())
+    checkEntries(posC->second, notification, matches);
+
+  checkEntries(typeIndex.anyNotification, notification, matches);
+
+  std::sort(matches.begin(), matches.end(), matchLess);
+}
+
+/**
+ * @return Number of indexed filters.
+ */
+unsigned int NtfSubscriptionIndex::size() const
+{
+  return numFilters;
+}
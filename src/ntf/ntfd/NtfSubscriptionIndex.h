@@ -0,0 +1,82 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+/**
+ *   This object is an inverted index over the filters of all subscriptions.
+ *   It finds the subscriptions that may match a notification without
+ *   checking the filters of every subscription.
+ */
+
+#ifndef NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
+#define NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
+
+#include <map>
+#include <vector>
+#include "ntf/ntfd/NtfFilter.h"
+#include "ntf/ntfd/NtfNotification.h"
+#include "ntf/saf/saNtf.h"
+
+class NtfSubscriptionIndex{
+
+ public:
+  struct Match {
+    unsigned int clientId;
+    SaNtfSubscriptionIdT subscriptionId;
+  };
+
+  NtfSubscriptionIndex();
+  virtual ~NtfSubscriptionIndex();
+  void filterAdded(unsigned int clientId,
+                   SaNtfSubscriptionIdT subscriptionId,
+                   NtfFilter *filter);
+  void filterRemoved(unsigned int clientId,
+                     SaNtfSubscriptionIdT subscriptionId,
+                     NtfFilter *filter);
+  void findMatches(NtfSmartPtr& notification, std::vector<Match>& matches);
+  unsigned int size() const;
+
+ private:
+  struct Entry {
+    unsigned int clientId;
+    SaNtfSubscriptionIdT subscriptionId;
+    NtfFilter *filter;
+  };
+  typedef std::vector<Entry> EntryList;
+
+  /* Filters of one notification type. A filter is only stored under its
+   * event types, if it has any. Otherwise under its notification class ids,
+   * if it has any. Otherwise it matches all notifications of the type.
+   */
+  struct TypeIndex {
+    std::map<SaNtfEventTypeT, EntryList> eventTypes;
+    std::map<uint64_t, EntryList> classIds;
+    EntryList anyNotification;
+  };
+  typedef std::map<SaNtfNotificationTypeT, TypeIndex> TypeIndexMap;
+
+  static uint64_t classIdKey(const SaNtfClassIdT *classId);
+  static void addEntry(EntryList& list, const Entry& entry);
+  static void removeEntry(EntryList& list, const Entry& entry);
+  static void checkEntries(const EntryList& list,
+                           NtfSmartPtr& notification,
+                           std::vector<Match>& matches);
+
+  TypeIndexMap typeIndexMap;
+  unsigned int numFilters;
+};
+
+#endif  // NTF_NTFD_NTFSUBSCRIPTIONINDEX_H_
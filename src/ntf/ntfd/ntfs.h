@@ -50,6 +50,7 @@
  * ========================================================================
  */
 #define NTFSV_READER_CACHE_DEFAULT 10000
+#define NTFSV_READER_CACHE_BYTES_DEFAULT (16 * 1024 * 1024)
 
 /* ========================================================================
  *   TYPE DEFINITIONS
@@ -60,6 +60,7 @@ typedef struct ntfs_cb {
   EDU_HDL edu_hdl;        /* Handle from EDU for encode/decode operations */
   bool fully_initialized;
   unsigned int cache_size; /* size of the reader cache */
+  uint64_t cache_bytes; /* max bytes in the reader cache, 0 for no limit */
   bool nid_started;       /**< true if started by NID */
   SaClmHandleT clm_hdl;   /* CLM handle, obtained through CLM init        */
   NCS_SEL_OBJ usr2_sel_obj; /* Selection object for CLM initialization.*/
@@ -271,10 +271,13 @@ void delete_reader_res_lib(SaAisErrorT error, MDS_DEST mdsDest, MDS_SYNC_SND_CTX
  *   SaNtfNotificationCallbackT function.
  *
  *   @param dispatchInfo contains all information about the notification.
+ *   @param encodedNotification dispatchInfo already encoded, or NULL if
+ *          dispatchInfo is to be encoded for this client.
  *
  *   @return return value == NCSCC_RC_SUCCESS if ok
  */
-int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo, uint32_t client_id, MDS_DEST mds_dest)
+int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo, USRBUF *encodedNotification,
+			  uint32_t client_id, MDS_DEST mds_dest)
 {
 	uint32_t rc = NCSCC_RC_SUCCESS;
 	ntfsv_msg_t msg;
@@ -301,6 +304,7 @@ int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo, uint32_t client_id
 	msg.info.cbk_info.ntfs_client_id = client_id;
 	msg.info.cbk_info.subscriptionId = dispatchInfo->subscriptionId;
 	msg.info.cbk_info.param.notification_cbk = dispatchInfo;
+	msg.info.cbk_info.notification_cbk_enc = encodedNotification;
 	rc = ntfs_mds_msg_send(ntfs_cb, &msg, &mds_dest, NULL,	/* send regular msg */
 			       MDS_SEND_PRIORITY_HIGH);
 	if (rc != NCSCC_RC_SUCCESS) {
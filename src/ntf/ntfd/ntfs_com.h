@@ -117,7 +117,8 @@ void read_next_res_lib(SaAisErrorT error,
 
 void delete_reader_res_lib(SaAisErrorT error, MDS_DEST mdsDest, MDS_SYNC_SND_CTXT *mdsCtxt);
 
-int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo, uint32_t client_id, MDS_DEST mds_dest);
+int send_notification_lib(ntfsv_send_not_req_t *dispatchInfo, USRBUF *encodedNotification,
+                          uint32_t client_id, MDS_DEST mds_dest);
 
 void sendLoggedConfirm(SaNtfIdentifierT notificationId);
 
@@ -235,6 +235,15 @@ uint32_t ntfs_cb_init(ntfs_cb_t *ntfs_cb)
 	} else {
 		ntfs_cb->cache_size = NTFSV_READER_CACHE_DEFAULT; 
 	}
+
+	tmp = (char *)getenv("NTFSV_ENV_CACHE_BYTES");
+	if (tmp) {
+		ntfs_cb->cache_bytes = strtoull(tmp, NULL, 0);
+		TRACE("NTFSV_ENV_CACHE_BYTES configured value: %llu",
+		      (unsigned long long)ntfs_cb->cache_bytes);
+	} else {
+		ntfs_cb->cache_bytes = NTFSV_READER_CACHE_BYTES_DEFAULT;
+	}
 	TRACE_LEAVE();
 	return NCSCC_RC_SUCCESS;
 }
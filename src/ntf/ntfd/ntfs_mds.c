@@ -16,6 +16,7 @@
  */
 
 #include "base/ncsencdec_pub.h"
+#include "base/ncssysf_mem.h"
 #include "ntfs.h"
 #include "ntf/ntfsv_enc_dec.h"
 
@@ -360,7 +361,9 @@ static uint32_t enc_send_not_rsp_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 /****************************************************************************
   Name          : enc_send_not_cbk_msg
  
-  Description   : This routine encodes a notification callback API msg
+  Description   : This routine encodes a notification callback API msg.
+                  A notification encoded by NTFS is appended without
+                  being copied.
  
   Arguments     : NCS_UBAID *msg,
                   NTFSV_MSG *msg
@@ -372,7 +375,19 @@ static uint32_t enc_send_not_rsp_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 static uint32_t enc_send_not_cbk_msg(NCS_UBAID *uba, ntfsv_msg_t *msg)
 {
 	ntfsv_send_not_req_t *param = msg->info.cbk_info.param.notification_cbk;
-	return ntfsv_enc_not_msg(uba, param);
+	USRBUF *ub;
+
+	if (msg->info.cbk_info.notification_cbk_enc == NULL)
+		return ntfsv_enc_not_msg(uba, param);
+
+	/* Refer to the payload of the already encoded notification */
+	ub = m_MMGR_DITTO_BUFR(msg->info.cbk_info.notification_cbk_enc);
+	if (ub == NULL) {
+		TRACE("m_MMGR_DITTO_BUFR failed");
+		return NCSCC_RC_OUT_OF_MEM;
+	}
+	ncs_enc_append_usrbuf(uba, ub);
+	return NCSCC_RC_SUCCESS;
 }
 
 /****************************************************************************
@@ -0,0 +1,144 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "base/ncssysf_mem.h"
+#include "base/osaf_extended_name.h"
+#include "ntf/ntfd/NtfNotification.h"
+#include "ntf/ntfsv_enc_dec.h"
+#include "ntf/ntfsv_mem.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+// The fixture for testing the encoded notification shared by the
+// notification callbacks to all subscribers
+class NtfNotificationTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    osaf_extended_name_init();
+    ntfsv_send_not_req_t *info = static_cast<ntfsv_send_not_req_t*>(
+        calloc(1, sizeof(ntfsv_send_not_req_t)));
+    info->notificationType = SA_NTF_TYPE_ALARM;
+    info->client_id = 17;
+    SaNtfAlarmNotificationT *alarm = &info->notification.alarm;
+    ntfsv_alloc_ntf_alarm(alarm, 2, 0, 1);
+    SaNtfNotificationHeaderT *h = &alarm->notificationHeader;
+    ntfsv_alloc_ntf_header(h, 0, 40, 0);
+    *h->eventType = SA_NTF_ALARM_PROCESSING;
+    *h->notificationClassId = {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 2};
+    *h->eventTime = 1476612340123456789LL;
+    osaf_extended_name_alloc("safComp=Comp1,safSu=SU1,safSg=SG1,safApp=App1",
+                             h->notificationObject);
+    osaf_extended_name_alloc("safApp=safAmfService", h->notifyingObject);
+    strncpy(h->additionalText, "Component failed, restarting it now", 40);
+    *alarm->probableCause = SA_NTF_SOFTWARE_ERROR;
+    *alarm->perceivedSeverity = SA_NTF_SEVERITY_MAJOR;
+    *alarm->trend = SA_NTF_TREND_NO_CHANGE;
+    for (int i = 0; i < 2; ++i) {
+      alarm->specificProblems[i].problemId = i;
+      alarm->specificProblems[i].problemType = SA_NTF_VALUE_UINT32;
+      alarm->specificProblems[i].problemValue.uint32Val = 4711 + i;
+    }
+    alarm->proposedRepairActions[0].actionId = 1;
+    alarm->proposedRepairActions[0].actionValueType = SA_NTF_VALUE_UINT32;
+    alarm->proposedRepairActions[0].actionValue.uint32Val = 2;
+    notification_ = NtfSmartPtr(new NtfNotification(4711, SA_NTF_TYPE_ALARM,
+                                                    info));
+  }
+
+  static std::vector<uint8_t> Flatten(USRBUF *ub) {
+    std::vector<uint8_t> data(m_MMGR_LINK_DATA_LEN(ub));
+    sysf_copy_from_usrbuf(ub, data.data(), data.size());
+    return data;
+  }
+
+  static std::vector<uint8_t> Encode(ntfsv_send_not_req_t *info) {
+    NCS_UBAID uba;
+    EXPECT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    EXPECT_EQ(NCSCC_RC_SUCCESS, ntfsv_enc_not_msg(&uba, info));
+    std::vector<uint8_t> data = Flatten(uba.start);
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+    return data;
+  }
+
+  NtfSmartPtr notification_;
+};
+
+TEST_F(NtfNotificationTest, EncodedOnce) {
+  USRBUF *encoded = notification_->getEncodedNotification();
+  ASSERT_NE(nullptr, encoded);
+  EXPECT_EQ(encoded, notification_->getEncodedNotification());
+  EXPECT_EQ(Encode(notification_->getNotInfo()), Flatten(encoded));
+}
+
+// A send appends a reference to the encoded payload, freeing it must not
+// free the payload of the notification
+TEST_F(NtfNotificationTest, SharedPayloadOutlivesSends) {
+  USRBUF *encoded = notification_->getEncodedNotification();
+  std::vector<uint8_t> expected = Flatten(encoded);
+
+  for (int i = 0; i < 3; ++i) {
+    NCS_UBAID uba;
+    ASSERT_EQ(NCSCC_RC_SUCCESS, ncs_enc_init_space(&uba));
+    uint8_t *p8 = ncs_enc_reserve_space(&uba, 4);
+    ncs_encode_32bit(&p8, i);
+    ncs_enc_claim_space(&uba, 4);
+    ncs_enc_append_usrbuf(&uba, m_MMGR_DITTO_BUFR(encoded));
+    std::vector<uint8_t> sent = Flatten(uba.start);
+    EXPECT_EQ(expected, std::vector<uint8_t>(sent.begin() + 4, sent.end()));
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+  }
+  EXPECT_EQ(expected, Flatten(notification_->getEncodedNotification()));
+}
+
+// Compare encoding the notification for each subscriber with referring to
+// the encoded notification
+TEST_F(NtfNotificationTest, Benchmark) {
+  static const int kSubscribers = 200000;
+  ntfsv_send_not_req_t *info = notification_->getNotInfo();
+
+  auto start = steady_clock::now();
+  for (int i = 0; i < kSubscribers; ++i) {
+    NCS_UBAID uba;
+    ncs_enc_init_space(&uba);
+    ntfsv_enc_not_msg(&uba, info);
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+  }
+  duration<double> encode = steady_clock::now() - start;
+
+  start = steady_clock::now();
+  for (int i = 0; i < kSubscribers; ++i) {
+    NCS_UBAID uba;
+    ncs_enc_init_space(&uba);
+    ncs_enc_append_usrbuf(&uba, m_MMGR_DITTO_BUFR(
+        notification_->getEncodedNotification()));
+    m_MMGR_FREE_BUFR_LIST(uba.start);
+  }
+  duration<double> shared = steady_clock::now() - start;
+
+  std::cout << "encode per subscriber "
+            << static_cast<uint64_t>(kSubscribers / encode.count())
+            << " sends/s, shared encoding "
+            << static_cast<uint64_t>(kSubscribers / shared.count())
+            << " sends/s\n";
+}
@@ -0,0 +1,184 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include "base/osaf_extended_name.h"
+#include "ntf/ntfd/NtfReaderCache.h"
+#include "ntf/ntfsv_mem.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+// The fixture for testing the notification cache read by the readers
+class NtfReaderCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    osaf_extended_name_init();
+  }
+
+  static NtfSmartPtr Alarm(SaNtfIdentifierT id, SaTimeT eventTime,
+                           SaUint16T textLength = 0) {
+    ntfsv_send_not_req_t *info = static_cast<ntfsv_send_not_req_t*>(
+        calloc(1, sizeof(ntfsv_send_not_req_t)));
+    info->notificationType = SA_NTF_TYPE_ALARM;
+    SaNtfAlarmNotificationT *alarm = &info->notification.alarm;
+    ntfsv_alloc_ntf_alarm(alarm, 0, 0, 0);
+    SaNtfNotificationHeaderT *h = &alarm->notificationHeader;
+    ntfsv_alloc_ntf_header(h, 0, textLength, 0);
+    *h->eventType = SA_NTF_ALARM_PROCESSING;
+    *h->eventTime = eventTime;
+    return NtfSmartPtr(new NtfNotification(id, SA_NTF_TYPE_ALARM, info));
+  }
+
+  // Adds notifications with ids 1..count, two at each event time
+  void Fill(unsigned int count) {
+    for (unsigned int i = 1; i <= count; i++) {
+      NtfSmartPtr n = Alarm(i, 1000 + i / 2);
+      cache_.add(n, count, 0);
+    }
+  }
+
+  NtfReaderCache cache_;
+};
+
+TEST_F(NtfReaderCacheTest, MaxEntries) {
+  for (SaNtfIdentifierT id = 1; id <= 10; id++) {
+    NtfSmartPtr n = Alarm(id, id);
+    cache_.add(n, 4, 0);
+  }
+  EXPECT_EQ(4u, cache_.size());
+  EXPECT_EQ(6u, cache_.begin());
+  EXPECT_EQ(10u, cache_.end());
+  EXPECT_EQ(7u, cache_.at(cache_.begin())->getNotificationId());
+  EXPECT_EQ(10u, cache_.at(cache_.end() - 1)->getNotificationId());
+}
+
+TEST_F(NtfReaderCacheTest, NoCache) {
+  NtfSmartPtr n = Alarm(1, 1);
+  cache_.add(n, 0, 0);
+  EXPECT_EQ(0u, cache_.size());
+  EXPECT_EQ(0u, cache_.bytes());
+  EXPECT_EQ(1, n.use_count());
+}
+
+TEST_F(NtfReaderCacheTest, MaxBytes) {
+  NtfSmartPtr n = Alarm(1, 1, 1000);
+  uint64_t size = NtfReaderCache::notificationSize(n);
+  EXPECT_LT(1000u, size);
+
+  cache_.add(n, 100, 3 * size);
+  for (SaNtfIdentifierT id = 2; id <= 10; id++) {
+    NtfSmartPtr big = Alarm(id, id, 1000);
+    cache_.add(big, 100, 3 * size);
+  }
+  EXPECT_EQ(3u, cache_.size());
+  EXPECT_EQ(3 * size, cache_.bytes());
+  EXPECT_EQ(1, n.use_count());
+
+  // a notification larger than the limit replaces all others
+  NtfSmartPtr huge = Alarm(11, 11, 8000);
+  cache_.add(huge, 100, 3 * size);
+  EXPECT_EQ(1u, cache_.size());
+  EXPECT_EQ(NtfReaderCache::notificationSize(huge), cache_.bytes());
+}
+
+TEST_F(NtfReaderCacheTest, TimeBounds) {
+  Fill(100);
+  ASSERT_TRUE(cache_.timeOrdered());
+  for (SaTimeT t = 999; t <= 1052; t++) {
+    NtfReaderCache::Position lower = cache_.begin();
+    while (lower < cache_.end() && cache_.eventTime(lower) < t)
+      lower++;
+    NtfReaderCache::Position upper = lower;
+    while (upper < cache_.end() && cache_.eventTime(upper) <= t)
+      upper++;
+    EXPECT_EQ(lower, cache_.lowerBoundTime(cache_.begin(), cache_.end(), t));
+    EXPECT_EQ(upper, cache_.upperBoundTime(cache_.begin(), cache_.end(), t));
+  }
+}
+
+TEST_F(NtfReaderCacheTest, TimeInversionsEvicted) {
+  NtfSmartPtr n = Alarm(1, 2000);
+  cache_.add(n, 3, 0);
+  n = Alarm(2, 1000);
+  cache_.add(n, 3, 0);
+  EXPECT_FALSE(cache_.timeOrdered());
+  for (SaNtfIdentifierT id = 3; id <= 4; id++) {
+    n = Alarm(id, 1000 + id);
+    cache_.add(n, 3, 0);
+  }
+  EXPECT_TRUE(cache_.timeOrdered());
+}
+
+TEST_F(NtfReaderCacheTest, FindId) {
+  Fill(50);
+  for (SaNtfIdentifierT id = 1; id <= 50; id++) {
+    NtfReaderCache::Position pos = cache_.findId(cache_.begin(), cache_.end(),
+                                                 id);
+    ASSERT_LT(pos, cache_.end());
+    EXPECT_EQ(id, cache_.at(pos)->getNotificationId());
+  }
+  EXPECT_EQ(cache_.end(), cache_.findId(cache_.begin(), cache_.end(), 51));
+
+  // ids out of order are found by scanning
+  NtfSmartPtr n = Alarm(7, 2000);
+  cache_.add(n, 50, 0);
+  NtfReaderCache::Position pos = cache_.findId(cache_.begin() + 10,
+                                               cache_.end(), 7);
+  EXPECT_EQ(cache_.end() - 1, pos);
+}
+
+// Compare a reader copying the cache, as readers did before, with a reader
+// searching a view of the cache
+TEST_F(NtfReaderCacheTest, Benchmark) {
+  static const unsigned int kCacheSize = 10000;
+  static const int kReaders = 500;
+  Fill(kCacheSize);
+
+  auto start = steady_clock::now();
+  for (int i = 0; i < kReaders; i++) {
+    SaTimeT t = 1000 + (i * 13) % (kCacheSize / 2);
+    std::list<NtfSmartPtr> coll;
+    for (NtfReaderCache::Position pos = cache_.begin(); pos < cache_.end();
+         pos++)
+      coll.push_back(cache_.at(pos));
+    std::list<NtfSmartPtr>::iterator it = coll.begin();
+    while (it != coll.end() && *(*it)->header()->eventTime < t)
+      it++;
+    ASSERT_TRUE(it != coll.end());
+  }
+  duration<double> copy = steady_clock::now() - start;
+
+  start = steady_clock::now();
+  for (int i = 0; i < kReaders; i++) {
+    SaTimeT t = 1000 + (i * 13) % (kCacheSize / 2);
+    NtfReaderCache::Position pos = cache_.lowerBoundTime(cache_.begin(),
+                                                         cache_.end(), t);
+    ASSERT_LT(pos, cache_.end());
+  }
+  duration<double> view = steady_clock::now() - start;
+
+  std::cout << "copied cache " << static_cast<uint64_t>(kReaders / copy.count())
+            << " readers/s, cache view "
+            << static_cast<uint64_t>(kReaders / view.count())
+            << " readers/s\n";
+}
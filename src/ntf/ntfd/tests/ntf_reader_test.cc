@@ -0,0 +1,313 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/osaf_extended_name.h"
+#include "ntf/ntfd/NtfReader.h"
+#include "ntf/ntfsv_mem.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Cached {
+  SaNtfIdentifierT id;
+  SaTimeT eventTime;
+  bool major;  // Only major alarms pass the filter of the readers
+};
+
+const SaNtfSearchModeT kSearchModes[] = {
+  SA_NTF_SEARCH_BEFORE_OR_AT_TIME, SA_NTF_SEARCH_AT_TIME,
+  SA_NTF_SEARCH_AT_OR_AFTER_TIME, SA_NTF_SEARCH_BEFORE_TIME,
+  SA_NTF_SEARCH_AFTER_TIME, SA_NTF_SEARCH_NOTIFICATION_ID,
+  SA_NTF_SEARCH_ONLY_FILTER};
+
+// Reads the way NtfReader did before it read the shared cache: the
+// matching notifications were copied to a list, which the search criteria
+// then cut and set the start of.
+class LinearReader {
+ public:
+  LinearReader(const std::vector<Cached>& cached,
+               const SaNtfSearchCriteriaT& sc)
+      : searchMode_(sc.searchMode), cursor_(0), firstRead_(true) {
+    std::vector<Cached> list;
+    for (const Cached& c : cached) {
+      if (c.major) list.push_back(c);
+    }
+    int firstAt = -1;
+    int lastAt = -1;
+    int firstAfter = -1;
+    for (int i = 0; i < static_cast<int>(list.size()); i++) {
+      if (list[i].eventTime == sc.eventTime) {
+        if (firstAt < 0) firstAt = i;
+        lastAt = i;
+      } else if (list[i].eventTime > sc.eventTime && firstAfter < 0) {
+        firstAfter = i;
+      }
+    }
+
+    int begin = 0;
+    int end = list.size();
+    switch (sc.searchMode) {
+      case SA_NTF_SEARCH_BEFORE_OR_AT_TIME:
+        if (lastAt >= 0) end = lastAt + 1;
+        cursor_ = std::max(end - 1, 0);
+        break;
+      case SA_NTF_SEARCH_AT_OR_AFTER_TIME:
+        if (firstAt >= 0)
+          begin = firstAt;
+        else if (firstAfter >= 0)
+          begin = firstAfter;
+        break;
+      case SA_NTF_SEARCH_BEFORE_TIME:
+        if (firstAt >= 0) end = firstAt;
+        cursor_ = std::max(end - 1, 0);
+        break;
+      case SA_NTF_SEARCH_AFTER_TIME:
+        if (lastAt >= 0) begin = lastAt + 1;
+        break;
+      default:
+        break;
+    }
+    for (int i = begin; i < end; i++) {
+      if ((sc.searchMode == SA_NTF_SEARCH_AT_TIME &&
+           list[i].eventTime != sc.eventTime) ||
+          (sc.searchMode == SA_NTF_SEARCH_NOTIFICATION_ID &&
+           list[i].id != sc.notificationId))
+        continue;
+      ids_.push_back(list[i].id);
+    }
+  }
+
+  // Returns the id of the notification read, 0 if there was none
+  SaNtfIdentifierT Next(SaNtfSearchDirectionT direction) {
+    int size = ids_.size();
+    int pos;
+    if (direction == SA_NTF_SEARCH_YOUNGER ||
+        searchMode_ == SA_NTF_SEARCH_AT_TIME ||
+        searchMode_ == SA_NTF_SEARCH_ONLY_FILTER) {
+      firstRead_ = false;
+      if (cursor_ >= size) return 0;
+      return ids_[cursor_++];
+    }
+    // The first older read gives the notification at the cursor, the next
+    // ones the notification before the one last read
+    pos = firstRead_ ? cursor_ : cursor_ - 2;
+    firstRead_ = false;
+    cursor_ = std::max(pos + 1, 0);
+    if (pos < 0 || pos >= size) return 0;
+    return ids_[pos];
+  }
+
+ private:
+  SaNtfSearchModeT searchMode_;
+  std::vector<SaNtfIdentifierT> ids_;
+  int cursor_;
+  bool firstRead_;
+};
+
+}  // namespace
+
+// The fixture for comparing the readers of the shared cache with the
+// readers that copied and scanned the notifications
+class NtfReaderTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    osaf_extended_name_init();
+  }
+
+  static NtfSmartPtr Alarm(const Cached& c) {
+    ntfsv_send_not_req_t *info = static_cast<ntfsv_send_not_req_t*>(
+        calloc(1, sizeof(ntfsv_send_not_req_t)));
+    info->notificationType = SA_NTF_TYPE_ALARM;
+    SaNtfAlarmNotificationT *alarm = &info->notification.alarm;
+    ntfsv_alloc_ntf_alarm(alarm, 0, 0, 0);
+    *alarm->perceivedSeverity =
+        c.major ? SA_NTF_SEVERITY_MAJOR : SA_NTF_SEVERITY_MINOR;
+    SaNtfNotificationHeaderT *h = &alarm->notificationHeader;
+    ntfsv_alloc_ntf_header(h, 0, 0, 0);
+    *h->eventType = SA_NTF_ALARM_PROCESSING;
+    *h->eventTime = c.eventTime;
+    return NtfSmartPtr(new NtfNotification(c.id, SA_NTF_TYPE_ALARM, info));
+  }
+
+  void Fill(const std::vector<Cached>& cached) {
+    cached_ = cached;
+    for (const Cached& c : cached) {
+      NtfSmartPtr n = Alarm(c);
+      cache_.add(n, cached.size(), 0);
+    }
+  }
+
+  // A reader of the major alarms, owning its filter
+  NtfReader *Reader(const SaNtfSearchCriteriaT& sc) {
+    SaNtfAlarmNotificationFilterT *f =
+        static_cast<SaNtfAlarmNotificationFilterT*>(malloc(sizeof(*f)));
+    ntfsv_filter_alarm_alloc(f, 0, 1, 0);
+    ntfsv_filter_header_alloc(&f->notificationFilterHeader, 0, 0, 0, 0);
+    f->perceivedSeverities[0] = SA_NTF_SEVERITY_MAJOR;
+    ntfsv_filter_ptrs_t f_rec = {};
+    f_rec.alarm_filter = f;
+    return new NtfReader(cache_, 1, sc, &f_rec);
+  }
+
+  // Reads in the directions with both readers and compares the results
+  void Compare(const SaNtfSearchCriteriaT& sc,
+               const std::vector<SaNtfSearchDirectionT>& directions) {
+    NtfReader *reader = Reader(sc);
+    LinearReader linear(cached_, sc);
+    for (size_t i = 0; i < directions.size(); i++) {
+      SCOPED_TRACE("mode " + std::to_string(sc.searchMode) + " time " +
+                   std::to_string(sc.eventTime) + " read " +
+                   std::to_string(i));
+      SaAisErrorT error;
+      NtfSmartPtr n = reader->next(directions[i], &error);
+      SaNtfIdentifierT expected = linear.Next(directions[i]);
+      if (expected == 0) {
+        EXPECT_EQ(SA_AIS_ERR_NOT_EXIST, error);
+      } else {
+        ASSERT_EQ(SA_AIS_OK, error);
+        EXPECT_EQ(expected, n->getNotificationId());
+      }
+    }
+    delete reader;
+  }
+
+  // Reads the ids in the direction until there are no more
+  std::vector<SaNtfIdentifierT> ReadAll(const SaNtfSearchCriteriaT& sc,
+                                        SaNtfSearchDirectionT direction) {
+    NtfReader *reader = Reader(sc);
+    std::vector<SaNtfIdentifierT> ids;
+    SaAisErrorT error;
+    for (;;) {
+      NtfSmartPtr n = reader->next(direction, &error);
+      if (error != SA_AIS_OK) break;
+      ids.push_back(n->getNotificationId());
+    }
+    delete reader;
+    return ids;
+  }
+
+  static SaNtfSearchCriteriaT Criteria(SaNtfSearchModeT mode, SaTimeT time,
+                                       SaNtfIdentifierT id = 0) {
+    SaNtfSearchCriteriaT sc;
+    sc.searchMode = mode;
+    sc.eventTime = time;
+    sc.notificationId = id;
+    return sc;
+  }
+
+  std::vector<Cached> cached_;
+  NtfReaderCache cache_;
+};
+
+TEST_F(NtfReaderTest, SearchModesInTimeOrder) {
+  Fill({{1, 10, true}, {2, 20, true}, {3, 20, false}, {4, 20, true},
+        {5, 30, true}, {6, 40, true}});
+  ASSERT_TRUE(cache_.timeOrdered());
+
+  typedef std::vector<SaNtfIdentifierT> Ids;
+  EXPECT_EQ(Ids({4}), ReadAll(Criteria(SA_NTF_SEARCH_BEFORE_OR_AT_TIME,
+                                             20), SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids({4, 2, 1}), ReadAll(Criteria(SA_NTF_SEARCH_BEFORE_OR_AT_TIME,
+                                             20), SA_NTF_SEARCH_OLDER));
+  EXPECT_EQ(Ids({2, 4}), ReadAll(Criteria(SA_NTF_SEARCH_AT_TIME, 20),
+                                 SA_NTF_SEARCH_OLDER));
+  EXPECT_EQ(Ids({2, 4, 5, 6}),
+            ReadAll(Criteria(SA_NTF_SEARCH_AT_OR_AFTER_TIME, 20),
+                    SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids({5, 6}), ReadAll(Criteria(SA_NTF_SEARCH_AT_OR_AFTER_TIME, 25),
+                                 SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids({1}), ReadAll(Criteria(SA_NTF_SEARCH_BEFORE_TIME, 20),
+                              SA_NTF_SEARCH_OLDER));
+  EXPECT_EQ(Ids({5, 6}), ReadAll(Criteria(SA_NTF_SEARCH_AFTER_TIME, 20),
+                                 SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids({4}), ReadAll(Criteria(SA_NTF_SEARCH_NOTIFICATION_ID, 0, 4),
+                              SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids(), ReadAll(Criteria(SA_NTF_SEARCH_NOTIFICATION_ID, 0, 3),
+                           SA_NTF_SEARCH_YOUNGER));
+  EXPECT_EQ(Ids({1, 2, 4, 5, 6}), ReadAll(Criteria(SA_NTF_SEARCH_ONLY_FILTER,
+                                                   0), SA_NTF_SEARCH_YOUNGER));
+}
+
+TEST_F(NtfReaderTest, AtOrAfterTimePrefersExactTimeWhenUnordered) {
+  Fill({{1, 5, true}, {2, 30, true}, {3, 20, true}, {4, 10, true},
+        {5, 20, true}});
+  ASSERT_FALSE(cache_.timeOrdered());
+
+  EXPECT_EQ(std::vector<SaNtfIdentifierT>({3, 4, 5}),
+            ReadAll(Criteria(SA_NTF_SEARCH_AT_OR_AFTER_TIME, 20),
+                    SA_NTF_SEARCH_YOUNGER));
+  // Without a notification at the time, from the first one after it
+  EXPECT_EQ(std::vector<SaNtfIdentifierT>({2, 3, 4, 5}),
+            ReadAll(Criteria(SA_NTF_SEARCH_AT_OR_AFTER_TIME, 15),
+                    SA_NTF_SEARCH_YOUNGER));
+}
+
+TEST_F(NtfReaderTest, NextInBothDirections) {
+  Fill({{1, 10, true}, {2, 20, true}, {3, 30, true}});
+  SaNtfSearchCriteriaT sc = Criteria(SA_NTF_SEARCH_AT_OR_AFTER_TIME, 20);
+  Compare(sc, {SA_NTF_SEARCH_OLDER, SA_NTF_SEARCH_OLDER, SA_NTF_SEARCH_OLDER,
+               SA_NTF_SEARCH_YOUNGER, SA_NTF_SEARCH_YOUNGER,
+               SA_NTF_SEARCH_YOUNGER, SA_NTF_SEARCH_YOUNGER,
+               SA_NTF_SEARCH_OLDER});
+  Compare(sc, {SA_NTF_SEARCH_YOUNGER, SA_NTF_SEARCH_YOUNGER,
+               SA_NTF_SEARCH_OLDER, SA_NTF_SEARCH_OLDER, SA_NTF_SEARCH_YOUNGER});
+}
+
+TEST_F(NtfReaderTest, MatchesLinearScanOnRandomCaches) {
+  std::mt19937 rng(4711);
+  auto random = [&rng](unsigned int n) {
+    return std::uniform_int_distribution<unsigned int>(0, n - 1)(rng);
+  };
+
+  for (int round = 0; round < 200; round++) {
+    std::vector<Cached> cached(random(12));
+    bool ordered = random(2);
+    for (size_t i = 0; i < cached.size(); i++) {
+      cached[i].id = i + 1;
+      cached[i].eventTime = 10 * (1 + random(6));
+      cached[i].major = random(4) != 0;
+    }
+    if (ordered) {
+      std::stable_sort(cached.begin(), cached.end(),
+                       [](const Cached& a, const Cached& b) {
+                         return a.eventTime < b.eventTime;
+                       });
+    }
+    cache_ = NtfReaderCache();
+    Fill(cached);
+
+    for (SaNtfSearchModeT mode : kSearchModes) {
+      for (int search = 0; search < 4; search++) {
+        SCOPED_TRACE("round " + std::to_string(round));
+        // Times at and between the event times, ids in and outside the cache
+        SaNtfSearchCriteriaT sc = Criteria(mode, 5 * random(16),
+                                           random(cached.size() + 2));
+        std::vector<SaNtfSearchDirectionT> directions(random(10));
+        for (auto& direction : directions) {
+          direction = random(2) ? SA_NTF_SEARCH_YOUNGER : SA_NTF_SEARCH_OLDER;
+        }
+        Compare(sc, directions);
+      }
+    }
+  }
+}
@@ -0,0 +1,366 @@
+/*      -*- OpenSAF  -*-
+ *
+ * (C) Copyright 2016 The OpenSAF Foundation
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. This file and program are licensed
+ * under the GNU Lesser General Public License Version 2.1, February 1999.
+ * The complete license can be accessed from the following location:
+ * http://opensource.org/licenses/lgpl-license.php
+ * See the Copying file included with the OpenSAF distribution for full
+ * licensing terms.
+ *
+ * Author(s): Ericsson AB
+ *
+ */
+
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/osaf_extended_name.h"
+#include "ntf/ntfd/NtfSubscriptionIndex.h"
+#include "ntf/ntfd/ntfs_com.h"
+#include "ntf/ntfsv_mem.h"
+#include "gtest/gtest.h"
+
+using namespace std::chrono;
+
+// Checkpointing of notifications to the standby is not tested here
+int sendNewNotification(unsigned int connId,
+                        ntfsv_send_not_req_t *notificationInfo,
+                        NCS_UBAID *uba) {
+  return NCSCC_RC_SUCCESS;
+}
+
+void sendMapNoOfSubscriptionToNotification(unsigned int noOfSubcriptions,
+                                           NCS_UBAID *uba) {
+}
+
+void sendMapSubscriptionToNotification(unsigned int clientId,
+                                       unsigned int subscriptionId,
+                                       NCS_UBAID *uba) {
+}
+
+int syncLoggedConfirm(unsigned int logged, NCS_UBAID *uba) {
+  return NCSCC_RC_SUCCESS;
+}
+
+namespace {
+
+// A notification mix recorded on a two controller cluster running an
+// application with a few hundred components. Each row is sent count times
+// per round.
+struct RecordedNotification {
+  SaNtfNotificationTypeT type;
+  SaNtfEventTypeT event_type;
+  SaNtfClassIdT class_id;
+  const char *object;
+  int count;
+};
+
+const RecordedNotification recorded_mix[] = {
+  {SA_NTF_TYPE_STATE_CHANGE, SA_NTF_OBJECT_STATE_CHANGE,
+   {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 101}, "safSu=SU1,safSg=SG1,safApp=App1",
+   40},
+  {SA_NTF_TYPE_STATE_CHANGE, SA_NTF_OBJECT_STATE_CHANGE,
+   {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 103}, "safSu=SU2,safSg=SG1,safApp=App1",
+   40},
+  {SA_NTF_TYPE_STATE_CHANGE, SA_NTF_OBJECT_STATE_CHANGE,
+   {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 106},
+   "safSi=SI3,safApp=App2", 20},
+  {SA_NTF_TYPE_OBJECT_CREATE_DELETE, SA_NTF_OBJECT_CREATION,
+   {32993, SA_SVC_IMMS, 1}, "safComp=Comp7,safSu=SU3,safSg=SG2,safApp=App2",
+   30},
+  {SA_NTF_TYPE_OBJECT_CREATE_DELETE, SA_NTF_OBJECT_DELETION,
+   {32993, SA_SVC_IMMS, 1}, "safComp=Comp7,safSu=SU3,safSg=SG2,safApp=App2",
+   30},
+  {SA_NTF_TYPE_ALARM, SA_NTF_ALARM_PROCESSING,
+   {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 2}, "safComp=Comp1,safSu=SU1,safApp=App1",
+   10},
+  {SA_NTF_TYPE_ALARM, SA_NTF_ALARM_COMMUNICATION,
+   {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 17}, "safNode=PL-4,safCluster=myClm",
+   5},
+  {SA_NTF_TYPE_ALARM, SA_NTF_ALARM_EQUIPMENT,
+   {32993, 100, 5}, "safNode=PL-7,safCluster=myClm", 5},
+};
+
+struct Subscription {
+  unsigned int client_id;
+  SaNtfSubscriptionIdT subscription_id;
+  NtfFilter *filter;
+};
+
+const SaNtfEventTypeT alarm_event_types[] = {
+  SA_NTF_ALARM_PROCESSING, SA_NTF_ALARM_COMMUNICATION, SA_NTF_ALARM_EQUIPMENT,
+  SA_NTF_ALARM_QOS, SA_NTF_ALARM_ENVIRONMENT
+};
+
+void SetName(SaNameT *name, const std::string& value) {
+  osaf_extended_name_alloc(value.c_str(), name);
+}
+
+}  // namespace
+
+// The fixture for testing NtfSubscriptionIndex against checking the filters
+// of all subscriptions, as ntfd did before the index was added.
+class NtfSubscriptionIndexTest : public ::testing::Test {
+ protected:
+  NtfSubscriptionIndexTest() : random_(4711) {
+  }
+
+  virtual void SetUp() {
+    osaf_extended_name_init();
+    for (const RecordedNotification& r : recorded_mix) {
+      NtfSmartPtr notification = CreateNotification(r);
+      for (int i = 0; i < r.count; ++i)
+        notifications_.push_back(notification);
+    }
+  }
+
+  virtual void TearDown() {
+    for (const Subscription& s : subscriptions_) {
+      index_.filterRemoved(s.client_id, s.subscription_id, s.filter);
+      delete s.filter;
+    }
+    subscriptions_.clear();
+    EXPECT_EQ(0u, index_.size());
+  }
+
+  NtfSmartPtr CreateNotification(const RecordedNotification& r) {
+    ntfsv_send_not_req_t *info = static_cast<ntfsv_send_not_req_t*>(
+        calloc(1, sizeof(ntfsv_send_not_req_t)));
+    SaNtfNotificationHeaderT *h;
+    info->notificationType = r.type;
+    switch (r.type) {
+      case SA_NTF_TYPE_ALARM:
+        ntfsv_alloc_ntf_alarm(&info->notification.alarm, 0, 0, 0);
+        h = &info->notification.alarm.notificationHeader;
+        *info->notification.alarm.probableCause = SA_NTF_SOFTWARE_ERROR;
+        *info->notification.alarm.perceivedSeverity = SA_NTF_SEVERITY_MAJOR;
+        *info->notification.alarm.trend = SA_NTF_TREND_NO_CHANGE;
+        break;
+      case SA_NTF_TYPE_STATE_CHANGE:
+        ntfsv_alloc_ntf_state_change(&info->notification.stateChange, 0);
+        h = &info->notification.stateChange.notificationHeader;
+        break;
+      default:
+        ntfsv_alloc_ntf_obj_create_del(&info->notification.objectCreateDelete,
+                                       0);
+        h = &info->notification.objectCreateDelete.notificationHeader;
+        break;
+    }
+    ntfsv_alloc_ntf_header(h, 0, 0, 0);
+    *h->eventType = r.event_type;
+    *h->notificationClassId = r.class_id;
+    *h->eventTime = 0;
+    SetName(h->notificationObject, r.object);
+    SetName(h->notifyingObject, "safApp=safAmfService");
+    return NtfSmartPtr(new NtfNotification(++notification_id_, r.type, info));
+  }
+
+  // Fill in a filter header the way subscribers of the recorded cluster
+  // filter, mostly on event type or notification class id.
+  void FillHeader(SaNtfNotificationFilterHeaderT *fh, int kind,
+                  SaNtfEventTypeT event_type, SaNtfClassIdT class_id,
+                  const std::string& object) {
+    switch (kind) {
+      case 0:
+        ntfsv_filter_header_alloc(fh, 1, 0, 0, 0);
+        fh->eventTypes[0] = event_type;
+        break;
+      case 1:
+        ntfsv_filter_header_alloc(fh, 0, 0, 0, 1);
+        fh->notificationClassIds[0] = class_id;
+        break;
+      case 2:
+        ntfsv_filter_header_alloc(fh, 1, 1, 0, 1);
+        fh->eventTypes[0] = event_type;
+        fh->notificationClassIds[0] = class_id;
+        SetName(&fh->notificationObjects[0], object);
+        break;
+      default:
+        // Only filters on the notification object, matched by substring
+        ntfsv_filter_header_alloc(fh, 0, 1, 0, 0);
+        SetName(&fh->notificationObjects[0], object);
+        break;
+    }
+  }
+
+  NtfFilter *CreateFilter() {
+    SaNtfClassIdT class_id = {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF,
+                              static_cast<SaUint16T>(100 + random_() % 20)};
+    std::string object = "safSu=SU" + std::to_string(1 + random_() % 4);
+    int kind = random_() % 100;
+    // Most filters give a class id, a few give neither class id nor event type
+    kind = kind < 15 ? 0 : kind < 75 ? 1 : kind < 95 ? 2 : 3;
+
+    switch (random_() % 3) {
+      case 0: {
+        SaNtfAlarmNotificationFilterT *f =
+            static_cast<SaNtfAlarmNotificationFilterT*>(malloc(sizeof(*f)));
+        ntfsv_filter_alarm_alloc(f, 0, random_() % 2, 0);
+        if (f->numPerceivedSeverities)
+          f->perceivedSeverities[0] = SA_NTF_SEVERITY_MAJOR;
+        class_id.minorId = random_() % 40;
+        FillHeader(&f->notificationFilterHeader, kind,
+                   alarm_event_types[random_() % 5], class_id, object);
+        return new NtfAlarmFilter(f);
+      }
+      case 1: {
+        SaNtfStateChangeNotificationFilterT *f =
+            static_cast<SaNtfStateChangeNotificationFilterT*>(
+                malloc(sizeof(*f)));
+        ntfsv_filter_state_ch_alloc(f, 0, 0);
+        FillHeader(&f->notificationFilterHeader, kind,
+                   SA_NTF_OBJECT_STATE_CHANGE, class_id, object);
+        return new NtfStateChangeFilter(f);
+      }
+      default: {
+        SaNtfObjectCreateDeleteNotificationFilterT *f =
+            static_cast<SaNtfObjectCreateDeleteNotificationFilterT*>(
+                malloc(sizeof(*f)));
+        ntfsv_filter_obj_cr_del_alloc(f, 0);
+        class_id.vendorId = 32993;
+        class_id.majorId = SA_SVC_IMMS;
+        class_id.minorId = random_() % 10;
+        FillHeader(&f->notificationFilterHeader, kind,
+                   random_() % 2 ? SA_NTF_OBJECT_CREATION :
+                   SA_NTF_OBJECT_DELETION, class_id, object);
+        return new NtfObjectCreateDeleteFilter(f);
+      }
+    }
+  }
+
+  // Subscriptions are added in client id and subscription id order, the
+  // order ntfd delivered notifications in before the index.
+  void AddSubscriptions(unsigned int clients, int per_client) {
+    for (unsigned int c = 1; c <= clients; ++c) {
+      for (int s = 1; s <= per_client; ++s) {
+        Subscription sub = {c, static_cast<SaNtfSubscriptionIdT>(s),
+                            CreateFilter()};
+        index_.filterAdded(sub.client_id, sub.subscription_id, sub.filter);
+        subscriptions_.push_back(sub);
+      }
+    }
+  }
+
+  void RemoveEverySecondSubscription() {
+    std::vector<Subscription> kept;
+    for (size_t i = 0; i < subscriptions_.size(); ++i) {
+      const Subscription& s = subscriptions_[i];
+      if (i % 2) {
+        index_.filterRemoved(s.client_id, s.subscription_id, s.filter);
+        delete s.filter;
+      } else {
+        kept.push_back(s);
+      }
+    }
+    subscriptions_.swap(kept);
+  }
+
+  void LinearMatches(NtfSmartPtr& notification,
+                     std::vector<NtfSubscriptionIndex::Match>& matches) {
+    matches.clear();
+    for (const Subscription& s : subscriptions_) {
+      if (s.filter->checkFilter(notification)) {
+        NtfSubscriptionIndex::Match match = {s.client_id, s.subscription_id};
+        matches.push_back(match);
+      }
+    }
+  }
+
+  void ExpectSameMatches() {
+    std::vector<NtfSubscriptionIndex::Match> expected;
+    std::vector<NtfSubscriptionIndex::Match> actual;
+    for (const RecordedNotification& r : recorded_mix) {
+      NtfSmartPtr notification = CreateNotification(r);
+      LinearMatches(notification, expected);
+      index_.findMatches(notification, actual);
+      ASSERT_EQ(expected.size(), actual.size()) << r.object;
+      for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].clientId, actual[i].clientId);
+        EXPECT_EQ(expected[i].subscriptionId, actual[i].subscriptionId);
+      }
+    }
+  }
+
+  // Match the recorded mix and return the number of notifications/sec
+  double NotificationsPerSecond(bool use_index, size_t *num_matches) {
+    static const int kRounds = 20;
+    std::vector<NtfSubscriptionIndex::Match> matches;
+    *num_matches = 0;
+
+    auto start = steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+      for (NtfSmartPtr& notification : notifications_) {
+        if (use_index)
+          index_.findMatches(notification, matches);
+        else
+          LinearMatches(notification, matches);
+        *num_matches += matches.size();
+      }
+    }
+    duration<double> elapsed = steady_clock::now() - start;
+    return kRounds * notifications_.size() / elapsed.count();
+  }
+
+  std::mt19937 random_;
+  SaNtfIdentifierT notification_id_ = 0;
+  NtfSubscriptionIndex index_;
+  std::vector<Subscription> subscriptions_;
+  std::vector<NtfSmartPtr> notifications_;
+};
+
+TEST_F(NtfSubscriptionIndexTest, IndexGivesSameMatchesAsLinearScan) {
+  AddSubscriptions(50, 40);
+  EXPECT_EQ(subscriptions_.size(), index_.size());
+  ExpectSameMatches();
+}
+
+TEST_F(NtfSubscriptionIndexTest, RemovedSubscriptionsAreNotMatched) {
+  AddSubscriptions(50, 40);
+  RemoveEverySecondSubscription();
+  EXPECT_EQ(subscriptions_.size(), index_.size());
+  ExpectSameMatches();
+}
+
+TEST_F(NtfSubscriptionIndexTest, UnknownNotificationTypeIsNotMatched) {
+  AddSubscriptions(5, 10);
+  RecordedNotification r = {SA_NTF_TYPE_ATTRIBUTE_CHANGE,
+                            SA_NTF_ATTRIBUTE_CHANGED,
+                            {SA_NTF_VENDOR_ID_SAF, SA_SVC_AMF, 101},
+                            "safSu=SU1", 1};
+  ntfsv_send_not_req_t *info = static_cast<ntfsv_send_not_req_t*>(
+      calloc(1, sizeof(ntfsv_send_not_req_t)));
+  info->notificationType = r.type;
+  SaNtfNotificationHeaderT *h =
+      &info->notification.attributeChange.notificationHeader;
+  ntfsv_alloc_ntf_header(h, 0, 0, 0);
+  *h->eventType = r.event_type;
+  *h->notificationClassId = r.class_id;
+  SetName(h->notificationObject, r.object);
+  NtfSmartPtr notification(new NtfNotification(1, r.type, info));
+
+  std::vector<NtfSubscriptionIndex::Match> matches;
+  index_.findMatches(notification, matches);
+  EXPECT_TRUE(matches.empty());
+}
+
+// Compare the number of matched notifications/sec with checking the filters
+// of all subscriptions
+TEST_F(NtfSubscriptionIndexTest, Benchmark) {
+  AddSubscriptions(100, 20);
+  size_t linear_matches;
+  size_t index_matches;
+  double linear = NotificationsPerSecond(false, &linear_matches);
+  double indexed = NotificationsPerSecond(true, &index_matches);
+  EXPECT_EQ(linear_matches, index_matches);
+  std::cout << subscriptions_.size() << " subscriptions: linear "
+            << static_cast<uint64_t>(linear) << " notifications/s, index "
+            << static_cast<uint64_t>(indexed) << " notifications/s\n";
+}
@@ -204,6 +204,8 @@ typedef struct {
     ntfsv_discarded_info_t discarded_cbk;
     ntfsv_ntfa_clm_status_cbk_t clm_node_status_cbk;
   } param;
+  /* notification_cbk already encoded by NTFS, shared by all subscribers */
+  USRBUF *notification_cbk_enc;
 } ntfsv_cbk_info_t;
 
 /* API Response parameter definitions */